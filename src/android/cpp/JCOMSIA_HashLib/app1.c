@@ -205,41 +205,6 @@ static const char IDENTIFIER_EXIF[] =
     0x45, 0x78, 0x69, 0x66, 0x00, 0x00
 };
 
-/*!
-@brief エントリの型情報を受け取り、型情報に応じた 1 カウントごとのデータ長を取得する。
-@param type エントリの型情報
-@return 型情報から取得したデータ長。型情報が未定義のものの場合は 0 を返す。
-*/
-static size_t getEntryTypeSize(unsigned short type)
-{
-    switch(type)
-    {
-    case IFD_TYPE_BYTE:
-        return BYTE_SIZE_UNSIGNED_CHAR;
-
-    case IFD_TYPE_ASCII:
-        return BYTE_SIZE_UNSIGNED_CHAR;
-
-    case IFD_TYPE_SHORT:
-        return BYTE_SIZE_UNSIGNED_SHORT;
-
-    case IFD_TYPE_LONG:
-        return BYTE_SIZE_UNSIGNED_INT;
-
-    case IFD_TYPE_UNDEFINED:
-        return BYTE_SIZE_UNSIGNED_CHAR;
-
-    case IFD_TYPE_SLONG:
-        return BYTE_SIZE_UNSIGNED_INT;
-
-    case IFD_TYPE_SRATIONAL:
-        return BYTE_SIZE_UNSIGNED_INT * 2;
-
-    default:
-        return 0;
-    }
-}
-
 /*!
 @brief Exif タグのバイトサイズ総数を取得する。
 @param entry サイズ取得用の Exif タグ構造体
@@ -540,16 +505,16 @@ static Entry getEntry(JpegBuffer *src, unsigned long seek, size_t tiffHeaderStar
 /*!
 @brief APP1 セグメント内のデータ形式が Exif であるかを確認する。
 @param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] startIndex 走査開始インデックス
+@param [in] segment セグメント索引に登録された APP1 セグメント
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_APP1_FORMAT APP1 領域が異なる形式の場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-static int checkIdentifierIsExif(JpegBuffer *src, unsigned long *startIndex)
+static int checkIdentifierIsExif(JpegBuffer *src, const JpegSegment *segment)
 {
     /* 識別子が正しいか調べる */
-    int ret = checkIdentifier(IDENTIFIER_EXIF, src, startIndex, BYTE_SIZE_EXIF_IDENTIFIER_SIZE);
+    int ret = checkSegmentIdentifier(IDENTIFIER_EXIF, src, segment, BYTE_SIZE_EXIF_IDENTIFIER_SIZE);
 
     if(ret == INCORRECT_IDENTIFIER)
     {
@@ -563,15 +528,17 @@ static int checkIdentifierIsExif(JpegBuffer *src, unsigned long *startIndex)
 /*!
 @brief Exif ファイルに格納されている APP1 領域の存在確認とその開始位置を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [in, out] seek 取得する走査開始位置
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP1_NOT_EXISTS APP1 領域が走査位置より下に存在しないとされる場合
 */
-int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
+int checkApp1Exists(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *seek)
 {
-    int ret = FUNCTION_SUCCESS;
+    int ret = INCORRECT_EXIF_FORMAT;  /* 索引の終端に達した場合は走査を続けられないのでエラー */
+    size_t position;
 
     /* パラメータチェック */
     if(src == NULL)
@@ -579,6 +546,11 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
         return INCORRECT_PARAMETER;
     }
 
+    if(index == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
     if(seek == NULL)
     {
         return INCORRECT_PARAMETER;
@@ -590,10 +562,17 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
         return INCORRECT_PARAMETER;
     }
 
-    while(1)
+    /* 走査位置から始まるセグメントを索引から探す */
+    position = findSegmentPosition(index, *seek);
+
+    for(; position < index->_count; ++position)
     {
         /* マーカセグメントの取得 */
-        int seg = getMarkerSegment(src, seek);
+        const JpegSegment *segment = &(index->_segments[position]);
+        int seg = segment->_marker;
+
+        /* 走査位置をマーカーの位置へ移動 */
+        *seek = segment->_offset;
 
         /*
          * セグメントが SOI の場合
@@ -601,7 +580,7 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
         if(seg == EXIF_MARKER_SOI)
         {
             /* 走査位置をセグメントIDの後ろへ移動 */
-            *seek += BYTE_SIZE_SEGMENT_MARKER;
+            *seek = segment->_nextOffset;
         }
 
         /*
@@ -637,6 +616,7 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
         else if(seg == EXIF_MARKER_APP01)
         {
             /* ループを抜ける */
+            ret = FUNCTION_SUCCESS;
             break;
         }
 
@@ -647,16 +627,8 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
                 ((seg >= EXIF_MARKER_SOF05) && (seg <= EXIF_MARKER_RST07)) ||
                 ((seg >= EXIF_MARKER_DHP)   && (seg <= EXIF_MARKER_COM))   || (seg == EXIF_MARKER_DNL))
         {
-            unsigned short len = 0x0000U;
-
-            /* 走査位置をセグメントIDの後ろへ移動 */
-            *seek += BYTE_SIZE_UNSIGNED_SHORT;
-
-            /* セグメントのサイズを取得 */
-            len = getAppSize(src, *seek);
-
-            /* 走査位置を移動 */
-            *seek += len;
+            /* 走査位置を次のセグメントへ移動 */
+            *seek = segment->_nextOffset;
         }
 
         /*
@@ -684,21 +656,16 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek)
 /*!
 @brief 原画像データの生成日時を Exif データから取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] dest 取得した原画像データの生成日時
+@param [out] dest 取得した原画像データの生成日時（src の該当範囲を参照する）
 @param entry 対象データのエントリ構造体
 @param startIndex 取得開始位置のインデックス
 @retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_EXIF_FORMAT 原画像データの生成日時フィールドの大きさが 20 より大きい場合
-@retval OTHER_ERROR メモリ確保に失敗した場合
+@retval INCORRECT_EXIF_FORMAT 原画像データの生成日時フィールドの大きさが 20 より大きい場合、またはデータ長を超える場合
 */
-static int readDateTimeOriginal(JpegBuffer *src, HashBuffer **dest, Entry entry, unsigned long startIndex)
+static int readDateTimeOriginal(JpegBuffer *src, ByteView *dest, Entry entry, unsigned long startIndex)
 {
-    /* 確保するべきメモリサイズ */
-    size_t memorySize = sizeof(HashBuffer *) + (entry.count * getEntryTypeSize(entry.type));
-
     /*
      * 原画像データの生成日時はサイズ固定なので、
-     * 基準より小さい場合は残りをゼロで埋め、
      * 基準より大きい場合はExif ファイルフォーマット不正としてエラーを返す。
      */
     if(BYTE_SIZE_DATE_TIME_ORIGINAL < entry.count)
@@ -706,23 +673,16 @@ static int readDateTimeOriginal(JpegBuffer *src, HashBuffer **dest, Entry entry,
         return INCORRECT_EXIF_FORMAT;
     }
 
-    /* 領域の確保 */
-    *dest = (HashBuffer *) malloc(memorySize);
-
-    if(*dest == NULL)
+    /* 取得範囲がデータ長を超える場合 */
+    if(src->_len < startIndex ||
+            src->_len - startIndex < entry.count)
     {
-        /* メモリ確保失敗 */
-        return OTHER_ERROR;
+        return INCORRECT_EXIF_FORMAT;
     }
 
-    /* 領域のゼロクリア */
-    memset(*dest, 0x00, memorySize);
-
-    /* データ取得 */
-    memcpy((*dest)->_buff, &(src->_buff[startIndex]), entry.count);
-
-    /* データ長の設定 */
-    (*dest)->_len = entry.count;
+    /* データを複製せずに参照する */
+    dest->_ptr = &(src->_buff[startIndex]);
+    dest->_len = entry.count;
 
     return FUNCTION_SUCCESS;
 }
@@ -730,34 +690,24 @@ static int readDateTimeOriginal(JpegBuffer *src, HashBuffer **dest, Entry entry,
 /*!
 @brief 原画像データの生成日時の秒以下の値を Exif データから取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] dest 取得した原画像データの生成日時
+@param [out] dest 取得した原画像データの生成日時（src の該当範囲を参照する）
 @param entry 対象データのエントリ構造体
 @param startIndex 取得開始位置のインデックス
 @retval FUNCTION_SUCCESS 正常終了
-@retval OTHER_ERROR メモリ確保に失敗した場合
+@retval INCORRECT_EXIF_FORMAT 取得範囲がデータ長を超える場合
 */
-static int readSubSecTimeOriginal(JpegBuffer *src, HashBuffer **dest, Entry entry, unsigned long startIndex)
+static int readSubSecTimeOriginal(JpegBuffer *src, ByteView *dest, Entry entry, unsigned long startIndex)
 {
-    /* 確保するべきメモリサイズ */
-    size_t memorySize = sizeof(HashBuffer *) + (entry.count * getEntryTypeSize(entry.type));
-
-    /* 領域の確保 */
-    *dest = (HashBuffer *) malloc(memorySize);
-
-    if(*dest == NULL)
+    /* 取得範囲がデータ長を超える場合 */
+    if(src->_len < startIndex ||
+            src->_len - startIndex < entry.count)
     {
-        /* メモリ確保失敗 */
-        return OTHER_ERROR;
+        return INCORRECT_EXIF_FORMAT;
     }
 
-    /* 領域のゼロクリア */
-    memset(*dest, 0x00, memorySize);
-
-    /* データ取得 */
-    memcpy((*dest)->_buff, &(src->_buff[startIndex]), entry.count);
-
-    /* データ長の設定 */
-    (*dest)->_len = entry.count;
+    /* データを複製せずに参照する */
+    dest->_ptr = &(src->_buff[startIndex]);
+    dest->_len = entry.count;
 
     return FUNCTION_SUCCESS;
 }
@@ -768,26 +718,24 @@ static int readSubSecTimeOriginal(JpegBuffer *src, HashBuffer **dest, Entry entr
 @details この関数を呼び出した時点でポインタが何らかの値を指している場合、その値は更新しない。
 @details 取得できなかった場合、NULL ポインタを指す。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] dateTimeOriginalBin 取得した原画像データの生成日時
-@param [out] subSecTimeOriginalBin 取得した原画像データの生成日時
-@param [in, out] seek 取得する走査開始位置。終了した時点で、探査したセグメントの次のアドレスを指す。
+@param [out] dateTimeOriginalBin 取得した原画像データの生成日時（src の該当範囲を参照する）
+@param [out] subSecTimeOriginalBin 取得した原画像データの生成日時（src の該当範囲を参照する）
+@param [in] app1Segment セグメント索引に登録された探査対象の APP1 セグメント
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER *src が NULL の場合。
-                            *seek が *src->_len より大きい場合。
-                            **dateTimeOriginalBin, **subSecTimeOriginalBin の両方が何らかの値を指している場合。
+                            app1Segment が NULL 、またはその位置が *src->_len より大きい場合。
+                            dateTimeOriginalBin, subSecTimeOriginalBin の両方が何らかの範囲を参照している場合。
 @retval INCORRECT_EXIF_FORMAT Exif ファイルの形式が正しくない場合
 @retval INCORRECT_APP1_FORMAT Exif 情報を含む APP1 とは記述形式が異なる場合
 @retval DATE_NOT_EXISTS 日時データを取得できなかった場合
 @retval OTHER_ERROR メモリ確保に失敗した場合など
 */
-static int takeDateTimeFromAPP1(JpegBuffer *src, HashBuffer **dateTimeOriginalBin, HashBuffer **subSecTimeOriginalBin, unsigned long *seek)
+static int takeDateTimeFromAPP1(JpegBuffer *src, ByteView *dateTimeOriginalBin, ByteView *subSecTimeOriginalBin, const JpegSegment *app1Segment)
 {
     int i;
     int ret = FUNCTION_SUCCESS;
     int jacicEndian;
     unsigned int offset;
-    unsigned short segment;
-    unsigned short app1Length;
     unsigned short byteOrder;
     unsigned short separator;
     unsigned short IFD0Count;
@@ -802,52 +750,41 @@ static int takeDateTimeFromAPP1(JpegBuffer *src, HashBuffer **dateTimeOriginalBi
         return INCORRECT_PARAMETER;
     }
 
-    if(src->_len <= *seek)
+    if(app1Segment == NULL)
     {
         return INCORRECT_PARAMETER;
     }
 
-    if(*dateTimeOriginalBin != NULL &&
-            *subSecTimeOriginalBin != NULL)
+    if(src->_len <= app1Segment->_offset)
     {
-        /* 両方が値を持っている場合は設定対象がないのでエラーとする */
         return INCORRECT_PARAMETER;
     }
 
-    /*
-     * 仮想走査位置に現在の走査位置をコピー
-     * 以下、この関数内では仮想走査位置を使用して走査を行う
-     */
-    tmpSeek = *seek;
-
+    if(dateTimeOriginalBin->_ptr != NULL &&
+            subSecTimeOriginalBin->_ptr != NULL)
+    {
+        /* 両方が値を持っている場合は設定対象がないのでエラーとする */
+        return INCORRECT_PARAMETER;
+    }
 
     /*
      * APP1 セグメントヘッダ
      */
 
-    /* セグメントマーカを取得 */
-    segment = getMarkerSegment(src, &tmpSeek);
-
-    if(segment != EXIF_MARKER_APP01)
+    if(app1Segment->_marker != EXIF_MARKER_APP01)
     {
         /* APP1 セグメントではない */
         return INCORRECT_APP1_FORMAT;
     }
 
-    /* 仮想走査位置を進める */
-    tmpSeek += BYTE_SIZE_SEGMENT_MARKER;
-
-    /* マーカのサイズを取得 */
-    app1Length = getAppSize(src, tmpSeek);
-
-    /* 実際の走査位置を次のセグメント開始位置へ進める */
-    *seek = tmpSeek + app1Length;
-
-    /* 仮想走査位置を進める */
-    tmpSeek += BYTE_SIZE_SEGMENT_SIZE;
+    /*
+     * 仮想走査位置にセグメント識別子の位置を設定
+     * 以下、この関数内では仮想走査位置を使用して走査を行う
+     */
+    tmpSeek = app1Segment->_offset + BYTE_SIZE_SEGMENT_MARKER + BYTE_SIZE_SEGMENT_SIZE;
 
     /* Exif 識別コード判定 */
-    ret = checkIdentifierIsExif(src, &tmpSeek);
+    ret = checkIdentifierIsExif(src, app1Segment);
 
     /* 既定の識別コードでない場合は失敗 */
     if(ret != FUNCTION_SUCCESS)
@@ -962,7 +899,7 @@ static int takeDateTimeFromAPP1(JpegBuffer *src, HashBuffer **dateTimeOriginalBi
         entry = getEntry(src, tmpSeek, tiffHeaderStartPosition, jacicEndian);
 
         if(entry.tag == EXIF_TAG_DATE_TIME_ORIGINAL &&
-                *dateTimeOriginalBin == NULL)
+                dateTimeOriginalBin->_ptr == NULL)
         {
             /* 原画像データの撮影日時の取得 */
             ret = readDateTimeOriginal(
@@ -979,8 +916,8 @@ static int takeDateTimeFromAPP1(JpegBuffer *src, HashBuffer **dateTimeOriginalBi
             }
 
             /* 両方取得できた場合は中止する */
-            if(*dateTimeOriginalBin != NULL &&
-                    *subSecTimeOriginalBin != NULL)
+            if(dateTimeOriginalBin->_ptr != NULL &&
+                    subSecTimeOriginalBin->_ptr != NULL)
             {
                 break;
             }
@@ -1005,8 +942,8 @@ static int takeDateTimeFromAPP1(JpegBuffer *src, HashBuffer **dateTimeOriginalBi
             }
 
             /* 両方取得できた場合は中止する */
-            if(*dateTimeOriginalBin != NULL &&
-                    *subSecTimeOriginalBin != NULL)
+            if(dateTimeOriginalBin->_ptr != NULL &&
+                    subSecTimeOriginalBin->_ptr != NULL)
             {
                 break;
             }
@@ -1032,19 +969,21 @@ static int takeDateTimeFromAPP1(JpegBuffer *src, HashBuffer **dateTimeOriginalBi
 @brief APP1 領域を探査し、原画像データの生成日時、およびその秒以下の値を取得する。
 @details 原画像データの生成日時のサブセック (SubSecTimeOriginal) が取得できなかった場合は無視する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] retDateBin 取得した日時データ
+@param [in] index src から作成したセグメント索引
+@param [in, out] arena retDateBin の割り当て元となるアリーナ
+@param [out] retDateBin 取得した日時データ（arena から割り当てられるため、個別に解放しないこと）
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER いずれかの引数が NULL の場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正の場合
 @retval DATE_NOT_EXISTS Exif メタデータ内に原画像データの生成日時が見つからなかった場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
  */
-int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
+int getDateTimeOriginal(JpegBuffer *src, const JpegSegmentIndex *index, Arena *arena, HashBuffer **retDateBin)
 {
     int ret;
     unsigned long seek = 0UL;
-    HashBuffer *dateTimeOriginalBuffer = NULL;
-    HashBuffer *subSecTimeOriginalBuffer = NULL;
+    ByteView dateTimeOriginalBuffer = {NULL, 0};
+    ByteView subSecTimeOriginalBuffer = {NULL, 0};
     size_t dataSize;
     size_t memorySize;
 
@@ -1059,33 +998,39 @@ int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
         return INCORRECT_PARAMETER;
     }
 
-    /*
-     * SOI を検出する（検出できなければ Exif 形式のエラー）
-     */
-    ret = checkFirstFindSOI(src, &seek);
+    if(index == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
 
-    if(ret != FUNCTION_SUCCESS)
+    if(arena == NULL)
     {
-        /* 不正な Exif フォーマット */
-        return INCORRECT_EXIF_FORMAT;
+        return INCORRECT_PARAMETER;
     }
 
-    /* APP1 領域を繰り返し検索する */
+    /* SOI の次から APP1 領域を繰り返し検索する */
+    seek = index->_startOffset;
+
     while(seek < src->_len)
     {
         /* APP1 領域を検出する */
-        ret = checkApp1Exists(src, &seek);
+        ret = checkApp1Exists(src, index, &seek);
 
         if(ret == FUNCTION_SUCCESS)
         {
+            const JpegSegment *app1Segment = &(index->_segments[findSegmentPosition(index, seek)]);
+
             /* 正常に取得できたので、取得内容から原画像データの生成日時を探す */
             ret = takeDateTimeFromAPP1(
                       src,
                       &dateTimeOriginalBuffer,
                       &subSecTimeOriginalBuffer,
-                      &seek
+                      app1Segment
                   );
 
+            /* 走査位置を次のセグメント開始位置へ進める */
+            seek = app1Segment->_nextOffset;
+
             /*
              * エラーが発生した場合は終了する
              * ただし、日時が見つからない場合は次の APP1 領域を探すため、終了しない
@@ -1099,8 +1044,8 @@ int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
             }
 
             /* 両方のデータが取得できていれば終了する */
-            if(dateTimeOriginalBuffer != NULL &&
-                    subSecTimeOriginalBuffer != NULL)
+            if(dateTimeOriginalBuffer._ptr != NULL &&
+                    subSecTimeOriginalBuffer._ptr != NULL)
             {
                 break;
             }
@@ -1111,7 +1056,7 @@ int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
              * APP1領域を全て検索し終えた場合
              */
             if(ret == APP1_NOT_EXISTS &&
-                    dateTimeOriginalBuffer != NULL)
+                    dateTimeOriginalBuffer._ptr != NULL)
             {
                 /* 少なくとも原画像データの生成日時が取得できているので、正常終了扱いとする */
                 ret = FUNCTION_SUCCESS;
@@ -1121,7 +1066,7 @@ int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
         }
     }
 
-    if(dateTimeOriginalBuffer == NULL)
+    if(dateTimeOriginalBuffer._ptr == NULL)
     {
         /*
          * 原画像データの生成日時を取得できなかった場合はエラー扱いにする。
@@ -1132,19 +1077,20 @@ int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
 
     /* 日時データと秒以下の値を結合する */
 
-    dataSize = dateTimeOriginalBuffer->_len;
+    dataSize = dateTimeOriginalBuffer._len;
 
     /* サブセックが見つかった場合のみ末尾に追加する */
 
-    if(subSecTimeOriginalBuffer != NULL &&
-            0 < subSecTimeOriginalBuffer->_len)
+    if(subSecTimeOriginalBuffer._ptr != NULL &&
+            0 < subSecTimeOriginalBuffer._len)
     {
-        dataSize += subSecTimeOriginalBuffer->_len;
+        dataSize += subSecTimeOriginalBuffer._len;
     }
 
-    memorySize = sizeof(HashBuffer *) + dataSize;
+    memorySize = sizeof(HashBuffer) + dataSize;
 
-    *retDateBin = (HashBuffer *) malloc(memorySize);
+    /* 領域の確保（アリーナから割り当てた領域はゼロクリア済み） */
+    *retDateBin = (HashBuffer *) arenaAlloc(arena, memorySize);
 
     if(*retDateBin == NULL)
     {
@@ -1153,26 +1099,19 @@ int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin)
         goto FINALIZE;
     }
 
-    /* 領域のゼロクリア */
-    memset(*retDateBin, 0x00, memorySize);
-
     /* データ長の設定 */
     (*retDateBin)->_len = dataSize;
 
-    memcpy((*retDateBin)->_buff, dateTimeOriginalBuffer->_buff, dateTimeOriginalBuffer->_len);
+    memcpy((*retDateBin)->_buff, dateTimeOriginalBuffer._ptr, dateTimeOriginalBuffer._len);
 
     /* 秒以下の値が存在する場合は末尾に追加 */
-    if(subSecTimeOriginalBuffer != NULL &&
-            0 < subSecTimeOriginalBuffer->_len)
+    if(subSecTimeOriginalBuffer._ptr != NULL &&
+            0 < subSecTimeOriginalBuffer._len)
     {
-        memcpy(&(*retDateBin)->_buff[dateTimeOriginalBuffer->_len], &subSecTimeOriginalBuffer->_buff, subSecTimeOriginalBuffer->_len);
+        memcpy(&(*retDateBin)->_buff[dateTimeOriginalBuffer._len], subSecTimeOriginalBuffer._ptr, subSecTimeOriginalBuffer._len);
     }
 
 FINALIZE:
 
-    /* メモリ解放 */
-    _SECURE_FREE(dateTimeOriginalBuffer);
-    _SECURE_FREE(subSecTimeOriginalBuffer);
-
     return ret;
 }
@@ -10,17 +10,19 @@
 #define APP1_H_
 
 #include "common.h"
+#include "exif.h"
 
 /*!
 @brief Exif ファイルに格納されている APP1 領域の存在確認とその開始位置を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [in, out] seek 取得する走査開始位置
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP1_NOT_EXISTS APP1 領域が走査位置より下に存在しないとされる場合
 */
-int checkApp1Exists(JpegBuffer *src, unsigned long *seek);
+int checkApp1Exists(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *seek);
 
 /*!
 @brief APP1 領域を探査し、原画像データの生成日時、およびその秒以下の値を取得する。
@@ -28,12 +30,14 @@ int checkApp1Exists(JpegBuffer *src, unsigned long *seek);
 @details NULL 終端を含めた長さ 20 の空白 (0x20) 埋めされたダミーデータを生成して返す。
 @details 原画像データの生成日時のサブセック (SubSecTimeOriginal)  が取得できなかった場合は無視する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] retDateBin 取得した日時データ
+@param [in] index src から作成したセグメント索引
+@param [in, out] arena retDateBin の割り当て元となるアリーナ
+@param [out] retDateBin 取得した日時データ（arena から割り当てられるため、個別に解放しないこと）
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER いずれかの引数が NULL の場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正の場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
  */
-int getDateTimeOriginal(JpegBuffer *src, HashBuffer **retDateBin);
+int getDateTimeOriginal(JpegBuffer *src, const JpegSegmentIndex *index, Arena *arena, HashBuffer **retDateBin);
 
 #endif /* APP1_H_ */
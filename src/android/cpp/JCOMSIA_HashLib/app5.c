@@ -645,18 +645,17 @@ static void getCharCodeSet(JpegBuffer *src, char charCode[], unsigned long seek)
 /*!
 @brief APP5領域を挿入する位置を返す。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [out] insPos 取得する APP5 領域を挿入する位置情報
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP5_ALREADY_EXISTS APP5 領域が既に存在する場合
 */
-static int getApp5InsertPosition(JpegBuffer *src, unsigned long *insPos)
+static int getApp5InsertPosition(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *insPos)
 {
-    int ret = FUNCTION_SUCCESS;
-    unsigned short seg = 0xFFFFU;
-    unsigned short len = 0x0000U;
-    unsigned long seek = 0U;
+    int ret = INCORRECT_EXIF_FORMAT;  /* 索引の終端に達した場合は走査を続けられないのでエラー */
+    size_t position;
 
     /* パラメータチェック */
     if(src == NULL)
@@ -664,35 +663,21 @@ static int getApp5InsertPosition(JpegBuffer *src, unsigned long *insPos)
         return INCORRECT_PARAMETER;
     }
 
-    if(insPos == NULL)
+    if(index == NULL)
     {
         return INCORRECT_PARAMETER;
     }
 
-    /* Exif スタートマーカー(SOI)チェック */
-    seg = getMarkerSegment(src, &seek);
-
-    if(seg != EXIF_MARKER_SOI)
-    {
-        /*
-         * スタートマーカー(SOI)でない場合、
-         * 「Exif ファイルフォーマットが不正」としてエラーを返す
-         */
-        return INCORRECT_EXIF_FORMAT;
-    }
-
-    /* セグメントの長さ分、走査位置をずらす */
-    seek += BYTE_SIZE_UNSIGNED_SHORT;
-
-    /* 走査位置がデータ長を超える場合 */
-    if(src->_len < seek)
+    if(insPos == NULL)
     {
-        return INCORRECT_EXIF_FORMAT;
+        return INCORRECT_PARAMETER;
     }
 
-    while(1)
+    /* SOI の次のセグメントから順に走査する */
+    for(position = 0; position < index->_count; ++position)
     {
-        seg = getMarkerSegment(src, &seek);
+        const JpegSegment *segment = &(index->_segments[position]);
+        unsigned short seg = segment->_marker;
 
         /*
          * SOF、DHT、SOS、DQT、DRIのいずれかの場合
@@ -705,7 +690,7 @@ static int getApp5InsertPosition(JpegBuffer *src, unsigned long *insPos)
         {
 
             /* APP5セグメント領域挿入位置を設定 */
-            *insPos = seek;
+            *insPos = segment->_offset;
             ret = FUNCTION_SUCCESS;
             break;
         }
@@ -734,34 +719,19 @@ static int getApp5InsertPosition(JpegBuffer *src, unsigned long *insPos)
         }
 
         /*
-         * 上記以外のセグメントの場合
-         */
-        else if(((seg >= EXIF_MARKER_SOF01) && (seg <= EXIF_MARKER_SOF03)) ||
-                ((seg >= EXIF_MARKER_SOF05) && (seg <= EXIF_MARKER_RST07)) ||
-                ((seg >= EXIF_MARKER_DHP)   && (seg <= EXIF_MARKER_COM))   || (seg == EXIF_MARKER_DNL))
-        {
-            /* 走査位置をセグメントIDの後ろへ移動 */
-            seek += BYTE_SIZE_UNSIGNED_SHORT;
-
-            /* セグメントのサイズを取得 */
-            len = getAppSize(src, seek);
-
-            /* 走査位置を移動 */
-            seek += len;
-        }
-
-        /*
-         * その他、判別不可能なセグメントの場合
+         * 上記以外のセグメントでない場合
          */
-        else
+        else if(!(((seg >= EXIF_MARKER_SOF01) && (seg <= EXIF_MARKER_SOF03)) ||
+                  ((seg >= EXIF_MARKER_SOF05) && (seg <= EXIF_MARKER_RST07)) ||
+                  ((seg >= EXIF_MARKER_DHP)   && (seg <= EXIF_MARKER_COM))   || (seg == EXIF_MARKER_DNL)))
         {
-            /* 「Exif ファイルフォーマットが不正」としてエラーを返す */
+            /* 判別不可能なセグメントなので「Exif ファイルフォーマットが不正」としてエラーを返す */
             ret = INCORRECT_EXIF_FORMAT;
             break;
         }
 
-        /* 走査位置がデータ長を超える場合 */
-        if(src->_len < seek)
+        /* 次の走査位置がデータ長を超える場合 */
+        if(src->_len < segment->_nextOffset)
         {
             ret = INCORRECT_EXIF_FORMAT;
             break;
@@ -774,16 +744,17 @@ static int getApp5InsertPosition(JpegBuffer *src, unsigned long *insPos)
 /*!
 @brief Exif ファイルに格納されている APP5 領域の存在確認とその開始位置を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [in, out] seek 取得する走査開始位置
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER いずれかの引数が NULL, または走査不可能な位置が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP5_NOT_EXISTS APP1 領域が見つからなかった場合
 */
-int checkApp5Exists(JpegBuffer *src, unsigned long *seek)
+int checkApp5Exists(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *seek)
 {
-    int ret = FUNCTION_SUCCESS;
-    unsigned short len = 0x0000U;
+    int ret = INCORRECT_EXIF_FORMAT;  /* 索引の終端に達した場合は走査を続けられないのでエラー */
+    size_t position;
 
     /* パラメータチェック */
     if(src == NULL)
@@ -791,6 +762,11 @@ int checkApp5Exists(JpegBuffer *src, unsigned long *seek)
         return INCORRECT_PARAMETER;
     }
 
+    if(index == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
     if(seek == NULL)
     {
         return INCORRECT_PARAMETER;
@@ -802,9 +778,14 @@ int checkApp5Exists(JpegBuffer *src, unsigned long *seek)
         return INCORRECT_PARAMETER;
     }
 
-    while(1)
+    /* 走査位置から始まるセグメントを索引から探す */
+    for(position = findSegmentPosition(index, *seek); position < index->_count; ++position)
     {
-        unsigned short seg = getMarkerSegment(src, seek);
+        const JpegSegment *segment = &(index->_segments[position]);
+        unsigned short seg = segment->_marker;
+
+        /* 走査位置をマーカーの位置へ移動 */
+        *seek = segment->_offset;
 
         /*
          * SOF、DHT、SOS、DQT、DRIのいずれかの場合
@@ -839,6 +820,7 @@ int checkApp5Exists(JpegBuffer *src, unsigned long *seek)
         else if(seg == EXIF_MARKER_APP05)
         {
             /* ループを抜ける */
+            ret = FUNCTION_SUCCESS;
             break;
         }
 
@@ -849,14 +831,8 @@ int checkApp5Exists(JpegBuffer *src, unsigned long *seek)
                 ((seg >= EXIF_MARKER_SOF05) && (seg <= EXIF_MARKER_RST07)) ||
                 ((seg >= EXIF_MARKER_DHP)   && (seg <= EXIF_MARKER_COM))   || (seg == EXIF_MARKER_DNL))
         {
-            /* 走査位置をセグメントIDの後ろへ移動 */
-            *seek += BYTE_SIZE_UNSIGNED_SHORT;
-
-            /* セグメントのサイズを取得 */
-            len = getAppSize(src, *seek);
-
-            /* 走査位置を移動 */
-            *seek += len;
+            /* 走査位置を次のセグメントへ移動 */
+            *seek = segment->_nextOffset;
         }
 
         /*
@@ -919,11 +895,14 @@ static int setBinaryData(HashBuffer **dst, HashBuffer *writeData, unsigned long
 @details JPEG 画像データを先頭から走査していき、最初に見つかった
 @details 次のセグメント ( APP6 ～ APP15、DQT、DHT、DRI、SOF、SOS ) の前に、
 @details APP5 セグメント領域を追加する。
+@details 埋め込み後の画像全体をメモリ上に作成せず、元データ前半部・APP5 データ・元データ後半部を順に書き出す。
 @remarks ※スマートフォン (HUAWEI P8Lite) で APP1 -> APP0 の順番でセグメントが並んでいる
 @remarks   ケースがあったので、上記ルールにて APP5 セグメント領域を追加する。
 @param [in] src JPEG画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [in] imgHash 埋め込むハッシュ値（画像）
 @param [in] dateHash 埋め込むハッシュ値（原画像生成日時）
+@param arena 作業用の APP5 セグメント領域データの割り当て元となるアリーナ
 @param [in] dst 出力先ファイルパス
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
@@ -934,14 +913,13 @@ static int setBinaryData(HashBuffer **dst, HashBuffer *writeData, unsigned long
 @retval APP5_ALREADY_EXISTS APP5 領域が既に存在する場合
 @retval OTHER_ERROR メモリの確保に失敗した場合
 */
-int writeApp5(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, const char *dst)
+int writeApp5(JpegBuffer *src, const JpegSegmentIndex *index, HashBuffer *imgHash, HashBuffer *dateHash, Arena *arena, const char *dst)
 {
     int ret = FUNCTION_SUCCESS;
     unsigned long insPos = 0UL;
     HashBuffer *app5 = NULL;
-    HashBuffer *outBuff = NULL;
     size_t app5Length = sizeof(APP5_SEGMENT_DATA);
-    size_t outBuffLength;
+    ByteView parts[3];
 
     /* パラメータチェック */
     if(src == NULL)
@@ -959,15 +937,18 @@ int writeApp5(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, const
         return INCORRECT_PARAMETER;
     }
 
-    if(dst == NULL)
+    if(arena == NULL)
     {
         return INCORRECT_PARAMETER;
     }
 
-    outBuffLength = src->_len + app5Length;
+    if(dst == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
 
-    /* APP5セグメント領域データの作成 */
-    app5 = (HashBuffer *) malloc(sizeof(HashBuffer *) + app5Length);
+    /* APP5セグメント領域データの作成（アリーナから割り当てた領域はゼロクリア済み） */
+    app5 = arenaAllocateBinaryData(arena, app5Length);
 
     if(app5 == NULL)
     {
@@ -975,285 +956,206 @@ int writeApp5(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, const
         return OTHER_ERROR;
     }
 
-    app5->_len = app5Length;
-
-
-    /* APP5 領域のゼロクリア */
-    memset(app5->_buff, 0x00, app5->_len);
-
     /* APP5 領域デフォルトデータの作成 */
     memcpy(app5->_buff, APP5_SEGMENT_DATA, app5->_len);
 
     /* APP5 領域にハッシュ値（画像）を埋め込む */
-    setBinaryData(&app5, imgHash, APP5_IMAGE_HASH_INSERT_POSITION);
+    ret = setBinaryData(&app5, imgHash, APP5_IMAGE_HASH_INSERT_POSITION);
+    if(ret != FUNCTION_SUCCESS)
+    {
+        return ret;
+    }
 
     /* APP5 領域にハッシュ値（原画像データ生成日時）を埋め込む */
-    setBinaryData(&app5, dateHash, APP5_DATE_HASH_INSERT_POSITION);
-
-    /* APP5 の埋め込み位置を走査 */
-    ret = getApp5InsertPosition(src, &insPos);
-
+    ret = setBinaryData(&app5, dateHash, APP5_DATE_HASH_INSERT_POSITION);
     if(ret != FUNCTION_SUCCESS)
     {
-        goto FINALIZE;
+        return ret;
     }
 
-    /* APP5 セグメント領域データ分を追加したサイズのバッファを用意 */
-    outBuff = (HashBuffer *) malloc(sizeof(HashBuffer *) + outBuffLength);
+    /* APP5 の埋め込み位置を走査 */
+    ret = getApp5InsertPosition(src, index, &insPos);
 
-    if(outBuff == NULL)
+    if(ret != FUNCTION_SUCCESS)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
+        return ret;
     }
 
-    outBuff->_len = outBuffLength;
-
-    /* 領域のゼロクリア */
-    memset(outBuff->_buff, 0x00, outBuff->_len);
-
-    /* 元データ前半部をコピー */
-    memcpy(outBuff->_buff, src->_buff, insPos);
-
-    /* APP5 データをコピー */
-    memcpy((outBuff->_buff + insPos), app5->_buff, app5->_len);
-
-    /* 元データ後半部をコピー */
-    memcpy((outBuff->_buff + insPos + app5->_len), &(src->_buff[insPos]), src->_len - insPos);
+    /* 元データ前半部、APP5 データ、元データ後半部の順に、出力用のバッファを作らずに直接書き出す */
+    parts[0]._ptr = src->_buff;
+    parts[0]._len = insPos;
+    parts[1]._ptr = app5->_buff;
+    parts[1]._len = app5->_len;
+    parts[2]._ptr = &(src->_buff[insPos]);
+    parts[2]._len = src->_len - insPos;
 
     /* ファイル書き出し */
-    ret = writeFile(dst, outBuff->_buff, src->_len + app5->_len);
-
-
-FINALIZE:
-    /* メモリ解放 */
-    _SECURE_FREE(app5);
-    _SECURE_FREE(outBuff);
-
-    return ret;
+    return writeFileGather(dst, parts, sizeof(parts) / sizeof(parts[0]));
 }
 
 /*!
-@brief APP5 領域内で対象の文字列が何番目に格納されているか調べる。
-@param targetItemText チェック対象のタイトル文字列
-@param [in] rMetaItemText 対象となるメタデータ領域を切り取ったデータ構造体
-@param [out] hashItemEntryOrder 取得するハッシュの格納順
-@param entryCount 項目の最大エントリ数
-@retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_APP5_FORMAT APP5 領域、またはテキストが不正な形式の場合
-@retval HASH_NOT_EXISTS 対象となるテキストが見つからない場合
-@retval OTHER_ERROR メモリ確保に失敗した場合
+@struct RMetaHashTarget
+@brief RMETA Data から取得するハッシュ値 1 件分の探索状態
 */
-static int seekValueOrder(const char *targetItemText, HashBuffer *rMetaItemText, int *hashItemEntryOrder, unsigned short entryCount)
+typedef struct
 {
-    int ret = HASH_NOT_EXISTS;
-    unsigned int i;
-    unsigned char *text = NULL;
-    unsigned long seek = 0UL;
-    size_t maxByteSize = BYTE_SIZE_UNSIGNED_CHAR * rMetaItemText->_len;
-
-    /* 領域の最大数までメモリ確保 */
-    text = (unsigned char *) malloc(maxByteSize);
-
-    if(text == NULL)
-    {
-        /* メモリ確保に失敗 */
-        return OTHER_ERROR;
-    }
+    const char *_title;   /*!< @brief 探索対象の項目テキストタイトル文字列 */
+    size_t _titleLength;  /*!< @brief _title の長さ（終端文字を除く） */
+    JACIC_BOOL _pending;  /*!< @brief 結果が未確定であることを示すフラグ（探索しない場合は最初から JACIC_BOOL_FALSE とする） */
+    int _order;           /*!< @brief 項目テキスト内の格納順（見つからない場合は -1 ） */
+    int _result;          /*!< @brief 取得結果 */
+    ByteView _value;      /*!< @brief 取得した内容テキスト（ _result が FUNCTION_SUCCESS の場合のみ有効） */
+} RMetaHashTarget;
 
-    /* 領域のゼロクリア */
-    memset(text, 0x00, maxByteSize);
-
-    /* 初期化 */
-    *hashItemEntryOrder = -1;
+/*!
+@brief 項目テキストと内容テキストをそれぞれ 1 回だけ走査し、複数のタイトルに対応する内容テキストを取得する。
+@details タイトルごとに項目テキスト・内容テキストを先頭から走査した場合と同じ結果を targets[]._result に設定する。
+@details 取得した内容テキストは rMetaItemText128 の該当範囲を参照し、メモリの確保は行わない。
+@param [in] rMetaItemText 取得対象の実データ（項目テキスト）の参照
+@param [in] rMetaItemText128 取得対象の実データ（内容テキスト 128 ）の参照
+@param entryCount セグメント内のメタデータ定義数
+@param [in, out] targets 探索対象の配列（ _title, _titleLength, _pending を設定しておく）
+@param targetCount targets の要素数
+@details 各要素の _result には次のいずれかが設定される。
+@details FUNCTION_SUCCESS : 正常終了
+@details INCORRECT_APP5_FORMAT : APP5 領域が不正な形式の場合
+@details INCORRECT_TEXT : 該当する内容テキストが不正な場合
+@details HASH_NOT_EXISTS : タイトルが見つからない場合
+*/
+static void decodeRMetaHashItems(const ByteView *rMetaItemText, const ByteView *rMetaItemText128, unsigned short entryCount, RMetaHashTarget targets[], size_t targetCount)
+{
+    size_t t;
+    size_t remaining = 0;            /* 未確定の探索対象数 */
+    int titleResult = HASH_NOT_EXISTS;
+    int i;
+    ByteView text;
+    unsigned long seek = 0UL;
 
-    /* メタデータを走査する */
-    for(i = 0; i < entryCount; ++i)
+    for(t = 0; t < targetCount; ++t)
     {
-        int funcRet;
+        targets[t]._order = -1;
+        targets[t]._value._ptr = NULL;
+        targets[t]._value._len = 0;
 
-        if(rMetaItemText->_len <= seek)
+        if(targets[t]._pending == JACIC_BOOL_TRUE)
         {
-            /* 走査位置が最大サイズを超えた */
-            ret = INCORRECT_APP5_FORMAT;
-            break;
+            ++remaining;
         }
+    }
 
-        /* テキスト項目格納 */
-        funcRet = getByteText(rMetaItemText, text, &seek, rMetaItemText->_len);
-
-        if(funcRet != FUNCTION_SUCCESS)
+    /* 項目テキストを走査して、すべてのタイトルの格納順を求める */
+    for(i = 0; i < entryCount && remaining > 0; ++i)
+    {
+        /* テキスト項目取得（走査位置が最大サイズを超えた場合も失敗する） */
+        if(getByteText(rMetaItemText, &text, &seek) != FUNCTION_SUCCESS)
         {
             /* 取得したテキストが不正 */
-            ret = INCORRECT_APP5_FORMAT;
+            titleResult = INCORRECT_APP5_FORMAT;
             break;
         }
 
-        /* 探査対象の文字列との比較 */
-        if(strcmp((char *)text, targetItemText) == 0)
+        for(t = 0; t < targetCount; ++t)
         {
-            /* 現在の番号の内容テキストを探すため格納する */
-            *hashItemEntryOrder = i;
-
-            ret = FUNCTION_SUCCESS;
-            break;
+            /* 探査対象の文字列との比較（同じタイトルが複数ある場合は最初のものを採用する） */
+            if(targets[t]._pending == JACIC_BOOL_TRUE &&
+                    targets[t]._order < 0 &&
+                    text._len == targets[t]._titleLength &&
+                    memcmp(text._ptr, targets[t]._title, text._len) == 0)
+            {
+                targets[t]._order = i;
+                --remaining;
+            }
         }
-
-        /* 取得したテキストの領域をゼロクリア */
-        memset(text, 0x00, strlen((char *)text));
     }
 
-    /* メモリ解放 */
-    free(text);
-    text = NULL;
+    /* タイトルが見つからなかった探索対象の結果を確定する */
+    remaining = 0;
 
-    return ret;
-}
-
-/*!
-@brief ハッシュ値を取得する。
-@param [in] rMetaItemText 対象となるメタデータ領域を切り取ったデータ構造体
-@param [out] retHash 取得したハッシュを格納する変数
-@param hashItemEntryOrder ハッシュ値の格納順
-@param entryCount 項目の最大エントリ数
-@retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_PARAMETER 不正な引数が指定された場合
-@retval INCORRECT_APP5_FORMAT APP5 領域が不正な形式の場合
-@retval INCORRECT_TEXT 指定した項目番号のテキストが不正な場合
-*/
-static int getHashData(HashBuffer *rMetaItemText, HashBuffer **retHash, int hashItemEntryOrder, unsigned short entryCount)
-{
-    int ret = FUNCTION_SUCCESS;
-    short i;
-    unsigned char *hashText = NULL;
-    unsigned long seek = 0UL;
-    size_t hashMemorySize = sizeof(HashBuffer) + BYTE_SIZE_HASH_LENGTH;
-    size_t maxByteSize = sizeof(HashBuffer) + rMetaItemText->_len * BYTE_SIZE_UNSIGNED_CHAR;
-
-    if(hashItemEntryOrder < 0 ||
-            entryCount < hashItemEntryOrder)
+    for(t = 0; t < targetCount; ++t)
     {
-        /* ハッシュの埋め込み位置を示す引数が 0 以下または最大エントリ数より多い */
-        return INCORRECT_PARAMETER;
-    }
-
-    /* 領域の最大数までメモリ確保 */
-    hashText = (unsigned char *) malloc(maxByteSize);
+        if(targets[t]._pending != JACIC_BOOL_TRUE) continue;
 
-    if(hashText == NULL)
-    {
-        /* メモリ確保に失敗 */
-        return OTHER_ERROR;
+        if(targets[t]._order < 0)
+        {
+            targets[t]._result = titleResult;
+            targets[t]._pending = JACIC_BOOL_FALSE;
+        }
+        else
+        {
+            ++remaining;
+        }
     }
 
-    /* 領域のゼロクリア */
-    memset(hashText, 0x00, maxByteSize);
+    /* 内容テキストを走査して、格納順に対応するハッシュ値を取得する */
+    seek = 0UL;
 
-    for(i = 0; i <= hashItemEntryOrder; ++i)
+    for(i = 0; remaining > 0; ++i)
     {
-        int funcRet;
+        int textRet;
 
-        /* テキスト項目格納 */
-        funcRet = getByteText(rMetaItemText, hashText, &seek, rMetaItemText->_len);
+        /* テキスト項目取得 */
+        textRet = getByteText(rMetaItemText128, &text, &seek);
 
-        if(funcRet != FUNCTION_SUCCESS)
+        for(t = 0; t < targetCount; ++t)
         {
-            /* 取得したテキストが不正 */
-            ret = INCORRECT_TEXT;
-            break;
-        }
+            if(targets[t]._pending != JACIC_BOOL_TRUE) continue;
 
-        if(i == hashItemEntryOrder)
-        {
-            /* 長さが 0 （終端文字のみ） */
-            if(strlen((char *)hashText) == 0)
+            if(textRet != FUNCTION_SUCCESS)
             {
-                /* テキストのフォーマット不正 */
-                ret = INCORRECT_TEXT;
-                break;
+                /* 取得したテキストが不正 */
+                targets[t]._result = INCORRECT_TEXT;
             }
-
-            /* ハッシュの文字列長と長さが合わない */
-            else if(strlen((char *)hashText) != BYTE_SIZE_HASH_LENGTH)
+            else if(targets[t]._order == i)
             {
-                /* テキストのフォーマット不正 */
-                ret = INCORRECT_TEXT;
-                break;
+                if(text._len != BYTE_SIZE_HASH_LENGTH)
+                {
+                    /* 長さが 0 （終端文字のみ）、またはハッシュの文字列長と長さが合わない */
+                    targets[t]._result = INCORRECT_TEXT;
+                }
+                else
+                {
+                    targets[t]._result = FUNCTION_SUCCESS;
+                    targets[t]._value = text;
+                }
             }
-
-            /* 領域の確保 */
-            *retHash = (HashBuffer *) malloc(hashMemorySize);
-
-            if(*retHash == NULL)
+            else if(rMetaItemText128->_len <= seek)
             {
-                /* メモリ確保に失敗 */
-                ret = OTHER_ERROR;
-                break;
+                /* 対象の格納順に達する前に走査位置が最大サイズを超えた */
+                targets[t]._result = INCORRECT_APP5_FORMAT;
+            }
+            else
+            {
+                /* 次の内容テキストへ */
+                continue;
             }
 
-            /* 取得した領域をゼロクリア */
-            memset(*retHash, 0x00, hashMemorySize);
-
-            /* ハッシュ文字列のコピー */
-            memcpy((*retHash)->_buff, hashText, BYTE_SIZE_HASH_LENGTH);
-            (*retHash)->_len = BYTE_SIZE_HASH_LENGTH;
-            break;
-        }
-
-        if(rMetaItemText->_len <= seek)
-        {
-            /* 走査位置が最大サイズを超えた */
-            ret = INCORRECT_APP5_FORMAT;
-            break;
+            targets[t]._pending = JACIC_BOOL_FALSE;
+            --remaining;
         }
-
-        /* 取得したテキストの領域をゼロクリア */
-        memset(hashText, 0x00, strlen((char *)hashText));
     }
-
-    /* メモリ解放 */
-    free(hashText);
-    hashText = NULL;
-
-    /* 処理の途中で失敗した場合のみ retHash を NULL に */
-    if(ret != FUNCTION_SUCCESS)
-    {
-        _SECURE_FREE(*retHash);
-    }
-
-    return ret;
 }
 
 /*!
-@brief 実データから指定したタイトルの項目を取得する。存在しない場合は NULL を設定する。
-@param [in] searchTitle 取得対象の項目テキストタイトル文字列
-@param [out] retItemValue 取得した内容テキストを格納するバイナリデータ構造体
-@param [in] rMetaItemText 取得対象の実データ（項目テキスト）
-@param [in] rMetaItemText128 取得対象の実データ（内容テキスト 128 ）
-@param entryCount セグメント内のメタデータ定義数
-@retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_PARAMETER 不正な引数が指定された場合
-@retval INCORRECT_APP5_FORMAT APP5 領域が不正な形式の場合
-@retval HASH_NOT_EXISTS ハッシュ値を示すエントリタイトルが見つからない場合
+@brief decodeRMetaHashItems で取得した結果を APP5 項目に設定する。
+@param [in] target 探索結果
+@param [out] retItemValue 取得した内容テキストを格納する構造体
+@return target->_result の値
 */
-static int getRMetaItemValue(const char *searchTitle, APP5Item  *retItemValue, HashBuffer *rMetaItemText, HashBuffer *rMetaItemText128, unsigned short entryCount)
+static int setRMetaItemValue(const RMetaHashTarget *target, APP5Item *retItemValue)
 {
-    int ret;
-    int hashEntryOrder = -1; /* ハッシュ値のアイテム位置 */
-    /* 項目テキスト 1 から項目テキストを取得 */
-    ret = seekValueOrder(searchTitle, rMetaItemText, &hashEntryOrder, entryCount);
-
-    if(ret == FUNCTION_SUCCESS)
+    if(target->_order >= 0)
     {
         /* タイトル文字列取得フラグを立てる */
         retItemValue->titleExistsFlag = JACIC_BOOL_TRUE;
+    }
 
-        /* 内容テキスト 128 から内容テキストの値を取得 */
-        ret = getHashData(rMetaItemText128, &(retItemValue->value), hashEntryOrder, entryCount);
+    if(target->_result == FUNCTION_SUCCESS)
+    {
+        /* 処理に成功した場合のみ内容テキストを設定する */
+        retItemValue->value = target->_value;
     }
 
-    return ret;
+    return target->_result;
 }
 
 /*!
@@ -1266,15 +1168,13 @@ static int getRMetaItemValue(const char *searchTitle, APP5Item  *retItemValue, H
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_APP5_FORMAT APP5 領域のフォーマット不正が原因でハッシュ値の取得に失敗した場合
 @retval HASH_NOT_EXISTS ハッシュ値が見つからない場合
-@retval OTHER_ERROR メモリ確保に失敗した場合
 */
 static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long *seek, unsigned short entryCount)
 {
     int ret = FUNCTION_SUCCESS;
     int funcRet;
-    HashBuffer *rMetaItemText1 = NULL;     /* 取得した項目テキスト */
-    HashBuffer *rMetaItemText128 = NULL;   /* 取得した内容テキスト */
-    size_t memorySize;                     /* 確保するメモリの大きさ */
+    ByteView rMetaItemText1 = {NULL, 0};   /* 取得した項目テキスト */
+    ByteView rMetaItemText128 = {NULL, 0}; /* 取得した内容テキスト */
 
     while(1)
     {
@@ -1296,58 +1196,48 @@ static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *
         if(rMetaItemId == APP5_RMETA_ITEM_TITLE_ID)
         {
             /* 項目テキスト 1 */
-            if(rMetaItemText1 != NULL)
+            if(rMetaItemText1._ptr != NULL)
             {
                 /* 同じカテゴリのデータが連続して来ているので不正なフォーマットとして終了 */
                 ret = INCORRECT_APP5_FORMAT;
                 break;
             }
 
-            /* 領域の確保 */
-            memorySize = sizeof(HashBuffer) + rMetaItemTextSize;
-            rMetaItemText1 = (HashBuffer *) malloc(memorySize);
-
-            if(rMetaItemText1 == NULL)
+            if(src->_len < *seek ||
+                    src->_len - *seek < rMetaItemTextSize)
             {
-                /* メモリ確保失敗 */
-                ret = OTHER_ERROR;
+                /* 読み込み画像の範囲外に出た場合は不正なフォーマットとして終了 */
+                ret = INCORRECT_APP5_FORMAT;
                 break;
             }
 
-            /* 領域のゼロクリア */
-            memset(rMetaItemText1, 0x00, memorySize);
-
-            memcpy(rMetaItemText1->_buff, &(src->_buff[*seek]), rMetaItemTextSize);
-            rMetaItemText1->_len = rMetaItemTextSize;
+            /* 領域を複製せずに参照する */
+            rMetaItemText1._ptr = &(src->_buff[*seek]);
+            rMetaItemText1._len = rMetaItemTextSize;
 
             *seek += rMetaItemTextSize;
         }
         else if(rMetaItemId == APP5_RMETA_ITEM_VALUE_ID)
         {
             /* 内容テキスト 128 */
-            if(rMetaItemText128 != NULL)
+            if(rMetaItemText128._ptr != NULL)
             {
                 /* 同じカテゴリのデータが連続して来ているので不正なフォーマットとして終了 */
                 ret = INCORRECT_APP5_FORMAT;
                 break;
             }
 
-            /* 領域の確保 */
-            memorySize = sizeof(HashBuffer) + rMetaItemTextSize;
-            rMetaItemText128 = (HashBuffer *) malloc(memorySize);
-
-            if(rMetaItemText128 == NULL)
+            if(src->_len < *seek ||
+                    src->_len - *seek < rMetaItemTextSize)
             {
-                /* メモリ確保失敗 */
-                ret = OTHER_ERROR;
+                /* 読み込み画像の範囲外に出た場合は不正なフォーマットとして終了 */
+                ret = INCORRECT_APP5_FORMAT;
                 break;
             }
 
-            /* 領域のゼロクリア */
-            memset(rMetaItemText128, 0x00, memorySize);
-
-            memcpy(rMetaItemText128->_buff, &(src->_buff[*seek]), rMetaItemTextSize);
-            rMetaItemText128->_len = rMetaItemTextSize;
+            /* 領域を複製せずに参照する */
+            rMetaItemText128._ptr = &(src->_buff[*seek]);
+            rMetaItemText128._len = rMetaItemTextSize;
 
             *seek += rMetaItemTextSize;
         }
@@ -1361,13 +1251,25 @@ static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *
         }
 
         /* 両方の領域を取得後に処理を行う */
-        if(rMetaItemText1 != NULL &&
-                rMetaItemText128 != NULL)
+        if(rMetaItemText1._ptr != NULL &&
+                rMetaItemText128._ptr != NULL)
         {
-            if(retImageHash->value == NULL)
+            RMetaHashTarget targets[2];
+
+            /* 取得済みでないハッシュ値のタイトルを、項目テキスト・内容テキストの 1 回の走査でまとめて探す */
+            targets[0]._title = APP5_HASH_IMAGE_TITLE_TEXT;
+            targets[0]._titleLength = sizeof(APP5_HASH_IMAGE_TITLE_TEXT) - 1;
+            targets[0]._pending = (retImageHash->value._ptr == NULL) ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+            targets[1]._title = APP5_HASH_DATE_TITLE_TEXT;
+            targets[1]._titleLength = sizeof(APP5_HASH_DATE_TITLE_TEXT) - 1;
+            targets[1]._pending = (retDateHash->value._ptr == NULL) ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+
+            decodeRMetaHashItems(&rMetaItemText1, &rMetaItemText128, entryCount, targets, 2);
+
+            if(retImageHash->value._ptr == NULL)
             {
                 /* 項目テキストから「改ざんチェック値（画像）」を取得 */
-                funcRet = getRMetaItemValue(APP5_HASH_IMAGE_TITLE_TEXT, retImageHash, rMetaItemText1, rMetaItemText128, entryCount);
+                funcRet = setRMetaItemValue(&targets[0], retImageHash);
 
                 if(funcRet != FUNCTION_SUCCESS &&
                         funcRet != INCORRECT_TEXT && /* ハッシュのタイトルはあるが値が誤り */
@@ -1379,10 +1281,10 @@ static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *
                 }
             }
 
-            if(retDateHash->value == NULL)
+            if(retDateHash->value._ptr == NULL)
             {
                 /* 項目テキストから「改ざんチェック値（撮影日時）」を取得 */
-                funcRet = getRMetaItemValue(APP5_HASH_DATE_TITLE_TEXT, retDateHash, rMetaItemText1, rMetaItemText128, entryCount);
+                funcRet = setRMetaItemValue(&targets[1], retDateHash);
 
                 if(funcRet != FUNCTION_SUCCESS &&
                         funcRet != INCORRECT_TEXT && /* ハッシュのタイトルはあるが値が誤り */
@@ -1394,8 +1296,8 @@ static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *
                 }
             }
 
-            if(retImageHash->value != NULL &&
-                    retDateHash->value != NULL)
+            if(retImageHash->value._ptr != NULL &&
+                    retDateHash->value._ptr != NULL)
             {
                 /* 両方のハッシュ値を取得できている場合は正常終了とする */
                 ret = FUNCTION_SUCCESS;
@@ -1412,16 +1314,13 @@ static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *
 
     }
 
-    /* メモリ解放 */
-    _SECURE_FREE(rMetaItemText1);
-    _SECURE_FREE(rMetaItemText128);
-
     return ret;
 }
 
 /*!
 @brief チェック対象画像の APP5 領域からハッシュ値を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
 @param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
 @param seek 走査開始位置
@@ -1433,7 +1332,7 @@ static int getRMetaHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *
 @retval HASH_NOT_EXISTS ハッシュ値が取得できない場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-static int _getHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek, const char *targetIdentifier, size_t identifierSize, unsigned short targetMetaVersion)
+static int _getHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek, const char *targetIdentifier, size_t identifierSize, unsigned short targetMetaVersion)
 {
     int ret = FUNCTION_SUCCESS;
     int app5ExistsResult;
@@ -1457,10 +1356,10 @@ static int _getHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retD
     while(1)
     {
         unsigned long app5EndNextIndex; /* APP5 領域終端“の次の”番地 */
-        unsigned short app5Size;        /* APP Size 自身を含むこのセグメントの終端までの長さ */
+        const JpegSegment *app5Segment; /* 索引に登録された APP5 セグメント */
 
         /* 画像からAPP5セグメントを検出する */
-        app5ExistsResult = checkApp5Exists(src, &seek);
+        app5ExistsResult = checkApp5Exists(src, index, &seek);
 
         if(app5ExistsResult != FUNCTION_SUCCESS)
         {
@@ -1475,20 +1374,16 @@ static int _getHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retD
             break;
         }
 
-        /* APP5 マーカーのバイトサイズ分走査位置を進める */
-        seek += BYTE_SIZE_SEGMENT_MARKER;
-
-        /* APP5 セグメントのサイズを取得 */
-        app5Size = getAppSize(src, seek);
+        app5Segment = &(index->_segments[findSegmentPosition(index, seek)]);
 
         /* APP5 セグメントの終端の次の番地を取得 */
-        app5EndNextIndex = seek + app5Size;
+        app5EndNextIndex = app5Segment->_nextOffset;
 
-        /* サイズ定義のバイトサイズ分走査位置を進める */
-        seek += BYTE_SIZE_SEGMENT_SIZE;
+        /* APP5 マーカーとサイズ定義のバイトサイズ分走査位置を進める */
+        seek += BYTE_SIZE_SEGMENT_MARKER + BYTE_SIZE_SEGMENT_SIZE;
 
-        /* セグメント識別名の取得（targetIdentifier ではない場合はこのセグメントを無視して次の APP5 セグメントへ） */
-        ret = checkIdentifier(targetIdentifier, src, &seek, identifierSize);
+        /* セグメント識別名の確認（targetIdentifier ではない場合はこのセグメントを無視して次の APP5 セグメントへ） */
+        ret = checkSegmentIdentifier(targetIdentifier, src, app5Segment, identifierSize);
 
         if(ret != FUNCTION_SUCCESS)
         {
@@ -1663,9 +1558,102 @@ static int _getHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retD
     return ret;
 }
 
+/*!
+@brief APP5 セグメントが本ライブラリの APP5_SEGMENT_DATA から作成されたものかを、ハッシュ値の埋め込み位置を除いて比較する。
+@param [in] segment 比較対象の APP5 セグメント（マーカーから sizeof(APP5_SEGMENT_DATA) バイト読み出せること）
+@retval JACIC_BOOL_TRUE ハッシュ値以外の全バイトが一致する場合
+@retval JACIC_BOOL_FALSE 一致しない場合
+*/
+static JACIC_BOOL matchApp5Template(const unsigned char *segment)
+{
+    const size_t imageHashEnd = APP5_IMAGE_HASH_INSERT_POSITION + BYTE_SIZE_HASH_LENGTH;
+    const size_t dateHashEnd = APP5_DATE_HASH_INSERT_POSITION + BYTE_SIZE_HASH_LENGTH;
+
+    /* セグメント長の定義を含む先頭側から比較し、異なるものを早く除外する */
+    if(memcmp(segment, APP5_SEGMENT_DATA, APP5_IMAGE_HASH_INSERT_POSITION) != 0)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    /* ハッシュ値（画像）とハッシュ値（撮影日時）の間 */
+    if(memcmp(segment + imageHashEnd, APP5_SEGMENT_DATA + imageHashEnd, APP5_DATE_HASH_INSERT_POSITION - imageHashEnd) != 0)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    /* ハッシュ値（撮影日時）以降 */
+    if(memcmp(segment + dateHashEnd, APP5_SEGMENT_DATA + dateHashEnd, sizeof(APP5_SEGMENT_DATA) - dateHashEnd) != 0)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    return JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 最初の APP5 セグメントが本ライブラリのテンプレートで書き込まれたものであれば、固定位置からハッシュ値を取得する。
+@details 汎用の DCPMI 解析で同じセグメントを解析した場合と同じ結果となる場合のみ成功とする。
+@param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
+@param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
+@retval JACIC_BOOL_TRUE ハッシュ値を取得できた場合
+@retval JACIC_BOOL_FALSE テンプレートと一致しない場合（汎用の解析で取得すること）
+*/
+static JACIC_BOOL getTemplateHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash)
+{
+    unsigned long seek = index->_startOffset;
+    const unsigned char *segment;
+
+    if(retImageHash->value._ptr != NULL ||
+            retDateHash->value._ptr != NULL)
+    {
+        /* 取得済みの値がある場合は汎用の解析に任せる */
+        return JACIC_BOOL_FALSE;
+    }
+
+    /* 汎用の解析と同じく、SOF などより前にある最初の APP5 セグメントを対象とする */
+    if(checkApp5Exists(src, index, &seek) != FUNCTION_SUCCESS)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    if(src->_len < seek ||
+            src->_len - seek < sizeof(APP5_SEGMENT_DATA))
+    {
+        /* セグメントが読み込み画像の範囲外に出る */
+        return JACIC_BOOL_FALSE;
+    }
+
+    segment = &(src->_buff[seek]);
+
+    if(matchApp5Template(segment) != JACIC_BOOL_TRUE)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    /* 終端文字を含むハッシュ値は、汎用の解析では長さ不正となるため除外する */
+    if(memchr(segment + APP5_IMAGE_HASH_INSERT_POSITION, 0x00, BYTE_SIZE_HASH_LENGTH) != NULL ||
+            memchr(segment + APP5_DATE_HASH_INSERT_POSITION, 0x00, BYTE_SIZE_HASH_LENGTH) != NULL)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    retImageHash->titleExistsFlag = JACIC_BOOL_TRUE;
+    retImageHash->value._ptr = segment + APP5_IMAGE_HASH_INSERT_POSITION;
+    retImageHash->value._len = BYTE_SIZE_HASH_LENGTH;
+
+    retDateHash->titleExistsFlag = JACIC_BOOL_TRUE;
+    retDateHash->value._ptr = segment + APP5_DATE_HASH_INSERT_POSITION;
+    retDateHash->value._len = BYTE_SIZE_HASH_LENGTH;
+
+    return JACIC_BOOL_TRUE;
+}
+
 /*!
 @brief チェック対象画像の APP5 領域 (RMETA) からハッシュ値を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
 @param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
 @param seek 走査開始位置
@@ -1675,14 +1663,15 @@ static int _getHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retD
 @retval HASH_NOT_EXISTS ハッシュ値が取得できない場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int _getRMETAHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek)
+int _getRMETAHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek)
 {
-    return _getHashValue(src, retImageHash, retDateHash, seek, IDENTIFIER_RMETA, BYTE_SIZE_RMETA_IDENTIFIER_SIZE, APP5_RMETA_VERSION);
+    return _getHashValue(src, index, retImageHash, retDateHash, seek, IDENTIFIER_RMETA, BYTE_SIZE_RMETA_IDENTIFIER_SIZE, APP5_RMETA_VERSION);
 }
 
 /*!
 @brief チェック対象画像の APP5 領域 (DCPMI) からハッシュ値を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
 @param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
 @param seek 走査開始位置
@@ -1692,14 +1681,15 @@ int _getRMETAHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDat
 @retval HASH_NOT_EXISTS ハッシュ値が取得できない場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int _getDCPMIHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek)
+int _getDCPMIHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek)
 {
-    return _getHashValue(src, retImageHash, retDateHash, seek, IDENTIFIER_DCPMI, BYTE_SIZE_DCPMI_IDENTIFIER_SIZE, APP5_DCPMI_VERSION);
+    return _getHashValue(src, index, retImageHash, retDateHash, seek, IDENTIFIER_DCPMI, BYTE_SIZE_DCPMI_IDENTIFIER_SIZE, APP5_DCPMI_VERSION);
 }
 
 /*!
 @brief チェック対象画像の APP5 領域からハッシュ値を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
 @param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
 @retval FUNCTION_SUCCESS 正常終了
@@ -1709,23 +1699,30 @@ int _getDCPMIHashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDat
 @retval HASH_NOT_EXISTS ハッシュ値が取得できない場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int getAPP5HashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateHash)
+int getAPP5HashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash)
 {
     int ret = FUNCTION_SUCCESS;
     unsigned long seek = 0UL;
     int dcpmiRet;
     int rmetaRet;
 
-    /* SOI を検出する（検出できなければ Exif 形式のエラー） */
-    ret = checkFirstFindSOI(src, &seek);
-    if(ret != FUNCTION_SUCCESS)
+    /* パラメータチェック */
+    if(src == NULL || index == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    /* 本ライブラリが書き込んだ APP5 セグメントであれば、解析せずに固定位置から取得する */
+    if(getTemplateHashValue(src, index, retImageHash, retDateHash) == JACIC_BOOL_TRUE)
     {
-        /* 不正な Exif フォーマット */
         goto FINALIZE;
     }
 
+    /* SOI の次から走査する */
+    seek = index->_startOffset;
+
     /* APP5 セグメント (DCPMI) 内のハッシュ値を確認、取得 */
-    dcpmiRet = _getDCPMIHashValue(src, retImageHash, retDateHash, seek);
+    dcpmiRet = _getDCPMIHashValue(src, index, retImageHash, retDateHash, seek);
 
     if(dcpmiRet != FUNCTION_SUCCESS)
     {
@@ -1737,7 +1734,7 @@ int getAPP5HashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateH
         }
 
         /* APP5 セグメント (RMETA) 内のハッシュ値を確認、取得 */
-        rmetaRet = _getRMETAHashValue(src, retImageHash, retDateHash, seek);
+        rmetaRet = _getRMETAHashValue(src, index, retImageHash, retDateHash, seek);
 
         if(rmetaRet != FUNCTION_SUCCESS)
         {
@@ -1763,8 +1760,10 @@ FINALIZE:
 /*!
 @brief `src` の APP5 領域に対し、`imgHash` と `dateHash` を埋め込んだ結果を `output` に格納する。
 @param src ハッシュ埋め込み対象となる画像データのバッファ
+@param index src から作成したセグメント索引
 @param imgHash 画像から計算したハッシュ値
 @param dateHash 原画像データの生成日時から計算したハッシュ値
+@param arena 作業用の APP5 セグメント領域データの割り当て元となるアリーナ
 @param dst 埋め込み後のデータを格納するポインタ
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
@@ -1772,7 +1771,7 @@ FINALIZE:
 @retval APP5_ALREADY_EXISTS APP5 領域が既に存在する場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int writeApp5ToBuff(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, JpegBuffer **dst)
+int writeApp5ToBuff(JpegBuffer *src, const JpegSegmentIndex *index, HashBuffer *imgHash, HashBuffer *dateHash, Arena *arena, JpegBuffer **dst)
 {
     int ret = FUNCTION_SUCCESS;
     unsigned long insPos = 0UL;
@@ -1801,10 +1800,15 @@ int writeApp5ToBuff(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash,
         return INCORRECT_PARAMETER;
     }
 
+    if(arena == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
     outBuffLength = src->_len + app5Length;
 
-    /* APP5セグメント領域データの作成 */
-    app5 = (HashBuffer *) malloc(sizeof(HashBuffer *) + app5Length);
+    /* APP5セグメント領域データの作成（アリーナから割り当てた領域はゼロクリア済み） */
+    app5 = arenaAllocateBinaryData(arena, app5Length);
 
     if(app5 == NULL)
     {
@@ -1812,12 +1816,6 @@ int writeApp5ToBuff(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash,
         return OTHER_ERROR;
     }
 
-    app5->_len = app5Length;
-
-
-    /* APP5 領域のゼロクリア */
-    memset(app5->_buff, 0x00, app5->_len);
-
     /* APP5 領域デフォルトデータの作成 */
     memcpy(app5->_buff, APP5_SEGMENT_DATA, app5->_len);
 
@@ -1836,27 +1834,23 @@ int writeApp5ToBuff(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash,
     }
 
     /* APP5 の埋め込み位置を走査 */
-    ret = getApp5InsertPosition(src, &insPos);
+    ret = getApp5InsertPosition(src, index, &insPos);
     if(ret != FUNCTION_SUCCESS)
     {
         goto FINALIZE;
     }
 
     /* APP5 セグメント領域データ分を追加したサイズのバッファを用意 */
-    *dst = (HashBuffer *) malloc(sizeof(HashBuffer *) + outBuffLength);
+    /* 全体をコピーで埋めるため、領域のゼロクリアは行わない */
+    *dst = allocateBinaryDataUninitialized(outBuffLength);
 
-    if(dst == NULL)
+    if(*dst == NULL)
     {
         /* メモリ確保失敗 */
         ret = OTHER_ERROR;
         goto FINALIZE;
     }
 
-    (*dst)->_len = outBuffLength;
-
-    /* 領域のゼロクリア */
-    memset((*dst)->_buff, 0x00, (*dst)->_len);
-
     /* 元データ前半部をコピー */
     memcpy((*dst)->_buff, src->_buff, insPos);
 
@@ -1868,10 +1862,6 @@ int writeApp5ToBuff(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash,
 
 
 FINALIZE:
-    /* メモリ解放 */
-
-    free(app5);
-    app5 = NULL;
 
     return ret;
 }
@@ -10,6 +10,7 @@
 #define APP5_H_
 
 #include "common.h"
+#include "exif.h"
 
 /*!
 @struct RMetaItem
@@ -18,30 +19,34 @@
 typedef struct
 {
     JACIC_BOOL titleExistsFlag; /*!< @brief 項目テキスト存在フラグ */
-    HashBuffer *value;          /*!< @brief 内容テキストバッファ */
+    ByteView value;             /*!< @brief 内容テキスト（読み込み結果の該当範囲を参照する。見つからない場合は _ptr が NULL） */
 } APP5Item;
 
 /*!
 @brief Exif ファイルに格納されている APP5 領域の存在確認とその開始位置を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [in, out] seek 取得する走査開始位置
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER いずれかの引数が NULL, または走査不可能な位置が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP5_NOT_EXISTS APP1 領域が見つからなかった場合
 */
-int checkApp5Exists(JpegBuffer *src, unsigned long *seek);
+int checkApp5Exists(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *seek);
 
 /*!
 @brief 改ざんチェック用の APP5 領域を JPEG 画像に埋め込んで保存する。
 @details JPEG 画像データを先頭から走査していき、最初に見つかった
 @details 次のセグメント ( APP6 ～ APP15、DQT、DHT、DRI、SOF、SOS ) の前に、
 @details APP5 セグメント領域を追加する。
+@details 埋め込み後の画像全体をメモリ上に作成せず、元データ前半部・APP5 データ・元データ後半部を順に書き出す。
 @remarks ※スマートフォン (HUAWEI P8Lite) で APP1 -> APP0 の順番でセグメントが並んでいる
 @remarks   ケースがあったので、上記ルールにて APP5 セグメント領域を追加する。
 @param [in] src JPEG画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [in] imgHash 埋め込むハッシュ値（画像）
 @param [in] dateHash 埋め込むハッシュ値（原画像生成日時）
+@param arena 作業用の APP5 セグメント領域データの割り当て元となるアリーナ
 @param [in] dst 出力先ファイルパス
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
@@ -52,11 +57,12 @@ int checkApp5Exists(JpegBuffer *src, unsigned long *seek);
 @retval APP5_ALREADY_EXISTS APP5 領域が既に存在する場合
 @retval OTHER_ERROR メモリの確保に失敗した場合
 */
-int writeApp5(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, const char *dst);
+int writeApp5(JpegBuffer *src, const JpegSegmentIndex *index, HashBuffer *imgHash, HashBuffer *dateHash, Arena *arena, const char *dst);
 
 /*!
 @brief チェック対象画像の APP5 領域からハッシュ値を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
 @param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
 @param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
 @retval FUNCTION_SUCCESS 正常終了
@@ -66,18 +72,20 @@ int writeApp5(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, const
 @retval HASH_NOT_EXISTS ハッシュ値が取得できない場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int getAPP5HashValue(JpegBuffer *src, APP5Item *retImageHash, APP5Item *retDateHash);
+int getAPP5HashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash);
 
 /*!
 @brief `src` の APP5 領域に対し、`imgHash` と `dateHash` を埋め込んだ結果を `output` に格納する。
 @param src ハッシュ埋め込み対象となる画像データのバッファ
+@param index src から作成したセグメント索引
 @param imgHash 画像から計算したハッシュ値
 @param dateHash 原画像データの生成日時から計算したハッシュ値
+@param arena 作業用の APP5 セグメント領域データの割り当て元となるアリーナ
 @param dst 埋め込み後のデータを格納するポインタ
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int writeApp5ToBuff(JpegBuffer *src, HashBuffer *imgHash, HashBuffer *dateHash, JpegBuffer **dst);
+int writeApp5ToBuff(JpegBuffer *src, const JpegSegmentIndex *index, HashBuffer *imgHash, HashBuffer *dateHash, Arena *arena, JpegBuffer **dst);
 
 #endif /* APP5_H_ */
@@ -11,6 +11,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !defined(JCOMSIA_DISABLE_VECTOR_BASE64)
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSSE3__)
+#include <tmmintrin.h>
+#define BASE64_ENCODE_SSSE3     /*!< @brief SSSE3 命令で 12 バイトずつまとめてエンコードする */
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BASE64_ENCODE_NEON      /*!< @brief NEON 命令で 48 バイトずつまとめてエンコードする */
+#endif
+#endif
+
 /*! Base64 変換テーブルのサイズ */
 #define TABLE_SIZE 64
 
@@ -46,6 +56,155 @@ size_t _getBase64EncodedSize(size_t srcLength)
     return encodedLength;
 }
 
+#if defined(BASE64_ENCODE_SSSE3)
+/*!
+@brief 16 バイト読み込んだうちの先頭 12 バイトを、変換テーブル上の位置（ 6 bit 単位の値 16 個）に並べ替える。
+@param in 読み込んだ 16 バイト
+@return 各バイトに 6 bit ずつ格納した値
+*/
+static __m128i _encodeReshuffle(__m128i in)
+{
+    __m128i t0, t1, t2, t3;
+
+    /* 3 バイトずつ、 [b1, b0, b2, b1] の順に 4 バイトへ広げる */
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    /* 乗算によるシフトで、各 32 bit 内の 6 bit 単位の値をバイトごとに取り出す */
+    t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+    return _mm_or_si128(t1, t3);
+}
+
+/*!
+@brief 変換テーブル上の位置 16 個を、 Base64 の文字に変換する。
+@param in 各バイトに 6 bit ずつ格納した値
+@return Base64 の文字 16 個
+*/
+static __m128i _encodeTranslate(__m128i in)
+{
+    /* 値の範囲（ 0-25, 26-51, 52-61, 62, 63 ）ごとに、文字コードとの差分を加える */
+    const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    __m128i mask = _mm_cmpgt_epi8(in, _mm_set1_epi8(25));
+
+    indices = _mm_sub_epi8(indices, mask);
+
+    return _mm_add_epi8(in, _mm_shuffle_epi8(offsets, indices));
+}
+#endif
+
+/*!
+@brief バイト配列の先頭から、ベクトル命令で一度に処理できる単位の分だけ Base64 エンコードする。
+@param srcData エンコード元のバイト配列
+@param srcLength エンコード元のバイト配列長
+@param [out] dstStr エンコード後の文字列
+@return エンコードしたバイト数（ 3 の倍数。ベクトル命令を使用しない場合は 0 ）
+*/
+static size_t _encodeBlocks(const unsigned char *srcData, size_t srcLength, char *dstStr)
+{
+    size_t done = 0;
+
+#if defined(BASE64_ENCODE_SSSE3)
+    /* 12 バイトを変換するごとに 16 バイトを読み込むため、末尾の 4 バイトは残す */
+    while(srcLength - done >= 16)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i *) (srcData + done));
+
+        _mm_storeu_si128((__m128i *) dstStr, _encodeTranslate(_encodeReshuffle(in)));
+
+        done += 12;
+        dstStr += 16;
+    }
+#elif defined(BASE64_ENCODE_NEON)
+    uint8x16x4_t lookup;
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+
+    lookup.val[0] = vld1q_u8((const unsigned char *) table);
+    lookup.val[1] = vld1q_u8((const unsigned char *) table + 16);
+    lookup.val[2] = vld1q_u8((const unsigned char *) table + 32);
+    lookup.val[3] = vld1q_u8((const unsigned char *) table + 48);
+
+    while(srcLength - done >= 48)
+    {
+        /* 3 バイトずつ 3 つのレーンに分けて読み込み、 4 文字ずつ 4 つのレーンから書き込む */
+        uint8x16x3_t in = vld3q_u8(srcData + done);
+        uint8x16x4_t out;
+
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+
+        out.val[0] = vqtbl4q_u8(lookup, out.val[0]);
+        out.val[1] = vqtbl4q_u8(lookup, out.val[1]);
+        out.val[2] = vqtbl4q_u8(lookup, out.val[2]);
+        out.val[3] = vqtbl4q_u8(lookup, out.val[3]);
+
+        vst4q_u8((unsigned char *) dstStr, out);
+
+        done += 48;
+        dstStr += 64;
+    }
+#else
+    (void) srcData;
+    (void) srcLength;
+    (void) dstStr;
+#endif
+
+    return done;
+}
+
+/*!
+@brief バイト配列を Base64 エンコードし、呼び出し元が用意した領域へ書き込む。
+@details 分割してエンコードする場合は、最後以外の呼び出しで srcLength を 3 の倍数とすること（端数は '=' で埋める）。
+@param srcData エンコード元のバイト配列
+@param srcLength エンコード元のバイト配列長
+@param [out] dstStr エンコード後の文字列（ (srcLength + 2) / 3 * 4 バイト以上の長さを持つこと）。NULL 終端しない。
+@return dstStr に書き込んだ文字数
+*/
+size_t base64EncodeChunk(const unsigned char *srcData, size_t srcLength, char *dstStr)
+{
+    size_t done;
+    size_t written;
+
+    if(srcData == NULL || dstStr == NULL) return 0;
+
+    done = _encodeBlocks(srcData, srcLength, dstStr);
+    written = done / 3 * 4;
+
+    while(srcLength - done >= 3)
+    {
+        dstStr[written + 0] = table[ (srcData[done + 0] >> 2) & 0x3f];
+        dstStr[written + 1] = table[((srcData[done + 0] << 4) & 0x30) | ((srcData[done + 1] >> 4) & 0xf)];
+        dstStr[written + 2] = table[((srcData[done + 1] << 2) & 0x3c) | ((srcData[done + 2] >> 6) & 0x3)];
+        dstStr[written + 3] = table[  srcData[done + 2]       & 0x3f];
+        done += 3;
+        written += 4;
+    }
+
+    if(srcLength - done == 2)
+    {
+        dstStr[written + 0] = table[ (srcData[done + 0] >> 2) & 0x3f];
+        dstStr[written + 1] = table[((srcData[done + 0] << 4) & 0x30) | ((srcData[done + 1] >> 4) & 0xf)];
+        dstStr[written + 2] = table[ (srcData[done + 1] << 2) & 0x3c];
+        dstStr[written + 3] = '=';
+        written += 4;
+    }
+    else if(srcLength - done == 1)
+    {
+        dstStr[written + 0] = table[ (srcData[done + 0] >> 2) & 0x3f];
+        dstStr[written + 1] = table[ (srcData[done + 0] << 4) & 0x30];
+        dstStr[written + 2] = '=';
+        dstStr[written + 3] = '=';
+        written += 4;
+    }
+
+    return written;
+}
+
 /*!
 @brief 文字列を Base64 エンコードし、結果を文字列として返す。
 @param srcData エンコード元のバイト配列
@@ -55,8 +214,6 @@ size_t _getBase64EncodedSize(size_t srcLength)
 */
 size_t base64Encode(const unsigned char *srcData, size_t srcLength, char **dstStr)
 {
-    int i;
-    size_t remain;
     size_t encodedLength;
 
     if(srcData == NULL) return 0;
@@ -68,7 +225,6 @@ size_t base64Encode(const unsigned char *srcData, size_t srcLength, char **dstSt
         return 1;
     }
 
-    remain = srcLength;
     encodedLength = _getBase64EncodedSize(srcLength);
 
     *dstStr = malloc(encodedLength + 1);
@@ -76,38 +232,9 @@ size_t base64Encode(const unsigned char *srcData, size_t srcLength, char **dstSt
     {
         return 0;
     }
-    memset(*dstStr, '\0', encodedLength + 1);
-
-    i = 0;
 
-    while(0 < remain)
-    {
-        if(remain >= 3)
-        {
-            (*dstStr)[4 * i + 0] = table[ (srcData[3 * i + 0] >> 2) & 0x3f];
-            (*dstStr)[4 * i + 1] = table[((srcData[3 * i + 0] << 4) & 0x30) | ((srcData[3 * i + 1] >> 4) & 0xf)];
-            (*dstStr)[4 * i + 2] = table[((srcData[3 * i + 1] << 2) & 0x3c) | ((srcData[3 * i + 2] >> 6) & 0x3)];
-            (*dstStr)[4 * i + 3] = table[  srcData[3 * i + 2]       & 0x3f];
-            remain -= 3;
-        }
-        else if(remain == 2)
-        {
-            (*dstStr)[4 * i + 0] = table[ (srcData[3 * i + 0] >> 2) & 0x3f];
-            (*dstStr)[4 * i + 1] = table[((srcData[3 * i + 0] << 4) & 0x30) | ((srcData[3 * i + 1] >> 4) & 0xf)];
-            (*dstStr)[4 * i + 2] = table[ (srcData[3 * i + 1] << 2) & 0x3c];
-            (*dstStr)[4 * i + 3] = '=';
-            remain -= 2;
-        }
-        else /* remain == 1 */
-        {
-            (*dstStr)[4 * i + 0] = table[ (srcData[3 * i + 0] >> 2) & 0x3f];
-            (*dstStr)[4 * i + 1] = table[ (srcData[3 * i + 0] << 4) & 0x30];
-            (*dstStr)[4 * i + 2] = '=';
-            (*dstStr)[4 * i + 3] = '=';
-            remain -= 1;
-        }
-        i++;
-    }
+    base64EncodeChunk(srcData, srcLength, *dstStr);
+    (*dstStr)[encodedLength] = '\0';
 
     return encodedLength;
 }
@@ -262,6 +389,102 @@ size_t base64Decode(const char *srcStr, size_t srcLength, unsigned char **dstDat
     return decodedLength;
 }
 
+/*!
+@brief Base64 の 1 文字を変換テーブル上の位置に変換する。
+@param c 変換する文字
+@return 変換テーブル上の位置。変換テーブルにない文字の場合は -1
+*/
+static int _base64Value(char c)
+{
+    if('A' <= c && c <= 'Z') return c - 'A';
+    if('a' <= c && c <= 'z') return c - 'a' + 26;
+    if('0' <= c && c <= '9') return c - '0' + 52;
+    if(c == '+') return 62;
+    if(c == '/') return 63;
+
+    return -1;
+}
+
+void base64DecoderInit(Base64Decoder *decoder)
+{
+    if(decoder == NULL) return;
+
+    decoder->_quadLength = 0;
+    decoder->_length = 0;
+    decoder->_paddingCount = 0;
+    decoder->_failed = JACIC_BOOL_FALSE;
+}
+
+size_t base64DecodeChunk(Base64Decoder *decoder, const char *srcStr, size_t srcLength, unsigned char *dstData)
+{
+    size_t i;
+    size_t decodedLength = 0;
+    unsigned char *quad;
+    int value;
+
+    if(decoder == NULL || srcStr == NULL || dstData == NULL) return 0;
+
+    quad = decoder->_quad;
+
+    for(i = 0; i < srcLength && decoder->_failed == JACIC_BOOL_FALSE; i++)
+    {
+        if(srcStr[i] == '=')
+        {
+            /* '=' は 4 文字の組の 3, 4 文字目にのみ置くことができる */
+            if(decoder->_quadLength < 2)
+            {
+                decoder->_failed = JACIC_BOOL_TRUE;
+                break;
+            }
+
+            decoder->_paddingCount++;
+            quad[decoder->_quadLength++] = 0;
+        }
+        else
+        {
+            value = _base64Value(srcStr[i]);
+
+            /* '=' の後に '=' 以外の文字を検出した、または Base64 で許容する文字以外を検出した */
+            if(0 < decoder->_paddingCount || value < 0)
+            {
+                decoder->_failed = JACIC_BOOL_TRUE;
+                break;
+            }
+
+            quad[decoder->_quadLength++] = (unsigned char)value;
+        }
+
+        decoder->_length++;
+
+        if(decoder->_quadLength < 4) continue;
+
+        /* '=' の数だけ末尾のバイトを減らす */
+        dstData[decodedLength++] = ((quad[0] << 2) & 0xfc) | ((quad[1] >> 4) & 0x3);
+        if(decoder->_paddingCount < 2)
+        {
+            dstData[decodedLength++] = ((quad[1] << 4) & 0xf0) | ((quad[2] >> 2) & 0xf);
+        }
+        if(decoder->_paddingCount < 1)
+        {
+            dstData[decodedLength++] = ((quad[2] << 6) & 0xc0) | ( quad[3]       & 0x3f);
+        }
+
+        decoder->_quadLength = 0;
+    }
+
+    return decodedLength;
+}
+
+JACIC_BOOL base64DecoderFinish(const Base64Decoder *decoder)
+{
+    if(decoder == NULL) return JACIC_BOOL_FALSE;
+
+    if(decoder->_failed == JACIC_BOOL_TRUE) return JACIC_BOOL_FALSE;
+    if(decoder->_length == 0 || decoder->_quadLength != 0) return JACIC_BOOL_FALSE;
+
+    return JACIC_BOOL_TRUE;
+}
+
 /*!
 @}
 
@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 
+#include "common.h"
+
 /*!
 @name Base64 関連定数定義
 @{
@@ -24,6 +26,20 @@ extern const char *BASE64_URL_PREFIX_JPEG;
 
 /*! @} */
 
+/*!
+@struct Base64Decoder
+@brief Base64 文字列を分割して受け取り、逐次デコードするためのコンテキスト
+@details 末尾以外に '=' を含むもの、4 の倍数の長さでないものなど、base64Decode が受け付けない文字列は不正として扱う。
+*/
+typedef struct
+{
+    unsigned char _quad[4];     /*!< @brief 4 文字に満たない未処理の文字（変換テーブル上の位置） */
+    size_t _quadLength;         /*!< @brief _quad に保持している文字数 */
+    size_t _length;             /*!< @brief これまでに受け取った文字数 */
+    size_t _paddingCount;       /*!< @brief 受け取った末尾の '=' の数 */
+    JACIC_BOOL _failed;         /*!< @brief 不正な文字を受け取ったか */
+} Base64Decoder;
+
 
 /*!
 @brief 文字列を Base64 エンコードし、結果を文字列として返す。
@@ -34,6 +50,17 @@ extern const char *BASE64_URL_PREFIX_JPEG;
 */
 size_t base64Encode(const unsigned char *srcData, size_t srcLength, char **dstStr);
 
+/*!
+@brief バイト配列を Base64 エンコードし、呼び出し元が用意した領域へ書き込む。
+@details 分割してエンコードする場合は、最後以外の呼び出しで srcLength を 3 の倍数とすること（端数は '=' で埋める）。
+結果は base64Encode で一度にエンコードした場合と等しい。
+@param srcData エンコード元のバイト配列
+@param srcLength エンコード元のバイト配列長
+@param [out] dstStr エンコード後の文字列（ (srcLength + 2) / 3 * 4 バイト以上の長さを持つこと）。NULL 終端しない。
+@return dstStr に書き込んだ文字数
+*/
+size_t base64EncodeChunk(const unsigned char *srcData, size_t srcLength, char *dstStr);
+
 /*!
 @brief 文字列を Base64 デコードし、結果をバイト配列として返す。
 @param srcStr デコード元の文字列
@@ -43,6 +70,32 @@ size_t base64Encode(const unsigned char *srcData, size_t srcLength, char **dstSt
 */
 size_t base64Decode(const char *srcStr, size_t srcLength, unsigned char **dstData);
 
+/*!
+@brief Base64 文字列の逐次デコードを開始するため、コンテキストを初期化する。
+@param [out] decoder 初期化対象のコンテキスト
+*/
+void base64DecoderInit(Base64Decoder *decoder);
+
+/*!
+@brief Base64 文字列の続きを受け取ってデコードする。
+@details 4 文字に満たない端数はコンテキスト内に保持し、次回以降の呼び出しでデコードする。
+不正な文字を受け取った場合は、それ以降何もデコードしない。
+@param [in, out] decoder base64DecoderInit で初期化済みのコンテキスト
+@param [in] srcStr デコード元の文字列
+@param srcLength デコード元の文字列長
+@param [out] dstData デコード後のバイト配列（ srcLength / 4 * 3 + 3 バイト以上の長さを持つこと）
+@return dstData に書き込んだバイト数
+*/
+size_t base64DecodeChunk(Base64Decoder *decoder, const char *srcStr, size_t srcLength, unsigned char *dstData);
+
+/*!
+@brief すべての文字列を受け取った後に呼び出し、正しい Base64 文字列であったかを返す。
+@param [in] decoder base64DecodeChunk ですべての文字列を渡したコンテキスト
+@retval JACIC_BOOL_TRUE 1 文字以上の正しい Base64 文字列であった（ base64Decode と同じ結果をデコードした）
+@retval JACIC_BOOL_FALSE 不正な文字列であった
+*/
+JACIC_BOOL base64DecoderFinish(const Base64Decoder *decoder);
+
 /*!
 @brief SVG から抜き出した Base64 形式の xlink からデータ URL として扱うために必要な接頭辞 `data:[<mediatype>][;base64],` を削除し、純粋な Base64 部分のみを取得する。
 @param srcStr NULL 終端されたデータ URL 文字列
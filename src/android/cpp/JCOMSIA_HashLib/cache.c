@@ -0,0 +1,474 @@
+﻿/*!
+@file cache.c
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief 検証結果キャッシュ
+@details 検証結果を、ファイルの識別情報（デバイス、i ノード番号、サイズ、更新日時、状態変更日時）とともに
+固定長のスロットを並べたファイルに記録する。ファイルは共有マップで参照し、複数のスレッド・プロセスから同時に使用できる。
+各スロットは書き込み回数を示すシーケンス番号を持ち、読み込み側はロックを取らずに、読み込みの前後で番号が変わっていないことを確認する。
+マップした領域自体は、検索・記録の間 cacheLock の読み込みロックを取って参照し、開き直す・閉じる際は書き込みロックを取って解放する。
+*/
+
+#if !defined(_MSC_VER) && !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L     /*!< @brief stat の st_mtim, st_ctim, ftruncate, pthread_rwlock を使用する */
+#endif
+
+#include <string.h>
+
+#include "cache.h"
+
+#if !defined(_MSC_VER) && !defined(JCOMSIA_DISABLE_VERIFICATION_CACHE)
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#define VERIFICATION_CACHE          /*!< @brief 検証結果キャッシュを使用する */
+#endif
+
+#define CACHE_MAGIC             ((uint32_t) 0x4356434a)     /*!< @brief キャッシュファイルの識別子（ "JCVC" ） */
+#define CACHE_FORMAT_VERSION    ((uint32_t) 2)              /*!< @brief キャッシュファイルの形式のバージョン（ 2 : 状態変更日時を追加し、ハッシュ値を削除） */
+#define CACHE_HEADER_SIZE       ((size_t) 64)               /*!< @brief キャッシュファイル先頭の管理情報のバイト数 */
+#define CACHE_SLOT_COUNT        ((size_t) 16384)            /*!< @brief スロット数（ 2 のべき乗） */
+#define CACHE_PROBE_COUNT       ((size_t) 8)                /*!< @brief 1 つのファイルに対して調べるスロット数 */
+#define CACHE_RACY_SECONDS      2                           /*!< @brief 更新日時・状態変更日時がこの秒数以内のファイルは、同じ日時のまま変更される可能性があるため記録しない */
+
+/*!
+@struct _cacheHeader
+@brief キャッシュファイル先頭の管理情報
+*/
+struct _cacheHeader
+{
+    uint32_t _magic;        /*!< @brief CACHE_MAGIC（初期化の最後に書き込む） */
+    uint32_t _version;      /*!< @brief CACHE_FORMAT_VERSION */
+    uint32_t _slotCount;    /*!< @brief スロット数 */
+    uint32_t _slotSize;     /*!< @brief 1 スロットのバイト数 */
+};
+
+/*!
+@struct _cacheSlot
+@brief 1 ファイル分の検証結果
+@details 全ての項目を 32 / 64 ビット単位で不可分に読み書きする。
+*/
+struct _cacheSlot
+{
+    uint32_t _sequence;                             /*!< @brief シーケンス番号（ 0 : 未使用、奇数 : 書き込み中） */
+    uint32_t _kind;                                 /*!< @brief 検証結果の種別 */
+    uint32_t _result;                               /*!< @brief 検証結果（公開 API の戻り値） */
+    uint32_t _reserved;                             /*!< @brief 予約 */
+    uint64_t _device;                               /*!< @brief ファイルのあるデバイス */
+    uint64_t _inode;                                /*!< @brief ファイルの i ノード番号 */
+    uint64_t _size;                                 /*!< @brief ファイルサイズ */
+    uint64_t _mtimeNs;                              /*!< @brief ファイルの更新日時（ナノ秒） */
+    uint64_t _ctimeNs;                              /*!< @brief ファイルの状態変更日時（ナノ秒） */
+};
+
+#if defined(VERIFICATION_CACHE)
+
+/*!
+@brief マップしたキャッシュファイルの先頭（開いていない場合は NULL ）
+*/
+static unsigned char *cacheBase = NULL;
+
+/*!
+@brief cacheBase とマップした領域を保護するロック（検索・記録は読み込みロック、開き直す・閉じる際は書き込みロックを取る）
+*/
+static pthread_rwlock_t cacheLock = PTHREAD_RWLOCK_INITIALIZER;
+
+/*!
+@brief マップしたキャッシュファイルのバイト数
+*/
+static const size_t cacheLength = CACHE_HEADER_SIZE + CACHE_SLOT_COUNT * sizeof(struct _cacheSlot);
+
+/*!
+@struct CacheSlotSnapshot
+@brief 1 ファイル分の検証結果を読み込んだ内容
+*/
+typedef struct
+{
+    uint32_t _sequence;     /*!< @brief 読み込み開始時のシーケンス番号 */
+    uint32_t _kind;         /*!< @brief 検証結果の種別 */
+    int _result;            /*!< @brief 検証結果 */
+    uint64_t _device;       /*!< @brief ファイルのあるデバイス */
+    uint64_t _inode;        /*!< @brief ファイルの i ノード番号 */
+    uint64_t _size;         /*!< @brief ファイルサイズ */
+    uint64_t _mtimeNs;      /*!< @brief ファイルの更新日時（ナノ秒） */
+    uint64_t _ctimeNs;      /*!< @brief ファイルの状態変更日時（ナノ秒） */
+} CacheSlotSnapshot;
+
+/*!
+@brief filePath の識別情報を取得する。
+@param [in] filePath 対象のファイルパス
+@param kind 検証結果の種別
+@param [out] key 取得した識別情報
+@retval JACIC_BOOL_TRUE 取得できた
+@retval JACIC_BOOL_FALSE 通常のファイルではない、または取得できなかった
+*/
+static JACIC_BOOL _getFileKey(const char *filePath, uint32_t kind, VerificationCacheKey *key)
+{
+    struct stat fileStat;
+
+    if(stat(filePath, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) return JACIC_BOOL_FALSE;
+
+    key->_kind = kind;
+    key->_device = (uint64_t) fileStat.st_dev;
+    key->_inode = (uint64_t) fileStat.st_ino;
+    key->_size = (uint64_t) fileStat.st_size;
+#if defined(__APPLE__)
+    key->_mtimeNs = (uint64_t) fileStat.st_mtimespec.tv_sec * 1000000000u + (uint64_t) fileStat.st_mtimespec.tv_nsec;
+    key->_ctimeNs = (uint64_t) fileStat.st_ctimespec.tv_sec * 1000000000u + (uint64_t) fileStat.st_ctimespec.tv_nsec;
+#else
+    key->_mtimeNs = (uint64_t) fileStat.st_mtim.tv_sec * 1000000000u + (uint64_t) fileStat.st_mtim.tv_nsec;
+    key->_ctimeNs = (uint64_t) fileStat.st_ctim.tv_sec * 1000000000u + (uint64_t) fileStat.st_ctim.tv_nsec;
+#endif
+    key->_valid = JACIC_BOOL_TRUE;
+
+    return JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 識別情報から最初に調べるスロットの位置を求める。
+@param [in] key 識別情報
+@return スロットの位置
+*/
+static size_t _cacheSlotIndex(const VerificationCacheKey *key)
+{
+    uint64_t hash = key->_inode * UINT64_C(0x9e3779b97f4a7c15);
+
+    hash ^= key->_device * UINT64_C(0xc2b2ae3d27d4eb4f);
+    hash ^= key->_kind;
+    hash ^= hash >> 29;
+
+    return (size_t) hash & (CACHE_SLOT_COUNT - 1);
+}
+
+/*!
+@brief スロットの位置からスロットを取得する。
+@param index スロットの位置（ CACHE_SLOT_COUNT 以上の場合は先頭から数える）
+@return スロット
+*/
+static struct _cacheSlot *_cacheSlotAt(size_t index)
+{
+    return (struct _cacheSlot *)(cacheBase + CACHE_HEADER_SIZE) + (index & (CACHE_SLOT_COUNT - 1));
+}
+
+/*!
+@brief スロットの内容を、書き込み中の内容が混ざらないように読み込む。
+@param [in] slot 対象のスロット
+@param [out] snapshot 読み込んだ内容
+@retval JACIC_BOOL_TRUE 読み込めた
+@retval JACIC_BOOL_FALSE 未使用、または書き込み中だった場合
+*/
+static JACIC_BOOL _readCacheSlot(struct _cacheSlot *slot, CacheSlotSnapshot *snapshot)
+{
+    uint32_t sequence = __atomic_load_n(&slot->_sequence, __ATOMIC_ACQUIRE);
+
+    if(sequence == 0 || (sequence & 1) != 0) return JACIC_BOOL_FALSE;
+
+    snapshot->_sequence = sequence;
+    snapshot->_kind = __atomic_load_n(&slot->_kind, __ATOMIC_RELAXED);
+    snapshot->_result = (int)(int32_t) __atomic_load_n(&slot->_result, __ATOMIC_RELAXED);
+    snapshot->_device = __atomic_load_n(&slot->_device, __ATOMIC_RELAXED);
+    snapshot->_inode = __atomic_load_n(&slot->_inode, __ATOMIC_RELAXED);
+    snapshot->_size = __atomic_load_n(&slot->_size, __ATOMIC_RELAXED);
+    snapshot->_mtimeNs = __atomic_load_n(&slot->_mtimeNs, __ATOMIC_RELAXED);
+    snapshot->_ctimeNs = __atomic_load_n(&slot->_ctimeNs, __ATOMIC_RELAXED);
+
+    /* 読み込み中に書き込まれていないことを確認する */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&slot->_sequence, __ATOMIC_RELAXED) == sequence ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+}
+
+/*!
+@brief スロットの内容が同じファイルのものか判定する（サイズ・更新日時・状態変更日時は比較しない）。
+*/
+#define CACHE_SAME_FILE(snapshot, key) \
+    ((snapshot)._kind == (key)->_kind && (snapshot)._device == (key)->_device && (snapshot)._inode == (key)->_inode)
+
+/*!
+@brief 識別情報が記録された時点から変わっていないか判定する。
+*/
+#define CACHE_SAME_STATE(snapshot, key) \
+    ((snapshot)._size == (key)->_size && (snapshot)._mtimeNs == (key)->_mtimeNs && (snapshot)._ctimeNs == (key)->_ctimeNs)
+
+/*!
+@brief マップした領域を解放する（ cacheLock の書き込みロックを取って呼び出す）。
+*/
+static void _unmapVerificationCache(void)
+{
+    if(cacheBase == NULL) return;
+
+    munmap(cacheBase, cacheLength);
+    cacheBase = NULL;
+}
+
+/*!
+@brief キャッシュに記録してよい検証結果か判定する。
+@details ファイルの内容だけで決まる結果のみ記録し、引数の不正・ファイル操作の失敗・その他のエラーは記録しない。
+@param result 検証結果（公開 API の戻り値）
+@retval JACIC_BOOL_TRUE 記録してよい
+@retval JACIC_BOOL_FALSE 記録しない
+*/
+static JACIC_BOOL _isCacheableResult(int result)
+{
+    if(result == OTHER_ERROR || result == INCORRECT_PARAMETER) return JACIC_BOOL_FALSE;
+    if(FILE_CLOSE_FAILED <= result && result <= FILE_NOT_EXISTS) return JACIC_BOOL_FALSE;
+
+    return JACIC_BOOL_TRUE;
+}
+
+#endif /* VERIFICATION_CACHE */
+
+/*!
+@brief 検証結果キャッシュのファイルを開き、以降の検証で使用する。
+@details ファイルが存在しない、または形式が異なる場合は空のキャッシュとして初期化する。
+既に開いているキャッシュは閉じる。他のスレッドで検証中に呼び出した場合は、その検索・記録が終わるのを待ってから切り替える。
+ファイルを作成する場合は所有者のみが読み書きできる権限（0600）で作成する。
+@param [in] cachePath キャッシュのファイルパス
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗した場合
+@retval FILE_WRITE_FAILED ファイルの初期化に失敗した場合
+@retval OTHER_ERROR マップできなかった場合、またはキャッシュを使用できない環境の場合
+*/
+int openVerificationCache(const char *cachePath)
+{
+#if defined(VERIFICATION_CACHE)
+    int ret = FUNCTION_SUCCESS;
+    int fd;
+    struct stat fileStat;
+    struct flock lock;
+    struct _cacheHeader *header;
+    unsigned char *base = MAP_FAILED;
+
+    if(cachePath == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    closeVerificationCache();
+
+    /* マップと初期化はロックの外で行い、使用中の検索・記録を待たせない */
+    if((fd = open(cachePath, O_RDWR | O_CREAT, 0600)) < 0)
+    {
+        return FILE_OPEN_FAILED;
+    }
+
+    /* 初期化が他のプロセスと重ならないように、ファイル全体をロックする（ファイルを閉じると解除される） */
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    if(fcntl(fd, F_SETLKW, &lock) != 0)
+    {
+        ret = OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    if(fstat(fd, &fileStat) != 0)
+    {
+        ret = OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    /* 足りない部分は 0 で埋められる（他のプロセスがマップしている範囲は縮めない） */
+    if((unsigned long long) fileStat.st_size < (unsigned long long) cacheLength && ftruncate(fd, (off_t) cacheLength) != 0)
+    {
+        ret = FILE_WRITE_FAILED;
+        goto FINALIZE;
+    }
+
+    base = (unsigned char *) mmap(NULL, cacheLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(base == MAP_FAILED)
+    {
+        ret = OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    header = (struct _cacheHeader *) base;
+    if(header->_magic != CACHE_MAGIC ||
+            header->_version != CACHE_FORMAT_VERSION ||
+            header->_slotCount != (uint32_t) CACHE_SLOT_COUNT ||
+            header->_slotSize != (uint32_t) sizeof(struct _cacheSlot))
+    {
+        /* 新規作成または形式が異なるため、空のキャッシュとして初期化する */
+        memset(base, 0, cacheLength);
+        header->_version = CACHE_FORMAT_VERSION;
+        header->_slotCount = (uint32_t) CACHE_SLOT_COUNT;
+        header->_slotSize = (uint32_t) sizeof(struct _cacheSlot);
+        __atomic_store_n(&header->_magic, CACHE_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    pthread_rwlock_wrlock(&cacheLock);
+    _unmapVerificationCache();
+    cacheBase = base;
+    pthread_rwlock_unlock(&cacheLock);
+
+FINALIZE:
+    /* マップした領域はファイルを閉じても有効 */
+    close(fd);
+
+    return ret;
+#else
+    (void) cachePath;
+
+    return OTHER_ERROR;
+#endif
+}
+
+/*!
+@brief 開いている検証結果キャッシュを閉じる。開いていない場合は何もしない。
+@details 他のスレッドで検証中に呼び出した場合は、その検索・記録が終わるのを待ってから閉じる。
+*/
+void closeVerificationCache(void)
+{
+#if defined(VERIFICATION_CACHE)
+    pthread_rwlock_wrlock(&cacheLock);
+    _unmapVerificationCache();
+    pthread_rwlock_unlock(&cacheLock);
+#endif
+}
+
+/*!
+@brief filePath の検証結果がキャッシュにあれば取得する。
+@details キャッシュを開いていない場合は常に見つからない。
+更新日時・状態変更日時・サイズなど識別情報のいずれかが異なる場合も見つからない扱いとする。
+@param [in] filePath 検証対象のファイルパス
+@param kind 検証結果の種別
+@param [out] key filePath の識別情報。見つからなかった場合は storeVerificationCache に渡す。
+@param [out] result 見つかった検証結果（公開 API の戻り値）
+@retval JACIC_BOOL_TRUE 見つかった
+@retval JACIC_BOOL_FALSE 見つからなかった
+*/
+JACIC_BOOL lookupVerificationCache(const char *filePath, uint32_t kind, VerificationCacheKey *key, int *result)
+{
+#if defined(VERIFICATION_CACHE)
+    CacheSlotSnapshot snapshot;
+    JACIC_BOOL found = JACIC_BOOL_FALSE;
+    size_t index;
+    size_t i;
+#endif
+
+    if(key == NULL) return JACIC_BOOL_FALSE;
+
+    key->_valid = JACIC_BOOL_FALSE;
+
+#if defined(VERIFICATION_CACHE)
+    if(filePath == NULL || result == NULL) return JACIC_BOOL_FALSE;
+
+    pthread_rwlock_rdlock(&cacheLock);
+
+    if(cacheBase != NULL && _getFileKey(filePath, kind, key))
+    {
+        index = _cacheSlotIndex(key);
+        for(i = 0; i < CACHE_PROBE_COUNT; i++)
+        {
+            if(!_readCacheSlot(_cacheSlotAt(index + i), &snapshot)) continue;
+            if(!CACHE_SAME_FILE(snapshot, key)) continue;
+
+            /* 同じファイルでもサイズか更新日時・状態変更日時が異なれば、検証し直す */
+            if(CACHE_SAME_STATE(snapshot, key))
+            {
+                *result = snapshot._result;
+                found = JACIC_BOOL_TRUE;
+            }
+            break;
+        }
+    }
+
+    pthread_rwlock_unlock(&cacheLock);
+
+    return found;
+#else
+    (void) filePath;
+    (void) kind;
+    (void) result;
+#endif
+
+    return JACIC_BOOL_FALSE;
+}
+
+/*!
+@brief filePath の検証結果をキャッシュに記録する。
+@details 検証中にファイルが変更された場合や、ファイル操作・メモリ確保の失敗による結果は記録しない。
+他のスレッド・プロセスが同じスロットに書き込んでいる場合も、待たずに記録をあきらめる。
+@param [in] filePath 検証対象のファイルパス
+@param [in] key lookupVerificationCache で取得した識別情報
+@param result 検証結果（公開 API の戻り値）
+*/
+void storeVerificationCache(const char *filePath, const VerificationCacheKey *key, int result)
+{
+#if defined(VERIFICATION_CACHE)
+    VerificationCacheKey current;
+    CacheSlotSnapshot snapshot;
+    struct _cacheSlot *slot = NULL;
+    struct _cacheSlot *candidate;
+    uint32_t sequence;
+    uint32_t nextSequence;
+    size_t index;
+    size_t i;
+
+    if(filePath == NULL || key == NULL || !key->_valid) return;
+    if(!_isCacheableResult(result)) return;
+
+    /* 検証中に変更されたファイルは記録しない */
+    if(!_getFileKey(filePath, key->_kind, &current)) return;
+    if(!CACHE_SAME_FILE(current, key) || !CACHE_SAME_STATE(current, key)) return;
+
+    /* 更新直後のファイルは、日時を変えずに再び変更される可能性がある */
+    if(key->_mtimeNs / 1000000000u + CACHE_RACY_SECONDS > (uint64_t) time(NULL)) return;
+    if(key->_ctimeNs / 1000000000u + CACHE_RACY_SECONDS > (uint64_t) time(NULL)) return;
+
+    pthread_rwlock_rdlock(&cacheLock);
+    if(cacheBase == NULL) goto FINALIZE;
+
+    /* 同じファイルのスロット、なければ最初の未使用のスロット、どちらもなければ最初のスロットを上書きする */
+    index = _cacheSlotIndex(key);
+    for(i = 0; i < CACHE_PROBE_COUNT; i++)
+    {
+        candidate = _cacheSlotAt(index + i);
+
+        if(_readCacheSlot(candidate, &snapshot))
+        {
+            if(CACHE_SAME_FILE(snapshot, key))
+            {
+                slot = candidate;
+                break;
+            }
+        }
+        else if(slot == NULL && __atomic_load_n(&candidate->_sequence, __ATOMIC_RELAXED) == 0)
+        {
+            slot = candidate;
+        }
+    }
+    if(slot == NULL) slot = _cacheSlotAt(index);
+
+    /* シーケンス番号を奇数にして書き込み中であることを示す（取れない場合は記録しない） */
+    sequence = __atomic_load_n(&slot->_sequence, __ATOMIC_RELAXED);
+    if((sequence & 1) != 0) goto FINALIZE;
+    if(!__atomic_compare_exchange_n(&slot->_sequence, &sequence, sequence + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) goto FINALIZE;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&slot->_kind, key->_kind, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->_result, (uint32_t)(int32_t) result, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->_device, key->_device, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->_inode, key->_inode, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->_size, key->_size, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->_mtimeNs, key->_mtimeNs, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->_ctimeNs, key->_ctimeNs, __ATOMIC_RELAXED);
+
+    /* 書き込み完了（ 0 は未使用を表すため飛ばす） */
+    nextSequence = sequence + 2;
+    if(nextSequence == 0) nextSequence = 2;
+    __atomic_store_n(&slot->_sequence, nextSequence, __ATOMIC_RELEASE);
+
+FINALIZE:
+    pthread_rwlock_unlock(&cacheLock);
+#else
+    (void) filePath;
+    (void) key;
+    (void) result;
+#endif
+}
@@ -0,0 +1,81 @@
+﻿/*!
+@file cache.h
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief 検証結果キャッシュ用ヘッダ
+*/
+
+#ifndef CACHE_H_
+#define CACHE_H_
+
+#include <stdint.h>
+
+#include "common.h"
+
+/*!
+@name 検証結果キャッシュの種別
+@details 同じファイルでも検証に使用した API が異なれば別の結果として扱う。
+@{
+*/
+#define VERIFICATION_CACHE_KIND_JPEG    ((uint32_t) 1)  /*!< @brief JCOMSIA_CheckHashValue の結果 */
+#define VERIFICATION_CACHE_KIND_SVG     ((uint32_t) 2)  /*!< @brief JCOMSIA_SVG_CheckHashValue の結果 */
+/*! @} */
+
+/*!
+@struct VerificationCacheKey
+@brief 検証結果キャッシュの検索に使用するファイルの識別情報
+*/
+typedef struct
+{
+    JACIC_BOOL _valid;  /*!< @brief 識別情報を取得できたか（キャッシュを使用しない場合は JACIC_BOOL_FALSE ） */
+    uint32_t _kind;     /*!< @brief 検証結果の種別 */
+    uint64_t _device;   /*!< @brief ファイルのあるデバイス */
+    uint64_t _inode;    /*!< @brief ファイルの i ノード番号 */
+    uint64_t _size;     /*!< @brief ファイルサイズ */
+    uint64_t _mtimeNs;  /*!< @brief ファイルの更新日時（ナノ秒） */
+    uint64_t _ctimeNs;  /*!< @brief ファイルの状態変更日時（ナノ秒。ユーザー空間から設定できないため、更新日時を戻した変更も検出できる） */
+} VerificationCacheKey;
+
+/*!
+@brief 検証結果キャッシュのファイルを開き、以降の検証で使用する。
+@details ファイルが存在しない、または形式が異なる場合は空のキャッシュとして初期化する。
+既に開いているキャッシュは閉じる。他のスレッドで検証中に呼び出した場合は、その検索・記録が終わるのを待ってから切り替える。
+@param [in] cachePath キャッシュのファイルパス
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗した場合
+@retval FILE_WRITE_FAILED ファイルの初期化に失敗した場合
+@retval OTHER_ERROR マップできなかった場合、またはキャッシュを使用できない環境の場合
+*/
+int openVerificationCache(const char *cachePath);
+
+/*!
+@brief 開いている検証結果キャッシュを閉じる。開いていない場合は何もしない。
+@details 他のスレッドで検証中に呼び出した場合は、その検索・記録が終わるのを待ってから閉じる。
+*/
+void closeVerificationCache(void);
+
+/*!
+@brief filePath の検証結果がキャッシュにあれば取得する。
+@details キャッシュを開いていない場合は常に見つからない。
+更新日時・状態変更日時・サイズなど識別情報のいずれかが異なる場合も見つからない扱いとする。
+@param [in] filePath 検証対象のファイルパス
+@param kind 検証結果の種別
+@param [out] key filePath の識別情報。見つからなかった場合は storeVerificationCache に渡す。
+@param [out] result 見つかった検証結果（公開 API の戻り値）
+@retval JACIC_BOOL_TRUE 見つかった
+@retval JACIC_BOOL_FALSE 見つからなかった
+*/
+JACIC_BOOL lookupVerificationCache(const char *filePath, uint32_t kind, VerificationCacheKey *key, int *result);
+
+/*!
+@brief filePath の検証結果をキャッシュに記録する。
+@details 検証中にファイルが変更された場合や、ファイル操作・メモリ確保の失敗による結果は記録しない。
+@param [in] filePath 検証対象のファイルパス
+@param [in] key lookupVerificationCache で取得した識別情報
+@param result 検証結果（公開 API の戻り値）
+*/
+void storeVerificationCache(const char *filePath, const VerificationCacheKey *key, int result);
+
+#endif /* CACHE_H_ */
@@ -6,12 +6,114 @@
 @brief 共通処理用ソースコード
 */
 
+#include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "common.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#include <emmintrin.h>
+#define MARKER_SCAN_SSE2    /*!< @brief SSE2 で 0xFF などの特定のバイトを探す */
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MARKER_SCAN_NEON    /*!< @brief NEON で 0xFF などの特定のバイトを探す */
+#endif
+
+#if !defined(_MSC_VER) && !defined(JCOMSIA_DISABLE_GATHER_WRITE)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define GATHER_WRITE        /*!< @brief writev で複数のバイト列をまとめて書き込む */
+#endif
+
+#if !defined(_MSC_VER) && defined(JCOMSIA_ENABLE_MAPPED_READ)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_READ         /*!< @brief mmap でファイルを参照する */
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(memory_sanitizer)
+#include <sanitizer/msan_interface.h>
+#define MEMORY_SANITIZER    /*!< @brief MemorySanitizer を有効にしたビルド */
+#endif
+#endif
+
+/*!
+@struct _arenaBlock
+@brief アリーナがヒープから追加した領域
+*/
+struct _arenaBlock
+{
+    struct _arenaBlock *_next;  /*!< @brief 1 つ前に追加した領域 */
+    size_t _capacity;           /*!< @brief _buff のバイト数 */
+    unsigned char _buff[];      /*!< @brief 割り当てに使用する領域 */
+};
+
+/*!
+@brief allocatorState のうち、 setAllocator が関数を差し替え中であることを示すビット
+*/
+#define ALLOCATOR_SWAPPING (((size_t)1) << (sizeof(size_t) * BIT_SIZE_1BYTE - 1))
+
+/*!
+@brief allocateMemory で確保して releaseMemory で解放されていない領域の数と、 ALLOCATOR_SWAPPING のビット
+@details 領域の数が 0 の場合のみ setAllocator が ALLOCATOR_SWAPPING を立てて関数を差し替える。
+領域の数が 1 以上の間は差し替えられないため、 allocateMemory / releaseMemory は関数をそのまま参照できる。
+*/
+static size_t allocatorState = 0;
+
+/*!
+@brief setAllocator で指定されたメモリ確保関数（ NULL の場合は malloc を使用する）
+*/
+static void *(*allocatorAllocFunction)(size_t size, void *context) = NULL;
+
+/*!
+@brief setAllocator で指定されたメモリ解放関数（ NULL の場合は free を使用する）
+*/
+static void (*allocatorFreeFunction)(void *ptr, void *context) = NULL;
+
+/*!
+@brief setAllocator で指定された、メモリ確保・解放関数に渡す任意の値
+*/
+static void *allocatorContext = NULL;
+
+#if defined(JCOMSIA_TEST_HOOKS)
+/*!
+@brief 全てのアリーナの割り当て回数の累計（テスト用）
+*/
+static ArenaStatistics arenaStatistics = {0, 0};
+#endif /* JCOMSIA_TEST_HOOKS */
+
+/*!
+@struct _fileDataHeader
+@brief ファイル読み込み用のバイナリデータ構造体の直前に置く管理情報
+*/
+struct _fileDataHeader
+{
+    void *_mapBase;         /*!< @brief マップした領域の先頭（ヒープに確保した場合は NULL ） */
+    size_t _mapLength;      /*!< @brief マップした領域の長さ */
+    FileDataCache *_cache;  /*!< @brief 返却先のキャッシュ（キャッシュの領域ではない場合は NULL ） */
+};
+
+/*!
+@brief ファイル読み込み用のバイナリデータ構造体から管理情報を取得する。
+*/
+#define FILE_DATA_HEADER(data) ((struct _fileDataHeader *)((unsigned char *)(data) - sizeof(struct _fileDataHeader)))
+
+/*!
+@brief 16 進数 1 文字の文字列表現
+*/
+static const unsigned char HEX_CHARACTERS[16] =
+{
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
 /*!
 @brief 稼働環境のエンディアンを判定し、エンディアンを示す値を返す。
 @retval BIG_ENDIAN ビッグエンディアン
@@ -64,20 +166,225 @@ unsigned int swapEndian32(unsigned int src)
 */
 int getCharCode(unsigned char *dst, unsigned char hexChar)
 {
-    char tmp[2];
-
     if(0x0FU < hexChar)
     {
         /* 1 文字表現の範囲外 */
         return INCORRECT_PARAMETER;
     }
 
-    sprintf(tmp, "%x", hexChar);
-    *dst = (unsigned char)tmp[0];
+    *dst = HEX_CHARACTERS[hexChar];
 
     return FUNCTION_SUCCESS;
 }
 
+/*!
+@brief バイト配列を 16 進数の文字列表現（小文字）に変換する。
+@details 1 バイトにつき 2 文字を出力する。終端文字は付加しない。
+@param [out] dst 変換結果を受けとる配列（length * 2 バイト以上の長さを持つこと）
+@param [in] src 変換対象のバイト配列
+@param length src の長さ
+*/
+void encodeHex(unsigned char *dst, const unsigned char *src, size_t length)
+{
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        dst[i * 2 + 0] = HEX_CHARACTERS[src[i] >> 4];
+        dst[i * 2 + 1] = HEX_CHARACTERS[src[i] & 0x0F];
+    }
+}
+
+/*!
+@brief 16 進数の文字列表現（小文字）をバイト配列に変換する。
+@details encodeHex で出力される形式のみを受け付け、大文字を含む場合も不正として扱う。
+@param [out] dst 変換結果を受けとる配列（length / 2 バイト以上の長さを持つこと）
+@param [in] src 変換対象の文字列
+@param length src の長さ（偶数であること）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER src に 16 進数として不正な文字が含まれる場合
+*/
+int decodeHex(unsigned char *dst, const unsigned char *src, size_t length)
+{
+    unsigned int invalid = 0;
+    unsigned int value[2];
+    unsigned int digit;
+    unsigned int alpha;
+    size_t i;
+    size_t j;
+
+    if((length & 1) != 0) return INCORRECT_PARAMETER;
+
+    for(i = 0; i < length / 2; ++i)
+    {
+        for(j = 0; j < 2; ++j)
+        {
+            /* '0'-'9' と 'a'-'f' のどちらの範囲にあるかを分岐せずに判定する */
+            digit = (unsigned int)src[i * 2 + j] - '0';
+            alpha = (unsigned int)src[i * 2 + j] - 'a';
+
+            value[j] = (digit < 10 ? digit : 0) | (alpha < 6 ? alpha + 10 : 0);
+            invalid |= (digit < 10 || alpha < 6) ? 0 : 1;
+        }
+
+        dst[i] = (unsigned char)((value[0] << 4) | value[1]);
+    }
+
+    return invalid == 0 ? FUNCTION_SUCCESS : INCORRECT_PARAMETER;
+}
+
+/*!
+@brief 2 つのバイト配列が等しいかを、内容によらず一定の時間で比較する。
+@param [in] lhs 比較対象のバイト配列
+@param [in] rhs 比較対象のバイト配列
+@param length 比較するバイト数
+@retval 0 等しい
+@retval 0以外 等しくない
+*/
+int compareConstantTime(const unsigned char *lhs, const unsigned char *rhs, size_t length)
+{
+    unsigned char difference = 0;
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        difference |= (unsigned char)(lhs[i] ^ rhs[i]);
+    }
+
+    return (int)difference;
+}
+
+/*!
+@brief バイト配列から最初の 0xFF（マーカーの先頭バイト）を探す。
+@details SSE2 / NEON が利用できる場合は 16 バイト単位で比較する。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@return 最初に見つかった 0xFF の位置（見つからなかった場合は length ）
+*/
+size_t findMarkerPrefix(const unsigned char *data, size_t length)
+{
+    size_t i = 0;
+
+#if defined(MARKER_SCAN_SSE2)
+    const __m128i markers = _mm_set1_epi8((char)0xFF);
+    __m128i found;
+    unsigned int mask;
+
+    /* 64 バイトずつまとめて判定し、見つかった場合のみ 16 バイト単位で位置を特定する */
+    for(; i + 64 <= length; i += 64)
+    {
+        found = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i +  0)), markers),
+                _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i + 16)), markers)),
+            _mm_or_si128(
+                _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i + 32)), markers),
+                _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i + 48)), markers)));
+
+        if(_mm_movemask_epi8(found) != 0) break;
+    }
+
+    for(; i + 16 <= length; i += 16)
+    {
+        mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), markers));
+        if(mask != 0) return i + (size_t)__builtin_ctz(mask);
+    }
+#elif defined(MARKER_SCAN_NEON)
+    const uint8x16_t markers = vdupq_n_u8(0xFF);
+    uint8x16_t found;
+    uint64_t mask;
+
+    /* 64 バイトずつまとめて判定し、見つかった場合のみ 16 バイト単位で位置を特定する */
+    for(; i + 64 <= length; i += 64)
+    {
+        found = vorrq_u8(
+            vorrq_u8(vceqq_u8(vld1q_u8(data + i +  0), markers), vceqq_u8(vld1q_u8(data + i + 16), markers)),
+            vorrq_u8(vceqq_u8(vld1q_u8(data + i + 32), markers), vceqq_u8(vld1q_u8(data + i + 48), markers)));
+
+        if(vmaxvq_u8(found) != 0) break;
+    }
+
+    for(; i + 16 <= length; i += 16)
+    {
+        /* 比較結果を 1 バイトあたり 4 ビットに詰めて、最初に一致した位置を求める */
+        mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(vld1q_u8(data + i), markers)), 4)), 0);
+        if(mask != 0) return i + (size_t)(__builtin_ctzll(mask) >> 2);
+    }
+#endif
+
+    for(; i < length; ++i)
+    {
+        if(data[i] == 0xFF) return i;
+    }
+
+    return length;
+}
+
+/*!
+@brief バイト配列から、XML の字句解析で 1 バイトずつ判定する必要のあるバイトを探す。
+@details 制御文字 (0x00 ～ 0x1F) 、 0x7F 以上のバイト、 '<' 、 '&' および delimiter を探す。
+SSE2 / NEON が利用できる場合は 16 バイト単位で比較する。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@param delimiter あわせて探すバイト（属性値を囲む引用符など）
+@return 最初に見つかった位置（見つからなかった場合は length ）
+*/
+size_t findXMLSpecialByte(const unsigned char *data, size_t length, unsigned char delimiter)
+{
+    size_t i = 0;
+    unsigned char c;
+
+#if defined(MARKER_SCAN_SSE2)
+    const __m128i controls = _mm_set1_epi8(0x20);
+    const __m128i printables = _mm_set1_epi8(0x7E);
+    const __m128i lessThan = _mm_set1_epi8('<');
+    const __m128i ampersand = _mm_set1_epi8('&');
+    const __m128i delimiters = _mm_set1_epi8((char)delimiter);
+    __m128i bytes;
+    unsigned int mask;
+
+    for(; i + 16 <= length; i += 16)
+    {
+        bytes = _mm_loadu_si128((const __m128i *)(data + i));
+
+        /* 符号付きで比較するため、0x80 以上のバイトは 0x20 未満として検出される */
+        mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmplt_epi8(bytes, controls), _mm_cmpgt_epi8(bytes, printables)),
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, lessThan), _mm_cmpeq_epi8(bytes, ampersand)),
+                _mm_cmpeq_epi8(bytes, delimiters))));
+        if(mask != 0) return i + (size_t)__builtin_ctz(mask);
+    }
+#elif defined(MARKER_SCAN_NEON)
+    const uint8x16_t controls = vdupq_n_u8(0x20);
+    const uint8x16_t printables = vdupq_n_u8(0x7E);
+    const uint8x16_t lessThan = vdupq_n_u8('<');
+    const uint8x16_t ampersand = vdupq_n_u8('&');
+    const uint8x16_t delimiters = vdupq_n_u8(delimiter);
+    uint8x16_t bytes;
+    uint64_t mask;
+
+    for(; i + 16 <= length; i += 16)
+    {
+        bytes = vld1q_u8(data + i);
+
+        /* 比較結果を 1 バイトあたり 4 ビットに詰めて、最初に一致した位置を求める */
+        mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vorrq_u8(
+            vorrq_u8(vcltq_u8(bytes, controls), vcgtq_u8(bytes, printables)),
+            vorrq_u8(vorrq_u8(vceqq_u8(bytes, lessThan), vceqq_u8(bytes, ampersand)), vceqq_u8(bytes, delimiters)))), 4)), 0);
+        if(mask != 0) return i + (size_t)(__builtin_ctzll(mask) >> 2);
+    }
+#endif
+
+    for(; i < length; ++i)
+    {
+        c = data[i];
+        if(c < 0x20 || 0x7E < c || c == '<' || c == '&' || c == delimiter) return i;
+    }
+
+    return length;
+}
+
 /*!
 @brief ファイルにバッファの内容を length バイト書き込む。
 @param [in] dst 書き込み対象となるファイルパス
@@ -125,34 +432,661 @@ int writeFile(const char *dst, unsigned char *outBuff, size_t length)
     return ret;
 }
 
+/*!
+@brief 複数のバイト列を先頭から順に連結した内容をファイルに書き込む。
+@details 連結したバッファを作成せずに、各バイト列から直接書き込む（ POSIX 環境では writev を使用する）。
+@param [in] dst 書き込み対象となるファイルパス
+@param [in] parts 書き込むバイト列の配列（長さ 0 の要素は読み飛ばす）
+@param count parts の要素数（ BYTE_VIEW_GATHER_MAX 以下）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗
+@retval FILE_WRITE_FAILED ファイルへの書き込みに失敗
+@retval FILE_CLOSE_FAILED ファイルのクローズに失敗
+*/
+int writeFileGather(const char *dst, const ByteView *parts, size_t count)
+{
+    int ret = FUNCTION_SUCCESS;
+    size_t i;
+#if defined(GATHER_WRITE)
+    int fd;
+    size_t first = 0;                       /* 書き込みが完了していない最初の要素 */
+    struct iovec iov[BYTE_VIEW_GATHER_MAX];
+#else
+    FILE *fp = NULL;
+#endif
+
+    /* パラメータチェック */
+    if(dst == NULL || parts == NULL || count > BYTE_VIEW_GATHER_MAX)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+#if defined(GATHER_WRITE)
+    for(i = 0; i < count; ++i)
+    {
+        iov[i].iov_base = (void *) parts[i]._ptr;
+        iov[i].iov_len = parts[i]._len;
+    }
+
+    /* fopen(dst, "wb") と同じく、作成・切り詰めを行って開く */
+    fd = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+    if(fd < 0)
+    {
+        /* ファイルのオープンに失敗 */
+        return FILE_OPEN_FAILED;
+    }
+
+    while(first < count)
+    {
+        ssize_t written;
+
+        if(iov[first].iov_len == 0)
+        {
+            ++first;
+            continue;
+        }
+
+        written = writev(fd, &iov[first], (int)(count - first));
+
+        if(written < 0 && errno == EINTR)
+        {
+            /* シグナルによる中断は再試行する */
+            continue;
+        }
+
+        if(written <= 0)
+        {
+            /* ファイルへの書き込みに失敗 */
+            ret = FILE_WRITE_FAILED;
+            break;
+        }
+
+        /* 書き込まれた分だけ要素を進める（途中までしか書き込まれなかった要素は残りを指すようにする） */
+        while(written > 0)
+        {
+            if((size_t) written >= iov[first].iov_len)
+            {
+                written -= (ssize_t) iov[first].iov_len;
+                ++first;
+            }
+            else
+            {
+                iov[first].iov_base = (unsigned char *) iov[first].iov_base + written;
+                iov[first].iov_len -= (size_t) written;
+                written = 0;
+            }
+        }
+    }
+
+    /* ファイルクローズ */
+    if(close(fd) != 0)
+    {
+        /* ファイルクローズに失敗 */
+        ret = FILE_CLOSE_FAILED;
+    }
+#else
+    fp = fopen(dst, "wb");
+
+    if(fp == NULL)
+    {
+        /* ファイルのオープンに失敗 */
+        return FILE_OPEN_FAILED;
+    }
+
+    for(i = 0; i < count; ++i)
+    {
+        if(parts[i]._len == 0) continue;
+
+        if(fwrite(parts[i]._ptr, BYTE_SIZE_UNSIGNED_CHAR, parts[i]._len, fp) < parts[i]._len)
+        {
+            /* ファイルへの書き込みに失敗 */
+            ret = FILE_WRITE_FAILED;
+            break;
+        }
+    }
+
+    /* ファイルクローズ */
+    if(fclose(fp) == EOF)
+    {
+        /* ファイルクローズに失敗 */
+        ret = FILE_CLOSE_FAILED;
+    }
+
+    fp = NULL;
+#endif
+
+    return ret;
+}
+
+/*!
+@brief allocateMemory / releaseMemory で使用する関数を差し替える。
+@details allocFunction と freeFunction の両方に NULL を指定した場合は、標準の malloc / free に戻す。
+allocateMemory で確保した領域が 1 つでも解放されずに残っている間は差し替えずに失敗する。
+差し替え中に他のスレッドから呼び出された allocateMemory は、差し替えが終わるまで待つ。
+@param allocFunction メモリを確保する関数（確保するバイト数と context を受け取り、確保できなかった場合は NULL を返す）
+@param freeFunction allocFunction で確保したメモリを解放する関数（解放する領域と context を受け取る）
+@param context allocFunction, freeFunction に渡す任意の値
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER allocFunction と freeFunction の片方のみ NULL が指定された場合
+@retval ALLOCATOR_IN_USE 差し替え前の関数で確保した領域が残っている場合、または他のスレッドが差し替え中の場合
+*/
+int setAllocator(void *(*allocFunction)(size_t size, void *context), void (*freeFunction)(void *ptr, void *context), void *context)
+{
+    size_t state = 0;
+
+    if((allocFunction == NULL) != (freeFunction == NULL))
+    {
+        /* 確保と解放の関数は組で指定する */
+        return INCORRECT_PARAMETER;
+    }
+
+    /* 確保中の領域が無い場合のみ、差し替え中の状態にする */
+    if(!__atomic_compare_exchange_n(&allocatorState, &state, ALLOCATOR_SWAPPING, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return ALLOCATOR_IN_USE;
+    }
+
+    allocatorAllocFunction = allocFunction;
+    allocatorFreeFunction = freeFunction;
+    allocatorContext = (allocFunction != NULL) ? context : NULL;
+
+    /* 差し替えた関数を、以降に確保するスレッドから参照できるようにする */
+    __atomic_store_n(&allocatorState, 0, __ATOMIC_RELEASE);
+
+    return FUNCTION_SUCCESS;
+}
+
+/*!
+@brief setAllocator で指定された関数（指定がなければ malloc ）でメモリを確保する。
+@details 確保した領域は初期化されない。使い終わったら releaseMemory で解放すること。
+@param size 確保するバイト数
+@return 確保した領域の先頭。size が 0 の場合、またはメモリが確保できなかった場合は NULL
+*/
+void *allocateMemory(size_t size)
+{
+    void *ptr;
+    size_t state;
+
+    if(size == 0) return NULL;
+
+    /* 確保中の領域の数を増やし、解放するまで関数を差し替えられないようにする（差し替え中の場合は終わるまで待つ） */
+    do
+    {
+        state = __atomic_load_n(&allocatorState, __ATOMIC_RELAXED) & ~ALLOCATOR_SWAPPING;
+    }
+    while(!__atomic_compare_exchange_n(&allocatorState, &state, state + 1, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    if(allocatorAllocFunction != NULL)
+    {
+        ptr = allocatorAllocFunction(size, allocatorContext);
+    }
+    else
+    {
+        ptr = malloc(size);
+    }
+
+    if(ptr == NULL)
+    {
+        /* 確保できなかった場合は数に含めない */
+        __atomic_sub_fetch(&allocatorState, 1, __ATOMIC_RELEASE);
+        return NULL;
+    }
+
+#if defined(MEMORY_SANITIZER)
+    /* 呼び出し元のプールから再利用された領域も、未初期化として検査させる */
+    __msan_poison(ptr, size);
+#endif
+
+    return ptr;
+}
+
+/*!
+@brief allocateMemory で確保したメモリを解放する。
+@param [in] ptr 解放する領域。NULL の場合は何もしない
+*/
+void releaseMemory(void *ptr)
+{
+    if(ptr == NULL) return;
+
+    if(allocatorFreeFunction != NULL)
+    {
+        allocatorFreeFunction(ptr, allocatorContext);
+    }
+    else
+    {
+        free(ptr);
+    }
+
+    /* 確保中の領域の数を減らす（ 0 になると関数を差し替えられる） */
+    __atomic_sub_fetch(&allocatorState, 1, __ATOMIC_RELEASE);
+}
+
+/*!
+@brief 実体と長さをもつバイナリデータ構造体のメモリを、バイナリ領域を初期化せずに確保して返す。
+@details 直後に全体を上書きするバッファ（ファイルの読み込み先など）に使用し、ページへの書き込みを 1 回で済ませる。
+MemorySanitizer を有効にしたビルドでは _buff を未初期化として扱うため、上書き前の読み出しは検出される。
+使い終わったら _SECURE_RELEASE で解放すること。
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return 確保したバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *allocateBinaryDataUninitialized(const size_t dataLen)
+{
+    struct _binaryData *binaryData = NULL;
+
+    if(dataLen == 0) return NULL;
+    if(SIZE_MAX - sizeof(struct _binaryData) < dataLen) return NULL;
+
+    binaryData = (struct _binaryData *) allocateMemory(sizeof(struct _binaryData) + dataLen);
+
+    if(binaryData != NULL)
+    {
+        binaryData->_len = dataLen;
+    }
+
+    return binaryData;
+}
+
+/*!
+@brief ファイルの読み込み先となるバイナリデータ構造体のメモリを、バイナリ領域を初期化せずに確保して返す。
+@details mapFileBinaryData でマップしたものと同じく、使い終わったら releaseFileBinaryData で解放すること。
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return 確保したバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *allocateFileBinaryData(const size_t dataLen)
+{
+    struct _fileDataHeader *header;
+    struct _binaryData *binaryData;
+    const size_t headerSize = sizeof(struct _fileDataHeader) + sizeof(struct _binaryData);
+
+    if(dataLen == 0) return NULL;
+    if(SIZE_MAX - headerSize < dataLen) return NULL;
+
+    header = (struct _fileDataHeader *) allocateMemory(headerSize + dataLen);
+    if(header == NULL) return NULL;
+
+    header->_mapBase = NULL;
+    header->_mapLength = 0;
+    header->_cache = NULL;
+
+    binaryData = (struct _binaryData *)(header + 1);
+    binaryData->_len = dataLen;
+
+    return binaryData;
+}
+
+/*!
+@brief ファイルの読み込み先となるバイナリデータ構造体を、cache の領域を使い回して返す。
+@details cache の領域が足りない場合は dataLen の大きさで確保し直す。
+返した領域は releaseFileBinaryData で cache に返却され、次の呼び出しで再び使用される。
+@param [in, out] cache 領域を使い回すためのキャッシュ。NULL の場合は allocateFileBinaryData と同じ
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return バイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *allocateCachedFileBinaryData(FileDataCache *cache, const size_t dataLen)
+{
+    struct _binaryData *binaryData;
+
+    /* キャッシュがない、または貸し出し中の場合は通常どおり確保する */
+    if(cache == NULL || cache->_inUse)
+    {
+        return allocateFileBinaryData(dataLen);
+    }
+
+    if(dataLen == 0) return NULL;
+
+    if(cache->_data == NULL || cache->_capacity < dataLen)
+    {
+        /* 足りない場合は確保し直す */
+        releaseFileDataCache(cache);
+
+        binaryData = allocateFileBinaryData(dataLen);
+        if(binaryData == NULL) return NULL;
+
+        FILE_DATA_HEADER(binaryData)->_cache = cache;
+        cache->_data = binaryData;
+        cache->_capacity = dataLen;
+    }
+
+    cache->_data->_len = dataLen;
+    cache->_inUse = JACIC_BOOL_TRUE;
+
+    return cache->_data;
+}
+
+/*!
+@brief FileDataCache が保持している領域を解放する。
+@details 貸し出し中の領域が残っていないこと。
+@param [in, out] cache 解放の対象となるキャッシュ
+*/
+void releaseFileDataCache(FileDataCache *cache)
+{
+    if(cache == NULL) return;
+
+    assert(!cache->_inUse);
+
+    if(cache->_data != NULL)
+    {
+        releaseMemory(FILE_DATA_HEADER(cache->_data));
+    }
+
+    cache->_data = NULL;
+    cache->_capacity = 0;
+}
+
+/*!
+@brief ファイルをメモリにマップし、読み取り専用のバイナリデータ構造体として返す。
+@details JCOMSIA_ENABLE_MAPPED_READ を定義してビルドした POSIX 環境でのみ有効で、それ以外では常に失敗する。
+管理情報とデータ長を置く 1 ページの直後にファイルをマップし、_buff がファイルの先頭を指すようにする。
+@param [in] filePath ファイルの場所
+@param [out] dst マップした結果を格納するポインタ。使い終わったら releaseFileBinaryData で解放すること。
+@retval FUNCTION_SUCCESS 正常終了
+@retval OTHER_ERROR マップできなかった場合（ファイルが存在しない、通常のファイルではない、サイズが 0 の場合を含む）
+*/
+int mapFileBinaryData(const char *filePath, struct _binaryData **dst)
+{
+#if defined(MAPPED_READ)
+    int ret = OTHER_ERROR;
+    int fd;
+    struct stat fileStat;
+    size_t fileSize;
+    size_t pageSize;
+    unsigned char *base = MAP_FAILED;
+    struct _binaryData *binaryData;
+    long sysPageSize = sysconf(_SC_PAGESIZE);
+
+    if(filePath == NULL || dst == NULL || sysPageSize <= 0)
+    {
+        return OTHER_ERROR;
+    }
+
+    pageSize = (size_t) sysPageSize;
+
+    if((fd = open(filePath, O_RDONLY)) < 0)
+    {
+        return OTHER_ERROR;
+    }
+
+    if(fstat(fd, &fileStat) != 0 ||
+            !S_ISREG(fileStat.st_mode) ||
+            fileStat.st_size <= 0 ||
+            (unsigned long long) fileStat.st_size > (unsigned long long)(SIZE_MAX - pageSize))
+    {
+        /* 通常のファイルではない、またはサイズがマップできない */
+        goto FINALIZE;
+    }
+
+    fileSize = (size_t) fileStat.st_size;
+
+    /* 管理情報用の 1 ページとファイル全体の範囲を確保し、ファイルをその後半に重ねてマップする */
+    base = (unsigned char *) mmap(NULL, pageSize + fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED)
+    {
+        goto FINALIZE;
+    }
+
+    if(mmap(base + pageSize, fileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(base, pageSize + fileSize);
+        goto FINALIZE;
+    }
+
+    /* 先頭から順に参照するため、先読みを促す（失敗しても動作に影響はない） */
+    madvise(base + pageSize, fileSize, MADV_SEQUENTIAL);
+    madvise(base + pageSize, fileSize, MADV_WILLNEED);
+
+    binaryData = (struct _binaryData *)(base + pageSize - offsetof(struct _binaryData, _buff));
+    binaryData->_len = fileSize;
+    FILE_DATA_HEADER(binaryData)->_mapBase = base;
+    FILE_DATA_HEADER(binaryData)->_mapLength = pageSize + fileSize;
+    FILE_DATA_HEADER(binaryData)->_cache = NULL;
+
+    *dst = binaryData;
+    ret = FUNCTION_SUCCESS;
+
+FINALIZE:
+    /* マップした領域はファイルを閉じても有効 */
+    close(fd);
+
+    return ret;
+#else
+    (void) filePath;
+    (void) dst;
+
+    return OTHER_ERROR;
+#endif
+}
+
+/*!
+@brief allocateFileBinaryData または mapFileBinaryData で取得したバイナリデータ構造体を解放する。
+@details allocateCachedFileBinaryData で取得したものは解放せず、キャッシュに返却する。
+@param [in, out] dst 解放の対象となるポインタの参照。処理後は NULL が設定される。
+*/
+void releaseFileBinaryData(struct _binaryData **dst)
+{
+    struct _fileDataHeader *header;
+
+    if(dst == NULL || *dst == NULL) return;
+
+    header = FILE_DATA_HEADER(*dst);
+
+    if(header->_cache != NULL)
+    {
+        /* キャッシュの領域は解放せずに返却する */
+        header->_cache->_inUse = JACIC_BOOL_FALSE;
+        *dst = NULL;
+        return;
+    }
+
+#if defined(MAPPED_READ)
+    if(header->_mapBase != NULL)
+    {
+        munmap(header->_mapBase, header->_mapLength);
+        *dst = NULL;
+        return;
+    }
+#endif
+
+    releaseMemory(header);
+    *dst = NULL;
+}
+
 /*!
 @brief 実体と長さをもつバイナリデータ構造体のメモリを確保して返す。
 @details 確保されたバイナリ領域 _buff は 0x00 で初期化される。
+確保には allocateMemory を使用するため、使い終わったら _SECURE_RELEASE で解放すること。
 @param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
 @return 確保したバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
 */
 struct _binaryData *allocateBinaryData(const size_t dataLen)
 {
-    size_t memorySize = 0;
+    struct _binaryData *binaryData = allocateBinaryDataUninitialized(dataLen);
+
+    if(binaryData != NULL)
+    {
+        memset(binaryData->_buff, 0x00, dataLen);
+    }
+
+    return binaryData;
+}
+
+/*!
+@brief アリーナを初期化する。
+@param [out] arena 初期化対象のアリーナ
+@param [in] initialBuff 最初に割り当てに使用する領域（呼び出し元のスタック上の配列など）。用意しない場合は NULL
+@param initialCapacity initialBuff のバイト数
+*/
+void arenaInit(Arena *arena, unsigned char *initialBuff, size_t initialCapacity)
+{
+    if(arena == NULL) return;
+
+    if(initialBuff == NULL)
+    {
+        initialCapacity = 0;
+    }
+
+    arena->_buff = initialBuff;
+    arena->_capacity = initialCapacity;
+    arena->_used = 0;
+    arena->_initialBuff = initialBuff;
+    arena->_initialCapacity = initialCapacity;
+    arena->_blocks = NULL;
+    arena->_allocCount = 0;
+    arena->_heapCount = 0;
+}
+
+/*!
+@brief 現在の割り当て位置を BYTE_SIZE_ARENA_ALIGN の境界に揃えるために必要なバイト数を返す。
+@param [in] arena 対象のアリーナ
+@return 境界に揃えるために読み飛ばすバイト数
+*/
+static size_t arenaPadding(const Arena *arena)
+{
+    uintptr_t address;
+
+    if(arena->_buff == NULL) return 0;
+
+    address = (uintptr_t)(arena->_buff + arena->_used);
+
+    return (size_t)((BYTE_SIZE_ARENA_ALIGN - (address % BYTE_SIZE_ARENA_ALIGN)) % BYTE_SIZE_ARENA_ALIGN);
+}
+
+/*!
+@brief アリーナから領域を割り当てる。
+@details 割り当てた領域は 0x00 で初期化され、BYTE_SIZE_ARENA_ALIGN の境界に配置される。
+割り当てた領域は arenaRelease を呼び出すまで有効で、個別に解放してはならない。
+@param [in, out] arena 割り当て元のアリーナ
+@param size 割り当てるバイト数
+@return 割り当てた領域の先頭。size が 0 の場合、またはメモリが確保できなかった場合は NULL
+*/
+void *arenaAlloc(Arena *arena, size_t size)
+{
+    size_t padding;
+    unsigned char *ptr;
+
+    if(arena == NULL || size == 0) return NULL;
+
+    padding = arenaPadding(arena);
+
+    if(arena->_capacity - arena->_used < padding ||
+            arena->_capacity - arena->_used - padding < size)
+    {
+        /* 現在の領域に収まらないので、ヒープから領域を追加する */
+        struct _arenaBlock *block;
+        size_t capacity = BYTE_SIZE_ARENA_BLOCK;
+
+        if(SIZE_MAX - sizeof(struct _arenaBlock) - BYTE_SIZE_ARENA_ALIGN < size) return NULL;
+
+        if(capacity < size + BYTE_SIZE_ARENA_ALIGN)
+        {
+            capacity = size + BYTE_SIZE_ARENA_ALIGN;
+        }
+
+        block = (struct _arenaBlock *) allocateMemory(sizeof(struct _arenaBlock) + capacity);
+        if(block == NULL) return NULL;
+
+        block->_next = arena->_blocks;
+        block->_capacity = capacity;
+        arena->_blocks = block;
+        arena->_heapCount++;
+#if defined(JCOMSIA_TEST_HOOKS)
+        __atomic_add_fetch(&arenaStatistics._heapCount, 1, __ATOMIC_RELAXED);
+#endif
+
+        arena->_buff = block->_buff;
+        arena->_capacity = capacity;
+        arena->_used = 0;
+
+        padding = arenaPadding(arena);
+    }
+
+    ptr = &(arena->_buff[arena->_used + padding]);
+    arena->_used += padding + size;
+    arena->_allocCount++;
+#if defined(JCOMSIA_TEST_HOOKS)
+    __atomic_add_fetch(&arenaStatistics._allocCount, 1, __ATOMIC_RELAXED);
+#endif
+
+    memset(ptr, 0x00, size);
+
+    return ptr;
+}
+
+/*!
+@brief アリーナから実体と長さをもつバイナリデータ構造体を割り当てて返す。
+@details allocateBinaryData と同じく _buff は 0x00 で初期化される。個別に解放してはならない。
+@param [in, out] arena 割り当て元のアリーナ
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return 割り当てたバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *arenaAllocateBinaryData(Arena *arena, const size_t dataLen)
+{
     struct _binaryData *binaryData = NULL;
 
     if(dataLen == 0) return NULL;
+    if(SIZE_MAX - sizeof(struct _binaryData) < dataLen) return NULL;
 
-    memorySize = sizeof(struct _binaryData) + dataLen;
-    binaryData = malloc(memorySize);
+    binaryData = (struct _binaryData *) arenaAlloc(arena, sizeof(struct _binaryData) + dataLen);
 
     if(binaryData != NULL)
     {
-        memset(binaryData, 0x00, memorySize);
         binaryData->_len = dataLen;
     }
 
     return binaryData;
 }
 
+/*!
+@brief アリーナから割り当てた領域をまとめて解放し、初期領域から割り当てを再開できる状態に戻す。
+@details 割り当て回数などの計数値は保持する。
+@param [in, out] arena 解放対象のアリーナ
+*/
+void arenaRelease(Arena *arena)
+{
+    if(arena == NULL) return;
+
+    while(arena->_blocks != NULL)
+    {
+        struct _arenaBlock *next = arena->_blocks->_next;
+
+        releaseMemory(arena->_blocks);
+        arena->_blocks = next;
+    }
+
+    arena->_buff = arena->_initialBuff;
+    arena->_capacity = arena->_initialCapacity;
+    arena->_used = 0;
+}
+
+#if defined(JCOMSIA_TEST_HOOKS)
+
+/*!
+@brief resetArenaStatistics を呼び出してからの、全てのアリーナの割り当て回数の累計を返す（テスト用）。
+@param [out] statistics 累計を受けとる構造体
+*/
+void getArenaStatistics(ArenaStatistics *statistics)
+{
+    if(statistics == NULL) return;
+
+    statistics->_allocCount = __atomic_load_n(&arenaStatistics._allocCount, __ATOMIC_RELAXED);
+    statistics->_heapCount = __atomic_load_n(&arenaStatistics._heapCount, __ATOMIC_RELAXED);
+}
+
+/*!
+@brief 全てのアリーナの割り当て回数の累計を 0 に戻す（テスト用）。
+*/
+void resetArenaStatistics(void)
+{
+    __atomic_store_n(&arenaStatistics._allocCount, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&arenaStatistics._heapCount, 0, __ATOMIC_RELAXED);
+}
+
+#endif /* JCOMSIA_TEST_HOOKS */
+
 /*!
 @brief バイト配列構造体の複製を行う。
-@details メモリの動的確保が行われるため、dst を使い終わったら解放する必要がある。
+@details メモリの動的確保が行われるため、dst を使い終わったら _SECURE_RELEASE で解放する必要がある。
 @param [in] src コピー元のバイト配列構造体
 @param [out] dst コピー先のバイト配列構造体
 */
@@ -165,7 +1099,7 @@ void copyBinaryDataToBinaryData(const struct _binaryData *src, struct _binaryDat
 
 /*!
 @brief バイト配列を構造体に複製する。
-@details メモリの動的確保が行われるため、dst を使い終わったら解放する必要がある。
+@details メモリの動的確保が行われるため、dst を使い終わったら _SECURE_RELEASE で解放する必要がある。
 @param [in] srcData コピー元のバイト配列
 @param srcLength srcData のデータ長
 @param [out] dst コピー先のバイト配列構造体
@@ -176,7 +1110,8 @@ void copyByteArrayToBinaryData(const unsigned char *srcData, const size_t srcLen
     if(dst == NULL || *dst != NULL) return;
     if(srcLength == 0) return;
 
-    *dst = allocateBinaryData(srcLength);
+    /* 全体を上書きするので初期化は不要 */
+    *dst = allocateBinaryDataUninitialized(srcLength);
     if(*dst == NULL) return;
 
     memcpy((*dst)->_buff, srcData, srcLength);
@@ -61,6 +61,7 @@ typedef enum
 @details -201 ～     : ファイル操作関連全般の問題
 @details -301 ～     : Exif ファイル操作関連の問題
 @details -401 ～     : SVG ファイル操作関連の問題
+@details -501 ～     : 非同期処理関連の問題
 @details -900        : その他の問題
 
 @{
@@ -74,6 +75,7 @@ typedef enum
 
 #define INCORRECT_PARAMETER                   ((int)-101)                /*!< @brief 不正な引数が指定された場合 */
 #define SAME_FILE_PATH                        ((int)-102)                /*!< @brief 読込元と出力先の画像ファイルパスが同じ */
+#define ALLOCATOR_IN_USE                      ((int)-103)                /*!< @brief 差し替え前のメモリ確保関数で確保した領域が残っている */
 
 #define FILE_NOT_EXISTS                       ((int)-201)                /*!< @brief 読込元画像ファイルが存在しない */
 #define FILE_ALREADY_EXISTS                   ((int)-202)                /*!< @brief 出力先画像ファイルが既に存在する */
@@ -106,6 +108,11 @@ typedef enum
 #define COMBINATION_HASHES_DOES_NOT_MATCH     ((int)-400)                /*!< @brief 原本画像と黒板画像の組み合わせのハッシュ値が一致しない */
 #define ORG_DOES_NOT_EXIST                    ((int)-401)                /*!< @brief 原本画像が存在しない */
 
+#define JOB_CANCELLED                         ((int)-501)                /*!< @brief 処理が取り消された */
+#define QUEUE_FULL                            ((int)-502)                /*!< @brief 処理待ちの数が上限に達している */
+#define QUEUE_STOPPED                         ((int)-503)                /*!< @brief 処理キューが停止処理中 */
+#define JOB_NOT_FOUND                         ((int)-504)                /*!< @brief 取り消し対象の処理が処理待ちの中に見つからない */
+
 #define OTHER_ERROR                           ((int)-900)                /*!< @brief その他のエラー */
 /*! @} */
 
@@ -124,6 +131,7 @@ typedef enum
 
 #define JW_ERROR_INCORRECT_PARAMETER          INCORRECT_PARAMETER      /*!< @brief 不正な引数が指定された場合 */
 #define JW_ERROR_SAME_FILE_PATH               SAME_FILE_PATH           /*!< @brief 読込元と出力先の画像ファイルパスが同じ */
+#define JW_ERROR_ALLOCATOR_IN_USE             ALLOCATOR_IN_USE         /*!< @brief 差し替え前のメモリ確保関数で確保した領域が残っている */
 
 #define JW_ERROR_READ_FILE_NOT_EXISTS         FILE_NOT_EXISTS          /*!< @brief 読込元画像ファイルが存在しない */
 #define JW_ERROR_WRITE_FILE_ALREADY_EXISTS    FILE_ALREADY_EXISTS      /*!< @brief 出力先画像ファイルが既に存在する */
@@ -245,6 +253,65 @@ typedef enum
 #define JC_SVG_ERROR_OTHERS                     OTHER_ERROR             /*!< @brief メモリ確保失敗などの予期せぬエラー */
 /*! @} */
 
+/*!
+@name SVG ファイル作成処理リターンコード
+
+@details    0    : 正常終了
+@details -101 ～ : 引数の不正などコード上の問題
+@details -201 ～ : ファイル操作関連全般の問題
+@details -301 ～ : Exif ファイル操作関連の問題
+@details -900    : その他の問題
+
+@{
+*/
+#define JW_SVG_CREATE_SUCCESS                   FUNCTION_SUCCESS        /*!< @brief 正常終了 */
+#define JW_SVG_ERROR_INCORRECT_PARAMETER        INCORRECT_PARAMETER     /*!< @brief 引数に NULL を渡された、メタデータや注釈の内容が不正など、引数指定に不備がある場合 */
+#define JW_SVG_ERROR_SAME_FILE_PATH             SAME_FILE_PATH          /*!< @brief 読み込み元と出力先のファイルパスが同じ */
+
+#define JW_SVG_ERROR_FILE_DOES_NOT_EXIST        FILE_NOT_EXISTS         /*!< @brief 読み込み元ファイルが存在しない */
+#define JW_SVG_ERROR_FILE_ALREADY_EXISTS        FILE_ALREADY_EXISTS     /*!< @brief 出力先ファイルが既に存在する */
+#define JW_SVG_ERROR_FILE_OPEN_FAILED           FILE_OPEN_FAILED        /*!< @brief ファイルオープン失敗 */
+#define JW_SVG_ERROR_FILE_SIZE_ZERO             FILE_SIZE_ZERO          /*!< @brief 読み込んだファイルサイズがゼロ */
+#define JW_SVG_ERROR_FILE_WRITE_FAILED          FILE_WRITE_FAILED       /*!< @brief ファイル書き込み失敗 */
+#define JW_SVG_ERROR_FILE_CLOSE_FAILED          FILE_CLOSE_FAILED       /*!< @brief ファイルクローズ失敗 */
+
+#define JW_SVG_ERROR_INCORRECT_EXIF_FORMAT      INCORRECT_EXIF_FORMAT   /*!< @brief 画像の幅と高さを取得できない */
+
+#define JW_SVG_ERROR_ORG_DOES_NOT_HAVE_HASH     ORG_DOES_NOT_HAVE_HASH  /*!< @brief 原本画像に画像ハッシュまたは撮影日時ハッシュが含まれていない */
+#define JW_SVG_ERROR_ORG_HASH_NG_IMAGE          ORG_HASH_NG_IMAGE       /*!< @brief 原本画像のハッシュ値（画像）が正しくない */
+#define JW_SVG_ERROR_ORG_HASH_NG_DATE           ORG_HASH_NG_DATE        /*!< @brief 原本画像のハッシュ値（撮影日時）が正しくない */
+#define JW_SVG_ERROR_ORG_HASH_NG_BOTH           ORG_HASH_NG_BOTH        /*!< @brief 原本画像のハッシュ値（画像、撮影日時）が正しくない */
+
+#define JW_SVG_ERROR_CB_DOES_NOT_HAVE_HASH      CB_DOES_NOT_HAVE_HASH   /*!< @brief 黒板画像に画像ハッシュまたは撮影日時ハッシュが含まれていない */
+#define JW_SVG_ERROR_CB_HASH_NG_IMAGE           CB_HASH_NG_IMAGE        /*!< @brief 黒板画像のハッシュ値（画像）が正しくない */
+#define JW_SVG_ERROR_CB_HASH_NG_DATE            CB_HASH_NG_DATE         /*!< @brief 黒板画像のハッシュ値（撮影日時）が正しくない */
+#define JW_SVG_ERROR_CB_HASH_NG_BOTH            CB_HASH_NG_BOTH         /*!< @brief 黒板画像のハッシュ値（画像、撮影日時）が正しくない */
+
+#define JW_SVG_ERROR_OTHERS                     OTHER_ERROR             /*!< @brief その他のエラー（メモリ領域の確保失敗など） */
+/*! @} */
+
+/*!
+@name 非同期処理リターンコード
+
+@details    0    : 正常終了
+@details -101 ～ : 引数の不正などコード上の問題
+@details -501 ～ : 非同期処理関連の問題
+@details -900    : その他の問題
+
+@{
+*/
+#define JQ_SUCCESS                            FUNCTION_SUCCESS         /*!< @brief 正常終了 */
+
+#define JQ_ERROR_INCORRECT_PARAMETER          INCORRECT_PARAMETER      /*!< @brief 不正な引数が指定された場合 */
+
+#define JQ_ERROR_CANCELLED                    JOB_CANCELLED            /*!< @brief 処理が取り消された（完了通知の結果として渡される） */
+#define JQ_ERROR_QUEUE_FULL                   QUEUE_FULL               /*!< @brief 処理待ちの数が上限に達している */
+#define JQ_ERROR_QUEUE_STOPPED                QUEUE_STOPPED            /*!< @brief 処理キューが停止処理中 */
+#define JQ_ERROR_JOB_NOT_FOUND                JOB_NOT_FOUND            /*!< @brief 取り消し対象の処理が処理待ちの中に見つからない */
+
+#define JQ_ERROR_OTHER                        OTHER_ERROR              /*!< @brief その他のエラー */
+/*! @} */
+
 /*! @name 定数マクロ定義 */
 /*! @{ */
 #define BYTE_SIZE_UNSIGNED_CHAR  ((size_t) 1) /*!< @brief unsigned char のバイト数 */
@@ -252,6 +319,9 @@ typedef enum
 #define BYTE_SIZE_UNSIGNED_INT   ((size_t) 4) /*!< @brief unsigned int のバイト数 */
 #define BIT_SIZE_1BYTE           ((size_t) 8) /*!< @brief 1 バイトのビット数 */
 #define BYTE_SIZE_HASH_LENGTH    ((size_t)64) /*!< @brief ハッシュのバイト数 */
+#define BYTE_SIZE_HASH_DIGEST    ((size_t)32) /*!< @brief 16 進数文字列に変換する前のハッシュのバイト数 */
+#define BYTE_SIZE_ARENA_BLOCK  ((size_t)4096) /*!< @brief アリーナがヒープから追加で確保する領域の標準のバイト数 */
+#define BYTE_SIZE_ARENA_ALIGN    ((size_t)16) /*!< @brief アリーナから割り当てる領域の先頭アドレスの境界 */
 /*! @} */
 
 
@@ -268,6 +338,50 @@ struct _binaryData
     unsigned char _buff[]; /*!< @brief 値 */
 };
 
+/*!
+@struct ByteView
+@brief 他のバイト配列の一部を、複製せずに参照するための構造体
+@details 参照先の領域は所有しないため、参照先のバイト配列を解放した後は使用できない。
+*/
+typedef struct
+{
+    const unsigned char *_ptr; /*!< @brief 参照先の先頭 */
+    size_t _len;               /*!< @brief 参照する長さ */
+} ByteView;
+
+struct _arenaBlock;
+
+/*!
+@struct Arena
+@brief 1 回の公開 API 呼び出しの間だけ使用する一時領域を、まとめて割り当てるための構造体
+@details 領域の先頭から順に切り出して割り当て、割り当てた領域を個別に解放することはない。
+呼び出し元が用意した初期領域が足りなくなった場合のみヒープから領域を追加し、arenaRelease でまとめて解放する。
+*/
+typedef struct
+{
+    unsigned char *_buff;           /*!< @brief 現在割り当てに使用している領域 */
+    size_t _capacity;               /*!< @brief _buff のバイト数 */
+    size_t _used;                   /*!< @brief _buff のうち割り当て済みのバイト数 */
+    unsigned char *_initialBuff;    /*!< @brief 呼び出し元が用意した初期領域 */
+    size_t _initialCapacity;        /*!< @brief _initialBuff のバイト数 */
+    struct _arenaBlock *_blocks;    /*!< @brief ヒープから追加した領域（新しい順） */
+    size_t _allocCount;             /*!< @brief 領域を割り当てた回数 */
+    size_t _heapCount;              /*!< @brief ヒープから領域を追加した回数 */
+} Arena;
+
+/*!
+@struct FileDataCache
+@brief 同じスレッドで複数のファイルを順に読み込む際に、読み込み先の領域を使い回すための構造体
+@details 一度に貸し出す領域は 1 つのみで、貸し出し中に要求された場合は通常どおり確保する。
+複数のスレッドから同時に使用しないこと。使い終わったら releaseFileDataCache で解放する。
+*/
+typedef struct
+{
+    struct _binaryData *_data;  /*!< @brief 使い回す読み込み先（未確保の場合は NULL ） */
+    size_t _capacity;           /*!< @brief _data のバイナリ領域のバイト数 */
+    JACIC_BOOL _inUse;          /*!< @brief _data を貸し出しているか */
+} FileDataCache;
+
 /*!
 @brief 稼働環境のエンディアンを判定し、エンディアンを示す値を返す。
 @retval BIG_ENDIAN ビッグエンディアン
@@ -298,6 +412,56 @@ unsigned int swapEndian32(unsigned int src);
 */
 int getCharCode(unsigned char *dst, unsigned char hexChar);
 
+/*!
+@brief バイト配列を 16 進数の文字列表現（小文字）に変換する。
+@details 1 バイトにつき 2 文字を出力する。終端文字は付加しない。
+@param [out] dst 変換結果を受けとる配列（length * 2 バイト以上の長さを持つこと）
+@param [in] src 変換対象のバイト配列
+@param length src の長さ
+*/
+void encodeHex(unsigned char *dst, const unsigned char *src, size_t length);
+
+/*!
+@brief 16 進数の文字列表現（小文字）をバイト配列に変換する。
+@details encodeHex で出力される形式のみを受け付け、大文字を含む場合も不正として扱う。
+@param [out] dst 変換結果を受けとる配列（length / 2 バイト以上の長さを持つこと）
+@param [in] src 変換対象の文字列
+@param length src の長さ（偶数であること）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER src に 16 進数として不正な文字が含まれる場合
+*/
+int decodeHex(unsigned char *dst, const unsigned char *src, size_t length);
+
+/*!
+@brief 2 つのバイト配列が等しいかを、内容によらず一定の時間で比較する。
+@param [in] lhs 比較対象のバイト配列
+@param [in] rhs 比較対象のバイト配列
+@param length 比較するバイト数
+@retval 0 等しい
+@retval 0以外 等しくない
+*/
+int compareConstantTime(const unsigned char *lhs, const unsigned char *rhs, size_t length);
+
+/*!
+@brief バイト配列から最初の 0xFF（マーカーの先頭バイト）を探す。
+@details SSE2 / NEON が利用できる場合は 16 バイト単位で比較する。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@return 最初に見つかった 0xFF の位置（見つからなかった場合は length ）
+*/
+size_t findMarkerPrefix(const unsigned char *data, size_t length);
+
+/*!
+@brief バイト配列から、XML の字句解析で 1 バイトずつ判定する必要のあるバイトを探す。
+@details 制御文字 (0x00 ～ 0x1F) 、 0x7F 以上のバイト、 '<' 、 '&' および delimiter を探す。
+SSE2 / NEON が利用できる場合は 16 バイト単位で比較する。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@param delimiter あわせて探すバイト（属性値を囲む引用符など）
+@return 最初に見つかった位置（見つからなかった場合は length ）
+*/
+size_t findXMLSpecialByte(const unsigned char *data, size_t length, unsigned char delimiter);
+
 /*!
 @brief ファイルにバッファの内容を length バイト書き込む。
 @param [in] dst 書き込み対象となるファイルパス
@@ -310,17 +474,179 @@ int getCharCode(unsigned char *dst, unsigned char hexChar);
 */
 int writeFile(const char *dst, unsigned char *outBuff, size_t length);
 
+/*!
+@def BYTE_VIEW_GATHER_MAX
+@brief writeFileGather で一度に書き込めるバイト列の最大数
+*/
+#define BYTE_VIEW_GATHER_MAX ((size_t)8)
+
+/*!
+@brief 複数のバイト列を先頭から順に連結した内容をファイルに書き込む。
+@details 連結したバッファを作成せずに、各バイト列から直接書き込む（ POSIX 環境では writev を使用する）。
+@param [in] dst 書き込み対象となるファイルパス
+@param [in] parts 書き込むバイト列の配列（長さ 0 の要素は読み飛ばす）
+@param count parts の要素数（ BYTE_VIEW_GATHER_MAX 以下）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗
+@retval FILE_WRITE_FAILED ファイルへの書き込みに失敗
+@retval FILE_CLOSE_FAILED ファイルのクローズに失敗
+*/
+int writeFileGather(const char *dst, const ByteView *parts, size_t count);
+
+/*!
+@brief allocateMemory / releaseMemory で使用する関数を差し替える。
+@details allocFunction と freeFunction の両方に NULL を指定した場合は、標準の malloc / free に戻す。
+allocateMemory で確保した領域が 1 つでも解放されずに残っている間は差し替えずに失敗する。
+差し替え中に他のスレッドから呼び出された allocateMemory は、差し替えが終わるまで待つ。
+@param allocFunction メモリを確保する関数（確保するバイト数と context を受け取り、確保できなかった場合は NULL を返す）
+@param freeFunction allocFunction で確保したメモリを解放する関数（解放する領域と context を受け取る）
+@param context allocFunction, freeFunction に渡す任意の値
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER allocFunction と freeFunction の片方のみ NULL が指定された場合
+@retval ALLOCATOR_IN_USE 差し替え前の関数で確保した領域が残っている場合、または他のスレッドが差し替え中の場合
+*/
+int setAllocator(void *(*allocFunction)(size_t size, void *context), void (*freeFunction)(void *ptr, void *context), void *context);
+
+/*!
+@brief setAllocator で指定された関数（指定がなければ malloc ）でメモリを確保する。
+@details 確保した領域は初期化されない。使い終わったら releaseMemory で解放すること。
+@param size 確保するバイト数
+@return 確保した領域の先頭。size が 0 の場合、またはメモリが確保できなかった場合は NULL
+*/
+void *allocateMemory(size_t size);
+
+/*!
+@brief allocateMemory で確保したメモリを解放する。
+@param [in] ptr 解放する領域。NULL の場合は何もしない
+*/
+void releaseMemory(void *ptr);
+
 /*!
 @brief 実体と長さをもつバイナリデータ構造体のメモリを確保して返す。
 @details 確保されたバイナリ領域 _buff は 0x00 で初期化される。
+確保には allocateMemory を使用するため、使い終わったら _SECURE_RELEASE で解放すること。
 @param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
 @return 確保したバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
 */
 struct _binaryData *allocateBinaryData(const size_t dataLen);
 
+/*!
+@brief 実体と長さをもつバイナリデータ構造体のメモリを、バイナリ領域を初期化せずに確保して返す。
+@details 直後に全体を上書きするバッファ（ファイルの読み込み先など）に使用し、ページへの書き込みを 1 回で済ませる。
+MemorySanitizer を有効にしたビルドでは _buff を未初期化として扱うため、上書き前の読み出しは検出される。
+使い終わったら _SECURE_RELEASE で解放すること。
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return 確保したバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *allocateBinaryDataUninitialized(const size_t dataLen);
+
+/*!
+@brief ファイルの読み込み先となるバイナリデータ構造体のメモリを、バイナリ領域を初期化せずに確保して返す。
+@details mapFileBinaryData でマップしたものと同じく、使い終わったら releaseFileBinaryData で解放すること。
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return 確保したバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *allocateFileBinaryData(const size_t dataLen);
+
+/*!
+@brief ファイルの読み込み先となるバイナリデータ構造体を、cache の領域を使い回して返す。
+@details cache の領域が足りない場合は dataLen の大きさで確保し直す。
+返した領域は releaseFileBinaryData で cache に返却され、次の呼び出しで再び使用される。
+@param [in, out] cache 領域を使い回すためのキャッシュ。NULL の場合は allocateFileBinaryData と同じ
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return バイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *allocateCachedFileBinaryData(FileDataCache *cache, const size_t dataLen);
+
+/*!
+@brief FileDataCache が保持している領域を解放する。
+@details 貸し出し中の領域が残っていないこと。
+@param [in, out] cache 解放の対象となるキャッシュ
+*/
+void releaseFileDataCache(FileDataCache *cache);
+
+/*!
+@brief ファイルをメモリにマップし、読み取り専用のバイナリデータ構造体として返す。
+@details JCOMSIA_ENABLE_MAPPED_READ を定義してビルドした POSIX 環境でのみ有効で、それ以外では常に失敗する。
+マップした領域には先読みのヒントを与える。失敗した場合は通常の読み込みで代替すること。
+_buff は書き換えられない。また、使用中にファイルが切り詰められた場合の動作は保証しない。
+@param [in] filePath ファイルの場所
+@param [out] dst マップした結果を格納するポインタ。使い終わったら releaseFileBinaryData で解放すること。
+@retval FUNCTION_SUCCESS 正常終了
+@retval OTHER_ERROR マップできなかった場合（ファイルが存在しない、通常のファイルではない、サイズが 0 の場合を含む）
+*/
+int mapFileBinaryData(const char *filePath, struct _binaryData **dst);
+
+/*!
+@brief allocateFileBinaryData または mapFileBinaryData で取得したバイナリデータ構造体を解放する。
+@details allocateCachedFileBinaryData で取得したものは解放せず、キャッシュに返却する。
+@param [in, out] dst 解放の対象となるポインタの参照。処理後は NULL が設定される。
+*/
+void releaseFileBinaryData(struct _binaryData **dst);
+
+/*!
+@brief アリーナを初期化する。
+@param [out] arena 初期化対象のアリーナ
+@param [in] initialBuff 最初に割り当てに使用する領域（呼び出し元のスタック上の配列など）。用意しない場合は NULL
+@param initialCapacity initialBuff のバイト数
+*/
+void arenaInit(Arena *arena, unsigned char *initialBuff, size_t initialCapacity);
+
+/*!
+@brief アリーナから領域を割り当てる。
+@details 割り当てた領域は 0x00 で初期化され、BYTE_SIZE_ARENA_ALIGN の境界に配置される。
+割り当てた領域は arenaRelease を呼び出すまで有効で、個別に解放してはならない。
+@param [in, out] arena 割り当て元のアリーナ
+@param size 割り当てるバイト数
+@return 割り当てた領域の先頭。size が 0 の場合、またはメモリが確保できなかった場合は NULL
+*/
+void *arenaAlloc(Arena *arena, size_t size);
+
+/*!
+@brief アリーナから実体と長さをもつバイナリデータ構造体を割り当てて返す。
+@details allocateBinaryData と同じく _buff は 0x00 で初期化される。個別に解放してはならない。
+@param [in, out] arena 割り当て元のアリーナ
+@param dataLen データ部の長さ（binaryData->_len の値に割り当てられる）
+@return 割り当てたバイナリデータ構造体のポインタ。メモリが確保できなかった場合は NULL
+*/
+struct _binaryData *arenaAllocateBinaryData(Arena *arena, const size_t dataLen);
+
+/*!
+@brief アリーナから割り当てた領域をまとめて解放し、初期領域から割り当てを再開できる状態に戻す。
+@details 割り当て回数などの計数値は保持する。
+@param [in, out] arena 解放対象のアリーナ
+*/
+void arenaRelease(Arena *arena);
+
+#if defined(JCOMSIA_TEST_HOOKS)
+
+/*!
+@struct ArenaStatistics
+@brief 全てのアリーナの割り当て回数の累計（テスト用）
+*/
+typedef struct
+{
+    size_t _allocCount;             /*!< @brief 領域を割り当てた回数 */
+    size_t _heapCount;              /*!< @brief ヒープから領域を追加した回数 */
+} ArenaStatistics;
+
+/*!
+@brief resetArenaStatistics を呼び出してからの、全てのアリーナの割り当て回数の累計を返す（テスト用）。
+@param [out] statistics 累計を受けとる構造体
+*/
+void getArenaStatistics(ArenaStatistics *statistics);
+
+/*!
+@brief 全てのアリーナの割り当て回数の累計を 0 に戻す（テスト用）。
+*/
+void resetArenaStatistics(void);
+
+#endif /* JCOMSIA_TEST_HOOKS */
+
 /*!
 @brief バイト配列構造体の複製を行う。
-@details メモリの動的確保が行われるため、dst を使い終わったら解放する必要がある。
+@details メモリの動的確保が行われるため、dst を使い終わったら _SECURE_RELEASE で解放する必要がある。
 @param [in] src コピー元のバイト配列構造体
 @param [out] dst コピー先のバイト配列構造体
  */
@@ -328,7 +654,7 @@ void copyBinaryDataToBinaryData(const struct _binaryData *src, struct _binaryDat
 
 /*!
 @brief バイト配列を構造体に複製する。
-@details メモリの動的確保が行われるため、dst を使い終わったら解放する必要がある。
+@details メモリの動的確保が行われるため、dst を使い終わったら _SECURE_RELEASE で解放する必要がある。
 @param [in] srcData コピー元のバイト配列
 @param length srcData のデータ長
 @param [out] dst コピー先のバイト配列構造体
@@ -354,4 +680,21 @@ do { \
 } \
 while(0)
 
+/*!
+@def _SECURE_RELEASE
+@brief allocateMemory （allocateBinaryData などを含む）で確保したメモリ領域を解放する。
+@details 解放されたポインタには NULL が設定される。
+
+@param [in] ptr メモリ解放の対象となるポインタ。処理後は `NULL` ポインタを指す。
+*/
+#define _SECURE_RELEASE(ptr) \
+do { \
+    if((ptr) != NULL) \
+    { \
+        releaseMemory((ptr)); \
+        (ptr) = NULL; \
+    } \
+} \
+while(0)
+
 #endif /* COMMON_H_ */
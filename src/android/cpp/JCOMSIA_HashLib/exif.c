@@ -167,15 +167,14 @@ unsigned short seekToEOI(JpegBuffer *src, unsigned long *seek)
         return ret;
     }
 
-    while(*seek < src->_len)
+    while(*seek + 1 < src->_len)
     {
-        memcpy(&seg, &(src->_buff[*seek]), BYTE_SIZE_SEGMENT_SIZE);
+        /* マーカーの先頭バイト (0xFF) まで読み飛ばす */
+        *seek += findMarkerPrefix(&(src->_buff[*seek]), src->_len - 1 - *seek);
+        if(src->_len <= *seek + 1) break;
 
-        /* リトルエンディアンの場合は反転させてビッグエンディアンにする */
-        if(getEndian() == JACIC_LITTLE_ENDIAN)
-        {
-            seg = swapEndian16(seg);
-        }
+        /* 次のバイトでマーカーの種類を判定する */
+        seg = (unsigned short)(0xFF00U | src->_buff[*seek + 1]);
 
         if(seg == EXIF_MARKER_EOI)
         {
@@ -277,13 +276,8 @@ unsigned short getMarkerSegment(JpegBuffer *src, unsigned long *seek)
 
     while(*seek + BYTE_SIZE_SEGMENT_MARKER <= src->_len)
     {
-        memcpy(&seg, &(src->_buff[*seek]), BYTE_SIZE_SEGMENT_MARKER);
-
-        /* リトルエンディアンの場合は反転させてビッグエンディアンにする */
-        if(getEndian() == JACIC_LITTLE_ENDIAN)
-        {
-            seg = swapEndian16(seg);
-        }
+        /* ビッグエンディアンの順で 2 バイトを組み立てる */
+        seg = (unsigned short)((src->_buff[*seek] << BIT_SIZE_1BYTE) | src->_buff[*seek + 1]);
 
         if(seg == 0xFFFFU)
         {
@@ -309,14 +303,9 @@ unsigned short getMarkerSegment(JpegBuffer *src, unsigned long *seek)
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_IDENTIFIER 取得した識別子と引数の識別子が別だった場合
-@retval OTHER_ERROR メモリ確保に失敗した場合
 */
 int checkIdentifier(const char *identifier, JpegBuffer *src, unsigned long *startIndex, size_t size)
 {
-    int ret;
-    unsigned char *tmpReadBuffer = NULL;
-    size_t readBufferSize = BYTE_SIZE_UNSIGNED_CHAR * size;
-
     if(src == NULL)
     {
         return INCORRECT_PARAMETER;
@@ -327,102 +316,292 @@ int checkIdentifier(const char *identifier, JpegBuffer *src, unsigned long *star
         return INCORRECT_PARAMETER;
     }
 
-    if(src->_len < *startIndex)
+    if(src->_len < *startIndex ||
+            src->_len - *startIndex < size)
     {
         return INCORRECT_PARAMETER;
     }
 
-    tmpReadBuffer = (unsigned char *) malloc(readBufferSize);
+    /* 一時領域に複製せず、指定された長さで識別子を直接比較する */
+    if(memcmp(identifier, &(src->_buff[*startIndex]), size) != 0)
+    {
+        return INCORRECT_IDENTIFIER;
+    }
+
+    return FUNCTION_SUCCESS;
+}
 
-    if(tmpReadBuffer == NULL)
+/*!
+@brief メタデータに対し、指定位置から終端文字までのテキストを走査し、取得する。
+@param [in] src 対象となるバイト配列の参照
+@param [out] text 取得したテキストの参照（src の該当範囲を指し、終端文字は長さに含まない）
+@param [in, out] seek 走査開始位置。走査したバイト数だけ呼び出し元の数値も加算される
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_TEXT 参照の終端まで終端文字が見つからなかった場合
+*/
+int getByteText(const ByteView *src, ByteView *text, unsigned long *seek)
+{
+    const unsigned char *terminator;
+
+    if(src->_len <= *seek)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
+        /* 走査位置が参照の終端を超えている */
+        return INCORRECT_TEXT;
     }
-    else
+
+    /* 終端文字を探す */
+    terminator = (const unsigned char *) memchr(&(src->_ptr[*seek]), 0x00, src->_len - *seek);
+
+    if(terminator == NULL)
     {
-        /* 領域のゼロクリア */
-        memset(tmpReadBuffer, 0x00, readBufferSize);
+        /* 最後まで終端文字が見つからなかった */
+        *seek = src->_len;
+        return INCORRECT_TEXT;
+    }
+
+    /* テキストを複製せずに参照する */
+    text->_ptr = &(src->_ptr[*seek]);
+    text->_len = (size_t)(terminator - text->_ptr);
+
+    /* 終端文字の次まで走査位置を進める */
+    *seek += text->_len + 1;
+
+    return FUNCTION_SUCCESS;
+}
 
-        /* 指定された長さで識別子の取得 */
-        memcpy(tmpReadBuffer, &(src->_buff[*startIndex]), readBufferSize);
+/*!
+@brief セグメント索引の末尾にセグメントを追加する。
+@param [in, out] index 追加先のセグメント索引
+@param [in] segment 追加するセグメント
+@retval FUNCTION_SUCCESS 正常終了
+@retval OTHER_ERROR メモリ確保に失敗した場合
+*/
+static int appendSegment(JpegSegmentIndex *index, const JpegSegment *segment)
+{
+    if(index->_capacity <= index->_count)
+    {
+        size_t capacity = (index->_capacity == 0) ? 16 : index->_capacity * 2;
+        JpegSegment *segments;
 
-        if(memcmp(identifier, (char *)tmpReadBuffer, readBufferSize) == 0)
+        if(index->_arena != NULL)
         {
-            ret = FUNCTION_SUCCESS;
+            /* アリーナからは拡張できないので、新しい領域に移し替える（元の領域はアリーナの解放時にまとめて解放される） */
+            segments = (JpegSegment *) arenaAlloc(index->_arena, sizeof(JpegSegment) * capacity);
+
+            if(segments != NULL && index->_count != 0)
+            {
+                memcpy(segments, index->_segments, sizeof(JpegSegment) * index->_count);
+            }
         }
         else
         {
-            ret = INCORRECT_IDENTIFIER;
+            segments = (JpegSegment *) realloc(index->_segments, sizeof(JpegSegment) * capacity);
         }
+
+        if(segments == NULL)
+        {
+            /* メモリ確保失敗 */
+            return OTHER_ERROR;
+        }
+
+        index->_segments = segments;
+        index->_capacity = capacity;
     }
 
-    /* メモリ解放 */
-    _SECURE_FREE(tmpReadBuffer);
+    index->_segments[index->_count] = *segment;
+    index->_count++;
 
-    return ret;
+    return FUNCTION_SUCCESS;
 }
 
 /*!
-@brief メタデータに対し、指定位置から終端文字までのテキストを走査し、取得する。
-@param [in] src 対象となるバイト配列構造体
-@param [out] text 取得するテキスト（終端文字を含む）
-@param [in, out] seek 走査開始位置。走査したバイト数だけ呼び出し元の数値も加算される
-@param maxByteSize 最大走査数
+@brief JPEG 画像を先頭から 1 回走査し、セグメント索引を作成する。
+@details 作成した索引は releaseSegmentIndex で解放すること（失敗した場合も呼び出してよい）。
+@param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [out] index 作成したセグメント索引
+@param [in, out] arena 索引の領域の割り当て元となるアリーナ。ヒープから確保する場合は NULL
 @retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_PARAMETER 最大走査数が 0 の場合
-@retval INCORRECT_TEXT 最大文字数まで終端文字が見つからなかった場合
+@retval INCORRECT_PARAMETER いずれかの引数の参照先が NULL の場合
+@retval INCORRECT_EXIF_FORMAT 先頭に SOI マーカーが見つからなかった場合
+@retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int getByteText(HashBuffer *src, unsigned char *text, unsigned long *seek, size_t maxByteSize)
+int buildSegmentIndex(JpegBuffer *src, JpegSegmentIndex *index, Arena *arena)
 {
-    int ret = FUNCTION_SUCCESS;
-    unsigned char c = 0x00;
-    unsigned int i;
+    int ret;
+    unsigned long seek = 0UL;
+
+    /* パラメータチェック */
+    if(src == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
 
-    if(maxByteSize == 0U)
+    if(index == NULL)
     {
-        /* 走査できない（不正な引数） */
         return INCORRECT_PARAMETER;
     }
 
-    for(i = 0; i < maxByteSize; ++i)
+    index->_segments = NULL;
+    index->_count = 0;
+    index->_capacity = 0;
+    index->_startOffset = 0UL;
+    index->_arena = arena;
+
+    /* Exif スタートマーカー (SOI) チェック */
+    ret = checkFirstFindSOI(src, &seek);
+
+    if(ret != FUNCTION_SUCCESS)
+    {
+        return ret;
+    }
+
+    index->_startOffset = seek;
+
+    /*
+     * 各解析処理が走査するセグメントをすべて登録する
+     * SOS 、 EOI 、判別不可能なセグメントはどの解析処理でも走査が終わるため、登録した時点で終了する
+     */
+    while(1)
     {
-        c = src->_buff[(*seek)++];
-        text[i] = c;
+        JpegSegment segment;
+        unsigned short seg = getMarkerSegment(src, &seek);
+
+        memset(&segment, 0x00, sizeof(JpegSegment));
+        segment._marker = seg;
+        segment._offset = seek;
+        segment._nextOffset = seek;
+
+        /*
+         * セグメントが SOI の場合（サイズ定義を持たない）
+         */
+        if(seg == EXIF_MARKER_SOI)
+        {
+            segment._nextOffset = seek + BYTE_SIZE_SEGMENT_MARKER;
+        }
+
+        /*
+         * セグメントが SOF0 ～ RST7 、または DQT ～ COM の場合
+         */
+        else if(((seg >= EXIF_MARKER_SOF00) && (seg <= EXIF_MARKER_RST07)) ||
+                ((seg >= EXIF_MARKER_DQT)   && (seg <= EXIF_MARKER_COM)))
+        {
+            /* セグメントのサイズを取得 */
+            segment._size = getAppSize(src, seek + BYTE_SIZE_SEGMENT_MARKER);
+            segment._nextOffset = seek + BYTE_SIZE_SEGMENT_MARKER + segment._size;
+
+            /* APP1 、 APP5 の場合は識別子を記録する（データ終端を超える部分は 0 のまま） */
+            if(seg == EXIF_MARKER_APP01 || seg == EXIF_MARKER_APP05)
+            {
+                unsigned long identifierIndex = seek + BYTE_SIZE_SEGMENT_MARKER + BYTE_SIZE_SEGMENT_SIZE;
+
+                if(identifierIndex < src->_len)
+                {
+                    size_t identifierSize = src->_len - identifierIndex;
+
+                    if(BYTE_SIZE_SEGMENT_IDENTIFIER < identifierSize)
+                    {
+                        identifierSize = BYTE_SIZE_SEGMENT_IDENTIFIER;
+                    }
+
+                    memcpy(segment._identifier, &(src->_buff[identifierIndex]), identifierSize);
+                }
+            }
+        }
+
+        ret = appendSegment(index, &segment);
+
+        if(ret != FUNCTION_SUCCESS)
+        {
+            return ret;
+        }
+
+        /*
+         * SOS 、 EOI 、判別不可能なセグメントの場合
+         */
+        if(segment._nextOffset == segment._offset)
+        {
+            break;
+        }
 
-        if(c == 0x00)
+        /* 走査位置がデータ長を超える場合 */
+        if(src->_len < segment._nextOffset)
         {
-            /* 終端文字に到達 */
             break;
         }
 
+        /* 走査位置を移動 */
+        seek = segment._nextOffset;
     }
 
-    if(c != 0x00)
+    return FUNCTION_SUCCESS;
+}
+
+/*!
+@brief セグメント索引が確保した領域を解放する。
+@details アリーナから割り当てた索引の領域は、アリーナの解放時にまとめて解放される。
+@param [in, out] index 解放対象のセグメント索引
+*/
+void releaseSegmentIndex(JpegSegmentIndex *index)
+{
+    if(index == NULL)
     {
-        /* 最後まで終端文字が見つからなかった */
-        ret = INCORRECT_TEXT;
+        return;
     }
 
-    return ret;
+    if(index->_arena == NULL)
+    {
+        _SECURE_FREE(index->_segments);
+    }
+
+    index->_segments = NULL;
+    index->_count = 0;
+    index->_capacity = 0;
 }
 
 /*!
-@brief ハッシュ値計算に用いるデータ開始位置を取得する。
-@param [in] src JPEG画像のバイナリ読み込み結果データ構造体
-@param [out] retStartIndex 取得する圧縮データ開始位置
-@param [out] retEndIndex 取得する圧縮データ終了位置
-@param ignoreApp5Flag JACIC_BOOL_TRUE のとき、 APP5 領域を発見した際にエラーを返す
+@brief 走査位置から走査を始めた場合に、最初に取得されるセグメントの索引内の位置を返す。
+@param [in] index セグメント索引
+@param seek 走査位置（SOI の次、またはいずれかのセグメントの次の走査開始位置）
+@return 索引内の位置（該当するセグメントがない場合は index->_count ）
+*/
+size_t findSegmentPosition(const JpegSegmentIndex *index, unsigned long seek)
+{
+    size_t low = 0;
+    size_t high = index->_count;
+
+    /* セグメントは出現順に並んでいるので、マーカーの位置で二分探索する */
+    while(low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if(index->_segments[middle]._offset < seek)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/*!
+@brief セグメント索引に保持した識別子が、指定した識別子と等しいか調べる。
+@details checkIdentifier と同じ戻り値を返す。
+@param [in] identifier 比較対象の文字列
+@param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] segment 対象のセグメント
+@param size 比較するバイト数
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
-@retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
-@retval APP5_ALREADY_EXISTS ignoreApp5Flag が JACIC_BOOL_TRUE であり、APP5 領域が既に存在する場合
+@retval INCORRECT_IDENTIFIER 取得した識別子と引数の識別子が別だった場合
+@retval OTHER_ERROR メモリ確保に失敗した場合
 */
-static int getHashSourceData(JpegBuffer *src, unsigned long *retStartIndex, unsigned long *retEndIndex, JACIC_BOOL ignoreApp5Flag)
+int checkSegmentIdentifier(const char *identifier, JpegBuffer *src, const JpegSegment *segment, size_t size)
 {
-    unsigned short seg = 0xFFFFU;
-    unsigned short len = 0x0000U;
-    unsigned long seek = 0UL;
+    unsigned long startIndex;
 
     /* パラメータチェック */
     if(src == NULL)
@@ -430,36 +609,74 @@ static int getHashSourceData(JpegBuffer *src, unsigned long *retStartIndex, unsi
         return INCORRECT_PARAMETER;
     }
 
-    if(retStartIndex == NULL)
+    if(segment == NULL)
     {
         return INCORRECT_PARAMETER;
     }
 
-    /* Exif スタートマーカー (SOI) チェック */
-    seg = getMarkerSegment(src, &seek);
+    startIndex = segment->_offset + BYTE_SIZE_SEGMENT_MARKER + BYTE_SIZE_SEGMENT_SIZE;
 
-    if(seg != EXIF_MARKER_SOI)
+    if(BYTE_SIZE_SEGMENT_IDENTIFIER < size)
     {
-        /*
-         * スタートマーカー (SOI) でない場合、
-         * 「Exif ファイルフォーマットが不正」としてエラーを返す
-         */
-        return INCORRECT_EXIF_FORMAT;
+        /* 索引に保持していない長さの場合はデータから読み込む */
+        return checkIdentifier(identifier, src, &startIndex, size);
     }
 
-    /* セグメントの長さ分、走査位置をずらす */
-    seek += BYTE_SIZE_UNSIGNED_SHORT;
+    if(src->_len < size)
+    {
+        return INCORRECT_PARAMETER;
+    }
 
-    /* 走査位置がデータ長を超える場合 */
-    if(src->_len < seek)
+    if(src->_len < startIndex)
     {
-        return INCORRECT_EXIF_FORMAT;
+        return INCORRECT_PARAMETER;
+    }
+
+    if(memcmp(identifier, segment->_identifier, size) != 0)
+    {
+        return INCORRECT_IDENTIFIER;
+    }
+
+    return FUNCTION_SUCCESS;
+}
+
+/*!
+@brief ハッシュ値計算に用いる圧縮データの開始位置（SOS セグメント）を取得する。
+@details SOS セグメントより前の範囲しか参照しないため、ファイルの先頭部分のみを読み込んだ状態でも呼び出せる。
+@param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] retStartIndex 取得する圧縮データ開始位置
+@param ignoreApp5Flag JACIC_BOOL_TRUE のとき、 APP5 領域を発見した際にエラーを返す
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
+@retval APP5_ALREADY_EXISTS ignoreApp5Flag が JACIC_BOOL_TRUE であり、APP5 領域が既に存在する場合
+*/
+int findCompressedImageStart(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *retStartIndex, JACIC_BOOL ignoreApp5Flag)
+{
+    size_t i;
+
+    /* パラメータチェック */
+    if(src == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    if(index == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    if(retStartIndex == NULL)
+    {
+        return INCORRECT_PARAMETER;
     }
 
     /* SOS の走査を行う */
-    while(1)
+    for(i = 0; i < index->_count; ++i)
     {
-        seg = getMarkerSegment(src, &seek);
+        const JpegSegment *segment = &(index->_segments[i]);
+        unsigned short seg = segment->_marker;
 
         /*
          * スキャンデータ開始セグメント (SOS) の場合
@@ -467,12 +684,9 @@ static int getHashSourceData(JpegBuffer *src, unsigned long *retStartIndex, unsi
         if(seg == EXIF_MARKER_SOS)
         {
             /* 以降をハッシュ値の計算に用いる為に走査位置を返す */
-            *retStartIndex = seek;
-
-            /* 走査位置をセグメント ID の後ろへ移動 */
-            seek += BYTE_SIZE_UNSIGNED_SHORT;
+            *retStartIndex = segment->_offset;
 
-            break;
+            return FUNCTION_SUCCESS;
         }
 
         /*
@@ -497,44 +711,54 @@ static int getHashSourceData(JpegBuffer *src, unsigned long *retStartIndex, unsi
         }
 
         /*
-         * セグメントが SOF0 ～ RST7 、または DQT ～ COM の場合
-         */
-        else if(((seg >= EXIF_MARKER_SOF00) && (seg <= EXIF_MARKER_RST07)) ||
-                ((seg >= EXIF_MARKER_DQT)   && (seg <= EXIF_MARKER_COM)))
-        {
-            /* 走査位置をセグメント ID の後ろへ移動 */
-            seek += BYTE_SIZE_UNSIGNED_SHORT;
-
-            /* セグメントのサイズを取得 */
-            memcpy(&len, &(src->_buff[seek]), BYTE_SIZE_UNSIGNED_SHORT);
-
-            /* リトルエンディアンの場合は反転させてビッグエンディアンにする */
-            if(getEndian() == JACIC_LITTLE_ENDIAN)
-            {
-                len = swapEndian16(len);
-            }
-
-            /* 走査位置を移動 */
-            seek += len;
-        }
-
-        /*
-         * その他、判別不可能なセグメントの場合
+         * セグメントが SOF0 ～ RST7 、または DQT ～ COM でない場合
          */
-        else
+        else if(!(((seg >= EXIF_MARKER_SOF00) && (seg <= EXIF_MARKER_RST07)) ||
+                  ((seg >= EXIF_MARKER_DQT)   && (seg <= EXIF_MARKER_COM))))
         {
-            /* 「 Exif フォーマットが不正」としてエラーを返す */
+            /* 判別不可能なセグメントなので「 Exif フォーマットが不正」としてエラーを返す */
             return INCORRECT_EXIF_FORMAT;
         }
 
-        /* 走査位置がデータ長を超える場合 */
-        if(src->_len < seek)
+        /* 次の走査位置がデータ長を超える場合 */
+        if(src->_len < segment->_nextOffset)
         {
             return INCORRECT_EXIF_FORMAT;
         }
+    }
+
+    /* SOS が見つからなかった */
+    return INCORRECT_EXIF_FORMAT;
+}
 
+/*!
+@brief ハッシュ値計算に用いるデータ開始位置を取得する。
+@param [in] src JPEG画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] retStartIndex 取得する圧縮データ開始位置
+@param [out] retEndIndex 取得する圧縮データ終了位置
+@param ignoreApp5Flag JACIC_BOOL_TRUE のとき、 APP5 領域を発見した際にエラーを返す
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
+@retval APP5_ALREADY_EXISTS ignoreApp5Flag が JACIC_BOOL_TRUE であり、APP5 領域が既に存在する場合
+*/
+static int getHashSourceData(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *retStartIndex, unsigned long *retEndIndex, JACIC_BOOL ignoreApp5Flag)
+{
+    int ret;
+    unsigned short seg = 0xFFFFU;
+    unsigned long seek = 0UL;
+
+    /* SOS の走査を行う */
+    ret = findCompressedImageStart(src, index, retStartIndex, ignoreApp5Flag);
+    if(ret != FUNCTION_SUCCESS)
+    {
+        return ret;
     }
 
+    /* 走査位置をセグメント ID の後ろへ移動 */
+    seek = *retStartIndex + BYTE_SIZE_UNSIGNED_SHORT;
+
     /* EOI の走査を行う */
     seg = seekToEOI(src, &seek);
 
@@ -553,58 +777,105 @@ static int getHashSourceData(JpegBuffer *src, unsigned long *retStartIndex, unsi
 /*!
 @brief ハッシュ値計算に必要となる『画像の圧縮データのバイナリ』を取得する。
 @details 対象となる範囲は、SOS ～ EOI の間（ SOS と EOI 自身を含む）。 EOI 移行の冗長なデータは無効なものとして無視する。
+取得したバイト配列は src の該当範囲を直接参照するため、src を解放するまでの間だけ使用できる。
 @param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] retImgBin 画像から抽出した『圧縮データ開始位置以降』のバイト配列のポインタ
+@param [in] index src から作成したセグメント索引
+@param [out] retImgView 画像の『圧縮データ開始位置以降』を参照するバイト配列
 @param ignoreApp5Flag JACIC_BOOL_TRUE のとき、 APP5 領域を発見した際にエラーを返す
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP5_ALREADY_EXISTS ignoreApp5Flag が真であり、APP5 領域が既に存在する場合
-@retval OTHER_ERROR メモリの確保に失敗した場合
 */
-int clipCompressedImage(JpegBuffer *src, HashBuffer **retImgBin, JACIC_BOOL ignoreApp5Flag)
+int clipCompressedImage(JpegBuffer *src, const JpegSegmentIndex *index, ByteView *retImgView, JACIC_BOOL ignoreApp5Flag)
 {
     int ret;
     unsigned long startIndex = 0UL;
     unsigned long endIndex = 0UL;
-    size_t dataSize = 0;
-    size_t memorySize = 0;
 
-    if(*retImgBin != NULL)
+    /* パラメータチェック */
+    if(retImgView == NULL)
     {
-        /* 初期化されていない場合初期化する */
-        free(*retImgBin);
-        *retImgBin = NULL;
+        return INCORRECT_PARAMETER;
     }
 
+    retImgView->_ptr = NULL;
+    retImgView->_len = 0;
+
     /*
      * ハッシュ値算出に必要なデータ開始位置を取得する
      * SOSセグメント以降を利用する。
      */
-    ret = getHashSourceData(src, &startIndex, &endIndex, ignoreApp5Flag);
+    ret = getHashSourceData(src, index, &startIndex, &endIndex, ignoreApp5Flag);
 
     if(ret != FUNCTION_SUCCESS)
     {
         return ret;
     }
 
-    /* ハッシュ計算に利用する圧縮データ部分の取得 */
-    dataSize = endIndex - startIndex;
-    memorySize = sizeof(HashBuffer) + dataSize;
-    *retImgBin = (HashBuffer *) malloc(memorySize);
+    /* ハッシュ計算に利用する圧縮データ部分を、複製せずに参照する */
+    retImgView->_ptr = &(src->_buff[startIndex]);
+    retImgView->_len = endIndex - startIndex;
 
-    if(*retImgBin == NULL)
+    return ret;
+}
+
+/*!
+@brief セグメント索引に登録された SOF セグメントから、画像の幅と高さを取得する。
+@details SOS セグメントより前の範囲しか参照しないため、ファイルの先頭部分のみを読み込んだ状態でも呼び出せる。
+@param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] width 画像の幅（ピクセル数）
+@param [out] height 画像の高さ（ピクセル数）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval INCORRECT_EXIF_FORMAT SOF セグメントが見つからない、または幅と高さが定義されていない場合
+*/
+int getImageSize(JpegBuffer *src, const JpegSegmentIndex *index, unsigned short *width, unsigned short *height)
+{
+    size_t position;
+
+    /* パラメータチェック */
+    if(src == NULL || index == NULL || width == NULL || height == NULL)
     {
-        /* メモリ確保失敗 */
-        return OTHER_ERROR;
+        return INCORRECT_PARAMETER;
     }
 
-    /* 領域のゼロクリア */
-    memset(*retImgBin, 0x00, memorySize);
+    *width = 0U;
+    *height = 0U;
 
-    (*retImgBin)->_len = dataSize;
+    for(position = 0; position < index->_count; ++position)
+    {
+        const JpegSegment *segment = &(index->_segments[position]);
+        unsigned short seg = segment->_marker;
+        unsigned long sizeIndex;
 
-    memcpy((*retImgBin)->_buff, &(src->_buff[startIndex]), dataSize);
+        /* SOF0 ～ SOF15 （ DHT 、 JPG 、 DAC を除く）以外は読み飛ばす */
+        if(seg < EXIF_MARKER_SOF00 || EXIF_MARKER_SOF15 < seg ||
+                seg == EXIF_MARKER_DHT || seg == EXIF_MARKER_JPG00 || seg == EXIF_MARKER_DAC)
+        {
+            continue;
+        }
 
-    return ret;
+        /* サイズ定義の後ろは、サンプル精度（ 1 バイト）、高さ（ 2 バイト）、幅（ 2 バイト）の順 */
+        sizeIndex = segment->_offset + BYTE_SIZE_SEGMENT_MARKER + BYTE_SIZE_SEGMENT_SIZE + 1;
+
+        if(segment->_size < BYTE_SIZE_SEGMENT_SIZE + 5 || src->_len < sizeIndex + 4)
+        {
+            return INCORRECT_EXIF_FORMAT;
+        }
+
+        *height = (unsigned short)((src->_buff[sizeIndex + 0] << BIT_SIZE_1BYTE) | src->_buff[sizeIndex + 1]);
+        *width  = (unsigned short)((src->_buff[sizeIndex + 2] << BIT_SIZE_1BYTE) | src->_buff[sizeIndex + 3]);
+
+        /* 高さを DNL セグメントで後から定義する画像は扱わない */
+        if(*width == 0U || *height == 0U)
+        {
+            return INCORRECT_EXIF_FORMAT;
+        }
+
+        return FUNCTION_SUCCESS;
+    }
+
+    return INCORRECT_EXIF_FORMAT;
 }
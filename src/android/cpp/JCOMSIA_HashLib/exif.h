@@ -97,6 +97,39 @@ extern const unsigned short EXIF_MARKER_JPG14;    /*!< @brief JPEG 拡張用リ
 extern const unsigned short EXIF_MARKER_COM;      /*!< @brief Exif マーカーセグメント コメント */
 /*! @} */
 
+/* @name 定数マクロ定義 */
+/* @{ */
+#define BYTE_SIZE_SEGMENT_IDENTIFIER ((size_t)6)    /*!< @brief セグメント索引に保持する APP1 / APP5 識別子のバイト数 */
+/* @} */
+
+/*!
+@struct JpegSegment
+@brief セグメント索引に登録された、1 つのマーカーセグメントの情報
+*/
+typedef struct
+{
+    unsigned short _marker;                                 /*!< @brief マーカーセグメント（判別不可能な位置やデータ終端の場合は 0xFFFF ） */
+    unsigned short _size;                                   /*!< @brief サイズ定義の値（サイズ定義を持たないセグメントは 0 ） */
+    unsigned long _offset;                                  /*!< @brief マーカーの位置（連続する FF は最後の FF の位置） */
+    unsigned long _nextOffset;                              /*!< @brief 次のセグメントの走査開始位置 */
+    unsigned char _identifier[BYTE_SIZE_SEGMENT_IDENTIFIER]; /*!< @brief APP1 / APP5 セグメントの識別子（データ終端を超える部分と、その他のセグメントは 0 ） */
+} JpegSegment;
+
+/*!
+@struct JpegSegmentIndex
+@brief JPEG 画像の SOI の次から SOS （または走査を続けられなくなる位置）までのセグメント索引
+@details 先頭から 1 回だけ走査して作成し、各セグメントの解析処理はデータを走査し直さずにこの索引を参照する。
+最後のセグメントは SOS 、 EOI 、判別不可能なセグメント、またはデータ長を超えるセグメントのいずれかとなる。
+*/
+typedef struct
+{
+    JpegSegment *_segments;         /*!< @brief セグメントの配列（出現順） */
+    size_t _count;                  /*!< @brief 登録されたセグメントの数 */
+    size_t _capacity;               /*!< @brief _segments に確保している要素数 */
+    unsigned long _startOffset;     /*!< @brief SOI の次の走査開始位置 */
+    Arena *_arena;                  /*!< @brief _segments の割り当て元のアリーナ（ヒープから確保した場合は NULL） */
+} JpegSegmentIndex;
+
 /*!
 @brief Exif ファイルに格納されている画像開始位置マーカーの存在確認とその開始位置を取得する。
 @param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
@@ -148,34 +181,102 @@ unsigned short getMarkerSegment(JpegBuffer *src, unsigned long *seek);
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_IDENTIFIER 取得した識別子と引数の識別子が別だった場合
-@retval OTHER_ERROR メモリ確保に失敗した場合
 */
 int checkIdentifier(const char *identifier, JpegBuffer *src, unsigned long *startIndex, size_t size);
 
 /*!
 @brief メタデータに対し、指定位置から終端文字までのテキストを走査し、取得する。
-@param [in] src 対象となるバイト配列構造体
-@param [out] text 取得するテキスト（終端文字を含む）
+@param [in] src 対象となるバイト配列の参照
+@param [out] text 取得したテキストの参照（src の該当範囲を指し、終端文字は長さに含まない）
 @param [in, out] seek 走査開始位置。走査したバイト数だけ呼び出し元の数値も加算される
-@param maxByteSize 最大走査数
 @retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_PARAMETER 最大走査数が 0 の場合
-@retval INCORRECT_TEXT 最大文字数まで終端文字が見つからなかった場合
+@retval INCORRECT_TEXT 参照の終端まで終端文字が見つからなかった場合
+*/
+int getByteText(const ByteView *src, ByteView *text, unsigned long *seek);
+
+/*!
+@brief JPEG 画像を先頭から 1 回走査し、セグメント索引を作成する。
+@details 作成した索引は releaseSegmentIndex で解放すること（失敗した場合も呼び出してよい）。
+arena を指定した場合、索引の領域はアリーナから割り当てられ、アリーナの解放までに限り有効となる。
+@param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [out] index 作成したセグメント索引
+@param [in, out] arena 索引の領域の割り当て元となるアリーナ。ヒープから確保する場合は NULL
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER いずれかの引数の参照先が NULL の場合
+@retval INCORRECT_EXIF_FORMAT 先頭に SOI マーカーが見つからなかった場合
+@retval OTHER_ERROR メモリ確保に失敗した場合
 */
-int getByteText(HashBuffer *src, unsigned char *text, unsigned long *seek, size_t maxByteSize);
+int buildSegmentIndex(JpegBuffer *src, JpegSegmentIndex *index, Arena *arena);
+
+/*!
+@brief セグメント索引が確保した領域を解放する。
+@details アリーナから割り当てた索引の領域は、アリーナの解放時にまとめて解放される。
+@param [in, out] index 解放対象のセグメント索引
+*/
+void releaseSegmentIndex(JpegSegmentIndex *index);
+
+/*!
+@brief 走査位置から走査を始めた場合に、最初に取得されるセグメントの索引内の位置を返す。
+@param [in] index セグメント索引
+@param seek 走査位置（SOI の次、またはいずれかのセグメントの次の走査開始位置）
+@return 索引内の位置（該当するセグメントがない場合は index->_count ）
+*/
+size_t findSegmentPosition(const JpegSegmentIndex *index, unsigned long seek);
+
+/*!
+@brief セグメント索引に保持した識別子が、指定した識別子と等しいか調べる。
+@details checkIdentifier と同じ戻り値を返す。
+@param [in] identifier 比較対象の文字列
+@param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] segment 対象のセグメント
+@param size 比較するバイト数
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval INCORRECT_IDENTIFIER 取得した識別子と引数の識別子が別だった場合
+@retval OTHER_ERROR メモリ確保に失敗した場合
+*/
+int checkSegmentIdentifier(const char *identifier, JpegBuffer *src, const JpegSegment *segment, size_t size);
+
+/*!
+@brief ハッシュ値計算に用いる圧縮データの開始位置（SOS セグメント）を取得する。
+@details SOS セグメントより前の範囲しか参照しないため、ファイルの先頭部分のみを読み込んだ状態でも呼び出せる。
+@param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] retStartIndex 取得する圧縮データ開始位置
+@param ignoreApp5Flag JACIC_BOOL_TRUE のとき、 APP5 領域を発見した際にエラーを返す
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
+@retval APP5_ALREADY_EXISTS ignoreApp5Flag が JACIC_BOOL_TRUE であり、APP5 領域が既に存在する場合
+*/
+int findCompressedImageStart(JpegBuffer *src, const JpegSegmentIndex *index, unsigned long *retStartIndex, JACIC_BOOL ignoreApp5Flag);
 
 /*!
 @brief ハッシュ値計算に必要となる『画像の圧縮データのバイナリ』を取得する。
 @details 対象となる範囲は、SOS ～ EOI の間（ SOS と EOI 自身を含む）。 EOI 移行の冗長なデータは無効なものとして無視する。
+取得したバイト配列は src の該当範囲を直接参照するため、src を解放するまでの間だけ使用できる。
 @param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
-@param [out] retImgBin 画像から抽出した『圧縮データ開始位置以降』のバイト配列のポインタ
+@param [in] index src から作成したセグメント索引
+@param [out] retImgView 画像の『圧縮データ開始位置以降』を参照するバイト配列
 @param ignoreApp5Flag JACIC_BOOL_TRUE のとき、 APP5 領域を発見した際にエラーを返す
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP5_ALREADY_EXISTS ignoreApp5Flag が真であり、APP5 領域が既に存在する場合
-@retval OTHER_ERROR メモリの確保に失敗した場合
 */
-int clipCompressedImage(JpegBuffer *src, HashBuffer **retImgBin, JACIC_BOOL ignoreApp5Flag);
+int clipCompressedImage(JpegBuffer *src, const JpegSegmentIndex *index, ByteView *retImgView, JACIC_BOOL ignoreApp5Flag);
+
+/*!
+@brief セグメント索引に登録された SOF セグメントから、画像の幅と高さを取得する。
+@details SOS セグメントより前の範囲しか参照しないため、ファイルの先頭部分のみを読み込んだ状態でも呼び出せる。
+@param [in] src JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] width 画像の幅（ピクセル数）
+@param [out] height 画像の高さ（ピクセル数）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval INCORRECT_EXIF_FORMAT SOF セグメントが見つからない、または幅と高さが定義されていない場合
+*/
+int getImageSize(JpegBuffer *src, const JpegSegmentIndex *index, unsigned short *width, unsigned short *height);
 
 #endif /* EXIF_H_ */
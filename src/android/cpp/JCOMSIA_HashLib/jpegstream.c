@@ -0,0 +1,285 @@
+﻿/*!
+@file jpegstream.c
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief JPEG 画像の逐次ハッシュ計算
+@details Base64 デコードしながら受け取る SVG 内の画像など、画像全体をメモリ上に展開せずにハッシュ値を計算する。
+SOS セグメントを探す処理と EOI を探す処理は、_readFileWithImageHash で読み込みと並行して計算する場合と同じ範囲を対象とする。
+*/
+
+#include <string.h>
+
+#include "exif.h"
+#include "jpegstream.h"
+
+#define BYTE_SIZE_STREAM_HEAD_INITIAL ((size_t)(64 * 1024))  /*!< @brief 先頭部分を保持する領域の初期のバイト数 */
+
+/*!
+@brief 先頭部分を保持する領域を、length バイトを追加できる大きさまで拡張する。
+@param [in, out] stream 逐次処理のコンテキスト
+@param length 追加するバイト数
+@retval FUNCTION_SUCCESS 正常終了
+@retval OTHER_ERROR BYTE_SIZE_STREAM_HEAD_MAX を超える場合、メモリ確保に失敗した場合
+*/
+static int _reserveHead(JpegStream *stream, size_t length)
+{
+    size_t used = (stream->_head != NULL) ? stream->_head->_len : 0;
+    size_t capacity = stream->_headCapacity;
+    JpegBuffer *head;
+
+    if(BYTE_SIZE_STREAM_HEAD_MAX - used < length) return OTHER_ERROR;
+    if(used + length <= capacity) return FUNCTION_SUCCESS;
+
+    if(capacity == 0) capacity = BYTE_SIZE_STREAM_HEAD_INITIAL;
+    while(capacity < used + length) capacity *= 2;
+    if(BYTE_SIZE_STREAM_HEAD_MAX < capacity) capacity = BYTE_SIZE_STREAM_HEAD_MAX;
+
+    head = allocateBinaryDataUninitialized(capacity);
+    if(head == NULL) return OTHER_ERROR;
+
+    head->_len = used;
+    if(stream->_head != NULL)
+    {
+        memcpy(head->_buff, stream->_head->_buff, used);
+        _SECURE_RELEASE(stream->_head);
+    }
+
+    stream->_head = head;
+    stream->_headCapacity = capacity;
+
+    return FUNCTION_SUCCESS;
+}
+
+/*!
+@brief 先頭部分のうち length バイトまでの範囲から、圧縮データの開始位置 (SOS) を探す。
+@param [in] head 先頭部分
+@param length 探す範囲のバイト数
+@param [out] startIndex 見つかった SOS セグメントの位置
+@return findCompressedImageStart の戻り値
+*/
+static int _findScanStart(JpegBuffer *head, size_t length, unsigned long *startIndex)
+{
+    int ret;
+    size_t headLength = head->_len;
+    JpegSegmentIndex index;
+    Arena arena;
+    unsigned char arenaBuff[BYTE_SIZE_ARENA_BLOCK];
+
+    arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+
+    head->_len = length;
+    ret = buildSegmentIndex(head, &index, &arena);
+    if(ret == FUNCTION_SUCCESS)
+    {
+        ret = findCompressedImageStart(head, &index, startIndex, JACIC_BOOL_FALSE);
+    }
+    releaseSegmentIndex(&index);
+    arenaRelease(&arena);
+    head->_len = headLength;
+
+    return ret;
+}
+
+/*!
+@brief 圧縮データの続きを受け取り、EOI マーカーまでをハッシュ値の計算に使用する。
+@details EOI マーカーを見つけた場合は、EOI マーカー自身までを含めて計算を終える。
+@param [in, out] stream 圧縮データを受け取っているコンテキスト
+@param [in] data 受け取るバイト列
+@param length data の長さ
+*/
+static void _hashScanData(JpegStream *stream, const unsigned char *data, size_t length)
+{
+    size_t scan = 0;
+    size_t end = 0;
+
+    if(length == 0) return;
+
+    if(stream->_prefixPending == JACIC_BOOL_TRUE && data[0] == 0xD9)
+    {
+        /* 前回受け取った最後のバイトと合わせて EOI マーカーになる */
+        end = 1;
+    }
+    else
+    {
+        while(scan + 1 < length)
+        {
+            scan += findMarkerPrefix(&data[scan], length - 1 - scan);
+            if(length <= scan + 1) break;
+
+            if(data[scan + 1] == 0xD9)
+            {
+                end = scan + BYTE_SIZE_SEGMENT_MARKER;
+                break;
+            }
+
+            scan++;
+        }
+    }
+
+    if(end != 0)
+    {
+        sha256Update(&stream->_context, data, end);
+        sha256FinalDigest(&stream->_context, stream->_prehashed._digest);
+
+        stream->_prehashed._hashed = JACIC_BOOL_TRUE;
+        stream->_prehashed._result = FUNCTION_SUCCESS;
+        stream->_state = JPEG_STREAM_DONE;
+        return;
+    }
+
+    sha256Update(&stream->_context, data, length);
+    stream->_prefixPending = (data[length - 1] == 0xFF) ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+}
+
+/*!
+@brief 先頭部分から SOS セグメントが見つかった場合に、圧縮データの受け取りを始める。
+@details 先頭部分のうち SOS マーカーより後に受け取っていたバイト列は、ハッシュ値の計算に使用して先頭部分から取り除く。
+@param [in, out] stream 先頭部分を受け取っているコンテキスト
+@param startIndex SOS セグメントの位置
+*/
+static void _startScan(JpegStream *stream, unsigned long startIndex)
+{
+    JpegBuffer *head = stream->_head;
+    size_t scanStart = startIndex + BYTE_SIZE_SEGMENT_MARKER;
+    size_t headLength = head->_len;
+
+    sha256Init(&stream->_context);
+    sha256Update(&stream->_context, &(head->_buff[startIndex]), BYTE_SIZE_SEGMENT_MARKER);
+
+    stream->_state = JPEG_STREAM_SCAN;
+    stream->_prefixPending = JACIC_BOOL_FALSE;
+
+    /* 検証時にセグメント索引から SOS を見つけられるよう、SOS マーカーまでを先頭部分として残す */
+    head->_len = scanStart;
+    _hashScanData(stream, &(head->_buff[scanStart]), headLength - scanStart);
+}
+
+void jpegStreamInit(JpegStream *stream)
+{
+    if(stream == NULL) return;
+
+    stream->_state = JPEG_STREAM_HEAD;
+    stream->_head = NULL;
+    stream->_headCapacity = 0;
+    stream->_prefixPending = JACIC_BOOL_FALSE;
+    stream->_prehashed._hashed = JACIC_BOOL_FALSE;
+    stream->_prehashed._result = FUNCTION_SUCCESS;
+}
+
+int jpegStreamWrite(JpegStream *stream, const unsigned char *data, size_t length)
+{
+    int ret;
+    size_t available;
+    unsigned long startIndex = 0UL;
+
+    if(stream == NULL || (data == NULL && length != 0))
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    switch(stream->_state)
+    {
+        case JPEG_STREAM_SCAN:
+            _hashScanData(stream, data, length);
+            return FUNCTION_SUCCESS;
+
+        case JPEG_STREAM_DONE:
+            /* EOI より後の冗長なデータは無効なものとして無視する */
+            return FUNCTION_SUCCESS;
+
+        case JPEG_STREAM_FAILED:
+            return OTHER_ERROR;
+
+        case JPEG_STREAM_HEAD:
+        default:
+            break;
+    }
+
+    if(length == 0) return FUNCTION_SUCCESS;
+
+    if(_reserveHead(stream, length) != FUNCTION_SUCCESS)
+    {
+        stream->_state = JPEG_STREAM_FAILED;
+        return OTHER_ERROR;
+    }
+
+    memcpy(&(stream->_head->_buff[stream->_head->_len]), data, length);
+    stream->_head->_len += length;
+
+    /* 続きを受け取っていない領域を参照しないよう、セグメントサイズ分を除いた長さで探す */
+    available = stream->_head->_len;
+    if(available <= BYTE_SIZE_SEGMENT_SIZE) return FUNCTION_SUCCESS;
+
+    ret = _findScanStart(stream->_head, available - BYTE_SIZE_SEGMENT_SIZE, &startIndex);
+    if(ret == FUNCTION_SUCCESS)
+    {
+        _startScan(stream, startIndex);
+    }
+
+    return FUNCTION_SUCCESS;
+}
+
+int jpegStreamFinish(JpegStream *stream, JpegBuffer **head, PrehashedImage *prehashed)
+{
+    int ret;
+    unsigned long startIndex = 0UL;
+
+    if(stream == NULL || head == NULL || prehashed == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    if(stream->_state == JPEG_STREAM_FAILED)
+    {
+        return OTHER_ERROR;
+    }
+
+    if(stream->_head == NULL)
+    {
+        /* 何も受け取っていない場合は、長さ 0 の先頭部分を返す */
+        if(_reserveHead(stream, 1) != FUNCTION_SUCCESS)
+        {
+            return OTHER_ERROR;
+        }
+    }
+
+    if(stream->_state == JPEG_STREAM_HEAD)
+    {
+        /* すべて受け取ったので、先頭部分全体から探す */
+        ret = _findScanStart(stream->_head, stream->_head->_len, &startIndex);
+        if(ret == FUNCTION_SUCCESS)
+        {
+            _startScan(stream, startIndex);
+        }
+        else
+        {
+            stream->_prehashed._hashed = JACIC_BOOL_TRUE;
+            stream->_prehashed._result = ret;
+        }
+    }
+
+    if(stream->_state == JPEG_STREAM_SCAN)
+    {
+        /* 最後まで EOI が見つからない */
+        stream->_prehashed._hashed = JACIC_BOOL_TRUE;
+        stream->_prehashed._result = INCORRECT_EXIF_FORMAT;
+    }
+
+    *head = stream->_head;
+    *prehashed = stream->_prehashed;
+
+    stream->_head = NULL;
+    stream->_headCapacity = 0;
+    stream->_state = JPEG_STREAM_DONE;
+
+    return FUNCTION_SUCCESS;
+}
+
+void jpegStreamRelease(JpegStream *stream)
+{
+    if(stream == NULL) return;
+
+    _SECURE_RELEASE(stream->_head);
+    stream->_headCapacity = 0;
+}
@@ -0,0 +1,92 @@
+﻿/*!
+@file jpegstream.h
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief JPEG 画像の逐次ハッシュ計算用ヘッダ
+*/
+
+#ifndef JPEGSTREAM_H_
+#define JPEGSTREAM_H_
+
+#include "common.h"
+#include "sha256.h"
+
+#define BYTE_SIZE_STREAM_HEAD_MAX ((size_t)(512 * 1024))  /*!< @brief 先頭部分（ SOI ～ SOS ）として保持する最大のバイト数 */
+
+/*!
+@struct PrehashedImage
+@brief ファイルの読み込みと並行して計算した画像ハッシュ値
+*/
+typedef struct
+{
+    JACIC_BOOL _hashed;                             /*!< @brief 画像ハッシュ値の計算を終えているか */
+    int _result;                                    /*!< @brief 圧縮データの切り出し結果（clipCompressedImage の戻り値と同じ値） */
+    unsigned char _digest[BYTE_SIZE_HASH_DIGEST];   /*!< @brief 画像ハッシュ値 */
+} PrehashedImage;
+
+/*!
+@enum JpegStreamState
+@brief 逐次処理中の JPEG 画像のどの部分を受け取っているかを示す。
+*/
+typedef enum
+{
+    JPEG_STREAM_HEAD,       /*!< @brief SOS セグメントより前の部分（先頭部分として保持する） */
+    JPEG_STREAM_SCAN,       /*!< @brief 圧縮データ（ハッシュ値を計算して破棄する） */
+    JPEG_STREAM_DONE,       /*!< @brief EOI より後の部分（無視する） */
+    JPEG_STREAM_FAILED      /*!< @brief 先頭部分が BYTE_SIZE_STREAM_HEAD_MAX を超えた、またはメモリ確保に失敗した */
+} JpegStreamState;
+
+/*!
+@struct JpegStream
+@brief JPEG 画像のバイト列を先頭から順に受け取り、画像全体を保持せずに画像ハッシュ値を計算するためのコンテキスト
+@details 先頭部分 (SOI ～ SOS マーカー) のみを保持し、圧縮データ (SOS ～ EOI) はハッシュ値の計算に使用して破棄する。
+保持した先頭部分は、計算した画像ハッシュ値とともに _validateImage などの検証処理に渡すことができる。
+*/
+typedef struct
+{
+    JpegStreamState _state;     /*!< @brief 受け取っている部分 */
+    JpegBuffer *_head;          /*!< @brief 先頭部分（ _len は格納済みのバイト数） */
+    size_t _headCapacity;       /*!< @brief _head に格納できるバイト数 */
+    SHA256Context _context;     /*!< @brief 計算中の画像ハッシュ値 */
+    JACIC_BOOL _prefixPending;  /*!< @brief 直前に受け取ったバイトが 0xFF であり、次のバイト次第で EOI となるか */
+    PrehashedImage _prehashed;  /*!< @brief 計算した画像ハッシュ値 */
+} JpegStream;
+
+/*!
+@brief 逐次処理のコンテキストを初期化する。
+@param [out] stream 初期化対象のコンテキスト
+*/
+void jpegStreamInit(JpegStream *stream);
+
+/*!
+@brief JPEG 画像の続きのバイト列を受け取る。
+@details 先頭部分を受け取っている間は SOS セグメントを探し、見つかった以降は EOI までをハッシュ値の計算に使用する。
+@param [in, out] stream jpegStreamInit で初期化済みのコンテキスト
+@param [in] data 受け取るバイト列
+@param length data の長さ
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval OTHER_ERROR 先頭部分が BYTE_SIZE_STREAM_HEAD_MAX を超えた場合、メモリ確保に失敗した場合
+*/
+int jpegStreamWrite(JpegStream *stream, const unsigned char *data, size_t length);
+
+/*!
+@brief すべてのバイト列を受け取った後に呼び出し、先頭部分と画像ハッシュ値を取得する。
+@details 圧縮データの範囲を特定できなかった場合も、clipCompressedImage と同じ戻り値を prehashed に設定して正常終了する。
+@param [in, out] stream jpegStreamWrite ですべてのバイト列を渡したコンテキスト
+@param [out] head 先頭部分。使い終わったら _SECURE_RELEASE で解放すること。
+@param [out] prehashed 計算した画像ハッシュ値
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval OTHER_ERROR jpegStreamWrite が失敗していた場合
+*/
+int jpegStreamFinish(JpegStream *stream, JpegBuffer **head, PrehashedImage *prehashed);
+
+/*!
+@brief 逐次処理のコンテキストが確保している領域を解放する。
+@param [in, out] stream 解放対象のコンテキスト
+*/
+void jpegStreamRelease(JpegStream *stream);
+
+#endif /* JPEGSTREAM_H_ */
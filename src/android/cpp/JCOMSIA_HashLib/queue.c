@@ -0,0 +1,495 @@
+﻿/*!
+@file queue.c
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief 非同期処理用の処理キュー
+@details 登録された処理を上限付きのリングバッファに積み、ライブラリが作成したスレッドで先頭から順に実行する。
+処理待ちが上限に達した場合は、設定に応じて登録側を待たせるか失敗させ、処理が溜まり続けないようにする。
+fork した子プロセスにはスレッドが複製されないため、子プロセスでは処理キューを開始していない状態に戻し、最初の登録で開始し直す。
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "queue.h"
+
+#if !defined(_MSC_VER) && !defined(JCOMSIA_DISABLE_WORK_QUEUE)
+#include <pthread.h>
+#include <unistd.h>
+#define WORK_QUEUE                  /*!< @brief スレッドで処理を実行する */
+#endif
+
+#if defined(WORK_QUEUE)
+
+/*!
+@struct WorkItem
+@brief 処理待ちの処理
+*/
+typedef struct
+{
+    WorkFunction _run;          /*!< @brief 処理を実行する関数 */
+    WorkFunction _cancel;       /*!< @brief 処理が取り消された場合に呼び出す関数 */
+    void *_work;                /*!< @brief _run, _cancel に渡す値 */
+    unsigned long _id;          /*!< @brief 識別番号 */
+} WorkItem;
+
+/*!
+@struct WorkQueue
+@brief 処理キューの状態（ workQueueMutex で保護する）
+*/
+typedef struct
+{
+    WorkItem *_items;                               /*!< @brief 処理待ちのリングバッファ（ malloc で確保する） */
+    size_t _capacity;                               /*!< @brief _items の要素数 */
+    size_t _head;                                   /*!< @brief 次に実行する処理の位置 */
+    size_t _count;                                  /*!< @brief 処理待ちの数 */
+    size_t _running;                                /*!< @brief 実行中の処理の数 */
+    unsigned long _nextId;                          /*!< @brief 最後に割り当てた識別番号 */
+    JACIC_BOOL _blocking;                           /*!< @brief 処理待ちが上限に達した場合に登録を待たせるか */
+    JACIC_BOOL _started;                            /*!< @brief 開始しているか */
+    JACIC_BOOL _stopping;                           /*!< @brief 停止処理中か */
+    pthread_t _threads[WORK_QUEUE_THREAD_MAX];      /*!< @brief 処理を実行するスレッド */
+    size_t _threadCount;                            /*!< @brief _threads のうち作成したスレッドの数 */
+} WorkQueue;
+
+/*!
+@brief ライブラリ内で共有する処理キュー
+*/
+static WorkQueue workQueue;
+
+/*!
+@brief workQueue を保護するミューテックス
+*/
+static pthread_mutex_t workQueueMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*!
+@brief 処理待ちが追加されたことを通知する条件変数
+*/
+static pthread_cond_t workQueueNotEmpty = PTHREAD_COND_INITIALIZER;
+
+/*!
+@brief 処理待ちに空きができたことを通知する条件変数
+*/
+static pthread_cond_t workQueueNotFull = PTHREAD_COND_INITIALIZER;
+
+/*!
+@brief 全ての処理が終わったことを通知する条件変数
+*/
+static pthread_cond_t workQueueIdle = PTHREAD_COND_INITIALIZER;
+
+/*!
+@brief fork 時の処理の登録を 1 回だけ行うための制御変数
+*/
+static pthread_once_t workQueueOnce = PTHREAD_ONCE_INIT;
+
+/*!
+@brief fork 時の処理を登録できたか（ workQueueOnce の後は変更しない）
+*/
+static JACIC_BOOL workQueueForkHandled = JACIC_BOOL_FALSE;
+
+/*!
+@brief 処理待ちがなくなるか停止処理が始まるまで、先頭から順に処理を実行する。
+@param [in] arg 使用しない
+@return 常に NULL
+*/
+static void *_runWorkQueue(void *arg)
+{
+    WorkItem item;
+
+    (void) arg;
+
+    pthread_mutex_lock(&workQueueMutex);
+    for(;;)
+    {
+        while(workQueue._count == 0 && !workQueue._stopping)
+        {
+            pthread_cond_wait(&workQueueNotEmpty, &workQueueMutex);
+        }
+
+        /* 停止処理中でも、取り消されなかった処理待ちは全て実行する */
+        if(workQueue._count == 0) break;
+
+        item = workQueue._items[workQueue._head];
+        workQueue._head = (workQueue._head + 1) % workQueue._capacity;
+        workQueue._count--;
+        workQueue._running++;
+        pthread_cond_signal(&workQueueNotFull);
+
+        pthread_mutex_unlock(&workQueueMutex);
+        item._run(item._work);
+        pthread_mutex_lock(&workQueueMutex);
+
+        workQueue._running--;
+        if(workQueue._count == 0 && workQueue._running == 0)
+        {
+            pthread_cond_broadcast(&workQueueIdle);
+        }
+    }
+    pthread_mutex_unlock(&workQueueMutex);
+
+    return NULL;
+}
+
+/*!
+@brief fork の前に workQueueMutex を取得し、子プロセスに複製される workQueue の状態を確定させる。
+*/
+static void _prepareForkWorkQueue(void)
+{
+    pthread_mutex_lock(&workQueueMutex);
+}
+
+/*!
+@brief fork の後、親プロセスで workQueueMutex を解放する。
+*/
+static void _resumeWorkQueueInParent(void)
+{
+    pthread_mutex_unlock(&workQueueMutex);
+}
+
+/*!
+@brief fork の後、子プロセスで workQueue を開始していない状態に戻す。
+@details 子プロセスには fork を呼び出したスレッドのみが複製され、処理を実行するスレッドは存在しないため、
+次の登録で開始し直す。親プロセスの処理待ち・実行中の処理は子プロセスでは実行も取り消しも行わない。
+条件変数は待機中だったスレッドの状態を含む可能性があるため初期化し直す。
+*/
+static void _resetWorkQueueInChild(void)
+{
+    free(workQueue._items);
+    workQueue._items = NULL;
+    workQueue._capacity = 0;
+    workQueue._head = 0;
+    workQueue._count = 0;
+    workQueue._running = 0;
+    workQueue._threadCount = 0;
+    workQueue._started = JACIC_BOOL_FALSE;
+    workQueue._stopping = JACIC_BOOL_FALSE;
+
+    pthread_cond_init(&workQueueNotEmpty, NULL);
+    pthread_cond_init(&workQueueNotFull, NULL);
+    pthread_cond_init(&workQueueIdle, NULL);
+
+    pthread_mutex_unlock(&workQueueMutex);
+}
+
+/*!
+@brief fork 時の処理を登録する（ workQueueOnce で 1 回だけ呼び出す）。
+*/
+static void _initWorkQueue(void)
+{
+    if(pthread_atfork(_prepareForkWorkQueue, _resumeWorkQueueInParent, _resetWorkQueueInChild) != 0) return;
+
+    workQueueForkHandled = JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 処理キューを開始する（ workQueueMutex を取得した状態で呼び出す）。
+@param threadCount 処理を実行するスレッド数。0 の場合は利用可能な CPU 数
+@param capacity 処理待ちにできる処理の数。0 の場合は WORK_QUEUE_DEFAULT_CAPACITY
+@param blocking 処理待ちが上限に達している場合に、登録を待たせるか
+@retval FUNCTION_SUCCESS 正常終了（既に開始している場合を含む）
+@retval QUEUE_STOPPED 停止処理中の場合
+@retval OTHER_ERROR メモリ確保やスレッドの作成、 fork 時の処理の登録に失敗した場合
+*/
+static int _startWorkQueueLocked(size_t threadCount, size_t capacity, JACIC_BOOL blocking)
+{
+    long processors;
+
+    if(workQueue._stopping) return QUEUE_STOPPED;
+    if(workQueue._started) return FUNCTION_SUCCESS;
+
+    /* 子プロセスで開始し直せない場合は、スレッドを作成しない */
+    if(pthread_once(&workQueueOnce, _initWorkQueue) != 0 || workQueueForkHandled == JACIC_BOOL_FALSE) return OTHER_ERROR;
+
+    if(threadCount == 0)
+    {
+        processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = processors > 0 ? (size_t) processors : 1;
+    }
+    if(WORK_QUEUE_THREAD_MAX < threadCount) threadCount = WORK_QUEUE_THREAD_MAX;
+
+    if(capacity == 0) capacity = WORK_QUEUE_DEFAULT_CAPACITY;
+    if(SIZE_MAX / sizeof(WorkItem) < capacity) return OTHER_ERROR;
+
+    /*
+     ライブラリ内部の管理領域であり、停止するまで保持するため、 allocateMemory では確保しない
+     （確保中の領域として数えると、処理が全て終わっていても JCOMSIA_SetAllocator で差し替えられなくなる）
+     */
+    workQueue._items = (WorkItem *) malloc(capacity * sizeof(WorkItem));
+    if(workQueue._items == NULL) return OTHER_ERROR;
+
+    workQueue._capacity = capacity;
+    workQueue._head = 0;
+    workQueue._count = 0;
+    workQueue._running = 0;
+    workQueue._blocking = blocking;
+
+    for(workQueue._threadCount = 0; workQueue._threadCount < threadCount; workQueue._threadCount++)
+    {
+        if(pthread_create(&workQueue._threads[workQueue._threadCount], NULL, _runWorkQueue, NULL) != 0)
+        {
+            /* 作成できたスレッドのみで処理する */
+            break;
+        }
+    }
+
+    if(workQueue._threadCount == 0)
+    {
+        free(workQueue._items);
+        workQueue._items = NULL;
+        return OTHER_ERROR;
+    }
+
+    workQueue._started = JACIC_BOOL_TRUE;
+
+    return FUNCTION_SUCCESS;
+}
+
+#endif /* WORK_QUEUE */
+
+/*!
+@brief 処理キューを開始する。
+@details ライブラリ内で 1 つの処理キューを共有する。既に開始している場合は何もしない。
+@param threadCount 処理を実行するスレッド数。0 の場合は利用可能な CPU 数
+@param capacity 処理待ちにできる処理の数。0 の場合は WORK_QUEUE_DEFAULT_CAPACITY
+@param blocking 処理待ちが上限に達している場合に、登録を待たせる（ JACIC_BOOL_TRUE ）か失敗させる（ JACIC_BOOL_FALSE ）か
+@retval FUNCTION_SUCCESS 正常終了（既に開始している場合を含む）
+@retval QUEUE_STOPPED 停止処理中の場合
+@retval OTHER_ERROR メモリ確保やスレッドの作成に失敗した場合、またはスレッドを使用できない環境の場合
+*/
+int startWorkQueue(size_t threadCount, size_t capacity, JACIC_BOOL blocking)
+{
+#if defined(WORK_QUEUE)
+    int ret;
+
+    pthread_mutex_lock(&workQueueMutex);
+    ret = _startWorkQueueLocked(threadCount, capacity, blocking);
+    pthread_mutex_unlock(&workQueueMutex);
+
+    return ret;
+#else
+    (void) threadCount;
+    (void) capacity;
+    (void) blocking;
+
+    return OTHER_ERROR;
+#endif
+}
+
+/*!
+@brief 処理キューに処理を登録する。
+@details 処理キューを開始していない場合は既定の設定で開始する。
+登録した処理は、いずれかのスレッドで run(work) として実行されるか、取り消された場合に cancel(work) が呼び出される。
+スレッドを使用できない環境では、登録せずにこの関数を呼び出したスレッドで run(work) を実行する。
+@param run 処理を実行する関数
+@param cancel 処理が取り消された場合に呼び出す関数
+@param [in] work run, cancel に渡す値
+@param [out] workId 登録した処理の識別番号（ cancelWork に使用する）。不要な場合は NULL
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval QUEUE_FULL 処理待ちが上限に達していて、待たせない設定の場合
+@retval QUEUE_STOPPED 停止処理中の場合
+@retval OTHER_ERROR 処理キューを開始できなかった場合
+*/
+int submitWork(WorkFunction run, WorkFunction cancel, void *work, unsigned long *workId)
+{
+#if defined(WORK_QUEUE)
+    int ret;
+    WorkItem *item;
+
+    if(run == NULL || cancel == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    pthread_mutex_lock(&workQueueMutex);
+
+    ret = _startWorkQueueLocked(0, 0, JACIC_BOOL_TRUE);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    /* 処理待ちに空きができるまで待つ（待たせない設定の場合は失敗させる） */
+    while(workQueue._count == workQueue._capacity && !workQueue._stopping)
+    {
+        if(!workQueue._blocking)
+        {
+            ret = QUEUE_FULL;
+            goto FINALIZE;
+        }
+
+        pthread_cond_wait(&workQueueNotFull, &workQueueMutex);
+    }
+
+    if(workQueue._stopping)
+    {
+        ret = QUEUE_STOPPED;
+        goto FINALIZE;
+    }
+
+    /* 0 は識別番号として使用しない */
+    if(++workQueue._nextId == 0) ++workQueue._nextId;
+
+    item = &workQueue._items[(workQueue._head + workQueue._count) % workQueue._capacity];
+    item->_run = run;
+    item->_cancel = cancel;
+    item->_work = work;
+    item->_id = workQueue._nextId;
+    workQueue._count++;
+
+    if(workId != NULL) *workId = item->_id;
+
+    pthread_cond_signal(&workQueueNotEmpty);
+
+FINALIZE:
+    pthread_mutex_unlock(&workQueueMutex);
+
+    return ret;
+#else
+    if(run == NULL || cancel == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    if(workId != NULL) *workId = 0;
+
+    run(work);
+
+    return FUNCTION_SUCCESS;
+#endif
+}
+
+/*!
+@brief 処理待ちの処理を取り消す。
+@details 取り消した処理の cancel は、この関数を呼び出したスレッドで呼び出される。
+@param workId submitWork で取得した識別番号
+@retval FUNCTION_SUCCESS 取り消した
+@retval JOB_NOT_FOUND 処理待ちの中に見つからない（実行中・実行済みの場合を含む）
+*/
+int cancelWork(unsigned long workId)
+{
+#if defined(WORK_QUEUE)
+    WorkItem item;
+    size_t i;
+    size_t position;
+    size_t nextPosition;
+    JACIC_BOOL found = JACIC_BOOL_FALSE;
+
+    if(workId == 0) return JOB_NOT_FOUND;
+
+    pthread_mutex_lock(&workQueueMutex);
+
+    for(i = 0; workQueue._started && i < workQueue._count; i++)
+    {
+        position = (workQueue._head + i) % workQueue._capacity;
+        if(workQueue._items[position]._id != workId) continue;
+
+        item = workQueue._items[position];
+        found = JACIC_BOOL_TRUE;
+
+        /* 後ろの処理待ちを 1 つずつ詰め、実行順を保つ */
+        for(; i + 1 < workQueue._count; i++)
+        {
+            nextPosition = (position + 1) % workQueue._capacity;
+            workQueue._items[position] = workQueue._items[nextPosition];
+            position = nextPosition;
+        }
+
+        workQueue._count--;
+        pthread_cond_signal(&workQueueNotFull);
+        if(workQueue._count == 0 && workQueue._running == 0)
+        {
+            pthread_cond_broadcast(&workQueueIdle);
+        }
+        break;
+    }
+
+    pthread_mutex_unlock(&workQueueMutex);
+
+    if(!found) return JOB_NOT_FOUND;
+
+    item._cancel(item._work);
+
+    return FUNCTION_SUCCESS;
+#else
+    (void) workId;
+
+    return JOB_NOT_FOUND;
+#endif
+}
+
+/*!
+@brief 登録済みの処理が全て終わるまで待つ。
+@attention 登録した処理の中から呼び出さないこと。
+*/
+void drainWorkQueue(void)
+{
+#if defined(WORK_QUEUE)
+    pthread_mutex_lock(&workQueueMutex);
+    while(workQueue._count != 0 || workQueue._running != 0)
+    {
+        pthread_cond_wait(&workQueueIdle, &workQueueMutex);
+    }
+    pthread_mutex_unlock(&workQueueMutex);
+#endif
+}
+
+/*!
+@brief 処理キューを停止し、スレッドを終了する。
+@details 停止処理中の登録は QUEUE_STOPPED で失敗する。停止後に登録した場合は再び開始する。
+@attention 登録した処理の中から呼び出さないこと。また、複数のスレッドから同時に呼び出さないこと。
+@param cancelPending 処理待ちの処理を取り消す（ JACIC_BOOL_TRUE ）か、全て実行してから停止する（ JACIC_BOOL_FALSE ）か
+*/
+void shutdownWorkQueue(JACIC_BOOL cancelPending)
+{
+#if defined(WORK_QUEUE)
+    WorkItem item;
+    size_t cancelHead = 0;
+    size_t cancelCount = 0;
+    size_t i;
+
+    pthread_mutex_lock(&workQueueMutex);
+    if(!workQueue._started || workQueue._stopping)
+    {
+        pthread_mutex_unlock(&workQueueMutex);
+        return;
+    }
+
+    workQueue._stopping = JACIC_BOOL_TRUE;
+    pthread_cond_broadcast(&workQueueNotEmpty);
+    pthread_cond_broadcast(&workQueueNotFull);
+
+    /* 処理待ちをまとめて取り出し、スレッドに実行させない（ _items はスレッドの終了後まで解放しない） */
+    if(cancelPending)
+    {
+        cancelHead = workQueue._head;
+        cancelCount = workQueue._count;
+        workQueue._head = (workQueue._head + workQueue._count) % workQueue._capacity;
+        workQueue._count = 0;
+    }
+    pthread_mutex_unlock(&workQueueMutex);
+
+    /* cancel はミューテックスを解放してから呼び出す */
+    for(i = 0; i < cancelCount; i++)
+    {
+        item = workQueue._items[(cancelHead + i) % workQueue._capacity];
+        item._cancel(item._work);
+    }
+
+    /* 実行中・残りの処理待ちを終えたスレッドから終了する */
+    for(i = 0; i < workQueue._threadCount; i++)
+    {
+        pthread_join(workQueue._threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&workQueueMutex);
+    free(workQueue._items);
+    workQueue._items = NULL;
+    workQueue._capacity = 0;
+    workQueue._threadCount = 0;
+    workQueue._started = JACIC_BOOL_FALSE;
+    workQueue._stopping = JACIC_BOOL_FALSE;
+    pthread_cond_broadcast(&workQueueIdle);
+    pthread_mutex_unlock(&workQueueMutex);
+#else
+    (void) cancelPending;
+#endif
+}
@@ -0,0 +1,74 @@
+﻿/*!
+@file queue.h
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief 非同期処理用の処理キューのヘッダ
+*/
+
+#ifndef QUEUE_H_
+#define QUEUE_H_
+
+#include "common.h"
+
+#define WORK_QUEUE_DEFAULT_CAPACITY ((size_t) 16)   /*!< @brief 処理待ちにできる処理の数の既定値 */
+#define WORK_QUEUE_THREAD_MAX       ((size_t) 64)   /*!< @brief 処理を実行するスレッド数の上限 */
+
+/*!
+@brief 処理キューに登録する処理の関数（実行時と取り消し時のそれぞれで、登録した work が渡される）
+*/
+typedef void (*WorkFunction)(void *work);
+
+/*!
+@brief 処理キューを開始する。
+@details ライブラリ内で 1 つの処理キューを共有する。既に開始している場合は何もしない。
+fork した子プロセスでは開始していない状態に戻る（親プロセスの処理待ちは実行も取り消しも行わない）。
+@param threadCount 処理を実行するスレッド数。0 の場合は利用可能な CPU 数
+@param capacity 処理待ちにできる処理の数。0 の場合は WORK_QUEUE_DEFAULT_CAPACITY
+@param blocking 処理待ちが上限に達している場合に、登録を待たせる（ JACIC_BOOL_TRUE ）か失敗させる（ JACIC_BOOL_FALSE ）か
+@retval FUNCTION_SUCCESS 正常終了（既に開始している場合を含む）
+@retval QUEUE_STOPPED 停止処理中の場合
+@retval OTHER_ERROR メモリ確保やスレッドの作成に失敗した場合、またはスレッドを使用できない環境の場合
+*/
+int startWorkQueue(size_t threadCount, size_t capacity, JACIC_BOOL blocking);
+
+/*!
+@brief 処理キューに処理を登録する。
+@details 処理キューを開始していない場合は既定の設定で開始する。
+登録した処理は、いずれかのスレッドで run(work) として実行されるか、取り消された場合に cancel(work) が呼び出される。
+@param run 処理を実行する関数
+@param cancel 処理が取り消された場合に呼び出す関数
+@param [in] work run, cancel に渡す値
+@param [out] workId 登録した処理の識別番号（ cancelWork に使用する）。不要な場合は NULL
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval QUEUE_FULL 処理待ちが上限に達していて、待たせない設定の場合
+@retval QUEUE_STOPPED 停止処理中の場合
+@retval OTHER_ERROR 処理キューを開始できなかった場合
+*/
+int submitWork(WorkFunction run, WorkFunction cancel, void *work, unsigned long *workId);
+
+/*!
+@brief 処理待ちの処理を取り消す。
+@details 取り消した処理の cancel は、この関数を呼び出したスレッドで呼び出される。
+@param workId submitWork で取得した識別番号
+@retval FUNCTION_SUCCESS 取り消した
+@retval JOB_NOT_FOUND 処理待ちの中に見つからない（実行中・実行済みの場合を含む）
+*/
+int cancelWork(unsigned long workId);
+
+/*!
+@brief 登録済みの処理が全て終わるまで待つ。
+@attention 登録した処理の中から呼び出さないこと。
+*/
+void drainWorkQueue(void);
+
+/*!
+@brief 処理キューを停止し、スレッドを終了する。
+@details 停止処理中の登録は QUEUE_STOPPED で失敗する。停止後に登録した場合は再び開始する。
+@attention 登録した処理の中から呼び出さないこと。また、複数のスレッドから同時に呼び出さないこと。
+@param cancelPending 処理待ちの処理を取り消す（ JACIC_BOOL_TRUE ）か、全て実行してから停止する（ JACIC_BOOL_FALSE ）か
+*/
+void shutdownWorkQueue(JACIC_BOOL cancelPending);
+
+#endif /* QUEUE_H_ */
@@ -6,7 +6,6 @@
 @brief ハッシュ値 (SHA-256) 計算モジュールのソースコード
 */
 
-#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,46 +13,125 @@
 #include "common.h"
 #include "sha256.h"
 
-/*!
-@struct UIntHashBuffer
-@brief 整数型の配列と長さのペア
-*/
-typedef struct
-{
-    size_t _len;          /*!< @brief 値の長さ */
-    unsigned int _buff[]; /*!< @brief 値 */
-} UIntHashBuffer;
+/*
+ @name ハードウェア命令の利用判定
+ @details SHA 拡張命令を持つ CPU では専用命令によるブロック処理を実行時に選択する。
+ JCOMSIA_DISABLE_HW_SHA256 を定義してビルドした場合は常に移植性のある実装を使用する。
+ */
+/* @{ */
+#if !defined(JCOMSIA_DISABLE_HW_SHA256) && (defined(__GNUC__) || defined(__clang__))
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SHA256_USE_X86_SHA_NI                                                   /*!< @brief x86 SHA 拡張命令 (SHA-NI) を使用する */
+#define SHA256_X86_TARGET __attribute__((target("sha,sse4.1")))                 /*!< @brief SHA-NI 用関数のコンパイル対象 */
+#elif defined(__aarch64__) && defined(__linux__)
+#if defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+#define SHA256_USE_ARMV8_SHA2                                                   /*!< @brief ARMv8 暗号拡張命令を使用する */
+#define SHA256_ARMV8_TARGET                                                     /*!< @brief ビルド設定で既に有効になっている */
+#elif defined(__clang__) && (16 <= __clang_major__)
+#define SHA256_USE_ARMV8_SHA2
+#define SHA256_ARMV8_TARGET __attribute__((target("sha2")))
+#elif !defined(__clang__) && (8 <= __GNUC__)
+#define SHA256_USE_ARMV8_SHA2
+#define SHA256_ARMV8_TARGET __attribute__((target("+crypto")))
+#endif
+#endif
+
+#endif /* JCOMSIA_DISABLE_HW_SHA256 */
+
+#if defined(SHA256_USE_X86_SHA_NI)
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA256_HW_DISPATCH                                                      /*!< @brief 実行時にブロック処理関数を選択する */
+#elif defined(SHA256_USE_ARMV8_SHA2)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)                                                     /*!< @brief AT_HWCAP の SHA2 ビット */
+#endif
+#define SHA256_HW_DISPATCH
+#endif
+/* @} */
 
 /* @name ビットマスク */
 /* @{ */
-#define MASK_64BIT (0x3F)             /*!< @brief 下 6 ビットのみを抽出するマスク */
 #define MASK_1BYTE (0xFF)             /*!< @brief 1 バイトのみを抽出するマスク */
-#define MASK_TOP (0x80000000U)        /*!< @brief 最上位ビットのみを抽出するマスク */
-#define MASK_IGNORE_TOP (0x7FFFFFFFU) /*!< @brief 最上位ビットのみを削除するマスク */
 /* @} */
 
 /* @name ビット操作 */
 /* @{ */
-#define SHR(target, shift)  (target >> shift)                               /*!< @brief 右ビットシフト */
-#define ROTR(target, shift) (SHR(target, shift) | (target << (32 - shift))) /*!< @brief 右ビット回転 */
+#define SHR(target, shift)  ((target) >> (shift))                               /*!< @brief 右ビットシフト */
+#define ROTR(target, shift) (SHR(target, shift) | ((target) << (32 - (shift)))) /*!< @brief 右ビット回転 */
 /* @} */
 
 /* @name 各種計算処理 */
 /* @{ */
-#define CH(x, y, z) ((x & y) ^ ((~x) & z))                      /*!< @brief ハッシュ計算処理 */
-#define MAJ(x, y, z) ((x & y) ^ (x & z) ^ (y & z))              /*!< @brief ハッシュ計算処理 */
+#define CH(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))                   /*!< @brief ハッシュ計算処理 */
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))          /*!< @brief ハッシュ計算処理 */
 #define SIGMA_A0(x) (ROTR(x,  2) ^ ROTR(x, 13) ^ ROTR(x, 22))   /*!< @brief ハッシュ計算処理 */
 #define SIGMA_A1(x) (ROTR(x,  6) ^ ROTR(x, 11) ^ ROTR(x, 25))   /*!< @brief ハッシュ計算処理 */
 #define SIGMA_B0(x) (ROTR(x,  7) ^ ROTR(x, 18) ^  SHR(x,  3))   /*!< @brief ハッシュ計算処理 */
 #define SIGMA_B1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^  SHR(x, 10))   /*!< @brief ハッシュ計算処理 */
 /* @} */
 
+/*
+ @name ビッグエンディアン読み込み
+ @details 稼働環境のエンディアンはコンパイル時に判定する。
+ 判定できないコンパイラではシフト演算による読み込みを行う（どちらの環境でも正しく動作する）。
+ */
+/* @{ */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define SHA256_LOAD_BIG_ENDIAN_32(dst, src) memcpy(&(dst), (src), BYTE_SIZE_UNSIGNED_INT)                       /*!< @brief ビッグエンディアン環境ではそのまま読み込む */
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) && (defined(__GNUC__) || defined(__clang__))
+#define SHA256_LOAD_BIG_ENDIAN_32(dst, src) do { memcpy(&(dst), (src), BYTE_SIZE_UNSIGNED_INT); (dst) = __builtin_bswap32(dst); } while(0) /*!< @brief リトルエンディアン環境ではバイト順を反転させて読み込む */
+#else
+#define SHA256_LOAD_BIG_ENDIAN_32(dst, src) \
+    ((dst) = ((unsigned int)(src)[0] << 24) | ((unsigned int)(src)[1] << 16) | ((unsigned int)(src)[2] << 8) | ((unsigned int)(src)[3])) /*!< @brief エンディアンに依存しない読み込み */
+#endif
+/* @} */
+
+/*
+ @name 展開済みラウンド処理
+ @details メッセージスケジュールは直近 16 ワードのみをリング状に保持する。
+ 変数の入れ替えを行わず、ラウンドごとに引数の並びをずらして展開する。
+ */
+/* @{ */
+#define SCHEDULE(w, i) \
+    ((w)[(i) & 15] += SIGMA_B1((w)[((i) - 2) & 15]) + (w)[((i) - 7) & 15] + SIGMA_B0((w)[((i) - 15) & 15]))  /*!< @brief 16 ワード目以降のメッセージスケジュール */
+
+#define ROUND(a, b, c, d, e, f, g, h, k, word) \
+do { \
+    unsigned int t1 = (h) + SIGMA_A1(e) + CH(e, f, g) + (k) + (word); \
+    unsigned int t2 = SIGMA_A0(a) + MAJ(a, b, c); \
+    (d) += t1; \
+    (h) = t1 + t2; \
+} while(0)  /*!< @brief 1 ラウンド分の計算 */
+
+#define ROUND_00_15(a, b, c, d, e, f, g, h, i) \
+do { \
+    SHA256_LOAD_BIG_ENDIAN_32(w[i], block + (i) * BYTE_SIZE_UNSIGNED_INT); \
+    ROUND(a, b, c, d, e, f, g, h, UNSIGNED_INT_K[i], w[i]); \
+} while(0)  /*!< @brief 0 ～ 15 ラウンド目（ブロックからワードを読み込む） */
+
+#define ROUND_16_63(a, b, c, d, e, f, g, h, i) \
+    ROUND(a, b, c, d, e, f, g, h, UNSIGNED_INT_K[i], SCHEDULE(w, i))  /*!< @brief 16 ～ 63 ラウンド目（スケジュールからワードを生成する） */
+
+#define ROUNDS_8(R, i) \
+do { \
+    R(a, b, c, d, e, f, g, h, (i) + 0); \
+    R(h, a, b, c, d, e, f, g, (i) + 1); \
+    R(g, h, a, b, c, d, e, f, (i) + 2); \
+    R(f, g, h, a, b, c, d, e, (i) + 3); \
+    R(e, f, g, h, a, b, c, d, (i) + 4); \
+    R(d, e, f, g, h, a, b, c, (i) + 5); \
+    R(c, d, e, f, g, h, a, b, (i) + 6); \
+    R(b, c, d, e, f, g, h, a, (i) + 7); \
+} while(0)  /*!< @brief 8 ラウンド分をまとめて展開する */
+/* @} */
+
 /* @name 定数マクロ定義 */
 /* @{ */
 #define BYTE_SIZE_ORIDINAL_DATA_LENGTH ((size_t)8)              /*!< @brief ハッシュ作成元データの本来のサイズをビットで格納する際の長さ */
-#define BYTE_SIZE_MESSAGE_BLOCK ((size_t)64)                    /*!< @brief メッセージブロックのビット数 */
-
-#define BYTE_SIZE_UNSIGNED_INT_HASH (sizeof(DEFAULT_UINT_HASH)) /*!< @brief 整数値で計算を行う際のハッシュのバイトサイズ */
 
 #define PADDING_DELIMITER_BYTE (0x80)                           /*!< @brief パディングの区切りバイト */
 /* @} */
@@ -79,442 +157,487 @@ static const unsigned int DEFAULT_UINT_HASH[] =
 };
 
 /*!
-@brief バイト配列構造体の指定した範囲を反転させる。
-@param [out] byteArray 対象となるバイト配列構造体
-@param startIndex 反転させる範囲の先頭のインデックス
-@param length 反転させる範囲の長さ
+@brief ハッシュ (SHA-256) の計算処理を行う。
+@details 加算は符号なし整数の桁あふれ（2^32 を法とする演算）をそのまま利用する。
+@param [in, out] hash 計算途中のハッシュ値。結果で上書きされる
+@param [in] data 計算のもととなるバイト配列（blockCount ブロック分）
+@param blockCount 処理するブロック数
 */
-void reverseByteArray(HashBuffer *byteArray, unsigned long startIndex, size_t length)
+static void computationPortable(unsigned int *hash, const unsigned char *data, size_t blockCount)
 {
-    unsigned long i, j;
-    unsigned char tmp;
+    unsigned int w[16];
 
-    for(i = startIndex, j = startIndex + length - 1; i < j; ++i, --j)
+    /* ローテーション用 */
+    unsigned int a;
+    unsigned int b;
+    unsigned int c;
+    unsigned int d;
+    unsigned int e;
+    unsigned int f;
+    unsigned int g;
+    unsigned int h;
+
+    const unsigned char *block;
+
+    for(block = data; 0 < blockCount; --blockCount, block += BYTE_SIZE_MESSAGE_BLOCK)
     {
-        tmp = byteArray->_buff[i];
-        byteArray->_buff[i] = byteArray->_buff[j];
-        byteArray->_buff[j] = tmp;
+        /* 現在のハッシュを複製 */
+        a = hash[0];
+        b = hash[1];
+        c = hash[2];
+        d = hash[3];
+        e = hash[4];
+        f = hash[5];
+        g = hash[6];
+        h = hash[7];
+
+        /* 0 ～ 15 は Block の配列を 4 バイトずつビッグエンディアンとして読み込む */
+        ROUNDS_8(ROUND_00_15,  0);
+        ROUNDS_8(ROUND_00_15,  8);
+
+        /* 16 ～ 63 は、すでに読み込まれた値から生成する */
+        ROUNDS_8(ROUND_16_63, 16);
+        ROUNDS_8(ROUND_16_63, 24);
+        ROUNDS_8(ROUND_16_63, 32);
+        ROUNDS_8(ROUND_16_63, 40);
+        ROUNDS_8(ROUND_16_63, 48);
+        ROUNDS_8(ROUND_16_63, 56);
+
+        /* 算出されたハッシュを現在のハッシュに加算 */
+        hash[0] += a;
+        hash[1] += b;
+        hash[2] += c;
+        hash[3] += d;
+        hash[4] += e;
+        hash[5] += f;
+        hash[6] += g;
+        hash[7] += h;
     }
 }
 
+#if defined(SHA256_USE_X86_SHA_NI)
+
 /*!
-@brief バイト配列構造体の指定したインデックスから 4 バイトまでを符号なし整数値に変換する。
-@details startIndexがバイト配列構造体の長さを超過した場合、その時点で計算を止めて結果を返す。
-@param [in] byteArray 対象となるバイト配列構造体
-@param startIndex 処理の開始位置となる先頭のインデックス
-@return 計算結果
+@brief x86 SHA 拡張命令 (SHA-NI) を用いてハッシュ (SHA-256) の計算処理を行う。
+@details 4 ラウンドごとに _mm_sha256rnds2_epu32 を 2 回呼び出す。
+メッセージスケジュールは直近 4 グループ (16 ワード) のみを保持する。
+@param [in, out] hash 計算途中のハッシュ値。結果で上書きされる
+@param [in] data 計算のもととなるバイト配列（blockCount ブロック分）
+@param blockCount 処理するブロック数
 */
-unsigned int byteArrayToUInt(HashBuffer *byteArray, int startIndex)
+static SHA256_X86_TARGET void computationSHANI(unsigned int *hash, const unsigned char *data, size_t blockCount)
 {
-    unsigned int i;
-    unsigned int result = 0U;
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
 
-    for(i = 0; i < 4 && i + startIndex < byteArray->_len; ++i)
-    {
-        result += (byteArray->_buff[startIndex + i] << (i << 3));
-    }
+    __m128i state0;
+    __m128i state1;
+    __m128i savedState0;
+    __m128i savedState1;
+    __m128i message[4];
+    __m128i roundInput;
+    __m128i tmp;
 
-    return result;
-}
+    int i;
 
-/*!
-@brief 符号なし倍精度整数をバイトごとの配列に分割する。
-@param [out] result 変換結果を格納するバイト配列構造体
-@param value 変換対象の数値
-@param length 変換するバイトの長さ ( 最大 8 バイトまで )
-@retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_PARAMETER 対象となる数のバイト数が多すぎる場合
-@retval OTHER_ERROR 配列の長さが十分でない場合
-*/
-int getBytes(HashBuffer *result, unsigned long long int value, size_t length)
-{
-    unsigned int i;
+    /* 専用命令が要求する {A, B, E, F} / {C, D, G, H} の並びに変換する */
+    tmp    = _mm_loadu_si128((const __m128i *)&hash[0]);
+    state1 = _mm_loadu_si128((const __m128i *)&hash[4]);
 
-    if(sizeof(value) < length)
-    {
-        /* 対象となる数のバイト数が多すぎる */
-        return INCORRECT_PARAMETER;
-    }
-    else if(result->_len < length)
-    {
-        /* 配列の長さが十分でない */
-        return OTHER_ERROR;
-    }
+    tmp    = _mm_shuffle_epi32(tmp, 0xB1);
+    state1 = _mm_shuffle_epi32(state1, 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
 
-    for(i = 0; i < length; ++i)
+    for(; 0 < blockCount; --blockCount, data += BYTE_SIZE_MESSAGE_BLOCK)
     {
-        result->_buff[i] = (value >> (i << 3)) & MASK_1BYTE;
+        savedState0 = state0;
+        savedState1 = state1;
+
+        for(i = 0; i < 16; ++i)
+        {
+            if(i < 4)
+            {
+                /* 0 ～ 15 ワード目はブロックからビッグエンディアンとして読み込む */
+                message[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + i * 16)), byteSwapMask);
+            }
+            else
+            {
+                /* 16 ワード目以降はすでに読み込まれた値から生成する */
+                tmp = _mm_add_epi32(
+                          _mm_sha256msg1_epu32(message[(i - 4) & 3], message[(i - 3) & 3]),
+                          _mm_alignr_epi8(message[(i - 1) & 3], message[(i - 2) & 3], 4)
+                      );
+                message[i & 3] = _mm_sha256msg2_epu32(tmp, message[(i - 1) & 3]);
+            }
+
+            roundInput = _mm_add_epi32(message[i & 3], _mm_loadu_si128((const __m128i *)&UNSIGNED_INT_K[i * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, roundInput);
+            roundInput = _mm_shuffle_epi32(roundInput, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, roundInput);
+        }
+
+        /* 算出されたハッシュを現在のハッシュに加算 */
+        state0 = _mm_add_epi32(state0, savedState0);
+        state1 = _mm_add_epi32(state1, savedState1);
     }
 
-    return FUNCTION_SUCCESS;
+    /* {A, B, C, D} / {E, F, G, H} の並びに戻す */
+    tmp    = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+    _mm_storeu_si128((__m128i *)&hash[0], state0);
+    _mm_storeu_si128((__m128i *)&hash[4], state1);
 }
 
 /*!
-@brief オーバーフローを起こさないよう、計算した結果溢れた桁を無視する加算処理を行う。
-@param paramLength この値を除いた引数の個数
-@return 計算結果
+@brief 稼働中の CPU が SHA-NI とその前提となる SSE4.1 に対応しているか調べる。
+@retval JACIC_BOOL_TRUE 対応している
+@retval JACIC_BOOL_FALSE 対応していない
 */
-unsigned int safetyAdd(int paramLength, ...)
+static JACIC_BOOL _hasHardwareSHA256(void)
 {
-    va_list args;
-    unsigned int result = 0U;
-    unsigned int value;
-    int i;
+    unsigned int eax, ebx, ecx, edx;
 
-    va_start(args, paramLength);
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) return JACIC_BOOL_FALSE;
 
-    /* 引数の数だけ加算する */
-    for(i = 0; i < paramLength; ++i)
-    {
-        value = va_arg(args, unsigned int);
-        result = ((result & MASK_IGNORE_TOP) + (value & MASK_IGNORE_TOP)) ^ (result & MASK_TOP) ^ (value & MASK_TOP);
-    }
+    /* SSSE3 (bit 9) と SSE4.1 (bit 19) */
+    if((ecx & (1U << 9)) == 0 || (ecx & (1U << 19)) == 0) return JACIC_BOOL_FALSE;
 
-    va_end(args);
+    if(__get_cpuid_max(0, NULL) < 7) return JACIC_BOOL_FALSE;
 
-    return result;
+    /* SHA (leaf 7, sub-leaf 0, EBX bit 29) */
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    return (ebx & (1U << 29)) != 0 ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
 }
 
+#define computationHardware computationSHANI    /*!< @brief ハードウェア命令によるブロック処理関数 */
+
+#elif defined(SHA256_USE_ARMV8_SHA2)
+
 /*!
-@brief ハッシュ (SHA-256) の計算処理を行う。
-@param [in] block 計算のもととなるバイト配列構造体
-@param [out] hash 最終的な結果を受け取る整数配列構造体
+@brief ARMv8 暗号拡張命令を用いてハッシュ (SHA-256) の計算処理を行う。
+@details 4 ラウンドごとに vsha256hq_u32 / vsha256h2q_u32 を呼び出す。
+メッセージスケジュールは直近 4 グループ (16 ワード) のみを保持する。
+@param [in, out] hash 計算途中のハッシュ値。結果で上書きされる
+@param [in] data 計算のもととなるバイト配列（blockCount ブロック分）
+@param blockCount 処理するブロック数
 */
-void computation(HashBuffer *block, UIntHashBuffer *hash)
+static SHA256_ARMV8_TARGET void computationARMv8(unsigned int *hash, const unsigned char *data, size_t blockCount)
 {
-    unsigned int uIntWord[64];
-
-    /* ローテーション用 */
-    unsigned int a;
-    unsigned int b;
-    unsigned int c;
-    unsigned int d;
-    unsigned int e;
-    unsigned int f;
-    unsigned int g;
-    unsigned int h;
-
-    /* ローテーション処理中に利用する一時変数 */
-    unsigned int uIntTmp1;
-    unsigned int uIntTmp2;
+    uint32x4_t state0;
+    uint32x4_t state1;
+    uint32x4_t savedState0;
+    uint32x4_t savedState1;
+    uint32x4_t message[4];
+    uint32x4_t roundInput;
+    uint32x4_t tmp;
 
-    /* ループカウンタ */
     int i;
 
-    /* 現在のハッシュを複製 */
-    a = hash->_buff[0];
-    b = hash->_buff[1];
-    c = hash->_buff[2];
-    d = hash->_buff[3];
-    e = hash->_buff[4];
-    f = hash->_buff[5];
-    g = hash->_buff[6];
-    h = hash->_buff[7];
-
-    /* ローテーション処理 */
-    for(i = 0; i < 64; ++i)
+    state0 = vld1q_u32(&hash[0]);
+    state1 = vld1q_u32(&hash[4]);
+
+    for(; 0 < blockCount; --blockCount, data += BYTE_SIZE_MESSAGE_BLOCK)
     {
-        /* 0 ～ 15は、Block の配列を 4 バイトずつ uIntWord に代入していく */
-        if(i < 16)
-        {
+        savedState0 = state0;
+        savedState1 = state1;
 
-            /* リトルエンディアンの場合は反転させてビッグエンディアンにする */
-            if(getEndian() == JACIC_LITTLE_ENDIAN)
+        for(i = 0; i < 16; ++i)
+        {
+            if(i < 4)
             {
-                reverseByteArray(block, i * BYTE_SIZE_UNSIGNED_INT, BYTE_SIZE_UNSIGNED_INT);
+                /* 0 ～ 15 ワード目はブロックからビッグエンディアンとして読み込む */
+                message[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+            }
+            else
+            {
+                /* 16 ワード目以降はすでに読み込まれた値から生成する */
+                message[i & 3] = vsha256su1q_u32(
+                                     vsha256su0q_u32(message[(i - 4) & 3], message[(i - 3) & 3]),
+                                     message[(i - 2) & 3],
+                                     message[(i - 1) & 3]
+                                 );
             }
 
-            uIntWord[i] = byteArrayToUInt(block, i * BYTE_SIZE_UNSIGNED_INT);
-
-            /* 16 ～ 63は、すでに代入された値から生成する */
-        }
-        else
-        {
-
-            uIntWord[i] = safetyAdd(4,
-                                    SIGMA_B1(uIntWord[i -  2]), uIntWord[i -  7],
-                                    SIGMA_B0(uIntWord[i - 15]), uIntWord[i - 16]
-                                   );
-
+            roundInput = vaddq_u32(message[i & 3], vld1q_u32(&UNSIGNED_INT_K[i * 4]));
+            tmp = state0;
+            state0 = vsha256hq_u32(state0, state1, roundInput);
+            state1 = vsha256h2q_u32(state1, tmp, roundInput);
         }
 
-        /* ローテーション時に変化を与える値を算出 */
-        uIntTmp1 = safetyAdd(5, h, SIGMA_A1(e), CH(e, f, g), UNSIGNED_INT_K[i], uIntWord[i]);
-        uIntTmp2 = safetyAdd(2, SIGMA_A0(a), MAJ(a, b, c));
-
-        h = g;
-        g = f;
-        f = e;
-        e = safetyAdd(2, d, uIntTmp1);
-        d = c;
-        c = b;
-        b = a;
-        a = safetyAdd(2, uIntTmp1, uIntTmp2);
-
+        /* 算出されたハッシュを現在のハッシュに加算 */
+        state0 = vaddq_u32(state0, savedState0);
+        state1 = vaddq_u32(state1, savedState1);
     }
 
-    /* 算出されたハッシュを現在のハッシュに加算 */
-    hash->_buff[0] = safetyAdd(2, hash->_buff[0], a);
-    hash->_buff[1] = safetyAdd(2, hash->_buff[1], b);
-    hash->_buff[2] = safetyAdd(2, hash->_buff[2], c);
-    hash->_buff[3] = safetyAdd(2, hash->_buff[3], d);
-    hash->_buff[4] = safetyAdd(2, hash->_buff[4], e);
-    hash->_buff[5] = safetyAdd(2, hash->_buff[5], f);
-    hash->_buff[6] = safetyAdd(2, hash->_buff[6], g);
-    hash->_buff[7] = safetyAdd(2, hash->_buff[7], h);
-
+    vst1q_u32(&hash[0], state0);
+    vst1q_u32(&hash[4], state1);
 }
 
 /*!
-@brief 可変長のバイト配列を受けてハッシュ値を返す。
-@param [in] byteArray ハッシュ値を計算するもととなるバイト配列構造体
-@param [out] result 最終的に算出されたハッシュ値を受けとる変数
-@retval FUNCTION_SUCCESS 正常終了
-@retval INCORRECT_PARAMETER 不正な引数により、内部で使用する関数でエラーが発生した場合
-@retval OTHER_ERROR メモリの確保に失敗した場合、ハッシュ値の格納に失敗した場合など
+@brief 稼働中の CPU が ARMv8 の SHA2 命令に対応しているか調べる。
+@retval JACIC_BOOL_TRUE 対応している
+@retval JACIC_BOOL_FALSE 対応していない
 */
-int hash(HashBuffer *byteArray, HashBuffer *result)
+static JACIC_BOOL _hasHardwareSHA256(void)
 {
-    int ret = FUNCTION_SUCCESS;
-    HashBuffer *orgLength = NULL;
-    HashBuffer *resizedByteArray = NULL;
-    HashBuffer *block = NULL;
-    HashBuffer *hashBytes = NULL;
-    UIntHashBuffer *uIntHash = NULL;
-    size_t tmpByteArrayLength = 0;
-    size_t totalBytes = 0;
-    size_t totalBlocks = 0;
-    size_t orgLengthMemorySize = sizeof(HashBuffer) + BYTE_SIZE_ORIDINAL_DATA_LENGTH;
-    size_t resizedByteArrayMemorySize = 0;
-    size_t blockMemorySize = sizeof(HashBuffer) + BYTE_SIZE_MESSAGE_BLOCK;
-    size_t uIntHashMemorySize = sizeof(HashBuffer) + sizeof(DEFAULT_UINT_HASH);
-    size_t hashBytesMemorySize = sizeof(HashBuffer) + BYTE_SIZE_UNSIGNED_INT;
-    unsigned int i;
-    unsigned int j;
-    unsigned int k;
-
-    /* 元データの長さをビット数で記憶する変数 */
-    orgLength = (HashBuffer *) malloc(orgLengthMemorySize);
-
-    if(orgLength == NULL)
-    {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
-    }
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0 ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+}
 
-    /* 領域のゼロクリア */
-    memset(orgLength, 0x00, orgLengthMemorySize);
+#define computationHardware computationARMv8    /*!< @brief ハードウェア命令によるブロック処理関数 */
 
-    orgLength->_len = BYTE_SIZE_ORIDINAL_DATA_LENGTH;
+#endif
 
-    /* 元データの長さをビット数 ( 8 倍 ) で記憶 */
-    ret = getBytes(orgLength, byteArray->_len * BIT_SIZE_1BYTE, BYTE_SIZE_ORIDINAL_DATA_LENGTH);
-
-    if(ret != FUNCTION_SUCCESS)
-    {
-        goto FINALIZE;    /* 処理失敗 */
-    }
+/*!
+@brief ブロック処理関数の型
+*/
+typedef void (*SHA256BlockFunction)(unsigned int *hash, const unsigned char *data, size_t blockCount);
 
-    /* リトルエンディアンの場合は反転させてビッグエンディアンにする */
-    if(getEndian() == JACIC_LITTLE_ENDIAN)
-    {
-        reverseByteArray(orgLength, 0, BYTE_SIZE_ORIDINAL_DATA_LENGTH);
-    }
+#if defined(SHA256_HW_DISPATCH)
 
-    /* 配列を 1 増加させた長さを取得 */
-    tmpByteArrayLength = byteArray->_len + 1;
+/*! 実行時に選択したブロック処理関数（未選択の場合は NULL） */
+static SHA256BlockFunction selectedBlockFunction = NULL;
 
-    /*
-     * ブロックの総数を算出
-     *  1 ブロックあたりのバイト数で割り + 1 する
-     */
-    totalBlocks = tmpByteArrayLength / BYTE_SIZE_MESSAGE_BLOCK + 1;
+/*!
+@brief 稼働中の CPU に合ったブロック処理関数を返す。
+@details 初回呼び出し時に CPU の対応命令を調べて結果を保持する。
+複数のスレッドから同時に呼び出された場合も、同じ関数が選ばれるだけで結果は変わらない。
+@return ブロック処理関数
+*/
+static SHA256BlockFunction _getBlockFunction(void)
+{
+    SHA256BlockFunction blockFunction = __atomic_load_n(&selectedBlockFunction, __ATOMIC_ACQUIRE);
 
-    /*
-     * 最後のメッセージブロックが 56 ( 全体 64 バイト - 元データ長の 8 バイト表現 ) バイトを超えている場合、
-     * メッセージブロックを一つ増やす
-     */
-    if((BYTE_SIZE_MESSAGE_BLOCK - BYTE_SIZE_ORIDINAL_DATA_LENGTH) < (tmpByteArrayLength & MASK_64BIT))
+    if(blockFunction == NULL)
     {
-        totalBlocks += 1;
+        blockFunction = (_hasHardwareSHA256() == JACIC_BOOL_TRUE) ? computationHardware : computationPortable;
+        __atomic_store_n(&selectedBlockFunction, blockFunction, __ATOMIC_RELEASE);
     }
 
-    /* 最終的なバイト数は [ ブロック数 ] * [ 1 ブロックあたりのバイト数 ] */
-    totalBytes = totalBlocks * BYTE_SIZE_MESSAGE_BLOCK;
-
-    /* 総ブロック数の領域を確保 */
-    resizedByteArrayMemorySize = sizeof(HashBuffer) + (BYTE_SIZE_UNSIGNED_CHAR * totalBytes);
-    resizedByteArray = (HashBuffer *) malloc(resizedByteArrayMemorySize);
-
-    if(resizedByteArray == NULL)
-    {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
-    }
+    return blockFunction;
+}
 
-    resizedByteArray->_len = totalBytes;
+#else
 
-    /* 領域のゼロクリア */
-    memset(resizedByteArray, 0x00, resizedByteArrayMemorySize);
+/*!
+@brief ブロック処理関数を返す。
+@details ハードウェア命令を利用できないビルドでは常に移植性のある実装を返す。
+@return ブロック処理関数
+*/
+static SHA256BlockFunction _getBlockFunction(void)
+{
+    return computationPortable;
+}
 
-    /* 元データをコピー */
-    memcpy(resizedByteArray->_buff, byteArray->_buff, byteArray->_len);
+#endif /* SHA256_HW_DISPATCH */
 
-    /* パディング用の区切り文字 */
-    resizedByteArray->_buff[byteArray->_len] = PADDING_DELIMITER_BYTE;
+/*!
+@brief ハッシュ (SHA-256) の計算処理を、稼働中の CPU に合った実装で行う。
+@param [in, out] hash 計算途中のハッシュ値。結果で上書きされる
+@param [in] data 計算のもととなるバイト配列（blockCount ブロック分）
+@param blockCount 処理するブロック数
+*/
+static void computation(unsigned int *hash, const unsigned char *data, size_t blockCount)
+{
+    _getBlockFunction()(hash, data, blockCount);
+}
 
-    /* malloc で増加した領域（末尾の元データ長を埋める 8 バイトを除く）のゼロクリア */
-    memset(
-        resizedByteArray->_buff + tmpByteArrayLength,
-        0x00,
-        totalBytes - tmpByteArrayLength - BYTE_SIZE_ORIDINAL_DATA_LENGTH
-    );
+/*!
+@brief ハッシュ値の逐次計算を開始するため、コンテキストを初期化する。
+@param [out] context 初期化対象のコンテキスト
+*/
+void sha256Init(SHA256Context *context)
+{
+    memcpy(context->_state, DEFAULT_UINT_HASH, sizeof(DEFAULT_UINT_HASH));
+    context->_totalLength = 0;
+    context->_blockLength = 0;
+    memset(context->_block, 0x00, BYTE_SIZE_MESSAGE_BLOCK);
+}
 
-    /* データ長を末尾にコピー */
-    memcpy(
-        resizedByteArray->_buff + totalBytes - BYTE_SIZE_ORIDINAL_DATA_LENGTH,
-        orgLength->_buff,
-        BYTE_SIZE_ORIDINAL_DATA_LENGTH
-    );
+/*!
+@brief ハッシュ値の計算対象となるデータを追加する。
+@details 1 ブロックに満たない端数はコンテキスト内に保持し、次回以降の呼び出しで処理する。
+@param [in, out] context sha256Init で初期化済みのコンテキスト
+@param [in] data 追加するバイト配列
+@param length data の長さ
+*/
+void sha256Update(SHA256Context *context, const unsigned char *data, size_t length)
+{
+    size_t copyLength;
+    size_t blockCount;
 
+    if(length == 0) return;
 
-    /* メッセージブロック用の配列 */
-    block = (HashBuffer *) malloc(blockMemorySize);
+    context->_totalLength += length;
 
-    if(block == NULL)
+    /* 前回の端数が残っている場合は、先に 1 ブロック分まで埋めて処理する */
+    if(context->_blockLength != 0)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
-    }
+        copyLength = BYTE_SIZE_MESSAGE_BLOCK - context->_blockLength;
+        if(length < copyLength)
+        {
+            copyLength = length;
+        }
 
-    /* 領域のゼロクリア */
-    memset(block, 0x00, blockMemorySize);
+        memcpy(context->_block + context->_blockLength, data, copyLength);
+        context->_blockLength += copyLength;
+        data += copyLength;
+        length -= copyLength;
 
-    block->_len = BYTE_SIZE_MESSAGE_BLOCK;
+        if(context->_blockLength < BYTE_SIZE_MESSAGE_BLOCK)
+        {
+            return;
+        }
 
-    /* ハッシュの初期値 */
-    uIntHash = (UIntHashBuffer *) malloc(uIntHashMemorySize);
+        computation(context->_state, context->_block, 1);
+        context->_blockLength = 0;
+    }
 
-    if(uIntHash == NULL)
+    /* ブロック単位のデータはコピーせずにそのまま処理する */
+    blockCount = length / BYTE_SIZE_MESSAGE_BLOCK;
+    if(blockCount != 0)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
+        computation(context->_state, data, blockCount);
+        data += blockCount * BYTE_SIZE_MESSAGE_BLOCK;
+        length -= blockCount * BYTE_SIZE_MESSAGE_BLOCK;
     }
 
-    /* 領域のゼロクリア */
-    memset(uIntHash, 0x00, uIntHashMemorySize);
+    /* 1 ブロックに満たない端数を保持する */
+    if(length != 0)
+    {
+        memcpy(context->_block, data, length);
+        context->_blockLength = length;
+    }
+}
 
-    uIntHash->_len = sizeof(DEFAULT_UINT_HASH) / BYTE_SIZE_UNSIGNED_INT;
+/*!
+@brief 末尾の端数データにパディングとデータ長を付与した最終ブロックを作成する。
+@param [out] dst 最終ブロックの格納先（BYTE_SIZE_MESSAGE_BLOCK * 2 バイト以上の長さを持つこと）
+@param [in] rest 1 ブロックに満たない端数データ
+@param restLength rest の長さ（BYTE_SIZE_MESSAGE_BLOCK 未満）
+@param totalLength 元データ全体のバイト数
+@return 作成したブロック数（1 または 2）
+*/
+static size_t _buildFinalBlocks(unsigned char *dst, const unsigned char *rest, size_t restLength, unsigned long long int totalLength)
+{
+    size_t blockCount = 1;
+    size_t i;
 
-    memcpy(uIntHash->_buff, DEFAULT_UINT_HASH, sizeof(DEFAULT_UINT_HASH));
+    /* 元データの長さをビット数 ( 8 倍 ) で記憶 */
+    unsigned long long int bitLength = totalLength * BIT_SIZE_1BYTE;
 
-    /* ハッシュ計算処理 */
-    for(i = 0; i < totalBytes; i += BYTE_SIZE_MESSAGE_BLOCK)
+    /*
+     * 最後のメッセージブロックが 56 ( 全体 64 バイト - 元データ長の 8 バイト表現 ) バイトを超えている場合、
+     * メッセージブロックを一つ増やす
+     */
+    if((BYTE_SIZE_MESSAGE_BLOCK - BYTE_SIZE_ORIDINAL_DATA_LENGTH) <= restLength)
     {
-
-        /* メッセージブロックにデータをコピー */
-        memcpy(block->_buff, resizedByteArray->_buff + i, BYTE_SIZE_MESSAGE_BLOCK);
-
-        /* メッセージブロックのハッシュを計算 */
-        computation(block, uIntHash);
+        blockCount = 2;
     }
 
-
-    /* データの長さのビット数表示をバイトに変換するための変数 */
-    hashBytes = (HashBuffer *) malloc(hashBytesMemorySize);
-
-    if(hashBytes == NULL)
+    if(restLength != 0)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
+        memcpy(dst, rest, restLength);
     }
 
-    /* 領域のゼロクリア */
-    memset(hashBytes, 0x00, hashBytesMemorySize);
+    /* パディング用の区切り文字 */
+    dst[restLength] = PADDING_DELIMITER_BYTE;
 
-    hashBytes->_len = BYTE_SIZE_UNSIGNED_INT;
+    /* 末尾の元データ長を埋める 8 バイトを除いた残りをゼロクリア */
+    memset(dst + restLength + 1, 0x00, blockCount * BYTE_SIZE_MESSAGE_BLOCK - BYTE_SIZE_ORIDINAL_DATA_LENGTH - restLength - 1);
 
-    /* 符号なし整数型の配列から 1 バイトごとの配列に変換 */
-    for(i = 0; i < (sizeof(DEFAULT_UINT_HASH) / BYTE_SIZE_UNSIGNED_INT); ++i)
+    /* データ長をビッグエンディアンで末尾に格納 */
+    for(i = 0; i < BYTE_SIZE_ORIDINAL_DATA_LENGTH; ++i)
     {
+        dst[blockCount * BYTE_SIZE_MESSAGE_BLOCK - 1 - i] = (unsigned char)((bitLength >> (i * BIT_SIZE_1BYTE)) & MASK_1BYTE);
+    }
 
-        ret = getBytes(hashBytes, uIntHash->_buff[i], BYTE_SIZE_UNSIGNED_INT);
-
-        if(ret != FUNCTION_SUCCESS)
-        {
-            goto FINALIZE;    /* 処理失敗 */
-        }
-
-        /* リトルエンディアンの場合は反転させてビッグエンディアンにする */
-        if(getEndian() == JACIC_LITTLE_ENDIAN)
-        {
-            reverseByteArray(hashBytes, 0, BYTE_SIZE_UNSIGNED_INT);
+    return blockCount;
+}
 
-        }
+/*!
+@brief 計算済みのハッシュの中間状態をバイト配列に変換する。
+@param [in] state ハッシュの中間状態（UINT_SIZE_HASH_STATE 個の整数値）
+@param [out] digest 変換結果を受けとる配列（BYTE_SIZE_HASH_DIGEST バイト）
+*/
+static void _writeDigest(const unsigned int *state, unsigned char *digest)
+{
+    size_t i;
+    size_t j;
 
-        /* 数値を文字に変換し、結果の配列に格納する */
+    for(i = 0; i < UINT_SIZE_HASH_STATE; ++i)
+    {
         for(j = 0; j < BYTE_SIZE_UNSIGNED_INT; ++j)
         {
-
-            /* 1 バイトを 2 文字に変換 */
-            for(k = 0; k < 2; ++k)
-            {
-
-                ret = getCharCode(
-                          &(result->_buff[i * BYTE_SIZE_UNSIGNED_INT * 2 + j * 2 + k]),
-                          (hashBytes->_buff[j] >> (4 * (1 - k))) & 0x0F
-                      );
-
-                if(ret != FUNCTION_SUCCESS)
-                {
-                    goto FINALIZE;
-                }
-
-            }
-
+            /* ビッグエンディアンの順で 1 バイトずつ取り出す */
+            digest[i * BYTE_SIZE_UNSIGNED_INT + j] = (unsigned char)((state[i] >> (BIT_SIZE_1BYTE * (BYTE_SIZE_UNSIGNED_INT - 1 - j))) & MASK_1BYTE);
         }
+    }
+}
 
+/*!
+@brief パディングを行って最終ブロックを処理し、ハッシュ値を 16 進数文字列で返す。
+@details 処理後のコンテキストは再度 sha256Init を呼び出すまで使用できない。
+@param [in, out] context sha256Init で初期化済みのコンテキスト
+@param [out] result 最終的に算出されたハッシュ値を受けとる変数（BYTE_SIZE_HASH_LENGTH 以上の長さを持つこと）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER result の長さが足りない場合
+*/
+int sha256Final(SHA256Context *context, HashBuffer *result)
+{
+    unsigned char digest[BYTE_SIZE_HASH_DIGEST];
+
+    if(result == NULL || result->_len < BYTE_SIZE_HASH_LENGTH)
+    {
+        return INCORRECT_PARAMETER;
     }
 
+    sha256FinalDigest(context, digest);
+
+    /* 数値を文字に変換し、結果の配列に格納する */
+    encodeHex(result->_buff, digest, BYTE_SIZE_HASH_DIGEST);
     result->_len = BYTE_SIZE_HASH_LENGTH;
 
-FINALIZE:
+    return FUNCTION_SUCCESS;
+}
 
-    /* メモリ解放 */
-    if(orgLength != NULL)
-    {
-        free(orgLength);
-        orgLength = NULL;
-    }
+/*!
+@brief パディングを行って最終ブロックを処理し、ハッシュ値をバイト配列で返す。
+@details 処理後のコンテキストは再度 sha256Init を呼び出すまで使用できない。
+@param [in, out] context sha256Init で初期化済みのコンテキスト
+@param [out] digest ハッシュ値を受けとる配列（BYTE_SIZE_HASH_DIGEST バイト）
+*/
+void sha256FinalDigest(SHA256Context *context, unsigned char *digest)
+{
+    unsigned char finalBlocks[BYTE_SIZE_MESSAGE_BLOCK * 2];
+    size_t blockCount;
 
-    if(resizedByteArray != NULL)
-    {
-        free(resizedByteArray);
-        resizedByteArray = NULL;
-    }
+    blockCount = _buildFinalBlocks(finalBlocks, context->_block, context->_blockLength, context->_totalLength);
+    computation(context->_state, finalBlocks, blockCount);
+    context->_blockLength = 0;
 
-    if(block != NULL)
-    {
-        free(block);
-        block = NULL;
-    }
+    _writeDigest(context->_state, digest);
+}
 
-    if(uIntHash != NULL)
-    {
-        free(uIntHash);
-        uIntHash = NULL;
-    }
+/*!
+@brief 可変長のバイト配列を受けてハッシュ値を返す。
+@details sha256Init / sha256Update / sha256Final を一度に呼び出す互換用の関数。
+@param [in] byteArray ハッシュ値を計算するもととなるバイト配列構造体
+@param [out] result 最終的に算出されたハッシュ値を受けとる変数
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+*/
+int hash(HashBuffer *byteArray, HashBuffer *result)
+{
+    SHA256Context context;
 
-    if(hashBytes != NULL)
-    {
-        free(hashBytes);
-        hashBytes = NULL;
-    }
+    if(byteArray == NULL) return INCORRECT_PARAMETER;
+
+    sha256Init(&context);
+    sha256Update(&context, byteArray->_buff, byteArray->_len);
 
-    return ret;
+    return sha256Final(&context, result);
 }
@@ -11,12 +11,64 @@
 
 #include "common.h"
 
+/* @name 定数マクロ定義 */
+/* @{ */
+#define BYTE_SIZE_MESSAGE_BLOCK ((size_t)64)    /*!< @brief メッセージブロックのバイト数 */
+#define UINT_SIZE_HASH_STATE ((size_t)8)        /*!< @brief ハッシュの中間状態を構成する整数値の個数 */
+/* @} */
+
+/*!
+@struct SHA256Context
+@brief ハッシュ値 (SHA-256) を逐次計算するためのコンテキスト
+@details 呼び出し元で確保した領域をそのまま使用し、内部でメモリの動的確保は行わない。
+*/
+typedef struct
+{
+    unsigned int _state[UINT_SIZE_HASH_STATE];          /*!< @brief 計算途中のハッシュ値 */
+    unsigned long long int _totalLength;                /*!< @brief これまでに入力されたデータのバイト数 */
+    size_t _blockLength;                                /*!< @brief _block に保持している未処理データのバイト数 */
+    unsigned char _block[BYTE_SIZE_MESSAGE_BLOCK];      /*!< @brief 1 ブロックに満たない未処理データ */
+} SHA256Context;
+
+/*!
+@brief ハッシュ値の逐次計算を開始するため、コンテキストを初期化する。
+@param [out] context 初期化対象のコンテキスト
+*/
+void sha256Init(SHA256Context *context);
+
+/*!
+@brief ハッシュ値の計算対象となるデータを追加する。
+@details 1 ブロックに満たない端数はコンテキスト内に保持し、次回以降の呼び出しで処理する。
+@param [in, out] context sha256Init で初期化済みのコンテキスト
+@param [in] data 追加するバイト配列
+@param length data の長さ
+*/
+void sha256Update(SHA256Context *context, const unsigned char *data, size_t length);
+
+/*!
+@brief パディングを行って最終ブロックを処理し、ハッシュ値を 16 進数文字列で返す。
+@details 処理後のコンテキストは再度 sha256Init を呼び出すまで使用できない。
+@param [in, out] context sha256Init で初期化済みのコンテキスト
+@param [out] result 最終的に算出されたハッシュ値を受けとる変数（BYTE_SIZE_HASH_LENGTH 以上の長さを持つこと）
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER result の長さが足りない場合
+*/
+int sha256Final(SHA256Context *context, HashBuffer *result);
+
+/*!
+@brief パディングを行って最終ブロックを処理し、ハッシュ値をバイト配列で返す。
+@details 処理後のコンテキストは再度 sha256Init を呼び出すまで使用できない。
+@param [in, out] context sha256Init で初期化済みのコンテキスト
+@param [out] digest ハッシュ値を受けとる配列（BYTE_SIZE_HASH_DIGEST バイト）
+*/
+void sha256FinalDigest(SHA256Context *context, unsigned char *digest);
+
 /*!
 @brief 可変長のバイト配列を受けてハッシュ値を返す。
 @param [in] byteArray ハッシュ値を計算するもととなるバイト配列構造体
 @param [out] result 最終的に算出されたハッシュ値を受けとる変数
 @retval FUNCTION_SUCCESS 正常終了
-@retval OTHER_ERROR メモリの確保に失敗した場合、ハッシュ値の格納に失敗した場合など
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
 */
 int hash(HashBuffer *byteArray, HashBuffer *result);
 
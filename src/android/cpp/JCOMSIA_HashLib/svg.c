@@ -24,6 +24,10 @@ https://github.com/libexpat/libexpat/blob/master/expat/COPYING
 #include "expat.h"
 #include "svg.h"
 
+#if !defined(JCOMSIA_DISABLE_FAST_SVG_SCAN)
+#define FAST_SVG_SCAN   /*!< @brief 想定する構成の SVG ファイルは Expat を使わずに解析する */
+#endif
+
 /*!
 @name SVG 解析用定数
 @{
@@ -61,12 +65,35 @@ static const char * const SVG_GROUP_ID_CHALKBOARD_IMAGE     = "dcp_chalkboard_im
 /*! SVG ファイルを読み込む際のバッファサイズ (1MB) */
 static const size_t BUFFER_SIZE = (1 * 1024 * 1024);
 
+/*! 画像を逐次処理する場合に SVG ファイルを読み込む際のバッファサイズ (64KB) */
+static const size_t STREAM_BUFFER_SIZE = (64 * 1024);
+
+/*! 画像を逐次処理する場合に、高速解析でデータ URL を取り除いた文書として保持する最大のバイト数 (1MB) */
+static const size_t FILTERED_DOCUMENT_MAX = (1 * 1024 * 1024);
+
 static void XMLCALL startElementHandler(void *userData, const XML_Char *elementName, const XML_Char **attributes);
 static void XMLCALL endElementHandler(void *userData, const XML_Char *elementName);
 static void XMLCALL characterDataHandler(void *userData, const XML_Char *data, int len);
 
 /*! @} */
 
+#if defined(JCOMSIA_TEST_HOOKS)
+/*!
+@brief SVG ファイルを解析した回数の累計（テスト用）
+*/
+static SVGParseStatistics svgParseStatistics = {0, 0, 0};
+
+/*!
+@brief parseWithImageHash で画像を逐次処理するか（テスト用）
+*/
+static JACIC_BOOL svgImageStreaming = JACIC_BOOL_TRUE;
+
+/*!
+@brief 想定する構成の SVG ファイルを高速解析 ( _scanFile ) で解析するか（テスト用）
+*/
+static JACIC_BOOL svgFastScan = JACIC_BOOL_TRUE;
+#endif /* JCOMSIA_TEST_HOOKS */
+
 /*!
 @name 解析に使用する定義
 @{
@@ -130,6 +157,60 @@ typedef enum
     TAG_SEARCH_MODE_CAN_NOT_REOPEN_SVG, /*!< @brief 再度 <svg> 要素が開かれた場合にのみエラーとし、それ以外は無視する。 */
 } TagSearchMode;
 
+/*!
+@enum ImageFilterState
+@brief XML パーサに渡す前のデータから、xlink:href 属性のデータ URL を探す際の状態を示す。
+*/
+typedef enum
+{
+    IMAGE_FILTER_SCAN,      /*!< @brief 空白文字（属性名の区切り）を探す */
+    IMAGE_FILTER_NAME,      /*!< @brief 属性名 xlink:href と照合する */
+    IMAGE_FILTER_EQUAL,     /*!< @brief 属性名の後の = を探す */
+    IMAGE_FILTER_QUOTE,     /*!< @brief 属性値の開始を示す引用符を探す */
+    IMAGE_FILTER_PREFIX,    /*!< @brief 属性値の先頭をデータ URL の接頭辞と照合する */
+    IMAGE_FILTER_PAYLOAD    /*!< @brief Base64 部分をデコードし、XML パーサには渡さずに取り除く */
+} ImageFilterState;
+
+/*! 取り除いたデータ URL のうち、どの要素のものか判別していない画像の最大数 */
+#define STREAMED_IMAGE_MAX 4
+
+/*!
+@struct StreamedImage
+@brief データ URL を取り除いて逐次処理した画像
+*/
+typedef struct
+{
+    size_t _offset;             /*!< @brief データ URL を取り除いた位置（XML パーサに渡したデータの先頭からのバイト数） */
+    JpegBuffer *_head;          /*!< @brief 画像の先頭部分 */
+    PrehashedImage _prehashed;  /*!< @brief 計算した画像ハッシュ値 */
+} StreamedImage;
+
+/*!
+@struct ImageFilter
+@brief XML パーサに渡す前のデータから xlink:href 属性のデータ URL を取り除き、画像を逐次処理するための構造体。
+@details 取り除いた画像は、XML パーサが開始タグを通知した時点でその位置から要素を判別する。
+*/
+typedef struct
+{
+    ImageFilterState _state;                        /*!< @brief データ URL を探す際の状態 */
+    size_t _matched;                                /*!< @brief 属性名、接頭辞のうち一致したバイト数 */
+    char _quote;                                    /*!< @brief 属性値を囲む引用符 */
+    size_t _passed;                                 /*!< @brief XML パーサに渡したバイト数 */
+    JACIC_BOOL _discard;                            /*!< @brief Base64 部分をデコードせずに読み捨てるか（メタデータのみ取得する場合） */
+
+    Base64Decoder _decoder;                         /*!< @brief 取り除いている Base64 部分のデコーダ */
+    JpegStream _stream;                             /*!< @brief デコードしている画像 */
+    unsigned char *_decoded;                        /*!< @brief デコード先のバッファ */
+
+    StreamedImage _images[STREAMED_IMAGE_MAX];      /*!< @brief 要素を判別していない画像（取り除いた順） */
+    size_t _imageCount;                             /*!< @brief _images の要素数 */
+
+    JACIC_BOOL _hasElementImage;                    /*!< @brief 直前に通知された開始タグから取り除いた画像があるか */
+    StreamedImage _elementImage;                    /*!< @brief 直前に通知された開始タグから取り除いた画像 */
+
+    JACIC_BOOL _scanning;                           /*!< @brief 高速解析中か（開始タグの画像は _settleStreamedImages ではなく _scanStartTag が取り出す） */
+} ImageFilter;
+
 /*!
 @struct ParsedResults
 @brief 解析の結果取得したデータを保存する構造体。
@@ -138,7 +219,11 @@ typedef struct
 {
     JpegBuffer *_originalImage;     /*!< @brief 原本画像 */
     JpegBuffer *_chalkboardImage;   /*!< @brief 黒板画像 */
+    PrehashedImage _originalPrehashed;      /*!< @brief 原本画像を逐次処理した場合の画像ハッシュ値 */
+    PrehashedImage _chalkboardPrehashed;    /*!< @brief 黒板画像を逐次処理した場合の画像ハッシュ値 */
     JACIC_BOOL _hasAnnotation;      /*!< @brief 注釈レイヤを検出したかどうか */
+    JACIC_BOOL _hasOriginalImage;   /*!< @brief 原本画像レイヤの画像要素を検出したかどうか */
+    JACIC_BOOL _hasChalkboard;      /*!< @brief 黒板画像レイヤを検出したかどうか（メタデータのみ取得する場合） */
 
     char *_vender;                  /*!< @brief 作成したソフトウェアベンダー（存在確認のみ） */
     char *_software;                /*!< @brief 作成したソフトウェア名（存在確認のみ） */
@@ -176,8 +261,50 @@ typedef struct
 {
     ParseCondition _condition;  /*!< パース中の条件を示す構造体 */
     ParsedResults _results;     /*!< 解析結果を格納する構造体 */
+    ImageFilter *_filter;       /*!< 画像を逐次処理する場合のフィルタ（画像全体をデコードする場合は NULL ） */
+    JACIC_BOOL _probing;        /*!< メタデータのみ取得する場合は JACIC_BOOL_TRUE （画像をデコードせず、黒板画像レイヤを検出した時点で解析を終了する） */
 } ParseInfo;
 
+#if defined(FAST_SVG_SCAN)
+
+/*! 高速解析で扱う要素の深さの最大値 */
+#define FAST_SCAN_DEPTH_MAX 64
+
+/*! 高速解析で扱う 1 要素あたりの属性数の最大値 */
+#define FAST_SCAN_ATTRIBUTE_MAX 32
+
+/*!
+@enum FastScanStatus
+@brief 高速解析の各処理の結果を示す。
+*/
+typedef enum
+{
+    FAST_SCAN_CONTINUE,     /*!< @brief 続きを解析する */
+    FAST_SCAN_STOPPED,      /*!< @brief ハンドラが解析を中断した（ `parseInfo._resultCode` が結果となる） */
+    FAST_SCAN_UNSUPPORTED   /*!< @brief 想定する構成以外の記述を検出した（ Expat で解析し直す） */
+} FastScanStatus;
+
+/*!
+@struct FastScanner
+@brief Expat を使わずに SVG ファイルを解析する際の状態を保存する構造体。
+@details 要素名と属性値は、文書を読み込んだ領域に終端文字を書き込んで参照する。
+*/
+typedef struct
+{
+    ParseInfo *_parseInfo;                                      /*!< @brief ハンドラに渡すユーザー定義オブジェクト */
+    char *_data;                                                /*!< @brief 文書全体（画像を逐次処理する場合はデータ URL を取り除いた文書。末尾に終端文字を付加する） */
+    size_t _length;                                             /*!< @brief 文書の長さ */
+    size_t _position;                                           /*!< @brief 解析中の位置 */
+
+    const char *_openElements[FAST_SCAN_DEPTH_MAX];             /*!< @brief 開いている要素の名前 */
+    size_t _depth;                                              /*!< @brief 開いている要素の数 */
+    JACIC_BOOL _rootClosed;                                     /*!< @brief ルート要素を閉じたか */
+
+    const XML_Char *_attributes[FAST_SCAN_ATTRIBUTE_MAX * 2 + 1];   /*!< @brief ハンドラに渡す属性名と属性値の配列 */
+} FastScanner;
+
+#endif
+
 /*!
 @brief ParseInfo 構造体の初期化を行う。
 @param parseInfo 初期化対象の構造体
@@ -195,7 +322,11 @@ static void _initParseInfo(ParseInfo *parseInfo)
 
     parseInfo->_results._originalImage = NULL;
     parseInfo->_results._chalkboardImage = NULL;
+    parseInfo->_results._originalPrehashed._hashed = JACIC_BOOL_FALSE;
+    parseInfo->_results._chalkboardPrehashed._hashed = JACIC_BOOL_FALSE;
     parseInfo->_results._hasAnnotation = JACIC_BOOL_FALSE;
+    parseInfo->_results._hasOriginalImage = JACIC_BOOL_FALSE;
+    parseInfo->_results._hasChalkboard = JACIC_BOOL_FALSE;
 
     parseInfo->_results._vender = NULL;
     parseInfo->_results._software = NULL;
@@ -204,6 +335,9 @@ static void _initParseInfo(ParseInfo *parseInfo)
     parseInfo->_results._hashCode = NULL;
 
     parseInfo->_results._resultCode = SVG_SUCCESS;
+
+    parseInfo->_filter = NULL;
+    parseInfo->_probing = JACIC_BOOL_FALSE;
 }
 
 /*!
@@ -214,13 +348,13 @@ static void _deinitParseInfo(ParseInfo *parseInfo)
 {
     parseInfo->_condition._parser = NULL;
 
-    _SECURE_FREE(parseInfo->_results._originalImage);
-    _SECURE_FREE(parseInfo->_results._chalkboardImage);
+    _SECURE_RELEASE(parseInfo->_results._originalImage);
+    _SECURE_RELEASE(parseInfo->_results._chalkboardImage);
     _SECURE_FREE(parseInfo->_results._vender);
     _SECURE_FREE(parseInfo->_results._software);
     _SECURE_FREE(parseInfo->_results._metaVersion);
     _SECURE_FREE(parseInfo->_results._stdVersion);
-    _SECURE_FREE(parseInfo->_results._hashCode);
+    _SECURE_RELEASE(parseInfo->_results._hashCode);
 }
 
 /*! @} */
@@ -284,101 +418,149 @@ SVGResult _validateMetadata(ParsedResults results);
 */
 JpegBuffer *_dataURLToImageData(const XML_Char *srcStr);
 
-/*! @} */
-
 /*!
-@brief SVG ファイルを解析して各種データを取得する。
-@details
-オリジナル画像は必ず存在しなければならない。
-黒板画像とハッシュ値は場合によっては存在しないことがある。
-
-@param [in] filePath SVG 画像のファイルパス
-@param [out] imageBuffer オリジナル画像領域の画像データ
-@param [out] chalkboardBuffer 黒板画像領域の画像データ
-@param [out] hashBuffer メタデータ領域のハッシュ値
+@brief 画像を逐次処理するためのフィルタを初期化する。
+@param [out] filter 初期化対象のフィルタ
+@retval SVG_SUCCESS 正常終了
+@retval SVG_FAILURE_OTHER_ERROR メモリ確保に失敗した場合
+*/
+SVGResult _initImageFilter(ImageFilter *filter);
 
-@retval SVG_SUCCESS                                     正常終了
+/*!
+@brief 画像を逐次処理するためのフィルタが確保している領域を解放する。
+@param [in, out] filter 解放対象のフィルタ
+*/
+void _releaseImageFilter(ImageFilter *filter);
 
-@retval SVG_FAILURE_INCORRECT_PARAMETER                 不正な引数を受け取った
-@retval SVG_FAILURE_FILE_CAN_NOT_OPEN                   SVG ファイルを開くことができなかった
-@retval SVG_FAILURE_FILE_READ_ERROR                     SVG ファイルの読み込み時にエラーが発生した
-@retval SVG_FAILURE_FILE_CLOSE_FAILED                   SVG ファイルのクローズ時にエラーが発生した
-@retval SVG_FAILURE_PARSE_ERROR                         SVG ファイルの解析に関して XML パーサからエラーが返された
-@retval SVG_FAILURE_BROKEN_STRUCTURE                    SVG の構造が壊れている
+/*!
+@brief 読み込んだデータから xlink:href 属性のデータ URL を取り除き、画像を逐次処理しながら XML パーサに渡す。
+@details 取り除いた結果は data に上書きする。データ URL を取り除くたびに、そこまでのデータを XML パーサに渡して要素を判別できるようにする。
+@param [in, out] parseInfo フィルタとパーサーを含むユーザー定義オブジェクト
+@param [in, out] data 読み込んだデータ
+@param len data の長さ
+@param isFinal 最後のデータであるか
+@return XML パーサの処理結果。逐次処理できないデータを検出した場合は `parseInfo._resultCode` に SVG_STREAMING_UNSUPPORTED を設定して XML_STATUS_ERROR を返す。
+*/
+enum XML_Status _parseFiltered(ParseInfo *parseInfo, char *data, size_t len, XML_Bool isFinal);
 
-@retval SVG_FAILURE_METADATA_BROKEN_STRUCTURE           メタデータの構成が壊れている
-@retval SVG_FAILURE_METADATA_INCORRECT_VENDER           「ベンダー名」が正しくない
-@retval SVG_FAILURE_METADATA_INCORRECT_SOFTWARE         「ソフトウェア名」が正しくない
-@retval SVG_FAILURE_METADATA_INCORRECT_META_VERSION     「メタデータバージョン」が正しくない
-@retval SVG_FAILURE_METADATA_INCORRECT_STANDARD_VERSION 「適用基準バージョン」が正しくない
-@retval SVG_FAILURE_METADATA_INCORRECT_HASHCODE             「ハッシュコード」が正しくない
+/*!
+@brief 通知された開始タグから取り除いた画像を、その要素の画像として取り出す。
+@details 前の開始タグから取り出した画像が使われずに残っている場合は解放する。
+@param [in, out] parseInfo フィルタとパーサーを含むユーザー定義オブジェクト
+@retval SVG_SUCCESS 正常終了（取り除いた画像がない場合を含む）
+@retval SVG_STREAMING_UNSUPPORTED 開始タグ以外の位置から取り除いていた場合、1 つの開始タグから複数取り除いていた場合
+*/
+SVGResult _settleStreamedImages(ParseInfo *parseInfo);
 
-@retval SVG_FAILURE_INCORRECT_IMAGE_DETECTED            正しくない画像を検出した
+/*!
+@brief <image> 要素の画像データを取得する。
+@details 開始タグから取り除いた画像があればそれを返し、なければ srcStr を Base64 デコードする。
+@param [in, out] parseInfo フィルタを含むユーザー定義オブジェクト
+@param srcStr xlink:href 属性から取得したデータ URL 形式の文字列
+@param attributes 文字列として属性名と属性値が交互に入っている配列
+@param [out] imageData 画像データ。変換途中で問題が発生した場合は NULL
+@param [out] prehashed 逐次処理した場合の画像ハッシュ値
+@retval SVG_SUCCESS 正常終了（ imageData が NULL の場合を含む）
+@retval SVG_STREAMING_UNSUPPORTED 取り除いた位置が xlink:href 属性の値であることを確認できなかった場合
+*/
+SVGResult _takeImageData(ParseInfo *parseInfo, const XML_Char *srcStr, const XML_Char **attributes, JpegBuffer **imageData, PrehashedImage *prehashed);
 
-@retval SVG_FAILURE_ORIGINAL_IMAGE_DOES_NOT_EXIST       必須要素の原本画像を取得できなかった
-@retval SVG_FAILURE_COULD_NOT_READ_ORIGINAL_IMAGE       原本画像の読み取りに失敗した
+#if defined(FAST_SVG_SCAN)
+/*!
+@brief SVG ファイル全体を読み込み、Expat を使わずに解析する。
+@details `<` の位置を順に探して要素を切り出し、Expat と同じ順序・内容で各ハンドラを呼び出す。
+DOCTYPE 宣言、処理命令、CDATA セクション、実体参照など、想定する構成以外の記述を検出した場合は
+parseInfo を初期状態に戻して JACIC_BOOL_FALSE を返すため、Expat で解析し直すこと。
+`parseInfo._filter` が設定されている場合は、ファイル全体を読み込まずに STREAM_BUFFER_SIZE ずつ読み込みながら
+xlink:href 属性のデータ URL を取り除いて逐次処理し ( _readFilteredDocument ) 、残りの文書を解析する。
+取り除いた画像は、取り除いた位置を含む開始タグの要素の画像とする。
+@param [in] filePath SVG 画像のファイルパス
+@param [in, out] parseInfo パーサーを含むユーザー定義オブジェクト
+@param [out] result 解析結果（ JACIC_BOOL_TRUE を返した場合のみ設定する）
+@retval JACIC_BOOL_TRUE 解析した（ハンドラが解析を中断した場合を含む）
+@retval JACIC_BOOL_FALSE 解析できなかった
+*/
+JACIC_BOOL _scanFile(const char *filePath, ParseInfo *parseInfo, SVGResult *result);
+#endif
 
-@retval SVG_FAILURE_CHALKBOARD_IMAGE_DOES_NOT_EXIST     必須となる条件のうえで黒板画像を取得できなかった
-@retval SVG_FAILURE_COULD_NOT_READ_CHALKBOARD_IMAGE     黒板画像の読み取りに失敗した
+/*! @} */
 
-@retval SVG_FAILURE_OTHER_ERROR                         メモリ確保に失敗したなど、その他のエラー
+/*!
+@brief SVG ファイルを読み込みながら Expat で解析する。
+@details `parseInfo._filter` が設定されている場合は、データ URL を取り除きながら解析する（ _parseFiltered ）。
+@param [in] filePath SVG 画像のファイルパス
+@param [in, out] parseInfo パーサーを含むユーザー定義オブジェクト
+@retval SVG_SUCCESS 正常終了
+@retval その他 parse, parseWithImageHash と同じ
 */
-SVGResult parse(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **chalkboardBuffer, HashBuffer **hashBuffer)
+static SVGResult _parseWithExpat(const char *filePath, ParseInfo *parseInfo)
 {
     SVGResult ret = SVG_SUCCESS;
     XML_Bool isFinal;
     void *buffer = NULL;
     FILE *fp = NULL;
-    XML_Parser parser;
-    ParseInfo parseInfo;
-
-    if(imageBuffer == NULL || *imageBuffer != NULL
-            || chalkboardBuffer == NULL || *chalkboardBuffer != NULL
-            || hashBuffer == NULL || *hashBuffer != NULL)
-    {
-        /* 引数不正 */
-        return SVG_FAILURE_INCORRECT_PARAMETER;
-    }
-
-    if((parser = XML_ParserCreate(NULL)) == NULL)
-    {
-        return SVG_FAILURE_OTHER_ERROR;
-    }
-
-    _initParseInfo(&parseInfo);
-    parseInfo._condition._parser = parser;
-
-    XML_SetUserData(parser, &parseInfo);
-    XML_SetElementHandler(parser, startElementHandler, endElementHandler);
-    XML_SetCharacterDataHandler(parser, characterDataHandler);
-
-    if((fp = fopen(filePath, "rb")) == NULL)
+    JpegBuffer *mapped = NULL;  /* マップしたファイル */
+    size_t mappedOffset = 0;    /* マップしたファイルのうち解析済みのバイト数 */
+    size_t bufferSize = (parseInfo->_filter != NULL && parseInfo->_filter->_discard == JACIC_BOOL_FALSE) ? STREAM_BUFFER_SIZE : BUFFER_SIZE;
+    XML_Parser parser = parseInfo->_condition._parser;
+
+    /*
+     マップできる場合は、読み込み用のバッファを使わずにマップした領域を直接解析する
+     画像を逐次処理する場合は、ファイル全体を参照しないよう小さいバッファで読み込む
+     データ URL を読み捨てる場合は、文字データの分割位置が parse と同じになるよう BUFFER_SIZE ずつ読み込む
+     */
+    if(parseInfo->_filter != NULL || mapFileBinaryData(filePath, &mapped) != FUNCTION_SUCCESS)
     {
-        return SVG_FAILURE_FILE_CAN_NOT_OPEN;
-    }
+        if((fp = fopen(filePath, "rb")) == NULL)
+        {
+            return SVG_FAILURE_FILE_CAN_NOT_OPEN;
+        }
 
-    buffer = malloc(BUFFER_SIZE);
-    if(buffer == NULL)
-    {
-        ret = SVG_FAILURE_OTHER_ERROR;
-        goto FINALIZE;
+        buffer = malloc(bufferSize);
+        if(buffer == NULL)
+        {
+            ret = SVG_FAILURE_OTHER_ERROR;
+            goto FINALIZE;
+        }
     }
 
     do
     {
         size_t len;
+        const char *data;
         enum XML_Status status;
 
-        len = fread(buffer, 1, BUFFER_SIZE, fp);
-        if(ferror(fp))
+        if(mapped != NULL)
         {
-            ret = SVG_FAILURE_FILE_READ_ERROR;
-            goto FINALIZE;
+            /* XML_Parse に渡す長さは int のため、BUFFER_SIZE ずつ渡す */
+            data = (const char *)&(mapped->_buff[mappedOffset]);
+            len = mapped->_len - mappedOffset;
+            if(BUFFER_SIZE < len) len = BUFFER_SIZE;
+
+            mappedOffset += len;
+            isFinal = mappedOffset == mapped->_len;
         }
+        else
+        {
+            len = fread(buffer, 1, bufferSize, fp);
+            if(ferror(fp))
+            {
+                ret = SVG_FAILURE_FILE_READ_ERROR;
+                goto FINALIZE;
+            }
 
-        isFinal = len < BUFFER_SIZE;
+            data = (const char *)buffer;
+            isFinal = len < bufferSize;
+        }
 
-        status = XML_Parse(parser, buffer, (int)len, isFinal);
+        if(parseInfo->_filter != NULL)
+        {
+            status = _parseFiltered(parseInfo, buffer, len, isFinal);
+        }
+        else
+        {
+            status = XML_Parse(parser, data, (int)len, isFinal);
+        }
         if(status == XML_STATUS_SUSPENDED)
         {
             /* 手動で中断した場合 */
@@ -396,9 +578,9 @@ SVGResult parse(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **cha
 #endif
             XML_StopParser(parser, XML_FALSE);
 
-            if(parseInfo._results._resultCode != SVG_SUCCESS)
+            if(parseInfo->_results._resultCode != SVG_SUCCESS)
             {
-                ret = parseInfo._results._resultCode;
+                ret = parseInfo->_results._resultCode;
             }
             else
             {
@@ -413,6 +595,92 @@ SVGResult parse(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **cha
 
     } while(!isFinal);
 
+FINALIZE:
+    /* メモリ解放 */
+    _SECURE_FREE(buffer);
+    releaseFileBinaryData(&mapped);
+
+    /* ファイルクローズ */
+    if(fp != NULL)
+    {
+        if(fclose(fp) == EOF)
+        {
+            /* ファイルクローズに失敗 */
+            ret = SVG_FAILURE_FILE_CLOSE_FAILED;
+        }
+
+        fp = NULL;
+    }
+
+    return ret;
+}
+
+/*!
+@brief SVG ファイルを解析して各種データを取得する。
+@details prehashedImages を指定した場合は画像を逐次処理し、parseWithImageHash の処理を行う。
+指定しない場合は parse の処理を行う。
+@param [in] filePath SVG 画像のファイルパス
+@param [out] imageBuffer オリジナル画像領域の画像データ
+@param [out] chalkboardBuffer 黒板画像領域の画像データ
+@param [out] hashBuffer メタデータ領域のハッシュ値
+@param [out] prehashedImages オリジナル画像、黒板画像の順に計算した画像ハッシュ値（ 2 要素）。画像全体をデコードする場合は NULL
+@return parse, parseWithImageHash と同じ
+*/
+static SVGResult _parseFile(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **chalkboardBuffer, HashBuffer **hashBuffer, PrehashedImage *prehashedImages)
+{
+    SVGResult ret = SVG_SUCCESS;
+    JACIC_BOOL scanned = JACIC_BOOL_FALSE;
+    XML_Parser parser;
+    ParseInfo parseInfo;
+    ImageFilter filter;
+
+    if(imageBuffer == NULL || *imageBuffer != NULL
+            || chalkboardBuffer == NULL || *chalkboardBuffer != NULL
+            || hashBuffer == NULL || *hashBuffer != NULL)
+    {
+        /* 引数不正 */
+        return SVG_FAILURE_INCORRECT_PARAMETER;
+    }
+
+    if((parser = XML_ParserCreate(NULL)) == NULL)
+    {
+        return SVG_FAILURE_OTHER_ERROR;
+    }
+
+    _initParseInfo(&parseInfo);
+    parseInfo._condition._parser = parser;
+
+    XML_SetUserData(parser, &parseInfo);
+    XML_SetElementHandler(parser, startElementHandler, endElementHandler);
+    XML_SetCharacterDataHandler(parser, characterDataHandler);
+
+    if(prehashedImages != NULL)
+    {
+        ret = _initImageFilter(&filter);
+        if(ret != SVG_SUCCESS) goto FINALIZE;
+
+        parseInfo._filter = &filter;
+    }
+
+#if defined(FAST_SVG_SCAN)
+    /* 想定する構成の SVG ファイルであれば、Expat を使わずに解析する（画像を逐次処理する場合も同じ） */
+    scanned = _scanFile(filePath, &parseInfo, &ret);
+#endif
+
+    if(scanned == JACIC_BOOL_FALSE)
+    {
+        ret = _parseWithExpat(filePath, &parseInfo);
+    }
+
+    if(ret != SVG_SUCCESS) goto FINALIZE;
+
+    if(parseInfo._filter != NULL && parseInfo._filter->_imageCount != 0)
+    {
+        /* 最後の開始タグより後（文字データ、コメントなど）から取り除いたデータ URL がある */
+        ret = SVG_STREAMING_UNSUPPORTED;
+        goto FINALIZE;
+    }
+
     /* オリジナル画像は必須 */
     if(parseInfo._results._originalImage != NULL)
     {
@@ -458,25 +726,22 @@ SVGResult parse(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **cha
         }
     }
 
+    if(prehashedImages != NULL)
+    {
+        prehashedImages[0] = parseInfo._results._originalPrehashed;
+        prehashedImages[1] = parseInfo._results._chalkboardPrehashed;
+    }
+
 FINALIZE:
     /* メモリ解放 */
 
-    _deinitParseInfo(&parseInfo);
-
-    _SECURE_FREE(buffer);
-
-    /* ファイルクローズ */
-    if(fp != NULL)
+    if(parseInfo._filter != NULL)
     {
-        if(fclose(fp) == EOF)
-        {
-            /* ファイルクローズに失敗 */
-            ret = SVG_FAILURE_FILE_CLOSE_FAILED;
-        }
-
-        fp = NULL;
+        _releaseImageFilter(parseInfo._filter);
     }
 
+    _deinitParseInfo(&parseInfo);
+
     XML_ParserFree(parser);
     parser = NULL;
 
@@ -484,24 +749,309 @@ FINALIZE:
 }
 
 /*!
-@brief XML 解析中、タグの開始部分に到達した場合に呼び出される。
-@details 属性値はタグの開始部分に含まれるため、ここで属性値をすべて読み取る。
-Expat のパーサに渡され、フレームワーク内部からコールされる。
-*/
-static void XMLCALL startElementHandler(void *userData, const XML_Char *elementName, const XML_Char **attributes)
-{
-    ParseInfo *parseInfo = userData;
+@brief SVG ファイルを解析して各種データを取得する。
+@details
+オリジナル画像は必ず存在しなければならない。
+黒板画像とハッシュ値は場合によっては存在しないことがある。
+ファイルをマップできる場合 ( mapFileBinaryData ) は、読み込み用のバッファを使わずにマップした領域を解析する。
+SVG 工事写真として想定する構成の場合は、Expat を使わずに高速解析 ( _scanFile ) で解析する。結果は Expat で解析した場合と同じとなる。
 
-    NextExpectedTagType nextExpectedTag = parseInfo->_condition._nextExpectedTagType;
-    TagSearchMode searchMode = parseInfo->_condition._tagSearchMode;
+@param [in] filePath SVG 画像のファイルパス
+@param [out] imageBuffer オリジナル画像領域の画像データ
+@param [out] chalkboardBuffer 黒板画像領域の画像データ
+@param [out] hashBuffer メタデータ領域のハッシュ値
 
-    (parseInfo->_condition._currentTagLevel)++;
+@retval SVG_SUCCESS                                     正常終了
 
-    if(searchMode == TAG_SEARCH_MODE_CAN_NOT_REOPEN_SVG)
-    {
-        /* すでに <svg> 要素の探索を終了している場合 */
-        if(strcmp(elementName, SVG_TAG_NAME_ROOT) == 0) {
-            /* <svg> */
+@retval SVG_FAILURE_INCORRECT_PARAMETER                 不正な引数を受け取った
+@retval SVG_FAILURE_FILE_CAN_NOT_OPEN                   SVG ファイルを開くことができなかった
+@retval SVG_FAILURE_FILE_READ_ERROR                     SVG ファイルの読み込み時にエラーが発生した
+@retval SVG_FAILURE_FILE_CLOSE_FAILED                   SVG ファイルのクローズ時にエラーが発生した
+@retval SVG_FAILURE_PARSE_ERROR                         SVG ファイルの解析に関して XML パーサからエラーが返された
+@retval SVG_FAILURE_BROKEN_STRUCTURE                    SVG の構造が壊れている
+
+@retval SVG_FAILURE_METADATA_BROKEN_STRUCTURE           メタデータの構成が壊れている
+@retval SVG_FAILURE_METADATA_INCORRECT_VENDER           「ベンダー名」が正しくない
+@retval SVG_FAILURE_METADATA_INCORRECT_SOFTWARE         「ソフトウェア名」が正しくない
+@retval SVG_FAILURE_METADATA_INCORRECT_META_VERSION     「メタデータバージョン」が正しくない
+@retval SVG_FAILURE_METADATA_INCORRECT_STANDARD_VERSION 「適用基準バージョン」が正しくない
+@retval SVG_FAILURE_METADATA_INCORRECT_HASHCODE             「ハッシュコード」が正しくない
+
+@retval SVG_FAILURE_INCORRECT_IMAGE_DETECTED            正しくない画像を検出した
+
+@retval SVG_FAILURE_ORIGINAL_IMAGE_DOES_NOT_EXIST       必須要素の原本画像を取得できなかった
+@retval SVG_FAILURE_COULD_NOT_READ_ORIGINAL_IMAGE       原本画像の読み取りに失敗した
+
+@retval SVG_FAILURE_CHALKBOARD_IMAGE_DOES_NOT_EXIST     必須となる条件のうえで黒板画像を取得できなかった
+@retval SVG_FAILURE_COULD_NOT_READ_CHALKBOARD_IMAGE     黒板画像の読み取りに失敗した
+
+@retval SVG_FAILURE_OTHER_ERROR                         メモリ確保に失敗したなど、その他のエラー
+*/
+SVGResult parse(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **chalkboardBuffer, HashBuffer **hashBuffer)
+{
+#if defined(JCOMSIA_TEST_HOOKS)
+    __atomic_add_fetch(&svgParseStatistics._parseCount, 1, __ATOMIC_RELAXED);
+#endif
+
+    return _parseFile(filePath, imageBuffer, chalkboardBuffer, hashBuffer, NULL);
+}
+
+/*!
+@brief SVG ファイルを解析して各種データを取得する。画像は Base64 デコードしながら逐次処理し、画像全体をメモリ上に展開しない。
+@details
+xlink:href 属性のデータ URL は XML パーサに渡す前に取り除き、デコードした画像のうち先頭部分 (SOI ～ SOS マーカー) のみを保持する。
+圧縮データ (SOS ～ EOI) は画像ハッシュ値の計算に使用して破棄するため、取得した画像データは prehashedImages とともに検証処理に渡すこと。
+SVG 工事写真として想定する構成の場合は、データ URL を取り除きながら STREAM_BUFFER_SIZE ずつ読み込んだ文書を高速解析 ( _scanFile ) で解析する。
+ファイル全体を読み込まないため、確保するメモリはファイルサイズによらない。
+取り除いたデータ URL がどの要素のものか判別できない場合など、parse と同じ結果を得られない場合は SVG_STREAMING_UNSUPPORTED を返す。
+
+@param [in] filePath SVG 画像のファイルパス
+@param [out] imageBuffer オリジナル画像領域の画像データ（先頭部分）
+@param [out] chalkboardBuffer 黒板画像領域の画像データ（先頭部分）
+@param [out] hashBuffer メタデータ領域のハッシュ値
+@param [out] prehashedImages オリジナル画像、黒板画像の順に計算した画像ハッシュ値（ 2 要素）
+
+@retval SVG_STREAMING_UNSUPPORTED 逐次処理できない記述を検出した
+@retval その他 parse と同じ
+*/
+SVGResult parseWithImageHash(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **chalkboardBuffer, HashBuffer **hashBuffer, PrehashedImage *prehashedImages)
+{
+    if(prehashedImages == NULL)
+    {
+        /* 引数不正 */
+        return SVG_FAILURE_INCORRECT_PARAMETER;
+    }
+
+#if defined(JCOMSIA_TEST_HOOKS)
+    __atomic_add_fetch(&svgParseStatistics._streamingCount, 1, __ATOMIC_RELAXED);
+    if(__atomic_load_n(&svgImageStreaming, __ATOMIC_RELAXED) == JACIC_BOOL_FALSE)
+    {
+        return SVG_STREAMING_UNSUPPORTED;
+    }
+#endif
+
+    return _parseFile(filePath, imageBuffer, chalkboardBuffer, hashBuffer, prehashedImages);
+}
+
+/*!
+@brief SVG ファイルからメタデータと黒板画像レイヤの有無のみを取得する。
+@param [in] filePath SVG 画像のファイルパス
+@param [out] metadata 取得したメタデータ
+@param filtering JACIC_BOOL_TRUE の場合は xlink:href 属性のデータ URL を XML パーサに渡す前に読み捨てる。
+読み捨てたデータ URL がどの要素のものか判別できない場合は SVG_STREAMING_UNSUPPORTED を返す。
+@return probeMetadata と同じ
+*/
+static SVGResult _probeFile(const char *filePath, SVGMetadata *metadata, JACIC_BOOL filtering)
+{
+    SVGResult ret = SVG_SUCCESS;
+    XML_Parser parser;
+    ParseInfo parseInfo;
+    ImageFilter filter;
+
+    if((parser = XML_ParserCreate(NULL)) == NULL)
+    {
+        return SVG_FAILURE_OTHER_ERROR;
+    }
+
+    _initParseInfo(&parseInfo);
+    parseInfo._condition._parser = parser;
+    parseInfo._probing = JACIC_BOOL_TRUE;
+
+    XML_SetUserData(parser, &parseInfo);
+    XML_SetElementHandler(parser, startElementHandler, endElementHandler);
+    XML_SetCharacterDataHandler(parser, characterDataHandler);
+
+    if(filtering == JACIC_BOOL_TRUE)
+    {
+        ret = _initImageFilter(&filter);
+        if(ret != SVG_SUCCESS) goto FINALIZE;
+
+        filter._discard = JACIC_BOOL_TRUE;
+        parseInfo._filter = &filter;
+    }
+
+    ret = _parseWithExpat(filePath, &parseInfo);
+    if(ret != SVG_SUCCESS) goto FINALIZE;
+
+    /* 黒板画像レイヤで終了した場合、それ以前の構成は開始タグごとに確認済み */
+    if(parseInfo._results._hasChalkboard == JACIC_BOOL_FALSE)
+    {
+        if(parseInfo._filter != NULL && parseInfo._filter->_imageCount != 0)
+        {
+            /* 最後の開始タグより後（文字データ、コメントなど）から読み捨てたデータ URL がある */
+            ret = SVG_STREAMING_UNSUPPORTED;
+            goto FINALIZE;
+        }
+
+        /* parse と同様に、原本画像は必須、黒板画像はハッシュコードがない場合のみ任意 */
+        if(parseInfo._results._hasOriginalImage == JACIC_BOOL_FALSE)
+        {
+            ret = SVG_FAILURE_ORIGINAL_IMAGE_DOES_NOT_EXIST;
+            goto FINALIZE;
+        }
+        if(parseInfo._results._hashCode != NULL)
+        {
+            ret = SVG_FAILURE_CHALKBOARD_IMAGE_DOES_NOT_EXIST;
+            goto FINALIZE;
+        }
+    }
+
+    /* 取得したメタデータを呼び出し元に移す */
+    metadata->_vender = parseInfo._results._vender;
+    metadata->_software = parseInfo._results._software;
+    metadata->_metaVersion = parseInfo._results._metaVersion;
+    metadata->_stdVersion = parseInfo._results._stdVersion;
+    metadata->_hashCode = parseInfo._results._hashCode;
+    metadata->_hasChalkboard = parseInfo._results._hasChalkboard;
+
+    parseInfo._results._vender = NULL;
+    parseInfo._results._software = NULL;
+    parseInfo._results._metaVersion = NULL;
+    parseInfo._results._stdVersion = NULL;
+    parseInfo._results._hashCode = NULL;
+
+FINALIZE:
+    /* メモリ解放 */
+
+    if(parseInfo._filter != NULL)
+    {
+        _releaseImageFilter(parseInfo._filter);
+    }
+
+    _deinitParseInfo(&parseInfo);
+
+    XML_ParserFree(parser);
+    parser = NULL;
+
+    return ret;
+}
+
+/*!
+@brief SVG ファイルからメタデータと黒板画像レイヤの有無のみを取得する。
+@details
+xlink:href 属性のデータ URL は XML パーサに渡す前に読み捨て、画像はデコードしない。
+黒板画像レイヤの開始タグを検出した時点で解析を終了するため、以降のデータは読み込まない。
+読み捨てたデータ URL がどの要素のものか判別できない場合は、データ URL も XML パーサに渡して解析し直す。
+
+@param [in] filePath SVG 画像のファイルパス
+@param [out] metadata 取得したメタデータ。使い終わったら releaseSVGMetadata で解放すること。
+
+@retval その他 parse と同じ（ SVG_FAILURE_COULD_NOT_READ_ORIGINAL_IMAGE, SVG_FAILURE_COULD_NOT_READ_CHALKBOARD_IMAGE は返さない）
+*/
+SVGResult probeMetadata(const char *filePath, SVGMetadata *metadata)
+{
+    SVGResult ret;
+
+    if(filePath == NULL || metadata == NULL)
+    {
+        /* 引数不正 */
+        return SVG_FAILURE_INCORRECT_PARAMETER;
+    }
+
+    metadata->_vender = NULL;
+    metadata->_software = NULL;
+    metadata->_metaVersion = NULL;
+    metadata->_stdVersion = NULL;
+    metadata->_hashCode = NULL;
+    metadata->_hasChalkboard = JACIC_BOOL_FALSE;
+
+    ret = _probeFile(filePath, metadata, JACIC_BOOL_TRUE);
+    if(ret == SVG_STREAMING_UNSUPPORTED)
+    {
+        ret = _probeFile(filePath, metadata, JACIC_BOOL_FALSE);
+    }
+
+    return ret;
+}
+
+void releaseSVGMetadata(SVGMetadata *metadata)
+{
+    if(metadata == NULL) return;
+
+    _SECURE_FREE(metadata->_vender);
+    _SECURE_FREE(metadata->_software);
+    _SECURE_FREE(metadata->_metaVersion);
+    _SECURE_FREE(metadata->_stdVersion);
+    _SECURE_RELEASE(metadata->_hashCode);
+    metadata->_hasChalkboard = JACIC_BOOL_FALSE;
+}
+
+#if defined(JCOMSIA_TEST_HOOKS)
+
+/*!
+@brief resetSVGParseStatistics を呼び出してからの、SVG ファイルを解析した回数の累計を返す（テスト用）。
+@param [out] statistics 累計を受けとる構造体
+*/
+void getSVGParseStatistics(SVGParseStatistics *statistics)
+{
+    if(statistics == NULL) return;
+
+    statistics->_parseCount = __atomic_load_n(&svgParseStatistics._parseCount, __ATOMIC_RELAXED);
+    statistics->_streamingCount = __atomic_load_n(&svgParseStatistics._streamingCount, __ATOMIC_RELAXED);
+    statistics->_scanCount = __atomic_load_n(&svgParseStatistics._scanCount, __ATOMIC_RELAXED);
+}
+
+/*!
+@brief SVG ファイルを解析した回数の累計を 0 に戻す（テスト用）。
+*/
+void resetSVGParseStatistics(void)
+{
+    __atomic_store_n(&svgParseStatistics._parseCount, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&svgParseStatistics._streamingCount, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&svgParseStatistics._scanCount, 0, __ATOMIC_RELAXED);
+}
+
+/*!
+@brief parseWithImageHash で画像を逐次処理するかを切り替える（テスト用）。
+@param enabled JACIC_BOOL_FALSE の場合は逐次処理しない
+*/
+void setSVGImageStreaming(JACIC_BOOL enabled)
+{
+    __atomic_store_n(&svgImageStreaming, enabled, __ATOMIC_RELAXED);
+}
+
+/*!
+@brief 想定する構成の SVG ファイルを高速解析で解析するかを切り替える（テスト用）。
+@param enabled JACIC_BOOL_FALSE の場合は常に Expat で解析する
+*/
+void setSVGFastScan(JACIC_BOOL enabled)
+{
+    __atomic_store_n(&svgFastScan, enabled, __ATOMIC_RELAXED);
+}
+
+#endif /* JCOMSIA_TEST_HOOKS */
+
+/*!
+@brief XML 解析中、タグの開始部分に到達した場合に呼び出される。
+@details 属性値はタグの開始部分に含まれるため、ここで属性値をすべて読み取る。
+Expat のパーサに渡され、フレームワーク内部からコールされる。
+*/
+static void XMLCALL startElementHandler(void *userData, const XML_Char *elementName, const XML_Char **attributes)
+{
+    ParseInfo *parseInfo = userData;
+
+    NextExpectedTagType nextExpectedTag = parseInfo->_condition._nextExpectedTagType;
+    TagSearchMode searchMode = parseInfo->_condition._tagSearchMode;
+
+    (parseInfo->_condition._currentTagLevel)++;
+
+    if(parseInfo->_filter != NULL && parseInfo->_filter->_scanning == JACIC_BOOL_FALSE)
+    {
+        /* 開始タグからデータ URL を取り除いていれば、この要素の画像として取り出す */
+        SVGResult settleResult = _settleStreamedImages(parseInfo);
+
+        if(settleResult != SVG_SUCCESS)
+        {
+            _abortParse(parseInfo, settleResult);
+            return;
+        }
+    }
+
+    if(searchMode == TAG_SEARCH_MODE_CAN_NOT_REOPEN_SVG)
+    {
+        /* すでに <svg> 要素の探索を終了している場合 */
+        if(strcmp(elementName, SVG_TAG_NAME_ROOT) == 0) {
+            /* <svg> */
 
             /* SVG 工事写真の仕様として、<svg> 要素は 1 ファイルに 1 個しか入っていないものとする */
             _abortParse(parseInfo, SVG_FAILURE_BROKEN_STRUCTURE);
@@ -701,7 +1251,7 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
         {
             /* 原本画像レイヤ */
 
-            if(parseInfo->_results._originalImage != NULL)
+            if(parseInfo->_results._hasOriginalImage == JACIC_BOOL_TRUE)
             {
                 /* 既に原本画像レイヤを検出済みの場合は構成エラー */
                 _abortParse(parseInfo, SVG_FAILURE_BROKEN_STRUCTURE);
@@ -716,7 +1266,7 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
         {
             /* 注釈レイヤ */
 
-            if(parseInfo->_results._originalImage == NULL)
+            if(parseInfo->_results._hasOriginalImage == JACIC_BOOL_FALSE)
             {
                 /*
                  原本画像レイヤは必須項目かつ注釈レイヤより前に来る必要があるため、
@@ -754,7 +1304,7 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
         {
             /* 黒板画像レイヤ */
 
-            if(parseInfo->_results._originalImage == NULL)
+            if(parseInfo->_results._hasOriginalImage == JACIC_BOOL_FALSE)
             {
                 /*
                  原本画像は必須項目かつ黒板画像レイヤより前に来る必要があるため、
@@ -779,6 +1329,18 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
                 return;
             }
 
+            if(parseInfo->_probing == JACIC_BOOL_TRUE)
+            {
+                /*
+                 メタデータのみ取得する場合は、黒板画像レイヤの有無が分かった時点で終了する
+                 （黒板画像レイヤがある場合、parse でも以降にメタデータを検証しない）
+                 一時停止として中断し、エラーとして扱わない
+                 */
+                parseInfo->_results._hasChalkboard = JACIC_BOOL_TRUE;
+                XML_StopParser(parseInfo->_condition._parser, XML_TRUE);
+                return;
+            }
+
             parseInfo->_condition._currentReadingLayer = CURRENT_READING_LAYER_CHALKBOARD_IMAGE;
             parseInfo->_condition._nextExpectedTagType = NEXT_EXPECTED_TAG_IMAGE;
         }
@@ -793,7 +1355,8 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
     {
         /* 画像要素 */
 
-        JpegBuffer *decodedImage;
+        JpegBuffer *decodedImage = NULL;
+        SVGResult imageResult;
         const char *base64URLImage = _getAttribute(SVG_ATTRIBUTE_NAME_IMAGE_XLINK, attributes);
 
         switch(parseInfo->_condition._currentReadingLayer)
@@ -811,7 +1374,20 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
                     return;
                 }
 
-                decodedImage = _dataURLToImageData(base64URLImage);
+                if(parseInfo->_probing == JACIC_BOOL_TRUE)
+                {
+                    /* メタデータのみ取得する場合は画像をデコードしない */
+                    parseInfo->_results._hasOriginalImage = JACIC_BOOL_TRUE;
+                    parseInfo->_condition._nextExpectedTagType = NEXT_EXPECTED_TAG_GROUP;
+                    break;
+                }
+
+                imageResult = _takeImageData(parseInfo, base64URLImage, attributes, &decodedImage, &(parseInfo->_results._originalPrehashed));
+                if(imageResult != SVG_SUCCESS)
+                {
+                    _abortParse(parseInfo, imageResult);
+                    return;
+                }
 
                 if(decodedImage == NULL)
                 {
@@ -820,6 +1396,7 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
                 }
 
                 parseInfo->_results._originalImage = decodedImage;
+                parseInfo->_results._hasOriginalImage = JACIC_BOOL_TRUE;
                 parseInfo->_condition._nextExpectedTagType = NEXT_EXPECTED_TAG_GROUP;
                 break;
 
@@ -836,7 +1413,12 @@ static void XMLCALL startElementHandler(void *userData, const XML_Char *elementN
                     return;
                 }
 
-                decodedImage = _dataURLToImageData(base64URLImage);
+                imageResult = _takeImageData(parseInfo, base64URLImage, attributes, &decodedImage, &(parseInfo->_results._chalkboardPrehashed));
+                if(imageResult != SVG_SUCCESS)
+                {
+                    _abortParse(parseInfo, imageResult);
+                    return;
+                }
 
                 if(decodedImage == NULL)
                 {
@@ -1183,3 +1765,1263 @@ FINALIZE:
 }
 
 /*! @} */
+
+/*!
+@name 画像の逐次処理（実装）
+@{
+*/
+
+/*!
+@brief XML の空白文字かどうかを返す。
+@param c 調べる文字
+@return 空白文字であれば JACIC_BOOL_TRUE
+*/
+static JACIC_BOOL _isXMLSpace(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\r' || c == '\n') ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+}
+
+/*!
+@brief データ URL の照合を最初からやり直す。
+@details 属性名は空白文字の後にのみ現れるため、c が空白文字であれば次の文字から属性名と照合する。
+@param [in, out] filter 対象のフィルタ
+@param c 照合に失敗した文字
+*/
+static void _resetImageFilter(ImageFilter *filter, char c)
+{
+    filter->_state = (_isXMLSpace(c) == JACIC_BOOL_TRUE) ? IMAGE_FILTER_NAME : IMAGE_FILTER_SCAN;
+    filter->_matched = 0;
+}
+
+/*!
+@brief XML パーサに渡す 1 文字を照合し、xlink:href 属性のデータ URL の開始を探す。
+@details 接頭辞 `data:image/jpeg;base64,` まで一致した場合、以降の Base64 部分を取り除く状態に移る。
+@param [in, out] filter 対象のフィルタ
+@param c XML パーサに渡す文字
+*/
+static void _advanceImageFilter(ImageFilter *filter, char c)
+{
+    switch(filter->_state)
+    {
+        case IMAGE_FILTER_NAME:
+            if(filter->_matched == 0 && _isXMLSpace(c) == JACIC_BOOL_TRUE) break;
+
+            if(c == SVG_ATTRIBUTE_NAME_IMAGE_XLINK[filter->_matched])
+            {
+                filter->_matched++;
+                if(SVG_ATTRIBUTE_NAME_IMAGE_XLINK[filter->_matched] == '\0')
+                {
+                    filter->_state = IMAGE_FILTER_EQUAL;
+                }
+                break;
+            }
+
+            _resetImageFilter(filter, c);
+            break;
+
+        case IMAGE_FILTER_EQUAL:
+            if(_isXMLSpace(c) == JACIC_BOOL_TRUE) break;
+
+            if(c == '=')
+            {
+                filter->_state = IMAGE_FILTER_QUOTE;
+                break;
+            }
+
+            _resetImageFilter(filter, c);
+            break;
+
+        case IMAGE_FILTER_QUOTE:
+            if(_isXMLSpace(c) == JACIC_BOOL_TRUE) break;
+
+            if(c == '"' || c == '\'')
+            {
+                filter->_quote = c;
+                filter->_state = IMAGE_FILTER_PREFIX;
+                filter->_matched = 0;
+                break;
+            }
+
+            _resetImageFilter(filter, c);
+            break;
+
+        case IMAGE_FILTER_PREFIX:
+            if(c == BASE64_URL_PREFIX_JPEG[filter->_matched])
+            {
+                filter->_matched++;
+                if(BASE64_URL_PREFIX_JPEG[filter->_matched] == '\0')
+                {
+                    /* 以降の Base64 部分は XML パーサに渡さずにデコードする */
+                    base64DecoderInit(&filter->_decoder);
+                    jpegStreamInit(&filter->_stream);
+                    filter->_state = IMAGE_FILTER_PAYLOAD;
+                }
+                break;
+            }
+
+            _resetImageFilter(filter, c);
+            break;
+
+        case IMAGE_FILTER_SCAN:
+        case IMAGE_FILTER_PAYLOAD:
+        default:
+            _resetImageFilter(filter, c);
+            break;
+    }
+}
+
+/*!
+@brief 取り除いた Base64 部分の終わりに到達した画像を、要素を判別していない画像として記録する。
+@details 読み捨てている場合 (`filter._discard`) は、取り除いた位置のみを記録する（ _head は NULL となる）。
+@param [in, out] filter 対象のフィルタ
+@param offset データ URL を取り除いた位置（XML パーサに渡したデータの先頭からのバイト数）
+@retval SVG_SUCCESS 正常終了
+@retval SVG_STREAMING_UNSUPPORTED 正しい Base64 文字列でない場合、記録できる数を超えた場合、画像を逐次処理できなかった場合
+*/
+static SVGResult _finishStreamedImage(ImageFilter *filter, size_t offset)
+{
+    StreamedImage *image;
+
+    if(filter->_discard == JACIC_BOOL_FALSE && base64DecoderFinish(&filter->_decoder) != JACIC_BOOL_TRUE) return SVG_STREAMING_UNSUPPORTED;
+    if(STREAMED_IMAGE_MAX <= filter->_imageCount) return SVG_STREAMING_UNSUPPORTED;
+
+    image = &(filter->_images[filter->_imageCount]);
+    image->_offset = offset;
+    image->_head = NULL;
+    image->_prehashed._hashed = JACIC_BOOL_FALSE;
+
+    if(filter->_discard == JACIC_BOOL_FALSE &&
+            jpegStreamFinish(&filter->_stream, &image->_head, &image->_prehashed) != FUNCTION_SUCCESS)
+    {
+        return SVG_STREAMING_UNSUPPORTED;
+    }
+
+    filter->_imageCount++;
+
+    return SVG_SUCCESS;
+}
+
+/*!
+@brief 直前の開始タグから取り出した画像が使われずに残っていれば解放する。
+@param [in, out] filter 対象のフィルタ
+*/
+static void _releaseElementImage(ImageFilter *filter)
+{
+    if(filter->_hasElementImage == JACIC_BOOL_TRUE)
+    {
+        _SECURE_RELEASE(filter->_elementImage._head);
+        filter->_hasElementImage = JACIC_BOOL_FALSE;
+    }
+}
+
+/*!
+@brief フィルタを初期状態に戻し、Expat で最初から解析し直せるようにする。
+@details 取り除いた画像は解放する。デコード先のバッファは解放せずに使い回す。
+@param [in, out] filter 対象のフィルタ
+*/
+static void _rewindImageFilter(ImageFilter *filter)
+{
+    size_t i;
+
+    for(i = 0; i < filter->_imageCount; ++i)
+    {
+        _SECURE_RELEASE(filter->_images[i]._head);
+    }
+    filter->_imageCount = 0;
+
+    _releaseElementImage(filter);
+    jpegStreamRelease(&filter->_stream);
+
+    filter->_state = IMAGE_FILTER_SCAN;
+    filter->_matched = 0;
+    filter->_quote = '"';
+    filter->_passed = 0;
+
+    base64DecoderInit(&filter->_decoder);
+    jpegStreamInit(&filter->_stream);
+}
+
+/*!
+@brief フィルタの処理を中断し、`parseInfo._resultCode` にエラーコードを設定する。
+@param parseInfo [in] パーサーを含むユーザー定義オブジェクト
+@param result 設定するエラーコード
+@return XML_STATUS_ERROR
+*/
+static enum XML_Status _stopFiltering(ParseInfo *parseInfo, SVGResult result)
+{
+    parseInfo->_results._resultCode = result;
+
+    return XML_STATUS_ERROR;
+}
+
+SVGResult _initImageFilter(ImageFilter *filter)
+{
+    filter->_state = IMAGE_FILTER_SCAN;
+    filter->_matched = 0;
+    filter->_quote = '"';
+    filter->_passed = 0;
+    filter->_discard = JACIC_BOOL_FALSE;
+
+    base64DecoderInit(&filter->_decoder);
+    jpegStreamInit(&filter->_stream);
+
+    filter->_imageCount = 0;
+    filter->_hasElementImage = JACIC_BOOL_FALSE;
+    filter->_elementImage._head = NULL;
+    filter->_scanning = JACIC_BOOL_FALSE;
+
+    /* 読み込んだデータ 1 回分の Base64 部分をデコードできる大きさを確保する */
+    filter->_decoded = allocateMemory(STREAM_BUFFER_SIZE / 4 * 3 + 3);
+    if(filter->_decoded == NULL)
+    {
+        return SVG_FAILURE_OTHER_ERROR;
+    }
+
+    return SVG_SUCCESS;
+}
+
+void _releaseImageFilter(ImageFilter *filter)
+{
+    size_t i;
+
+    for(i = 0; i < filter->_imageCount; ++i)
+    {
+        _SECURE_RELEASE(filter->_images[i]._head);
+    }
+    filter->_imageCount = 0;
+
+    _releaseElementImage(filter);
+    jpegStreamRelease(&filter->_stream);
+
+    _SECURE_RELEASE(filter->_decoded);
+}
+
+enum XML_Status _parseFiltered(ParseInfo *parseInfo, char *data, size_t len, XML_Bool isFinal)
+{
+    ImageFilter *filter = parseInfo->_filter;
+    XML_Parser parser = parseInfo->_condition._parser;
+    enum XML_Status status;
+    size_t i = 0;
+    size_t out = 0;     /* XML パーサに渡すデータとして data に書き戻したバイト数 */
+    size_t flushed = 0; /* data に書き戻したうち XML パーサに渡したバイト数 */
+
+    while(i < len)
+    {
+        if(filter->_state == IMAGE_FILTER_PAYLOAD)
+        {
+            size_t end = i;
+            size_t decodedLength;
+
+            if(filter->_discard == JACIC_BOOL_TRUE)
+            {
+                /* 属性値の終わりまでを XML パーサに渡さずに読み捨てる */
+                const char *quote = memchr(&data[i], filter->_quote, len - i);
+
+                end = (quote != NULL) ? (size_t)(quote - data) : len;
+            }
+            else
+            {
+                /* 属性値の終わりまでを XML パーサに渡さずにデコードする */
+                while(end < len && data[end] != filter->_quote) end++;
+
+                decodedLength = base64DecodeChunk(&filter->_decoder, &data[i], end - i, filter->_decoded);
+                if(filter->_decoder._failed == JACIC_BOOL_TRUE ||
+                        jpegStreamWrite(&filter->_stream, filter->_decoded, decodedLength) != FUNCTION_SUCCESS)
+                {
+                    return _stopFiltering(parseInfo, SVG_STREAMING_UNSUPPORTED);
+                }
+            }
+
+            i = end;
+            if(i == len) break;
+
+            if(_finishStreamedImage(filter, filter->_passed + (out - flushed)) != SVG_SUCCESS)
+            {
+                return _stopFiltering(parseInfo, SVG_STREAMING_UNSUPPORTED);
+            }
+
+            /* 属性値を閉じる引用符は XML パーサに渡す */
+            data[out++] = data[i++];
+            _resetImageFilter(filter, filter->_quote);
+
+            /* 取り除いた画像がどの要素のものか判別できるよう、ここまでを XML パーサに渡す */
+            status = XML_Parse(parser, &data[flushed], (int)(out - flushed), XML_FALSE);
+            filter->_passed += out - flushed;
+            flushed = out;
+
+            if(status != XML_STATUS_OK) return status;
+            continue;
+        }
+
+        _advanceImageFilter(filter, data[i]);
+        data[out++] = data[i++];
+    }
+
+    if(isFinal && filter->_state == IMAGE_FILTER_PAYLOAD)
+    {
+        /* 属性値が閉じられないまま終了した */
+        return _stopFiltering(parseInfo, SVG_STREAMING_UNSUPPORTED);
+    }
+
+    status = XML_Parse(parser, &data[flushed], (int)(out - flushed), isFinal);
+    filter->_passed += out - flushed;
+
+    return status;
+}
+
+/*!
+@brief 開始タグの範囲から取り除いた画像を、その要素の画像として取り出す。
+@details _settleStreamedImages と高速解析 ( _scanStartTag ) で共通に使用する。
+@param [in, out] filter 対象のフィルタ
+@param tagStart 開始タグの位置（XML パーサに渡したデータの先頭からのバイト数）
+@param tagEnd 開始タグの終了位置（この位置を含まない）
+@return _settleStreamedImages と同じ
+*/
+static SVGResult _settleImagesInTag(ImageFilter *filter, size_t tagStart, size_t tagEnd)
+{
+    size_t count = 0;
+    size_t i;
+
+    _releaseElementImage(filter);
+
+    for(i = 0; i < filter->_imageCount; ++i)
+    {
+        if(filter->_images[i]._offset < tagStart)
+        {
+            /* 開始タグ以外（文字データ、コメントなど）から取り除いた */
+            return SVG_STREAMING_UNSUPPORTED;
+        }
+
+        if(tagEnd <= filter->_images[i]._offset) break;
+
+        count++;
+    }
+
+    if(count == 0) return SVG_SUCCESS;
+    if(1 < count) return SVG_STREAMING_UNSUPPORTED;
+
+    filter->_elementImage = filter->_images[0];
+    filter->_hasElementImage = JACIC_BOOL_TRUE;
+
+    filter->_imageCount--;
+    memmove(&(filter->_images[0]), &(filter->_images[1]), sizeof(StreamedImage) * filter->_imageCount);
+
+    return SVG_SUCCESS;
+}
+
+SVGResult _settleStreamedImages(ParseInfo *parseInfo)
+{
+    size_t tagStart = (size_t)XML_GetCurrentByteIndex(parseInfo->_condition._parser);
+    size_t tagEnd = tagStart + (size_t)XML_GetCurrentByteCount(parseInfo->_condition._parser);
+
+    return _settleImagesInTag(parseInfo->_filter, tagStart, tagEnd);
+}
+
+SVGResult _takeImageData(ParseInfo *parseInfo, const XML_Char *srcStr, const XML_Char **attributes, JpegBuffer **imageData, PrehashedImage *prehashed)
+{
+    ImageFilter *filter = parseInfo->_filter;
+    int count = 0;
+
+    prehashed->_hashed = JACIC_BOOL_FALSE;
+
+    if(filter == NULL || filter->_hasElementImage == JACIC_BOOL_FALSE)
+    {
+        /* データ URL を取り除いていない場合は、画像全体をデコードする */
+        *imageData = _dataURLToImageData(srcStr);
+        return SVG_SUCCESS;
+    }
+
+    /*
+     取り除いた位置が xlink:href 属性の値であることを確認する
+     （ xlink:href 属性の値は接頭辞のみとなり、他の属性の値は接頭辞を含まない）
+     */
+    if(strcmp(srcStr, BASE64_URL_PREFIX_JPEG) != 0)
+    {
+        return SVG_STREAMING_UNSUPPORTED;
+    }
+
+    while(attributes[count] != NULL)
+    {
+        if(strcmp(attributes[count], SVG_ATTRIBUTE_NAME_IMAGE_XLINK) != 0 &&
+                strstr(attributes[count + 1], BASE64_URL_PREFIX_JPEG) != NULL)
+        {
+            return SVG_STREAMING_UNSUPPORTED;
+        }
+
+        count += 2;
+    }
+
+    *imageData = filter->_elementImage._head;
+    *prehashed = filter->_elementImage._prehashed;
+
+    filter->_elementImage._head = NULL;
+    filter->_hasElementImage = JACIC_BOOL_FALSE;
+
+    return SVG_SUCCESS;
+}
+
+/*! @} */
+
+#if defined(FAST_SVG_SCAN)
+
+/*!
+@name SVG の高速解析（実装）
+@details Expat が受理する記述のうち、SVG 工事写真として出力される範囲のみを解析する。
+Expat は文字データを改行の位置と読み込みバッファ (BUFFER_SIZE) の境界で分割して通知するため、同じ位置で分割して通知する。
+@{
+*/
+
+/*!
+@brief SVG ファイル全体を読み込む。
+@param [in] filePath SVG 画像のファイルパス
+@return 読み込んだデータ（末尾に終端文字を付加する。 _len は終端文字を含まない）。読み込めなかった場合は NULL
+*/
+static JpegBuffer *_readDocument(const char *filePath)
+{
+    FILE *fp = NULL;
+    long fileSize;
+    JpegBuffer *document = NULL;
+
+    if((fp = fopen(filePath, "rb")) == NULL) return NULL;
+
+    if(fseek(fp, 0L, SEEK_END) != 0 || (fileSize = ftell(fp)) <= 0L || fseek(fp, 0L, SEEK_SET) != 0)
+    {
+        goto FINALIZE;
+    }
+
+    document = allocateBinaryDataUninitialized((size_t)fileSize + 1);
+    if(document == NULL) goto FINALIZE;
+
+    if(fread(document->_buff, 1, (size_t)fileSize, fp) < (size_t)fileSize)
+    {
+        _SECURE_RELEASE(document);
+        goto FINALIZE;
+    }
+
+    document->_len = (size_t)fileSize;
+    document->_buff[fileSize] = '\0';
+
+FINALIZE:
+    if(fclose(fp) == EOF)
+    {
+        _SECURE_RELEASE(document);
+    }
+
+    return document;
+}
+
+/*!
+@brief 作成中の文書の末尾にデータを追加する。
+@details 領域が足りない場合は 2 倍ずつ確保し直す。追加後の長さが FILTERED_DOCUMENT_MAX を超える場合は追加しない。
+@param [in, out] document 作成中の文書（ NULL の場合は新たに確保する）
+@param [in, out] capacity document の _buff に格納できるバイト数（終端文字の分を含む）
+@param [in] data 追加するデータ
+@param length data の長さ
+@retval JACIC_BOOL_TRUE 追加した
+@retval JACIC_BOOL_FALSE 文書が FILTERED_DOCUMENT_MAX を超える場合、メモリ確保に失敗した場合
+*/
+static JACIC_BOOL _appendDocument(JpegBuffer **document, size_t *capacity, const char *data, size_t length)
+{
+    size_t used = (*document != NULL) ? (*document)->_len : 0;
+    size_t newCapacity = *capacity;
+    JpegBuffer *grown;
+
+    if(length == 0) return JACIC_BOOL_TRUE;
+    if(FILTERED_DOCUMENT_MAX - used < length) return JACIC_BOOL_FALSE;
+
+    if(*capacity < used + length + 1)
+    {
+        if(newCapacity == 0) newCapacity = STREAM_BUFFER_SIZE;
+        while(newCapacity < used + length + 1) newCapacity *= 2;
+
+        grown = allocateBinaryDataUninitialized(newCapacity);
+        if(grown == NULL) return JACIC_BOOL_FALSE;
+
+        if(*document != NULL)
+        {
+            memcpy(grown->_buff, (*document)->_buff, used);
+            _SECURE_RELEASE(*document);
+        }
+
+        *document = grown;
+        *capacity = newCapacity;
+    }
+
+    memcpy(&((*document)->_buff[used]), data, length);
+    (*document)->_len = used + length;
+    (*document)->_buff[used + length] = '\0';
+
+    return JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 画像を逐次処理する場合に、SVG ファイルを STREAM_BUFFER_SIZE ずつ読み込み、xlink:href 属性のデータ URL を取り除いた文書を作成する。
+@details _parseFiltered と同じくデータ URL の Base64 部分をデコードして画像ハッシュ値を計算し、取り除いた位置（作成した文書の先頭からのバイト数）とともに記録する。
+ファイル全体を保持しないため、メモリ使用量はファイルサイズによらず STREAM_BUFFER_SIZE と FILTERED_DOCUMENT_MAX の和までとなる。
+@param [in] filePath SVG 画像のファイルパス
+@param [in, out] filter 対象のフィルタ
+@param [out] document 作成した文書（末尾に終端文字を付加する。 _len は終端文字を含まない）
+@retval SVG_SUCCESS 正常終了
+@retval SVG_STREAMING_UNSUPPORTED 正しい Base64 文字列でない場合など、データ URL を逐次処理できなかった場合
+@retval SVG_FAILURE_OTHER_ERROR 読み込めなかった場合、取り除いた後の文書が FILTERED_DOCUMENT_MAX を超える場合（ Expat で解析し直す）
+*/
+static SVGResult _readFilteredDocument(const char *filePath, ImageFilter *filter, JpegBuffer **document)
+{
+    SVGResult ret = SVG_SUCCESS;
+    FILE *fp = NULL;
+    char *buffer = NULL;
+    size_t capacity = 0;
+    size_t len;
+    size_t i;
+    size_t start;
+    size_t decodedLength;
+
+    *document = NULL;
+
+    if((fp = fopen(filePath, "rb")) == NULL) return SVG_FAILURE_OTHER_ERROR;
+
+    if((buffer = (char *)allocateMemory(STREAM_BUFFER_SIZE)) == NULL)
+    {
+        ret = SVG_FAILURE_OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    while((len = fread(buffer, 1, STREAM_BUFFER_SIZE, fp)) != 0)
+    {
+        i = 0;
+
+        while(i < len)
+        {
+            if(filter->_state == IMAGE_FILTER_PAYLOAD)
+            {
+                /* 属性値の終わりまでを文書に含めずにデコードする */
+                start = i;
+                while(i < len && buffer[i] != filter->_quote) i++;
+
+                decodedLength = base64DecodeChunk(&filter->_decoder, &buffer[start], i - start, filter->_decoded);
+                if(filter->_decoder._failed == JACIC_BOOL_TRUE ||
+                        jpegStreamWrite(&filter->_stream, filter->_decoded, decodedLength) != FUNCTION_SUCCESS)
+                {
+                    ret = SVG_STREAMING_UNSUPPORTED;
+                    goto FINALIZE;
+                }
+
+                if(i == len) break;
+
+                /* 属性値を閉じる引用符の位置を、取り除いた位置として記録する */
+                if(_finishStreamedImage(filter, (*document != NULL) ? (*document)->_len : 0) != SVG_SUCCESS)
+                {
+                    ret = SVG_STREAMING_UNSUPPORTED;
+                    goto FINALIZE;
+                }
+
+                _resetImageFilter(filter, filter->_quote);
+                start = i++;
+            }
+            else
+            {
+                start = i;
+                while(i < len && filter->_state != IMAGE_FILTER_PAYLOAD)
+                {
+                    _advanceImageFilter(filter, buffer[i]);
+                    i++;
+                }
+            }
+
+            if(_appendDocument(document, &capacity, &buffer[start], i - start) == JACIC_BOOL_FALSE)
+            {
+                ret = SVG_FAILURE_OTHER_ERROR;
+                goto FINALIZE;
+            }
+        }
+    }
+
+    if(ferror(fp) || *document == NULL)
+    {
+        ret = SVG_FAILURE_OTHER_ERROR;
+    }
+    else if(filter->_state == IMAGE_FILTER_PAYLOAD)
+    {
+        /* 属性値が閉じられないまま終了した */
+        ret = SVG_STREAMING_UNSUPPORTED;
+    }
+
+FINALIZE:
+    _SECURE_RELEASE(buffer);
+
+    if(fclose(fp) == EOF && ret == SVG_SUCCESS)
+    {
+        ret = SVG_FAILURE_OTHER_ERROR;
+    }
+
+    if(ret != SVG_SUCCESS)
+    {
+        _SECURE_RELEASE(*document);
+    }
+
+    return ret;
+}
+
+/*!
+@brief 名前の先頭に使用できる文字かどうかを返す。
+@details ASCII 以外の文字は対象外とする。
+@param c 調べる文字
+@return 使用できる場合は JACIC_BOOL_TRUE
+*/
+static JACIC_BOOL _isNameStartChar(char c)
+{
+    return (('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z') || c == '_' || c == ':') ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+}
+
+/*!
+@brief 名前の 2 文字目以降に使用できる文字かどうかを返す。
+@details ASCII 以外の文字は対象外とする。
+@param c 調べる文字
+@return 使用できる場合は JACIC_BOOL_TRUE
+*/
+static JACIC_BOOL _isNameChar(char c)
+{
+    return (_isNameStartChar(c) == JACIC_BOOL_TRUE || ('0' <= c && c <= '9') || c == '.' || c == '-') ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+}
+
+/*!
+@brief 名前の終わりの位置を返す。
+@param [in] data 文書
+@param position 名前の先頭の位置
+@return 名前の直後の位置（名前でない場合は position ）
+*/
+static size_t _scanName(const char *data, size_t position)
+{
+    if(_isNameStartChar(data[position]) == JACIC_BOOL_FALSE) return position;
+
+    do
+    {
+        position++;
+    } while(_isNameChar(data[position]) == JACIC_BOOL_TRUE);
+
+    return position;
+}
+
+/*!
+@brief 空白文字を読み飛ばした位置を返す。
+@param [in] data 文書
+@param position 読み飛ばし始める位置
+@return 空白文字以外の文字の位置
+*/
+static size_t _skipSpaces(const char *data, size_t position)
+{
+    while(_isXMLSpace(data[position]) == JACIC_BOOL_TRUE) position++;
+
+    return position;
+}
+
+/*!
+@brief findXMLSpecialByte で見つけた位置の文字が、XML の文字として使用できるかを調べる。
+@details 0x80 以上のバイトは UTF-8 として復号し、サロゲート、U+FFFE、U+FFFF、冗長な表現などは使用できないものとする。
+@param [in] data 調べる位置
+@param available data から文書の終わりまでのバイト数
+@return 文字のバイト数（使用できない場合は 0 ）
+*/
+static size_t _validCharLength(const unsigned char *data, size_t available)
+{
+    unsigned char lead = data[0];
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    size_t length;
+    size_t i;
+
+    if(lead == '\t' || lead == '\n' || lead == '\r' || lead == 0x7F) return 1;
+    if(lead < 0xC2 || 0xF4 < lead) return 0;
+
+    if(lead < 0xE0)
+    {
+        length = 2;
+    }
+    else if(lead < 0xF0)
+    {
+        length = 3;
+        if(lead == 0xE0) lower = 0xA0;
+        if(lead == 0xED) upper = 0x9F;
+    }
+    else
+    {
+        length = 4;
+        if(lead == 0xF0) lower = 0x90;
+        if(lead == 0xF4) upper = 0x8F;
+    }
+
+    if(available < length) return 0;
+
+    for(i = 1; i < length; ++i)
+    {
+        if(data[i] < lower || upper < data[i]) return 0;
+
+        lower = 0x80;
+        upper = 0xBF;
+    }
+
+    /* U+FFFE, U+FFFF */
+    if(lead == 0xEF && data[1] == 0xBF && 0xBE <= data[2]) return 0;
+
+    return length;
+}
+
+/*!
+@brief ハンドラが解析を中断したかどうかを返す。
+@param [in] scanner 解析中の状態
+@return FAST_SCAN_STOPPED または FAST_SCAN_CONTINUE
+*/
+static FastScanStatus _handlerStatus(const FastScanner *scanner)
+{
+    return (scanner->_parseInfo->_results._resultCode != SVG_SUCCESS) ? FAST_SCAN_STOPPED : FAST_SCAN_CONTINUE;
+}
+
+/*!
+@brief 文字データをハンドラに通知する。
+@details Expat が読み込みバッファの境界で分割して通知する可能性がある範囲は対象外とする。
+@param [in, out] scanner 解析中の状態
+@param start 文字データの開始位置
+@param end 文字データの終了位置（この位置を含まない）
+@return 処理結果
+*/
+static FastScanStatus _notifyCharacterData(FastScanner *scanner, size_t start, size_t end)
+{
+    if(start == end) return FAST_SCAN_CONTINUE;
+
+    /* 末尾の ']' も Expat が次のバッファまで持ち越す場合があるため、境界の直前で終わる場合も対象外とする */
+    if(start / BUFFER_SIZE != (end + 1) / BUFFER_SIZE) return FAST_SCAN_UNSUPPORTED;
+
+    characterDataHandler(scanner->_parseInfo, &(scanner->_data[start]), (int)(end - start));
+
+    return _handlerStatus(scanner);
+}
+
+/*!
+@brief 要素の内容のうち、次の `<` までの文字データを解析する。
+@details Expat と同じく、改行 (LF, CR, CR LF) は 1 文字の LF として個別に通知する。
+@param [in, out] scanner 解析中の状態
+@return 処理結果
+*/
+static FastScanStatus _scanCharacterData(FastScanner *scanner)
+{
+    const unsigned char *data = (const unsigned char *)scanner->_data;
+    size_t length = scanner->_length;
+    size_t position = scanner->_position;
+    size_t runStart = position;
+    size_t charLength;
+    FastScanStatus status;
+
+    while(position < length)
+    {
+        position += findXMLSpecialByte(&data[position], length - position, ']');
+        if(position == length || data[position] == '<') break;
+
+        switch(data[position])
+        {
+            case '&':
+                /* 実体参照、文字参照 */
+                return FAST_SCAN_UNSUPPORTED;
+
+            case ']':
+                /* 文字データ中の "]]>" は Expat ではエラーとなる */
+                if(position + 2 < length && data[position + 1] == ']' && data[position + 2] == '>')
+                {
+                    return FAST_SCAN_UNSUPPORTED;
+                }
+                position++;
+                break;
+
+            case '\n':
+            case '\r':
+                status = _notifyCharacterData(scanner, runStart, position);
+                if(status != FAST_SCAN_CONTINUE) return status;
+
+                characterDataHandler(scanner->_parseInfo, "\n", 1);
+                status = _handlerStatus(scanner);
+                if(status != FAST_SCAN_CONTINUE) return status;
+
+                position += (data[position] == '\r' && data[position + 1] == '\n') ? 2 : 1;
+                runStart = position;
+                break;
+
+            default:
+                charLength = _validCharLength(&data[position], length - position);
+                if(charLength == 0) return FAST_SCAN_UNSUPPORTED;
+
+                position += charLength;
+                break;
+        }
+    }
+
+    scanner->_position = position;
+
+    return _notifyCharacterData(scanner, runStart, position);
+}
+
+/*!
+@brief 属性値を解析し、Expat と同じく空白文字 (TAB, LF, CR, CR LF) を 1 文字の空白に置き換える。
+@details 置き換えた結果は属性値の位置に上書きする。 Base64 部分のように長い属性値は findXMLSpecialByte でまとめて読み飛ばす。
+@param [in, out] scanner 解析中の状態
+@param start 属性値の開始位置（開始の引用符の次）
+@param quote 属性値を囲む引用符
+@param [out] valueEnd 置き換えた属性値の終了位置
+@param [out] next 終了の引用符の次の位置
+@return 処理結果
+*/
+static FastScanStatus _scanAttributeValue(FastScanner *scanner, size_t start, char quote, size_t *valueEnd, size_t *next)
+{
+    unsigned char *data = (unsigned char *)scanner->_data;
+    size_t length = scanner->_length;
+    size_t read = start;
+    size_t write = start;
+    size_t plain;
+    size_t charLength;
+    unsigned char c;
+
+    while(read < length)
+    {
+        plain = findXMLSpecialByte(&data[read], length - read, (unsigned char)quote);
+        if(write != read) memmove(&data[write], &data[read], plain);
+        read += plain;
+        write += plain;
+
+        if(read == length) break;
+
+        c = data[read];
+        if(c == (unsigned char)quote)
+        {
+            *valueEnd = write;
+            *next = read + 1;
+            return FAST_SCAN_CONTINUE;
+        }
+
+        if(c == '<' || c == '&') return FAST_SCAN_UNSUPPORTED;
+
+        if(c == '\t' || c == '\n' || c == '\r')
+        {
+            data[write++] = ' ';
+            read += (c == '\r' && data[read + 1] == '\n') ? 2 : 1;
+            continue;
+        }
+
+        charLength = _validCharLength(&data[read], length - read);
+        if(charLength == 0) return FAST_SCAN_UNSUPPORTED;
+
+        memmove(&data[write], &data[read], charLength);
+        read += charLength;
+        write += charLength;
+    }
+
+    /* 属性値が閉じられていない */
+    return FAST_SCAN_UNSUPPORTED;
+}
+
+/*!
+@brief 開始タグ（空要素タグを含む）を解析し、ハンドラに通知する。
+@param [in, out] scanner 解析中の状態（ `<` の位置から開始する）
+@return 処理結果
+*/
+static FastScanStatus _scanStartTag(FastScanner *scanner)
+{
+    char *data = scanner->_data;
+    size_t tagStart = scanner->_position;
+    size_t position = scanner->_position + 1;
+    size_t terminators[FAST_SCAN_ATTRIBUTE_MAX * 2 + 1];   /* 終端文字を書き込む位置 */
+    size_t terminatorCount = 0;
+    size_t count = 0;
+    size_t nameStart;
+    size_t nameEnd;
+    size_t valueStart;
+    size_t valueEnd;
+    size_t i, j;
+    const char *elementName = &data[position];
+    JACIC_BOOL isEmptyElement;
+    FastScanStatus status;
+
+    nameEnd = _scanName(data, position);
+    if(nameEnd == position) return FAST_SCAN_UNSUPPORTED;
+    terminators[terminatorCount++] = nameEnd;
+    position = nameEnd;
+
+    for(;;)
+    {
+        nameStart = _skipSpaces(data, position);
+
+        if(data[nameStart] == '>')
+        {
+            isEmptyElement = JACIC_BOOL_FALSE;
+            position = nameStart + 1;
+            break;
+        }
+
+        if(data[nameStart] == '/' && data[nameStart + 1] == '>')
+        {
+            isEmptyElement = JACIC_BOOL_TRUE;
+            position = nameStart + 2;
+            break;
+        }
+
+        /* 属性の前には空白文字が必要 */
+        if(nameStart == position || count == FAST_SCAN_ATTRIBUTE_MAX) return FAST_SCAN_UNSUPPORTED;
+
+        nameEnd = _scanName(data, nameStart);
+        if(nameEnd == nameStart) return FAST_SCAN_UNSUPPORTED;
+
+        position = _skipSpaces(data, nameEnd);
+        if(data[position] != '=') return FAST_SCAN_UNSUPPORTED;
+
+        position = _skipSpaces(data, position + 1);
+        if(data[position] != '"' && data[position] != '\'') return FAST_SCAN_UNSUPPORTED;
+
+        valueStart = position + 1;
+        status = _scanAttributeValue(scanner, valueStart, data[position], &valueEnd, &position);
+        if(status != FAST_SCAN_CONTINUE) return status;
+
+        scanner->_attributes[count * 2] = &data[nameStart];
+        scanner->_attributes[count * 2 + 1] = &data[valueStart];
+        terminators[terminatorCount++] = nameEnd;
+        terminators[terminatorCount++] = valueEnd;
+        count++;
+    }
+
+    if(isEmptyElement == JACIC_BOOL_FALSE && scanner->_depth == FAST_SCAN_DEPTH_MAX) return FAST_SCAN_UNSUPPORTED;
+    if(scanner->_depth == 0 && scanner->_rootClosed == JACIC_BOOL_TRUE) return FAST_SCAN_UNSUPPORTED;
+
+    for(i = 0; i < terminatorCount; ++i)
+    {
+        data[terminators[i]] = '\0';
+    }
+    scanner->_attributes[count * 2] = NULL;
+
+    for(i = 0; i < count; ++i)
+    {
+        for(j = i + 1; j < count; ++j)
+        {
+            /* 属性名の重複は Expat ではエラーとなる */
+            if(strcmp(scanner->_attributes[i * 2], scanner->_attributes[j * 2]) == 0) return FAST_SCAN_UNSUPPORTED;
+        }
+    }
+
+    scanner->_position = position;
+
+    if(scanner->_parseInfo->_filter != NULL)
+    {
+        /* 開始タグからデータ URL を取り除いていれば、この要素の画像として取り出す */
+        SVGResult settleResult = _settleImagesInTag(scanner->_parseInfo->_filter, tagStart, position);
+
+        if(settleResult != SVG_SUCCESS)
+        {
+            _abortParse(scanner->_parseInfo, settleResult);
+            return FAST_SCAN_STOPPED;
+        }
+    }
+
+    startElementHandler(scanner->_parseInfo, elementName, scanner->_attributes);
+    status = _handlerStatus(scanner);
+    if(status != FAST_SCAN_CONTINUE) return status;
+
+    if(isEmptyElement == JACIC_BOOL_TRUE)
+    {
+        if(scanner->_depth == 0) scanner->_rootClosed = JACIC_BOOL_TRUE;
+
+        endElementHandler(scanner->_parseInfo, elementName);
+        return _handlerStatus(scanner);
+    }
+
+    scanner->_openElements[scanner->_depth++] = elementName;
+
+    return FAST_SCAN_CONTINUE;
+}
+
+/*!
+@brief 終了タグを解析し、ハンドラに通知する。
+@param [in, out] scanner 解析中の状態（ `<` の位置から開始する）
+@return 処理結果
+*/
+static FastScanStatus _scanEndTag(FastScanner *scanner)
+{
+    const char *data = scanner->_data;
+    size_t position = scanner->_position + 2;
+    size_t nameEnd = _scanName(data, position);
+    const char *elementName;
+
+    if(nameEnd == position || scanner->_depth == 0) return FAST_SCAN_UNSUPPORTED;
+
+    /* 開いている要素と名前が一致しない場合は Expat ではエラーとなる */
+    elementName = scanner->_openElements[scanner->_depth - 1];
+    if(strncmp(elementName, &data[position], nameEnd - position) != 0 || elementName[nameEnd - position] != '\0')
+    {
+        return FAST_SCAN_UNSUPPORTED;
+    }
+
+    position = _skipSpaces(data, nameEnd);
+    if(data[position] != '>') return FAST_SCAN_UNSUPPORTED;
+
+    scanner->_position = position + 1;
+    scanner->_depth--;
+    if(scanner->_depth == 0) scanner->_rootClosed = JACIC_BOOL_TRUE;
+
+    endElementHandler(scanner->_parseInfo, elementName);
+
+    return _handlerStatus(scanner);
+}
+
+/*!
+@brief コメントを読み飛ばす。
+@param [in, out] scanner 解析中の状態（ `<!--` の位置から開始する）
+@return 処理結果
+*/
+static FastScanStatus _scanComment(FastScanner *scanner)
+{
+    const unsigned char *data = (const unsigned char *)scanner->_data;
+    size_t length = scanner->_length;
+    size_t position = scanner->_position + 4;
+    size_t charLength;
+
+    while(position < length)
+    {
+        position += findXMLSpecialByte(&data[position], length - position, '-');
+        if(position == length) break;
+
+        if(data[position] == '-')
+        {
+            if(data[position + 1] == '-')
+            {
+                /* コメント中の "--" は "-->" 以外 Expat ではエラーとなる */
+                if(data[position + 2] != '>') return FAST_SCAN_UNSUPPORTED;
+
+                scanner->_position = position + 3;
+                return FAST_SCAN_CONTINUE;
+            }
+
+            position++;
+        }
+        else if(data[position] == '<' || data[position] == '&')
+        {
+            position++;
+        }
+        else
+        {
+            charLength = _validCharLength(&data[position], length - position);
+            if(charLength == 0) return FAST_SCAN_UNSUPPORTED;
+
+            position += charLength;
+        }
+    }
+
+    /* コメントが閉じられていない */
+    return FAST_SCAN_UNSUPPORTED;
+}
+
+/*!
+@brief XML 宣言の擬似属性を照合する。
+@param [in] data 文書
+@param position 擬似属性の前の空白文字の位置
+@param name 擬似属性名
+@param values 受け入れる値の配列（ NULL で終わる）
+@return 擬似属性の直後の位置（一致しない場合は 0 ）
+*/
+static size_t _matchPseudoAttribute(const char *data, size_t position, const char *name, const char * const *values)
+{
+    size_t nameStart = _skipSpaces(data, position);
+    size_t valueLength;
+    char quote;
+
+    if(nameStart == position || strncmp(&data[nameStart], name, strlen(name)) != 0) return 0;
+
+    position = _skipSpaces(data, nameStart + strlen(name));
+    if(data[position] != '=') return 0;
+
+    position = _skipSpaces(data, position + 1);
+    quote = data[position];
+    if(quote != '"' && quote != '\'') return 0;
+    position++;
+
+    for(; *values != NULL; ++values)
+    {
+        valueLength = strlen(*values);
+        if(strncmp(&data[position], *values, valueLength) == 0 && data[position + valueLength] == quote)
+        {
+            return position + valueLength + 1;
+        }
+    }
+
+    return 0;
+}
+
+/*!
+@brief XML 宣言を解析する。
+@details バージョン 1.0 、エンコーディング UTF-8 の宣言のみを対象とする。
+@param [in, out] scanner 解析中の状態（ `<?xml` の位置から開始する）
+@return 処理結果
+*/
+static FastScanStatus _scanXMLDeclaration(FastScanner *scanner)
+{
+    static const char * const VERSIONS[] = { "1.0", NULL };
+    static const char * const ENCODINGS[] = { "UTF-8", "utf-8", NULL };
+    static const char * const STANDALONES[] = { "yes", "no", NULL };
+    const char *data = scanner->_data;
+    size_t position = scanner->_position + 5;
+    size_t next;
+
+    position = _matchPseudoAttribute(data, position, "version", VERSIONS);
+    if(position == 0) return FAST_SCAN_UNSUPPORTED;
+
+    if((next = _matchPseudoAttribute(data, position, "encoding", ENCODINGS)) != 0) position = next;
+    if((next = _matchPseudoAttribute(data, position, "standalone", STANDALONES)) != 0) position = next;
+
+    position = _skipSpaces(data, position);
+    if(data[position] != '?' || data[position + 1] != '>') return FAST_SCAN_UNSUPPORTED;
+
+    scanner->_position = position + 2;
+
+    return FAST_SCAN_CONTINUE;
+}
+
+/*!
+@brief 文書全体を解析する。
+@param [in, out] scanner 解析中の状態
+@return 処理結果（最後まで解析した場合は FAST_SCAN_CONTINUE ）
+*/
+static FastScanStatus _scanDocument(FastScanner *scanner)
+{
+    const char *data = scanner->_data;
+    size_t length = scanner->_length;
+    FastScanStatus status;
+
+    /* UTF-8 の BOM */
+    if(3 <= length && memcmp(data, "\xEF\xBB\xBF", 3) == 0) scanner->_position = 3;
+
+    if(strncmp(&data[scanner->_position], "<?xml", 5) == 0)
+    {
+        status = _scanXMLDeclaration(scanner);
+        if(status != FAST_SCAN_CONTINUE) return status;
+    }
+
+    while(scanner->_position < length)
+    {
+        if(scanner->_depth != 0)
+        {
+            status = _scanCharacterData(scanner);
+            if(status != FAST_SCAN_CONTINUE) return status;
+            if(scanner->_position == length) break;
+        }
+        else
+        {
+            /* ルート要素の外側には空白文字とコメントのみを許容する */
+            scanner->_position = _skipSpaces(data, scanner->_position);
+            if(scanner->_position == length) break;
+            if(data[scanner->_position] != '<') return FAST_SCAN_UNSUPPORTED;
+        }
+
+        if(data[scanner->_position + 1] == '/')
+        {
+            status = _scanEndTag(scanner);
+        }
+        else if(strncmp(&data[scanner->_position], "<!--", 4) == 0)
+        {
+            status = _scanComment(scanner);
+        }
+        else if(data[scanner->_position + 1] == '!' || data[scanner->_position + 1] == '?')
+        {
+            /* DOCTYPE 宣言、CDATA セクション、処理命令 */
+            status = FAST_SCAN_UNSUPPORTED;
+        }
+        else
+        {
+            status = _scanStartTag(scanner);
+        }
+
+        if(status != FAST_SCAN_CONTINUE) return status;
+    }
+
+    /* ルート要素が閉じられていない */
+    if(scanner->_rootClosed == JACIC_BOOL_FALSE || scanner->_depth != 0) return FAST_SCAN_UNSUPPORTED;
+
+    return FAST_SCAN_CONTINUE;
+}
+
+JACIC_BOOL _scanFile(const char *filePath, ParseInfo *parseInfo, SVGResult *result)
+{
+    JpegBuffer *document;
+    FastScanner scanner;
+    FastScanStatus status;
+    XML_Parser parser;
+    ImageFilter *filter = parseInfo->_filter;
+
+#if defined(JCOMSIA_TEST_HOOKS)
+    if(__atomic_load_n(&svgFastScan, __ATOMIC_RELAXED) == JACIC_BOOL_FALSE) return JACIC_BOOL_FALSE;
+#endif
+
+    if(filter != NULL)
+    {
+        /* 画像を逐次処理する場合は、データ URL を取り除きながら読み込み、ファイル全体を保持しない */
+        SVGResult readResult = _readFilteredDocument(filePath, filter, &document);
+
+        if(readResult == SVG_STREAMING_UNSUPPORTED)
+        {
+            _rewindImageFilter(filter);
+            *result = SVG_STREAMING_UNSUPPORTED;
+            return JACIC_BOOL_TRUE;
+        }
+
+        if(readResult != SVG_SUCCESS)
+        {
+            /* 読み込めない場合のエラーは Expat で解析する際に判定する */
+            _rewindImageFilter(filter);
+            return JACIC_BOOL_FALSE;
+        }
+    }
+    /* 読み込めない場合のエラーは Expat で解析する際に判定する */
+    else if((document = _readDocument(filePath)) == NULL)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    scanner._parseInfo = parseInfo;
+    scanner._data = (char *)document->_buff;
+    scanner._length = document->_len;
+    scanner._position = 0;
+    scanner._depth = 0;
+    scanner._rootClosed = JACIC_BOOL_FALSE;
+
+    if(filter != NULL) filter->_scanning = JACIC_BOOL_TRUE;
+
+    status = _scanDocument(&scanner);
+
+    _SECURE_RELEASE(document);
+
+    if(filter != NULL)
+    {
+        filter->_scanning = JACIC_BOOL_FALSE;
+        _releaseElementImage(filter);
+    }
+
+    if(status == FAST_SCAN_UNSUPPORTED)
+    {
+        if(filter != NULL) _rewindImageFilter(filter);
+
+        /* ハンドラが途中まで処理した結果を破棄し、Expat で最初から解析できるようにする */
+        parser = parseInfo->_condition._parser;
+
+        _deinitParseInfo(parseInfo);
+        _initParseInfo(parseInfo);
+
+        parseInfo->_condition._parser = parser;
+        parseInfo->_filter = filter;
+
+        return JACIC_BOOL_FALSE;
+    }
+
+#if defined(JCOMSIA_TEST_HOOKS)
+    __atomic_add_fetch(&svgParseStatistics._scanCount, 1, __ATOMIC_RELAXED);
+#endif
+
+    *result = parseInfo->_results._resultCode;
+
+    return JACIC_BOOL_TRUE;
+}
+
+/*! @} */
+
+#endif
@@ -10,6 +10,7 @@
 #define svg_h
 
 #include "common.h"
+#include "jpegstream.h"
 
 /*!
 @enum SVGResult
@@ -42,8 +43,24 @@ typedef enum _svg_result
     SVG_FAILURE_COULD_NOT_READ_CHALKBOARD_IMAGE,        /*!< @brief 黒板画像の読み取りに失敗した */
 
     SVG_FAILURE_OTHER_ERROR,                            /*!< @brief メモリ確保に失敗したなど、その他のエラー */
+
+    SVG_STREAMING_UNSUPPORTED,                          /*!< @brief 画像を逐次処理できない記述のため、parse で解析し直す必要がある */
 } SVGResult;
 
+/*!
+@struct SVGMetadata
+@brief probeMetadata で取得したメタデータ
+*/
+typedef struct
+{
+    char *_vender;              /*!< @brief 作成したソフトウェアベンダー */
+    char *_software;            /*!< @brief 作成したソフトウェア名 */
+    char *_metaVersion;         /*!< @brief メタデータバージョン */
+    char *_stdVersion;          /*!< @brief 適用基準バージョン */
+    HashBuffer *_hashCode;      /*!< @brief ハッシュ値（メタデータに含まれていない場合は NULL ） */
+    JACIC_BOOL _hasChalkboard;  /*!< @brief 黒板画像レイヤを検出したかどうか */
+} SVGMetadata;
+
 /*!
 @brief SVG ファイルを解析して各種データを取得する。
 @details
@@ -65,4 +82,83 @@ typedef enum _svg_result
 */
 SVGResult parse(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **chalkboardBuffer, HashBuffer **hashBuffer);
 
+/*!
+@brief SVG ファイルを解析して各種データを取得する。画像は Base64 デコードしながら逐次処理し、画像全体をメモリ上に展開しない。
+@details
+xlink:href 属性のデータ URL は XML パーサに渡す前に取り除き、デコードした画像のうち先頭部分 (SOI ～ SOS マーカー) のみを保持する。
+圧縮データ (SOS ～ EOI) は画像ハッシュ値の計算に使用して破棄するため、取得した画像データは prehashedImages とともに検証処理に渡すこと。
+SVG 工事写真として想定する構成の場合は、parse と同じく Expat を使わずに解析し、xlink:href 属性の値を同じく逐次処理する。
+取り除いたデータ URL がどの要素のものか判別できない場合など、parse と同じ結果を得られない場合は SVG_STREAMING_UNSUPPORTED を返す。
+
+@param [in] filePath SVG 画像のファイルパス
+@param [out] imageBuffer オリジナル画像領域の画像データ（先頭部分）
+@param [out] chalkboardBuffer 黒板画像領域の画像データ（先頭部分）
+@param [out] hashBuffer メタデータ領域のハッシュ値
+@param [out] prehashedImages オリジナル画像、黒板画像の順に計算した画像ハッシュ値（ 2 要素）
+
+@retval SVG_STREAMING_UNSUPPORTED 逐次処理できない記述を検出した
+@retval その他 parse と同じ
+*/
+SVGResult parseWithImageHash(const char *filePath, JpegBuffer **imageBuffer, JpegBuffer **chalkboardBuffer, HashBuffer **hashBuffer, PrehashedImage *prehashedImages);
+
+/*!
+@brief SVG ファイルからメタデータと黒板画像レイヤの有無のみを取得する。
+@details
+xlink:href 属性のデータ URL は XML パーサに渡す前に読み捨て、画像はデコードしない。
+黒板画像レイヤの開始タグを検出した時点で解析を終了するため、以降のデータは読み込まない。
+画像の内容と、黒板画像レイヤ以降の構成は検証しない。
+
+@param [in] filePath SVG 画像のファイルパス
+@param [out] metadata 取得したメタデータ。使い終わったら releaseSVGMetadata で解放すること。
+
+@retval その他 parse と同じ（ SVG_FAILURE_COULD_NOT_READ_ORIGINAL_IMAGE, SVG_FAILURE_COULD_NOT_READ_CHALKBOARD_IMAGE は返さない）
+*/
+SVGResult probeMetadata(const char *filePath, SVGMetadata *metadata);
+
+/*!
+@brief probeMetadata で取得したメタデータを解放する。
+@param [in, out] metadata 解放対象のメタデータ
+*/
+void releaseSVGMetadata(SVGMetadata *metadata);
+
+#if defined(JCOMSIA_TEST_HOOKS)
+
+/*!
+@struct SVGParseStatistics
+@brief SVG ファイルを解析した回数の累計（テスト用）
+*/
+typedef struct
+{
+    size_t _parseCount;             /*!< @brief parse で解析した回数 */
+    size_t _streamingCount;         /*!< @brief parseWithImageHash で解析した回数（ SVG_STREAMING_UNSUPPORTED を返した場合を含む） */
+    size_t _scanCount;              /*!< @brief parse, parseWithImageHash のうち、Expat を使わずに高速解析で解析した回数 */
+} SVGParseStatistics;
+
+/*!
+@brief resetSVGParseStatistics を呼び出してからの、SVG ファイルを解析した回数の累計を返す（テスト用）。
+@param [out] statistics 累計を受けとる構造体
+*/
+void getSVGParseStatistics(SVGParseStatistics *statistics);
+
+/*!
+@brief SVG ファイルを解析した回数の累計を 0 に戻す（テスト用）。
+*/
+void resetSVGParseStatistics(void);
+
+/*!
+@brief parseWithImageHash で画像を逐次処理するかを切り替える（テスト用）。
+@details 逐次処理しない場合、parseWithImageHash はファイルを読み込まずに SVG_STREAMING_UNSUPPORTED を返す。
+@param enabled JACIC_BOOL_FALSE の場合は逐次処理しない（初期値は JACIC_BOOL_TRUE ）
+*/
+void setSVGImageStreaming(JACIC_BOOL enabled);
+
+/*!
+@brief 想定する構成の SVG ファイルを、Expat を使わずに高速解析で解析するかを切り替える（テスト用）。
+@details JCOMSIA_DISABLE_FAST_SVG_SCAN を定義した場合は、常に Expat で解析する。
+@param enabled JACIC_BOOL_FALSE の場合は常に Expat で解析する（初期値は JACIC_BOOL_TRUE ）
+*/
+void setSVGFastScan(JACIC_BOOL enabled);
+
+#endif /* JCOMSIA_TEST_HOOKS */
+
 #endif /* svg_h */
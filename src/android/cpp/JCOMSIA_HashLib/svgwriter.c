@@ -0,0 +1,477 @@
+﻿/*!
+@file svgwriter.c
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief SVG ファイル作成処理
+@details
+注釈レイヤの内容の検査において、XML パーサライブラリ Expat を使用しています。
+ライセンス情報は下記の URL を参照してください。
+
+https://github.com/libexpat/libexpat/blob/master/expat/COPYING
+*/
+
+/* Expat を同じライブラリ内のソースとしてビルドする */
+#define XML_STATIC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "base64.h"
+#include "expat.h"
+#include "svgwriter.h"
+
+/*!
+@name SVG 作成用定数
+@{
+*/
+
+#define BYTE_SIZE_SVG_WRITE_BUFFER ((size_t)(64 * 1024))    /*!< @brief 書き出し用のバッファのバイト数（ Base64 の 4 文字単位の倍数とする） */
+
+static const char * const SVG_NAMESPACE_SVG     = "http://www.w3.org/2000/svg";                     /*!< @brief SVG の名前空間 */
+static const char * const SVG_NAMESPACE_XLINK   = "http://www.w3.org/1999/xlink";                   /*!< @brief XLink の名前空間 */
+static const char * const SVG_NAMESPACE_XMP     = "adobe:ns:meta/";                                 /*!< @brief XMP の名前空間 */
+static const char * const SVG_NAMESPACE_RDF     = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";    /*!< @brief RDF の名前空間 */
+
+static const char * const SVG_GROUP_ID_ORIGINAL_IMAGE       = "dcp_org_img";        /*!< @brief 原本画像を示すグループ ID */
+static const char * const SVG_GROUP_ID_ANNOTATION           = "dcp_annotation";     /*!< @brief 注釈を示すグループ ID */
+static const char * const SVG_GROUP_ID_CHALKBOARD_IMAGE     = "dcp_chalkboard_img"; /*!< @brief 黒板画像を示すグループ ID */
+
+/*! @} */
+
+/*!
+@struct SVGWriter
+@brief SVG ファイルの書き出し状態
+@details 書き込みは _buff にまとめてから行い、一度失敗した後は何も書き込まない。
+*/
+typedef struct
+{
+    FILE *_fp;          /*!< @brief 書き出し先のファイル */
+    char *_buff;        /*!< @brief 書き出し用のバッファ（ BYTE_SIZE_SVG_WRITE_BUFFER バイト） */
+    size_t _used;       /*!< @brief _buff のうち書き出していないバイト数 */
+    int _ret;           /*!< @brief これまでの書き出し結果 */
+} SVGWriter;
+
+/*!
+@brief バッファに溜めた内容をファイルへ書き出す。
+@param [in, out] writer 書き出し状態
+*/
+static void _flushWriter(SVGWriter *writer)
+{
+    if(writer->_ret == FUNCTION_SUCCESS && writer->_used != 0)
+    {
+        if(fwrite(writer->_buff, BYTE_SIZE_UNSIGNED_CHAR, writer->_used, writer->_fp) < writer->_used)
+        {
+            /* ファイルへの書き込みに失敗 */
+            writer->_ret = FILE_WRITE_FAILED;
+        }
+    }
+
+    writer->_used = 0;
+}
+
+/*!
+@brief バイト列をバッファに追加する（バッファが一杯になった時点で書き出す）。
+@param [in, out] writer 書き出し状態
+@param [in] data 追加するバイト列
+@param length data のバイト数
+*/
+static void _writeBytes(SVGWriter *writer, const char *data, size_t length)
+{
+    while(0 < length && writer->_ret == FUNCTION_SUCCESS)
+    {
+        size_t copyLength = BYTE_SIZE_SVG_WRITE_BUFFER - writer->_used;
+
+        if(length < copyLength) copyLength = length;
+
+        memcpy(writer->_buff + writer->_used, data, copyLength);
+        writer->_used += copyLength;
+        data += copyLength;
+        length -= copyLength;
+
+        if(writer->_used == BYTE_SIZE_SVG_WRITE_BUFFER) _flushWriter(writer);
+    }
+}
+
+/*!
+@brief NULL 終端された文字列をそのままバッファに追加する。
+@param [in, out] writer 書き出し状態
+@param [in] str 追加する文字列
+*/
+static void _writeText(SVGWriter *writer, const char *str)
+{
+    _writeBytes(writer, str, strlen(str));
+}
+
+/*!
+@brief NULL 終端された文字列を、 XML の文字データや属性値として扱えるようにエスケープしてバッファに追加する。
+@param [in, out] writer 書き出し状態
+@param [in] str 追加する文字列
+*/
+static void _writeEscapedText(SVGWriter *writer, const char *str)
+{
+    const char *start = str;
+
+    for(; *str != '\0'; ++str)
+    {
+        const char *entity;
+
+        switch(*str)
+        {
+        case '&': entity = "&amp;"; break;
+        case '<': entity = "&lt;";  break;
+        case '>': entity = "&gt;";  break;
+        case '"': entity = "&quot;"; break;
+        default: continue;
+        }
+
+        /* エスケープ不要な部分はまとめて追加する */
+        _writeBytes(writer, start, (size_t)(str - start));
+        _writeText(writer, entity);
+        start = str + 1;
+    }
+
+    _writeBytes(writer, start, (size_t)(str - start));
+}
+
+/*!
+@brief 符号なし整数を 10 進数の文字列としてバッファに追加する。
+@param [in, out] writer 書き出し状態
+@param value 追加する値
+*/
+static void _writeNumber(SVGWriter *writer, unsigned long value)
+{
+    char text[24];
+
+    snprintf(text, sizeof(text), "%lu", value);
+    _writeText(writer, text);
+}
+
+/*!
+@brief dcpm メタデータの要素 1 つをバッファに追加する。
+@param [in, out] writer 書き出し状態
+@param [in] name 要素名（ dcpm: を除く）
+@param [in] value 要素の内容
+*/
+static void _writeMetadataItem(SVGWriter *writer, const char *name, const char *value)
+{
+    _writeText(writer, "<dcpm:");
+    _writeText(writer, name);
+    _writeText(writer, ">");
+    _writeEscapedText(writer, value);
+    _writeText(writer, "</dcpm:");
+    _writeText(writer, name);
+    _writeText(writer, ">\n");
+}
+
+/*!
+@brief 画像レイヤ（グループ要素と、データ URL 形式で画像を埋め込んだ画像要素）をバッファに追加する。
+@details Base64 文字列はバッファの空き領域へ直接エンコードし、バッファが一杯になるごとに書き出す。
+@param [in, out] writer 書き出し状態
+@param [in] groupId グループ要素の ID
+@param [in] layer 埋め込む画像
+*/
+static void _writeImageLayer(SVGWriter *writer, const char *groupId, const SVGLayerImage *layer)
+{
+    const unsigned char *data = layer->_image->_buff;
+    size_t remain = layer->_image->_len;
+
+    _writeText(writer, "<g id=\"");
+    _writeText(writer, groupId);
+    _writeText(writer, "\"><image x=\"0\" y=\"0\" width=\"");
+    _writeNumber(writer, layer->_width);
+    _writeText(writer, "\" height=\"");
+    _writeNumber(writer, layer->_height);
+    _writeText(writer, "\" xlink:href=\"");
+    _writeText(writer, BASE64_URL_PREFIX_JPEG);
+
+    while(0 < remain && writer->_ret == FUNCTION_SUCCESS)
+    {
+        /* 空き領域に収まる 3 バイト単位の長さずつエンコードする（最後の端数のみ '=' で埋める） */
+        size_t encodeLength = (BYTE_SIZE_SVG_WRITE_BUFFER - writer->_used) / 4 * 3;
+
+        if(encodeLength == 0)
+        {
+            _flushWriter(writer);
+            continue;
+        }
+
+        if(remain < encodeLength) encodeLength = remain;
+
+        writer->_used += base64EncodeChunk(data, encodeLength, writer->_buff + writer->_used);
+        data += encodeLength;
+        remain -= encodeLength;
+
+        if(BYTE_SIZE_SVG_WRITE_BUFFER - writer->_used < 4) _flushWriter(writer);
+    }
+
+    _writeText(writer, "\"/></g>\n");
+}
+
+/*!
+@brief 0x80 以上のバイトで始まる UTF-8 の文字のバイト数を求める。
+@details サロゲート、U+FFFE、U+FFFF、冗長な表現、途中で終わる文字など、XML の文字として使用できないものは 0 とする。
+@param [in] data 文字の先頭（ NUL 終端の文字列内）
+@return 文字のバイト数（使用できない場合は 0 ）
+*/
+static size_t _utf8CharLength(const unsigned char *data)
+{
+    unsigned char lead = data[0];
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    size_t length;
+    size_t i;
+
+    if(lead < 0xC2 || 0xF4 < lead) return 0;
+
+    if(lead < 0xE0)
+    {
+        length = 2;
+    }
+    else if(lead < 0xF0)
+    {
+        length = 3;
+        if(lead == 0xE0) lower = 0xA0;
+        if(lead == 0xED) upper = 0x9F;
+    }
+    else
+    {
+        length = 4;
+        if(lead == 0xF0) lower = 0x90;
+        if(lead == 0xF4) upper = 0x8F;
+    }
+
+    /* NUL は範囲外のため、文字列の終わりを越えて読むことはない */
+    for(i = 1; i < length; ++i)
+    {
+        if(data[i] < lower || upper < data[i]) return 0;
+
+        lower = 0x80;
+        upper = 0xBF;
+    }
+
+    /* U+FFFE, U+FFFF */
+    if(lead == 0xEF && data[1] == 0xBF && 0xBE <= data[2]) return 0;
+
+    return length;
+}
+
+/*!
+@brief メタデータの値として書き出せる、空でない文字列か調べる。
+@details XML で使用できない制御文字を含むもの、正しい UTF-8 でないものは書き出せないものとする。
+@param [in] value 調べる文字列
+@return 書き出せる文字列であれば JACIC_BOOL_TRUE
+*/
+static JACIC_BOOL _isMetadataValue(const char *value)
+{
+    const unsigned char *data = (const unsigned char *) value;
+    size_t length;
+
+    if(value == NULL || value[0] == '\0') return JACIC_BOOL_FALSE;
+
+    while(*data != '\0')
+    {
+        if(*data < 0x80)
+        {
+            if(*data < 0x20 && *data != '\t' && *data != '\n' && *data != '\r') return JACIC_BOOL_FALSE;
+            ++data;
+            continue;
+        }
+
+        if((length = _utf8CharLength(data)) == 0) return JACIC_BOOL_FALSE;
+        data += length;
+    }
+
+    return JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 書き出す内容が、 SVG ファイルの解析処理で受け付けられる内容か調べる。
+@param [in] document 書き出す内容
+@return 受け付けられる内容であれば JACIC_BOOL_TRUE
+*/
+static JACIC_BOOL _isWritableDocument(const SVGDocument *document)
+{
+    /* 必須のメタデータ（名前空間は呼び出し元が指定する） */
+    if(_isMetadataValue(document->_dcpmNamespace) != JACIC_BOOL_TRUE) return JACIC_BOOL_FALSE;
+    if(_isMetadataValue(document->_vender) != JACIC_BOOL_TRUE) return JACIC_BOOL_FALSE;
+    if(_isMetadataValue(document->_software) != JACIC_BOOL_TRUE) return JACIC_BOOL_FALSE;
+    if(document->_metaVersion == NULL || document->_stdVersion == NULL) return JACIC_BOOL_FALSE;
+
+    /* svg.c の _availableVersion で判定可能なバージョンのみ */
+    if(strcmp(document->_metaVersion, "3.1") != 0) return JACIC_BOOL_FALSE;
+    if(strcmp(document->_stdVersion, "1.5") != 0 &&
+            strcmp(document->_stdVersion, "1.0") != 0 &&
+            strcmp(document->_stdVersion, "0.5") != 0)
+    {
+        return JACIC_BOOL_FALSE;
+    }
+
+    /* 原本画像は必須、黒板画像とハッシュ値は両方あるか両方ないかのいずれか */
+    if(document->_originalImage._image == NULL || document->_originalImage._image->_len == 0) return JACIC_BOOL_FALSE;
+    if(document->_chalkboardImage._image != NULL && document->_chalkboardImage._image->_len == 0) return JACIC_BOOL_FALSE;
+    if((document->_chalkboardImage._image == NULL) != (document->_hashCode == NULL)) return JACIC_BOOL_FALSE;
+
+    /* 注釈レイヤは後続の黒板画像レイヤの解析を妨げないこと */
+    if(document->_annotation != NULL && isWellFormedAnnotation(document->_annotation) != JACIC_BOOL_TRUE) return JACIC_BOOL_FALSE;
+
+    return JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 注釈レイヤの内容が、グループ要素の子として整形式の XML となるかを調べる。
+@param [in] annotation NULL 終端された SVG 要素の並び
+@return 整形式であれば JACIC_BOOL_TRUE
+*/
+JACIC_BOOL isWellFormedAnnotation(const char *annotation)
+{
+    static const char OPEN_TAG[] = "<g>";
+    static const char CLOSE_TAG[] = "</g>";
+
+    JACIC_BOOL result = JACIC_BOOL_FALSE;
+    XML_Parser parser;
+
+    if(annotation == NULL) return JACIC_BOOL_FALSE;
+
+    parser = XML_ParserCreate("UTF-8");
+    if(parser == NULL) return JACIC_BOOL_FALSE;
+
+    /* グループ要素で囲んだ内容が 1 つの要素となれば、グループ要素を途中で閉じることはない */
+    if(XML_Parse(parser, OPEN_TAG, (int)(sizeof(OPEN_TAG) - 1), XML_FALSE) == XML_STATUS_OK &&
+            XML_Parse(parser, annotation, (int)strlen(annotation), XML_FALSE) == XML_STATUS_OK &&
+            XML_Parse(parser, CLOSE_TAG, (int)(sizeof(CLOSE_TAG) - 1), XML_TRUE) == XML_STATUS_OK)
+    {
+        result = JACIC_BOOL_TRUE;
+    }
+
+    XML_ParserFree(parser);
+
+    return result;
+}
+
+/*!
+@brief 原本画像、注釈、黒板画像の各レイヤとメタデータを持つ SVG ファイルを書き出す。
+@details 画像は一定の長さずつ Base64 エンコードしながら書き出し、 Base64 文字列全体をメモリ上に作成しない。
+原本画像の大きさを SVG の大きさとし、黒板画像は左上に元の大きさで配置する。
+書き出しに失敗した場合、書き出し途中のファイルは削除する。
+@param [in] document 書き出す内容
+@param [in] dst 書き出し先のファイルパス
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗
+@retval FILE_WRITE_FAILED ファイルへの書き込みに失敗
+@retval FILE_CLOSE_FAILED ファイルのクローズに失敗
+@retval OTHER_ERROR メモリ確保に失敗した場合
+*/
+int writeSVG(const SVGDocument *document, const char *dst)
+{
+    SVGWriter writer;
+
+    /* パラメータチェック */
+    if(document == NULL || dst == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    if(_isWritableDocument(document) != JACIC_BOOL_TRUE)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    writer._used = 0;
+    writer._ret = FUNCTION_SUCCESS;
+    writer._buff = (char *) allocateMemory(BYTE_SIZE_SVG_WRITE_BUFFER);
+    if(writer._buff == NULL)
+    {
+        /* メモリ確保失敗 */
+        return OTHER_ERROR;
+    }
+
+    writer._fp = fopen(dst, "wb");
+    if(writer._fp == NULL)
+    {
+        /* ファイルのオープンに失敗 */
+        _SECURE_RELEASE(writer._buff);
+        return FILE_OPEN_FAILED;
+    }
+
+    /* 書き込みは writer._buff にまとめてから行うため、ファイル側ではバッファリングしない */
+    setvbuf(writer._fp, NULL, _IONBF, 0);
+
+    /* ルート要素 */
+    _writeText(&writer, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"");
+    _writeText(&writer, SVG_NAMESPACE_SVG);
+    _writeText(&writer, "\" xmlns:xlink=\"");
+    _writeText(&writer, SVG_NAMESPACE_XLINK);
+    _writeText(&writer, "\" width=\"");
+    _writeNumber(&writer, document->_originalImage._width);
+    _writeText(&writer, "\" height=\"");
+    _writeNumber(&writer, document->_originalImage._height);
+    _writeText(&writer, "\" viewBox=\"0 0 ");
+    _writeNumber(&writer, document->_originalImage._width);
+    _writeText(&writer, " ");
+    _writeNumber(&writer, document->_originalImage._height);
+    _writeText(&writer, "\">\n");
+
+    /* メタデータ（ルート要素の最初の子要素） */
+    _writeText(&writer, "<x:xmpmeta xmlns:x=\"");
+    _writeText(&writer, SVG_NAMESPACE_XMP);
+    _writeText(&writer, "\">\n<rdf:RDF xmlns:rdf=\"");
+    _writeText(&writer, SVG_NAMESPACE_RDF);
+    _writeText(&writer, "\">\n<rdf:Description rdf:about=\"\" xmlns:dcpm=\"");
+    _writeEscapedText(&writer, document->_dcpmNamespace);
+    _writeText(&writer, "\">\n");
+
+    _writeMetadataItem(&writer, "vender", document->_vender);
+    _writeMetadataItem(&writer, "software", document->_software);
+    _writeMetadataItem(&writer, "metaVersion", document->_metaVersion);
+    _writeMetadataItem(&writer, "stdVersion", document->_stdVersion);
+
+    if(document->_hashCode != NULL)
+    {
+        _writeText(&writer, "<dcpm:hashCode>");
+        _writeBytes(&writer, (const char *) document->_hashCode->_buff, document->_hashCode->_len);
+        _writeText(&writer, "</dcpm:hashCode>\n");
+    }
+
+    _writeText(&writer, "</rdf:Description>\n</rdf:RDF>\n</x:xmpmeta>\n");
+
+    /* 原本画像レイヤ、注釈レイヤ、黒板画像レイヤの順 */
+    _writeImageLayer(&writer, SVG_GROUP_ID_ORIGINAL_IMAGE, &(document->_originalImage));
+
+    if(document->_annotation != NULL)
+    {
+        _writeText(&writer, "<g id=\"");
+        _writeText(&writer, SVG_GROUP_ID_ANNOTATION);
+        _writeText(&writer, "\">");
+        _writeText(&writer, document->_annotation);
+        _writeText(&writer, "</g>\n");
+    }
+
+    if(document->_chalkboardImage._image != NULL)
+    {
+        _writeImageLayer(&writer, SVG_GROUP_ID_CHALKBOARD_IMAGE, &(document->_chalkboardImage));
+    }
+
+    _writeText(&writer, "</svg>\n");
+    _flushWriter(&writer);
+
+    /* ファイルクローズ */
+    if(fclose(writer._fp) == EOF && writer._ret == FUNCTION_SUCCESS)
+    {
+        /* ファイルクローズに失敗 */
+        writer._ret = FILE_CLOSE_FAILED;
+    }
+
+    writer._fp = NULL;
+    _SECURE_RELEASE(writer._buff);
+
+    /* 書き出し途中のファイルは残さない */
+    if(writer._ret != FUNCTION_SUCCESS)
+    {
+        remove(dst);
+    }
+
+    return writer._ret;
+}
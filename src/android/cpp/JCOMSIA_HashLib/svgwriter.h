@@ -0,0 +1,65 @@
+﻿/*!
+@file svgwriter.h
+@date Created on: 2026/10/17
+@author DATT JAPAN Inc.
+@version 3.2
+@brief SVG ファイル作成処理
+*/
+
+#ifndef svgwriter_h
+#define svgwriter_h
+
+#include "common.h"
+
+/*!
+@struct SVGLayerImage
+@brief SVG ファイルの画像レイヤに埋め込む JPEG 画像
+*/
+typedef struct
+{
+    const JpegBuffer *_image;   /*!< @brief 埋め込む JPEG 画像（レイヤを出力しない場合は NULL ） */
+    unsigned short _width;      /*!< @brief 画像の幅（ピクセル数） */
+    unsigned short _height;     /*!< @brief 画像の高さ（ピクセル数） */
+} SVGLayerImage;
+
+/*!
+@struct SVGDocument
+@brief writeSVG で書き出す SVG ファイルの内容
+*/
+typedef struct
+{
+    const char *_dcpmNamespace;     /*!< @brief dcpm 接頭辞に割り当てる名前空間 */
+    const char *_vender;            /*!< @brief 作成したソフトウェアベンダー */
+    const char *_software;          /*!< @brief 作成したソフトウェア名 */
+    const char *_metaVersion;       /*!< @brief メタデータバージョン */
+    const char *_stdVersion;        /*!< @brief 適用基準バージョン */
+    const HashBuffer *_hashCode;    /*!< @brief ハッシュ値（黒板画像を出力しない場合は NULL ） */
+    SVGLayerImage _originalImage;   /*!< @brief 原本画像 */
+    const char *_annotation;        /*!< @brief 注釈レイヤの内容となる SVG 要素の並び（注釈レイヤを出力しない場合は NULL ） */
+    SVGLayerImage _chalkboardImage; /*!< @brief 黒板画像（出力しない場合は _image を NULL とする） */
+} SVGDocument;
+
+/*!
+@brief 注釈レイヤの内容が、グループ要素の子として整形式の XML となるかを調べる。
+@param [in] annotation NULL 終端された SVG 要素の並び
+@return 整形式であれば JACIC_BOOL_TRUE
+*/
+JACIC_BOOL isWellFormedAnnotation(const char *annotation);
+
+/*!
+@brief 原本画像、注釈、黒板画像の各レイヤとメタデータを持つ SVG ファイルを書き出す。
+@details 画像は一定の長さずつ Base64 エンコードしながら書き出し、 Base64 文字列全体をメモリ上に作成しない。
+原本画像の大きさを SVG の大きさとし、黒板画像は左上に元の大きさで配置する。
+書き出しに失敗した場合、書き出し途中のファイルは削除する。
+@param [in] document 書き出す内容
+@param [in] dst 書き出し先のファイルパス
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗
+@retval FILE_WRITE_FAILED ファイルへの書き込みに失敗
+@retval FILE_CLOSE_FAILED ファイルのクローズに失敗
+@retval OTHER_ERROR メモリ確保に失敗した場合
+*/
+int writeSVG(const SVGDocument *document, const char *dst);
+
+#endif /* svgwriter_h */
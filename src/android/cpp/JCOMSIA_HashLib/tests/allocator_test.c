@@ -0,0 +1,214 @@
+﻿/*!
+@file allocator_test.c
+@brief 他のスレッドが API を呼び出している間に JCOMSIA_SetAllocator を呼び出しても、確保した関数で解放されることを検査するテスト
+@details 各スレッドが JCOMSIA_WriteHashValueMem と JCOMSIA_FreeImageData を繰り返す間に、メインスレッドが 2 組の関数と
+標準の malloc / free を切り替え続ける。各関数は確保した領域の先頭に自身の印を付け、解放時に印が異なる領域を数える。
+確保した領域が残っている間の差し替えは JW_ERROR_ALLOCATOR_IN_USE で失敗することも確認する。
+*/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define THREAD_COUNT (4)            /*!< @brief API を呼び出すスレッドの数 */
+#define REPEAT_COUNT (200)          /*!< @brief 各スレッドが API を呼び出す回数 */
+#define HEADER_SIZE ((size_t)16)    /*!< @brief 確保した領域の先頭に置く印のバイト数（アライメントを保つ大きさ） */
+#define SCAN_LENGTH (16 * 1024)     /*!< @brief テスト用画像の画像データのバイト数 */
+/* @} */
+
+/*!
+@struct TaggedAllocator
+@brief 確保した領域に印を付ける関数の状態
+*/
+typedef struct
+{
+    size_t _allocCount;     /*!< @brief 確保した回数 */
+    size_t _freeCount;      /*!< @brief 解放した回数 */
+    size_t _foreignCount;   /*!< @brief 他の関数で確保された領域を解放しようとした回数 */
+} TaggedAllocator;
+
+/*!
+@struct WorkerArgs
+@brief API を呼び出すスレッドに渡す値
+*/
+typedef struct
+{
+    const unsigned char *_source;   /*!< @brief 埋め込み前の画像 */
+    size_t _sourceLength;           /*!< @brief _source の長さ */
+    int _failures;                  /*!< @brief API が失敗した回数 */
+    int _done;                      /*!< @brief 呼び出しを終えたか */
+} WorkerArgs;
+
+/*!
+@brief 領域の先頭に context を記録してメモリを確保する。
+@param size 確保するバイト数
+@param context TaggedAllocator
+@return 確保した領域（印の直後）
+*/
+static void *_taggedAlloc(size_t size, void *context)
+{
+    unsigned char *block = (unsigned char *)malloc(HEADER_SIZE + size);
+
+    if(block == NULL) return NULL;
+
+    memcpy(block, &context, sizeof(context));
+    __atomic_add_fetch(&((TaggedAllocator *)context)->_allocCount, 1, __ATOMIC_RELAXED);
+
+    return block + HEADER_SIZE;
+}
+
+/*!
+@brief 領域の先頭の印を確認してメモリを解放する。
+@param ptr 解放する領域
+@param context TaggedAllocator
+*/
+static void _taggedFree(void *ptr, void *context)
+{
+    unsigned char *block = (unsigned char *)ptr - HEADER_SIZE;
+    void *tag;
+
+    memcpy(&tag, block, sizeof(tag));
+
+    if(tag != context)
+    {
+        /* 他の関数で確保された領域は解放しない（標準の malloc で確保された領域の場合は印が無いため） */
+        __atomic_add_fetch(&((TaggedAllocator *)context)->_foreignCount, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_add_fetch(&((TaggedAllocator *)context)->_freeCount, 1, __ATOMIC_RELAXED);
+    free(block);
+}
+
+/*!
+@brief ハッシュ値の埋め込みと解放を繰り返す。
+@param [in, out] arg WorkerArgs
+@return NULL
+*/
+static void *_worker(void *arg)
+{
+    WorkerArgs *args = (WorkerArgs *)arg;
+    unsigned char *hashed = NULL;
+    size_t hashedLength = 0;
+    int i;
+
+    for(i = 0; i < REPEAT_COUNT; ++i)
+    {
+        if(JCOMSIA_WriteHashValueMem(args->_source, args->_sourceLength, &hashed, &hashedLength) != JW_SUCCESS ||
+                JCOMSIA_CheckHashValueMem(hashed, hashedLength) != JC_OK)
+        {
+            args->_failures++;
+        }
+
+        JCOMSIA_FreeImageData(&hashed);
+    }
+
+    __atomic_store_n(&args->_done, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    TaggedAllocator allocators[2];
+    WorkerArgs args[THREAD_COUNT];
+    pthread_t threads[THREAD_COUNT];
+    unsigned char *source;
+    unsigned char *hashed = NULL;
+    size_t sourceLength = 0;
+    size_t hashedLength = 0;
+    size_t swapCount = 0;
+    int running = 0;
+    int finished;
+    int ret;
+    int i;
+
+    memset(allocators, 0, sizeof(allocators));
+
+    source = createTestJpeg(640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U, &sourceLength);
+    TEST_CHECK(source != NULL);
+    if(source == NULL) return 1;
+
+    /* 確保した領域が残っている間は差し替えられない */
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(_taggedAlloc, _taggedFree, &allocators[0]));
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_WriteHashValueMem(source, sourceLength, &hashed, &hashedLength));
+    TEST_CHECK_EQUAL(JW_ERROR_ALLOCATOR_IN_USE, JCOMSIA_SetAllocator(_taggedAlloc, _taggedFree, &allocators[1]));
+    TEST_CHECK_EQUAL(JW_ERROR_ALLOCATOR_IN_USE, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+    JCOMSIA_FreeImageData(&hashed);
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(_taggedAlloc, _taggedFree, &allocators[1]));
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+
+    /* 他のスレッドが API を呼び出している間に切り替え続ける */
+    for(i = 0; i < THREAD_COUNT; ++i)
+    {
+        args[i]._source = source;
+        args[i]._sourceLength = sourceLength;
+        args[i]._failures = 0;
+        args[i]._done = 0;
+
+        if(pthread_create(&threads[i], NULL, _worker, &args[i]) != 0) break;
+        running++;
+    }
+    TEST_CHECK_EQUAL(THREAD_COUNT, running);
+
+    do
+    {
+        switch(swapCount % 3)
+        {
+        case 0:
+            ret = JCOMSIA_SetAllocator(_taggedAlloc, _taggedFree, &allocators[0]);
+            break;
+        case 1:
+            ret = JCOMSIA_SetAllocator(_taggedAlloc, _taggedFree, &allocators[1]);
+            break;
+        default:
+            ret = JCOMSIA_SetAllocator(NULL, NULL, NULL);
+            break;
+        }
+
+        if(ret == JW_SUCCESS)
+        {
+            swapCount++;
+        }
+        else
+        {
+            TEST_CHECK_EQUAL(JW_ERROR_ALLOCATOR_IN_USE, ret);
+        }
+
+        finished = 1;
+        for(i = 0; i < running; ++i)
+        {
+            if(__atomic_load_n(&args[i]._done, __ATOMIC_ACQUIRE) == 0) finished = 0;
+        }
+    }
+    while(!finished);
+
+    for(i = 0; i < running; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        TEST_CHECK_EQUAL(0, args[i]._failures);
+    }
+
+    /* 全ての領域が、確保した関数で解放されている */
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+    for(i = 0; i < 2; ++i)
+    {
+        TEST_CHECK_EQUAL(0, allocators[i]._foreignCount);
+        TEST_CHECK_EQUAL(allocators[i]._allocCount, allocators[i]._freeCount);
+    }
+
+    free(source);
+
+    return testFailures == 0 ? 0 : 1;
+}
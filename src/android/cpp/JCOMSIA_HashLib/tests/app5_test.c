@@ -0,0 +1,344 @@
+﻿/*!
+@file app5_test.c
+@brief 切り詰めた、または大きさの定義が不正な APP5 セグメントに対する getAPP5HashValue の戻り値を検査するテスト
+@details 本ライブラリで書き込んだ APP5 セグメントを元に、セグメントの途中で切り詰めたもの、項目の大きさやエントリ数を
+変更したもの、ハッシュ値の長さを変えたものを作成する。
+期待値は、RMETA Data の項目テキストと内容テキストをタイトルごとに走査していた app5.c（ 1 回の走査にまとめる前）で得た値であり、
+変更後も同じエラーコードを返すことを確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app5.h"
+#include "common.h"
+#include "exif.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define ENTRY_COUNT_OFFSET ((size_t)20)     /*!< @brief セグメント先頭からエントリ数までのバイト数 */
+#define FIRST_ITEM_OFFSET ((size_t)30)      /*!< @brief セグメント先頭から最初の RMETA 項目までのバイト数 */
+#define ITEM_TITLE_ID (0x0001)              /*!< @brief 項目テキストの RMETA ID */
+#define ITEM_VALUE_ID (0x0012)              /*!< @brief 内容テキスト 128 の RMETA ID */
+#define IMAGE_HASH_OFFSET ((size_t)718)     /*!< @brief セグメント先頭からハッシュ値（画像）までのバイト数 */
+#define DATE_HASH_OFFSET ((size_t)783)      /*!< @brief セグメント先頭からハッシュ値（撮影日時）までのバイト数 */
+#define HASH_TEXT_LENGTH ((size_t)64)       /*!< @brief ハッシュ値の文字列長 */
+#define TITLE_SIZE_MIN (58UL)               /*!< @brief ハッシュ値の 2 つのタイトルを含む最小の項目テキストの大きさの定義 */
+#define TITLE_SIZE_MAX (682UL)              /*!< @brief 元の項目テキストの大きさの定義 */
+#define MAX_SEGMENT_LENGTH ((size_t)65537)  /*!< @brief マーカーを含む APP5 セグメントの最大バイト数 */
+/* @} */
+
+/*!
+@struct ErrorRange
+@brief 変更する値の範囲と、その範囲で期待する戻り値
+*/
+typedef struct
+{
+    unsigned long _first; /*!< @brief 範囲の先頭の値 */
+    unsigned long _last;  /*!< @brief 範囲の最後の値（この値を含む） */
+    int _expected;        /*!< @brief 期待する戻り値 */
+} ErrorRange;
+
+/*!
+@brief 項目テキストの大きさの定義を変えた場合の期待値（ TITLE_SIZE_MIN ～ TITLE_SIZE_MAX 以外）
+*/
+static const ErrorRange TITLE_SIZE[] =
+{
+    { 0UL, 57UL, INCORRECT_APP5_FORMAT },
+    { 683UL, 65535UL, INCORRECT_APP5_FORMAT }
+};
+
+/*!
+@brief セグメントの長さを切り詰めた場合の期待値（マーカーを含むセグメントのバイト数ごと）
+*/
+static const ErrorRange TRUNCATED[] =
+{
+    { 4UL, 9UL, INCORRECT_APP5_FORMAT },
+    { 10UL, 11UL, APP5_NOT_EXISTS },
+    { 12UL, 13UL, INCORRECT_APP5_FORMAT },
+    { 14UL, 17UL, APP5_NOT_EXISTS },
+    { 18UL, 716UL, INCORRECT_APP5_FORMAT },
+    { 717UL, 844UL, HASH_NOT_EXISTS },
+    { 845UL, 845UL, FUNCTION_SUCCESS },
+    { 846UL, 847UL, HASH_NOT_EXISTS },
+    { 848UL, 3449UL, FUNCTION_SUCCESS }
+};
+
+/*!
+@brief エントリ数を変えた場合の期待値
+*/
+static const ErrorRange ENTRY_COUNT[] =
+{
+    { 0UL, 0UL, INCORRECT_APP5_FORMAT },
+    { 1UL, 1UL, HASH_NOT_EXISTS },
+    { 2UL, 65535UL, FUNCTION_SUCCESS }
+};
+
+/*!
+@brief 内容テキスト 128 の大きさの定義を変えた場合の期待値
+*/
+static const ErrorRange VALUE_SIZE[] =
+{
+    { 0UL, 1UL, INCORRECT_APP5_FORMAT },
+    { 2UL, 66UL, HASH_NOT_EXISTS },
+    { 67UL, 67UL, INCORRECT_APP5_FORMAT },
+    { 68UL, 131UL, HASH_NOT_EXISTS },
+    { 132UL, 6934UL, FUNCTION_SUCCESS },
+    { 6935UL, 65535UL, INCORRECT_APP5_FORMAT }
+};
+
+/*!
+@brief 元となる画像
+*/
+static unsigned char *baseImage = NULL;
+static size_t baseLength = 0;       /*!< @brief baseImage のバイト数 */
+static size_t app5Offset = 0;       /*!< @brief baseImage 内の APP5 セグメントの位置 */
+static size_t app5Length = 0;       /*!< @brief baseImage 内の APP5 セグメントのバイト数（マーカーを含む） */
+
+/*!
+@brief 作業用の APP5 セグメント
+*/
+static unsigned char segment[MAX_SEGMENT_LENGTH];
+
+/*!
+@brief 作業用の APP5 セグメントを元の内容に戻す。
+*/
+static void _resetSegment(void)
+{
+    memset(segment, 0x00, sizeof(segment));
+    memcpy(segment, baseImage + app5Offset, app5Length);
+}
+
+/*!
+@brief 作業用の APP5 セグメントに 2 バイトの値をビッグエンディアンで書き込む。
+@param offset セグメント先頭からの位置
+@param value 書き込む値
+*/
+static void _setShort(size_t offset, unsigned short value)
+{
+    segment[offset] = (unsigned char)(value >> 8);
+    segment[offset + 1] = (unsigned char)(value & 0xFF);
+}
+
+/*!
+@brief 元の APP5 セグメントから RMETA 項目を探す。
+@param id 探す RMETA ID
+@return セグメント先頭から RMETA ID までのバイト数（見つからない場合は 0 ）
+*/
+static size_t _findItem(unsigned short id)
+{
+    const unsigned char *app5 = baseImage + app5Offset;
+    size_t offset = FIRST_ITEM_OFFSET;
+
+    while(offset + 4 <= app5Length)
+    {
+        if(((app5[offset] << 8) | app5[offset + 1]) == id) return offset;
+        offset += 2 + ((app5[offset + 2] << 8) | app5[offset + 3]);
+    }
+
+    return 0;
+}
+
+/*!
+@brief 元の画像の APP5 セグメントを作業用の APP5 セグメントに置き換えて、ハッシュ値を取得する。
+@details セグメントの長さの定義は segmentLength に合わせて書き換える。
+取得に成功した場合は、取得したハッシュ値が元の画像で埋め込んだ位置を参照していることも確認する。
+@param segmentLength 作業用の APP5 セグメントのバイト数（マーカーを含む）
+@param [in] label 失敗時に表示する場面の名前
+@param value 変更した値
+@param expected 期待する戻り値
+*/
+static void _check(size_t segmentLength, const char *label, unsigned long value, int expected)
+{
+    JpegBuffer *buffer;
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    APP5Item imageHash = {JACIC_BOOL_FALSE, {NULL, 0}};
+    APP5Item dateHash = {JACIC_BOOL_FALSE, {NULL, 0}};
+    size_t tailLength = baseLength - app5Offset - app5Length;
+    int actual;
+
+    buffer = (JpegBuffer *)malloc(sizeof(JpegBuffer) + app5Offset + segmentLength + tailLength);
+    TEST_CHECK(buffer != NULL);
+    if(buffer == NULL) return;
+
+    _setShort(2, (unsigned short)(segmentLength - 2));
+
+    buffer->_len = app5Offset + segmentLength + tailLength;
+    memcpy(buffer->_buff, baseImage, app5Offset);
+    memcpy(buffer->_buff + app5Offset, segment, segmentLength);
+    memcpy(buffer->_buff + app5Offset + segmentLength, baseImage + app5Offset + app5Length, tailLength);
+
+    actual = buildSegmentIndex(buffer, &index, NULL);
+
+    if(actual == FUNCTION_SUCCESS)
+    {
+        actual = getAPP5HashValue(buffer, &index, &imageHash, &dateHash);
+    }
+
+    if(actual != expected)
+    {
+        fprintf(stderr, "%s: value %lu: expected %d, got %d\n", label, value, expected, actual);
+        ++testFailures;
+    }
+    else if(actual == FUNCTION_SUCCESS)
+    {
+        /* 切り詰めた場合も、ハッシュ値の位置はセグメント先頭からの元の位置となる */
+        TEST_CHECK_EQUAL(HASH_TEXT_LENGTH, imageHash.value._len);
+        TEST_CHECK_EQUAL(HASH_TEXT_LENGTH, dateHash.value._len);
+        TEST_CHECK(imageHash.value._ptr == buffer->_buff + app5Offset + IMAGE_HASH_OFFSET);
+        TEST_CHECK(dateHash.value._ptr == buffer->_buff + app5Offset + DATE_HASH_OFFSET);
+    }
+
+    releaseSegmentIndex(&index);
+    free(buffer);
+}
+
+/*!
+@brief 範囲ごとの期待値の表から、値に対応する期待値を取得する。
+@param [in] ranges 期待値の表（値の昇順）
+@param count ranges の要素数
+@param value 変更した値
+@return 期待する戻り値（表に無い場合は OTHER_ERROR ）
+*/
+static int _expectedOf(const ErrorRange ranges[], size_t count, unsigned long value)
+{
+    size_t i;
+
+    for(i = 0; i < count; ++i)
+    {
+        if(ranges[i]._first <= value && value <= ranges[i]._last) return ranges[i]._expected;
+    }
+
+    return OTHER_ERROR;
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char path[TEST_PATH_LENGTH];
+    JpegBuffer *buffer = NULL;
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    unsigned long seek;
+    size_t titleItem;
+    size_t valueItem;
+    size_t length;
+    unsigned long value;
+
+    if(initTestDirectory("app5") != 0) return 1;
+
+    /* 本ライブラリで APP5 セグメントを書き込んだ画像を読み込み、 APP5 セグメントの位置を求める */
+    testPath(path, "hashed.jpg");
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(path, 640, 480, TEST_DATE_TIME, 4096, 1U));
+    baseImage = readTestFile(path, &baseLength);
+    TEST_CHECK(baseImage != NULL);
+    if(baseImage == NULL) goto FINALIZE;
+
+    buffer = (JpegBuffer *)malloc(sizeof(JpegBuffer) + baseLength);
+    TEST_CHECK(buffer != NULL);
+    if(buffer == NULL) goto FINALIZE;
+    buffer->_len = baseLength;
+    memcpy(buffer->_buff, baseImage, baseLength);
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(buffer, &index, NULL));
+    seek = index._startOffset;
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, checkApp5Exists(buffer, &index, &seek));
+    app5Offset = seek;
+    app5Length = 2 + ((baseImage[seek + 2] << 8) | baseImage[seek + 3]);
+    releaseSegmentIndex(&index);
+    free(buffer);
+
+    titleItem = _findItem(ITEM_TITLE_ID);
+    valueItem = _findItem(ITEM_VALUE_ID);
+    TEST_CHECK(titleItem != 0 && valueItem != 0);
+    if(titleItem == 0 || valueItem == 0) goto FINALIZE;
+
+    /* 変更しない（テンプレートの固定位置から取得する） */
+    _resetSegment();
+    _check(app5Length, "unchanged", 0, FUNCTION_SUCCESS);
+
+    /* セグメントの後ろに余分なデータがある（汎用の解析で取得する） */
+    for(length = app5Length + 1; length <= app5Length + 256; ++length)
+    {
+        _resetSegment();
+        _check(length, "padded", (unsigned long)length, FUNCTION_SUCCESS);
+    }
+
+    /* セグメントの途中で切り詰める */
+    for(length = 4; length < app5Length; ++length)
+    {
+        _resetSegment();
+        _check(length, "truncated", (unsigned long)length, _expectedOf(TRUNCATED, sizeof(TRUNCATED) / sizeof(TRUNCATED[0]), length));
+    }
+
+    /* エントリ数を変える */
+    for(value = 0; value <= 0xFFFF; ++value)
+    {
+        _resetSegment();
+        _setShort(ENTRY_COUNT_OFFSET, (unsigned short)value);
+        _check(app5Length, "entry count", value, _expectedOf(ENTRY_COUNT, sizeof(ENTRY_COUNT) / sizeof(ENTRY_COUNT[0]), value));
+    }
+
+    /*
+     * 項目テキストの大きさの定義を変える（セグメントや画像の範囲を超えるものを含む）
+     * 項目テキストの後ろは 0x00 で埋められており、 ID とサイズの 4 バイトずつ読み進めるため、
+     * 内容テキスト 128 の位置と 4 バイト単位で揃う大きさの場合のみハッシュ値を取得できる
+     */
+    for(value = 0; value <= 0xFFFF; ++value)
+    {
+        int expected = _expectedOf(TITLE_SIZE, sizeof(TITLE_SIZE) / sizeof(TITLE_SIZE[0]), value);
+
+        if(expected == OTHER_ERROR)
+        {
+            expected = ((value - TITLE_SIZE_MIN) % 4 == 0) ? FUNCTION_SUCCESS : INCORRECT_APP5_FORMAT;
+        }
+
+        _resetSegment();
+        _setShort(titleItem + 2, (unsigned short)value);
+        _check(app5Length, "title size", value, expected);
+    }
+
+    /* 内容テキスト 128 の大きさの定義を変える（セグメントや画像の範囲を超えるものを含む） */
+    for(value = 0; value <= 0xFFFF; ++value)
+    {
+        _resetSegment();
+        _setShort(valueItem + 2, (unsigned short)value);
+        _check(app5Length, "value size", value, _expectedOf(VALUE_SIZE, sizeof(VALUE_SIZE) / sizeof(VALUE_SIZE[0]), value));
+    }
+
+    /* ハッシュ値の長さを変える（空、 1 文字短い、終端文字を消して後ろのテキストと続ける） */
+    _resetSegment();
+    segment[IMAGE_HASH_OFFSET] = 0x00;
+    _check(app5Length, "empty image hash", 0, HASH_NOT_EXISTS);
+
+    _resetSegment();
+    segment[IMAGE_HASH_OFFSET + HASH_TEXT_LENGTH - 1] = 0x00;
+    _check(app5Length, "short image hash", HASH_TEXT_LENGTH - 1, HASH_NOT_EXISTS);
+
+    _resetSegment();
+    segment[IMAGE_HASH_OFFSET + HASH_TEXT_LENGTH] = 'A';
+    _check(app5Length, "long image hash", HASH_TEXT_LENGTH + 1, HASH_NOT_EXISTS);
+
+    _resetSegment();
+    segment[DATE_HASH_OFFSET] = 0x00;
+    _check(app5Length, "empty date hash", 0, HASH_NOT_EXISTS);
+
+    _resetSegment();
+    segment[DATE_HASH_OFFSET + HASH_TEXT_LENGTH - 1] = 0x00;
+    _check(app5Length, "short date hash", HASH_TEXT_LENGTH - 1, HASH_NOT_EXISTS);
+
+    _resetSegment();
+    segment[DATE_HASH_OFFSET + HASH_TEXT_LENGTH] = 'A';
+    _check(app5Length, "long date hash", HASH_TEXT_LENGTH + 1, HASH_NOT_EXISTS);
+
+FINALIZE:
+
+    free(baseImage);
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
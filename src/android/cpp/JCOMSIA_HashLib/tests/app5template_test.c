@@ -0,0 +1,227 @@
+﻿/*!
+@file app5template_test.c
+@brief 本ライブラリの APP5 テンプレートから固定位置でハッシュ値を取得した結果を、汎用の DCPMI / RMETA 解析の結果と比較するテスト
+@details 本ライブラリで書き込んだ画像について、ハッシュ値の各バイトを全ての値に置き換えたもの、
+ハッシュ値以外の各バイトを変更したものを作成し、getAPP5HashValue と汎用の解析とで
+戻り値・タイトルの有無・取得したハッシュ値のバイト列が一致することを確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app5.h"
+#include "common.h"
+#include "exif.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define IMAGE_HASH_OFFSET ((size_t)718)     /*!< @brief セグメント先頭からハッシュ値（画像）までのバイト数 */
+#define DATE_HASH_OFFSET ((size_t)783)      /*!< @brief セグメント先頭からハッシュ値（撮影日時）までのバイト数 */
+#define HASH_TEXT_LENGTH ((size_t)64)       /*!< @brief ハッシュ値の文字列長 */
+#define IMAGE_COUNT (3)                     /*!< @brief 比較に使う画像の数 */
+/* @} */
+
+/*!
+@brief app5.c の内部関数（ヘッダでは公開していない）
+*/
+int _getDCPMIHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek);
+
+/*!
+@brief app5.c の内部関数（ヘッダでは公開していない）
+*/
+int _getRMETAHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash, unsigned long seek);
+
+/*!
+@brief テンプレートの判定を行わずに、汎用の DCPMI / RMETA 解析でハッシュ値を取得する。
+@details getAPP5HashValue からテンプレートの判定を除いたものと同じ手順で取得する。
+@param [in] src 対象となる JPEG 画像のバイナリ読み込み結果データ構造体
+@param [in] index src から作成したセグメント索引
+@param [out] retImageHash 取得したハッシュ値（画像）を格納する変数
+@param [out] retDateHash 取得したハッシュ値（撮影日時）を格納する変数
+@return getAPP5HashValue と同じ戻り値
+*/
+static int _getGeneralHashValue(JpegBuffer *src, const JpegSegmentIndex *index, APP5Item *retImageHash, APP5Item *retDateHash)
+{
+    int dcpmiRet;
+    int rmetaRet;
+
+    dcpmiRet = _getDCPMIHashValue(src, index, retImageHash, retDateHash, index->_startOffset);
+
+    if(dcpmiRet == FUNCTION_SUCCESS ||
+            (dcpmiRet != HASH_NOT_EXISTS && dcpmiRet != INCORRECT_APP5_FORMAT))
+    {
+        return dcpmiRet;
+    }
+
+    rmetaRet = _getRMETAHashValue(src, index, retImageHash, retDateHash, index->_startOffset);
+
+    if(rmetaRet == APP5_NOT_EXISTS || rmetaRet == INCORRECT_APP5_FORMAT)
+    {
+        return dcpmiRet;
+    }
+
+    return rmetaRet;
+}
+
+/*!
+@brief 取得した 2 つの APP5 項目が、タイトルの有無とハッシュ値のバイト列について一致するかを調べる。
+@param [in] expected 汎用の解析で取得した項目
+@param [in] actual getAPP5HashValue で取得した項目
+@retval 0 一致する
+@retval 1 一致しない
+*/
+static int _compareItem(const APP5Item *expected, const APP5Item *actual)
+{
+    if(expected->titleExistsFlag != actual->titleExistsFlag) return 1;
+    if((expected->value._ptr == NULL) != (actual->value._ptr == NULL)) return 1;
+    if(expected->value._ptr == NULL) return 0;
+    if(expected->value._len != actual->value._len) return 1;
+
+    return memcmp(expected->value._ptr, actual->value._ptr, expected->value._len) == 0 ? 0 : 1;
+}
+
+/*!
+@brief getAPP5HashValue と汎用の解析でハッシュ値を取得し、結果を比較する。
+@param [in] buffer 対象となる JPEG 画像
+@param [in] label 失敗時に表示する場面の名前
+@param offset 変更したバイトの APP5 セグメント先頭からの位置
+@param value 変更後のバイトの値
+*/
+static void _compare(JpegBuffer *buffer, const char *label, size_t offset, unsigned char value)
+{
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    APP5Item expectedImage = {JACIC_BOOL_FALSE, {NULL, 0}};
+    APP5Item expectedDate = {JACIC_BOOL_FALSE, {NULL, 0}};
+    APP5Item actualImage = {JACIC_BOOL_FALSE, {NULL, 0}};
+    APP5Item actualDate = {JACIC_BOOL_FALSE, {NULL, 0}};
+    int expected;
+    int actual;
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(buffer, &index, NULL));
+
+    expected = _getGeneralHashValue(buffer, &index, &expectedImage, &expectedDate);
+    actual = getAPP5HashValue(buffer, &index, &actualImage, &actualDate);
+
+    if(expected != actual ||
+            _compareItem(&expectedImage, &actualImage) != 0 ||
+            _compareItem(&expectedDate, &actualDate) != 0)
+    {
+        fprintf(stderr, "%s: offset %lu, value 0x%02X: expected %d, got %d\n", label,
+                (unsigned long)offset, value, expected, actual);
+        ++testFailures;
+    }
+
+    releaseSegmentIndex(&index);
+}
+
+/*!
+@brief 1 枚の画像について、 APP5 セグメントの各バイトを変更して比較する。
+@param [in] path 画像を書き込むファイル
+@param [in] dateTime 撮影日時
+@param seed 画像データを作る疑似乱数の種
+*/
+static void _checkImage(const char *path, const char *dateTime, unsigned int seed)
+{
+    unsigned char *image;
+    JpegBuffer *buffer;
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    unsigned long seek;
+    unsigned char *app5;
+    size_t app5Length;
+    size_t length = 0;
+    size_t offset;
+    unsigned char original;
+    unsigned int value;
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(path, 640, 480, dateTime, 4096, seed));
+    image = readTestFile(path, &length);
+    TEST_CHECK(image != NULL);
+    if(image == NULL) return;
+
+    buffer = (JpegBuffer *)malloc(sizeof(JpegBuffer) + length);
+    TEST_CHECK(buffer != NULL);
+    if(buffer == NULL)
+    {
+        free(image);
+        return;
+    }
+    buffer->_len = length;
+    memcpy(buffer->_buff, image, length);
+    free(image);
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(buffer, &index, NULL));
+    seek = index._startOffset;
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, checkApp5Exists(buffer, &index, &seek));
+    releaseSegmentIndex(&index);
+
+    app5 = buffer->_buff + seek;
+    app5Length = 2 + ((app5[2] << 8) | app5[3]);
+
+    /* 変更しない */
+    _compare(buffer, "unchanged", 0, 0);
+
+    /* ハッシュ値の各バイトを全ての値に置き換える（ 0x00 の場合は汎用の解析に任せる） */
+    for(offset = IMAGE_HASH_OFFSET; offset < DATE_HASH_OFFSET + HASH_TEXT_LENGTH; ++offset)
+    {
+        if(IMAGE_HASH_OFFSET + HASH_TEXT_LENGTH <= offset && offset < DATE_HASH_OFFSET) continue;
+
+        original = app5[offset];
+
+        for(value = 0; value <= 0xFF; ++value)
+        {
+            app5[offset] = (unsigned char)value;
+            _compare(buffer, "hash", offset, (unsigned char)value);
+        }
+
+        app5[offset] = original;
+    }
+
+    /* ハッシュ値以外の各バイトを変更する（テンプレートと一致しなくなるため汎用の解析で取得する） */
+    for(offset = 0; offset < app5Length; ++offset)
+    {
+        if((IMAGE_HASH_OFFSET <= offset && offset < IMAGE_HASH_OFFSET + HASH_TEXT_LENGTH) ||
+                (DATE_HASH_OFFSET <= offset && offset < DATE_HASH_OFFSET + HASH_TEXT_LENGTH)) continue;
+
+        /* マーカーとセグメントの長さはセグメント索引が変わるため対象外とする */
+        if(offset < 4) continue;
+
+        original = app5[offset];
+
+        app5[offset] = (unsigned char)(original ^ 0xFF);
+        _compare(buffer, "template", offset, app5[offset]);
+
+        app5[offset] = (unsigned char)(original ^ 0x01);
+        _compare(buffer, "template", offset, app5[offset]);
+
+        app5[offset] = original;
+    }
+
+    free(buffer);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const char *DATE_TIMES[IMAGE_COUNT] = { TEST_DATE_TIME, "2021:12:31 23:59:59", "1999:01:01 00:00:00" };
+
+    char path[TEST_PATH_LENGTH];
+    unsigned int i;
+
+    if(initTestDirectory("app5template") != 0) return 1;
+
+    testPath(path, "hashed.jpg");
+
+    for(i = 0; i < IMAGE_COUNT; ++i)
+    {
+        _checkImage(path, DATE_TIMES[i], i + 1U);
+    }
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
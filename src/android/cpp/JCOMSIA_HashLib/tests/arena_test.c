@@ -0,0 +1,120 @@
+﻿/*!
+@file arena_test.c
+@brief 1 回の検証・埋め込みで発生するヒープ操作の回数を検査するテスト
+@details 作業用の一時領域がアリーナの初期領域に収まり、ヒープの確保は入出力用の領域のみであることを確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define REPEAT_COUNT (16)               /*!< @brief 各 API を呼び出す回数 */
+#define MAX_HEAP_CALLS_PER_CHECK (1)    /*!< @brief 1 回の検証で許容するヒープ確保の回数（ファイルの読み込み先） */
+#define MAX_HEAP_CALLS_PER_WRITE (2)    /*!< @brief 1 回の埋め込みで許容するヒープ確保の回数（入力の複製と出力） */
+/* @} */
+
+/*!
+@struct HeapCounter
+@brief JCOMSIA_SetAllocator に指定した関数の呼び出し回数
+*/
+typedef struct
+{
+    size_t _allocCount;     /*!< @brief 確保した回数 */
+    size_t _freeCount;      /*!< @brief 解放した回数 */
+} HeapCounter;
+
+/*!
+@brief 呼び出し回数を数えてメモリを確保する。
+@param size 確保するバイト数
+@param context HeapCounter
+@return 確保した領域
+*/
+static void *_countingAlloc(size_t size, void *context)
+{
+    ((HeapCounter *)context)->_allocCount++;
+
+    return malloc(size);
+}
+
+/*!
+@brief 呼び出し回数を数えてメモリを解放する。
+@param ptr 解放する領域
+@param context HeapCounter
+*/
+static void _countingFree(void *ptr, void *context)
+{
+    ((HeapCounter *)context)->_freeCount++;
+
+    free(ptr);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char path[TEST_PATH_LENGTH];
+    unsigned char *source = NULL;
+    unsigned char *hashed = NULL;
+    size_t sourceLength = 0;
+    size_t hashedLength = 0;
+    HeapCounter counter = {0, 0};
+    ArenaStatistics statistics;
+    int i;
+
+    if(initTestDirectory("arena") != 0) return 1;
+
+    source = createTestJpeg(640, 480, TEST_DATE_TIME, 64 * 1024, 1U, &sourceLength);
+    TEST_CHECK(source != NULL);
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(testPath(path, "hashed.jpg"), 640, 480, TEST_DATE_TIME, 64 * 1024, 1U));
+
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(_countingAlloc, _countingFree, &counter));
+
+    /* ファイルの検証 */
+    resetArenaStatistics();
+    for(i = 0; i < REPEAT_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(JC_OK, JCOMSIA_CheckHashValue(path));
+    }
+    getArenaStatistics(&statistics);
+    printf("check: %u heap calls, %u arena allocations, %u arena heap blocks per call\n",
+           (unsigned int)(counter._allocCount / REPEAT_COUNT),
+           (unsigned int)(statistics._allocCount / REPEAT_COUNT),
+           (unsigned int)(statistics._heapCount / REPEAT_COUNT));
+    TEST_CHECK(0 < statistics._allocCount);
+    TEST_CHECK_EQUAL(0, statistics._heapCount);
+    TEST_CHECK(counter._allocCount <= (size_t)MAX_HEAP_CALLS_PER_CHECK * REPEAT_COUNT);
+    TEST_CHECK_EQUAL(counter._allocCount, counter._freeCount);
+
+    /* メモリ上の画像への埋め込み（出力の確保を含む） */
+    counter._allocCount = 0;
+    counter._freeCount = 0;
+    resetArenaStatistics();
+    for(i = 0; i < REPEAT_COUNT && source != NULL; ++i)
+    {
+        TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_WriteHashValueMem(source, sourceLength, &hashed, &hashedLength));
+        JCOMSIA_FreeImageData(&hashed);
+    }
+    getArenaStatistics(&statistics);
+    printf("write: %u heap calls, %u arena allocations, %u arena heap blocks per call\n",
+           (unsigned int)(counter._allocCount / REPEAT_COUNT),
+           (unsigned int)(statistics._allocCount / REPEAT_COUNT),
+           (unsigned int)(statistics._heapCount / REPEAT_COUNT));
+    TEST_CHECK(0 < statistics._allocCount);
+    TEST_CHECK_EQUAL(0, statistics._heapCount);
+    TEST_CHECK(counter._allocCount <= (size_t)MAX_HEAP_CALLS_PER_WRITE * REPEAT_COUNT);
+    TEST_CHECK_EQUAL(counter._allocCount, counter._freeCount);
+
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+
+    free(source);
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
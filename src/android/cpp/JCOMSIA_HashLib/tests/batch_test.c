@@ -0,0 +1,236 @@
+﻿/*!
+@file batch_test.c
+@brief 一括チェックの結果が、1 件ずつチェックした結果と一致することを検査するテスト
+@details 正常な画像、改ざんした画像、ハッシュ値のない画像、存在しないファイルなどを混ぜ、
+スレッド数を変えて JCOMSIA_CheckHashValueBatch / JCOMSIA_SVG_CheckHashValueBatch を呼び出す。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define FIXTURE_COUNT (8)       /*!< @brief 画像ファイルの種類の数 */
+#define PATH_COUNT (40)         /*!< @brief 一括チェックに渡すパスの数（種類を繰り返して並べる） */
+#define SCAN_LENGTH (32 * 1024) /*!< @brief テスト用画像の画像データのバイト数 */
+/* @} */
+
+/*! 試すスレッド数（0 は利用可能な CPU 数） */
+static const size_t THREAD_COUNTS[] = { 1, 2, 3, 4, 8, 0 };
+
+/*!
+@brief 画像データの途中の 1 バイトを書き換える。
+@param [in, out] data 画像
+@param length data の長さ
+*/
+static void _tamperScanData(unsigned char *data, size_t length)
+{
+    size_t i = length - 64;
+
+    /* マーカーやスタッフィングに関係しないバイトを選ぶ */
+    while(data[i] == 0xFF || data[i - 1] == 0xFF || (data[i] ^ 0x01) == 0xFF)
+    {
+        --i;
+    }
+    data[i] ^= 0x01;
+}
+
+/*!
+@brief 画像内の撮影日時の文字列を書き換える。
+@param [in, out] data 画像
+@param length data の長さ
+@retval 0 成功
+@retval -1 撮影日時が見つからない場合
+*/
+static int _tamperDateTime(unsigned char *data, size_t length)
+{
+    size_t dateLength = strlen(TEST_DATE_TIME);
+    size_t i;
+
+    for(i = 0; i + dateLength <= length; ++i)
+    {
+        if(memcmp(data + i, TEST_DATE_TIME, dateLength) == 0)
+        {
+            /* 年の 1 桁を変える */
+            data[i + 3] = '1';
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/*!
+@brief ファイルを読み込み、改ざんして別のファイルに書き込む。
+@param [in] srcPath 読み込むファイル
+@param [in] dstPath 書き込み先
+@param dateOnly 0 以外の場合は撮影日時を、0 の場合は画像データを書き換える
+@retval 0 成功
+@retval -1 失敗
+*/
+static int _writeTamperedCopy(const char *srcPath, const char *dstPath, int dateOnly)
+{
+    unsigned char *data;
+    size_t length = 0;
+    int ret = 0;
+
+    if((data = readTestFile(srcPath, &length)) == NULL) return -1;
+
+    if(dateOnly)
+    {
+        ret = _tamperDateTime(data, length);
+    }
+    else
+    {
+        _tamperScanData(data, length);
+    }
+
+    if(ret == 0)
+    {
+        ret = writeTestFile(dstPath, data, length);
+    }
+
+    free(data);
+
+    return ret;
+}
+
+/*!
+@brief 一括チェックの結果を 1 件ずつの結果と比較する。
+@param [in] name 表示に使用する名前
+@param batchFunction 一括チェック関数
+@param singleFunction 1 件ずつのチェック関数
+@param [in] paths チェックするパス
+*/
+static void _compareBatch(const char *name,
+                          int (WINAPI *batchFunction)(const char **, size_t, int *, const JCOMSIA_BatchOptions *),
+                          int (WINAPI *singleFunction)(const char *),
+                          const char **paths)
+{
+    int expected[PATH_COUNT];
+    int actual[PATH_COUNT];
+    JCOMSIA_BatchOptions options;
+    size_t i;
+    size_t j;
+
+    for(i = 0; i < PATH_COUNT; ++i)
+    {
+        expected[i] = singleFunction(paths[i]);
+    }
+
+    for(j = 0; j <= sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); ++j)
+    {
+        memset(actual, 0x7F, sizeof(actual));
+
+        if(j < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]))
+        {
+            options.threadCount = THREAD_COUNTS[j];
+            TEST_CHECK_EQUAL(JW_SUCCESS, batchFunction(paths, PATH_COUNT, actual, &options));
+        }
+        else
+        {
+            /* 既定値 */
+            TEST_CHECK_EQUAL(JW_SUCCESS, batchFunction(paths, PATH_COUNT, actual, NULL));
+        }
+
+        for(i = 0; i < PATH_COUNT; ++i)
+        {
+            if(expected[i] != actual[i])
+            {
+                fprintf(stderr, "%s: options %u, %s: batch %d, sequential %d\n",
+                        name, (unsigned int)j, paths[i], actual[i], expected[i]);
+                ++testFailures;
+            }
+        }
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const char * const JPEG_NAMES[FIXTURE_COUNT] =
+    {
+        "ok1.jpg", "ok2.jpg", "ok3.jpg", "image_ng.jpg", "date_ng.jpg", "plain.jpg", "empty.jpg", "missing.jpg"
+    };
+    static const char * const SVG_NAMES[FIXTURE_COUNT] =
+    {
+        "pair.svg", "original.svg", "pair2.svg", "image_ng.svg", "date_ng.svg", "truncated.svg", "empty.svg", "missing.svg"
+    };
+    char jpegPaths[FIXTURE_COUNT][TEST_PATH_LENGTH];
+    char svgPaths[FIXTURE_COUNT][TEST_PATH_LENGTH];
+    const char *paths[PATH_COUNT];
+    unsigned char *plain;
+    unsigned char *svg;
+    size_t length = 0;
+    int results[PATH_COUNT];
+    size_t i;
+
+    if(initTestDirectory("batch") != 0) return 1;
+
+    for(i = 0; i < FIXTURE_COUNT; ++i)
+    {
+        testPath(jpegPaths[i], JPEG_NAMES[i]);
+        testPath(svgPaths[i], SVG_NAMES[i]);
+    }
+
+    /* JPEG */
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(jpegPaths[0], 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(jpegPaths[1], 320, 240, TEST_DATE_TIME, SCAN_LENGTH * 3, 2U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(jpegPaths[2], 200, 120, TEST_DATE_TIME, SCAN_LENGTH / 4, 3U));
+    TEST_CHECK_EQUAL(0, _writeTamperedCopy(jpegPaths[0], jpegPaths[3], 0));
+    TEST_CHECK_EQUAL(0, _writeTamperedCopy(jpegPaths[1], jpegPaths[4], 1));
+    plain = createTestJpeg(640, 480, TEST_DATE_TIME, SCAN_LENGTH, 4U, &length);
+    TEST_CHECK(plain != NULL && writeTestFile(jpegPaths[5], plain, length) == 0);
+    free(plain);
+    TEST_CHECK_EQUAL(0, writeTestFile(jpegPaths[6], (const unsigned char *)"", 0));
+
+    TEST_CHECK_EQUAL(JC_OK, JCOMSIA_CheckHashValue(jpegPaths[0]));
+    TEST_CHECK_EQUAL(JC_NG_IMAGE, JCOMSIA_CheckHashValue(jpegPaths[3]));
+    TEST_CHECK_EQUAL(JC_NG_DATE, JCOMSIA_CheckHashValue(jpegPaths[4]));
+
+    /* SVG */
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPaths[0], jpegPaths[0], jpegPaths[2], "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPaths[1], jpegPaths[1], NULL, "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPaths[2], jpegPaths[1], jpegPaths[2], "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPaths[3], jpegPaths[3], NULL, "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPaths[4], jpegPaths[4], NULL, "vender"));
+    svg = readTestFile(svgPaths[0], &length);
+    TEST_CHECK(svg != NULL && writeTestFile(svgPaths[5], svg, length / 2) == 0);
+    free(svg);
+    TEST_CHECK_EQUAL(0, writeTestFile(svgPaths[6], (const unsigned char *)"", 0));
+
+    TEST_CHECK_EQUAL(JC_SVG_RESULT_OK, JCOMSIA_SVG_CheckHashValue(svgPaths[0]));
+    TEST_CHECK_EQUAL(JC_SVG_RESULT_OK, JCOMSIA_SVG_CheckHashValue(svgPaths[1]));
+    TEST_CHECK_EQUAL(JC_NG_IMAGE, JCOMSIA_SVG_CheckHashValue(svgPaths[3]));
+    TEST_CHECK_EQUAL(JC_NG_DATE, JCOMSIA_SVG_CheckHashValue(svgPaths[4]));
+
+    /* 種類を繰り返して並べ、ワーカー間の分担が偏らないようにする */
+    for(i = 0; i < PATH_COUNT; ++i)
+    {
+        paths[i] = jpegPaths[(i * 3) % FIXTURE_COUNT];
+    }
+    _compareBatch("JCOMSIA_CheckHashValueBatch", JCOMSIA_CheckHashValueBatch, JCOMSIA_CheckHashValue, paths);
+
+    for(i = 0; i < PATH_COUNT; ++i)
+    {
+        paths[i] = svgPaths[(i * 3) % FIXTURE_COUNT];
+    }
+    _compareBatch("JCOMSIA_SVG_CheckHashValueBatch", JCOMSIA_SVG_CheckHashValueBatch, JCOMSIA_SVG_CheckHashValue, paths);
+
+    /* 不正な引数 */
+    TEST_CHECK_EQUAL(JC_ERROR_INCORRECT_PARAMETER, JCOMSIA_CheckHashValueBatch(NULL, 1, results, NULL));
+    TEST_CHECK_EQUAL(JC_ERROR_INCORRECT_PARAMETER, JCOMSIA_CheckHashValueBatch(paths, 1, NULL, NULL));
+    TEST_CHECK_EQUAL(JC_SVG_ERROR_INCORRECT_PARAMETER, JCOMSIA_SVG_CheckHashValueBatch(NULL, 1, results, NULL));
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
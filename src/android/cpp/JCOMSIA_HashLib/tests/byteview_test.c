@@ -0,0 +1,237 @@
+﻿/*!
+@file byteview_test.c
+@brief 読み込んだ画像の一部を複製せずに参照する処理 (clipCompressedImage / getByteText / getDateTimeOriginal) のテスト
+@details 手で組み立てた画像について、取得した参照が元の領域の既知の範囲を指すことを確認する。
+圧縮データは SOS から EOI まで（ EOI より後ろのデータ、スタッフィングされた 0xFF と RST マーカーでは終わらない）、
+テキストは終端文字の直前までを参照する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app1.h"
+#include "common.h"
+#include "exif.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define IMAGE_CAPACITY ((size_t)256)    /*!< @brief 組み立てる画像の最大長 */
+#define SOS_OFFSET (24UL)               /*!< @brief IMAGE の SOS の位置 */
+#define EOI_END (48UL)                  /*!< @brief IMAGE の EOI の直後の位置 */
+/* @} */
+
+/*!
+@brief 圧縮データの参照を確認する画像
+@details SOS の後の画像データに、スタッフィングされた 0xFF 、 RST マーカー、連続する 0xFF を含める。
+EOI の後ろには冗長なデータを置く。
+*/
+static const unsigned char IMAGE[] =
+{
+    0xFF, 0xD8,                                                             /*  0: SOI */
+    0xFF, 0xE5, 0x00, 0x08, 'D', 'C', 'P', 'M', 'I', 0x00,                  /*  2: APP5 */
+    0xFF, 0xDB, 0x00, 0x04, 0x00, 0x01,                                     /* 12: DQT */
+    0xFF, 0xC0, 0x00, 0x04, 0x08, 0x00,                                     /* 18: SOF0 */
+    0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00,             /* 24: SOS */
+    0x12, 0xFF, 0x00, 0x34, 0xFF, 0xD0, 0x56, 0xFF, 0xFF, 0xD1, 0x78, 0x9A, /* 34: 画像データ */
+    0xFF, 0xD9,                                                             /* 46: EOI */
+    0x00, 0xFF, 0xD9, 0x11                                                  /* 48: 冗長なデータ */
+};
+
+/*!
+@brief バイト配列から画像のバイナリ構造体を作成する。
+@param [out] storage 構造体の領域（sizeof(JpegBuffer) + IMAGE_CAPACITY バイト）
+@param [in] data 画像
+@param length data の長さ
+@return storage を指す構造体
+*/
+static JpegBuffer *_makeBuffer(unsigned char *storage, const unsigned char *data, size_t length)
+{
+    JpegBuffer *buffer = (JpegBuffer *)storage;
+
+    buffer->_len = length;
+    memcpy(buffer->_buff, data, length);
+
+    return buffer;
+}
+
+/*!
+@brief バイト配列から文字列を探す。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@param [in] text 探す文字列
+@return 最初に見つかった位置（見つからなかった場合は NULL ）
+*/
+static const unsigned char *_find(const unsigned char *data, size_t length, const char *text)
+{
+    size_t textLength = strlen(text);
+    size_t i;
+
+    for(i = 0; i + textLength <= length; ++i)
+    {
+        if(memcmp(data + i, text, textLength) == 0) return data + i;
+    }
+
+    return NULL;
+}
+
+/*!
+@brief 圧縮データを参照し、戻り値と参照する範囲を確認する。
+@param [in] label 失敗時に表示する場面の名前
+@param [in] buffer 対象となる画像
+@param ignoreApp5Flag clipCompressedImage に渡す値
+@param expected 期待する戻り値
+@param start 期待する参照の開始位置（ expected が FUNCTION_SUCCESS の場合のみ使用する）
+@param end 期待する参照の終了位置（同上）
+*/
+static void _checkClip(const char *label, JpegBuffer *buffer, JACIC_BOOL ignoreApp5Flag, int expected, unsigned long start, unsigned long end)
+{
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    ByteView view = {NULL, 0};
+    int actual;
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(buffer, &index, NULL));
+    actual = clipCompressedImage(buffer, &index, &view, ignoreApp5Flag);
+
+    if(actual != expected)
+    {
+        fprintf(stderr, "%s: expected %d, got %d\n", label, expected, actual);
+        ++testFailures;
+    }
+    else if(actual == FUNCTION_SUCCESS)
+    {
+        if(view._ptr != buffer->_buff + start || view._len != (size_t)(end - start))
+        {
+            fprintf(stderr, "%s: expected %lu..%lu, got %ld..%ld\n", label, start, end,
+                    (long)(view._ptr - buffer->_buff), (long)(view._ptr - buffer->_buff + (long)view._len));
+            ++testFailures;
+        }
+    }
+    else
+    {
+        TEST_CHECK(view._ptr == NULL && view._len == 0);
+    }
+
+    releaseSegmentIndex(&index);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const unsigned char TEXTS[] = { 'a', 'b', 'c', 0x00, 0x00, 'd', 'e', 0x00, 'f', 'g' };
+
+    unsigned char storage[sizeof(JpegBuffer) + IMAGE_CAPACITY];
+    unsigned char data[IMAGE_CAPACITY];
+    unsigned char arenaBuff[512];
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    JpegBuffer *buffer;
+    HashBuffer *dateBin = NULL;
+    ByteView source;
+    ByteView text;
+    Arena arena;
+    unsigned char *image;
+    const unsigned char *dateOffset;
+    unsigned long seek;
+    size_t imageLength = 0;
+
+    /* SOS から EOI まで（ EOI より後ろは含まない） */
+    buffer = _makeBuffer(storage, IMAGE, sizeof(IMAGE));
+    _checkClip("basic", buffer, JACIC_BOOL_FALSE, FUNCTION_SUCCESS, SOS_OFFSET, EOI_END);
+    _checkClip("APP5", buffer, JACIC_BOOL_TRUE, APP5_ALREADY_EXISTS, 0, 0);
+
+    /* データが EOI で終わる */
+    buffer = _makeBuffer(storage, IMAGE, EOI_END);
+    _checkClip("ends with EOI", buffer, JACIC_BOOL_FALSE, FUNCTION_SUCCESS, SOS_OFFSET, EOI_END);
+
+    /* EOI が無い（ EOI の 1 バイト目でデータが終わる場合を含む） */
+    buffer = _makeBuffer(storage, IMAGE, EOI_END - 1);
+    _checkClip("no EOI", buffer, JACIC_BOOL_FALSE, INCORRECT_EXIF_FORMAT, 0, 0);
+    buffer = _makeBuffer(storage, IMAGE, SOS_OFFSET + 2);
+    _checkClip("no scan", buffer, JACIC_BOOL_FALSE, INCORRECT_EXIF_FORMAT, 0, 0);
+
+    /* SOS の直後の EOI */
+    memcpy(data, IMAGE, SOS_OFFSET + 2);
+    data[SOS_OFFSET + 2] = 0xFF;
+    data[SOS_OFFSET + 3] = 0xD9;
+    buffer = _makeBuffer(storage, data, SOS_OFFSET + 4);
+    _checkClip("empty scan", buffer, JACIC_BOOL_FALSE, FUNCTION_SUCCESS, SOS_OFFSET, SOS_OFFSET + 4);
+
+    /* SOS より前の EOI */
+    memcpy(data, IMAGE, sizeof(IMAGE));
+    data[19] = 0xD9;
+    buffer = _makeBuffer(storage, data, sizeof(IMAGE));
+    _checkClip("EOI before SOS", buffer, JACIC_BOOL_FALSE, INCORRECT_EXIF_FORMAT, 0, 0);
+
+    /* 終端文字までのテキスト（空のテキスト、終端文字の無いテキストを含む） */
+    source._ptr = TEXTS;
+    source._len = sizeof(TEXTS);
+    seek = 0;
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, getByteText(&source, &text, &seek));
+    TEST_CHECK(text._ptr == TEXTS && text._len == 3);
+    TEST_CHECK_EQUAL(4, seek);
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, getByteText(&source, &text, &seek));
+    TEST_CHECK(text._ptr == TEXTS + 4 && text._len == 0);
+    TEST_CHECK_EQUAL(5, seek);
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, getByteText(&source, &text, &seek));
+    TEST_CHECK(text._ptr == TEXTS + 5 && text._len == 2);
+    TEST_CHECK_EQUAL(8, seek);
+
+    TEST_CHECK_EQUAL(INCORRECT_TEXT, getByteText(&source, &text, &seek));
+    TEST_CHECK_EQUAL(sizeof(TEXTS), seek);
+    TEST_CHECK_EQUAL(INCORRECT_TEXT, getByteText(&source, &text, &seek));
+
+    /* 参照の長さを終端文字の手前で切った場合は、参照の外を探さない */
+    source._len = 3;
+    seek = 0;
+    TEST_CHECK_EQUAL(INCORRECT_TEXT, getByteText(&source, &text, &seek));
+    TEST_CHECK_EQUAL(3, seek);
+
+    /* 撮影日時（ APP1 の値を参照して取得する） */
+    image = createTestJpeg(640, 480, TEST_DATE_TIME, 1024, 1U, &imageLength);
+    TEST_CHECK(image != NULL);
+    if(image != NULL)
+    {
+        JpegBuffer *imageBuffer = (JpegBuffer *)malloc(sizeof(JpegBuffer) + imageLength);
+
+        TEST_CHECK(imageBuffer != NULL);
+        if(imageBuffer != NULL)
+        {
+            imageBuffer->_len = imageLength;
+            memcpy(imageBuffer->_buff, image, imageLength);
+
+            arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+            TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(imageBuffer, &index, NULL));
+            TEST_CHECK_EQUAL(FUNCTION_SUCCESS, getDateTimeOriginal(imageBuffer, &index, &arena, &dateBin));
+            TEST_CHECK(dateBin != NULL && dateBin->_len >= strlen(TEST_DATE_TIME) &&
+                    memcmp(dateBin->_buff, TEST_DATE_TIME, strlen(TEST_DATE_TIME)) == 0);
+            releaseSegmentIndex(&index);
+            arenaRelease(&arena);
+
+            /* 撮影日時の途中でデータが終わる（データ終端を超えて参照せず、撮影日時が無いものとして扱う） */
+            dateOffset = _find(image, imageLength, TEST_DATE_TIME);
+            TEST_CHECK(dateOffset != NULL);
+            if(dateOffset != NULL)
+            {
+                imageBuffer->_len = (size_t)(dateOffset - image) + 5;
+
+                arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+                TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(imageBuffer, &index, NULL));
+                TEST_CHECK_EQUAL(DATE_NOT_EXISTS, getDateTimeOriginal(imageBuffer, &index, &arena, &dateBin));
+                releaseSegmentIndex(&index);
+                arenaRelease(&arena);
+            }
+
+            free(imageBuffer);
+        }
+    }
+    free(image);
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+﻿/*!
+@file cache_test.c
+@brief 検証結果キャッシュの利用と再検証を検査するテスト
+@details 識別情報が一致するファイルにはキャッシュの結果が返り、更新日時を変更したファイルや、
+更新日時を元に戻して内容を変更したファイル（状態変更日時が変わる）は検証し直されることを確認する。
+*/
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "svg.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define SCAN_LENGTH (32 * 1024) /*!< @brief テスト用画像の画像データのバイト数 */
+#define FILE_AGE (3600)         /*!< @brief テスト用ファイルに設定する更新日時の古さ（秒） */
+#define RACY_WAIT (3)           /*!< @brief 状態変更日時が記録される古さになるまで待つ時間（秒） */
+/* @} */
+
+/*!
+@brief ファイルの更新日時を設定する。
+@param [in] path 対象のファイル
+@param seconds 更新日時（秒）
+@retval 0 成功
+@retval -1 失敗
+*/
+static int _setModifiedTime(const char *path, time_t seconds)
+{
+    struct timespec times[2];
+
+    times[0].tv_sec = seconds;
+    times[0].tv_nsec = 0;
+    times[1] = times[0];
+
+    return utimensat(AT_FDCWD, path, times, 0);
+}
+
+/*!
+@brief ファイルの内容を改ざんし、更新日時を元に戻す。
+@details サイズと i ノード番号、更新日時は変わらないが、状態変更日時は変わる。
+@param [in] path 対象のファイル
+@param [in] tampered 改ざん後のファイル
+@param seconds 元の更新日時（秒）
+@retval 0 成功
+@retval -1 失敗
+*/
+static int _replaceKeepingTime(const char *path, const char *tampered, time_t seconds)
+{
+    unsigned char *data;
+    size_t length = 0;
+    int ret;
+
+    if((data = readTestFile(tampered, &length)) == NULL) return -1;
+    ret = writeTestFile(path, data, length);
+    free(data);
+
+    if(ret != 0) return -1;
+
+    return _setModifiedTime(path, seconds);
+}
+
+/*!
+@brief ファイルを検証し、結果と、キャッシュの結果が返ったかを確認する。
+@details キャッシュの結果が返った場合は画像を読み込まないため、アリーナの割り当ても SVG ファイルの解析も行われない。
+@param [in] path 対象のファイル
+@param svg SVG ファイルの場合は JACIC_BOOL_TRUE
+@param expected 期待する検証結果
+@param cached キャッシュの結果が返ることを期待する場合は JACIC_BOOL_TRUE
+*/
+static void _check(const char *path, JACIC_BOOL svg, int expected, JACIC_BOOL cached)
+{
+    ArenaStatistics arena;
+    SVGParseStatistics parse;
+    int result;
+    JACIC_BOOL verified;
+
+    resetArenaStatistics();
+    resetSVGParseStatistics();
+
+    result = svg ? JCOMSIA_SVG_CheckHashValue(path) : JCOMSIA_CheckHashValue(path);
+
+    getArenaStatistics(&arena);
+    getSVGParseStatistics(&parse);
+    verified = (arena._allocCount != 0 || parse._parseCount != 0 || parse._streamingCount != 0) ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE;
+
+    if(result != expected || verified == cached)
+    {
+        fprintf(stderr, "%s: expected %d (%s), got %d (%s)\n", path,
+                expected, cached ? "cached" : "verified", result, verified ? "verified" : "cached");
+        ++testFailures;
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char cachePath[TEST_PATH_LENGTH];
+    char imagePath[TEST_PATH_LENGTH];
+    char tamperedPath[TEST_PATH_LENGTH];
+    char svgPath[TEST_PATH_LENGTH];
+    char tamperedSvgPath[TEST_PATH_LENGTH];
+    unsigned char *data;
+    size_t length = 0;
+    size_t i;
+    struct stat cacheStat;
+    time_t modifiedTime = time(NULL) - FILE_AGE;
+
+    if(initTestDirectory("cache") != 0) return 1;
+
+    testPath(cachePath, "verification.cache");
+    testPath(imagePath, "image.jpg");
+    testPath(tamperedPath, "tampered.jpg");
+    testPath(svgPath, "image.svg");
+    testPath(tamperedSvgPath, "tampered.svg");
+
+    /* 同じサイズで画像データのみ異なるファイルを用意する */
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(imagePath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    data = readTestFile(imagePath, &length);
+    TEST_CHECK(data != NULL);
+    if(data == NULL) return 1;
+    for(i = length - 64; data[i] == 0xFF || data[i - 1] == 0xFF || (data[i] ^ 0x01) == 0xFF; --i)
+    {
+        /* マーカーやスタッフィングに関係しないバイトを選ぶ */
+    }
+    data[i] ^= 0x01;
+    TEST_CHECK_EQUAL(0, writeTestFile(tamperedPath, data, length));
+    free(data);
+    TEST_CHECK_EQUAL(JC_NG_IMAGE, JCOMSIA_CheckHashValue(tamperedPath));
+
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPath, imagePath, NULL, "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(tamperedSvgPath, tamperedPath, NULL, "vender"));
+    TEST_CHECK_EQUAL(JC_NG_IMAGE, JCOMSIA_SVG_CheckHashValue(tamperedSvgPath));
+
+    /* キャッシュファイルは umask によらず所有者のみ読み書きできる */
+    umask(0);
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetVerificationCache(cachePath));
+    TEST_CHECK_EQUAL(0, stat(cachePath, &cacheStat));
+    TEST_CHECK_EQUAL(0600, cacheStat.st_mode & 0777);
+
+    /* 状態変更日時は過去にできないため、記録されるまで待ってから検証する */
+    TEST_CHECK_EQUAL(0, _setModifiedTime(imagePath, modifiedTime));
+    TEST_CHECK_EQUAL(0, _setModifiedTime(svgPath, modifiedTime));
+    sleep(RACY_WAIT);
+    _check(imagePath, JACIC_BOOL_FALSE, JC_OK, JACIC_BOOL_FALSE);
+    _check(svgPath, JACIC_BOOL_TRUE, JC_SVG_RESULT_OK, JACIC_BOOL_FALSE);
+
+    /* 識別情報が一致する間はキャッシュの結果が返る（キャッシュを開き直しても同じ） */
+    _check(imagePath, JACIC_BOOL_FALSE, JC_OK, JACIC_BOOL_TRUE);
+    _check(svgPath, JACIC_BOOL_TRUE, JC_SVG_RESULT_OK, JACIC_BOOL_TRUE);
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetVerificationCache(NULL));
+    _check(imagePath, JACIC_BOOL_FALSE, JC_OK, JACIC_BOOL_FALSE);
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetVerificationCache(cachePath));
+    _check(imagePath, JACIC_BOOL_FALSE, JC_OK, JACIC_BOOL_TRUE);
+
+    /* 更新日時が変わると検証し直す */
+    TEST_CHECK_EQUAL(0, _setModifiedTime(imagePath, modifiedTime + 1));
+    TEST_CHECK_EQUAL(0, _setModifiedTime(svgPath, modifiedTime + 1));
+    _check(imagePath, JACIC_BOOL_FALSE, JC_OK, JACIC_BOOL_FALSE);
+    _check(svgPath, JACIC_BOOL_TRUE, JC_SVG_RESULT_OK, JACIC_BOOL_FALSE);
+
+    /* 更新日時を元に戻して改ざんしても、状態変更日時が変わるため検証し直す */
+    TEST_CHECK_EQUAL(0, _replaceKeepingTime(imagePath, tamperedPath, modifiedTime + 1));
+    TEST_CHECK_EQUAL(0, _replaceKeepingTime(svgPath, tamperedSvgPath, modifiedTime + 1));
+    _check(imagePath, JACIC_BOOL_FALSE, JC_NG_IMAGE, JACIC_BOOL_FALSE);
+    _check(svgPath, JACIC_BOOL_TRUE, JC_NG_IMAGE, JACIC_BOOL_FALSE);
+    _check(imagePath, JACIC_BOOL_FALSE, JC_NG_IMAGE, JACIC_BOOL_FALSE);
+
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetVerificationCache(NULL));
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
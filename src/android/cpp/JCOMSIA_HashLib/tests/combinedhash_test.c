@@ -0,0 +1,177 @@
+﻿/*!
+@file combinedhash_test.c
+@brief SVG ファイルに埋め込む合成ハッシュ値を、パスワードから計算し直した値と比較するテスト
+@details 合成ハッシュ値は、原本画像と黒板画像の APP5 に埋め込まれた 4 つのハッシュ値（16 進数文字列）と、
+パスワードのハッシュ値（16 進数文字列）を連結した値から計算する。
+ライブラリに埋め込んだ計算済みのパスワードのハッシュ値が正しいことを、高速化前の実装 (referenceHash) で
+パスワードから計算した値を使って確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app5.h"
+#include "common.h"
+#include "exif.h"
+#include "sha256_reference.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define IMAGE_COUNT (3)             /*!< @brief 組み合わせに使う画像の数 */
+#define SCAN_LENGTH (8 * 1024)      /*!< @brief テスト用画像の画像データのバイト数 */
+#define COMBINED_COUNT ((size_t)5)  /*!< @brief 連結するハッシュ値の数（ 4 つのハッシュ値とパスワード） */
+/* @} */
+
+/*! ハッシュ生成に使用するパスワード */
+static const char *PASSWORD = "d598ccd39f78df7d900259e9317662f23d8e9e6d32329a695e6e6f2e8cbed4e5";
+
+/*! PASSWORD の SHA-256 ハッシュ値 */
+static const char *PASSWORD_EXPECTED = "c48076b14af645d273d05690cf218060a20daf3a27f0d5ac0c4aa9ac7e3592ce";
+
+/*!
+@brief 高速化前の実装でハッシュ値を計算する。
+@param [in] data 計算対象のデータ
+@param length data の長さ
+@param [out] hex 結果を受けとる配列（BYTE_SIZE_HASH_LENGTH バイト）
+@retval 0 成功
+@retval -1 失敗
+*/
+static int _referenceHash(const unsigned char *data, size_t length, unsigned char *hex)
+{
+    HashBuffer *input = allocateBinaryData(length);
+    HashBuffer *result = allocateBinaryData(BYTE_SIZE_HASH_LENGTH);
+    int ret = -1;
+
+    if(input != NULL && result != NULL)
+    {
+        memcpy(input->_buff, data, length);
+
+        if(referenceHash(input, result) == FUNCTION_SUCCESS)
+        {
+            memcpy(hex, result->_buff, BYTE_SIZE_HASH_LENGTH);
+            ret = 0;
+        }
+    }
+
+    releaseMemory(input);
+    releaseMemory(result);
+
+    return ret;
+}
+
+/*!
+@brief 画像の APP5 に埋め込まれたハッシュ値（画像、撮影日時）を取り出す。
+@param [in] image 改ざんチェック値を埋め込んだ画像
+@param length image の長さ
+@param [out] hashes 画像、撮影日時の順にハッシュ値を受けとる配列（BYTE_SIZE_HASH_LENGTH * 2 バイト）
+@retval 0 成功
+@retval -1 失敗
+*/
+static int _getEmbeddedHashes(const unsigned char *image, size_t length, unsigned char *hashes)
+{
+    JpegBuffer *buffer = (JpegBuffer *)malloc(sizeof(JpegBuffer) + length);
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    APP5Item imageHash = {JACIC_BOOL_FALSE, {NULL, 0}};
+    APP5Item dateHash = {JACIC_BOOL_FALSE, {NULL, 0}};
+    int ret = -1;
+
+    if(buffer == NULL) return -1;
+
+    buffer->_len = length;
+    memcpy(buffer->_buff, image, length);
+
+    if(buildSegmentIndex(buffer, &index, NULL) == FUNCTION_SUCCESS &&
+            getAPP5HashValue(buffer, &index, &imageHash, &dateHash) == FUNCTION_SUCCESS &&
+            imageHash.value._len == BYTE_SIZE_HASH_LENGTH && dateHash.value._len == BYTE_SIZE_HASH_LENGTH)
+    {
+        memcpy(hashes, imageHash.value._ptr, BYTE_SIZE_HASH_LENGTH);
+        memcpy(hashes + BYTE_SIZE_HASH_LENGTH, dateHash.value._ptr, BYTE_SIZE_HASH_LENGTH);
+        ret = 0;
+    }
+
+    releaseSegmentIndex(&index);
+    free(buffer);
+
+    return ret;
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const char *DATE_TIMES[IMAGE_COUNT] = { TEST_DATE_TIME, "2021:12:31 23:59:59", "1999:01:01 00:00:00" };
+
+    unsigned char *images[IMAGE_COUNT];
+    size_t lengths[IMAGE_COUNT];
+    unsigned char hashes[IMAGE_COUNT][BYTE_SIZE_HASH_LENGTH * 2];
+    unsigned char passwordHash[BYTE_SIZE_HASH_LENGTH];
+    unsigned char combined[BYTE_SIZE_HASH_LENGTH * COMBINED_COUNT];
+    unsigned char expected[BYTE_SIZE_HASH_LENGTH];
+    unsigned char *hashCode = NULL;
+    int i;
+    int j;
+
+    /* パスワードのハッシュ値（既知の値） */
+    TEST_CHECK_EQUAL(0, _referenceHash((const unsigned char *)PASSWORD, strlen(PASSWORD), passwordHash));
+    TEST_CHECK(memcmp(passwordHash, PASSWORD_EXPECTED, BYTE_SIZE_HASH_LENGTH) == 0);
+
+    /* 改ざんチェック値を埋め込んだ画像と、埋め込まれたハッシュ値 */
+    for(i = 0; i < IMAGE_COUNT; ++i)
+    {
+        unsigned char *source;
+        size_t sourceLength = 0;
+
+        images[i] = NULL;
+        lengths[i] = 0;
+
+        source = createTestJpeg(640, 480, DATE_TIMES[i], SCAN_LENGTH, (unsigned int)i + 1U, &sourceLength);
+        TEST_CHECK(source != NULL);
+        if(source == NULL) continue;
+
+        TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_WriteHashValueMem(source, sourceLength, &images[i], &lengths[i]));
+        free(source);
+
+        if(images[i] != NULL)
+        {
+            TEST_CHECK_EQUAL(0, _getEmbeddedHashes(images[i], lengths[i], hashes[i]));
+        }
+    }
+
+    /* 全ての組み合わせ（同じ画像どうし、順序の入れ替えを含む） */
+    for(i = 0; i < IMAGE_COUNT; ++i)
+    {
+        for(j = 0; j < IMAGE_COUNT; ++j)
+        {
+            if(images[i] == NULL || images[j] == NULL) continue;
+
+            memcpy(combined, hashes[i], BYTE_SIZE_HASH_LENGTH * 2);
+            memcpy(combined + BYTE_SIZE_HASH_LENGTH * 2, hashes[j], BYTE_SIZE_HASH_LENGTH * 2);
+            memcpy(combined + BYTE_SIZE_HASH_LENGTH * 4, passwordHash, BYTE_SIZE_HASH_LENGTH);
+            TEST_CHECK_EQUAL(0, _referenceHash(combined, sizeof(combined), expected));
+
+            TEST_CHECK_EQUAL(JW_HASHER_CREATE_SUCCESS,
+                    JCOMSIA_SVG_CalculateHashValueMem(images[i], lengths[i], images[j], lengths[j], &hashCode));
+            TEST_CHECK(hashCode != NULL);
+
+            if(hashCode != NULL && memcmp(hashCode, expected, BYTE_SIZE_HASH_LENGTH) != 0)
+            {
+                fprintf(stderr, "original %d, chalkboard %d: expected %.64s, got %.64s\n", i, j, expected, hashCode);
+                ++testFailures;
+            }
+
+            JCOMSIA_SVG_FreeHashValue(&hashCode);
+        }
+    }
+
+    for(i = 0; i < IMAGE_COUNT; ++i)
+    {
+        JCOMSIA_FreeImageData(&images[i]);
+    }
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+﻿/*!
+@file gather_test.c
+@brief 複数のバイト列をまとめて書き込む処理 (writeFileGather) が、途中までしか書き込まれなかった場合に残りを書き込むことを検査するテスト
+@details テスト側で writev を定義し、ライブラリからの呼び出しを置き換える。
+1 回に書き込むバイト数を制限して要素の途中で書き込みを止めた場合、シグナルによる中断 (EINTR) の場合に、
+書き込まれたファイルの内容が各バイト列を連結したものと一致することを確認する。
+書き込みが進まない場合とエラーの場合は FILE_WRITE_FAILED になることも確認する。
+*/
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define PART_COUNT ((size_t)8)          /*!< @brief 書き込むバイト列の数（ BYTE_VIEW_GATHER_MAX ） */
+#define UNLIMITED ((size_t)-1)          /*!< @brief 1 回に書き込むバイト数を制限しないことを示す値 */
+/* @} */
+
+/*!
+@struct WritevControl
+@brief テスト側の writev の動作
+*/
+typedef struct
+{
+    size_t _limit;          /*!< @brief 1 回に書き込むバイト数の上限 */
+    int _interruptEvery;    /*!< @brief この回数ごとに EINTR で失敗する（ 0 の場合は失敗しない） */
+    int _failAt;            /*!< @brief この回目の呼び出しで _failResult を返す（ 0 の場合は失敗しない） */
+    int _failResult;        /*!< @brief _failAt 回目の呼び出しの戻り値（ -1 の場合は errno に EIO を設定する） */
+    int _calls;             /*!< @brief 呼び出された回数 */
+} WritevControl;
+
+/*! テスト側の writev の動作 */
+static WritevControl control = { UNLIMITED, 0, 0, 0, 0 };
+
+/*!
+@brief ライブラリから呼び出される writev を置き換える。
+@details control に従って、書き込むバイト数を制限し、中断やエラーを発生させる。書き込みは write で行う。
+@param fd 書き込み先
+@param [in] iov 書き込むバイト列の配列
+@param iovcnt iov の要素数
+@return 書き込んだバイト数（失敗した場合は -1 ）
+*/
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    size_t remaining = control._limit;
+    ssize_t total = 0;
+    int i;
+
+    ++control._calls;
+
+    if(control._failAt == control._calls)
+    {
+        if(control._failResult < 0) errno = EIO;
+        return (ssize_t)control._failResult;
+    }
+
+    if(control._interruptEvery != 0 && control._calls % control._interruptEvery == 0)
+    {
+        errno = EINTR;
+        return -1;
+    }
+
+    for(i = 0; i < iovcnt && remaining != 0; ++i)
+    {
+        size_t length = iov[i].iov_len < remaining ? iov[i].iov_len : remaining;
+        ssize_t written;
+
+        if(length == 0) continue;
+
+        written = write(fd, iov[i].iov_base, length);
+        if(written < 0) return total == 0 ? -1 : total;
+
+        total += written;
+        remaining -= (size_t)written;
+        if((size_t)written < length) break;
+    }
+
+    return total;
+}
+
+/*!
+@brief 各バイト列を書き込み、戻り値とファイルの内容を確認する。
+@param [in] path 書き込み先
+@param [in] parts 書き込むバイト列の配列
+@param count parts の要素数
+@param limit 1 回に書き込むバイト数の上限
+@param interruptEvery この回数ごとに EINTR で失敗させる（ 0 の場合は失敗させない）
+*/
+static void _checkWrite(const char *path, const ByteView *parts, size_t count, size_t limit, int interruptEvery)
+{
+    unsigned char expected[8192];
+    unsigned char *written;
+    size_t expectedLength = 0;
+    size_t writtenLength = 0;
+    size_t i;
+    int ret;
+
+    for(i = 0; i < count; ++i)
+    {
+        memcpy(expected + expectedLength, parts[i]._ptr, parts[i]._len);
+        expectedLength += parts[i]._len;
+    }
+
+    control._limit = limit;
+    control._interruptEvery = interruptEvery;
+    control._failAt = 0;
+    control._calls = 0;
+
+    ret = writeFileGather(path, parts, count);
+    written = readTestFile(path, &writtenLength);
+
+    if(ret != FUNCTION_SUCCESS || written == NULL || writtenLength != expectedLength ||
+            memcmp(written, expected, expectedLength) != 0)
+    {
+        fprintf(stderr, "limit %lu, interrupt %d: result %d, wrote %lu of %lu bytes\n", (unsigned long)limit,
+                interruptEvery, ret, (unsigned long)writtenLength, (unsigned long)expectedLength);
+        ++testFailures;
+    }
+
+    free(written);
+}
+
+/*!
+@brief 書き込みを失敗させ、 FILE_WRITE_FAILED になることを確認する。
+@param [in] path 書き込み先
+@param [in] parts 書き込むバイト列の配列
+@param count parts の要素数
+@param failAt 失敗させる呼び出しの回目
+@param failResult 失敗させる呼び出しの戻り値
+*/
+static void _checkFailure(const char *path, const ByteView *parts, size_t count, int failAt, int failResult)
+{
+    int ret;
+
+    control._limit = 7;
+    control._interruptEvery = 0;
+    control._failAt = failAt;
+    control._failResult = failResult;
+    control._calls = 0;
+
+    ret = writeFileGather(path, parts, count);
+
+    if(ret != FILE_WRITE_FAILED || control._calls != failAt)
+    {
+        fprintf(stderr, "fail at %d with %d: result %d after %d calls\n", failAt, failResult, ret, control._calls);
+        ++testFailures;
+    }
+
+    control._failAt = 0;
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const size_t LENGTHS[PART_COUNT] = { 0, 1, 7, 0, 100, 3, 4096, 5 };
+    static const size_t LIMITS[] = { 1, 2, 3, 5, 7, 8, 64, 100, 4095, 4096, UNLIMITED };
+
+    unsigned char data[8192];
+    ByteView parts[PART_COUNT + 1];
+    ByteView empty[2];
+    char path[TEST_PATH_LENGTH];
+    char missingPath[TEST_PATH_LENGTH];
+    unsigned char *written;
+    size_t writtenLength = 0;
+    size_t offset = 0;
+    size_t i;
+
+    if(initTestDirectory("gather") != 0) return 1;
+
+    testPath(path, "gather.bin");
+    testPath(missingPath, "missing/gather.bin");
+
+    for(i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (unsigned char)(i * 31U + (i >> 8));
+    }
+
+    for(i = 0; i < PART_COUNT; ++i)
+    {
+        parts[i]._ptr = data + offset;
+        parts[i]._len = LENGTHS[i];
+        offset += LENGTHS[i];
+    }
+
+    /* 制限なし（ writev の呼び出しは 1 回） */
+    _checkWrite(path, parts, PART_COUNT, UNLIMITED, 0);
+
+    if(control._calls == 0)
+    {
+        /* writev を使用しない構成（ JCOMSIA_DISABLE_GATHER_WRITE ）では途中までの書き込みは発生しない */
+        printf("writeFileGather does not use writev in this build\n");
+    }
+    else
+    {
+        TEST_CHECK_EQUAL(1, control._calls);
+
+        /* 要素の途中で書き込みが止まる場合 */
+        for(i = 0; i < sizeof(LIMITS) / sizeof(LIMITS[0]); ++i)
+        {
+            _checkWrite(path, parts, PART_COUNT, LIMITS[i], 0);
+        }
+
+        /* 1 バイトずつ書き込む場合は、空でない要素の全バイト数だけ呼び出される */
+        _checkWrite(path, parts, PART_COUNT, 1, 0);
+        TEST_CHECK_EQUAL(offset, control._calls);
+
+        /* シグナルによる中断は再試行する */
+        _checkWrite(path, parts, PART_COUNT, 5, 2);
+        _checkWrite(path, parts, PART_COUNT, 64, 3);
+        _checkWrite(path, parts, PART_COUNT, UNLIMITED, 2);
+
+        /* 書き込みが進まない場合、エラーの場合 */
+        _checkFailure(path, parts, PART_COUNT, 1, 0);
+        _checkFailure(path, parts, PART_COUNT, 3, 0);
+        _checkFailure(path, parts, PART_COUNT, 1, -1);
+        _checkFailure(path, parts, PART_COUNT, 4, -1);
+
+        /* 空の要素だけの場合は書き込まない */
+        empty[0]._ptr = data;
+        empty[0]._len = 0;
+        empty[1]._ptr = NULL;
+        empty[1]._len = 0;
+        control._calls = 0;
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, writeFileGather(path, empty, 2));
+        TEST_CHECK_EQUAL(0, control._calls);
+        written = readTestFile(path, &writtenLength);
+        TEST_CHECK(written != NULL);
+        TEST_CHECK_EQUAL(0, writtenLength);
+        free(written);
+    }
+
+    /* 失敗した後も、ファイルは作り直される（以前の内容は残らない） */
+    _checkWrite(path, parts + 1, 2, UNLIMITED, 0);
+
+    /* 不正な引数、開けないファイル */
+    parts[PART_COUNT] = parts[0];
+    TEST_CHECK_EQUAL(INCORRECT_PARAMETER, writeFileGather(path, parts, PART_COUNT + 1));
+    TEST_CHECK_EQUAL(INCORRECT_PARAMETER, writeFileGather(NULL, parts, PART_COUNT));
+    TEST_CHECK_EQUAL(INCORRECT_PARAMETER, writeFileGather(path, NULL, PART_COUNT));
+    TEST_CHECK_EQUAL(FILE_OPEN_FAILED, writeFileGather(missingPath, parts, PART_COUNT));
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
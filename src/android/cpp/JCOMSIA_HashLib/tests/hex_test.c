@@ -0,0 +1,147 @@
+﻿/*!
+@file hex_test.c
+@brief ハッシュ値のバイト配列と 16 進数文字列の変換 (encodeHex / decodeHex) と、一定時間の比較 (compareConstantTime) のテスト
+@details 全てのバイト値について sprintf による変換と一致すること、変換した文字列が元のバイト配列に戻ることを確認する。
+16 進数の小文字以外の文字を含む場合と奇数長の場合は decodeHex が失敗すること、
+compareConstantTime が 1 ビットの違いを全ての位置で検出することも確認する。
+*/
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define GUARD_BYTE (0xA5)   /*!< @brief 変換結果の直後に置き、書き込まれていないことを確認する値 */
+/* @} */
+
+/*! 既知の変換結果を確認するバイト配列 */
+static const unsigned char KNOWN_BYTES[] = { 0x00, 0x01, 0x7F, 0x80, 0xA5, 0xFF, 0x0F, 0xF0, 0x12, 0x9E };
+
+/*! KNOWN_BYTES の 16 進数文字列 */
+static const char *KNOWN_HEX = "00017f80a5ff0ff0129e";
+
+/*!
+@brief 1 文字が decodeHex で受け付けられるべき文字かを調べる。
+@param c 対象の文字
+@retval 1 '0' ～ '9' または 'a' ～ 'f'
+@retval 0 それ以外
+*/
+static int _isLowerHex(unsigned int c)
+{
+    return ('0' <= c && c <= '9') || ('a' <= c && c <= 'f');
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    unsigned char bytes[BYTE_SIZE_HASH_DIGEST + 1];
+    unsigned char decoded[BYTE_SIZE_HASH_DIGEST + 1];
+    unsigned char text[BYTE_SIZE_HASH_LENGTH + 1];
+    unsigned char other[BYTE_SIZE_HASH_DIGEST];
+    char expected[3];
+    unsigned int state = 12345U;
+    unsigned int value;
+    unsigned int c;
+    size_t position;
+    size_t i;
+    int bit;
+
+    /* 既知の変換結果 */
+    memset(text, GUARD_BYTE, sizeof(text));
+    encodeHex(text, KNOWN_BYTES, sizeof(KNOWN_BYTES));
+    TEST_CHECK(memcmp(text, KNOWN_HEX, sizeof(KNOWN_BYTES) * 2) == 0);
+    TEST_CHECK_EQUAL(GUARD_BYTE, text[sizeof(KNOWN_BYTES) * 2]);
+
+    memset(decoded, GUARD_BYTE, sizeof(decoded));
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, decodeHex(decoded, (const unsigned char *)KNOWN_HEX, strlen(KNOWN_HEX)));
+    TEST_CHECK(memcmp(decoded, KNOWN_BYTES, sizeof(KNOWN_BYTES)) == 0);
+    TEST_CHECK_EQUAL(GUARD_BYTE, decoded[sizeof(KNOWN_BYTES)]);
+
+    /* 全てのバイト値（ sprintf の小文字表記と一致し、元の値に戻る） */
+    for(value = 0; value <= 0xFF; ++value)
+    {
+        bytes[0] = (unsigned char)value;
+        encodeHex(text, bytes, 1);
+        sprintf(expected, "%02x", value);
+
+        if(memcmp(text, expected, 2) != 0)
+        {
+            fprintf(stderr, "encode 0x%02X: expected %s, got %c%c\n", value, expected, text[0], text[1]);
+            ++testFailures;
+        }
+
+        decoded[0] = (unsigned char)~value;
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, decodeHex(decoded, text, 2));
+        TEST_CHECK_EQUAL(value, decoded[0]);
+    }
+
+    /* ハッシュ値の長さのバイト配列の往復 */
+    for(i = 0; i < BYTE_SIZE_HASH_DIGEST; ++i)
+    {
+        state = state * 1103515245U + 12345U;
+        bytes[i] = (unsigned char)(state >> 16);
+    }
+
+    encodeHex(text, bytes, BYTE_SIZE_HASH_DIGEST);
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, decodeHex(decoded, text, BYTE_SIZE_HASH_LENGTH));
+    TEST_CHECK(memcmp(decoded, bytes, BYTE_SIZE_HASH_DIGEST) == 0);
+
+    /* 全ての文字を、上位・下位の桁と文字列中の各位置に置く（小文字の 16 進数以外は不正） */
+    for(c = 0; c <= 0xFF; ++c)
+    {
+        for(position = 0; position < BYTE_SIZE_HASH_LENGTH; ++position)
+        {
+            unsigned char saved = text[position];
+            int result;
+
+            text[position] = (unsigned char)c;
+            result = decodeHex(decoded, text, BYTE_SIZE_HASH_LENGTH);
+
+            if(result != (_isLowerHex(c) ? FUNCTION_SUCCESS : INCORRECT_PARAMETER))
+            {
+                fprintf(stderr, "decode: character 0x%02X at %lu: got %d\n", c, (unsigned long)position, result);
+                ++testFailures;
+            }
+
+            text[position] = saved;
+        }
+    }
+
+    /* 奇数長と長さ 0 */
+    TEST_CHECK_EQUAL(INCORRECT_PARAMETER, decodeHex(decoded, text, 1));
+    TEST_CHECK_EQUAL(INCORRECT_PARAMETER, decodeHex(decoded, text, BYTE_SIZE_HASH_LENGTH - 1));
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, decodeHex(decoded, text, 0));
+
+    /* 一定時間の比較（等しい場合、全ての位置の 1 ビットの違い、比較範囲外の違い） */
+    memcpy(other, bytes, BYTE_SIZE_HASH_DIGEST);
+    TEST_CHECK_EQUAL(0, compareConstantTime(bytes, other, BYTE_SIZE_HASH_DIGEST));
+    TEST_CHECK_EQUAL(0, compareConstantTime(bytes, other, 0));
+
+    for(position = 0; position < BYTE_SIZE_HASH_DIGEST; ++position)
+    {
+        for(bit = 0; bit < 8; ++bit)
+        {
+            other[position] = (unsigned char)(bytes[position] ^ (1U << bit));
+
+            if(compareConstantTime(bytes, other, BYTE_SIZE_HASH_DIGEST) == 0 ||
+                    compareConstantTime(other, bytes, BYTE_SIZE_HASH_DIGEST) == 0)
+            {
+                fprintf(stderr, "compare: bit %d at %lu was not detected\n", bit, (unsigned long)position);
+                ++testFailures;
+            }
+
+            /* 違いが比較範囲の外にある場合は等しい */
+            TEST_CHECK_EQUAL(0, compareConstantTime(bytes, other, position));
+
+            other[position] = bytes[position];
+        }
+    }
+
+    return testFailures == 0 ? 0 : 1;
+}
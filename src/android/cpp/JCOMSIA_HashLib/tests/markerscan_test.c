@@ -0,0 +1,138 @@
+﻿/*!
+@file markerscan_test.c
+@brief findMarkerPrefix の SSE2 / NEON による走査を、1 バイトずつ調べる実装と比較するテスト
+@details 64 バイト単位・16 バイト単位・端数の各段階で、0xFF の位置を 0 ～ 63 の全ての位置にずらして比較する。
+マーカーの 2 バイトがベクトルの境界をまたぐ場合、走査範囲の直後にだけ 0xFF がある場合、0xFF が無い場合も確認する。
+先頭位置のずれによる違いも確認するため、走査対象の開始位置を 0 ～ 15 バイトずらす。
+*/
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define MAX_LENGTH (256)        /*!< @brief 走査するバイト数の最大値 */
+#define MATCH_RANGE (64)        /*!< @brief 0xFF を置く位置の範囲（ 64 バイト単位の走査 1 回分） */
+#define ALIGNMENT_RANGE (16)    /*!< @brief 走査対象の開始位置をずらすバイト数の範囲 */
+#define MARKER_PREFIX (0xFF)    /*!< @brief 探すバイト */
+/* @} */
+
+/*!
+@brief 1 バイトずつ調べて、最初の 0xFF の位置を求める。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@return 最初に見つかった 0xFF の位置（見つからなかった場合は length ）
+*/
+static size_t _findMarkerPrefixScalar(const unsigned char *data, size_t length)
+{
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        if(data[i] == MARKER_PREFIX) return i;
+    }
+
+    return length;
+}
+
+/*!
+@brief 0xFF を含まないバイト列で埋める。
+@details 0xFE など、比較で誤って一致しやすい値も含める。
+@param [out] data 埋める領域
+@param length data の長さ
+*/
+static void _fill(unsigned char *data, size_t length)
+{
+    unsigned int state = 12345U;
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        state = state * 1103515245U + 12345U;
+        data[i] = (unsigned char)((state >> 16) % MARKER_PREFIX);
+    }
+}
+
+/*!
+@brief findMarkerPrefix の結果を、1 バイトずつ調べた結果と比較する。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@param [in] label 失敗時に表示する場面の名前
+@param position 0xFF を置いた位置
+*/
+static void _compare(const unsigned char *data, size_t length, const char *label, size_t position)
+{
+    size_t expected = _findMarkerPrefixScalar(data, length);
+    size_t actual = findMarkerPrefix(data, length);
+
+    if(expected != actual)
+    {
+        fprintf(stderr, "%s: length %lu, position %lu: expected %lu, got %lu\n", label,
+                (unsigned long)length, (unsigned long)position, (unsigned long)expected, (unsigned long)actual);
+        ++testFailures;
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    unsigned char buffer[ALIGNMENT_RANGE + MAX_LENGTH + 1];
+    unsigned char *data;
+    size_t alignment;
+    size_t length;
+    size_t position;
+
+    for(alignment = 0; alignment < ALIGNMENT_RANGE; ++alignment)
+    {
+        data = buffer + alignment;
+
+        for(length = 0; length <= MAX_LENGTH; ++length)
+        {
+            /* 0xFF が無い */
+            _fill(buffer, sizeof(buffer));
+            _compare(data, length, "no match", length);
+            TEST_CHECK_EQUAL(length, findMarkerPrefix(data, length));
+
+            /* 走査範囲の直後にだけ 0xFF がある */
+            data[length] = MARKER_PREFIX;
+            _compare(data, length, "after end", length);
+
+            for(position = 0; position < MATCH_RANGE && position < length; ++position)
+            {
+                /* 先頭から 64 バイト以内の全ての位置、および 64 バイトずらした位置 */
+                _fill(buffer, sizeof(buffer));
+                data[position] = MARKER_PREFIX;
+                _compare(data, length, "single", position);
+
+                _fill(buffer, sizeof(buffer));
+                if(position + MATCH_RANGE < length)
+                {
+                    data[position + MATCH_RANGE] = MARKER_PREFIX;
+                    _compare(data, length, "second block", position + MATCH_RANGE);
+                }
+
+                /* 後ろにもう 1 つある場合は、前の位置を返す */
+                data[position] = MARKER_PREFIX;
+                data[length - 1] = MARKER_PREFIX;
+                _compare(data, length, "first of two", position);
+            }
+
+            /* マーカーの 2 バイトが 16 バイトの境界をまたぐ（ 0xFF は境界の直前） */
+            for(position = 15; position + 1 < length; position += 16)
+            {
+                _fill(buffer, sizeof(buffer));
+                data[position] = MARKER_PREFIX;
+                data[position + 1] = 0xD8;
+                _compare(data, length, "straddling", position);
+            }
+        }
+    }
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,251 @@
+﻿/*!
+@file mem_test.c
+@brief メモリ上の画像を扱う API の結果が、ファイルを介する API の結果と一致することを検査するテスト
+@details JCOMSIA_FreeImageData が JCOMSIA_WriteHashValueMem で確保した領域の先頭を正しく求めて解放することも確認する。
+*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define MAX_LIVE_BLOCKS (64)        /*!< @brief 記録する確保済み領域の最大数 */
+#define SCAN_LENGTH (48 * 1024)     /*!< @brief テスト用画像の画像データのバイト数 */
+/* @} */
+
+/*!
+@struct LiveBlocks
+@brief JCOMSIA_SetAllocator に指定した関数で確保され、まだ解放されていない領域
+*/
+typedef struct
+{
+    void *_blocks[MAX_LIVE_BLOCKS]; /*!< @brief 確保済みの領域の先頭 */
+    size_t _count;                  /*!< @brief _blocks の要素数 */
+    size_t _unknownFreeCount;       /*!< @brief 確保していない領域を解放しようとした回数 */
+} LiveBlocks;
+
+/*!
+@brief 確保した領域を記録してメモリを確保する。
+@param size 確保するバイト数
+@param context LiveBlocks
+@return 確保した領域
+*/
+static void *_trackingAlloc(size_t size, void *context)
+{
+    LiveBlocks *live = (LiveBlocks *)context;
+    void *ptr = malloc(size);
+
+    if(ptr != NULL && live->_count < MAX_LIVE_BLOCKS)
+    {
+        live->_blocks[live->_count++] = ptr;
+    }
+
+    return ptr;
+}
+
+/*!
+@brief 確保した領域であることを確認してメモリを解放する。
+@param ptr 解放する領域
+@param context LiveBlocks
+*/
+static void _trackingFree(void *ptr, void *context)
+{
+    LiveBlocks *live = (LiveBlocks *)context;
+    size_t i;
+
+    for(i = 0; i < live->_count; ++i)
+    {
+        if(live->_blocks[i] == ptr)
+        {
+            live->_blocks[i] = live->_blocks[--live->_count];
+            free(ptr);
+            return;
+        }
+    }
+
+    live->_unknownFreeCount++;
+    free(ptr);
+}
+
+/*!
+@brief 領域が確保済みとして記録されているかを返す。
+@param [in] live 確保済みの領域
+@param [in] ptr 調べる領域の先頭
+@retval 1 記録されている
+@retval 0 記録されていない
+*/
+static int _isLive(const LiveBlocks *live, const void *ptr)
+{
+    size_t i;
+
+    for(i = 0; i < live->_count; ++i)
+    {
+        if(live->_blocks[i] == ptr) return 1;
+    }
+
+    return 0;
+}
+
+/*!
+@brief JCOMSIA_WriteHashValue と JCOMSIA_WriteHashValueMem の結果を比較する。
+@param [in] source 埋め込み前の画像
+@param sourceLength source の長さ
+@param [in] sourcePath source を書き込むファイル
+@param [in] destPath JCOMSIA_WriteHashValue の書き込み先
+*/
+static void _compareWrite(const unsigned char *source, size_t sourceLength, const char *sourcePath, const char *destPath)
+{
+    unsigned char *fileResult;
+    unsigned char *memResult = NULL;
+    size_t fileLength = 0;
+    size_t memLength = 0;
+    int fileRet;
+    int memRet;
+
+    TEST_CHECK_EQUAL(0, writeTestFile(sourcePath, source, sourceLength));
+    remove(destPath);
+
+    fileRet = JCOMSIA_WriteHashValue(sourcePath, destPath);
+    memRet = JCOMSIA_WriteHashValueMem(source, sourceLength, &memResult, &memLength);
+    TEST_CHECK_EQUAL(fileRet, memRet);
+
+    if(fileRet != JW_SUCCESS)
+    {
+        TEST_CHECK(memResult == NULL);
+        return;
+    }
+
+    fileResult = readTestFile(destPath, &fileLength);
+    TEST_CHECK(fileResult != NULL && memResult != NULL);
+    TEST_CHECK_EQUAL(fileLength, memLength);
+    if(fileResult != NULL && memResult != NULL && fileLength == memLength)
+    {
+        TEST_CHECK(memcmp(fileResult, memResult, fileLength) == 0);
+    }
+
+    free(fileResult);
+    JCOMSIA_FreeImageData(&memResult);
+}
+
+/*!
+@brief JCOMSIA_CheckHashValue と JCOMSIA_CheckHashValueMem の結果を比較する。
+@param [in] path チェックするファイル
+@param expected 期待する結果
+*/
+static void _compareCheck(const char *path, int expected)
+{
+    unsigned char *image;
+    size_t length = 0;
+
+    image = readTestFile(path, &length);
+    TEST_CHECK(image != NULL);
+    TEST_CHECK_EQUAL(expected, JCOMSIA_CheckHashValue(path));
+    if(image != NULL)
+    {
+        TEST_CHECK_EQUAL(expected, JCOMSIA_CheckHashValueMem(image, length));
+    }
+
+    free(image);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char sourcePath[TEST_PATH_LENGTH];
+    char destPath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    unsigned char *source;
+    unsigned char *chalkboard;
+    unsigned char *hashed = NULL;
+    unsigned char *original = NULL;
+    unsigned char *fileHash = NULL;
+    unsigned char *memHash = NULL;
+    size_t sourceLength = 0;
+    size_t chalkboardLength = 0;
+    size_t hashedLength = 0;
+    size_t originalLength = 0;
+    LiveBlocks live;
+
+    if(initTestDirectory("mem") != 0) return 1;
+
+    testPath(sourcePath, "source.jpg");
+    testPath(destPath, "dest.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+
+    source = createTestJpeg(640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U, &sourceLength);
+    TEST_CHECK(source != NULL);
+    if(source == NULL) return 1;
+
+    /* 埋め込み: 正常な画像、埋め込み済みの画像、JPEG でないデータ */
+    _compareWrite(source, sourceLength, sourcePath, destPath);
+    original = readTestFile(destPath, &originalLength);
+    TEST_CHECK(original != NULL);
+    if(original != NULL)
+    {
+        _compareWrite(original, originalLength, sourcePath, destPath);
+    }
+    _compareWrite((const unsigned char *)"not a jpeg image", 16, sourcePath, destPath);
+    TEST_CHECK_EQUAL(JW_ERROR_READ_FILE_SIZE_ZERO, JCOMSIA_WriteHashValueMem(source, 0, &hashed, &hashedLength));
+    TEST_CHECK(hashed == NULL);
+
+    /* チェック: 埋め込み済みの画像、埋め込み前の画像 */
+    TEST_CHECK_EQUAL(0, writeTestFile(destPath, original, originalLength));
+    _compareCheck(destPath, JC_OK);
+    TEST_CHECK_EQUAL(0, writeTestFile(sourcePath, source, sourceLength));
+    _compareCheck(sourcePath, JC_ERROR_APP5_NOT_EXISTS);
+    TEST_CHECK_EQUAL(JC_ERROR_READ_FILE_SIZE_ZERO, JCOMSIA_CheckHashValueMem(source, 0));
+
+    /* SVG 用のハッシュコード */
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH / 2, 2U));
+    chalkboard = readTestFile(chalkboardPath, &chalkboardLength);
+    TEST_CHECK(chalkboard != NULL);
+    TEST_CHECK_EQUAL(JW_HASHER_CREATE_SUCCESS, JCOMSIA_SVG_CalculateHashValue(destPath, chalkboardPath, &fileHash));
+    TEST_CHECK_EQUAL(JW_HASHER_CREATE_SUCCESS, JCOMSIA_SVG_CalculateHashValueMem(original, originalLength, chalkboard, chalkboardLength, &memHash));
+    TEST_CHECK(fileHash != NULL && memHash != NULL && memcmp(fileHash, memHash, JCOMSIA_HASH_LENGTH) == 0);
+    JCOMSIA_SVG_FreeHashValue(&fileHash);
+    JCOMSIA_SVG_FreeHashValue(&memHash);
+    TEST_CHECK_EQUAL(JCOMSIA_SVG_CalculateHashValue(sourcePath, chalkboardPath, &fileHash),
+                     JCOMSIA_SVG_CalculateHashValueMem(source, sourceLength, chalkboard, chalkboardLength, &memHash));
+    TEST_CHECK(fileHash == NULL && memHash == NULL);
+
+    /* JCOMSIA_FreeImageData は確保した構造体の先頭を解放する */
+    memset(&live, 0, sizeof(live));
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(_trackingAlloc, _trackingFree, &live));
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_WriteHashValueMem(source, sourceLength, &hashed, &hashedLength));
+    TEST_CHECK(hashed != NULL);
+    TEST_CHECK_EQUAL(1, live._count);
+    if(hashed != NULL)
+    {
+        TEST_CHECK(_isLive(&live, hashed - offsetof(JpegBuffer, _buff)));
+        TEST_CHECK_EQUAL(JC_OK, JCOMSIA_CheckHashValueMem(hashed, hashedLength));
+    }
+
+    /* 確保した領域が残っている間は差し替えられない（解放は確保した関数で行われる） */
+    TEST_CHECK_EQUAL(JW_ERROR_ALLOCATOR_IN_USE, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+    JCOMSIA_FreeImageData(&hashed);
+    TEST_CHECK(hashed == NULL);
+    TEST_CHECK_EQUAL(0, live._count);
+    TEST_CHECK_EQUAL(0, live._unknownFreeCount);
+
+    /* NULL は無視される */
+    JCOMSIA_FreeImageData(&hashed);
+    JCOMSIA_FreeImageData(NULL);
+    TEST_CHECK_EQUAL(0, live._unknownFreeCount);
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+
+    free(source);
+    free(original);
+    free(chalkboard);
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
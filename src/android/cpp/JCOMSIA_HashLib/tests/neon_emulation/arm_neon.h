@@ -0,0 +1,187 @@
+﻿/*!
+@file arm_neon.h
+@brief ARMv8 の NEON / SHA2 組み込み関数のうち、sha256.c が使用するものを C で再現したヘッダ
+@details AArch64 のコンパイラを使用できない環境で computationARMv8 の処理内容を検証するためのもの。
+SHA256H / SHA256H2 / SHA256SU0 / SHA256SU1 は Arm Architecture Reference Manual の疑似コードに従う。
+レーンの並びはリトルエンディアンの AArch64 と同じく、メモリ上の先頭をレーン 0 とする。
+*/
+#ifndef JCOMSIA_NEON_EMULATION_ARM_NEON_H_
+#define JCOMSIA_NEON_EMULATION_ARM_NEON_H_
+
+#include <stdint.h>
+
+/*!
+@struct uint8x16_t
+@brief 16 レーンの 8 ビット整数ベクトル
+*/
+typedef struct
+{
+    uint8_t _lane[16];      /*!< @brief 各レーンの値 */
+} uint8x16_t;
+
+/*!
+@struct uint32x4_t
+@brief 4 レーンの 32 ビット整数ベクトル
+*/
+typedef struct
+{
+    uint32_t _lane[4];      /*!< @brief 各レーンの値 */
+} uint32x4_t;
+
+/*! @brief 32 ビット値の右回転 */
+static inline uint32_t _emuRotr(uint32_t value, unsigned int shift)
+{
+    return (value >> shift) | (value << (32 - shift));
+}
+
+/*! @brief LD1 (16 バイト) */
+static inline uint8x16_t vld1q_u8(const uint8_t *src)
+{
+    uint8x16_t result;
+    int i;
+
+    for(i = 0; i < 16; ++i) result._lane[i] = src[i];
+    return result;
+}
+
+/*! @brief LD1 (32 ビット x 4) */
+static inline uint32x4_t vld1q_u32(const uint32_t *src)
+{
+    uint32x4_t result;
+    int i;
+
+    for(i = 0; i < 4; ++i) result._lane[i] = src[i];
+    return result;
+}
+
+/*! @brief ST1 (32 ビット x 4) */
+static inline void vst1q_u32(uint32_t *dst, uint32x4_t value)
+{
+    int i;
+
+    for(i = 0; i < 4; ++i) dst[i] = value._lane[i];
+}
+
+/*! @brief REV32 (32 ビットごとにバイト順を反転) */
+static inline uint8x16_t vrev32q_u8(uint8x16_t value)
+{
+    uint8x16_t result;
+    int i;
+
+    for(i = 0; i < 16; ++i) result._lane[i] = value._lane[(i & ~3) | (3 - (i & 3))];
+    return result;
+}
+
+/*! @brief 8 ビット x 16 を 32 ビット x 4 として解釈する（リトルエンディアン） */
+static inline uint32x4_t vreinterpretq_u32_u8(uint8x16_t value)
+{
+    uint32x4_t result;
+    int i;
+
+    for(i = 0; i < 4; ++i)
+    {
+        result._lane[i] = (uint32_t)value._lane[i * 4] | ((uint32_t)value._lane[i * 4 + 1] << 8) |
+                          ((uint32_t)value._lane[i * 4 + 2] << 16) | ((uint32_t)value._lane[i * 4 + 3] << 24);
+    }
+    return result;
+}
+
+/*! @brief ADD (32 ビット x 4) */
+static inline uint32x4_t vaddq_u32(uint32x4_t a, uint32x4_t b)
+{
+    uint32x4_t result;
+    int i;
+
+    for(i = 0; i < 4; ++i) result._lane[i] = a._lane[i] + b._lane[i];
+    return result;
+}
+
+/*!
+@brief 疑似コードの SHA256hash
+@param x abcd（レーン 0 が a）
+@param y efgh（レーン 0 が e）
+@param w 4 ラウンド分のメッセージと定数の和
+@param part1 真の場合は x を、偽の場合は y を返す
+*/
+static inline uint32x4_t _emuSHA256Hash(uint32x4_t x, uint32x4_t y, uint32x4_t w, int part1)
+{
+    uint32_t chs;
+    uint32_t maj;
+    uint32_t t;
+    uint32_t carry;
+    int e;
+    int i;
+
+    for(e = 0; e < 4; ++e)
+    {
+        chs = (y._lane[0] & y._lane[1]) ^ (~y._lane[0] & y._lane[2]);
+        maj = (x._lane[0] & x._lane[1]) ^ (x._lane[0] & x._lane[2]) ^ (x._lane[1] & x._lane[2]);
+        t = y._lane[3] + (_emuRotr(y._lane[0], 6) ^ _emuRotr(y._lane[0], 11) ^ _emuRotr(y._lane[0], 25)) + chs + w._lane[e];
+        x._lane[3] = t + x._lane[3];
+        y._lane[3] = t + (_emuRotr(x._lane[0], 2) ^ _emuRotr(x._lane[0], 13) ^ _emuRotr(x._lane[0], 22)) + maj;
+
+        /* <Y, X> = ROL(Y : X, 32) */
+        carry = y._lane[3];
+        for(i = 3; 0 < i; --i) y._lane[i] = y._lane[i - 1];
+        y._lane[0] = x._lane[3];
+        for(i = 3; 0 < i; --i) x._lane[i] = x._lane[i - 1];
+        x._lane[0] = carry;
+    }
+
+    return part1 ? x : y;
+}
+
+/*! @brief SHA256H Qd, Qn, Vm.4S */
+static inline uint32x4_t vsha256hq_u32(uint32x4_t hashAbcd, uint32x4_t hashEfgh, uint32x4_t wk)
+{
+    return _emuSHA256Hash(hashAbcd, hashEfgh, wk, 1);
+}
+
+/*! @brief SHA256H2 Qd, Qn, Vm.4S */
+static inline uint32x4_t vsha256h2q_u32(uint32x4_t hashEfgh, uint32x4_t hashAbcd, uint32x4_t wk)
+{
+    return _emuSHA256Hash(hashAbcd, hashEfgh, wk, 0);
+}
+
+/*! @brief SHA256SU0 Vd.4S, Vn.4S */
+static inline uint32x4_t vsha256su0q_u32(uint32x4_t w0To3, uint32x4_t w4To7)
+{
+    uint32x4_t result;
+    uint32_t element;
+    int e;
+
+    for(e = 0; e < 4; ++e)
+    {
+        /* T = operand2<31:0> : operand1<127:32> */
+        element = (e < 3) ? w0To3._lane[e + 1] : w4To7._lane[0];
+        element = _emuRotr(element, 7) ^ _emuRotr(element, 18) ^ (element >> 3);
+        result._lane[e] = element + w0To3._lane[e];
+    }
+    return result;
+}
+
+/*! @brief SHA256SU1 Vd.4S, Vn.4S, Vm.4S */
+static inline uint32x4_t vsha256su1q_u32(uint32x4_t tw0To3, uint32x4_t w8To11, uint32x4_t w12To15)
+{
+    uint32x4_t result;
+    uint32_t t0[4];
+    uint32_t element;
+    int e;
+
+    /* T0 = operand3<31:0> : operand2<127:32> */
+    t0[0] = w8To11._lane[1];
+    t0[1] = w8To11._lane[2];
+    t0[2] = w8To11._lane[3];
+    t0[3] = w12To15._lane[0];
+
+    for(e = 0; e < 4; ++e)
+    {
+        /* 前半は operand3<127:64>、後半は前半の結果を使用する */
+        element = (e < 2) ? w12To15._lane[e + 2] : result._lane[e - 2];
+        element = _emuRotr(element, 17) ^ _emuRotr(element, 19) ^ (element >> 10);
+        result._lane[e] = element + tw0To3._lane[e] + t0[e];
+    }
+    return result;
+}
+
+#endif /* JCOMSIA_NEON_EMULATION_ARM_NEON_H_ */
@@ -0,0 +1,221 @@
+﻿/*!
+@file prehash_test.c
+@brief 読み込みと並行して計算した画像ハッシュ値が、読み込み後に一度に計算した値と一致することを検査するテスト
+@details _readFileWithImageHash は BYTE_SIZE_READ_CHUNK バイトずつ読み込みながら SOS と EOI を探すため、
+SOS ・ EOI ・スタッフィングされた 0xFF の各マーカー、およびファイルの終わりが読み込み単位の境界にちょうど重なる、
+または境界をまたぐ画像を作成し、clipCompressedImage で切り出した範囲の SHA-256 と比較する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "exif.h"
+#include "jpegstream.h"
+#include "sha256.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define READ_CHUNK ((size_t)(1024 * 1024))  /*!< @brief 読み込み単位のバイト数（ writeHashLib.c の BYTE_SIZE_READ_CHUNK と同じ） */
+#define READ_HEAD ((size_t)(64 * 1024))     /*!< @brief SOS を探す前に待つバイト数（ writeHashLib.c の BYTE_SIZE_READ_HEAD と同じ） */
+#define MAX_COMMENT_SIZE ((size_t)65537)    /*!< @brief COM セグメント 1 つの最大バイト数（マーカーを含む） */
+#define NO_STUFFING ((size_t)0)             /*!< @brief スタッフィングされた 0xFF を置かない */
+/* @} */
+
+/*!
+@brief writeHashLib.c の内部関数（ヘッダでは公開していない）
+*/
+int _readFileWithImageHash(const char *filePath, JpegBuffer **buffer, PrehashedImage *prehashed);
+
+/*!
+@brief 各マーカーを指定した位置に置いた JPEG 画像を作成する。
+@details createTestJpeg の先頭部分の SOI の直後に COM セグメントを挿入して SOS の位置を合わせ、
+0xFF を含まない画像データで EOI の位置を合わせる。
+@param sosOffset SOS マーカーの 0xFF の位置
+@param eoiOffset EOI マーカーの 0xFF の位置
+@param stuffedOffset スタッフィングされた 0xFF の位置（ NO_STUFFING の場合は置かない）
+@param trailing EOI の後に続けるバイト数
+@param [out] length 作成した画像のバイト数
+@return 作成した画像（ free で解放する）。位置を合わせられない場合は NULL
+*/
+static unsigned char *_buildImage(size_t sosOffset, size_t eoiOffset, size_t stuffedOffset, size_t trailing, size_t *length)
+{
+    unsigned char *base;
+    unsigned char *image;
+    unsigned char *p;
+    size_t baseLength = 0;
+    size_t headLength;
+    size_t baseSos;
+    size_t padding;
+    size_t segment;
+    unsigned int seed = 1U;
+    size_t i;
+
+    /* 画像データの無い画像から、先頭部分（ SOI ～ SOS セグメント）を取り出す */
+    if((base = createTestJpeg(640, 480, TEST_DATE_TIME, 0, 1U, &baseLength)) == NULL) return NULL;
+    headLength = baseLength - 2;
+    for(baseSos = 0; baseSos + 1 < headLength && !(base[baseSos] == 0xFF && base[baseSos + 1] == 0xDA); ++baseSos);
+
+    padding = sosOffset - baseSos;
+    if(sosOffset < baseSos || (0 < padding && padding < 4) || eoiOffset < headLength + padding)
+    {
+        free(base);
+        return NULL;
+    }
+
+    *length = eoiOffset + 2 + trailing;
+    if((image = (unsigned char *)malloc(*length)) == NULL)
+    {
+        free(base);
+        return NULL;
+    }
+
+    /* SOI */
+    p = image;
+    memcpy(p, base, 2);
+    p += 2;
+
+    /* COM セグメントで SOS の位置を合わせる（ 1 つの大きさは 4 バイト以上） */
+    while(0 < padding)
+    {
+        segment = (MAX_COMMENT_SIZE < padding) ? MAX_COMMENT_SIZE : padding;
+        if(0 < padding - segment && padding - segment < 4) segment -= 4;
+
+        *p++ = 0xFF;
+        *p++ = 0xFE;
+        *p++ = (unsigned char)((segment - 2) >> 8);
+        *p++ = (unsigned char)((segment - 2) & 0xFF);
+        memset(p, 'C', segment - 4);
+        p += segment - 4;
+        padding -= segment;
+    }
+
+    /* APP1 ～ SOS セグメント */
+    memcpy(p, base + 2, headLength - 2);
+    p += headLength - 2;
+    free(base);
+
+    /* 画像データ（ 0xFF を含まない） */
+    while(p < image + eoiOffset)
+    {
+        seed = seed * 1103515245U + 12345U;
+        *p++ = (unsigned char)((seed >> 16) % 0xFF);
+    }
+
+    /* スタッフィングされた 0xFF（直前は 0xFF の後に続いても問題のない 0x00 とする） */
+    if(stuffedOffset != NO_STUFFING)
+    {
+        image[stuffedOffset - 1] = 0x00;
+        image[stuffedOffset] = 0xFF;
+        image[stuffedOffset + 1] = 0x00;
+    }
+
+    /* EOI と、その後の冗長なデータ */
+    *p++ = 0xFF;
+    *p++ = 0xD9;
+    for(i = 0; i < trailing; ++i)
+    {
+        *p++ = (unsigned char)i;
+    }
+
+    return image;
+}
+
+/*!
+@brief 画像をファイルに書き込んで読み込みと並行して画像ハッシュ値を計算し、一度に計算した値と比較する。
+@param [in] path 書き込むファイル
+@param [in] label 失敗時に表示する場面の名前
+@param sosOffset SOS マーカーの 0xFF の位置
+@param eoiOffset EOI マーカーの 0xFF の位置
+@param stuffedOffset スタッフィングされた 0xFF の位置（ NO_STUFFING の場合は置かない）
+@param trailing EOI の後に続けるバイト数
+*/
+static void _check(const char *path, const char *label, size_t sosOffset, size_t eoiOffset, size_t stuffedOffset, size_t trailing)
+{
+    unsigned char *image;
+    unsigned char expected[BYTE_SIZE_HASH_DIGEST];
+    size_t length = 0;
+    JpegBuffer *buffer = NULL;
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    PrehashedImage prehashed;
+    ByteView view = {NULL, 0};
+    SHA256Context context;
+
+    image = _buildImage(sosOffset, eoiOffset, stuffedOffset, trailing, &length);
+    TEST_CHECK(image != NULL);
+    if(image == NULL) return;
+
+    TEST_CHECK_EQUAL(0, writeTestFile(path, image, length));
+    free(image);
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, _readFileWithImageHash(path, &buffer, &prehashed));
+    if(buffer == NULL) return;
+
+    /* 読み込み後に切り出した範囲を一度に計算する */
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(buffer, &index, NULL));
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, clipCompressedImage(buffer, &index, &view, JACIC_BOOL_FALSE));
+    TEST_CHECK_EQUAL(sosOffset, view._ptr - buffer->_buff);
+    TEST_CHECK_EQUAL(eoiOffset + 2 - sosOffset, view._len);
+
+    sha256Init(&context);
+    sha256Update(&context, view._ptr, view._len);
+    sha256FinalDigest(&context, expected);
+
+    if(prehashed._hashed != JACIC_BOOL_TRUE || prehashed._result != FUNCTION_SUCCESS ||
+            memcmp(expected, prehashed._digest, BYTE_SIZE_HASH_DIGEST) != 0)
+    {
+        fprintf(stderr, "%s: SOS %lu, EOI %lu, size %lu: hashed %d, result %d, digest %s\n", label,
+                (unsigned long)sosOffset, (unsigned long)eoiOffset, (unsigned long)length, (int)prehashed._hashed, prehashed._result,
+                memcmp(expected, prehashed._digest, BYTE_SIZE_HASH_DIGEST) == 0 ? "same" : "different");
+        ++testFailures;
+    }
+
+    releaseSegmentIndex(&index);
+    releaseFileBinaryData(&buffer);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char path[TEST_PATH_LENGTH];
+    const size_t sos = 200;
+
+    if(initTestDirectory("prehash") != 0) return 1;
+
+    testPath(path, "image.jpg");
+
+    /* 境界から離れた位置 */
+    _check(path, "reference", sos, READ_CHUNK / 2, NO_STUFFING, 0);
+
+    /* ファイルの終わりが境界に重なる */
+    _check(path, "EOF at boundary", sos, READ_CHUNK - 2, NO_STUFFING, 0);
+    _check(path, "EOF at second boundary", sos, READ_CHUNK * 2 - 2, NO_STUFFING, 0);
+
+    /* EOI が境界をまたぐ、境界から始まる、境界で終わって後にデータが続く */
+    _check(path, "EOI straddling", sos, READ_CHUNK - 1, NO_STUFFING, 0);
+    _check(path, "EOI at boundary", sos, READ_CHUNK, NO_STUFFING, 0);
+    _check(path, "EOI before boundary", sos, READ_CHUNK - 2, NO_STUFFING, 16);
+    _check(path, "EOI straddling with trailing data", sos, READ_CHUNK - 1, NO_STUFFING, 16);
+    _check(path, "EOI straddling second boundary", sos, READ_CHUNK * 2 - 1, NO_STUFFING, 0);
+    _check(path, "EOI at second boundary", sos, READ_CHUNK * 2, NO_STUFFING, 0);
+
+    /* スタッフィングされた 0xFF が境界をまたぐ、境界から始まる */
+    _check(path, "stuffing straddling", sos, READ_CHUNK + 100, READ_CHUNK - 1, 0);
+    _check(path, "stuffing at boundary", sos, READ_CHUNK + 100, READ_CHUNK, 0);
+
+    /* SOS が先頭部分の境界、読み込み単位の境界をまたぐ、境界から始まる */
+    _check(path, "SOS straddling head", READ_HEAD - 1, READ_CHUNK + 100, NO_STUFFING, 0);
+    _check(path, "SOS at head", READ_HEAD, READ_CHUNK + 100, NO_STUFFING, 0);
+    _check(path, "SOS straddling", READ_CHUNK - 1, READ_CHUNK + 100, NO_STUFFING, 0);
+    _check(path, "SOS at boundary", READ_CHUNK, READ_CHUNK + 100, NO_STUFFING, 0);
+    _check(path, "SOS before boundary", READ_CHUNK - 2, READ_CHUNK * 2 - 1, NO_STUFFING, 0);
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+﻿/*!
+@file probe_test.c
+@brief メタデータのみの解析 (probeMetadata) の結果が、SVG ファイル全体の解析 (parse) の結果と一致することを検査するテスト
+@details 正常な SVG ファイルと、メタデータやレイヤの構成を書き換えた SVG ファイルについて、
+戻り値、ハッシュコード、黒板画像の有無を比較する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "svg.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define SCAN_LENGTH (24 * 1024) /*!< @brief テスト用画像の画像データのバイト数 */
+/* @} */
+
+/*!
+@struct SvgVariant
+@brief 正常な SVG ファイルの一部を置き換えて作成する SVG ファイル
+*/
+typedef struct
+{
+    const char *_name;          /*!< @brief ファイル名 */
+    int _pair;                  /*!< @brief 黒板画像を含む SVG ファイルをもとにするか */
+    const char *_find;          /*!< @brief 置き換える文字列（全ての一致を置き換える。 NULL の場合は置き換えない） */
+    const char *_replace;       /*!< @brief 置き換え後の文字列 */
+    SVGResult _expected;        /*!< @brief 期待する解析結果 */
+} SvgVariant;
+
+/*! 比較する SVG ファイル */
+static const SvgVariant VARIANTS[] =
+{
+    { "pair.svg", 1, NULL, NULL, SVG_SUCCESS },
+    { "original.svg", 0, NULL, NULL, SVG_SUCCESS },
+    { "no_vender.svg", 0, "<dcpm:vender>vender</dcpm:vender>", "", SVG_FAILURE_METADATA_BROKEN_STRUCTURE },
+    { "two_softwares.svg", 1, "<dcpm:software>", "<dcpm:software>a</dcpm:software><dcpm:software>", SVG_FAILURE_METADATA_INCORRECT_SOFTWARE },
+    { "meta_version.svg", 0, "<dcpm:metaVersion>3.1<", "<dcpm:metaVersion>9.9<", SVG_FAILURE_METADATA_INCORRECT_META_VERSION },
+    { "std_version.svg", 1, "<dcpm:stdVersion>1.5<", "<dcpm:stdVersion>1.0<", SVG_SUCCESS },
+    { "no_hash.svg", 1, "dcpm:hashCode", "dcpm:unknown", SVG_FAILURE_METADATA_INCORRECT_HASHCODE },
+    { "no_original.svg", 0, "dcp_org_img", "dcp_other_img", SVG_FAILURE_BROKEN_STRUCTURE },
+    { "no_chalkboard.svg", 1, "dcp_chalkboard_img", "dcp_other_img", SVG_FAILURE_BROKEN_STRUCTURE },
+    { "broken.svg", 0, "</rdf:RDF>", "</rdf:rdf>", SVG_FAILURE_PARSE_ERROR },
+};
+
+/*!
+@brief 文字列の一致箇所を全て置き換えてファイルに書き込む。
+@param [in] path 書き込み先
+@param [in] text もとの文字列
+@param [in] find 置き換える文字列。NULL の場合は text をそのまま書き込む
+@param [in] replace 置き換え後の文字列
+@retval 0 成功
+@retval -1 find が見つからない場合、書き込みに失敗した場合
+*/
+static int _writeReplaced(const char *path, const char *text, const char *find, const char *replace)
+{
+    const char *found;
+    FILE *fp;
+    int ret = 0;
+
+    if(find != NULL && strstr(text, find) == NULL) return -1;
+
+    if((fp = fopen(path, "wb")) == NULL) return -1;
+
+    while(find != NULL && (found = strstr(text, find)) != NULL)
+    {
+        fwrite(text, 1, (size_t)(found - text), fp);
+        fputs(replace, fp);
+        text = found + strlen(find);
+    }
+    fputs(text, fp);
+
+    if(ferror(fp)) ret = -1;
+    if(fclose(fp) != 0) ret = -1;
+
+    return ret;
+}
+
+/*!
+@brief 1 つの SVG ファイルについて probeMetadata と parse の結果を比較する。
+@param [in] path SVG ファイル
+@param expected 期待する解析結果
+*/
+static void _compare(const char *path, SVGResult expected)
+{
+    SVGMetadata metadata;
+    JCOMSIA_SVGMeta meta;
+    JpegBuffer *image = NULL;
+    JpegBuffer *chalkboard = NULL;
+    HashBuffer *hashCode = NULL;
+    SVGResult probeResult;
+    SVGResult parseResult;
+    int publicResult;
+
+    memset(&metadata, 0, sizeof(metadata));
+    memset(&meta, 0, sizeof(meta));
+
+    parseResult = parse(path, &image, &chalkboard, &hashCode);
+    probeResult = probeMetadata(path, &metadata);
+    publicResult = JCOMSIA_SVG_ProbeMetadata(path, &meta);
+
+    if(parseResult != expected || probeResult != parseResult)
+    {
+        fprintf(stderr, "%s: expected %d, parse %d, probe %d\n", path, (int)expected, (int)parseResult, (int)probeResult);
+        ++testFailures;
+    }
+
+    if(parseResult == SVG_SUCCESS && probeResult == SVG_SUCCESS)
+    {
+        TEST_CHECK_EQUAL(chalkboard != NULL, metadata._hasChalkboard == JACIC_BOOL_TRUE);
+        TEST_CHECK_EQUAL(hashCode != NULL, metadata._hashCode != NULL);
+        if(hashCode != NULL && metadata._hashCode != NULL)
+        {
+            TEST_CHECK_EQUAL(hashCode->_len, metadata._hashCode->_len);
+            TEST_CHECK(hashCode->_len == metadata._hashCode->_len &&
+                       memcmp(hashCode->_buff, metadata._hashCode->_buff, hashCode->_len) == 0);
+        }
+
+        /* 公開 API も同じ内容を返す */
+        TEST_CHECK_EQUAL(JW_SUCCESS, publicResult);
+        TEST_CHECK_EQUAL(chalkboard != NULL, meta.hasChalkboard);
+        TEST_CHECK(meta.vender != NULL && strcmp(meta.vender, "vender") == 0);
+        TEST_CHECK(meta.software != NULL && strcmp(meta.software, "jcomsia-test") == 0);
+        TEST_CHECK(meta.metaVersion != NULL && strcmp(meta.metaVersion, "3.1") == 0);
+        TEST_CHECK(meta.stdVersion != NULL && metadata._stdVersion != NULL && strcmp(meta.stdVersion, metadata._stdVersion) == 0);
+        TEST_CHECK_EQUAL(hashCode != NULL, meta.hashCode != NULL);
+        if(hashCode != NULL && meta.hashCode != NULL)
+        {
+            TEST_CHECK_EQUAL(hashCode->_len, strlen(meta.hashCode));
+            TEST_CHECK(memcmp(hashCode->_buff, meta.hashCode, hashCode->_len) == 0);
+        }
+    }
+    else
+    {
+        TEST_CHECK(publicResult != JW_SUCCESS);
+        TEST_CHECK(meta.vender == NULL && meta.hashCode == NULL && meta.hasChalkboard == 0);
+    }
+
+    JCOMSIA_SVG_FreeMetadata(&meta);
+    releaseSVGMetadata(&metadata);
+    _SECURE_RELEASE(image);
+    _SECURE_RELEASE(chalkboard);
+    _SECURE_RELEASE(hashCode);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char originalPath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    char pairPath[TEST_PATH_LENGTH];
+    char singlePath[TEST_PATH_LENGTH];
+    char path[TEST_PATH_LENGTH];
+    char *pairText;
+    char *singleText;
+    size_t length = 0;
+    size_t i;
+
+    if(initTestDirectory("probe") != 0) return 1;
+
+    testPath(originalPath, "original.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+    testPath(pairPath, "source_pair.svg");
+    testPath(singlePath, "source_original.svg");
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(originalPath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH, 2U));
+    TEST_CHECK_EQUAL(0, writeTestSvg(pairPath, originalPath, chalkboardPath, "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(singlePath, originalPath, NULL, "vender"));
+
+    pairText = (char *)readTestFile(pairPath, &length);
+    singleText = (char *)readTestFile(singlePath, &length);
+    TEST_CHECK(pairText != NULL && singleText != NULL);
+    if(pairText == NULL || singleText == NULL) return 1;
+
+    for(i = 0; i < sizeof(VARIANTS) / sizeof(VARIANTS[0]); ++i)
+    {
+        testPath(path, VARIANTS[i]._name);
+        TEST_CHECK_EQUAL(0, _writeReplaced(path, VARIANTS[i]._pair ? pairText : singleText, VARIANTS[i]._find, VARIANTS[i]._replace));
+        _compare(path, VARIANTS[i]._expected);
+    }
+
+    testPath(path, "missing.svg");
+    _compare(path, SVG_FAILURE_FILE_CAN_NOT_OPEN);
+
+    free(pairText);
+    free(singleText);
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,378 @@
+﻿/*!
+@file queue_test.c
+@brief 処理キューの完了通知が、完了・取り消し・停止のいずれの場合も 1 回だけ呼び出されることを検査するテスト
+@details 最初の処理の完了通知でワーカーを止めておき、後続の処理が処理待ちにある状態で取り消しと停止を行う。
+同じ状態で fork した子プロセスでは、処理キューを開始し直して登録した処理が完了し、親プロセスの処理待ちを待たないことも確認する。
+*/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define JOB_COUNT (6)               /*!< @brief 1 つの場面で登録する処理の数 */
+#define SCAN_LENGTH (16 * 1024)     /*!< @brief テスト用画像の画像データのバイト数 */
+#define NOT_CALLED (0x7FFF)         /*!< @brief 完了通知が呼び出されていない処理の結果 */
+#define CHILD_TIMEOUT (30)          /*!< @brief 子プロセスの処理を待つ時間（秒） */
+/* @} */
+
+/*!
+@struct JobRecord
+@brief 1 つの処理の完了通知の記録
+*/
+typedef struct
+{
+    int _callCount;                             /*!< @brief 完了通知が呼び出された回数 */
+    int _result;                                /*!< @brief 完了通知に渡された結果 */
+    unsigned char _hashCode[BYTE_SIZE_HASH_LENGTH]; /*!< @brief 完了通知に渡されたハッシュコード */
+    int _hasHashCode;                           /*!< @brief _hashCode を受けとったか */
+} JobRecord;
+
+/*!
+@struct Gate
+@brief 完了通知の中でワーカーを止めておくための状態
+*/
+typedef struct
+{
+    pthread_mutex_t _mutex;     /*!< @brief 状態を保護するミューテックス */
+    pthread_cond_t _changed;    /*!< @brief 状態が変わったことを通知する */
+    int _entered;               /*!< @brief ワーカーが止まったか */
+    int _released;              /*!< @brief ワーカーを再開させたか */
+    JobRecord _record;          /*!< @brief ワーカーを止める処理の記録 */
+} Gate;
+
+static Gate gate = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, { 0, 0, {0}, 0 } };
+
+/*! 完了通知の記録を保護するミューテックス */
+static pthread_mutex_t recordMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*!
+@brief 結果を記録する完了通知。
+@param result 結果
+@param userdata JobRecord
+*/
+static void _recordResult(int result, void *userdata)
+{
+    JobRecord *record = (JobRecord *)userdata;
+
+    pthread_mutex_lock(&recordMutex);
+    record->_callCount++;
+    record->_result = result;
+    pthread_mutex_unlock(&recordMutex);
+}
+
+/*!
+@brief 結果とハッシュコードを記録する完了通知。
+@param result 結果
+@param hashCode ハッシュコード
+@param userdata JobRecord
+*/
+static void _recordHash(int result, const unsigned char *hashCode, void *userdata)
+{
+    JobRecord *record = (JobRecord *)userdata;
+
+    pthread_mutex_lock(&recordMutex);
+    record->_callCount++;
+    record->_result = result;
+    record->_hasHashCode = hashCode != NULL;
+    if(hashCode != NULL)
+    {
+        memcpy(record->_hashCode, hashCode, BYTE_SIZE_HASH_LENGTH);
+    }
+    pthread_mutex_unlock(&recordMutex);
+}
+
+/*!
+@brief 結果を記録し、_releaseGate が呼び出されるまでワーカーを止める完了通知。
+@param result 結果
+@param userdata 未使用
+*/
+static void _waitAtGate(int result, void *userdata)
+{
+    (void) userdata;
+
+    _recordResult(result, &gate._record);
+
+    pthread_mutex_lock(&gate._mutex);
+    gate._entered = 1;
+    pthread_cond_broadcast(&gate._changed);
+    while(!gate._released)
+    {
+        pthread_cond_wait(&gate._changed, &gate._mutex);
+    }
+    pthread_mutex_unlock(&gate._mutex);
+}
+
+/*!
+@brief ワーカーを止める処理を登録し、ワーカーが止まるまで待つ。
+@param [in] path チェックするファイル
+*/
+static void _closeGate(const char *path)
+{
+    pthread_mutex_lock(&gate._mutex);
+    gate._entered = 0;
+    gate._released = 0;
+    memset(&gate._record, 0, sizeof(gate._record));
+    pthread_mutex_unlock(&gate._mutex);
+
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitCheckHash(path, _waitAtGate, NULL, NULL));
+
+    pthread_mutex_lock(&gate._mutex);
+    while(!gate._entered)
+    {
+        pthread_cond_wait(&gate._changed, &gate._mutex);
+    }
+    pthread_mutex_unlock(&gate._mutex);
+}
+
+/*!
+@brief 止めたワーカーを再開させる。
+*/
+static void _releaseGate(void)
+{
+    pthread_mutex_lock(&gate._mutex);
+    gate._released = 1;
+    pthread_cond_broadcast(&gate._changed);
+    pthread_mutex_unlock(&gate._mutex);
+}
+
+/*! 停止処理中に登録を試みた結果 */
+static int submitWhileStopping = NOT_CALLED;
+/*! 停止処理中に登録を試みた処理の記録（呼び出されてはならない） */
+static JobRecord lateRecord;
+/*! 停止処理中の登録に使用するファイル */
+static const char *latePath;
+
+/*!
+@brief 取り消しを記録し、停止処理中の登録が失敗することを確かめてからワーカーを再開させる完了通知。
+@param result 結果
+@param userdata JobRecord
+*/
+static void _recordCancelAndRelease(int result, void *userdata)
+{
+    _recordResult(result, userdata);
+
+    submitWhileStopping = JCOMSIA_SubmitCheckHash(latePath, _recordResult, &lateRecord, NULL);
+    _releaseGate();
+}
+
+/*!
+@brief 記録を初期化する。
+@param [out] records 初期化する記録
+@param count records の要素数
+*/
+static void _resetRecords(JobRecord *records, size_t count)
+{
+    size_t i;
+
+    memset(records, 0, sizeof(JobRecord) * count);
+    for(i = 0; i < count; ++i)
+    {
+        records[i]._result = NOT_CALLED;
+    }
+}
+
+/*!
+@brief fork した子プロセスで処理を登録し、完了が通知されることを確認する。
+@details 子プロセスでは、親プロセスの処理待ちを待たずに完了待ちが終わること、登録した処理が 1 回だけ通知されること、
+停止できることを確認する。子プロセスが CHILD_TIMEOUT 秒以内に終了しない場合は SIGALRM で終了させ、失敗とする。
+@param [in] path チェックするファイル
+*/
+static void _checkInChild(const char *path)
+{
+    JobRecord record;
+    pid_t pid;
+    int status = 0;
+
+    fflush(NULL);
+
+    pid = fork();
+    TEST_CHECK(0 <= pid);
+    if(pid < 0) return;
+
+    if(pid == 0)
+    {
+        alarm(CHILD_TIMEOUT);
+
+        /* 親プロセスの処理待ち・実行中の処理は子プロセスには無い */
+        JCOMSIA_DrainQueue();
+
+        _resetRecords(&record, 1);
+        if(JCOMSIA_SubmitCheckHash(path, _recordResult, &record, NULL) != JQ_SUCCESS) _exit(1);
+        JCOMSIA_DrainQueue();
+        JCOMSIA_ShutdownQueue(0);
+
+        _exit(record._callCount == 1 && record._result == JC_OK ? 0 : 1);
+    }
+
+    TEST_CHECK_EQUAL(pid, waitpid(pid, &status, 0));
+    TEST_CHECK(WIFEXITED(status));
+    if(WIFSIGNALED(status))
+    {
+        fprintf(stderr, "child terminated by signal %d\n", WTERMSIG(status));
+    }
+    TEST_CHECK_EQUAL(0, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char imagePath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    char sourcePath[TEST_PATH_LENGTH];
+    char destPath[TEST_PATH_LENGTH];
+    char hashedPath[TEST_PATH_LENGTH];
+    char svgPath[TEST_PATH_LENGTH];
+    JCOMSIA_QueueOptions options;
+    JCOMSIA_JobId jobIds[JOB_COUNT];
+    JobRecord records[JOB_COUNT];
+    unsigned char *source;
+    unsigned char *hashCode = NULL;
+    size_t length = 0;
+    int i;
+
+    if(initTestDirectory("queue") != 0) return 1;
+
+    testPath(imagePath, "image.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+    testPath(sourcePath, "source.jpg");
+    testPath(destPath, "dest.jpg");
+    testPath(hashedPath, "hashed.jpg");
+    testPath(svgPath, "image.svg");
+    latePath = imagePath;
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(imagePath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH, 2U));
+    source = createTestJpeg(640, 480, TEST_DATE_TIME, SCAN_LENGTH, 3U, &length);
+    TEST_CHECK(source != NULL && writeTestFile(sourcePath, source, length) == 0);
+    free(source);
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPath, imagePath, chalkboardPath, "vender"));
+
+    /* ワーカー 1 つで、処理待ちに後続の処理が残るようにする */
+    options.threadCount = 1;
+    options.capacity = JOB_COUNT;
+    options.failWhenFull = 1;
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_StartQueue(&options));
+
+    /* 取り消し: 取り消した処理は呼び出したスレッドで 1 回だけ通知され、残りは実行される */
+    _resetRecords(records, JOB_COUNT);
+    _closeGate(imagePath);
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitCheckHash(imagePath, _recordResult, &records[i], &jobIds[i]));
+        TEST_CHECK(jobIds[i] != 0);
+    }
+    TEST_CHECK_EQUAL(JQ_ERROR_QUEUE_FULL, JCOMSIA_SubmitCheckHash(imagePath, _recordResult, &lateRecord, NULL));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_CancelJob(jobIds[1]));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_CancelJob(jobIds[4]));
+    TEST_CHECK_EQUAL(1, records[1]._callCount);
+    TEST_CHECK_EQUAL(JQ_ERROR_CANCELLED, records[1]._result);
+    TEST_CHECK_EQUAL(JQ_ERROR_JOB_NOT_FOUND, JCOMSIA_CancelJob(jobIds[1]));
+    TEST_CHECK_EQUAL(JQ_ERROR_JOB_NOT_FOUND, JCOMSIA_CancelJob(0));
+    _releaseGate();
+    JCOMSIA_DrainQueue();
+    TEST_CHECK_EQUAL(JQ_ERROR_JOB_NOT_FOUND, JCOMSIA_CancelJob(jobIds[0]));
+    TEST_CHECK_EQUAL(1, gate._record._callCount);
+    TEST_CHECK_EQUAL(JC_OK, gate._record._result);
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(1, records[i]._callCount);
+        TEST_CHECK_EQUAL(i == 1 || i == 4 ? JQ_ERROR_CANCELLED : JC_OK, records[i]._result);
+    }
+
+    /* 完了待ち: 種類の異なる処理がそれぞれ 1 回だけ、同期版と同じ結果で通知される */
+    _resetRecords(records, JOB_COUNT);
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitWriteHash(sourcePath, destPath, _recordResult, &records[0], NULL));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitWriteHash(imagePath, hashedPath, _recordResult, &records[1], NULL));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitCheckHash(sourcePath, _recordResult, &records[2], NULL));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SVG_SubmitCalculateHash(imagePath, chalkboardPath, _recordHash, &records[3], NULL));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SVG_SubmitCalculateHash(sourcePath, chalkboardPath, _recordHash, &records[4], NULL));
+    TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SVG_SubmitCheckHash(svgPath, _recordResult, &records[5], NULL));
+    JCOMSIA_DrainQueue();
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(1, records[i]._callCount);
+    }
+    TEST_CHECK_EQUAL(JW_SUCCESS, records[0]._result);
+    TEST_CHECK_EQUAL(JC_OK, JCOMSIA_CheckHashValue(destPath));
+    TEST_CHECK_EQUAL(JCOMSIA_WriteHashValue(imagePath, hashedPath), records[1]._result);
+    TEST_CHECK(records[1]._result != JW_SUCCESS);
+    TEST_CHECK_EQUAL(JCOMSIA_CheckHashValue(sourcePath), records[2]._result);
+    TEST_CHECK_EQUAL(JW_HASHER_CREATE_SUCCESS, records[3]._result);
+    TEST_CHECK_EQUAL(JW_HASHER_CREATE_SUCCESS, JCOMSIA_SVG_CalculateHashValue(imagePath, chalkboardPath, &hashCode));
+    TEST_CHECK(records[3]._hasHashCode && hashCode != NULL && memcmp(records[3]._hashCode, hashCode, BYTE_SIZE_HASH_LENGTH) == 0);
+    JCOMSIA_SVG_FreeHashValue(&hashCode);
+    TEST_CHECK_EQUAL(JCOMSIA_SVG_CalculateHashValue(sourcePath, chalkboardPath, &hashCode), records[4]._result);
+    TEST_CHECK(!records[4]._hasHashCode);
+    TEST_CHECK_EQUAL(JC_SVG_RESULT_OK, records[5]._result);
+
+    /* 処理が全て終われば、処理キューを開始したままでもメモリ確保関数を差し替えられる */
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+
+    /* fork: ワーカーが止まり処理待ちが残っている状態で fork しても、子プロセスでは開始し直して処理できる */
+    _resetRecords(records, JOB_COUNT);
+    _closeGate(imagePath);
+    for(i = 0; i < 2; ++i)
+    {
+        TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitCheckHash(imagePath, _recordResult, &records[i], NULL));
+    }
+    _checkInChild(imagePath);
+    _releaseGate();
+    JCOMSIA_DrainQueue();
+    for(i = 0; i < 2; ++i)
+    {
+        TEST_CHECK_EQUAL(1, records[i]._callCount);
+        TEST_CHECK_EQUAL(JC_OK, records[i]._result);
+    }
+
+    /* 処理待ちを取り消して停止: 取り消しの通知は 1 回だけで、停止処理中の登録は失敗する */
+    _resetRecords(records, JOB_COUNT);
+    _resetRecords(&lateRecord, 1);
+    _closeGate(imagePath);
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitCheckHash(imagePath,
+                                                            i == JOB_COUNT - 1 ? _recordCancelAndRelease : _recordResult,
+                                                            &records[i], NULL));
+    }
+    JCOMSIA_ShutdownQueue(1);
+    TEST_CHECK_EQUAL(1, gate._record._callCount);
+    TEST_CHECK_EQUAL(JC_OK, gate._record._result);
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(1, records[i]._callCount);
+        TEST_CHECK_EQUAL(JQ_ERROR_CANCELLED, records[i]._result);
+    }
+    TEST_CHECK_EQUAL(JQ_ERROR_QUEUE_STOPPED, submitWhileStopping);
+    TEST_CHECK_EQUAL(0, lateRecord._callCount);
+
+    /* 停止後の登録で再び開始し、処理待ちを全て実行してから停止する */
+    _resetRecords(records, JOB_COUNT);
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(JQ_SUCCESS, JCOMSIA_SubmitCheckHash(imagePath, _recordResult, &records[i], NULL));
+    }
+    JCOMSIA_ShutdownQueue(0);
+    for(i = 0; i < JOB_COUNT; ++i)
+    {
+        TEST_CHECK_EQUAL(1, records[i]._callCount);
+        TEST_CHECK_EQUAL(JC_OK, records[i]._result);
+    }
+    TEST_CHECK_EQUAL(0, lateRecord._callCount);
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+﻿/*!
+@file readfile_test.c
+@brief ファイルの読み込み結果が、 mmap で参照する場合と fread で読み込む場合とで一致することを検査するテスト
+@details JCOMSIA_ENABLE_MAPPED_READ を定義したライブラリと定義しないライブラリの両方にリンクして、同じ期待値で実行する。
+ページの境界をまたぐ大きさのファイル、サイズが 0 のファイル、マップできないファイル（通常のファイルではないもの）、
+存在しないファイルについて、読み込んだバイト列と戻り値を確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "jpegstream.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define PAGE_SIZE_MAX ((size_t)(64 * 1024))  /*!< @brief 境界をまたぐ大きさを試すページサイズの最大値 */
+#define UNMAPPABLE_FILE "/dev/null"         /*!< @brief マップできない（通常のファイルではない）ファイル */
+/* @} */
+
+/*!
+@brief writeHashLib.c の内部関数（ヘッダでは公開していない）
+*/
+int _readFile(const char *filePath, FileDataCache *cache, JpegBuffer **buffer);
+
+/*!
+@brief writeHashLib.c の内部関数（ヘッダでは公開していない）
+*/
+int _readFileWithImageHash(const char *filePath, JpegBuffer **buffer, PrehashedImage *prehashed);
+
+/*!
+@brief マップできるかを確認する。
+@details JCOMSIA_ENABLE_MAPPED_READ を定義した場合は通常のファイルをマップでき、定義しない場合は常に失敗する。
+@param [in] path 対象のファイル
+@param expected JCOMSIA_ENABLE_MAPPED_READ を定義した場合の期待値
+*/
+static void _checkMap(const char *path, int expected)
+{
+    JpegBuffer *buffer = NULL;
+    int actual = mapFileBinaryData(path, &buffer);
+
+#if defined(JCOMSIA_ENABLE_MAPPED_READ)
+    TEST_CHECK_EQUAL(expected, actual);
+#else
+    (void) expected;
+    TEST_CHECK_EQUAL(OTHER_ERROR, actual);
+#endif
+
+    TEST_CHECK((actual == FUNCTION_SUCCESS) == (buffer != NULL));
+    releaseFileBinaryData(&buffer);
+}
+
+/*!
+@brief ファイルを読み込み、戻り値とバイト列を確認する。
+@details _readFile （キャッシュを使う場合と使わない場合）と _readFileWithImageHash の両方で読み込む。
+@param [in] path 対象のファイル
+@param expectedResult 期待する戻り値
+@param [in] expected 期待するバイト列（ expectedResult が FUNCTION_SUCCESS の場合のみ使用する）
+@param expectedLength expected の長さ
+*/
+static void _checkRead(const char *path, int expectedResult, const unsigned char *expected, size_t expectedLength)
+{
+    JpegBuffer *buffer = NULL;
+    FileDataCache cache = {NULL, 0, JACIC_BOOL_FALSE};
+    PrehashedImage prehashed;
+    int pass;
+
+    for(pass = 0; pass < 3; ++pass)
+    {
+        int actual;
+
+        if(pass == 0)
+        {
+            actual = _readFile(path, NULL, &buffer);
+        }
+        else if(pass == 1)
+        {
+            actual = _readFile(path, &cache, &buffer);
+        }
+        else
+        {
+            actual = _readFileWithImageHash(path, &buffer, &prehashed);
+        }
+
+        if(actual != expectedResult)
+        {
+            fprintf(stderr, "%s (pass %d): expected %d, got %d\n", path, pass, expectedResult, actual);
+            ++testFailures;
+        }
+        else if(actual == FUNCTION_SUCCESS)
+        {
+            TEST_CHECK(buffer != NULL);
+            if(buffer != NULL)
+            {
+                TEST_CHECK_EQUAL(expectedLength, buffer->_len);
+                TEST_CHECK(buffer->_len == expectedLength && memcmp(buffer->_buff, expected, expectedLength) == 0);
+            }
+        }
+
+        releaseFileBinaryData(&buffer);
+    }
+
+    releaseFileDataCache(&cache);
+}
+
+/*!
+@brief 指定した大きさのファイルを書き込んで読み込み、書き込んだバイト列と比較する。
+@param [in] path 書き込むファイル
+@param length ファイルのバイト数
+*/
+static void _checkSize(const char *path, size_t length)
+{
+    unsigned char *data = (unsigned char *)malloc(length);
+    size_t i;
+
+    TEST_CHECK(data != NULL);
+    if(data == NULL) return;
+
+    for(i = 0; i < length; ++i)
+    {
+        data[i] = (unsigned char)(i * 131U + (i >> 8));
+    }
+
+    TEST_CHECK_EQUAL(0, writeTestFile(path, data, length));
+    _checkMap(path, FUNCTION_SUCCESS);
+    _checkRead(path, FUNCTION_SUCCESS, data, length);
+    free(data);
+    remove(path);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char path[TEST_PATH_LENGTH];
+    char hashedPath[TEST_PATH_LENGTH];
+    char destPath[TEST_PATH_LENGTH];
+    char missingPath[TEST_PATH_LENGTH];
+    unsigned char *source;
+    unsigned char *expected = NULL;
+    unsigned char *written;
+    size_t sourceLength = 0;
+    size_t expectedLength = 0;
+    size_t writtenLength = 0;
+    size_t pageSize;
+
+    if(initTestDirectory("readfile") != 0) return 1;
+
+    testPath(path, "data.bin");
+    testPath(hashedPath, "hashed.jpg");
+    testPath(destPath, "dest.jpg");
+    testPath(missingPath, "missing.jpg");
+
+    /* ページの境界の前後の大きさ（ 1 ページ分の管理情報の直後にマップするため、境界をまたぐ場合を含む） */
+    _checkSize(path, 1);
+    for(pageSize = 4096; pageSize <= PAGE_SIZE_MAX; pageSize *= 2)
+    {
+        _checkSize(path, pageSize - 1);
+        _checkSize(path, pageSize);
+        _checkSize(path, pageSize + 1);
+    }
+    _checkSize(path, 1024 * 1024 + 1);
+
+    /* サイズが 0 のファイル（マップせずに通常の読み込みで失敗する） */
+    TEST_CHECK_EQUAL(0, writeTestFile(path, (const unsigned char *)"", 0));
+    _checkMap(path, OTHER_ERROR);
+    _checkRead(path, FILE_SIZE_ZERO, NULL, 0);
+    TEST_CHECK_EQUAL(JC_ERROR_READ_FILE_SIZE_ZERO, JCOMSIA_CheckHashValue(path));
+    remove(path);
+
+    /* マップできないファイル（通常の読み込みで代替する） */
+    _checkMap(UNMAPPABLE_FILE, OTHER_ERROR);
+    _checkRead(UNMAPPABLE_FILE, FILE_SIZE_ZERO, NULL, 0);
+    TEST_CHECK_EQUAL(JC_ERROR_READ_FILE_SIZE_ZERO, JCOMSIA_CheckHashValue(UNMAPPABLE_FILE));
+
+    /* 存在しないファイル */
+    _checkMap(missingPath, OTHER_ERROR);
+    _checkRead(missingPath, FILE_OPEN_FAILED, NULL, 0);
+    TEST_CHECK_EQUAL(JC_ERROR_READ_FILE_NOT_EXISTS, JCOMSIA_CheckHashValue(missingPath));
+
+    /* ハッシュ値の埋め込みと検証（メモリ上の画像を扱う API の結果と比較する） */
+    source = createTestJpeg(640, 480, TEST_DATE_TIME, 64 * 1024, 7U, &sourceLength);
+    TEST_CHECK(source != NULL);
+    if(source != NULL)
+    {
+        TEST_CHECK_EQUAL(0, writeTestFile(path, source, sourceLength));
+        _checkMap(path, FUNCTION_SUCCESS);
+        _checkRead(path, FUNCTION_SUCCESS, source, sourceLength);
+
+        TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_WriteHashValueMem(source, sourceLength, &expected, &expectedLength));
+        TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_WriteHashValue(path, destPath));
+
+        written = readTestFile(destPath, &writtenLength);
+        TEST_CHECK(written != NULL);
+        TEST_CHECK_EQUAL(expectedLength, writtenLength);
+        TEST_CHECK(written != NULL && expected != NULL && writtenLength == expectedLength &&
+                memcmp(written, expected, expectedLength) == 0);
+
+        TEST_CHECK_EQUAL(JC_OK, JCOMSIA_CheckHashValue(destPath));
+        TEST_CHECK_EQUAL(JCOMSIA_CheckHashValueMem(written, writtenLength), JCOMSIA_CheckHashValue(destPath));
+
+        free(written);
+        JCOMSIA_FreeImageData(&expected);
+        free(source);
+    }
+
+    /* 改ざんした画像 */
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(hashedPath, 640, 480, TEST_DATE_TIME, 4096, 3U));
+    remove(destPath);
+    TEST_CHECK_EQUAL(0, writeTamperedTestJpeg(hashedPath, destPath));
+    written = readTestFile(destPath, &writtenLength);
+    TEST_CHECK(written != NULL);
+    if(written != NULL)
+    {
+        TEST_CHECK_EQUAL(JCOMSIA_CheckHashValueMem(written, writtenLength), JCOMSIA_CheckHashValue(destPath));
+        TEST_CHECK(JCOMSIA_CheckHashValue(destPath) != JC_OK);
+        free(written);
+    }
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+﻿/*!
+@file segindex_test.c
+@brief JPEG 画像のセグメント索引 (buildSegmentIndex) を、手で組み立てた画像の既知の値と比較するテスト
+@details 各セグメントのマーカー・サイズ定義・位置・次の走査開始位置・識別子を確認する。
+連続する 0xFF 、 SOS 、 EOI 、判別不可能なマーカー、データ終端を超えるセグメント、データ終端で終わるセグメントで
+走査が終わることと、索引の領域をアリーナから割り当てた場合も同じ索引になることを確認する。
+*/
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "exif.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define IMAGE_CAPACITY ((size_t)2048)   /*!< @brief 組み立てる画像の最大長 */
+#define COM_COUNT ((size_t)200)         /*!< @brief 索引の拡張を確認するために並べる COM セグメントの数 */
+#define ARENA_CAPACITY ((size_t)256)    /*!< @brief アリーナの初期領域のバイト数（索引が収まらない大きさ） */
+/* @} */
+
+/*!
+@struct ExpectedSegment
+@brief 索引に登録されるべきセグメント
+*/
+typedef struct
+{
+    unsigned short _marker;         /*!< @brief マーカーセグメント */
+    unsigned short _size;           /*!< @brief サイズ定義の値 */
+    unsigned long _offset;          /*!< @brief マーカーの位置 */
+    unsigned long _nextOffset;      /*!< @brief 次のセグメントの走査開始位置 */
+    const char *_identifier;        /*!< @brief 識別子（ BYTE_SIZE_SEGMENT_IDENTIFIER バイト、識別子を持たない場合は NULL ） */
+} ExpectedSegment;
+
+/*!
+@brief 基本となる画像
+@details SOI 、 APP1 (Exif) 、連続する 0xFF の後の APP0 、 APP5 (DCPMI) 、 COM 、 DQT 、 SOS 、画像データ、 EOI の順に並べる。
+*/
+static const unsigned char BASIC_IMAGE[] =
+{
+    0xFF, 0xD8,                                                             /*  0: SOI */
+    0xFF, 0xE1, 0x00, 0x10, 'E', 'x', 'i', 'f', 0x00, 0x00,                 /*  2: APP1 */
+    0x4D, 0x4D, 0x00, 0x2A, 0x00, 0x00, 0x00, 0x08,
+    0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x04, 0x4A, 0x46,                         /* 20: 0xFF の連続と APP0 (22) */
+    0xFF, 0xE5, 0x00, 0x0A, 'D', 'C', 'P', 'M', 'I', 0x00, 0x01, 0x02,      /* 28: APP5 */
+    0xFF, 0xFE, 0x00, 0x05, 'a', 'b', 'c',                                  /* 40: COM */
+    0xFF, 0xDB, 0x00, 0x04, 0x00, 0x01,                                     /* 47: DQT */
+    0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00,             /* 53: SOS */
+    0x12, 0x34, 0xFF, 0x00, 0x56,                                           /* 63: 画像データ */
+    0xFF, 0xD9                                                              /* 68: EOI */
+};
+
+/*! BASIC_IMAGE の索引 */
+static const ExpectedSegment BASIC_SEGMENTS[] =
+{
+    { 0xFFE1, 0x0010,  2, 20, "Exif\0\0" },
+    { 0xFFE0, 0x0004, 22, 28, NULL },
+    { 0xFFE5, 0x000A, 28, 40, "DCPMI\0" },
+    { 0xFFFE, 0x0005, 40, 47, NULL },
+    { 0xFFDB, 0x0004, 47, 53, NULL },
+    { 0xFFDA, 0x0000, 53, 53, NULL }
+};
+
+/*!
+@brief 索引を作成し、期待する索引と比較する。
+@details ヒープから確保する場合と、アリーナから割り当てる場合の両方で作成する。
+@param [in] label 失敗時に表示する場面の名前
+@param [in] data 対象となる画像
+@param length data の長さ
+@param [in] expected 期待する索引
+@param count expected の要素数
+*/
+static void _check(const char *label, const unsigned char *data, size_t length, const ExpectedSegment *expected, size_t count)
+{
+    unsigned char storage[sizeof(JpegBuffer) + IMAGE_CAPACITY];
+    unsigned char arenaBuff[ARENA_CAPACITY];
+    JpegBuffer *buffer = (JpegBuffer *)storage;
+    JpegSegmentIndex index;
+    Arena arena;
+    int pass;
+    size_t i;
+
+    buffer->_len = length;
+    memcpy(buffer->_buff, data, length);
+
+    for(pass = 0; pass < 2; ++pass)
+    {
+        int ret;
+
+        arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+        ret = buildSegmentIndex(buffer, &index, pass == 0 ? NULL : &arena);
+
+        if(ret != FUNCTION_SUCCESS || index._count != count || index._startOffset != 2UL)
+        {
+            fprintf(stderr, "%s (pass %d): result %d, count %lu (expected %lu), start %lu\n", label, pass, ret,
+                    (unsigned long)index._count, (unsigned long)count, index._startOffset);
+            ++testFailures;
+        }
+        else
+        {
+            for(i = 0; i < count; ++i)
+            {
+                const JpegSegment *segment = &index._segments[i];
+                unsigned char identifier[BYTE_SIZE_SEGMENT_IDENTIFIER];
+
+                memset(identifier, 0x00, sizeof(identifier));
+                if(expected[i]._identifier != NULL)
+                {
+                    memcpy(identifier, expected[i]._identifier, BYTE_SIZE_SEGMENT_IDENTIFIER);
+                }
+
+                if(segment->_marker != expected[i]._marker || segment->_size != expected[i]._size ||
+                        segment->_offset != expected[i]._offset || segment->_nextOffset != expected[i]._nextOffset ||
+                        memcmp(segment->_identifier, identifier, BYTE_SIZE_SEGMENT_IDENTIFIER) != 0)
+                {
+                    fprintf(stderr, "%s (pass %d): segment %lu: got %04X size %u at %lu next %lu\n", label, pass,
+                            (unsigned long)i, segment->_marker, segment->_size, segment->_offset, segment->_nextOffset);
+                    ++testFailures;
+                }
+
+                /* 各セグメントの位置とその直後から走査を始めた場合の位置 */
+                TEST_CHECK_EQUAL(i, findSegmentPosition(&index, segment->_offset));
+                TEST_CHECK_EQUAL(i + 1, findSegmentPosition(&index, segment->_offset + 1));
+            }
+        }
+
+        releaseSegmentIndex(&index);
+        arenaRelease(&arena);
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    unsigned char data[IMAGE_CAPACITY];
+    ExpectedSegment expected[COM_COUNT + 2];
+    unsigned char storage[sizeof(JpegBuffer) + IMAGE_CAPACITY];
+    JpegBuffer *buffer = (JpegBuffer *)storage;
+    JpegSegmentIndex index;
+    size_t length;
+    size_t i;
+
+    /* 基本となる画像 */
+    _check("basic", BASIC_IMAGE, sizeof(BASIC_IMAGE), BASIC_SEGMENTS, sizeof(BASIC_SEGMENTS) / sizeof(BASIC_SEGMENTS[0]));
+
+    /* 識別子の途中でデータが終わる APP5 （次の走査開始位置がデータ長を超えるため終了する） */
+    memcpy(expected, BASIC_SEGMENTS, sizeof(BASIC_SEGMENTS));
+    expected[2]._identifier = "DCP\0\0\0";
+    _check("truncated identifier", BASIC_IMAGE, 35, expected, 3);
+
+    /* サイズ定義の途中でデータが終わる APP5 （サイズ定義は 0 として扱い、直後のデータ終端で終了する） */
+    expected[2]._size = 0x0000;
+    expected[2]._nextOffset = 30;
+    expected[2]._identifier = NULL;
+    expected[3]._marker = 0xFFFF;
+    expected[3]._size = 0x0000;
+    expected[3]._offset = 30;
+    expected[3]._nextOffset = 30;
+    _check("truncated size", BASIC_IMAGE, 31, expected, 4);
+
+    /* セグメントの終わりでデータが終わる（データ終端を示す 0xFFFF を登録して終了する） */
+    memcpy(expected, BASIC_SEGMENTS, sizeof(BASIC_SEGMENTS));
+    expected[3]._marker = 0xFFFF;
+    expected[3]._size = 0x0000;
+    expected[3]._nextOffset = 40;
+    _check("end of data", BASIC_IMAGE, 40, expected, 4);
+
+    /* SOS の前の EOI */
+    memcpy(data, BASIC_IMAGE, sizeof(BASIC_IMAGE));
+    data[48] = 0xD9;
+    memcpy(expected, BASIC_SEGMENTS, sizeof(BASIC_SEGMENTS));
+    expected[4]._marker = 0xFFD9;
+    expected[4]._size = 0x0000;
+    expected[4]._nextOffset = 47;
+    _check("EOI", data, sizeof(BASIC_IMAGE), expected, 5);
+
+    /* 2 つ目の SOI （サイズ定義を持たずに 2 バイト進む） */
+    memcpy(data, BASIC_IMAGE, sizeof(BASIC_IMAGE));
+    data[48] = 0xD8;
+    data[49] = 0xFF;
+    data[50] = 0xDA;
+    memcpy(expected, BASIC_SEGMENTS, sizeof(BASIC_SEGMENTS));
+    expected[4]._marker = 0xFFD8;
+    expected[4]._size = 0x0000;
+    expected[4]._nextOffset = 49;
+    expected[5]._marker = 0xFFDA;
+    expected[5]._size = 0x0000;
+    expected[5]._offset = 49;
+    expected[5]._nextOffset = 49;
+    _check("SOI", data, sizeof(BASIC_IMAGE), expected, 6);
+
+    /* 判別不可能なマーカー（ 0xFF で始まらない位置） */
+    memcpy(data, BASIC_IMAGE, sizeof(BASIC_IMAGE));
+    data[40] = 0x12;
+    memcpy(expected, BASIC_SEGMENTS, sizeof(BASIC_SEGMENTS));
+    expected[3]._marker = 0x12FE;
+    expected[3]._size = 0x0000;
+    expected[3]._nextOffset = 40;
+    _check("unknown marker", data, sizeof(BASIC_IMAGE), expected, 4);
+
+    /* 索引の初期の大きさを超える数のセグメント */
+    length = 0;
+    data[length++] = 0xFF;
+    data[length++] = 0xD8;
+    for(i = 0; i < COM_COUNT; ++i)
+    {
+        expected[i]._marker = 0xFFFE;
+        expected[i]._size = (unsigned short)(2 + i % 5);
+        expected[i]._offset = (unsigned long)length;
+        expected[i]._nextOffset = (unsigned long)(length + 2 + expected[i]._size);
+        expected[i]._identifier = NULL;
+
+        data[length++] = 0xFF;
+        data[length++] = 0xFE;
+        data[length++] = 0x00;
+        data[length++] = (unsigned char)expected[i]._size;
+        memset(data + length, 'x', expected[i]._size - 2U);
+        length += expected[i]._size - 2U;
+    }
+    expected[COM_COUNT]._marker = 0xFFDA;
+    expected[COM_COUNT]._size = 0x0000;
+    expected[COM_COUNT]._offset = (unsigned long)length;
+    expected[COM_COUNT]._nextOffset = (unsigned long)length;
+    expected[COM_COUNT]._identifier = NULL;
+    data[length++] = 0xFF;
+    data[length++] = 0xDA;
+    _check("many segments", data, length, expected, COM_COUNT + 1);
+
+    /* 先頭が SOI でない場合 */
+    buffer->_len = sizeof(BASIC_IMAGE) - 2;
+    memcpy(buffer->_buff, BASIC_IMAGE + 2, buffer->_len);
+    TEST_CHECK_EQUAL(INCORRECT_EXIF_FORMAT, buildSegmentIndex(buffer, &index, NULL));
+    releaseSegmentIndex(&index);
+
+    /* 索引に保持した識別子の比較 */
+    buffer->_len = sizeof(BASIC_IMAGE);
+    memcpy(buffer->_buff, BASIC_IMAGE, sizeof(BASIC_IMAGE));
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, buildSegmentIndex(buffer, &index, NULL));
+    if(index._count == sizeof(BASIC_SEGMENTS) / sizeof(BASIC_SEGMENTS[0]))
+    {
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, checkSegmentIdentifier("Exif", buffer, &index._segments[0], 4));
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, checkSegmentIdentifier("Exif\0", buffer, &index._segments[0], 6));
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, checkSegmentIdentifier("DCPMI", buffer, &index._segments[2], 6));
+        TEST_CHECK_EQUAL(INCORRECT_IDENTIFIER, checkSegmentIdentifier("Exif", buffer, &index._segments[2], 4));
+        TEST_CHECK_EQUAL(INCORRECT_IDENTIFIER, checkSegmentIdentifier("DCPMJ", buffer, &index._segments[2], 6));
+
+        /* 索引に保持していない長さはデータから読み込む */
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, checkSegmentIdentifier("DCPMI\0\x01", buffer, &index._segments[2], 7));
+        TEST_CHECK_EQUAL(INCORRECT_IDENTIFIER, checkSegmentIdentifier("DCPMI\0\x02", buffer, &index._segments[2], 7));
+    }
+    else
+    {
+        TEST_CHECK_EQUAL(sizeof(BASIC_SEGMENTS) / sizeof(BASIC_SEGMENTS[0]), index._count);
+    }
+    releaseSegmentIndex(&index);
+
+    return testFailures == 0 ? 0 : 1;
+}
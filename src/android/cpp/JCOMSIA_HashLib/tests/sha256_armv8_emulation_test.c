@@ -0,0 +1,37 @@
+﻿/*!
+@file sha256_armv8_emulation_test.c
+@brief ARMv8 の SHA2 命令による実装 (computationARMv8) を、x86 上で命令を再現して検証するテスト
+@details AArch64 向けとしてプリプロセッサの定義を切り替えたうえで sha256.c を取り込み、
+neon_emulation/arm_neon.h の組み込み関数で computationARMv8 をコンパイルする。
+実機での動作確認は、AArch64 向けにビルドした sha256_kernel_test で行う。
+*/
+
+/* x86 向けのシステムヘッダは、アーキテクチャの定義を切り替える前に読み込んでおく */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/auxv.h>
+
+#undef __x86_64__
+#undef __i386__
+#define __aarch64__ 1
+#define __ARM_FEATURE_SHA2 1
+
+#include "../sha256.c"
+
+#if !defined(SHA256_USE_ARMV8_SHA2)
+#error computationARMv8 is not enabled
+#endif
+
+#include "sha256_kernel_cases.h"
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    return runKernelCases("computationARMv8 (emulated)") == 0 ? 0 : 1;
+}
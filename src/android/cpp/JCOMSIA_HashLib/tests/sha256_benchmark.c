@@ -0,0 +1,143 @@
+﻿/*!
+@file sha256_benchmark.c
+@brief ハッシュ値 (SHA-256) 計算の処理速度を、高速化前の実装と比較するベンチマーク
+@details 1 KB から 32 MB までのデータについて hash() と referenceHash() の処理速度 (MB/s) を表示する。
+両者の結果が一致しない場合は 1 を返して終了する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common.h"
+#include "sha256.h"
+#include "sha256_reference.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define BENCHMARK_MIN_TOTAL_BYTES ((size_t)64 * 1024 * 1024)    /*!< @brief 1 つのデータ長で最低限処理するバイト数 */
+#define BENCHMARK_MAX_LENGTH ((size_t)32 * 1024 * 1024)         /*!< @brief 計測する最大のデータ長 */
+/* @} */
+
+/*! 計測するデータ長 */
+static const size_t BENCHMARK_LENGTHS[] =
+{
+    1024, 16 * 1024, 256 * 1024, 1024 * 1024, 8 * 1024 * 1024, BENCHMARK_MAX_LENGTH
+};
+
+/*!
+@brief ハッシュ値の計算関数の型
+*/
+typedef int (*HashFunction)(HashBuffer *byteArray, HashBuffer *result);
+
+/*!
+@brief 単調増加する時刻を秒で返す。
+@return 時刻
+*/
+static double _now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*!
+@brief ハッシュ値の計算を繰り返し、処理速度を計測する。
+@param hashFunction 計測する関数
+@param [in] data 入力データ
+@param [out] result ハッシュ値を受けとる変数
+@param repeat 繰り返す回数
+@return 処理速度 (MB/s)。計算に失敗した場合は負の値
+*/
+static double _measure(HashFunction hashFunction, HashBuffer *data, HashBuffer *result, size_t repeat)
+{
+    double start;
+    double elapsed;
+    size_t i;
+
+    start = _now();
+    for(i = 0; i < repeat; ++i)
+    {
+        result->_len = BYTE_SIZE_HASH_LENGTH;
+        if(hashFunction(data, result) != FUNCTION_SUCCESS)
+        {
+            return -1.0;
+        }
+    }
+    elapsed = _now() - start;
+
+    return (double)(data->_len * repeat) / (1024.0 * 1024.0) / (elapsed > 0.0 ? elapsed : 1e-9);
+}
+
+/*!
+@brief ベンチマークを実行する。
+@retval 0 成功
+@retval 1 計算に失敗した場合、または結果が一致しない場合
+*/
+int main(void)
+{
+    HashBuffer *data;
+    HashBuffer *expected;
+    HashBuffer *actual;
+    double referenceSpeed;
+    double currentSpeed;
+    size_t repeat;
+    size_t i;
+    unsigned int seed = 2015U;
+    int ret = 0;
+
+    data = (HashBuffer *)malloc(sizeof(HashBuffer) + BENCHMARK_MAX_LENGTH);
+    expected = (HashBuffer *)malloc(sizeof(HashBuffer) + BYTE_SIZE_HASH_LENGTH);
+    actual = (HashBuffer *)malloc(sizeof(HashBuffer) + BYTE_SIZE_HASH_LENGTH);
+    if(data == NULL || expected == NULL || actual == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        ret = 1;
+        goto FINALIZE;
+    }
+
+    for(i = 0; i < BENCHMARK_MAX_LENGTH; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        data->_buff[i] = (unsigned char)(seed >> 16);
+    }
+
+    printf("%10s %16s %16s %8s\n", "bytes", "reference MB/s", "current MB/s", "ratio");
+
+    for(i = 0; i < sizeof(BENCHMARK_LENGTHS) / sizeof(BENCHMARK_LENGTHS[0]); ++i)
+    {
+        data->_len = BENCHMARK_LENGTHS[i];
+        repeat = BENCHMARK_MIN_TOTAL_BYTES / data->_len;
+        if(repeat == 0)
+        {
+            repeat = 1;
+        }
+
+        referenceSpeed = _measure(referenceHash, data, expected, repeat);
+        currentSpeed = _measure(hash, data, actual, repeat);
+        if(referenceSpeed < 0.0 || currentSpeed < 0.0)
+        {
+            fprintf(stderr, "hash failed at %u bytes\n", (unsigned int)data->_len);
+            ret = 1;
+            goto FINALIZE;
+        }
+
+        if(memcmp(expected->_buff, actual->_buff, BYTE_SIZE_HASH_LENGTH) != 0)
+        {
+            fprintf(stderr, "hash mismatch at %u bytes\n", (unsigned int)data->_len);
+            ret = 1;
+            goto FINALIZE;
+        }
+
+        printf("%10u %16.1f %16.1f %7.1fx\n", (unsigned int)data->_len, referenceSpeed, currentSpeed, currentSpeed / referenceSpeed);
+    }
+
+FINALIZE:
+    free(data);
+    free(expected);
+    free(actual);
+
+    return ret;
+}
@@ -0,0 +1,223 @@
+﻿/*!
+@file sha256_kernel_cases.h
+@brief ハッシュ値 (SHA-256) のブロック処理関数を比較するテストケース
+@details sha256.c を取り込んだ翻訳単位から読み込み、computationHardware を computationPortable と比較する。
+*/
+#ifndef SHA256_KERNEL_CASES_H_
+#define SHA256_KERNEL_CASES_H_
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define KERNEL_CASE_MAX_LENGTH ((size_t)(BYTE_SIZE_MESSAGE_BLOCK * 64 + 7))  /*!< @brief 比較に使用するデータの最大長 */
+#define KERNEL_CASE_MAX_BLOCKS ((size_t)17)                                  /*!< @brief 中間状態の比較で一度に処理する最大ブロック数 */
+/* @} */
+
+/*!
+@struct KnownAnswer
+@brief 既知の入力とハッシュ値の組 (FIPS 180-2)
+*/
+typedef struct
+{
+    const char *_message;           /*!< @brief 入力文字列 */
+    size_t _repeat;                 /*!< @brief 入力文字列を繰り返す回数 */
+    const char *_digest;            /*!< @brief 期待するハッシュ値（16 進数文字列） */
+} KnownAnswer;
+
+/*! 既知の入力とハッシュ値 */
+static const KnownAnswer KNOWN_ANSWERS[] =
+{
+    { "", 1, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", 1, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 1,
+      "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+    { "aaaaaaaaaa", 100000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" }
+};
+
+/*! 境界となるデータ長（パディングが 1 ブロックと 2 ブロックに分かれる前後と、複数ブロック） */
+static const size_t KERNEL_CASE_LENGTHS[] =
+{
+    0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 1000,
+    BYTE_SIZE_MESSAGE_BLOCK * 17 + 3, KERNEL_CASE_MAX_LENGTH
+};
+
+/*!
+@brief 再現可能な疑似乱数でバイト配列を埋める。
+@param [out] dst 埋める配列
+@param length dst の長さ
+@param seed 乱数の種
+*/
+static void _fillPseudoRandom(unsigned char *dst, size_t length, unsigned int seed)
+{
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        dst[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+/*!
+@brief 指定したブロック処理関数だけを使ってハッシュ値を計算する。
+@param blockFunction ブロック処理関数
+@param [in] data 入力データ
+@param length data の長さ
+@param [out] digest ハッシュ値を受けとる配列（BYTE_SIZE_HASH_DIGEST バイト）
+*/
+static void _digestWith(SHA256BlockFunction blockFunction, const unsigned char *data, size_t length, unsigned char *digest)
+{
+    unsigned int state[UINT_SIZE_HASH_STATE];
+    unsigned char finalBlocks[BYTE_SIZE_MESSAGE_BLOCK * 2];
+    size_t fullBlockCount = length / BYTE_SIZE_MESSAGE_BLOCK;
+    size_t finalBlockCount;
+
+    memcpy(state, DEFAULT_UINT_HASH, sizeof(state));
+
+    if(fullBlockCount != 0)
+    {
+        blockFunction(state, data, fullBlockCount);
+    }
+
+    finalBlockCount = _buildFinalBlocks(finalBlocks, data + fullBlockCount * BYTE_SIZE_MESSAGE_BLOCK,
+                                        length - fullBlockCount * BYTE_SIZE_MESSAGE_BLOCK, length);
+    blockFunction(state, finalBlocks, finalBlockCount);
+
+    _writeDigest(state, digest);
+}
+
+/*!
+@brief ハッシュ値を 16 進数文字列に変換する。
+@param [in] digest ハッシュ値（BYTE_SIZE_HASH_DIGEST バイト）
+@param [out] text 変換結果（BYTE_SIZE_HASH_DIGEST * 2 + 1 バイト）
+*/
+static void _toHexText(const unsigned char *digest, char *text)
+{
+    static const char HEX[] = "0123456789abcdef";
+    size_t i;
+
+    for(i = 0; i < BYTE_SIZE_HASH_DIGEST; ++i)
+    {
+        text[i * 2] = HEX[digest[i] >> 4];
+        text[i * 2 + 1] = HEX[digest[i] & 0x0F];
+    }
+    text[BYTE_SIZE_HASH_DIGEST * 2] = '\0';
+}
+
+/*!
+@brief 既知の入力に対するハッシュ値を検査する。
+@param blockFunction ブロック処理関数
+@param [in] name 結果の表示に使用する関数名
+@return 失敗したケースの数
+*/
+static int _checkKnownAnswers(SHA256BlockFunction blockFunction, const char *name)
+{
+    unsigned char *message;
+    unsigned char digest[BYTE_SIZE_HASH_DIGEST];
+    char text[BYTE_SIZE_HASH_DIGEST * 2 + 1];
+    size_t messageLength;
+    size_t i;
+    size_t j;
+    int failures = 0;
+
+    for(i = 0; i < sizeof(KNOWN_ANSWERS) / sizeof(KNOWN_ANSWERS[0]); ++i)
+    {
+        messageLength = strlen(KNOWN_ANSWERS[i]._message);
+        if((message = (unsigned char *)malloc(messageLength * KNOWN_ANSWERS[i]._repeat + 1)) == NULL)
+        {
+            fprintf(stderr, "%s: out of memory\n", name);
+            return failures + 1;
+        }
+
+        for(j = 0; j < KNOWN_ANSWERS[i]._repeat; ++j)
+        {
+            memcpy(message + j * messageLength, KNOWN_ANSWERS[i]._message, messageLength);
+        }
+
+        _digestWith(blockFunction, message, messageLength * KNOWN_ANSWERS[i]._repeat, digest);
+        _toHexText(digest, text);
+        if(strcmp(text, KNOWN_ANSWERS[i]._digest) != 0)
+        {
+            fprintf(stderr, "%s: known answer %u mismatch: %s\n", name, (unsigned int)i, text);
+            ++failures;
+        }
+
+        free(message);
+    }
+
+    return failures;
+}
+
+/*!
+@brief 境界となるデータ長と複数ブロックの入力について、ブロック処理関数を移植性のある実装と比較する。
+@param blockFunction 比較するブロック処理関数
+@param [in] name 結果の表示に使用する関数名
+@return 失敗したケースの数
+*/
+static int _compareWithPortable(SHA256BlockFunction blockFunction, const char *name)
+{
+    static unsigned char data[KERNEL_CASE_MAX_LENGTH];
+    unsigned char expected[BYTE_SIZE_HASH_DIGEST];
+    unsigned char actual[BYTE_SIZE_HASH_DIGEST];
+    unsigned int expectedState[UINT_SIZE_HASH_STATE];
+    unsigned int actualState[UINT_SIZE_HASH_STATE];
+    size_t i;
+    size_t blockCount;
+    int failures = 0;
+
+    _fillPseudoRandom(data, sizeof(data), 2015U);
+
+    /* パディングを含めたハッシュ値 */
+    for(i = 0; i < sizeof(KERNEL_CASE_LENGTHS) / sizeof(KERNEL_CASE_LENGTHS[0]); ++i)
+    {
+        _digestWith(computationPortable, data, KERNEL_CASE_LENGTHS[i], expected);
+        _digestWith(blockFunction, data, KERNEL_CASE_LENGTHS[i], actual);
+        if(memcmp(expected, actual, sizeof(expected)) != 0)
+        {
+            fprintf(stderr, "%s: digest mismatch at %u bytes\n", name, (unsigned int)KERNEL_CASE_LENGTHS[i]);
+            ++failures;
+        }
+    }
+
+    /* 任意の中間状態から複数ブロックを続けて処理した結果 */
+    for(blockCount = 1; blockCount <= KERNEL_CASE_MAX_BLOCKS; ++blockCount)
+    {
+        _fillPseudoRandom((unsigned char *)expectedState, sizeof(expectedState), (unsigned int)blockCount);
+        memcpy(actualState, expectedState, sizeof(actualState));
+
+        computationPortable(expectedState, data + blockCount, blockCount);
+        blockFunction(actualState, data + blockCount, blockCount);
+        if(memcmp(expectedState, actualState, sizeof(expectedState)) != 0)
+        {
+            fprintf(stderr, "%s: state mismatch after %u blocks\n", name, (unsigned int)blockCount);
+            ++failures;
+        }
+    }
+
+    return failures;
+}
+
+#if defined(computationHardware)
+
+/*!
+@brief computationHardware を既知の入力と移植性のある実装で検査する。
+@param [in] name 結果の表示に使用する関数名
+@return 失敗したケースの数
+*/
+static int runKernelCases(const char *name)
+{
+    int failures = 0;
+
+    failures += _checkKnownAnswers(computationPortable, "computationPortable");
+    failures += _checkKnownAnswers(computationHardware, name);
+    failures += _compareWithPortable(computationHardware, name);
+
+    printf("%s: %d failure(s)\n", name, failures);
+
+    return failures;
+}
+
+#endif /* computationHardware */
+
+#endif /* SHA256_KERNEL_CASES_H_ */
@@ -0,0 +1,38 @@
+﻿/*!
+@file sha256_kernel_test.c
+@brief ハッシュ値 (SHA-256) のハードウェア命令による実装を、移植性のある実装と比較するテスト
+@details 稼働中の CPU が SHA-NI (x86) または ARMv8 の SHA2 命令に対応していない場合はスキップする。
+*/
+#include "../sha256.c"
+#include "sha256_kernel_cases.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define TEST_SKIPPED (77)   /*!< @brief テストをスキップしたことを示す終了コード */
+/* @} */
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+@retval TEST_SKIPPED ハードウェア命令を利用できない場合
+*/
+int main(void)
+{
+#if defined(SHA256_HW_DISPATCH)
+    if(_hasHardwareSHA256() != JACIC_BOOL_TRUE)
+    {
+        printf("hardware SHA-256 instructions are not available\n");
+        return TEST_SKIPPED;
+    }
+
+#if defined(SHA256_USE_X86_SHA_NI)
+    return runKernelCases("computationSHANI") == 0 ? 0 : 1;
+#else
+    return runKernelCases("computationARMv8") == 0 ? 0 : 1;
+#endif
+#else
+    printf("hardware SHA-256 instructions are not enabled in this build\n");
+    return TEST_SKIPPED;
+#endif /* SHA256_HW_DISPATCH */
+}
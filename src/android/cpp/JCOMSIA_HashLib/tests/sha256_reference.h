@@ -0,0 +1,20 @@
+﻿/*!
+@file sha256_reference.h
+@brief 高速化前のハッシュ値 (SHA-256) 計算処理のヘッダ（ベンチマークの比較用）
+*/
+#ifndef SHA256_REFERENCE_H_
+#define SHA256_REFERENCE_H_
+
+#include "common.h"
+
+/*!
+@brief 可変長のバイト配列を受けてハッシュ値を返す（sha256.c の version 3.0 の hash と同じ処理）。
+@param [in] byteArray ハッシュ値を計算するもととなるバイト配列構造体
+@param [out] result 最終的に算出されたハッシュ値を受けとる変数
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数により、内部で使用する関数でエラーが発生した場合
+@retval OTHER_ERROR メモリの確保に失敗した場合、ハッシュ値の格納に失敗した場合など
+*/
+int referenceHash(HashBuffer *byteArray, HashBuffer *result);
+
+#endif /* SHA256_REFERENCE_H_ */
@@ -0,0 +1,226 @@
+﻿/*!
+@file sha256_test.c
+@brief ハッシュ値 (SHA-256) の逐次計算 (sha256Init / sha256Update / sha256Final) を既知の値と一括計算の結果と比較するテスト
+@details FIPS 180-2 の例示の値と一致すること、データを任意の位置で分割して追加しても
+高速化前の一括計算 (referenceHash) と同じ値になることを確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "sha256.h"
+#include "sha256_reference.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define MAX_LENGTH ((size_t)300)            /*!< @brief 分割位置を変えて比較するデータの最大長 */
+#define MILLION_LENGTH ((size_t)1000000)    /*!< @brief 'a' を繰り返すデータの長さ */
+#define MILLION_CHUNK ((size_t)997)         /*!< @brief 'a' を繰り返すデータを追加する単位（ブロック長の倍数にしない） */
+/* @} */
+
+/*!
+@struct KnownAnswer
+@brief 既知のハッシュ値
+*/
+typedef struct
+{
+    const char *_message;   /*!< @brief 入力 */
+    const char *_expected;  /*!< @brief 期待するハッシュ値（16 進数文字列） */
+} KnownAnswer;
+
+/*! FIPS 180-2 の例示の値 */
+static const KnownAnswer KNOWN_ANSWERS[] =
+{
+    { "", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+            "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" }
+};
+
+/*! 'a' を 1,000,000 回繰り返したデータのハッシュ値 */
+static const char *MILLION_EXPECTED = "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+/*!
+@brief 逐次計算の結果を 16 進数文字列で取得する。
+@param [in, out] context 計算中のコンテキスト
+@param [out] hex 結果を受けとる配列（BYTE_SIZE_HASH_LENGTH + 1 バイト、終端文字を付加する）
+*/
+static void _final(SHA256Context *context, char *hex)
+{
+    HashBuffer *result = allocateBinaryData(BYTE_SIZE_HASH_LENGTH);
+
+    memset(hex, 0, BYTE_SIZE_HASH_LENGTH + 1);
+
+    TEST_CHECK(result != NULL);
+    if(result == NULL) return;
+
+    TEST_CHECK_EQUAL(FUNCTION_SUCCESS, sha256Final(context, result));
+    TEST_CHECK_EQUAL(BYTE_SIZE_HASH_LENGTH, result->_len);
+    memcpy(hex, result->_buff, BYTE_SIZE_HASH_LENGTH);
+
+    releaseMemory(result);
+}
+
+/*!
+@brief データを 1 か所で分割して逐次計算する。
+@param [in] data 計算対象のデータ
+@param length data の長さ
+@param split 分割する位置
+@param [out] hex 結果を受けとる配列（BYTE_SIZE_HASH_LENGTH + 1 バイト）
+*/
+static void _hashSplit(const unsigned char *data, size_t length, size_t split, char *hex)
+{
+    SHA256Context context;
+
+    sha256Init(&context);
+    sha256Update(&context, data, split);
+    sha256Update(&context, data + split, length - split);
+    _final(&context, hex);
+}
+
+/*!
+@brief データを一定の長さずつ追加して逐次計算する。
+@param [in] data 計算対象のデータ
+@param length data の長さ
+@param chunk 1 回に追加するバイト数
+@param [out] hex 結果を受けとる配列（BYTE_SIZE_HASH_LENGTH + 1 バイト）
+*/
+static void _hashChunked(const unsigned char *data, size_t length, size_t chunk, char *hex)
+{
+    SHA256Context context;
+    size_t offset;
+
+    sha256Init(&context);
+    for(offset = 0; offset < length; offset += chunk)
+    {
+        sha256Update(&context, data + offset, length - offset < chunk ? length - offset : chunk);
+    }
+    _final(&context, hex);
+}
+
+/*!
+@brief 高速化前の実装で一括計算する。
+@param [in] data 計算対象のデータ
+@param length data の長さ
+@param [out] hex 結果を受けとる配列（BYTE_SIZE_HASH_LENGTH + 1 バイト）
+*/
+static void _hashReference(const unsigned char *data, size_t length, char *hex)
+{
+    /* allocateBinaryData は長さ 0 の領域を確保できないため、1 バイト確保して長さを設定し直す */
+    HashBuffer *input = allocateBinaryData(length == 0 ? 1 : length);
+    HashBuffer *result = allocateBinaryData(BYTE_SIZE_HASH_LENGTH);
+
+    memset(hex, 0, BYTE_SIZE_HASH_LENGTH + 1);
+
+    TEST_CHECK(input != NULL && result != NULL);
+    if(input != NULL && result != NULL)
+    {
+        memcpy(input->_buff, data, length);
+        input->_len = length;
+        TEST_CHECK_EQUAL(FUNCTION_SUCCESS, referenceHash(input, result));
+        memcpy(hex, result->_buff, BYTE_SIZE_HASH_LENGTH);
+    }
+
+    releaseMemory(input);
+    releaseMemory(result);
+}
+
+/*!
+@brief 2 つのハッシュ値を比較し、異なる場合は失敗として表示する。
+@param [in] label 失敗時に表示する場面の名前
+@param length データの長さ
+@param parameter 分割位置など、場面ごとの値
+@param [in] expected 期待するハッシュ値
+@param [in] actual 計算したハッシュ値
+*/
+static void _compare(const char *label, size_t length, size_t parameter, const char *expected, const char *actual)
+{
+    if(memcmp(expected, actual, BYTE_SIZE_HASH_LENGTH) != 0)
+    {
+        fprintf(stderr, "%s: length %lu, %lu: expected %s, got %s\n", label,
+                (unsigned long)length, (unsigned long)parameter, expected, actual);
+        ++testFailures;
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const size_t CHUNKS[] = { 1, 3, 55, 56, 63, 64, 65, 127, 128, 129 };
+
+    unsigned char data[MAX_LENGTH];
+    unsigned char *million;
+    char expected[BYTE_SIZE_HASH_LENGTH + 1];
+    char actual[BYTE_SIZE_HASH_LENGTH + 1];
+    unsigned int state = 12345U;
+    size_t length;
+    size_t split;
+    size_t i;
+
+    /* 既知のハッシュ値（全ての分割位置） */
+    for(i = 0; i < sizeof(KNOWN_ANSWERS) / sizeof(KNOWN_ANSWERS[0]); ++i)
+    {
+        const unsigned char *message = (const unsigned char *)KNOWN_ANSWERS[i]._message;
+
+        length = strlen(KNOWN_ANSWERS[i]._message);
+
+        for(split = 0; split <= length; ++split)
+        {
+            _hashSplit(message, length, split, actual);
+            _compare("known answer", length, split, KNOWN_ANSWERS[i]._expected, actual);
+        }
+
+        _hashChunked(message, length, 1, actual);
+        _compare("known answer (byte by byte)", length, 1, KNOWN_ANSWERS[i]._expected, actual);
+
+        _hashReference(message, length, actual);
+        _compare("known answer (reference)", length, 0, KNOWN_ANSWERS[i]._expected, actual);
+    }
+
+    /* 'a' を 1,000,000 回繰り返したデータ */
+    million = (unsigned char *)malloc(MILLION_LENGTH);
+    TEST_CHECK(million != NULL);
+    if(million != NULL)
+    {
+        memset(million, 'a', MILLION_LENGTH);
+        _hashChunked(million, MILLION_LENGTH, MILLION_CHUNK, actual);
+        _compare("million", MILLION_LENGTH, MILLION_CHUNK, MILLION_EXPECTED, actual);
+        _hashChunked(million, MILLION_LENGTH, MILLION_LENGTH, actual);
+        _compare("million", MILLION_LENGTH, MILLION_LENGTH, MILLION_EXPECTED, actual);
+        free(million);
+    }
+
+    /* 逐次計算と一括計算（全ての長さ・分割位置） */
+    for(i = 0; i < MAX_LENGTH; ++i)
+    {
+        state = state * 1103515245U + 12345U;
+        data[i] = (unsigned char)(state >> 16);
+    }
+
+    for(length = 0; length <= MAX_LENGTH; ++length)
+    {
+        _hashReference(data, length, expected);
+
+        for(split = 0; split <= length; ++split)
+        {
+            _hashSplit(data, length, split, actual);
+            _compare("split", length, split, expected, actual);
+        }
+
+        for(i = 0; i < sizeof(CHUNKS) / sizeof(CHUNKS[0]); ++i)
+        {
+            _hashChunked(data, length, CHUNKS[i], actual);
+            _compare("chunked", length, CHUNKS[i], expected, actual);
+        }
+    }
+
+    return testFailures == 0 ? 0 : 1;
+}
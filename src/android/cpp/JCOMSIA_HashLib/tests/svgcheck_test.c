@@ -0,0 +1,172 @@
+﻿/*!
+@file svgcheck_test.c
+@brief 画像を逐次処理する SVG ファイルの検証結果が、画像全体をデコードする検証結果と一致することを検査するテスト
+@details 改ざん無し、画像や撮影日時の改ざん、組み合わせの不一致、メタデータや XML の破損などの SVG ファイルについて、
+逐次処理を無効にした場合、Expat で逐次処理した場合、高速解析で逐次処理した場合の JCOMSIA_SVG_CheckHashValue の戻り値を比較する。
+逐次処理で結果が得られた場合は画像全体をデコードして検証し直さないこと、
+想定する構成の SVG ファイルは逐次処理する場合も高速解析で解析することも確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "svg.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define SCAN_LENGTH (24 * 1024) /*!< @brief テスト用画像の画像データのバイト数 */
+#define HASH_CODE_START "<dcpm:hashCode>"           /*!< @brief ハッシュコードの直前の文字列 */
+#define IMAGE_DATA_START "data:image/jpeg;base64,"  /*!< @brief 画像データの直前の文字列 */
+/* @} */
+
+/*!
+@brief 1 つの SVG ファイルについて、逐次処理の有無と解析方法による検証結果を比較する。
+@param [in] path SVG ファイル
+@param expected 期待する検証結果
+@param streamable Expat で逐次処理して結果が得られるファイルの場合は 1
+@param scannable 高速解析で逐次処理して結果が得られるファイルの場合は 1
+@param scanCount 高速解析を有効にした場合に、高速解析で解析する回数（画像全体をデコードして検証し直す分を含む）
+*/
+static void _compare(const char *path, int expected, int streamable, int scannable, int scanCount)
+{
+    SVGParseStatistics statistics;
+    int fullResult;
+    int expatResult;
+    int scanResult;
+
+    /* 画像全体をデコードして検証する */
+    setSVGImageStreaming(JACIC_BOOL_FALSE);
+    resetSVGParseStatistics();
+    fullResult = JCOMSIA_SVG_CheckHashValue(path);
+    getSVGParseStatistics(&statistics);
+    TEST_CHECK_EQUAL(1, statistics._parseCount);
+    setSVGImageStreaming(JACIC_BOOL_TRUE);
+
+    /* Expat で画像を逐次処理して検証する */
+    setSVGFastScan(JACIC_BOOL_FALSE);
+    resetSVGParseStatistics();
+    expatResult = JCOMSIA_SVG_CheckHashValue(path);
+    getSVGParseStatistics(&statistics);
+    TEST_CHECK_EQUAL(1, statistics._streamingCount);
+    TEST_CHECK_EQUAL(streamable ? 0 : 1, statistics._parseCount);
+    TEST_CHECK_EQUAL(0, statistics._scanCount);
+    setSVGFastScan(JACIC_BOOL_TRUE);
+
+    /* 高速解析で画像を逐次処理して検証する */
+    resetSVGParseStatistics();
+    scanResult = JCOMSIA_SVG_CheckHashValue(path);
+    getSVGParseStatistics(&statistics);
+    TEST_CHECK_EQUAL(1, statistics._streamingCount);
+    TEST_CHECK_EQUAL((streamable || scannable) ? 0 : 1, statistics._parseCount);
+    TEST_CHECK_EQUAL(scanCount, statistics._scanCount);
+
+    if(fullResult != expected || expatResult != fullResult || scanResult != fullResult)
+    {
+        fprintf(stderr, "%s: expected %d, full %d, expat %d, scan %d\n", path, expected, fullResult, expatResult, scanResult);
+        ++testFailures;
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char originalPath[TEST_PATH_LENGTH];
+    char otherPath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    char tamperedPath[TEST_PATH_LENGTH];
+    char tamperedChalkboardPath[TEST_PATH_LENGTH];
+    char pairPath[TEST_PATH_LENGTH];
+    char otherPairPath[TEST_PATH_LENGTH];
+    char singlePath[TEST_PATH_LENGTH];
+    char path[TEST_PATH_LENGTH];
+    char sourcePath[TEST_PATH_LENGTH];
+    char *pairText;
+    char *singleText;
+    size_t length = 0;
+
+    if(initTestDirectory("svgcheck") != 0) return 1;
+
+    testPath(originalPath, "original.jpg");
+    testPath(otherPath, "other.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+    testPath(tamperedPath, "tampered.jpg");
+    testPath(tamperedChalkboardPath, "tampered_chalkboard.jpg");
+    testPath(pairPath, "pair.svg");
+    testPath(otherPairPath, "other_pair.svg");
+    testPath(singlePath, "original.svg");
+    testPath(sourcePath, "source.svg");
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(originalPath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(otherPath, 480, 320, TEST_DATE_TIME, SCAN_LENGTH, 3U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH / 2, 2U));
+    TEST_CHECK_EQUAL(0, writeTamperedTestJpeg(originalPath, tamperedPath));
+    TEST_CHECK_EQUAL(0, writeTamperedTestJpeg(chalkboardPath, tamperedChalkboardPath));
+    TEST_CHECK_EQUAL(0, writeTestSvg(pairPath, originalPath, chalkboardPath, "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(otherPairPath, otherPath, chalkboardPath, "vender"));
+    TEST_CHECK_EQUAL(0, writeTestSvg(singlePath, originalPath, NULL, "vender"));
+
+    pairText = (char *)readTestFile(pairPath, &length);
+    singleText = (char *)readTestFile(singlePath, &length);
+    TEST_CHECK(pairText != NULL && singleText != NULL);
+    if(pairText == NULL || singleText == NULL) return 1;
+
+    /* 改ざん無し */
+    _compare(pairPath, JC_SVG_RESULT_OK, 1, 1, 1);
+    _compare(singlePath, JC_SVG_RESULT_OK, 1, 1, 1);
+
+    /* 画像の改ざん */
+    testPath(path, "image_ng.svg");
+    TEST_CHECK_EQUAL(0, writeTestSvg(path, tamperedPath, NULL, "vender"));
+    _compare(path, JC_NG_IMAGE, 1, 1, 1);
+
+    /* 黒板画像を含む SVG ファイルの原本画像、黒板画像を改ざんした画像に置き換える */
+    TEST_CHECK_EQUAL(0, writeTestSvg(sourcePath, tamperedPath, NULL, "vender"));
+    testPath(path, "original_ng.svg");
+    TEST_CHECK_EQUAL(0, writeValueReplacedTestFile(path, pairText, IMAGE_DATA_START, 0, sourcePath));
+    _compare(path, JC_SVG_ERROR_NG_ORG_IMAGE, 1, 1, 1);
+
+    TEST_CHECK_EQUAL(0, writeTestSvg(sourcePath, tamperedChalkboardPath, NULL, "vender"));
+    testPath(path, "chalkboard_ng.svg");
+    TEST_CHECK_EQUAL(0, writeValueReplacedTestFile(path, pairText, IMAGE_DATA_START, 1, sourcePath));
+    _compare(path, JC_SVG_ERROR_NG_CB_IMAGE, 1, 1, 1);
+
+    /* 他の組み合わせのハッシュコード */
+    testPath(path, "combination_ng.svg");
+    TEST_CHECK_EQUAL(0, writeValueReplacedTestFile(path, pairText, HASH_CODE_START, 0, otherPairPath));
+    _compare(path, JC_SVG_RESULT_NG_COMBINATION, 1, 1, 1);
+
+    /* メタデータ、XML の破損 */
+    testPath(path, "no_vender.svg");
+    TEST_CHECK_EQUAL(0, writeReplacedTestFile(path, singleText, "<dcpm:vender>vender</dcpm:vender>", ""));
+    _compare(path, JC_SVG_ERROR_METADATA_BROKEN_STRUCTURE, 1, 1, 1);
+
+    testPath(path, "broken.svg");
+    TEST_CHECK_EQUAL(0, writeReplacedTestFile(path, singleText, "</rdf:RDF>", "</rdf:rdf>"));
+    _compare(path, JC_SVG_ERROR_OTHERS, 1, 0, 0);
+
+    /*
+     コメント内のデータ URL はどの要素のものか判別できず逐次処理できないため、画像全体をデコードして検証し直す
+     （高速解析でも Expat と同じくデータ URL を取り除いてから解析するため、検証し直す際にも高速解析で解析する）
+     */
+    testPath(path, "comment.svg");
+    TEST_CHECK_EQUAL(0, writeReplacedTestFile(path, pairText, "<g ", "<!-- xlink:href=\"data:image/jpeg;base64,AAAA\" --><g "));
+    _compare(path, JC_SVG_RESULT_OK, 0, 0, 2);
+
+    /* 高速解析で扱わない DOCTYPE 宣言もある場合は、どちらでも逐次処理できない */
+    testPath(path, "doctype.svg");
+    TEST_CHECK_EQUAL(0, writeReplacedTestFile(path, pairText, "<svg", "<!DOCTYPE svg><!-- xlink:href=\"data:image/jpeg;base64,AAAA\" --><svg"));
+    _compare(path, JC_SVG_RESULT_OK, 0, 0, 0);
+
+    free(pairText);
+    free(singleText);
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
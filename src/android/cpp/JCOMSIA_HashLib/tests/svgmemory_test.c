@@ -0,0 +1,156 @@
+﻿/*!
+@file svgmemory_test.c
+@brief 画像を逐次処理する SVG ファイルの検証で、確保するメモリの最大量がファイルサイズによらないことを検査するテスト
+@details JCOMSIA_SetAllocator に指定した関数で確保中のバイト数を数え、大きな画像を埋め込んだ SVG ファイルを検証した際の最大値を確認する。
+高速解析、Expat のどちらで解析する場合も上限を超えないこと、画像全体をデコードする場合はファイルサイズ以上となることを確認する。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "svg.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define SCAN_LENGTH (8 * 1024 * 1024)           /*!< @brief テスト用画像の画像データのバイト数 */
+#define MAX_STREAMING_PEAK (2 * 1024 * 1024)    /*!< @brief 画像を逐次処理する場合に許容する確保中のバイト数の最大値 */
+#define BLOCK_HEADER_SIZE (16)                  /*!< @brief 確保した領域の前に置くバイト数の記録領域（ malloc の境界に合わせる） */
+/* @} */
+
+/*!
+@struct PeakCounter
+@brief JCOMSIA_SetAllocator に指定した関数で確保中のバイト数
+@details 画像の組を並行して検証する場合があるため、アトミックに更新する。
+*/
+typedef struct
+{
+    size_t _current;    /*!< @brief 確保中のバイト数 */
+    size_t _peak;       /*!< @brief _current の最大値 */
+} PeakCounter;
+
+/*!
+@brief 確保中のバイト数を数えてメモリを確保する。
+@param size 確保するバイト数
+@param context PeakCounter
+@return 確保した領域
+*/
+static void *_peakAlloc(size_t size, void *context)
+{
+    PeakCounter *counter = (PeakCounter *)context;
+    unsigned char *block = malloc(BLOCK_HEADER_SIZE + size);
+    size_t current;
+    size_t peak;
+
+    if(block == NULL) return NULL;
+
+    *(size_t *)block = size;
+
+    current = __atomic_add_fetch(&counter->_current, size, __ATOMIC_RELAXED);
+    peak = __atomic_load_n(&counter->_peak, __ATOMIC_RELAXED);
+    while(peak < current &&
+            !__atomic_compare_exchange_n(&counter->_peak, &peak, current, JACIC_BOOL_FALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+        /* 他のスレッドが更新した値と比べ直す */
+    }
+
+    return block + BLOCK_HEADER_SIZE;
+}
+
+/*!
+@brief 確保中のバイト数を数えてメモリを解放する。
+@param ptr 解放する領域
+@param context PeakCounter
+*/
+static void _peakFree(void *ptr, void *context)
+{
+    unsigned char *block = (unsigned char *)ptr - BLOCK_HEADER_SIZE;
+
+    __atomic_sub_fetch(&((PeakCounter *)context)->_current, *(size_t *)block, __ATOMIC_RELAXED);
+
+    free(block);
+}
+
+/*!
+@brief SVG ファイルを検証し、確保中のバイト数の最大値を返す。
+@param [in] path SVG ファイル
+@param [in, out] counter JCOMSIA_SetAllocator に指定したカウンタ
+@param [out] statistics 検証中に SVG ファイルを解析した回数
+@return 確保中のバイト数の最大値
+*/
+static size_t _checkPeak(const char *path, PeakCounter *counter, SVGParseStatistics *statistics)
+{
+    __atomic_store_n(&counter->_peak, __atomic_load_n(&counter->_current, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    resetSVGParseStatistics();
+
+    TEST_CHECK_EQUAL(JC_SVG_RESULT_OK, JCOMSIA_SVG_CheckHashValue(path));
+
+    getSVGParseStatistics(statistics);
+
+    return __atomic_load_n(&counter->_peak, __ATOMIC_RELAXED);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char originalPath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    char svgPath[TEST_PATH_LENGTH];
+    unsigned char *svg;
+    size_t svgLength = 0;
+    size_t peak;
+    PeakCounter counter = {0, 0};
+    SVGParseStatistics statistics;
+
+    if(initTestDirectory("svgmemory") != 0) return 1;
+
+    testPath(originalPath, "original.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+    testPath(svgPath, "large.svg");
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(originalPath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH / 4, 2U));
+    TEST_CHECK_EQUAL(0, writeTestSvg(svgPath, originalPath, chalkboardPath, "vender"));
+
+    svg = readTestFile(svgPath, &svgLength);
+    TEST_CHECK(svg != NULL);
+    free(svg);
+
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(_peakAlloc, _peakFree, &counter));
+
+    /* 高速解析で画像を逐次処理する */
+    peak = _checkPeak(svgPath, &counter, &statistics);
+    printf("fast scan: peak %lu bytes for %lu bytes of SVG\n", (unsigned long)peak, (unsigned long)svgLength);
+    TEST_CHECK_EQUAL(1, statistics._scanCount);
+    TEST_CHECK_EQUAL(0, statistics._parseCount);
+    TEST_CHECK(peak <= MAX_STREAMING_PEAK);
+
+    /* Expat で画像を逐次処理する */
+    setSVGFastScan(JACIC_BOOL_FALSE);
+    peak = _checkPeak(svgPath, &counter, &statistics);
+    printf("expat: peak %lu bytes for %lu bytes of SVG\n", (unsigned long)peak, (unsigned long)svgLength);
+    TEST_CHECK_EQUAL(0, statistics._scanCount);
+    TEST_CHECK_EQUAL(0, statistics._parseCount);
+    TEST_CHECK(peak <= MAX_STREAMING_PEAK);
+    setSVGFastScan(JACIC_BOOL_TRUE);
+
+    /* 画像全体をデコードする場合は、画像を保持するためファイルサイズに比例する */
+    setSVGImageStreaming(JACIC_BOOL_FALSE);
+    peak = _checkPeak(svgPath, &counter, &statistics);
+    printf("full parse: peak %lu bytes for %lu bytes of SVG\n", (unsigned long)peak, (unsigned long)svgLength);
+    TEST_CHECK_EQUAL(1, statistics._parseCount);
+    TEST_CHECK(SCAN_LENGTH < peak);
+    setSVGImageStreaming(JACIC_BOOL_TRUE);
+
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SetAllocator(NULL, NULL, NULL));
+    TEST_CHECK_EQUAL(0, counter._current);
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
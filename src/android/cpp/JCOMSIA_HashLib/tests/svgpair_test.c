@@ -0,0 +1,156 @@
+﻿/*!
+@file svgpair_test.c
+@brief SVG ファイルの原本画像と黒板画像を並行して検証する場合の結果と、fork した子プロセスでの検証を検査するテスト
+@details 呼び出し元のスレッドから検証する場合（黒板画像を常駐のワーカースレッドで検証する）と、
+一括処理のスレッドから検証する場合（ 2 枚を順に検証する）で、両方の画像が改ざんされている場合を含めて同じ結果となることを確認する。
+また、ワーカースレッドを作成した後に fork した子プロセスでも、検証が終了することを確認する。
+*/
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define SCAN_LENGTH (24 * 1024)                     /*!< @brief テスト用画像の画像データのバイト数 */
+#define IMAGE_DATA_START "data:image/jpeg;base64,"  /*!< @brief 画像データの直前の文字列 */
+#define CHILD_TIMEOUT (30)                          /*!< @brief 子プロセスの検証を待つ時間（秒） */
+/* @} */
+
+/*!
+@brief 呼び出し元のスレッドから検証した結果と、一括処理のスレッドから検証した結果を比較する。
+@details 一括処理は 2 スレッドで行うため、各スレッドは画像 2 枚を順に検証する。
+@param [in] path SVG ファイル
+@param expected 期待する検証結果
+*/
+static void _compare(const char *path, int expected)
+{
+    const char *paths[2];
+    int results[2] = {0, 0};
+    JCOMSIA_BatchOptions options;
+    int result;
+
+    paths[0] = path;
+    paths[1] = path;
+    options.threadCount = 2;
+
+    result = JCOMSIA_SVG_CheckHashValue(path);
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SVG_CheckHashValueBatch(paths, 2, results, &options));
+
+    if(result != expected || results[0] != expected || results[1] != expected)
+    {
+        fprintf(stderr, "%s: expected %d, pair worker %d, inline %d %d\n", path, expected, result, results[0], results[1]);
+        ++testFailures;
+    }
+}
+
+/*!
+@brief fork した子プロセスで SVG ファイルを検証し、結果を確認する。
+@details 子プロセスが CHILD_TIMEOUT 秒以内に終了しない場合は SIGALRM で終了させ、失敗とする。
+@param [in] path SVG ファイル
+@param expected 期待する検証結果
+*/
+static void _checkInChild(const char *path, int expected)
+{
+    pid_t pid;
+    int status = 0;
+
+    fflush(NULL);
+
+    pid = fork();
+    TEST_CHECK(0 <= pid);
+    if(pid < 0) return;
+
+    if(pid == 0)
+    {
+        alarm(CHILD_TIMEOUT);
+        _exit(JCOMSIA_SVG_CheckHashValue(path) == expected && JCOMSIA_SVG_CheckHashValue(path) == expected ? 0 : 1);
+    }
+
+    TEST_CHECK_EQUAL(pid, waitpid(pid, &status, 0));
+    TEST_CHECK(WIFEXITED(status));
+    if(WIFSIGNALED(status))
+    {
+        fprintf(stderr, "child terminated by signal %d\n", WTERMSIG(status));
+    }
+    TEST_CHECK_EQUAL(0, WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char originalPath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    char tamperedPath[TEST_PATH_LENGTH];
+    char tamperedChalkboardPath[TEST_PATH_LENGTH];
+    char pairPath[TEST_PATH_LENGTH];
+    char sourcePath[TEST_PATH_LENGTH];
+    char originalNgPath[TEST_PATH_LENGTH];
+    char chalkboardNgPath[TEST_PATH_LENGTH];
+    char bothNgPath[TEST_PATH_LENGTH];
+    char *pairText;
+    char *originalNgText;
+    size_t length = 0;
+
+    if(initTestDirectory("svgpair") != 0) return 1;
+
+    testPath(originalPath, "original.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+    testPath(tamperedPath, "tampered.jpg");
+    testPath(tamperedChalkboardPath, "tampered_chalkboard.jpg");
+    testPath(pairPath, "pair.svg");
+    testPath(sourcePath, "source.svg");
+    testPath(originalNgPath, "original_ng.svg");
+    testPath(chalkboardNgPath, "chalkboard_ng.svg");
+    testPath(bothNgPath, "both_ng.svg");
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(originalPath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH / 2, 2U));
+    TEST_CHECK_EQUAL(0, writeTamperedTestJpeg(originalPath, tamperedPath));
+    TEST_CHECK_EQUAL(0, writeTamperedTestJpeg(chalkboardPath, tamperedChalkboardPath));
+    TEST_CHECK_EQUAL(0, writeTestSvg(pairPath, originalPath, chalkboardPath, "vender"));
+
+    pairText = (char *)readTestFile(pairPath, &length);
+    TEST_CHECK(pairText != NULL);
+    if(pairText == NULL) return 1;
+
+    /* 原本画像、黒板画像、両方を改ざんした画像に置き換える */
+    TEST_CHECK_EQUAL(0, writeTestSvg(sourcePath, tamperedPath, NULL, "vender"));
+    TEST_CHECK_EQUAL(0, writeValueReplacedTestFile(originalNgPath, pairText, IMAGE_DATA_START, 0, sourcePath));
+    TEST_CHECK_EQUAL(0, writeTestSvg(sourcePath, tamperedChalkboardPath, NULL, "vender"));
+    TEST_CHECK_EQUAL(0, writeValueReplacedTestFile(chalkboardNgPath, pairText, IMAGE_DATA_START, 1, sourcePath));
+
+    originalNgText = (char *)readTestFile(originalNgPath, &length);
+    TEST_CHECK(originalNgText != NULL);
+    if(originalNgText == NULL) return 1;
+    TEST_CHECK_EQUAL(0, writeValueReplacedTestFile(bothNgPath, originalNgText, IMAGE_DATA_START, 1, sourcePath));
+
+    /* 並行して検証しても、2 枚を順に検証した場合と同じく原本画像のエラーを優先する */
+    _compare(pairPath, JC_SVG_RESULT_OK);
+    _compare(originalNgPath, JC_SVG_ERROR_NG_ORG_IMAGE);
+    _compare(chalkboardNgPath, JC_SVG_ERROR_NG_CB_IMAGE);
+    _compare(bothNgPath, JC_SVG_ERROR_NG_ORG_IMAGE);
+
+    /* ワーカースレッドを作成した後に fork した子プロセスでも検証できる */
+    _checkInChild(pairPath, JC_SVG_RESULT_OK);
+    _checkInChild(bothNgPath, JC_SVG_ERROR_NG_ORG_IMAGE);
+
+    /* 親プロセスのワーカースレッドは引き続き使用できる */
+    _compare(chalkboardNgPath, JC_SVG_ERROR_NG_CB_IMAGE);
+
+    free(pairText);
+    free(originalNgText);
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+﻿/*!
+@file svgwriter_test.c
+@brief JCOMSIA_SVG_Write で作成した SVG ファイルが JCOMSIA_SVG_CheckHashValue の検証を通ることを検査するテスト
+@details 黒板画像と注釈の有無を変えて作成した SVG ファイルを検証し、dcpm 接頭辞には呼び出し元が指定した名前空間が出力されることも確認する。
+名前空間を指定しない場合や、メタデータが正しい UTF-8 でない場合は、引数不正として SVG ファイルを作成しないこと。
+マルチバイト文字を含むメタデータは、作成した SVG ファイルを解析して同じ値を取得できること。
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define SCAN_LENGTH (24 * 1024) /*!< @brief テスト用画像の画像データのバイト数 */
+#define ANNOTATION "<rect x=\"0\" y=\"0\" width=\"10\" height=\"10\"/>" /*!< @brief 注釈レイヤの内容 */
+/* @} */
+
+/*!
+@brief JCOMSIA_SVG_Write で SVG ファイルを作成し、検証結果と出力内容を確認する。
+@param [in] path 作成する SVG ファイル
+@param [in] originalPath 原本画像
+@param [in] chalkboardPath 黒板画像。NULL の場合は黒板画像レイヤを出力しない
+@param [in] annotation 注釈レイヤの内容。NULL の場合は注釈レイヤを出力しない
+@param [in] vender 出力するベンダー名
+@param [in] dcpmNamespace dcpm 接頭辞に割り当てる名前空間
+@param [in] expectedNamespace 出力される名前空間の属性（エスケープ後）
+*/
+static void _writeAndCheck(const char *path, const char *originalPath, const char *chalkboardPath,
+                           const char *annotation, const char *vender, const char *dcpmNamespace, const char *expectedNamespace)
+{
+    JCOMSIA_SVGMeta meta;
+    JCOMSIA_SVGMeta probed;
+    char *text;
+    size_t length = 0;
+
+    memset(&meta, 0, sizeof(meta));
+    meta.vender = (char *)vender;
+    meta.software = "jcomsia-test";
+    meta.dcpmNamespace = dcpmNamespace;
+
+    remove(path);
+    TEST_CHECK_EQUAL(JW_SVG_CREATE_SUCCESS, JCOMSIA_SVG_Write(originalPath, chalkboardPath, annotation, &meta, path));
+    TEST_CHECK_EQUAL(JC_SVG_RESULT_OK, JCOMSIA_SVG_CheckHashValue(path));
+
+    text = (char *)readTestFile(path, &length);
+    TEST_CHECK(text != NULL);
+    if(text != NULL)
+    {
+        TEST_CHECK(strstr(text, expectedNamespace) != NULL);
+        TEST_CHECK((annotation != NULL) == (strstr(text, ANNOTATION) != NULL));
+        free(text);
+    }
+
+    /* 作成したメタデータを取得できる */
+    memset(&probed, 0, sizeof(probed));
+    TEST_CHECK_EQUAL(JW_SUCCESS, JCOMSIA_SVG_ProbeMetadata(path, &probed));
+    TEST_CHECK(probed.vender != NULL && strcmp(probed.vender, vender) == 0);
+    TEST_CHECK(probed.metaVersion != NULL && strcmp(probed.metaVersion, "3.1") == 0);
+    TEST_CHECK(probed.stdVersion != NULL && strcmp(probed.stdVersion, "1.5") == 0);
+    TEST_CHECK_EQUAL(chalkboardPath != NULL, probed.hashCode != NULL);
+    TEST_CHECK_EQUAL(chalkboardPath != NULL, probed.hasChalkboard != 0);
+    TEST_CHECK(probed.dcpmNamespace == NULL);
+    JCOMSIA_SVG_FreeMetadata(&probed);
+}
+
+/*!
+@brief 書き出せないメタデータを指定した場合に SVG ファイルを作成しないことを確認する。
+@param [in] path 作成を試みる SVG ファイル
+@param [in] originalPath 原本画像
+@param [in] vender 出力するベンダー名
+@param [in] dcpmNamespace dcpm 接頭辞に割り当てる名前空間
+*/
+static void _checkRejected(const char *path, const char *originalPath, const char *vender, const char *dcpmNamespace)
+{
+    JCOMSIA_SVGMeta meta;
+    FILE *fp;
+
+    memset(&meta, 0, sizeof(meta));
+    meta.vender = (char *)vender;
+    meta.software = "jcomsia-test";
+    meta.dcpmNamespace = dcpmNamespace;
+
+    remove(path);
+    TEST_CHECK_EQUAL(JW_SVG_ERROR_INCORRECT_PARAMETER, JCOMSIA_SVG_Write(originalPath, NULL, NULL, &meta, path));
+
+    fp = fopen(path, "rb");
+    TEST_CHECK(fp == NULL);
+    if(fp != NULL) fclose(fp);
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    char originalPath[TEST_PATH_LENGTH];
+    char chalkboardPath[TEST_PATH_LENGTH];
+    char path[TEST_PATH_LENGTH];
+
+    if(initTestDirectory("svgwriter") != 0) return 1;
+
+    testPath(originalPath, "original.jpg");
+    testPath(chalkboardPath, "chalkboard.jpg");
+    testPath(path, "written.svg");
+
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(originalPath, 640, 480, TEST_DATE_TIME, SCAN_LENGTH, 1U));
+    TEST_CHECK_EQUAL(0, writeHashedTestJpeg(chalkboardPath, 320, 240, TEST_DATE_TIME, SCAN_LENGTH, 2U));
+
+    /* 黒板画像と注釈の有無 */
+    _writeAndCheck(path, originalPath, chalkboardPath, ANNOTATION, "vender", TEST_DCPM_NAMESPACE, "xmlns:dcpm=\"" TEST_DCPM_NAMESPACE "\"");
+    _writeAndCheck(path, originalPath, chalkboardPath, NULL, "vender", TEST_DCPM_NAMESPACE, "xmlns:dcpm=\"" TEST_DCPM_NAMESPACE "\"");
+    _writeAndCheck(path, originalPath, NULL, ANNOTATION, "vender", TEST_DCPM_NAMESPACE, "xmlns:dcpm=\"" TEST_DCPM_NAMESPACE "\"");
+    _writeAndCheck(path, originalPath, NULL, NULL, "vender", TEST_DCPM_NAMESPACE, "xmlns:dcpm=\"" TEST_DCPM_NAMESPACE "\"");
+
+    /* 名前空間は属性値としてエスケープして出力する */
+    _writeAndCheck(path, originalPath, chalkboardPath, NULL, "vender", TEST_DCPM_NAMESPACE "?a=\"1\"&b", "xmlns:dcpm=\"" TEST_DCPM_NAMESPACE "?a=&quot;1&quot;&amp;b\"");
+
+    /* 2 ～ 4 バイトの UTF-8 の文字は、解析して同じ値を取得できる */
+    _writeAndCheck(path, originalPath, chalkboardPath, NULL, "v\xC3\xA9nder \xE3\x83\x99\xE3\x83\xB3\xE3\x83\x80 \xF0\x9F\x93\xB7",
+                   TEST_DCPM_NAMESPACE, "xmlns:dcpm=\"" TEST_DCPM_NAMESPACE "\"");
+
+    /* 名前空間の既定値は無い */
+    _checkRejected(path, originalPath, "vender", NULL);
+    _checkRejected(path, originalPath, "vender", "");
+
+    /* 正しい UTF-8 でないメタデータは書き出さない */
+    _checkRejected(path, originalPath, "vender\x80", TEST_DCPM_NAMESPACE);          /* 先頭バイトでない */
+    _checkRejected(path, originalPath, "vender\xC0\xAF", TEST_DCPM_NAMESPACE);      /* 冗長な表現 */
+    _checkRejected(path, originalPath, "vender\xE3\x83", TEST_DCPM_NAMESPACE);      /* 途中で終わる */
+    _checkRejected(path, originalPath, "vender\xED\xA0\x80", TEST_DCPM_NAMESPACE);  /* サロゲート */
+    _checkRejected(path, originalPath, "vender\xEF\xBF\xBE", TEST_DCPM_NAMESPACE);  /* U+FFFE */
+    _checkRejected(path, originalPath, "vender\xF4\x90\x80\x80", TEST_DCPM_NAMESPACE); /* U+10FFFF より大きい */
+    _checkRejected(path, originalPath, "vender", TEST_DCPM_NAMESPACE "\xFF");
+
+    cleanupTestDirectory();
+
+    return testFailures == 0 ? 0 : 1;
+}
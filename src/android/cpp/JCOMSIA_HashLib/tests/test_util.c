@@ -0,0 +1,576 @@
+﻿/*!
+@file test_util.c
+@brief テストで共通に使用する、テスト用 JPEG 画像と一時ファイルの作成処理
+*/
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "base64.h"
+#include "common.h"
+#include "test_util.h"
+#include "writeHashLib.h"
+
+/*! 失敗した検査の数 */
+int testFailures = 0;
+
+/*! テスト用の一時ディレクトリ（未作成の場合は空文字列） */
+static char testDirectory[TEST_PATH_LENGTH] = "";
+
+/*!
+@brief テスト用の一時ディレクトリを作成する。
+@param [in] name ディレクトリ名に含める名前
+@retval 0 成功
+@retval -1 作成できなかった場合
+*/
+int initTestDirectory(const char *name)
+{
+    const char *base = getenv("TMPDIR");
+
+    if(base == NULL || base[0] == '\0')
+    {
+        base = "/tmp";
+    }
+
+    snprintf(testDirectory, sizeof(testDirectory), "%s/jcomsia_%s_XXXXXX", base, name);
+    if(mkdtemp(testDirectory) == NULL)
+    {
+        fprintf(stderr, "cannot create %s\n", testDirectory);
+        testDirectory[0] = '\0';
+        return -1;
+    }
+
+    return 0;
+}
+
+/*!
+@brief 一時ディレクトリとその中のファイルを削除する。
+*/
+void cleanupTestDirectory(void)
+{
+    DIR *directory;
+    struct dirent *entry;
+    char path[TEST_PATH_LENGTH];
+
+    if(testDirectory[0] == '\0') return;
+
+    if((directory = opendir(testDirectory)) != NULL)
+    {
+        while((entry = readdir(directory)) != NULL)
+        {
+            if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+            unlink(testPath(path, entry->d_name));
+        }
+        closedir(directory);
+    }
+
+    rmdir(testDirectory);
+    testDirectory[0] = '\0';
+}
+
+/*!
+@brief 一時ディレクトリ内のファイルパスを作成する。
+@param [out] dst パスを受けとる配列（TEST_PATH_LENGTH バイト）
+@param [in] fileName ファイル名
+@return dst
+*/
+char *testPath(char *dst, const char *fileName)
+{
+    int length = snprintf(dst, TEST_PATH_LENGTH, "%s/%s", testDirectory, fileName);
+
+    if(length < 0 || TEST_PATH_LENGTH <= (size_t)length)
+    {
+        /* 収まらないパスは使用しない */
+        fprintf(stderr, "path too long: %s\n", fileName);
+        dst[0] = '\0';
+    }
+
+    return dst;
+}
+
+/*!
+@brief 16 ビット値をビッグエンディアンで書き込む。
+@param [out] dst 書き込み先
+@param value 書き込む値
+@return 書き込んだ直後の位置
+*/
+static unsigned char *_putUInt16(unsigned char *dst, unsigned int value)
+{
+    dst[0] = (unsigned char)((value >> 8) & 0xFF);
+    dst[1] = (unsigned char)(value & 0xFF);
+
+    return dst + 2;
+}
+
+/*!
+@brief 32 ビット値をビッグエンディアンで書き込む。
+@param [out] dst 書き込み先
+@param value 書き込む値
+@return 書き込んだ直後の位置
+*/
+static unsigned char *_putUInt32(unsigned char *dst, unsigned long value)
+{
+    dst = _putUInt16(dst, (unsigned int)((value >> 16) & 0xFFFF));
+
+    return _putUInt16(dst, (unsigned int)(value & 0xFFFF));
+}
+
+/*!
+@brief IFD のエントリを書き込む。
+@param [out] dst 書き込み先
+@param tag タグ番号
+@param type 型
+@param count 値の個数
+@return 書き込んだ直後の位置（値またはオフセットの 4 バイトは呼び出し元で書き込む）
+*/
+static unsigned char *_putIfdEntry(unsigned char *dst, unsigned int tag, unsigned int type, unsigned long count)
+{
+    dst = _putUInt16(dst, tag);
+    dst = _putUInt16(dst, type);
+
+    return _putUInt32(dst, count);
+}
+
+/*!
+@brief Exif の撮影日時と SOF0 を持つテスト用の JPEG 画像を作成する。
+@details 画像データはデコードできないが、ハッシュ値の計算と埋め込みに必要なセグメントは全て含む。
+@param width SOF0 に記録する幅
+@param height SOF0 に記録する高さ
+@param dateTime 撮影日時（"YYYY:MM:DD hh:mm:ss"）
+@param scanLength 画像データ（スタッフィング前）のバイト数
+@param seed 画像データを作る疑似乱数の種
+@param [out] length 作成した画像のバイト数
+@return 作成した画像（free で解放する）。メモリが確保できなかった場合は NULL
+*/
+unsigned char *createTestJpeg(unsigned short width, unsigned short height, const char *dateTime, size_t scanLength, unsigned int seed, size_t *length)
+{
+    /* TIFF ヘッダ (8) + IFD0 (2 + 12 + 4) + Exif IFD (2 + 12 * 2 + 4) の後に撮影日時を置く */
+    const unsigned long exifIfdOffset = 8 + 2 + 12 + 4;
+    const unsigned long dateOffset = exifIfdOffset + 2 + 12 * 2 + 4;
+    size_t dateLength = strlen(dateTime) + 1;
+    size_t exifLength = 6 + dateOffset + dateLength;
+    unsigned char *image;
+    unsigned char *p;
+    size_t i;
+    unsigned char value;
+
+    /* 画像データは全て 0xFF の場合にスタッフィングで 2 倍になる */
+    if((image = (unsigned char *)malloc(2 + (4 + exifLength) + (4 + 65) + (4 + 9) + (4 + 6) + scanLength * 2 + 2)) == NULL)
+    {
+        return NULL;
+    }
+
+    p = image;
+
+    /* SOI */
+    *p++ = 0xFF;
+    *p++ = 0xD8;
+
+    /* APP1 (Exif) */
+    *p++ = 0xFF;
+    *p++ = 0xE1;
+    p = _putUInt16(p, (unsigned int)(exifLength + 2));
+    memcpy(p, "Exif\0\0", 6);
+    p += 6;
+    memcpy(p, "MM", 2);
+    p = _putUInt16(p + 2, 42);
+    p = _putUInt32(p, 8);
+
+    /* IFD0: ExifIFDPointer */
+    p = _putUInt16(p, 1);
+    p = _putIfdEntry(p, 0x8769, 4, 1);
+    p = _putUInt32(p, exifIfdOffset);
+    p = _putUInt32(p, 0);
+
+    /* Exif IFD: DateTimeOriginal, SubSecTimeOriginal */
+    p = _putUInt16(p, 2);
+    p = _putIfdEntry(p, 0x9003, 2, (unsigned long)dateLength);
+    p = _putUInt32(p, dateOffset);
+    p = _putIfdEntry(p, 0x9291, 2, 3);
+    memcpy(p, "12\0\0", 4);
+    p += 4;
+    p = _putUInt32(p, 0);
+    memcpy(p, dateTime, dateLength);
+    p += dateLength;
+
+    /* DQT */
+    *p++ = 0xFF;
+    *p++ = 0xDB;
+    p = _putUInt16(p, 67);
+    *p++ = 0x00;
+    for(i = 1; i <= 64; ++i)
+    {
+        *p++ = (unsigned char)i;
+    }
+
+    /* SOF0: 8 ビット、1 コンポーネント */
+    *p++ = 0xFF;
+    *p++ = 0xC0;
+    p = _putUInt16(p, 11);
+    *p++ = 8;
+    p = _putUInt16(p, height);
+    p = _putUInt16(p, width);
+    *p++ = 1;
+    *p++ = 1;
+    *p++ = 0x11;
+    *p++ = 0;
+
+    /* SOS */
+    *p++ = 0xFF;
+    *p++ = 0xDA;
+    p = _putUInt16(p, 8);
+    *p++ = 1;
+    *p++ = 1;
+    *p++ = 0;
+    *p++ = 0;
+    *p++ = 63;
+    *p++ = 0;
+
+    /* 画像データ（0xFF の後には 0x00 を挿入する） */
+    for(i = 0; i < scanLength; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        value = (unsigned char)(seed >> 16);
+        *p++ = value;
+        if(value == 0xFF)
+        {
+            *p++ = 0x00;
+        }
+    }
+
+    /* EOI */
+    *p++ = 0xFF;
+    *p++ = 0xD9;
+
+    *length = (size_t)(p - image);
+
+    return image;
+}
+
+/*!
+@brief createTestJpeg で作成した画像に改ざんチェック値を埋め込み、ファイルに書き込む。
+@param [in] path 書き込み先
+@param width SOF0 に記録する幅
+@param height SOF0 に記録する高さ
+@param dateTime 撮影日時
+@param scanLength 画像データのバイト数
+@param seed 画像データを作る疑似乱数の種
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeHashedTestJpeg(const char *path, unsigned short width, unsigned short height, const char *dateTime, size_t scanLength, unsigned int seed)
+{
+    unsigned char *source;
+    unsigned char *hashed = NULL;
+    size_t sourceLength;
+    size_t hashedLength = 0;
+    int ret = -1;
+
+    if((source = createTestJpeg(width, height, dateTime, scanLength, seed, &sourceLength)) == NULL)
+    {
+        return -1;
+    }
+
+    if(JCOMSIA_WriteHashValueMem(source, sourceLength, &hashed, &hashedLength) == JW_SUCCESS)
+    {
+        ret = writeTestFile(path, hashed, hashedLength);
+    }
+
+    JCOMSIA_FreeImageData(&hashed);
+    free(source);
+
+    return ret;
+}
+
+/*!
+@brief 画像ファイルを Base64 エンコードして、SVG の画像レイヤとして書き込む。
+@param [in] fp 書き込み先
+@param [in] groupId レイヤのグループ ID
+@param [in] imagePath 画像ファイルのパス
+@retval 0 成功
+@retval -1 失敗
+*/
+static int _writeTestSvgLayer(FILE *fp, const char *groupId, const char *imagePath)
+{
+    unsigned char *image;
+    char *encoded = NULL;
+    size_t imageLength = 0;
+    int ret = -1;
+
+    if((image = readTestFile(imagePath, &imageLength)) == NULL)
+    {
+        return -1;
+    }
+
+    if(base64Encode(image, imageLength, &encoded) != 0 && encoded != NULL)
+    {
+        fprintf(fp, "<g id=\"%s\"><image x=\"0\" y=\"0\" width=\"640\" height=\"480\" xlink:href=\"data:image/jpeg;base64,%s\"/></g>\n",
+                groupId, encoded);
+        ret = 0;
+    }
+
+    free(encoded);
+    free(image);
+
+    return ret;
+}
+
+/*!
+@brief 画像ファイルを埋め込んだテスト用の SVG ファイルを書き込む。
+@details JCOMSIA_SVG_Write を使用せずに、JACIC 写真の SVG と同じ構成の文字列を直接組み立てる。
+黒板画像を指定した場合は、JCOMSIA_SVG_CalculateHashValue で計算したハッシュコードをメタデータに含める。
+@param [in] path 書き込み先
+@param [in] originalPath 原本画像のファイルパス
+@param [in] chalkboardPath 黒板画像のファイルパス。黒板画像がない場合は NULL
+@param [in] vender メタデータのベンダー名
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeTestSvg(const char *path, const char *originalPath, const char *chalkboardPath, const char *vender)
+{
+    FILE *fp;
+    unsigned char *hashCode = NULL;
+    int ret = 0;
+
+    if(chalkboardPath != NULL && JCOMSIA_SVG_CalculateHashValue(originalPath, chalkboardPath, &hashCode) != JW_HASHER_CREATE_SUCCESS)
+    {
+        return -1;
+    }
+
+    if((fp = fopen(path, "wb")) == NULL)
+    {
+        JCOMSIA_SVG_FreeHashValue(&hashCode);
+        return -1;
+    }
+
+    fprintf(fp,
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"640\" height=\"480\">\n"
+            "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\">\n"
+            "<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">\n"
+            "<rdf:Description rdf:about=\"\" xmlns:dcpm=\"%s\">\n"
+            "<dcpm:vender>%s</dcpm:vender>\n"
+            "<dcpm:software>jcomsia-test</dcpm:software>\n"
+            "<dcpm:metaVersion>3.1</dcpm:metaVersion>\n"
+            "<dcpm:stdVersion>1.5</dcpm:stdVersion>\n",
+            TEST_DCPM_NAMESPACE, vender);
+
+    if(hashCode != NULL)
+    {
+        fprintf(fp, "<dcpm:hashCode>%.*s</dcpm:hashCode>\n", (int)BYTE_SIZE_HASH_LENGTH, (const char *)hashCode);
+    }
+
+    fprintf(fp, "</rdf:Description>\n</rdf:RDF>\n</x:xmpmeta>\n");
+
+    if(_writeTestSvgLayer(fp, "dcp_org_img", originalPath) != 0)
+    {
+        ret = -1;
+    }
+
+    if(chalkboardPath != NULL && _writeTestSvgLayer(fp, "dcp_chalkboard_img", chalkboardPath) != 0)
+    {
+        ret = -1;
+    }
+
+    fprintf(fp, "</svg>\n");
+
+    if(fclose(fp) != 0)
+    {
+        ret = -1;
+    }
+
+    JCOMSIA_SVG_FreeHashValue(&hashCode);
+
+    return ret;
+}
+
+/*!
+@brief バイト配列をファイルに書き込む。
+@param [in] path 書き込み先
+@param [in] data 書き込むデータ
+@param length data の長さ
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeTestFile(const char *path, const unsigned char *data, size_t length)
+{
+    FILE *fp;
+    int ret = 0;
+
+    if((fp = fopen(path, "wb")) == NULL)
+    {
+        return -1;
+    }
+
+    if(fwrite(data, 1, length, fp) != length)
+    {
+        ret = -1;
+    }
+
+    if(fclose(fp) != 0)
+    {
+        ret = -1;
+    }
+
+    return ret;
+}
+
+/*!
+@brief ファイル全体を読み込む。
+@param [in] path 読み込むファイル
+@param [out] length 読み込んだバイト数
+@return 読み込んだデータ（free で解放する）。失敗した場合は NULL
+*/
+unsigned char *readTestFile(const char *path, size_t *length)
+{
+    FILE *fp;
+    unsigned char *data = NULL;
+    long size;
+
+    if((fp = fopen(path, "rb")) == NULL)
+    {
+        return NULL;
+    }
+
+    if(fseek(fp, 0, SEEK_END) == 0 && 0 <= (size = ftell(fp)) && fseek(fp, 0, SEEK_SET) == 0)
+    {
+        if((data = (unsigned char *)malloc((size_t)size + 1)) != NULL &&
+                fread(data, 1, (size_t)size, fp) != (size_t)size)
+        {
+            free(data);
+            data = NULL;
+        }
+        else if(data != NULL)
+        {
+            /* 文字列として扱えるように終端する */
+            data[size] = '\0';
+        }
+        *length = (size_t)size;
+    }
+
+    fclose(fp);
+
+    return data;
+}
+
+/*!
+@brief 画像データの途中の 1 バイトを書き換えたファイルを作成する。
+@param [in] srcPath 読み込むファイル
+@param [in] dstPath 書き込み先
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeTamperedTestJpeg(const char *srcPath, const char *dstPath)
+{
+    unsigned char *data;
+    size_t length = 0;
+    size_t i;
+    int ret;
+
+    if((data = readTestFile(srcPath, &length)) == NULL) return -1;
+
+    for(i = length - 64; data[i] == 0xFF || data[i - 1] == 0xFF || (data[i] ^ 0x01) == 0xFF; --i)
+    {
+        /* マーカーやスタッフィングに関係しないバイトを選ぶ */
+    }
+    data[i] ^= 0x01;
+
+    ret = writeTestFile(dstPath, data, length);
+    free(data);
+
+    return ret;
+}
+
+/*!
+@brief 文字列の最初の一致箇所を置き換えてファイルに書き込む。
+@param [in] path 書き込み先
+@param [in] text もとの文字列
+@param [in] find 置き換える文字列
+@param [in] replace 置き換え後の文字列
+@retval 0 成功
+@retval -1 find が見つからない場合、書き込みに失敗した場合
+*/
+int writeReplacedTestFile(const char *path, const char *text, const char *find, const char *replace)
+{
+    const char *found = strstr(text, find);
+    FILE *fp;
+    int ret = 0;
+
+    if(found == NULL) return -1;
+
+    if((fp = fopen(path, "wb")) == NULL) return -1;
+
+    fwrite(text, 1, (size_t)(found - text), fp);
+    fputs(replace, fp);
+    fputs(found + strlen(find), fp);
+
+    if(ferror(fp)) ret = -1;
+    if(fclose(fp) != 0) ret = -1;
+
+    return ret;
+}
+
+/*!
+@brief 文字列内の値を複製して返す。
+@param [in] text 検索対象の文字列
+@param [in] start 値の直前の文字列
+@param index start の何番目（ 0 から数える）の一致箇所の値を返すか
+@return 値（ start の直後から '<' または '"' の直前まで）の複製。見つからない場合は NULL
+*/
+static char *_copyValue(const char *text, const char *start, int index)
+{
+    const char *found = text;
+    char *value;
+    size_t length;
+
+    for(; index >= 0; --index)
+    {
+        if((found = strstr(found, start)) == NULL) return NULL;
+        found += strlen(start);
+    }
+
+    length = strcspn(found, "<\"");
+    if((value = malloc(length + 1)) == NULL) return NULL;
+
+    memcpy(value, found, length);
+    value[length] = '\0';
+
+    return value;
+}
+
+/*!
+@brief 値を置き換えた SVG ファイルを作成する。
+@param [in] path 書き込み先
+@param [in] text もとの SVG ファイルの内容
+@param [in] start 値の直前の文字列
+@param index start の何番目（ 0 から数える）の一致箇所の値を置き換えるか
+@param [in] sourcePath 置き換え後の値を取り出す SVG ファイル（ start の最初の一致箇所の値を使う）
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeValueReplacedTestFile(const char *path, const char *text, const char *start, int index, const char *sourcePath)
+{
+    char *source;
+    char *find;
+    char *replace;
+    size_t length = 0;
+    int ret = -1;
+
+    if((source = (char *)readTestFile(sourcePath, &length)) == NULL) return -1;
+
+    find = _copyValue(text, start, index);
+    replace = _copyValue(source, start, 0);
+    if(find != NULL && replace != NULL && strlen(find) != 0)
+    {
+        ret = writeReplacedTestFile(path, text, find, replace);
+    }
+
+    free(find);
+    free(replace);
+    free(source);
+
+    return ret;
+}
@@ -0,0 +1,160 @@
+﻿/*!
+@file test_util.h
+@brief テストで共通に使用する検査マクロと、テスト用 JPEG 画像の作成処理のヘッダ
+*/
+#ifndef TEST_UTIL_H_
+#define TEST_UTIL_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define TEST_PATH_LENGTH ((size_t)512)          /*!< @brief テスト用ファイルパスの最大長 */
+#define TEST_DATE_TIME "2020:01:02 03:04:05"    /*!< @brief テスト用画像の既定の撮影日時 */
+#define TEST_DCPM_NAMESPACE "urn:x-jcomsia-test:dcpm"  /*!< @brief テスト用 SVG の dcpm 接頭辞に割り当てる名前空間（テスト専用の値） */
+/* @} */
+
+/*! 失敗した検査の数 */
+extern int testFailures;
+
+/*!
+@brief 条件が偽の場合に、失敗として記録して表示する。
+*/
+#define TEST_CHECK(expression) \
+    do \
+    { \
+        if(!(expression)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expression); \
+            ++testFailures; \
+        } \
+    } while(0)
+
+/*!
+@brief 2 つの整数が等しくない場合に、失敗として記録して値を表示する。
+*/
+#define TEST_CHECK_EQUAL(expected, actual) \
+    do \
+    { \
+        long _expectedValue = (long)(expected); \
+        long _actualValue = (long)(actual); \
+        if(_expectedValue != _actualValue) \
+        { \
+            fprintf(stderr, "%s:%d: %s == %s failed: %ld != %ld\n", __FILE__, __LINE__, #expected, #actual, _expectedValue, _actualValue); \
+            ++testFailures; \
+        } \
+    } while(0)
+
+/*!
+@brief テスト用の一時ディレクトリを作成する。
+@param [in] name ディレクトリ名に含める名前
+@retval 0 成功
+@retval -1 作成できなかった場合
+*/
+int initTestDirectory(const char *name);
+
+/*!
+@brief 一時ディレクトリとその中のファイルを削除する。
+*/
+void cleanupTestDirectory(void);
+
+/*!
+@brief 一時ディレクトリ内のファイルパスを作成する。
+@param [out] dst パスを受けとる配列（TEST_PATH_LENGTH バイト）
+@param [in] fileName ファイル名
+@return dst
+*/
+char *testPath(char *dst, const char *fileName);
+
+/*!
+@brief Exif の撮影日時と SOF0 を持つテスト用の JPEG 画像を作成する。
+@details 画像データはデコードできないが、ハッシュ値の計算と埋め込みに必要なセグメントは全て含む。
+@param width SOF0 に記録する幅
+@param height SOF0 に記録する高さ
+@param dateTime 撮影日時（"YYYY:MM:DD hh:mm:ss"）
+@param scanLength 画像データ（スタッフィング前）のバイト数
+@param seed 画像データを作る疑似乱数の種
+@param [out] length 作成した画像のバイト数
+@return 作成した画像（free で解放する）。メモリが確保できなかった場合は NULL
+*/
+unsigned char *createTestJpeg(unsigned short width, unsigned short height, const char *dateTime, size_t scanLength, unsigned int seed, size_t *length);
+
+/*!
+@brief createTestJpeg で作成した画像に改ざんチェック値を埋め込み、ファイルに書き込む。
+@param [in] path 書き込み先
+@param width SOF0 に記録する幅
+@param height SOF0 に記録する高さ
+@param dateTime 撮影日時
+@param scanLength 画像データのバイト数
+@param seed 画像データを作る疑似乱数の種
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeHashedTestJpeg(const char *path, unsigned short width, unsigned short height, const char *dateTime, size_t scanLength, unsigned int seed);
+
+/*!
+@brief 画像ファイルを埋め込んだテスト用の SVG ファイルを書き込む。
+@details JCOMSIA_SVG_Write を使用せずに、JACIC 写真の SVG と同じ構成の文字列を直接組み立てる。
+黒板画像を指定した場合は、JCOMSIA_SVG_CalculateHashValue で計算したハッシュコードをメタデータに含める。
+@param [in] path 書き込み先
+@param [in] originalPath 原本画像のファイルパス
+@param [in] chalkboardPath 黒板画像のファイルパス。黒板画像がない場合は NULL
+@param [in] vender メタデータのベンダー名
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeTestSvg(const char *path, const char *originalPath, const char *chalkboardPath, const char *vender);
+
+/*!
+@brief バイト配列をファイルに書き込む。
+@param [in] path 書き込み先
+@param [in] data 書き込むデータ
+@param length data の長さ
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeTestFile(const char *path, const unsigned char *data, size_t length);
+
+/*!
+@brief ファイル全体を読み込む。
+@param [in] path 読み込むファイル
+@param [out] length 読み込んだバイト数
+@return 読み込んだデータ（末尾に '\0' を付加する。free で解放する）。失敗した場合は NULL
+*/
+unsigned char *readTestFile(const char *path, size_t *length);
+
+/*!
+@brief 画像データの途中の 1 バイトを書き換えたファイルを作成する。
+@details マーカーやスタッフィングに関係しないバイトを書き換えるため、画像ハッシュ値のみが一致しなくなる。
+@param [in] srcPath 読み込むファイル
+@param [in] dstPath 書き込み先
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeTamperedTestJpeg(const char *srcPath, const char *dstPath);
+
+/*!
+@brief 文字列の最初の一致箇所を置き換えてファイルに書き込む。
+@param [in] path 書き込み先
+@param [in] text もとの文字列
+@param [in] find 置き換える文字列
+@param [in] replace 置き換え後の文字列
+@retval 0 成功
+@retval -1 find が見つからない場合、書き込みに失敗した場合
+*/
+int writeReplacedTestFile(const char *path, const char *text, const char *find, const char *replace);
+
+/*!
+@brief 値を置き換えた SVG ファイルを作成する。
+@param [in] path 書き込み先
+@param [in] text もとの SVG ファイルの内容
+@param [in] start 値の直前の文字列
+@param index start の何番目（ 0 から数える）の一致箇所の値を置き換えるか
+@param [in] sourcePath 置き換え後の値を取り出す SVG ファイル（ start の最初の一致箇所の値を使う）
+@retval 0 成功
+@retval -1 失敗
+*/
+int writeValueReplacedTestFile(const char *path, const char *text, const char *start, int index, const char *sourcePath);
+
+#endif /* TEST_UTIL_H_ */
@@ -0,0 +1,170 @@
+﻿/*!
+@file xmlscan_test.c
+@brief findXMLSpecialByte の SSE2 / NEON による走査を、1 バイトずつ調べる実装と比較するテスト
+@details 探す対象の各バイト（制御文字、 0x7F 以上、 '<' 、 '&' 、区切り文字）を 0 ～ 63 の全ての位置に置いて比較する。
+UTF-8 の複数バイトの文字がベクトルの境界をまたぐ場合、走査範囲の直後にだけ対象がある場合、対象が無い場合も確認する。
+先頭位置のずれによる違いも確認するため、走査対象の開始位置を 0 ～ 15 バイトずらす。
+*/
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "test_util.h"
+
+/* @name 定数マクロ定義 */
+/* @{ */
+#define MAX_LENGTH (160)        /*!< @brief 走査するバイト数の最大値 */
+#define MATCH_RANGE (64)        /*!< @brief 対象のバイトを置く位置の範囲 */
+#define ALIGNMENT_RANGE (16)    /*!< @brief 走査対象の開始位置をずらすバイト数の範囲 */
+/* @} */
+
+/*!
+@brief 探す対象のバイト（区切り文字を除く）
+@details 符号付き比較の境界となる 0x1F, 0x7F, 0x80 を含める。
+*/
+static const unsigned char SPECIAL_BYTES[] = { 0x00, 0x09, 0x0A, 0x1F, 0x7F, 0x80, 0xC3, 0xFF, '<', '&' };
+
+/*!
+@brief 区切り文字の候補
+*/
+static const unsigned char DELIMITERS[] = { '"', '\'', ']', '-' };
+
+/*!
+@brief 1 バイトずつ調べて、最初に見つかった対象の位置を求める。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@param delimiter あわせて探すバイト
+@return 最初に見つかった位置（見つからなかった場合は length ）
+*/
+static size_t _findXMLSpecialByteScalar(const unsigned char *data, size_t length, unsigned char delimiter)
+{
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        if(data[i] < 0x20 || 0x7E < data[i] || data[i] == '<' || data[i] == '&' || data[i] == delimiter) return i;
+    }
+
+    return length;
+}
+
+/*!
+@brief 対象を含まない表示可能な ASCII 文字で埋める。
+@details 0x20, 0x7E, '>' など、対象の前後の値も含める。
+@param [out] data 埋める領域
+@param length data の長さ
+@param delimiter 使用しないバイト
+*/
+static void _fill(unsigned char *data, size_t length, unsigned char delimiter)
+{
+    unsigned int state = 12345U;
+    unsigned char c;
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        do
+        {
+            state = state * 1103515245U + 12345U;
+            c = (unsigned char)(0x20 + (state >> 16) % (0x7E - 0x20 + 1));
+        } while(c == '<' || c == '&' || c == delimiter);
+
+        data[i] = c;
+    }
+}
+
+/*!
+@brief findXMLSpecialByte の結果を、1 バイトずつ調べた結果と比較する。
+@param [in] data 走査対象のバイト配列
+@param length data の長さ
+@param delimiter あわせて探すバイト
+@param [in] label 失敗時に表示する場面の名前
+@param position 対象を置いた位置
+*/
+static void _compare(const unsigned char *data, size_t length, unsigned char delimiter, const char *label, size_t position)
+{
+    size_t expected = _findXMLSpecialByteScalar(data, length, delimiter);
+    size_t actual = findXMLSpecialByte(data, length, delimiter);
+
+    if(expected != actual)
+    {
+        fprintf(stderr, "%s: delimiter '%c', length %lu, position %lu: expected %lu, got %lu\n", label, delimiter,
+                (unsigned long)length, (unsigned long)position, (unsigned long)expected, (unsigned long)actual);
+        ++testFailures;
+    }
+}
+
+/*!
+@brief テストを実行する。
+@retval 0 成功
+@retval 1 失敗
+*/
+int main(void)
+{
+    static const unsigned char MULTI_BYTE_CHAR[] = { 0xE3, 0x81, 0x82 }; /* U+3042 */
+
+    unsigned char filler[ALIGNMENT_RANGE + MAX_LENGTH + 1];
+    unsigned char buffer[ALIGNMENT_RANGE + MAX_LENGTH + 1];
+    unsigned char *data;
+    unsigned char delimiter;
+    size_t d;
+    size_t s;
+    size_t alignment;
+    size_t length;
+    size_t position;
+
+    for(d = 0; d < sizeof(DELIMITERS); ++d)
+    {
+        delimiter = DELIMITERS[d];
+        _fill(filler, sizeof(filler), delimiter);
+
+        for(alignment = 0; alignment < ALIGNMENT_RANGE; ++alignment)
+        {
+            data = buffer + alignment;
+
+            for(length = 0; length <= MAX_LENGTH; ++length)
+            {
+                /* 対象が無い */
+                memcpy(buffer, filler, sizeof(buffer));
+                _compare(data, length, delimiter, "no match", length);
+                TEST_CHECK_EQUAL(length, findXMLSpecialByte(data, length, delimiter));
+
+                /* 走査範囲の直後にだけ対象がある */
+                data[length] = delimiter;
+                _compare(data, length, delimiter, "after end", length);
+
+                for(position = 0; position < MATCH_RANGE && position < length; ++position)
+                {
+                    for(s = 0; s < sizeof(SPECIAL_BYTES); ++s)
+                    {
+                        memcpy(buffer, filler, sizeof(buffer));
+                        data[position] = SPECIAL_BYTES[s];
+                        _compare(data, length, delimiter, "special byte", position);
+                    }
+
+                    memcpy(buffer, filler, sizeof(buffer));
+                    data[position] = delimiter;
+                    _compare(data, length, delimiter, "delimiter", position);
+
+                    /* 後ろにもう 1 つある場合は、前の位置を返す */
+                    data[length - 1] = '<';
+                    _compare(data, length, delimiter, "first of two", position);
+                }
+
+                /* 複数バイトの文字が 16 バイトの境界をまたぐ（先頭は境界の 1 または 2 バイト前） */
+                for(position = 14; position + sizeof(MULTI_BYTE_CHAR) <= length; position += 16)
+                {
+                    memcpy(buffer, filler, sizeof(buffer));
+                    memcpy(&data[position], MULTI_BYTE_CHAR, sizeof(MULTI_BYTE_CHAR));
+                    _compare(data, length, delimiter, "straddling", position);
+
+                    memcpy(buffer, filler, sizeof(buffer));
+                    memcpy(&data[position + 1], MULTI_BYTE_CHAR, sizeof(MULTI_BYTE_CHAR));
+                    _compare(data, length, delimiter, "straddling", position + 1);
+                }
+            }
+        }
+    }
+
+    return testFailures == 0 ? 0 : 1;
+}
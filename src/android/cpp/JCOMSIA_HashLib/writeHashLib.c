@@ -12,12 +12,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !defined(_MSC_VER) && (!defined(JCOMSIA_DISABLE_PIPELINED_READ) || !defined(JCOMSIA_DISABLE_BATCH_THREADS) || !defined(JCOMSIA_DISABLE_PARALLEL_SVG_VALIDATION))
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include "app1.h"
 #include "app5.h"
+#include "cache.h"
 #include "common.h"
 #include "exif.h"
+#include "jpegstream.h"
+#include "queue.h"
 #include "sha256.h"
 #include "svg.h"
+#include "svgwriter.h"
 #include "writeHashLib.h"
 
 
@@ -27,30 +36,12 @@
 const size_t JCOMSIA_HASH_LENGTH = BYTE_SIZE_HASH_LENGTH;
 
 
-/* ハッシュ生成に使用するパスワード */
-static const char *PASSWORD = "d598ccd39f78df7d900259e9317662f23d8e9e6d32329a695e6e6f2e8cbed4e5";
-
-static HashBuffer *_getPasswordHash()
-{
-    int ret;
-    size_t passwordLength = strlen(PASSWORD);
-
-    HashBuffer *input = NULL;
-    HashBuffer *output = NULL;
-
-    input = allocateBinaryData(passwordLength);
-    if(input == NULL) return NULL;
-
-    memcpy(input->_buff, PASSWORD, passwordLength);
-    output = allocateBinaryData(JCOMSIA_HASH_LENGTH);
-
-    ret = hash(input, output);
-    assert(ret == FUNCTION_SUCCESS);
-
-    _SECURE_FREE(input);
-
-    return output;
-}
+/*!
+@brief ハッシュ生成に使用するパスワードのハッシュ値（16 進数文字列）
+@details パスワードは定数であるため、呼び出しのたびに計算せず計算済みの値を埋め込む。
+パスワード "d598ccd39f78df7d900259e9317662f23d8e9e6d32329a695e6e6f2e8cbed4e5" を SHA-256 で計算した値。
+*/
+static const unsigned char PASSWORD_HASH[BYTE_SIZE_HASH_LENGTH + 1] = "c48076b14af645d273d05690cf218060a20daf3a27f0d5ac0c4aa9ac7e3592ce";
 
 /*!
 @brief 指定ファイルの存在チェックを行う。
@@ -129,8 +120,10 @@ int _fileSize(size_t *result, FILE *fp)
 
 /*!
 @brief `filePath` を読み込み、`buffer` に格納する。
+@details mapFileBinaryData でマップできる場合は、読み込まずにマップした領域を返す。
 @param [in] filePath ファイルの場所
-@param [out] buffer 読み込んだ `filePath` のバイナリ情報を格納するためのデータ
+@param [in, out] cache 読み込み先の領域を使い回すためのキャッシュ。使い回さない場合は NULL
+@param [out] buffer 読み込んだ `filePath` のバイナリ情報を格納するためのデータ。使い終わったら releaseFileBinaryData で解放すること。
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval FILE_OPEN_FAILED ファイルオープンに失敗した場合
@@ -138,7 +131,7 @@ int _fileSize(size_t *result, FILE *fp)
 @retval FILE_CLOSE_FAILED ファイルクローズに失敗した場合
 @retval OTHER_ERROR ファイル読み込み途中でエラーが発生した場合、メモリ確保に失敗した場合
 */
-int _readFile(const char *filePath, JpegBuffer **buffer)
+int _readFile(const char *filePath, FileDataCache *cache, JpegBuffer **buffer)
 {
     int ret = FUNCTION_SUCCESS;
     int closeResult;
@@ -152,6 +145,12 @@ int _readFile(const char *filePath, JpegBuffer **buffer)
         return INCORRECT_PARAMETER;
     }
 
+    /* マップできる場合は読み込まずに参照する */
+    if(mapFileBinaryData(filePath, buffer) == FUNCTION_SUCCESS)
+    {
+        return FUNCTION_SUCCESS;
+    }
+
     if((fp = fopen(filePath, "rb")) == NULL)
     {
         /* ファイルオープンエラー */
@@ -173,9 +172,9 @@ int _readFile(const char *filePath, JpegBuffer **buffer)
     }
 
     /* バイナリデータ領域確保 */
-    *buffer = allocateBinaryData(fileSize);
+    *buffer = allocateCachedFileBinaryData(cache, fileSize);
 
-    if(buffer == NULL)
+    if(*buffer == NULL)
     {
         /* メモリ確保失敗 */
         ret = OTHER_ERROR;
@@ -211,36 +210,382 @@ FINALIZE:
 }
 
 /*!
-@brief ハッシュを合成して再計算する用途のために結合する。
-@param [in] srcBuffer コピー元のデータ構造体
-@param [out] dstBuffer コピー先のデータ構造体（メモリ割り当て済み）
-@param [in] cursor データのコピー位置を示すポインタ（ dstBuffer のデータの末尾）
+@name ファイル読み込みと画像ハッシュ値計算の並行処理
+@details 読み込みスレッドがファイルを一定サイズずつ読み込み、呼び出し元のスレッドは読み込み済みの範囲から順に
+画像ハッシュ値を計算する。読み込みとハッシュ値計算の時間が重なるため、大きな画像ほど処理時間が短くなる。
+後続の APP5 / APP1 の解析や書き込みでファイル全体が必要になるため、読み込み先は最終的なバッファとし、
+読み込み済みのバイト数のみを受け渡す。
+@{
+*/
+
+#if !defined(_MSC_VER) && !defined(JCOMSIA_DISABLE_PIPELINED_READ)
+#define PIPELINED_READ                                  /*!< @brief 読み込みスレッドを使用する */
+#endif
+
+#define BYTE_SIZE_READ_CHUNK ((size_t)(1024 * 1024))    /*!< @brief 読み込みスレッドが一度に読み込むバイト数 */
+#define BYTE_SIZE_READ_HEAD  ((size_t)(64 * 1024))      /*!< @brief SOS セグメントを探す前に待つ先頭部分のバイト数 */
+
+#if defined(PIPELINED_READ)
+
+/*!
+@struct FileReader
+@brief 読み込みスレッドと呼び出し元のスレッドで共有する読み込み状況
+*/
+typedef struct
+{
+    FILE *_fp;                  /*!< @brief 読み込み対象のファイル */
+    unsigned char *_dst;        /*!< @brief 読み込み先のバッファ */
+    size_t _size;               /*!< @brief ファイルサイズ */
+    size_t _available;          /*!< @brief 読み込み済みのバイト数（_mutex で保護する） */
+    JACIC_BOOL _finished;       /*!< @brief 読み込みスレッドが終了したか（_mutex で保護する） */
+    int _result;                /*!< @brief 読み込み結果（_mutex で保護する） */
+    pthread_mutex_t _mutex;     /*!< @brief 読み込み状況を保護するミューテックス */
+    pthread_cond_t _cond;       /*!< @brief 読み込みの進行を通知する条件変数 */
+} FileReader;
+
+/*!
+@brief ファイルを BYTE_SIZE_READ_CHUNK バイトずつ読み込み、読み込むたびに進捗を通知する。
+@param [in, out] arg 読み込み状況 (FileReader)
+@return 常に NULL
+*/
+static void *_readFileChunks(void *arg)
+{
+    FileReader *reader = (FileReader *)arg;
+    size_t offset = 0;
+    size_t chunkSize;
+    size_t readSize;
+    int result = FUNCTION_SUCCESS;
+
+    while(offset < reader->_size)
+    {
+        chunkSize = reader->_size - offset;
+        if(BYTE_SIZE_READ_CHUNK < chunkSize) chunkSize = BYTE_SIZE_READ_CHUNK;
+
+        readSize = fread(reader->_dst + offset, BYTE_SIZE_UNSIGNED_CHAR, chunkSize, reader->_fp);
+        offset += readSize;
+
+        pthread_mutex_lock(&reader->_mutex);
+        reader->_available = offset;
+        pthread_cond_signal(&reader->_cond);
+        pthread_mutex_unlock(&reader->_mutex);
+
+        if(readSize < chunkSize)
+        {
+            /* ファイル読み込み失敗 */
+            result = FILE_OPEN_FAILED;
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&reader->_mutex);
+    reader->_result = result;
+    reader->_finished = JACIC_BOOL_TRUE;
+    pthread_cond_signal(&reader->_cond);
+    pthread_mutex_unlock(&reader->_mutex);
+
+    return NULL;
+}
+
+/*!
+@brief 指定したバイト数の読み込みが終わるか、読み込みスレッドが終了するまで待つ。
+@param [in, out] reader 読み込み状況
+@param minimum 待つバイト数
+@return 読み込み済みのバイト数（minimum に満たない場合は読み込みに失敗している）
+*/
+static size_t _waitFileChunks(FileReader *reader, size_t minimum)
+{
+    size_t available;
+
+    pthread_mutex_lock(&reader->_mutex);
+    while(reader->_available < minimum && reader->_finished == JACIC_BOOL_FALSE)
+    {
+        pthread_cond_wait(&reader->_cond, &reader->_mutex);
+    }
+    available = reader->_available;
+    pthread_mutex_unlock(&reader->_mutex);
+
+    return available;
+}
+
+/*!
+@brief 読み込み済みの範囲から順に、画像の圧縮データ (SOS ～ EOI) のハッシュ値を計算する。
+@details clipCompressedImage と同じ範囲を対象とし、範囲を特定できなかった場合は同じ戻り値を prehashed に設定する。
+読み込みに失敗した場合、prehashed は計算済みにならない。
+@param [in, out] reader 読み込み状況
+@param [in, out] buffer 読み込み先のバッファ（_len は一時的に読み込み済みの長さへ変更する）
+@param [out] prehashed 計算した画像ハッシュ値
+*/
+static void _hashFileChunks(FileReader *reader, JpegBuffer *buffer, PrehashedImage *prehashed)
+{
+    SHA256Context context;
+    JpegSegmentIndex index;
+    Arena arena;
+    unsigned char arenaBuff[BYTE_SIZE_ARENA_BLOCK];
+    unsigned long startIndex = 0UL;
+    const unsigned char *found;
+    size_t available;
+    size_t request;
+    size_t hashed;
+    size_t scan;
+    int ret;
+
+    /* 探し直すたびに作成するセグメント索引は、同じ領域を使い回す */
+    arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+
+    /* 先頭部分から SOS セグメントを探す。読み込みが足りずに見つからない場合は、読み込みを待って探し直す */
+    request = BYTE_SIZE_READ_HEAD;
+    for(;;)
+    {
+        if(reader->_size < request) request = reader->_size;
+
+        available = _waitFileChunks(reader, request);
+        if(available < request) return;
+
+        if(available < reader->_size)
+        {
+            /* 走査中に読み込み途中の領域を参照しないよう、セグメントサイズ分を除いた長さで探す */
+            buffer->_len = (BYTE_SIZE_SEGMENT_SIZE < available) ? available - BYTE_SIZE_SEGMENT_SIZE : 0;
+        }
+
+        ret = buildSegmentIndex(buffer, &index, &arena);
+        if(ret == FUNCTION_SUCCESS)
+        {
+            ret = findCompressedImageStart(buffer, &index, &startIndex, JACIC_BOOL_FALSE);
+        }
+        releaseSegmentIndex(&index);
+        arenaRelease(&arena);
+        buffer->_len = reader->_size;
+
+        if(ret == FUNCTION_SUCCESS) break;
+
+        if(reader->_size <= available)
+        {
+            /* ファイル全体を読み込んでも見つからない */
+            prehashed->_hashed = JACIC_BOOL_TRUE;
+            prehashed->_result = ret;
+            return;
+        }
+
+        request = available + BYTE_SIZE_READ_CHUNK;
+    }
+
+    sha256Init(&context);
+    hashed = startIndex;
+    scan = startIndex + BYTE_SIZE_SEGMENT_MARKER;
+
+    for(;;)
+    {
+        /* 読み込み済みの範囲から EOI マーカーを探す */
+        found = NULL;
+        while(scan + 1 < available)
+        {
+            scan += findMarkerPrefix(&(buffer->_buff[scan]), available - 1 - scan);
+            if(available <= scan + 1) break;
+
+            if(buffer->_buff[scan + 1] == 0xD9)
+            {
+                found = &(buffer->_buff[scan]);
+                break;
+            }
+
+            scan++;
+        }
+
+        if(found != NULL)
+        {
+            /* EOI マーカー自身までを含めて計算を終える */
+            sha256Update(&context, &(buffer->_buff[hashed]), scan + BYTE_SIZE_SEGMENT_MARKER - hashed);
+            sha256FinalDigest(&context, prehashed->_digest);
+
+            prehashed->_hashed = JACIC_BOOL_TRUE;
+            prehashed->_result = FUNCTION_SUCCESS;
+            return;
+        }
+
+        /* EOI より前であることが確定した範囲を計算する */
+        sha256Update(&context, &(buffer->_buff[hashed]), scan - hashed);
+        hashed = scan;
+
+        if(reader->_size <= available)
+        {
+            /* ファイルの最後まで EOI が見つからない */
+            prehashed->_hashed = JACIC_BOOL_TRUE;
+            prehashed->_result = INCORRECT_EXIF_FORMAT;
+            return;
+        }
+
+        request = available + BYTE_SIZE_READ_CHUNK;
+        if(reader->_size < request) request = reader->_size;
+
+        available = _waitFileChunks(reader, request);
+        if(available < request) return;
+    }
+}
+
+#endif /* PIPELINED_READ */
+
+/*!
+@brief `filePath` を読み込んで `buffer` に格納し、読み込みと並行して画像ハッシュ値を計算する。
+@details 読み込みスレッドを使用できない環境、またはファイルをマップできた場合は _readFile と同じ処理を行い、prehashed は計算済みにならない。
+@param [in] filePath ファイルの場所
+@param [out] buffer 読み込んだ `filePath` のバイナリ情報を格納するためのデータ。使い終わったら releaseFileBinaryData で解放すること。
+@param [out] prehashed 読み込みと並行して計算した画像ハッシュ値
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_OPEN_FAILED ファイルオープンに失敗した場合
+@retval FILE_SIZE_ZERO ファイルサイズが 0 の場合
+@retval FILE_CLOSE_FAILED ファイルクローズに失敗した場合
+@retval OTHER_ERROR ファイル読み込み途中でエラーが発生した場合、メモリ確保に失敗した場合
+*/
+int _readFileWithImageHash(const char *filePath, JpegBuffer **buffer, PrehashedImage *prehashed)
+{
+#if defined(PIPELINED_READ)
+    int ret = FUNCTION_SUCCESS;
+    int closeResult;
+    size_t fileSize;
+    FileReader reader;
+    pthread_t thread;
+    FILE *fp = NULL;
+
+    /* パラメータが不正 */
+    if(filePath == NULL || buffer == NULL || prehashed == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    prehashed->_hashed = JACIC_BOOL_FALSE;
+
+    /* マップできる場合は読み込まずに参照する（画像ハッシュ値はハッシュ値の生成時に計算する） */
+    if(mapFileBinaryData(filePath, buffer) == FUNCTION_SUCCESS)
+    {
+        return FUNCTION_SUCCESS;
+    }
+
+    if((fp = fopen(filePath, "rb")) == NULL)
+    {
+        /* ファイルオープンエラー */
+        ret = FILE_OPEN_FAILED;
+        goto FINALIZE;
+    }
+
+    /* ファイルサイズ取得 */
+    if((ret = _fileSize(&fileSize, fp)) != FUNCTION_SUCCESS)
+    {
+        goto FINALIZE;
+    }
+
+    if(fileSize == 0UL)
+    {
+        /* ファイルサイズゼロ */
+        ret = FILE_SIZE_ZERO;
+        goto FINALIZE;
+    }
+
+    /* バイナリデータ領域確保 */
+    *buffer = allocateFileBinaryData(fileSize);
+    if(*buffer == NULL)
+    {
+        /* メモリ確保失敗 */
+        ret = OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    reader._fp = fp;
+    reader._dst = (*buffer)->_buff;
+    reader._size = fileSize;
+    reader._available = 0;
+    reader._finished = JACIC_BOOL_FALSE;
+    reader._result = FUNCTION_SUCCESS;
+    pthread_mutex_init(&reader._mutex, NULL);
+    pthread_cond_init(&reader._cond, NULL);
+
+    if(pthread_create(&thread, NULL, _readFileChunks, &reader) == 0)
+    {
+        /* 読み込みと並行して画像ハッシュ値を計算する */
+        _hashFileChunks(&reader, *buffer, prehashed);
+        pthread_join(thread, NULL);
+    }
+    else
+    {
+        /* スレッドを作成できない場合は、読み込みを終えてから計算する */
+        _readFileChunks(&reader);
+        _hashFileChunks(&reader, *buffer, prehashed);
+    }
+
+    pthread_cond_destroy(&reader._cond);
+    pthread_mutex_destroy(&reader._mutex);
+
+    ret = reader._result;
+    if(ret != FUNCTION_SUCCESS)
+    {
+        prehashed->_hashed = JACIC_BOOL_FALSE;
+    }
+
+FINALIZE:
+    /* ファイルクローズ */
+    if(fp != NULL)
+    {
+        closeResult = fclose(fp);
+
+        if(closeResult == EOF)
+        {
+            /* ファイルクローズに失敗 */
+            ret = FILE_CLOSE_FAILED;
+        }
+
+        fp = NULL;
+    }
+
+    return ret;
+#else
+    /* パラメータが不正 */
+    if(prehashed == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    prehashed->_hashed = JACIC_BOOL_FALSE;
+
+    return _readFile(filePath, NULL, buffer);
+#endif
+}
+
+/*! @} */
+
+/*!
+@brief ハッシュ値のバイト配列を 16 進数文字列に変換して、計算中のハッシュコンテキストに追加する。
+@details 合成ハッシュ値は仕様上 16 進数文字列を結合した値から計算するため、追加する直前に変換する。
+@param [in] digest 追加するハッシュ値（BYTE_SIZE_HASH_DIGEST バイト）
+@param [in, out] context 合成ハッシュ値を計算中のコンテキスト
 */
-void _appendHash(HashBuffer *srcBuffer, HashBuffer *dstBuffer, size_t *cursor)
+void _appendDigest(const unsigned char *digest, SHA256Context *context)
 {
-    assert(srcBuffer != NULL);
-    assert(dstBuffer != NULL);
-    assert(cursor != NULL);
+    unsigned char hashString[BYTE_SIZE_HASH_LENGTH];
 
-    memcpy(dstBuffer->_buff + *cursor, srcBuffer->_buff, srcBuffer->_len);
-    *cursor += srcBuffer->_len;
+    assert(digest != NULL);
+    assert(context != NULL);
+
+    encodeHex(hashString, digest, BYTE_SIZE_HASH_DIGEST);
+    sha256Update(context, hashString, BYTE_SIZE_HASH_LENGTH);
 }
 
 /*!
 @brief APP5 領域から取得したハッシュ値と画像データから生成したハッシュ値を比較した結果を返す。
 @param [in] app5ImageHash APP5 領域から取得したハッシュ値（画像）
-@param [in] dataImageHash 画像データから生成したハッシュ値（画像）
+@details APP5 領域の 16 進数文字列をバイト配列に戻し、一定時間で比較する。
+@param [in] dataImageDigest 画像データから生成したハッシュ値（画像、BYTE_SIZE_HASH_DIGEST バイト）
 @param [in] app5DateHash APP5 領域から取得したハッシュ値（撮影日時）
-@param [in] dataDateHash 画像データから生成したハッシュ値（撮影日時）
+@param [in] dataDateDigest 画像データから生成したハッシュ値（撮影日時、BYTE_SIZE_HASH_DIGEST バイト）
 @retval SAME_HASH 画像、撮影日時のどちらもハッシュ値が等しい
 @retval INCORRECT_HASH_BOTH 画像、撮影日時のどちらもハッシュ値が等しくない
 @retval INCORRECT_HASH_IMAGE 画像のハッシュ値が等しくなく、撮影日時のハッシュ値が等しい
 @retval INCORRECT_HASH_DATE 画像のハッシュ値が等しく、撮影日時のハッシュ値が等しくない
 */
-int _compareHashValues(APP5Item app5ImageHash, HashBuffer *dataImageHash, APP5Item app5DateHash, HashBuffer *dataDateHash)
+int _compareHashValues(APP5Item app5ImageHash, const unsigned char *dataImageDigest, APP5Item app5DateHash, const unsigned char *dataDateDigest)
 {
     int imageResult = -1;
     int dateResult  = -1;
+    unsigned char app5Digest[BYTE_SIZE_HASH_DIGEST];
 
     /* APP5領域にいずれのハッシュ値も存在しない */
     if(app5ImageHash.titleExistsFlag == JACIC_BOOL_FALSE &&
@@ -250,16 +595,18 @@ int _compareHashValues(APP5Item app5ImageHash, HashBuffer *dataImageHash, APP5It
         return HASH_NOT_EXISTS;
     }
 
-    if(app5ImageHash.value != NULL &&
-            dataImageHash != NULL)
+    if(app5ImageHash.value._ptr != NULL &&
+            dataImageDigest != NULL &&
+            decodeHex(app5Digest, app5ImageHash.value._ptr, BYTE_SIZE_HASH_LENGTH) == FUNCTION_SUCCESS)
     {
-        imageResult = memcmp(app5ImageHash.value->_buff, dataImageHash->_buff, JCOMSIA_HASH_LENGTH);
+        imageResult = compareConstantTime(app5Digest, dataImageDigest, BYTE_SIZE_HASH_DIGEST);
     }
 
-    if(app5DateHash.value != NULL &&
-            dataDateHash != NULL)
+    if(app5DateHash.value._ptr != NULL &&
+            dataDateDigest != NULL &&
+            decodeHex(app5Digest, app5DateHash.value._ptr, BYTE_SIZE_HASH_LENGTH) == FUNCTION_SUCCESS)
     {
-        dateResult  = memcmp(app5DateHash.value->_buff,  dataDateHash->_buff,  JCOMSIA_HASH_LENGTH);
+        dateResult  = compareConstantTime(app5Digest, dataDateDigest, BYTE_SIZE_HASH_DIGEST);
     }
 
     if(imageResult == 0 && dateResult == 0)
@@ -306,6 +653,10 @@ int _hashWriteReturnValueConvert(int retval)
         ret = JW_ERROR_SAME_FILE_PATH;
         break;
 
+    case ALLOCATOR_IN_USE:
+        ret = JW_ERROR_ALLOCATOR_IN_USE;
+        break;
+
     case FILE_NOT_EXISTS:
         ret = JW_ERROR_READ_FILE_NOT_EXISTS;
         break;
@@ -501,6 +852,97 @@ int _createHashReturnValueConvert(int retval)
     return ret;
 }
 
+/*!
+@brief SVG ファイル作成関数で内部利用している戻り値定数を外部公開用の定数に置き換える。
+@param retval 対象となる戻り値
+*/
+int _svgWriteReturnValueConvert(int retval)
+{
+    int ret;
+
+    switch(retval)
+    {
+    case FUNCTION_SUCCESS:
+        ret = JW_SVG_CREATE_SUCCESS;
+        break;
+
+    case INCORRECT_PARAMETER:
+        ret = JW_SVG_ERROR_INCORRECT_PARAMETER;
+        break;
+
+    case SAME_FILE_PATH:
+        ret = JW_SVG_ERROR_SAME_FILE_PATH;
+        break;
+
+    case FILE_NOT_EXISTS:
+        ret = JW_SVG_ERROR_FILE_DOES_NOT_EXIST;
+        break;
+
+    case FILE_ALREADY_EXISTS:
+        ret = JW_SVG_ERROR_FILE_ALREADY_EXISTS;
+        break;
+
+    case FILE_OPEN_FAILED:
+        ret = JW_SVG_ERROR_FILE_OPEN_FAILED;
+        break;
+
+    case FILE_SIZE_ZERO:
+        ret = JW_SVG_ERROR_FILE_SIZE_ZERO;
+        break;
+
+    case FILE_WRITE_FAILED:
+        ret = JW_SVG_ERROR_FILE_WRITE_FAILED;
+        break;
+
+    case FILE_CLOSE_FAILED:
+        ret = JW_SVG_ERROR_FILE_CLOSE_FAILED;
+        break;
+
+    case INCORRECT_EXIF_FORMAT:
+        ret = JW_SVG_ERROR_INCORRECT_EXIF_FORMAT;
+        break;
+
+    case ORG_DOES_NOT_HAVE_HASH:
+        ret = JW_SVG_ERROR_ORG_DOES_NOT_HAVE_HASH;
+        break;
+
+    case ORG_HASH_NG_IMAGE:
+        ret = JW_SVG_ERROR_ORG_HASH_NG_IMAGE;
+        break;
+
+    case ORG_HASH_NG_DATE:
+        ret = JW_SVG_ERROR_ORG_HASH_NG_DATE;
+        break;
+
+    case ORG_HASH_NG_BOTH:
+        ret = JW_SVG_ERROR_ORG_HASH_NG_BOTH;
+        break;
+
+    case CB_DOES_NOT_HAVE_HASH:
+        ret = JW_SVG_ERROR_CB_DOES_NOT_HAVE_HASH;
+        break;
+
+    case CB_HASH_NG_IMAGE:
+        ret = JW_SVG_ERROR_CB_HASH_NG_IMAGE;
+        break;
+
+    case CB_HASH_NG_DATE:
+        ret = JW_SVG_ERROR_CB_HASH_NG_DATE;
+        break;
+
+    case CB_HASH_NG_BOTH:
+        ret = JW_SVG_ERROR_CB_HASH_NG_BOTH;
+        break;
+
+    case OTHER_ERROR:
+    default:
+        ret = JW_SVG_ERROR_OTHERS;
+        break;
+    }
+
+    return ret;
+}
+
 /*!
 @brief SVG 用ハッシュチェック関数で内部利用している戻り値定数を外部公開用の定数に置き換える。
 @param retval 対象となる戻り値
@@ -616,95 +1058,96 @@ int _svgResultToPublicErrorCode(SVGResult svgResult)
 }
 
 /*!
-@brief 画像データのバイナリからハッシュ値を生成して呼び出し元へ返す。
+@brief バイト配列のハッシュ値をバイト配列で求める。
+@param [in] data 計算対象のバイト配列
+@param length data の長さ
+@param [out] digest ハッシュ値を受けとる配列（BYTE_SIZE_HASH_DIGEST バイト）
+*/
+static void _digestBytes(const unsigned char *data, size_t length, unsigned char *digest)
+{
+    SHA256Context context;
+
+    sha256Init(&context);
+    sha256Update(&context, data, length);
+    sha256FinalDigest(&context, digest);
+}
+
+/*!
+@brief 画像データのバイナリからハッシュ値を生成して呼び出し元へ返す。
 @param [in] srcBuffer ハッシュ値生成対象の画像バイナリ
-@param [out] imageHash 呼び出し元で受け取る画像ハッシュ値（NULL 初期化されていること）
-@param [out] dateHash 呼び出し元で受け取る撮影日時ハッシュ値（NULL 初期化されていること）
+@param [in] index srcBuffer から作成したセグメント索引
+@param [in] prehashed 読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [out] imageDigest 呼び出し元で受け取る画像ハッシュ値（BYTE_SIZE_HASH_DIGEST バイト）
+@param [out] dateDigest 呼び出し元で受け取る撮影日時ハッシュ値（BYTE_SIZE_HASH_DIGEST バイト）
+@param [in, out] arena 作業用の領域の割り当て元となるアリーナ
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval DATE_NOT_EXISTS Exif メタデータ内に原画像データの生成日時が見つからなかった場合
 @retval OTHER_ERROR メモリの確保に失敗した場合
 */
-int _generateHashes(JpegBuffer *srcBuffer, HashBuffer **imageHash, HashBuffer **dateHash)
+int _generateHashes(JpegBuffer *srcBuffer, const JpegSegmentIndex *index, const PrehashedImage *prehashed, unsigned char *imageDigest, unsigned char *dateDigest, Arena *arena)
 {
     int ret;
-    HashBuffer *imgBuff = NULL;
+    ByteView imgView = {NULL, 0};
     HashBuffer *dateBuff = NULL;
 
     if(srcBuffer == NULL) return INCORRECT_PARAMETER;
     if(srcBuffer->_len == 0) return FILE_SIZE_ZERO;
 
-    if(imageHash == NULL) return INCORRECT_PARAMETER;
-    if(*imageHash != NULL) return INCORRECT_PARAMETER;
-
-    if(dateHash == NULL) return INCORRECT_PARAMETER;
-    if(*dateHash != NULL) return INCORRECT_PARAMETER;
+    if(index == NULL) return INCORRECT_PARAMETER;
+    if(imageDigest == NULL) return INCORRECT_PARAMETER;
+    if(dateDigest == NULL) return INCORRECT_PARAMETER;
+    if(arena == NULL) return INCORRECT_PARAMETER;
 
-    /*
-     * ハッシュ値計算に必要となる
-     * 『画像の圧縮データ開始位置以降のバイナリ』を取得する
-     */
-    ret = clipCompressedImage(srcBuffer, &imgBuff, JACIC_BOOL_FALSE);
-    if(ret != FUNCTION_SUCCESS)
-    {
-        goto FINALIZE;
-    }
-
-    *imageHash = allocateBinaryData(JCOMSIA_HASH_LENGTH);
-    if(*imageHash == NULL)
+    if(prehashed != NULL && prehashed->_hashed == JACIC_BOOL_TRUE)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
+        /* 読み込みと並行して計算済みの画像ハッシュを使用する */
+        ret = prehashed->_result;
+        if(ret != FUNCTION_SUCCESS) return ret;
     }
-
-    /* ハッシュ値計算 */
-    ret = hash(imgBuff, *imageHash);
-    if(ret != FUNCTION_SUCCESS)
+    else
     {
-        goto FINALIZE;
+        /*
+         * ハッシュ値計算に必要となる
+         * 『画像の圧縮データ開始位置以降のバイナリ』を取得する
+         */
+        ret = clipCompressedImage(srcBuffer, index, &imgView, JACIC_BOOL_FALSE);
+        if(ret != FUNCTION_SUCCESS) return ret;
     }
 
     /*
      * APP1 領域からハッシュ値計算に必要となる『撮影日時情報』を取得する
+     * （作業用の領域はアリーナから割り当て、呼び出し元でまとめて解放する）
      */
-    ret = getDateTimeOriginal(srcBuffer, &dateBuff);
-    if(ret != FUNCTION_SUCCESS)
-    {
-        /* 不正な Exif フォーマット */
-        goto FINALIZE;
-    }
+    ret = getDateTimeOriginal(srcBuffer, index, arena, &dateBuff);
+    if(ret != FUNCTION_SUCCESS) return ret;
 
-    *dateHash = allocateBinaryData(JCOMSIA_HASH_LENGTH);
-    if(*dateHash == NULL)
+    /* ハッシュ値計算 */
+    if(imgView._ptr != NULL)
     {
-        /* メモリ確保失敗 */
-        ret = OTHER_ERROR;
-        goto FINALIZE;
+        _digestBytes(imgView._ptr, imgView._len, imageDigest);
     }
-
-    /* ハッシュ値計算 */
-    ret = hash(dateBuff, *dateHash);
-    if(ret != FUNCTION_SUCCESS)
+    else
     {
-        goto FINALIZE;
+        memcpy(imageDigest, prehashed->_digest, BYTE_SIZE_HASH_DIGEST);
     }
 
-FINALIZE:
-
-    /* メモリ解放 */
-    _SECURE_FREE(dateBuff);
-    _SECURE_FREE(imgBuff);
+    _digestBytes(dateBuff->_buff, dateBuff->_len, dateDigest);
 
-    return ret;
+    return FUNCTION_SUCCESS;
 }
 
+/*! 埋め込み時のアリーナの初期領域のバイト数（APP5 セグメント全体とその他の一時領域が収まる大きさ） */
+#define BYTE_SIZE_WRITE_ARENA (BYTE_SIZE_ARENA_BLOCK * 2)
+
 /*!
-@brief 指定されたバイト配列に改ざんチェック値を埋め込んだバイト配列を返す。
+@brief 指定されたバイト配列に改ざんチェック値を埋め込み、destFile が指定されていればファイルへ、そうでなければ destBuff へ出力する。
 
 @param [in] srcBuff 改ざんチェック値を埋め込む対象のバッファ
-@param [out] destBuff 改ざんチェック値を埋めんだ状態を受け付けるバッファ
+@param [in] prehashed 読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [out] destBuff 改ざんチェック値を埋めんだ状態を受け付けるバッファ（ destFile を指定する場合は NULL ）
+@param [in] destFile 改ざんチェック値を埋め込んだ結果を書き出すファイルパス（ destBuff へ出力する場合は NULL ）
 @retval FUNCTION_SUCCESS 正常終了
 @retval INCORRECT_PARAMETER 不正な引数が指定された場合
 @retval FILE_SIZE_ZERO バッファのサイズがゼロ
@@ -713,24 +1156,35 @@ FINALIZE:
 @retval INCORRECT_EXIF_FORMAT Exif ファイルが不正な形式の場合
 @retval APP5_ALREADY_EXISTS APP5 領域が既に存在する場合
 @retval DATE_NOT_EXISTS Exif メタデータ内に原画像データの生成日時が見つからなかった場合
+@retval FILE_OPEN_FAILED ファイルのオープンに失敗
+@retval FILE_WRITE_FAILED ファイルへの書き込みに失敗
+@retval FILE_CLOSE_FAILED ファイルのクローズに失敗
 @retval OTHER_ERROR メモリの確保に失敗した場合
 */
-int _writeHashValueToBuffer(JpegBuffer *srcBuff, JpegBuffer **destBuff)
+static int _writeHashValue(JpegBuffer *srcBuff, const PrehashedImage *prehashed, JpegBuffer **destBuff, const char *destFile)
 {
     int ret = FUNCTION_SUCCESS;
     HashBuffer *dateHash = NULL;
     HashBuffer *imageHash = NULL;
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+    Arena arena;
+    unsigned char arenaBuff[BYTE_SIZE_WRITE_ARENA];
+    unsigned char imageDigest[BYTE_SIZE_HASH_DIGEST];
+    unsigned char dateDigest[BYTE_SIZE_HASH_DIGEST];
 
     /* パラメータが不正 */
     if(srcBuff == NULL || srcBuff->_len == 0)
     {
         return INCORRECT_PARAMETER;
     }
-    if(destBuff == NULL)
+    if(destBuff == NULL && destFile == NULL)
     {
         return INCORRECT_PARAMETER;
     }
 
+    /* この呼び出しの間だけ使用する一時領域は、すべてアリーナから割り当てる */
+    arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+
     if(srcBuff->_len == 0UL)
     {
         /* ファイルサイズゼロ */
@@ -738,31 +1192,97 @@ int _writeHashValueToBuffer(JpegBuffer *srcBuff, JpegBuffer **destBuff)
         goto FINALIZE;
     }
 
-    ret = _generateHashes(srcBuff, &imageHash, &dateHash);
+    /* ハッシュ値の計算と APP5 領域の埋め込みで共通に参照するセグメント索引を作成する */
+    ret = buildSegmentIndex(srcBuff, &index, &arena);
+    if(ret != FUNCTION_SUCCESS)
+    {
+        goto FINALIZE;
+    }
+
+    ret = _generateHashes(srcBuff, &index, prehashed, imageDigest, dateDigest, &arena);
     if(ret != FUNCTION_SUCCESS)
     {
         goto FINALIZE;
     }
 
+    /* APP5 領域には 16 進数文字列で埋め込む */
+    imageHash = arenaAllocateBinaryData(&arena, JCOMSIA_HASH_LENGTH);
+    dateHash = arenaAllocateBinaryData(&arena, JCOMSIA_HASH_LENGTH);
+    if(imageHash == NULL || dateHash == NULL)
+    {
+        /* メモリ確保失敗 */
+        ret = OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    encodeHex(imageHash->_buff, imageDigest, BYTE_SIZE_HASH_DIGEST);
+    encodeHex(dateHash->_buff, dateDigest, BYTE_SIZE_HASH_DIGEST);
+
     /* 出力 */
-    ret = writeApp5ToBuff(srcBuff, imageHash, dateHash, destBuff);
+    if(destFile != NULL)
+    {
+        /* 埋め込み後の画像全体をバッファに作成せずにファイルへ書き出す */
+        ret = writeApp5(srcBuff, &index, imageHash, dateHash, &arena, destFile);
+    }
+    else
+    {
+        ret = writeApp5ToBuff(srcBuff, &index, imageHash, dateHash, &arena, destBuff);
+    }
 
 FINALIZE:
 
     /* メモリ解放 */
-    _SECURE_FREE(dateHash);
-    _SECURE_FREE(imageHash);
+    releaseSegmentIndex(&index);
+    arenaRelease(&arena);
 
     /* 戻り値を外部公開用の定数に置き換えて返す */
     return _hashWriteReturnValueConvert(ret);
 }
 
+/*!
+@brief 指定されたバイト配列に改ざんチェック値を埋め込んだバイト配列を返す。
+
+@param [in] srcBuff 改ざんチェック値を埋め込む対象のバッファ
+@param [in] prehashed 読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [out] destBuff 改ざんチェック値を埋めんだ状態を受け付けるバッファ
+@return _writeHashValue と同じ
+*/
+int _writeHashValueToBuffer(JpegBuffer *srcBuff, const PrehashedImage *prehashed, JpegBuffer **destBuff)
+{
+    if(destBuff == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    return _writeHashValue(srcBuff, prehashed, destBuff, NULL);
+}
+
+/*!
+@brief 指定されたバイト配列に改ざんチェック値を埋め込んだ結果をファイルに書き出す。
+@details 書き出しは元データと APP5 セグメントから直接行うため、出力全体のバッファは確保しない。
+
+@param [in] srcBuff 改ざんチェック値を埋め込む対象のバッファ
+@param [in] prehashed 読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [in] destFile 書き出し先のファイルパス
+@return _writeHashValue と同じ
+*/
+int _writeHashValueToFile(JpegBuffer *srcBuff, const PrehashedImage *prehashed, const char *destFile)
+{
+    if(destFile == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    return _writeHashValue(srcBuff, prehashed, NULL, destFile);
+}
+
 /*!
 @brief 画像データを読み込み、画像から再計算したハッシュ値と、既に計算して格納しているハッシュ値を比較した結果を返す。
 @details 望むなら、再計算したハッシュ値を呼び出し元へ返却する。
 @param [in] srcImage 検証対象となる画像データ（改ざん検知情報付与済み）
-@param [out] imageHash srcImage から再計算された画像ハッシュ値（NULL初期化されていること）。呼び出し元で不要ならば NULL を渡す。
-@param [out] dateHash srcImage から再計算された撮影日時ハッシュ値（NULL初期化されていること）。呼び出し元で不要ならば NULL を渡す。
+@param [in] prehashed 読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [out] imageDigest srcImage から再計算された画像ハッシュ値（BYTE_SIZE_HASH_DIGEST バイト）。呼び出し元で不要ならば NULL を渡す。
+@param [out] dateDigest srcImage から再計算された撮影日時ハッシュ値（BYTE_SIZE_HASH_DIGEST バイト）。呼び出し元で不要ならば NULL を渡す。
 @retval SAME_HASH ハッシュ値が正しい
 @retval INCORRECT_HASH_IMAGE ハッシュ値（画像）が正しくない
 @retval INCORRECT_HASH_DATE ハッシュ値（撮影日時）が正しくない
@@ -776,66 +1296,374 @@ FINALIZE:
 @retval DATE_NOT_EXISTS 検証対象の画像に日時情報が見つからない
 @retval OTHER_ERROR メモリ確保に失敗した場合などその他のエラー
 */
-int _validateImage(JpegBuffer *srcImage, HashBuffer **imageHash, HashBuffer **dateHash)
+int _validateImage(JpegBuffer *srcImage, const PrehashedImage *prehashed, unsigned char *imageDigest, unsigned char *dateDigest)
 {
     int ret;
 
-    HashBuffer *generatedImageHash = NULL;
-    HashBuffer *generatedDateHash = NULL;
+    unsigned char generatedImageDigest[BYTE_SIZE_HASH_DIGEST];
+    unsigned char generatedDateDigest[BYTE_SIZE_HASH_DIGEST];
 
-    APP5Item app5ImageHash = {JACIC_BOOL_FALSE, NULL};
-    APP5Item app5DateHash = {JACIC_BOOL_FALSE, NULL};
+    APP5Item app5ImageHash = {JACIC_BOOL_FALSE, {NULL, 0}};
+    APP5Item app5DateHash = {JACIC_BOOL_FALSE, {NULL, 0}};
+
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+
+    Arena arena;
+    unsigned char arenaBuff[BYTE_SIZE_ARENA_BLOCK];
 
     if(srcImage == NULL) return INCORRECT_PARAMETER;
     if(srcImage->_len == 0) return FILE_SIZE_ZERO;
 
+    /* この呼び出しの間だけ使用する一時領域は、すべてアリーナから割り当てる */
+    arenaInit(&arena, arenaBuff, sizeof(arenaBuff));
+
+    /* 以降の解析で共通に参照するセグメント索引を作成する */
+    ret = buildSegmentIndex(srcImage, &index, &arena);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
     /* 画像の APP5 セグメント内のハッシュ値を確認、取得 */
-    ret = getAPP5HashValue(srcImage, &app5ImageHash, &app5DateHash);
+    ret = getAPP5HashValue(srcImage, &index, &app5ImageHash, &app5DateHash);
     if(ret != FUNCTION_SUCCESS) goto FINALIZE;
 
-    /* 原本画像から再計算したハッシュ値 2 種類を取得 */
-    ret = _generateHashes(srcImage, &generatedImageHash, &generatedDateHash);
-    if(ret != FUNCTION_SUCCESS)
+    /* 画像から再計算したハッシュ値 2 種類を取得 */
+    ret = _generateHashes(srcImage, &index, prehashed, generatedImageDigest, generatedDateDigest, &arena);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    /* 画像に埋め込まれているハッシュ値と先ほど計算したハッシュ値が等しいか検証する */
+    ret = _compareHashValues(app5ImageHash, generatedImageDigest, app5DateHash, generatedDateDigest);
+    if(ret != SAME_HASH) goto FINALIZE;
+
+    /* 呼び出し元がハッシュの抽出を求めているならば、再計算したハッシュをコピーして関数呼び出し元に返す */
+    if(imageDigest != NULL)
     {
-        goto FINALIZE;
+        memcpy(imageDigest, generatedImageDigest, BYTE_SIZE_HASH_DIGEST);
     }
-    /* 原本画像に埋め込まれているハッシュ値と先ほど計算したハッシュ値が等しいか検証する */
-    ret = _compareHashValues(app5ImageHash, generatedImageHash, app5DateHash, generatedDateHash);
-    if(ret != SAME_HASH) goto FINALIZE;
+    if(dateDigest != NULL)
+    {
+        memcpy(dateDigest, generatedDateDigest, BYTE_SIZE_HASH_DIGEST);
+    }
+
+FINALIZE:
 
-    /* 呼び出し元が画像ハッシュの抽出を求めているならば */
-    if(imageHash != NULL)
+    /* メモリ解放（セグメント索引を含め、アリーナから割り当てた領域をまとめて解放する） */
+    releaseSegmentIndex(&index);
+    arenaRelease(&arena);
+
+    return ret;
+}
+
+/*!
+@brief _validateImage の戻り値を、原本画像または黒板画像のエラーとして情報を付け足した値に置き換える。
+@param retval _validateImage の戻り値
+@param isOriginal 原本画像の検証結果であれば JACIC_BOOL_TRUE 、黒板画像であれば JACIC_BOOL_FALSE
+@return 置き換えた戻り値（対象外の値はそのまま返す）
+*/
+int _validateResultToSVGError(int retval, JACIC_BOOL isOriginal)
+{
+    switch(retval)
     {
-        /* 画像ハッシュをコピーして関数呼び出し元に返す */
-        copyBinaryDataToBinaryData(generatedImageHash, imageHash);
-        if(*imageHash == NULL)
-        {
-            ret = OTHER_ERROR;
-            goto FINALIZE;
-        }
+        case APP5_NOT_EXISTS:
+        case HASH_NOT_EXISTS:
+        case INCORRECT_EXIF_FORMAT:
+        case INCORRECT_APP5_FORMAT:
+            return isOriginal == JACIC_BOOL_TRUE ? ORG_DOES_NOT_HAVE_HASH : CB_DOES_NOT_HAVE_HASH;
+
+        case INCORRECT_HASH_IMAGE:
+            return isOriginal == JACIC_BOOL_TRUE ? ORG_HASH_NG_IMAGE : CB_HASH_NG_IMAGE;
+
+        case INCORRECT_HASH_DATE:
+        case INCORRECT_APP1_FORMAT:
+        case DATE_NOT_EXISTS:
+            return isOriginal == JACIC_BOOL_TRUE ? ORG_HASH_NG_DATE : CB_HASH_NG_DATE;
+
+        case INCORRECT_HASH_BOTH:
+            return isOriginal == JACIC_BOOL_TRUE ? ORG_HASH_NG_BOTH : CB_HASH_NG_BOTH;
     }
 
-    /* 呼び出し元が撮影日時ハッシュの抽出を求めているならば */
-    if(dateHash != NULL)
+    return retval;
+}
+
+#if !defined(_MSC_VER) && !defined(JCOMSIA_DISABLE_PARALLEL_SVG_VALIDATION)
+#define PARALLEL_SVG_VALIDATION                         /*!< @brief 原本画像と黒板画像を別のスレッドで同時に検証する */
+#endif
+
+#if defined(PARALLEL_SVG_VALIDATION)
+
+/*!
+@struct ImageValidation
+@brief ワーカースレッドで検証する 1 枚分の画像
+*/
+typedef struct
+{
+    JpegBuffer *_image;                 /*!< @brief 検証対象の画像 */
+    const PrehashedImage *_prehashed;   /*!< @brief 読み込みと並行して計算済みの画像ハッシュ値（計算済みでない場合は NULL ） */
+    unsigned char *_imageDigest;        /*!< @brief 再計算した画像ハッシュ値の格納先 */
+    unsigned char *_dateDigest;         /*!< @brief 再計算した撮影日時ハッシュ値の格納先 */
+    int _result;                        /*!< @brief 検証結果（_validateImage の戻り値） */
+} ImageValidation;
+
+/*!
+@brief 画像 1 枚の検証をワーカースレッドで行う。
+@param [in, out] arg 検証対象 (ImageValidation)
+@return 常に NULL
+*/
+static void *_runImageValidation(void *arg)
+{
+    ImageValidation *validation = (ImageValidation *)arg;
+
+    validation->_result = _validateImage(validation->_image, validation->_prehashed, validation->_imageDigest, validation->_dateDigest);
+
+    return NULL;
+}
+
+/*!
+@struct PairValidationWorker
+@brief 黒板画像を検証する常駐のワーカースレッドの状態（ pairWorkerMutex で保護する）
+*/
+typedef struct
+{
+    JACIC_BOOL _started;                /*!< @brief スレッドの作成を試みたか（ fork した子プロセスでは JACIC_BOOL_FALSE に戻す） */
+    JACIC_BOOL _available;              /*!< @brief スレッドを作成できたか */
+    JACIC_BOOL _keyCreated;             /*!< @brief inlineValidationKey を作成できたか（ pairWorkerOnce の後は変更しない） */
+    JACIC_BOOL _busy;                   /*!< @brief 検証を依頼されてから、依頼元が結果を受け取るまでの間か */
+    JACIC_BOOL _done;                   /*!< @brief 依頼された検証が終わったか */
+    ImageValidation *_validation;       /*!< @brief 検証を依頼された画像（依頼されていない場合は NULL ） */
+} PairValidationWorker;
+
+/*!
+@brief 黒板画像を検証する常駐のワーカースレッド
+*/
+static PairValidationWorker pairWorker = { JACIC_BOOL_FALSE, JACIC_BOOL_FALSE, JACIC_BOOL_FALSE, JACIC_BOOL_FALSE, JACIC_BOOL_FALSE, NULL };
+
+/*!
+@brief pairWorker を保護するミューテックス
+*/
+static pthread_mutex_t pairWorkerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*!
+@brief 検証を依頼したことを通知する条件変数
+*/
+static pthread_cond_t pairWorkerRequested = PTHREAD_COND_INITIALIZER;
+
+/*!
+@brief 依頼された検証が終わったことを通知する条件変数
+*/
+static pthread_cond_t pairWorkerFinished = PTHREAD_COND_INITIALIZER;
+
+/*!
+@brief inlineValidationKey の作成と fork 時の処理の登録を 1 回だけ行うための制御変数
+*/
+static pthread_once_t pairWorkerOnce = PTHREAD_ONCE_INIT;
+
+/*!
+@brief 値が NULL 以外のスレッドでは、ワーカースレッドに分担させずに 2 枚を順に検証する
+*/
+static pthread_key_t inlineValidationKey;
+
+/*!
+@brief 依頼された黒板画像の検証を繰り返し行う。
+@param arg 未使用
+@return 返らない
+*/
+static void *_runPairWorker(void *arg)
+{
+    ImageValidation *validation;
+
+    (void) arg;
+
+    pthread_mutex_lock(&pairWorkerMutex);
+    for(;;)
     {
-        /* 撮影日時ハッシュをコピーして関数呼び出し元に返す */
-        copyBinaryDataToBinaryData(generatedDateHash, dateHash);
-        if(*dateHash == NULL)
+        while(pairWorker._validation == NULL)
         {
-            ret = OTHER_ERROR;
-            goto FINALIZE;
+            pthread_cond_wait(&pairWorkerRequested, &pairWorkerMutex);
         }
+
+        validation = pairWorker._validation;
+
+        pthread_mutex_unlock(&pairWorkerMutex);
+        _runImageValidation(validation);
+        pthread_mutex_lock(&pairWorkerMutex);
+
+        pairWorker._validation = NULL;
+        pairWorker._done = JACIC_BOOL_TRUE;
+        pthread_cond_signal(&pairWorkerFinished);
     }
 
-FINALIZE:
-    /* メモリ解放 */
-    _SECURE_FREE(generatedImageHash);
-    _SECURE_FREE(generatedDateHash);
+    /* ここには到達しない */
+    pthread_mutex_unlock(&pairWorkerMutex);
 
-    _SECURE_FREE(app5ImageHash.value);
-    _SECURE_FREE(app5DateHash.value);
+    return NULL;
+}
 
-    return ret;
+/*!
+@brief fork の前に pairWorkerMutex を取得し、子プロセスに複製される pairWorker の状態を確定させる。
+*/
+static void _prepareForkPairWorker(void)
+{
+    pthread_mutex_lock(&pairWorkerMutex);
+}
+
+/*!
+@brief fork の後、親プロセスで pairWorkerMutex を解放する。
+*/
+static void _resumePairWorkerInParent(void)
+{
+    pthread_mutex_unlock(&pairWorkerMutex);
+}
+
+/*!
+@brief fork の後、子プロセスで pairWorker を初期状態に戻す。
+@details 子プロセスには fork を呼び出したスレッドのみが複製され、ワーカースレッドは存在しないため、
+次の検証で作成し直す。条件変数は待機中だったワーカースレッドの状態を含む可能性があるため初期化し直す。
+*/
+static void _resetPairWorkerInChild(void)
+{
+    pairWorker._started = JACIC_BOOL_FALSE;
+    pairWorker._available = JACIC_BOOL_FALSE;
+    pairWorker._busy = JACIC_BOOL_FALSE;
+    pairWorker._done = JACIC_BOOL_FALSE;
+    pairWorker._validation = NULL;
+
+    pthread_cond_init(&pairWorkerRequested, NULL);
+    pthread_cond_init(&pairWorkerFinished, NULL);
+
+    pthread_mutex_unlock(&pairWorkerMutex);
+}
+
+/*!
+@brief inlineValidationKey を作成し、fork 時の処理を登録する（ pairWorkerOnce で 1 回だけ呼び出す）。
+*/
+static void _initPairWorker(void)
+{
+    if(pthread_key_create(&inlineValidationKey, NULL) != 0) return;
+
+    if(pthread_atfork(_prepareForkPairWorker, _resumePairWorkerInParent, _resetPairWorkerInChild) != 0)
+    {
+        /* 子プロセスで作成し直せないため、ワーカースレッドは使用しない */
+        pthread_key_delete(inlineValidationKey);
+        return;
+    }
+
+    pairWorker._keyCreated = JACIC_BOOL_TRUE;
+}
+
+/*!
+@brief 常駐のワーカースレッドをまだ作成していなければ作成する（ pairWorkerMutex を取得して呼び出す）。
+@details プロセッサが 1 つの場合はスレッドを作成しても速くならないため、作成しない。
+*/
+static void _startPairWorker(void)
+{
+    pthread_t thread;
+
+    if(pairWorker._started == JACIC_BOOL_TRUE) return;
+    pairWorker._started = JACIC_BOOL_TRUE;
+
+    if(sysconf(_SC_NPROCESSORS_ONLN) < 2) return;
+    if(pthread_create(&thread, NULL, _runPairWorker, NULL) != 0) return;
+
+    pthread_detach(thread);
+    pairWorker._available = JACIC_BOOL_TRUE;
+}
+
+#endif /* PARALLEL_SVG_VALIDATION */
+
+/*!
+@brief 呼び出し元のスレッドで SVG ファイルの画像 2 枚を順に検証するかを設定する。
+@details 一括処理や処理キューのスレッドはプロセッサ数に合わせて作成しているため、
+そのスレッドで検証する場合は常駐のワーカースレッドに分担させない。
+@param enabled JACIC_BOOL_TRUE の場合は、呼び出し元のスレッドで 2 枚を順に検証する
+*/
+static void _setInlinePairValidation(JACIC_BOOL enabled)
+{
+#if defined(PARALLEL_SVG_VALIDATION)
+    if(pthread_once(&pairWorkerOnce, _initPairWorker) != 0 || pairWorker._keyCreated == JACIC_BOOL_FALSE) return;
+
+    pthread_setspecific(inlineValidationKey, enabled == JACIC_BOOL_TRUE ? &pairWorker : NULL);
+#else
+    (void) enabled;
+#endif
+}
+
+/*!
+@brief 原本画像と黒板画像を、呼び出し元のスレッドで順に検証する。
+@param [in] images 原本画像、黒板画像の順に並べた配列
+@param [in] prehashedImages 原本画像、黒板画像の順に読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [out] imageDigests 再計算した画像ハッシュ値の配列（2 * BYTE_SIZE_HASH_DIGEST バイト）
+@param [out] dateDigests 再計算した撮影日時ハッシュ値の配列（2 * BYTE_SIZE_HASH_DIGEST バイト）
+@param [out] results 画像ごとの検証結果（_validateImage の戻り値）
+*/
+static void _validateImagesInline(JpegBuffer **images, const PrehashedImage *prehashedImages, unsigned char *imageDigests, unsigned char *dateDigests, int *results)
+{
+    size_t i;
+
+    for(i = 0; i < 2; ++i)
+    {
+        results[i] = _validateImage(images[i], prehashedImages != NULL ? &prehashedImages[i] : NULL,
+                                    imageDigests + i * BYTE_SIZE_HASH_DIGEST, dateDigests + i * BYTE_SIZE_HASH_DIGEST);
+    }
+}
+
+/*!
+@brief 原本画像と黒板画像の検証を行い、4 種類のハッシュ値をまとめて取得する。
+@details 常駐のワーカースレッドが空いている場合は、黒板画像をワーカースレッドで、原本画像を呼び出し元のスレッドで同時に検証する。
+ワーカースレッドがない場合、他の検証で使用中の場合、一括処理や処理キューのスレッドから呼び出された場合 ( _setInlinePairValidation ) は、
+呼び出し元のスレッドで 2 枚を順に検証する。どちらの場合も結果は images と同じ順に格納する。
+ワーカースレッドは最初に依頼する際に作成する。fork した子プロセスでは複製されないため、子プロセスで最初に依頼する際に作成し直す。
+@param [in] images 原本画像、黒板画像の順に並べた配列
+@param [in] prehashedImages 原本画像、黒板画像の順に読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
+@param [out] imageDigests 再計算した画像ハッシュ値の配列（2 * BYTE_SIZE_HASH_DIGEST バイト）
+@param [out] dateDigests 再計算した撮影日時ハッシュ値の配列（2 * BYTE_SIZE_HASH_DIGEST バイト）
+@param [out] results 画像ごとの検証結果（_validateImage の戻り値）
+*/
+static void _validateImagePair(JpegBuffer **images, const PrehashedImage *prehashedImages, unsigned char *imageDigests, unsigned char *dateDigests, int *results)
+{
+#if defined(PARALLEL_SVG_VALIDATION)
+    ImageValidation chalkboard;
+
+    if(pthread_once(&pairWorkerOnce, _initPairWorker) != 0 || pairWorker._keyCreated == JACIC_BOOL_FALSE ||
+            pthread_getspecific(inlineValidationKey) != NULL)
+    {
+        _validateImagesInline(images, prehashedImages, imageDigests, dateDigests, results);
+        return;
+    }
+
+    chalkboard._image = images[1];
+    chalkboard._prehashed = prehashedImages != NULL ? &prehashedImages[1] : NULL;
+    chalkboard._imageDigest = imageDigests + BYTE_SIZE_HASH_DIGEST;
+    chalkboard._dateDigest = dateDigests + BYTE_SIZE_HASH_DIGEST;
+    chalkboard._result = FUNCTION_SUCCESS;
+
+    pthread_mutex_lock(&pairWorkerMutex);
+    _startPairWorker();
+    if(pairWorker._available == JACIC_BOOL_FALSE || pairWorker._busy == JACIC_BOOL_TRUE)
+    {
+        /* ワーカースレッドがない場合、他の検証で使用中の場合は呼び出し元のスレッドで順に検証する */
+        pthread_mutex_unlock(&pairWorkerMutex);
+        _validateImagesInline(images, prehashedImages, imageDigests, dateDigests, results);
+        return;
+    }
+    pairWorker._busy = JACIC_BOOL_TRUE;
+    pairWorker._done = JACIC_BOOL_FALSE;
+    pairWorker._validation = &chalkboard;
+    pthread_cond_signal(&pairWorkerRequested);
+    pthread_mutex_unlock(&pairWorkerMutex);
+
+    /* 黒板画像の検証と並行して原本画像を検証する */
+    results[0] = _validateImage(images[0], prehashedImages, imageDigests, dateDigests);
+
+    pthread_mutex_lock(&pairWorkerMutex);
+    while(pairWorker._done == JACIC_BOOL_FALSE)
+    {
+        pthread_cond_wait(&pairWorkerFinished, &pairWorkerMutex);
+    }
+    pairWorker._busy = JACIC_BOOL_FALSE;
+    pthread_mutex_unlock(&pairWorkerMutex);
+
+    results[1] = chalkboard._result;
+#else
+    _validateImagesInline(images, prehashedImages, imageDigests, dateDigests, results);
+#endif
 }
 
 /*!
@@ -843,6 +1671,7 @@ FINALIZE:
 
 @param [in] originalImageBuffer 画像改ざん検知情報付与済みの原本画像のデータ
 @param [in] chalkboardBuffer 画像改ざん検知情報付与済みの黒板画像のデータ
+@param [in] prehashedImages 原本画像、黒板画像の順に読み込みと並行して計算済みの画像ハッシュ値。計算済みでない場合は NULL を渡す。
 @param [out] hashCode 計算したハッシュ値を格納するポインタ
 
 @retval FUNCTION_SUCCESS 正常終了
@@ -861,20 +1690,18 @@ FINALIZE:
 
 @retval OTHER_ERROR その他のエラー（メモリ領域の確保失敗など）
 */
-int _calculateHashValue(JpegBuffer *originalImageBuffer, JpegBuffer *chalkboardBuffer, HashBuffer **hashCode)
+int _calculateHashValue(JpegBuffer *originalImageBuffer, JpegBuffer *chalkboardBuffer, const PrehashedImage *prehashedImages, HashBuffer **hashCode)
 {
-    int ret;
+    int ret = FUNCTION_SUCCESS;
 
-    size_t cursor;
-    size_t combinedHashLength = 0;
+    SHA256Context context;
 
-    HashBuffer *passwordBuffer = NULL;
-    HashBuffer *combinedHash = NULL;
 
-    HashBuffer *originalImageHash = NULL;
-    HashBuffer *originalDateHash = NULL;
-    HashBuffer *chalkboardImageHash = NULL;
-    HashBuffer *chalkboardDateHash = NULL;
+    JpegBuffer *images[2];
+    unsigned char imageDigests[BYTE_SIZE_HASH_DIGEST * 2];
+    unsigned char dateDigests[BYTE_SIZE_HASH_DIGEST * 2];
+    unsigned char digest[BYTE_SIZE_HASH_DIGEST];
+    int results[2];
 
     /* パラメータが不正 */
     if(originalImageBuffer == NULL || chalkboardBuffer == NULL || hashCode == NULL)
@@ -884,121 +1711,511 @@ int _calculateHashValue(JpegBuffer *originalImageBuffer, JpegBuffer *chalkboardB
 
     *hashCode = NULL;
 
-    /* 原本画像に対してハッシュ値の検証を行いながらハッシュ値を取得する */
-    ret = _validateImage(originalImageBuffer, &originalImageHash, &originalDateHash);
-    if(ret != SAME_HASH)
-    {
-        /* 一部の戻り値は情報を付け足して返す */
-        switch(ret)
-        {
-            case APP5_NOT_EXISTS:
-            case HASH_NOT_EXISTS:
-            case INCORRECT_EXIF_FORMAT:
-            case INCORRECT_APP5_FORMAT:
-                ret = ORG_DOES_NOT_HAVE_HASH;
-                break;
-
-            case INCORRECT_HASH_IMAGE:
-                ret = ORG_HASH_NG_IMAGE;
-                break;
+    /* 原本画像と黒板画像に対してハッシュ値の検証を行いながら、4 種類のハッシュ値をまとめて取得する */
+    images[0] = originalImageBuffer;
+    images[1] = chalkboardBuffer;
 
-            case INCORRECT_HASH_DATE:
-            case INCORRECT_APP1_FORMAT:
-            case DATE_NOT_EXISTS:
-                ret = ORG_HASH_NG_DATE;
-                break;
+    _validateImagePair(images, prehashedImages, imageDigests, dateDigests, results);
 
-            case INCORRECT_HASH_BOTH:
-                ret = ORG_HASH_NG_BOTH;
-                break;
-        }
+    /* 原本画像のエラーを優先して、一部の戻り値は情報を付け足して返す */
+    if(results[0] != SAME_HASH)
+    {
+        ret = _validateResultToSVGError(results[0], JACIC_BOOL_TRUE);
         goto FINALIZE;
     }
-
-    /* 黒板画像に対してハッシュ値の検証を行いながらハッシュ値を取得する */
-    ret = _validateImage(chalkboardBuffer, &chalkboardImageHash, &chalkboardDateHash);
-    if(ret != SAME_HASH)
+    if(results[1] != SAME_HASH)
     {
-        /* 一部の戻り値は情報を付け足して返す */
-        switch(ret)
-        {
-            case APP5_NOT_EXISTS:
-            case HASH_NOT_EXISTS:
-            case INCORRECT_EXIF_FORMAT:
-            case INCORRECT_APP5_FORMAT:
-                ret = CB_DOES_NOT_HAVE_HASH;
-                break;
-
-            case INCORRECT_HASH_IMAGE:
-                ret = CB_HASH_NG_IMAGE;
-                break;
-
-            case INCORRECT_HASH_DATE:
-            case INCORRECT_APP1_FORMAT:
-            case DATE_NOT_EXISTS:
-                ret = CB_HASH_NG_DATE;
-                break;
-
-            case INCORRECT_HASH_BOTH:
-                ret = CB_HASH_NG_BOTH;
-                break;
-        }
+        ret = _validateResultToSVGError(results[1], JACIC_BOOL_FALSE);
         goto FINALIZE;
     }
 
-    passwordBuffer = _getPasswordHash();
-
-    /* 各種ハッシュ値と“パスワード”を結合した長さを計算 */
-    combinedHashLength =
-        originalImageHash->_len + originalDateHash->_len +
-        chalkboardImageHash->_len + chalkboardDateHash->_len +
-        passwordBuffer->_len;
-
-    /* 各種ハッシュ値とパスワードを結合する */
-    combinedHash = allocateBinaryData(combinedHashLength);
-    if(combinedHash == NULL)
+    *hashCode = allocateBinaryData(JCOMSIA_HASH_LENGTH);
+    if(*hashCode == NULL)
     {
         ret = OTHER_ERROR;
         goto FINALIZE;
     }
 
-    /* 各種ハッシュを結合 */
-    cursor = 0;
+    /* 各種ハッシュ値とパスワードを結合した値のハッシュを、結合用のバッファを作らずに逐次計算する */
+    sha256Init(&context);
 
     /* オリジナル画像のハッシュを結合 */
-    _appendHash(originalImageHash,   combinedHash, &cursor);
-    _appendHash(originalDateHash,    combinedHash, &cursor);
+    _appendDigest(imageDigests, &context);
+    _appendDigest(dateDigests,  &context);
 
     /* 黒板画像のハッシュを結合 */
-    _appendHash(chalkboardImageHash, combinedHash, &cursor);
-    _appendHash(chalkboardDateHash,  combinedHash, &cursor);
+    _appendDigest(imageDigests + BYTE_SIZE_HASH_DIGEST, &context);
+    _appendDigest(dateDigests + BYTE_SIZE_HASH_DIGEST,  &context);
 
     /* パスワードハッシュを結合 */
-    _appendHash(passwordBuffer, combinedHash, &cursor);
+    sha256Update(&context, PASSWORD_HASH, BYTE_SIZE_HASH_LENGTH);
 
-    *hashCode = allocateBinaryData(JCOMSIA_HASH_LENGTH);
-    if(*hashCode == NULL)
+    /* 結合したハッシュ値の計算（公開する hashCode は 16 進数文字列） */
+    sha256FinalDigest(&context, digest);
+    encodeHex((*hashCode)->_buff, digest, BYTE_SIZE_HASH_DIGEST);
+
+FINALIZE:
+
+    return ret;
+}
+
+/*!
+@brief バイト配列を、ファイルの読み込み結果と同じ形式のバイナリデータ構造体に複製する。
+@param [in] data 複製元のバイト配列
+@param dataLength data のバイト数
+@param [out] buffer 複製したバイナリデータ構造体を格納するポインタ。使い終わったら releaseFileBinaryData で解放すること。
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_PARAMETER 不正な引数が指定された場合
+@retval FILE_SIZE_ZERO dataLength が 0 の場合
+@retval OTHER_ERROR メモリ確保に失敗した場合
+*/
+int _copyToFileBinaryData(const unsigned char *data, size_t dataLength, JpegBuffer **buffer)
+{
+    /* パラメータが不正 */
+    if(data == NULL || buffer == NULL)
+    {
+        return INCORRECT_PARAMETER;
+    }
+
+    if(dataLength == 0)
+    {
+        /* ファイルサイズゼロと同じ扱いとする */
+        return FILE_SIZE_ZERO;
+    }
+
+    *buffer = allocateFileBinaryData(dataLength);
+    if(*buffer == NULL)
+    {
+        /* メモリ確保失敗 */
+        return OTHER_ERROR;
+    }
+
+    memcpy((*buffer)->_buff, data, dataLength);
+
+    return FUNCTION_SUCCESS;
+}
+
+/*!
+@brief 指定された JPEG ファイルのハッシュ値をチェックする。
+@details cache を指定した場合は読み込みスレッドを使用せず、cache の領域に読み込む。
+戻り値は cache の有無によらず同じ値になる。
+@param [in] checkFile 改ざんチェックを行いたいファイル名
+@param [in, out] cache 読み込み先の領域を使い回すためのキャッシュ。読み込みスレッドを使用する場合は NULL
+@return `JCOMSIA_CheckHashValue()` と同じ値
+*/
+int _checkHashValue(const char *checkFile, FileDataCache *cache)
+{
+    int ret;
+    JpegBuffer *readJpegBuffer = NULL;
+    PrehashedImage prehashed;
+    VerificationCacheKey cacheKey;
+
+    /* ファイル読み込みチェック */
+    if(checkFile == NULL)
+    {
+        /* パラメータが不正 */
+        return JC_ERROR_INCORRECT_PARAMETER;
+    }
+
+    /* チェック対象画像ファイルが存在しない場合 */
+    if(_fileExist(checkFile) != FUNCTION_SUCCESS)
+    {
+        return JC_ERROR_READ_FILE_NOT_EXISTS;
+    }
+
+    /* 変更されていないファイルの検証結果が記録されていれば、そのまま返す */
+    if(lookupVerificationCache(checkFile, VERIFICATION_CACHE_KIND_JPEG, &cacheKey, &ret))
+    {
+        return ret;
+    }
+
+    /* チェック対象画像オープン */
+    if(cache != NULL)
+    {
+        /* 複数ファイルの並列処理ではスレッドを追加せず、キャッシュの領域に読み込む */
+        prehashed._hashed = JACIC_BOOL_FALSE;
+        ret = _readFile(checkFile, cache, &readJpegBuffer);
+    }
+    else
+    {
+        ret = _readFileWithImageHash(checkFile, &readJpegBuffer, &prehashed);
+    }
+    if(ret != FUNCTION_SUCCESS)
     {
-        ret = OTHER_ERROR;
         goto FINALIZE;
     }
 
-    /* 結合したハッシュ値の計算 */
-    ret = hash(combinedHash, *hashCode);
+    /* ハッシュ値一致判定 */
+    ret = _validateImage(readJpegBuffer, &prehashed, NULL, NULL);
 
 FINALIZE:
 
     /* メモリ解放 */
-    _SECURE_FREE(originalImageHash);
-    _SECURE_FREE(originalDateHash);
-    _SECURE_FREE(chalkboardImageHash);
-    _SECURE_FREE(chalkboardDateHash);
-    _SECURE_FREE(passwordBuffer);
-    _SECURE_FREE(combinedHash);
+    releaseFileBinaryData(&readJpegBuffer);
+
+    /* 戻り値を外部公開用の定数に置き換え、検証結果キャッシュに記録して返す */
+    ret = _hashCheckReturnValueConvert(ret);
+    storeVerificationCache(checkFile, &cacheKey, ret);
+
+    return ret;
+}
+
+/*!
+@brief `JCOMSIA_SVG_CheckHashValue()` を複数ファイルの並列処理から呼び出すための関数
+@details SVG ファイルは解析時に画像をコピーするため、cache は使用しない。
+@param [in] checkFilePath 改ざんチェックを行いたい SVG ファイル名
+@param [in, out] cache 使用しない
+@return `JCOMSIA_SVG_CheckHashValue()` と同じ値
+*/
+int _svgCheckHashValue(const char *checkFilePath, FileDataCache *cache)
+{
+    (void) cache;
+
+    return JCOMSIA_SVG_CheckHashValue(checkFilePath);
+}
+
+/*!
+@name 複数ファイルの並列処理
+@details ワーカースレッドは処理対象の位置を共有し、1 ファイルずつ取り出して処理する。
+ファイルごとの処理時間に差があっても、先に終わったスレッドが残りを引き受ける。
+呼び出し元のスレッドもワーカーの 1 つとして処理に加わり、スレッドごとに FileDataCache を 1 つ持って読み込み先を使い回す。
+@{
+*/
+
+#if !defined(_MSC_VER) && !defined(JCOMSIA_DISABLE_BATCH_THREADS)
+#define BATCH_THREADS                               /*!< @brief ワーカースレッドを使用する */
+#endif
+
+#define BATCH_THREAD_MAX ((size_t) 64)              /*!< @brief 同時に処理するスレッド数の上限 */
+
+/*!
+@brief 1 ファイルを処理する関数（戻り値は results に格納する値）
+*/
+typedef int (*BatchFunction)(const char *path, FileDataCache *cache);
+
+/*!
+@struct BatchQueue
+@brief ワーカースレッドで共有する処理対象
+*/
+typedef struct
+{
+    BatchFunction _function;    /*!< @brief 1 ファイルを処理する関数 */
+    const char **_paths;        /*!< @brief 処理対象のファイルパス */
+    int *_results;              /*!< @brief 処理結果の格納先 */
+    size_t _count;              /*!< @brief 処理対象のファイル数 */
+    size_t _threadCount;        /*!< @brief 処理するスレッド数（呼び出し元のスレッドを含む） */
+    size_t _next;               /*!< @brief 次に取り出す位置（_mutex で保護する） */
+#if defined(BATCH_THREADS)
+    pthread_mutex_t _mutex;     /*!< @brief 取り出し位置を保護するミューテックス */
+#endif
+} BatchQueue;
+
+/*!
+@brief 処理対象を 1 つ取り出す。
+@param [in, out] queue 処理対象
+@param [out] index 取り出した位置
+@retval JACIC_BOOL_TRUE 取り出した
+@retval JACIC_BOOL_FALSE 全て取り出し済み
+*/
+static JACIC_BOOL _takeBatchItem(BatchQueue *queue, size_t *index)
+{
+    JACIC_BOOL taken = JACIC_BOOL_FALSE;
+
+#if defined(BATCH_THREADS)
+    pthread_mutex_lock(&queue->_mutex);
+#endif
+    if(queue->_next < queue->_count)
+    {
+        *index = queue->_next++;
+        taken = JACIC_BOOL_TRUE;
+    }
+#if defined(BATCH_THREADS)
+    pthread_mutex_unlock(&queue->_mutex);
+#endif
+
+    return taken;
+}
+
+/*!
+@brief 処理対象がなくなるまで 1 ファイルずつ取り出して処理する。
+@param [in, out] arg 処理対象 (BatchQueue)
+@return 常に NULL
+*/
+static void *_runBatchWorker(void *arg)
+{
+    BatchQueue *queue = (BatchQueue *)arg;
+    FileDataCache cache = { NULL, 0, JACIC_BOOL_FALSE };
+    size_t index;
+
+    /* 複数のスレッドで分担する場合は、スレッドをさらに増やさずに検証する */
+    if(1 < queue->_threadCount) _setInlinePairValidation(JACIC_BOOL_TRUE);
+
+    while(_takeBatchItem(queue, &index))
+    {
+        queue->_results[index] = queue->_function(queue->_paths[index], &cache);
+    }
+
+    if(1 < queue->_threadCount) _setInlinePairValidation(JACIC_BOOL_FALSE);
+
+    releaseFileDataCache(&cache);
+
+    return NULL;
+}
+
+/*!
+@brief 同時に処理するスレッド数を決める。
+@param [in] options 動作の指定（ NULL の場合は既定値）
+@param count 処理対象のファイル数
+@return スレッド数（呼び出し元のスレッドを含む。1 以上 count 以下）
+*/
+static size_t _batchThreadCount(const JCOMSIA_BatchOptions *options, size_t count)
+{
+    size_t threadCount = 1;
+
+#if defined(BATCH_THREADS)
+    long processors;
+
+    if(options != NULL && options->threadCount != 0)
+    {
+        threadCount = options->threadCount;
+    }
+    else if((processors = sysconf(_SC_NPROCESSORS_ONLN)) > 0)
+    {
+        threadCount = (size_t) processors;
+    }
+
+    if(BATCH_THREAD_MAX < threadCount) threadCount = BATCH_THREAD_MAX;
+#else
+    (void) options;
+#endif
+
+    if(count < threadCount) threadCount = count;
+
+    return threadCount;
+}
+
+/*!
+@brief 複数のファイルをワーカースレッドで分担して処理する。
+@details スレッドを作成できなかった場合は、作成できたスレッドと呼び出し元のスレッドで処理する。
+@param function 1 ファイルを処理する関数
+@param [in] paths 処理対象のファイルパスの配列
+@param count paths の要素数
+@param [out] results 各ファイルの処理結果を格納する配列
+@param [in] options 動作の指定（ NULL の場合は既定値）
+*/
+void _runBatch(BatchFunction function, const char **paths, size_t count, int *results, const JCOMSIA_BatchOptions *options)
+{
+    BatchQueue queue;
+    size_t threadCount = _batchThreadCount(options, count);
+#if defined(BATCH_THREADS)
+    pthread_t threads[BATCH_THREAD_MAX];
+    size_t created = 0;
+    size_t i;
+#endif
+
+    queue._function = function;
+    queue._paths = paths;
+    queue._results = results;
+    queue._count = count;
+    queue._threadCount = threadCount;
+    queue._next = 0;
+
+#if defined(BATCH_THREADS)
+    if(pthread_mutex_init(&queue._mutex, NULL) != 0)
+    {
+        /* スレッド間で共有できないため、呼び出し元のスレッドのみで処理する */
+        for(i = 0; i < count; i++)
+        {
+            results[i] = function(paths[i], NULL);
+        }
+        return;
+    }
+
+    for(created = 0; created + 1 < threadCount; created++)
+    {
+        if(pthread_create(&threads[created], NULL, _runBatchWorker, &queue) != 0)
+        {
+            /* 作成できたスレッドのみで処理する */
+            break;
+        }
+    }
+
+    _runBatchWorker(&queue);
+
+    for(i = 0; i < created; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&queue._mutex);
+#else
+    (void) threadCount;
+
+    _runBatchWorker(&queue);
+#endif
+}
+
+/*! @} */
+
+/*!
+@name 非同期処理
+@details 公開 API の呼び出しを処理キューに登録し、処理キューのスレッドで実行した結果を呼び出し元の関数に通知する。
+@{
+*/
+
+/*!
+@enum HashJobType
+@brief 非同期に実行する公開 API の種類
+*/
+typedef enum
+{
+    HASH_JOB_WRITE,         /*!< @brief JCOMSIA_WriteHashValue */
+    HASH_JOB_CHECK,         /*!< @brief JCOMSIA_CheckHashValue */
+    HASH_JOB_SVG_CALCULATE, /*!< @brief JCOMSIA_SVG_CalculateHashValue */
+    HASH_JOB_SVG_CHECK      /*!< @brief JCOMSIA_SVG_CheckHashValue */
+} HashJobType;
+
+/*!
+@struct HashJob
+@brief 非同期に実行する処理
+*/
+typedef struct
+{
+    HashJobType _type;                          /*!< @brief 実行する公開 API の種類 */
+    const char *_paths[2];                      /*!< @brief 公開 API に渡すパス（ _buff に複製したもの。使用しない場合は NULL ） */
+    JCOMSIA_CompletionFunc _callback;           /*!< @brief 完了を通知する関数 */
+    JCOMSIA_HashCompletionFunc _hashCallback;   /*!< @brief 完了をハッシュ値とともに通知する関数 */
+    void *_userdata;                            /*!< @brief 通知する関数に渡す値 */
+    char _buff[];                               /*!< @brief パスの複製先 */
+} HashJob;
+
+/*!
+@brief 非同期に実行する処理を作成する。
+@param type 実行する公開 API の種類
+@param [in] path1 公開 API の 1 つ目の引数
+@param [in] path2 公開 API の 2 つ目の引数。使用しない場合は NULL
+@param callback 完了を通知する関数
+@param hashCallback 完了をハッシュ値とともに通知する関数
+@param [in] userdata 通知する関数に渡す値
+@return 作成した処理。メモリが確保できなかった場合は NULL
+*/
+static HashJob *_createHashJob(HashJobType type, const char *path1, const char *path2, JCOMSIA_CompletionFunc callback, JCOMSIA_HashCompletionFunc hashCallback, void *userdata)
+{
+    HashJob *job;
+    size_t length1 = strlen(path1) + 1;
+    size_t length2 = path2 != NULL ? strlen(path2) + 1 : 0;
+
+    job = (HashJob *) allocateMemory(sizeof(HashJob) + length1 + length2);
+    if(job == NULL) return NULL;
+
+    memcpy(job->_buff, path1, length1);
+    job->_paths[0] = job->_buff;
+    job->_paths[1] = NULL;
+    if(path2 != NULL)
+    {
+        memcpy(job->_buff + length1, path2, length2);
+        job->_paths[1] = job->_buff + length1;
+    }
+
+    job->_type = type;
+    job->_callback = callback;
+    job->_hashCallback = hashCallback;
+    job->_userdata = userdata;
+
+    return job;
+}
+
+/*!
+@brief 処理の完了を通知し、処理を解放する。
+@param [in] job 完了した処理
+@param result 公開 API の戻り値
+@param [in] hashCode 計算したハッシュ値（ HASH_JOB_SVG_CALCULATE 以外、または失敗した場合は NULL ）
+*/
+static void _completeHashJob(HashJob *job, int result, const unsigned char *hashCode)
+{
+    if(job->_hashCallback != NULL)
+    {
+        job->_hashCallback(result, hashCode, job->_userdata);
+    }
+    else if(job->_callback != NULL)
+    {
+        job->_callback(result, job->_userdata);
+    }
+
+    releaseMemory(job);
+}
+
+/*!
+@brief 処理キューのスレッドで公開 API を実行し、完了を通知する。
+@param [in] work 実行する処理 (HashJob)
+*/
+static void _runHashJob(void *work)
+{
+    HashJob *job = (HashJob *) work;
+    unsigned char *hashCode = NULL;
+    int result;
+
+    /* 処理キューのスレッドは複数の処理を同時に実行するため、スレッドをさらに増やさずに検証する */
+    _setInlinePairValidation(JACIC_BOOL_TRUE);
+
+    switch(job->_type)
+    {
+    case HASH_JOB_WRITE:
+        result = JCOMSIA_WriteHashValue(job->_paths[0], job->_paths[1]);
+        break;
+
+    case HASH_JOB_CHECK:
+        result = JCOMSIA_CheckHashValue(job->_paths[0]);
+        break;
+
+    case HASH_JOB_SVG_CALCULATE:
+        result = JCOMSIA_SVG_CalculateHashValue(job->_paths[0], job->_paths[1], &hashCode);
+        break;
+
+    case HASH_JOB_SVG_CHECK:
+    default:
+        result = JCOMSIA_SVG_CheckHashValue(job->_paths[0]);
+        break;
+    }
+
+    _setInlinePairValidation(JACIC_BOOL_FALSE);
+
+    _completeHashJob(job, result, hashCode);
+    JCOMSIA_SVG_FreeHashValue(&hashCode);
+}
+
+/*!
+@brief 取り消された処理の完了を JQ_ERROR_CANCELLED として通知する。
+@param [in] work 取り消された処理 (HashJob)
+*/
+static void _cancelHashJob(void *work)
+{
+    _completeHashJob((HashJob *) work, JQ_ERROR_CANCELLED, NULL);
+}
+
+/*!
+@brief 処理を処理キューに登録する。登録できなかった場合は通知せずに解放する。
+@param [in] job 登録する処理（ NULL の場合はメモリ確保の失敗として扱う）
+@param [out] jobId 登録した処理の識別番号。不要な場合は NULL
+@return submitWork と同じ値（ job が NULL の場合は OTHER_ERROR ）
+*/
+static int _submitHashJob(HashJob *job, JCOMSIA_JobId *jobId)
+{
+    int ret;
+
+    if(job == NULL) return OTHER_ERROR;
+
+    ret = submitWork(_runHashJob, _cancelHashJob, job, jobId);
+    if(ret != FUNCTION_SUCCESS)
+    {
+        releaseMemory(job);
+    }
 
     return ret;
 }
 
+/*! @} */
+
 /*!
 @brief 指定された JPEG ファイルに改ざんチェック値を埋め込んだファイルを出力する。
 @details sourceFile と destFile には同じファイルを設定できない。
@@ -1030,7 +2247,7 @@ int WINAPI JCOMSIA_WriteHashValue(const char *sourceFile, const char *destFile)
 {
     int ret = JW_SUCCESS;
     JpegBuffer *srcJpegBuffer = NULL;
-    JpegBuffer *destJpegBuffer = NULL;
+    PrehashedImage prehashed;
 
     /* パラメータが不正 */
     if(sourceFile == NULL || destFile == NULL)
@@ -1050,42 +2267,523 @@ int WINAPI JCOMSIA_WriteHashValue(const char *sourceFile, const char *destFile)
         return JW_ERROR_READ_FILE_NOT_EXISTS;
     }
 
-    /* 出力先画像ファイルが既に存在する場合 */
-    if(_fileExist(destFile) == FUNCTION_SUCCESS)
+    /* 出力先画像ファイルが既に存在する場合 */
+    if(_fileExist(destFile) == FUNCTION_SUCCESS)
+    {
+        return JW_ERROR_WRITE_FILE_ALREADY_EXISTS;
+    }
+
+    /* ファイルオープン */
+    ret = _readFileWithImageHash(sourceFile, &srcJpegBuffer, &prehashed);
+    if(ret != FUNCTION_SUCCESS)
+    {
+        goto FINALIZE;
+    }
+
+    /* 出力（埋め込み後の画像全体はメモリ上に作成しない） */
+    ret = _writeHashValueToFile(srcJpegBuffer, &prehashed, destFile);
+
+FINALIZE:
+
+    /* メモリ解放 */
+    releaseFileBinaryData(&srcJpegBuffer);
+
+    /* 戻り値を外部公開用の定数に置き換えて返す */
+    return _hashWriteReturnValueConvert(ret);
+}
+
+/*!
+@brief 指定された JPEG ファイルに正しい改ざんチェック値が設定されているかを確認する。
+@param [in] checkFile チェック対象のファイル名
+
+@retval JC_OK                                 1 : ハッシュ値が一致した
+@retval JC_NG                                 0 : ハッシュ値（画像、撮影日時の両方）が一致しない
+@retval JC_NG_IMAGE                          -1 : ハッシュ値（画像）が一致しない
+@retval JC_NG_DATE                           -2 : ハッシュ値（撮影日時）が一致しない
+
+@retval JC_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+
+@retval JC_ERROR_READ_FILE_NOT_EXISTS      -201 : 読込元画像ファイルが存在しない
+@retval JC_ERROR_READ_FILE_OPEN_FAILED     -203 : ファイルオープン失敗
+@retval JC_ERROR_READ_FILE_SIZE_ZERO       -204 : 読み込んだファイルサイズがゼロ
+@retval JC_ERROR_FILE_CLOSE_FAILED         -206 : ファイルのクローズに失敗
+
+@retval JC_ERROR_INCORRECT_EXIF_FORMAT     -301 : Exif フォーマットが不正
+@retval JC_ERROR_APP5_NOT_EXISTS           -303 : APP5 領域が見つからない
+@retval JC_ERROR_INCORRECT_APP5_FORMAT     -304 : APP5 領域の記述形式が異なる
+@retval JC_ERROR_HASH_NOT_EXISTS           -305 : ハッシュ値が設定されていない
+@retval JC_ERROR_DATE_NOT_EXISTS           -307 : checkFile に日時情報が見つからない
+
+@retval JC_ERROR_OTHER                     -900 : その他のエラー
+
+@since 1.0
+*/
+int WINAPI JCOMSIA_CheckHashValue(const char *checkFile)
+{
+    return _checkHashValue(checkFile, NULL);
+}
+
+/*!
+@brief 原本画像と黒板画像から SVG 画像に埋め込むための改ざん検知情報を計算する。
+@details hashCode は処理が成功した際にメモリ領域が確保されるため、必要に応じて手動で解放する必要がある。
+hashCode の長さは `JCOMSIA_HASH_LENGTH` を参照。
+
+@param [in] originalImagePath 画像改ざん検知情報付与済みの原本画像のパス
+@param [in] chalkboardPath 画像改ざん検知情報付与済みの黒板画像のパス
+@param [out] hashCode 計算したハッシュ値を格納するポインタ。NULL 終端されない。途中で処理が失敗した場合は NULL を返す。
+
+@retval JW_HASHER_CREATE_SUCCESS                   0 : 正常終了
+
+@retval JW_HASHER_ERROR_INCORRECT_PARAMETER     -101 : 引数に NULL を渡された等、引数指定に不備がある場合
+
+@retval JW_HASHER_ERROR_FILE_DOES_NOT_EXIST     -201 : 読み込み元ファイルが存在しない
+@retval JW_HASHER_ERROR_FILE_OPEN_FAILED        -203 : ファイルオープン失敗
+@retval JW_HASHER_ERROR_FILE_SIZE_ZERO          -204 : 読み込んだファイルサイズがゼロ
+@retval JW_HASHER_ERROR_FILE_CLOSE_FAILED       -206 : ファイルクローズ失敗
+
+@retval JW_HASHER_ERROR_ORG_DOES_NOT_HAVE_HASH  -351 : 原本画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_HASHER_ERROR_ORG_HASH_NG_IMAGE       -352 : 原本画像のハッシュ値（画像）が正しくない
+@retval JW_HASHER_ERROR_ORG_HASH_NG_DATE        -353 : 原本画像のハッシュ値（撮影日時）が正しくない
+@retval JW_HASHER_ERROR_ORG_HASH_NG_BOTH        -354 : 原本画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_HASHER_ERROR_CB_DOES_NOT_HAVE_HASH   -361 : 黒板画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_HASHER_ERROR_CB_HASH_NG_IMAGE        -362 : 黒板画像のハッシュ値（画像）が正しくない
+@retval JW_HASHER_ERROR_CB_HASH_NG_DATE         -363 : 黒板画像のハッシュ値（撮影日時）が正しくない
+@retval JW_HASHER_ERROR_CB_HASH_NG_BOTH         -364 : 黒板画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_HASHER_ERROR_OTHERS                  -900 : その他のエラー（メモリ領域の確保失敗など）
+
+@since 3.0
+*/
+int WINAPI JCOMSIA_SVG_CalculateHashValue(const char *originalImagePath, const char *chalkboardPath, unsigned char **hashCode)
+{
+    int ret;
+
+    JpegBuffer *originalImageBuffer = NULL;
+    JpegBuffer *chalkBoardBuffer = NULL;
+    PrehashedImage prehashedImages[2];
+
+    HashBuffer *returnHashCode = NULL;
+
+    /* パラメータが不正 */
+    if(originalImagePath == NULL || chalkboardPath == NULL || hashCode == NULL)
+    {
+        return JW_HASHER_ERROR_INCORRECT_PARAMETER;
+    }
+
+    *hashCode = NULL;
+
+    /* 画像ファイルが存在しない場合 */
+    if(_fileExist(originalImagePath) != FUNCTION_SUCCESS ||
+            _fileExist(chalkboardPath) != FUNCTION_SUCCESS)
+    {
+        return JW_HASHER_ERROR_FILE_DOES_NOT_EXIST;
+    }
+
+    ret = _readFileWithImageHash(originalImagePath, &originalImageBuffer, &prehashedImages[0]);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    ret = _readFileWithImageHash(chalkboardPath, &chalkBoardBuffer, &prehashedImages[1]);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    /* ハッシュ値の算出を行う */
+    ret = _calculateHashValue(originalImageBuffer, chalkBoardBuffer, prehashedImages, &returnHashCode);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    /* 最終的な結果を受け取る引数にコピーする */
+    *hashCode = malloc(returnHashCode->_len);
+    if(*hashCode == NULL)
+    {
+        ret = OTHER_ERROR;
+        goto FINALIZE;
+    }
+
+    memcpy(*hashCode, returnHashCode->_buff, returnHashCode->_len);
+
+FINALIZE:
+
+    /* メモリ解放 */
+    releaseFileBinaryData(&originalImageBuffer);
+    releaseFileBinaryData(&chalkBoardBuffer);
+    _SECURE_RELEASE(returnHashCode);
+
+    return _createHashReturnValueConvert(ret);
+}
+
+#if !defined(JCOMSIA_DISABLE_STREAMING_SVG_CHECK)
+#define STREAMING_SVG_CHECK                             /*!< @brief SVG ファイル内の画像を逐次処理して検証する */
+#endif
+
+/*!
+@brief SVG ファイルを解析し、メタデータ内に含まれる hashCode と原本画像 + 黒板画像で再計算したハッシュ値が等しいかを調べる。
+@param [in] checkFilePath 処理対象となる SVG ファイルのパス
+@param streaming JACIC_BOOL_TRUE の場合は画像を逐次処理し (parseWithImageHash) 、画像全体をメモリ上に展開しない。
+@param [out] unsupported 逐次処理できない記述を検出した場合は JACIC_BOOL_TRUE 、それ以外の場合は JACIC_BOOL_FALSE
+（ JACIC_BOOL_TRUE の場合の戻り値は JC_SVG_ERROR_OTHERS ）
+@return `JCOMSIA_SVG_CheckHashValue()` と同じ値
+*/
+static int _checkSVGFile(const char *checkFilePath, JACIC_BOOL streaming, JACIC_BOOL *unsupported)
+{
+    int ret, cmpResult;
+    SVGResult svgResult;
+
+    JpegBuffer *originalImageBuffer = NULL;
+    JpegBuffer *chalkboardBuffer = NULL;
+    HashBuffer *svgHashCode = NULL;
+    HashBuffer *recalculatedHashCode = NULL;
+    PrehashedImage prehashedImages[2];
+    const PrehashedImage *prehashed = NULL;
+
+    *unsupported = JACIC_BOOL_FALSE;
+
+    /* SVG ファイルの解析 */
+    if(streaming == JACIC_BOOL_TRUE)
+    {
+        svgResult = parseWithImageHash(checkFilePath, &originalImageBuffer, &chalkboardBuffer, &svgHashCode, prehashedImages);
+        prehashed = prehashedImages;
+    }
+    else
+    {
+        svgResult = parse(checkFilePath, &originalImageBuffer, &chalkboardBuffer, &svgHashCode);
+    }
+    if(svgResult == SVG_STREAMING_UNSUPPORTED)
+    {
+        *unsupported = JACIC_BOOL_TRUE;
+        ret = JC_SVG_ERROR_OTHERS;
+        goto FINALIZE;
+    }
+    if(svgResult != SVG_SUCCESS)
+    {
+        ret = _svgResultToPublicErrorCode(svgResult);
+        goto FINALIZE;
+    }
+    assert(originalImageBuffer != NULL);
+
+    if(chalkboardBuffer == NULL)
+    {
+        /* 原本画像のみ取得できた場合、原本画像に対して従来のハッシュチェックを行った値を返す */
+        ret = _validateImage(originalImageBuffer, prehashed, NULL, NULL);
+        ret = _hashCheckReturnValueConvert(ret);
+        goto FINALIZE;
+    }
+
+    /* ハッシュ値算出 */
+    ret = _calculateHashValue(originalImageBuffer, chalkboardBuffer, prehashed, &recalculatedHashCode);
+    if(ret != FUNCTION_SUCCESS)
+    {
+        ret = _svgHashCheckReturnValueConvert(ret);
+        goto FINALIZE;
+    }
+    assert(recalculatedHashCode != NULL);
+
+    if(svgHashCode->_len != recalculatedHashCode->_len)
+    {
+        ret = JC_SVG_RESULT_NG_COMBINATION;
+        goto FINALIZE;
+    }
+
+    cmpResult = compareConstantTime(svgHashCode->_buff, recalculatedHashCode->_buff, svgHashCode->_len);
+    if(cmpResult != 0)
+    {
+        ret = JC_SVG_RESULT_NG_COMBINATION;
+        goto FINALIZE;
+    }
+    ret = JC_SVG_RESULT_OK;
+
+FINALIZE:
+
+    /* メモリ解放 */
+    _SECURE_RELEASE(originalImageBuffer);
+    _SECURE_RELEASE(chalkboardBuffer);
+    _SECURE_RELEASE(svgHashCode);
+    _SECURE_RELEASE(recalculatedHashCode);
+
+    return ret;
+}
+
+/*!
+@brief SVG ファイルが改ざんされているものか検証を行う。
+@details メタデータ内に含まれる hashCode と、
+原本画像 + 黒板画像で再計算したハッシュ値が等しいかを調べる。
+
+もし SVG ファイル内に黒板画像が含まれていない場合、
+原本画像単体に対して `JACIC_CheckHashValue` 関数を呼び出したときと同じ値を返す。
+
+@param checkFilePath 処理対象となる SVG ファイルのパス
+
+@retval JC_SVG_RESULT_OK                                   1 : 改ざん無し
+@retval JC_SVG_RESULT_NG_COMBINATION                      -3 : 原本画像と黒板画像の組み合わせが正しくない
+
+@retval JC_SVG_ERROR_ORG_DOES_NOT_EXIST                  -21 : SVG内に原本画像が存在しない
+@retval JC_SVG_ERROR_ORG_DOES_NOT_HAVE_HASH              -22 : 原本画像からハッシュ値を取得できなかった
+@retval JC_SVG_ERROR_NG_ORG_IMAGE                        -23 : 原本画像の画像ハッシュが不正または計算不能
+@retval JC_SVG_ERROR_NG_ORG_DATE                         -24 : 原本画像の撮影日時ハッシュが不正または計算不能
+@retval JC_SVG_ERROR_NG_ORG_BOTH                         -25 : 原本画像の画像ハッシュおよび撮影日時ハッシュの両方が不正または計算不能
+
+@retval JC_SVG_ERROR_CB_DOES_NOT_EXIST                   -41 : SVG内に合成ハッシュ値が含まれているが、黒板画像が存在しない
+@retval JC_SVG_ERROR_CB_DOES_NOT_HAVE_HASH               -42 : 黒板画像からハッシュ値を取得できなかった
+@retval JC_SVG_ERROR_NG_CB_IMAGE                         -43 : 黒板画像の画像ハッシュが不正または計算不能
+@retval JC_SVG_ERROR_NG_CB_DATE                          -44 : 黒板画像の撮影日時ハッシュが不正または計算不能
+@retval JC_SVG_ERROR_NG_CB_BOTH                          -45 : 黒板画像の画像ハッシュおよび撮影日時ハッシュの両方が不正または計算不能
+
+@retval JC_SVG_ERROR_BROKEN_STRUCTURE                    -61 : SVGの構成が壊れている
+
+@retval JC_SVG_ERROR_METADATA_BROKEN_STRUCTURE           -81 : メタデータの構成が壊れている
+@retval JC_SVG_ERROR_METADATA_INCORRECT_VENDER           -82 : メタデータ「ベンダー名」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_SOFTWARE         -83 : メタデータ「ソフトウェア名」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_FORMAT_VERSION   -84 : メタデータ「メタデータバージョン」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_STANDARD_VERSION -85 : メタデータ「適用基準バージョン」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_HASHCODE         -86 : メタデータ「ハッシュコード」に問題あり
+
+@retval JC_SVG_ERROR_INCORRECT_PARAMETER                -100 : NULLなど不正な引数が渡された
+@retval JC_SVG_ERROR_OTHERS                             -900 : メモリ確保失敗などの予期せぬエラー
+
+@since 3.0
+*/
+int WINAPI JCOMSIA_SVG_CheckHashValue(const char *checkFilePath)
+{
+    int ret;
+    VerificationCacheKey cacheKey;
+    JACIC_BOOL unsupported = JACIC_BOOL_TRUE;
+
+    /* パラメータが不正 */
+    if(checkFilePath == NULL)
+    {
+        return JC_SVG_ERROR_INCORRECT_PARAMETER;
+    }
+
+    /* チェック対象画像ファイルが存在しない場合 */
+    if(_fileExist(checkFilePath) != FUNCTION_SUCCESS)
+    {
+        return JC_ERROR_READ_FILE_NOT_EXISTS;
+    }
+
+    /* 変更されていないファイルの検証結果が記録されていれば、そのまま返す */
+    if(lookupVerificationCache(checkFilePath, VERIFICATION_CACHE_KIND_SVG, &cacheKey, &ret))
+    {
+        return ret;
+    }
+
+#if defined(STREAMING_SVG_CHECK)
+    /*
+     画像を逐次処理して検証する（改ざんを検出した場合も、画像全体をデコードした場合と同じ値を返す）
+     逐次処理できない記述を検出した場合のみ、従来どおり画像全体をデコードして検証し直す
+     */
+    ret = _checkSVGFile(checkFilePath, JACIC_BOOL_TRUE, &unsupported);
+#endif
+    if(unsupported == JACIC_BOOL_TRUE)
+    {
+        ret = _checkSVGFile(checkFilePath, JACIC_BOOL_FALSE, &unsupported);
+    }
+
+    /* 検証結果キャッシュに記録する（ SVG ファイル全体の結果のため、ハッシュ値は記録しない） */
+    storeVerificationCache(checkFilePath, &cacheKey, ret);
+
+    return ret;
+}
+
+/*!
+@brief `JCOMSIA_SVG_CalculateHashValue()` 関数によって確保されたメモリ領域を解放する。
+@details 解放されたポインタには NULL が設定される。
+@attention 動作の安全性のため、本ライブラリによって確保されたメモリ領域以外を指すポインタを引数として与えないこと。
+
+@param [out] ptr メモリ解放の対象となるポインタの参照。処理後は `NULL` ポインタを指すように設定される。
+
+@since 3.1
+*/
+void WINAPI JCOMSIA_SVG_FreeHashValue(unsigned char **ptr)
+{
+    if(ptr == NULL) return;
+
+    _SECURE_FREE(*ptr);
+}
+
+/*!
+@brief 本ライブラリが画像バッファ等の確保・解放に使用する関数を差し替える。
+@details 画像ファイルの読み込み先や APP5 埋め込み後の出力先など、サイズの大きいバッファを組み込み先のメモリプールに割り当てる場合に使用する。
+allocFunction と freeFunction の両方に NULL を指定した場合は、標準の malloc / free に戻す。
+`JCOMSIA_SVG_CalculateHashValue()` で取得したハッシュ値は差し替えの対象外であり、`JCOMSIA_SVG_FreeHashValue()` で解放できる。
+@attention 本ライブラリが確保した領域（ `JCOMSIA_WriteHashValueMem()` で取得して `JCOMSIA_FreeImageData()` で解放していない画像、
+処理中または処理待ちの API 呼び出しが使用している領域を含む）が残っている間は差し替えず、JW_ERROR_ALLOCATOR_IN_USE を返す。
+他の API を呼び出す前、またはすべての処理が終わって確保した領域をすべて解放した後に呼び出すこと。
+
+@param [in] allocFunction メモリを確保する関数。確保できなかった場合は NULL を返すこと。
+@param [in] freeFunction allocFunction で確保したメモリを解放する関数
+@param [in] context allocFunction, freeFunction の呼び出し時に渡される任意の値
+
+@retval JW_SUCCESS                            0 : 正常終了
+@retval JW_ERROR_INCORRECT_PARAMETER       -101 : allocFunction と freeFunction の片方のみ NULL が指定された場合
+@retval JW_ERROR_ALLOCATOR_IN_USE          -103 : 差し替え前の関数で確保した領域が残っている場合、または他のスレッドが差し替え中の場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SetAllocator(JCOMSIA_AllocFunc allocFunction, JCOMSIA_FreeFunc freeFunction, void *context)
+{
+    return _hashWriteReturnValueConvert(setAllocator(allocFunction, freeFunction, context));
+}
+
+/*!
+@brief 複数の画像ファイルについて、ハッシュ値をチェックする。
+@details 指定したスレッド数のワーカーで paths を分担して処理し、paths[i] の結果を results[i] に格納する。
+results[i] には `JCOMSIA_CheckHashValue(paths[i])` と同じ値が格納される。
+スレッドを作成できない環境では、呼び出し元のスレッドで順に処理する。
+
+@param [in] paths チェック対象となる画像ファイルのパスの配列
+@param [in] count paths の要素数
+@param [out] results 各ファイルのチェック結果を格納する配列（ count 個の要素が必要）
+@param [in] options 動作の指定。NULL の場合は既定値を使用する。
+
+@retval JW_SUCCESS                            0 : 全てのファイルを処理した（各ファイルの結果は results を参照）
+@retval JC_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_CheckHashValueBatch(const char **paths, size_t count, int *results, const JCOMSIA_BatchOptions *options)
+{
+    /* パラメータが不正 */
+    if(count != 0 && (paths == NULL || results == NULL))
+    {
+        return JC_ERROR_INCORRECT_PARAMETER;
+    }
+
+    _runBatch(_checkHashValue, paths, count, results, options);
+
+    return JW_SUCCESS;
+}
+
+/*!
+@brief 複数の SVG ファイルについて、ハッシュ値をチェックする。
+@details 指定したスレッド数のワーカーで paths を分担して処理し、paths[i] の結果を results[i] に格納する。
+results[i] には `JCOMSIA_SVG_CheckHashValue(paths[i])` と同じ値が格納される。
+スレッドを作成できない環境では、呼び出し元のスレッドで順に処理する。
+
+@param [in] paths チェック対象となる SVG ファイルのパスの配列
+@param [in] count paths の要素数
+@param [out] results 各ファイルのチェック結果を格納する配列（ count 個の要素が必要）
+@param [in] options 動作の指定。NULL の場合は既定値を使用する。
+
+@retval JW_SUCCESS                            0 : 全てのファイルを処理した（各ファイルの結果は results を参照）
+@retval JC_SVG_ERROR_INCORRECT_PARAMETER   -101 : 不正な引数が指定された場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SVG_CheckHashValueBatch(const char **paths, size_t count, int *results, const JCOMSIA_BatchOptions *options)
+{
+    /* パラメータが不正 */
+    if(count != 0 && (paths == NULL || results == NULL))
+    {
+        return JC_SVG_ERROR_INCORRECT_PARAMETER;
+    }
+
+    _runBatch(_svgCheckHashValue, paths, count, results, options);
+
+    return JW_SUCCESS;
+}
+
+/*!
+@brief 検証結果キャッシュを有効にする。
+@details 以降の `JCOMSIA_CheckHashValue()`, `JCOMSIA_SVG_CheckHashValue()` およびその一括処理の結果を、
+ファイルの識別情報（デバイス、i ノード番号、サイズ、更新日時、状態変更日時）とともに cachePath のファイルに記録する。
+識別情報が全て一致するファイルは検証を行わず、記録した結果を返す。いずれかが異なる場合は検証し直す。
+状態変更日時はファイルの内容や属性を変更するたびに更新され、ユーザー空間から設定できないため、更新日時を元に戻したファイルも検証し直す。
+キャッシュファイルは複数のプロセスから同時に使用できる。cachePath に NULL を指定した場合はキャッシュを無効にする。
+ファイル操作やメモリ確保の失敗による結果は記録しない。
+他のスレッドで検証中に呼び出した場合は、その検索・記録が終わるのを待ってからキャッシュを切り替える。
+@attention Windows では使用できない。
+
+@param [in] cachePath キャッシュのファイルパス。存在しない場合は作成する。
+
+@retval JW_SUCCESS                            0 : 正常終了
+@retval JW_ERROR_READ_FILE_OPEN_FAILED     -203 : キャッシュファイルのオープンに失敗
+@retval JW_ERROR_WRITE_FILE_FAILED         -205 : キャッシュファイルの初期化に失敗
+@retval JW_ERROR_OTHER                     -900 : キャッシュファイルをマップできなかった場合、またはキャッシュを使用できない環境の場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SetVerificationCache(const char *cachePath)
+{
+    if(cachePath == NULL)
+    {
+        closeVerificationCache();
+        return JW_SUCCESS;
+    }
+
+    return _hashWriteReturnValueConvert(openVerificationCache(cachePath));
+}
+
+/*!
+@brief 指定された JPEG 画像のバイト配列に改ざんチェック値を埋め込んだバイト配列を返す。
+@details `JCOMSIA_WriteHashValue()` のファイルを介さない版。source の内容は変更しない。
+dest は処理が成功した際にメモリ領域が確保されるため、使い終わったら `JCOMSIA_FreeImageData()` で解放すること。
+
+@param [in] source 改ざんチェック値を埋め込みたい JPEG 画像のバイト配列
+@param [in] sourceLength source のバイト数
+@param [out] dest 改ざんチェック値を埋め込んだ JPEG 画像のバイト配列を格納するポインタ。途中で処理が失敗した場合は NULL を返す。
+@param [out] destLength dest のバイト数を格納する変数
+
+@retval JW_SUCCESS                            0 : 正常終了
+
+@retval JW_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+
+@retval JW_ERROR_READ_FILE_SIZE_ZERO       -204 : sourceLength がゼロ
+
+@retval JW_ERROR_INCORRECT_EXIF_FORMAT     -301 : Exif フォーマットが不正
+@retval JW_ERROR_APP5_ALREADY_EXISTS       -302 : APP5 セグメントが既に存在する
+@retval JW_ERROR_DATE_NOT_EXISTS           -307 : source に日時情報が見つからない
+
+@retval JW_ERROR_OTHER                     -900 : その他のエラー
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_WriteHashValueMem(const unsigned char *source, size_t sourceLength, unsigned char **dest, size_t *destLength)
+{
+    int ret;
+    JpegBuffer *srcJpegBuffer = NULL;
+    JpegBuffer *destJpegBuffer = NULL;
+
+    /* パラメータが不正 */
+    if(source == NULL || dest == NULL || destLength == NULL)
     {
-        return JW_ERROR_WRITE_FILE_ALREADY_EXISTS;
+        return JW_ERROR_INCORRECT_PARAMETER;
     }
 
-    /* ファイルオープン */
-    ret = _readFile(sourceFile, &srcJpegBuffer);
+    *dest = NULL;
+    *destLength = 0;
+
+    ret = _copyToFileBinaryData(source, sourceLength, &srcJpegBuffer);
     if(ret != FUNCTION_SUCCESS)
     {
         goto FINALIZE;
     }
 
-    /* 出力 */
-    /* destBuff は保存対象のバッファ */
-    ret = _writeHashValueToBuffer(srcJpegBuffer, &destJpegBuffer);
+    /* 埋め込み後の画像全体をメモリ上に作成する */
+    ret = _writeHashValueToBuffer(srcJpegBuffer, NULL, &destJpegBuffer);
     if(ret != FUNCTION_SUCCESS)
     {
         goto FINALIZE;
     }
 
-    ret = writeFile(destFile, destJpegBuffer->_buff, destJpegBuffer->_len);
+    /* 複製せずにバイナリ領域をそのまま返す（ JCOMSIA_FreeImageData で構造体ごと解放する） */
+    *dest = destJpegBuffer->_buff;
+    *destLength = destJpegBuffer->_len;
+    destJpegBuffer = NULL;
 
 FINALIZE:
 
     /* メモリ解放 */
-    _SECURE_FREE(destJpegBuffer);
-    _SECURE_FREE(srcJpegBuffer);
+    releaseFileBinaryData(&srcJpegBuffer);
+    _SECURE_RELEASE(destJpegBuffer);
 
     /* 戻り値を外部公開用の定数に置き換えて返す */
     return _hashWriteReturnValueConvert(ret);
 }
 
 /*!
-@brief 指定された JPEG ファイルに正しい改ざんチェック値が設定されているかを確認する。
-@param [in] checkFile チェック対象のファイル名
+@brief 指定された JPEG 画像のバイト配列に正しい改ざんチェック値が設定されているかを確認する。
+@details `JCOMSIA_CheckHashValue()` のファイルを介さない版。
+
+@param [in] image チェック対象の JPEG 画像のバイト配列
+@param [in] imageLength image のバイト数
 
 @retval JC_OK                                 1 : ハッシュ値が一致した
 @retval JC_NG                                 0 : ハッシュ値（画像、撮影日時の両方）が一致しない
@@ -1094,75 +2792,64 @@ FINALIZE:
 
 @retval JC_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
 
-@retval JC_ERROR_READ_FILE_NOT_EXISTS      -201 : 読込元画像ファイルが存在しない
-@retval JC_ERROR_READ_FILE_OPEN_FAILED     -203 : ファイルオープン失敗
-@retval JC_ERROR_READ_FILE_SIZE_ZERO       -204 : 読み込んだファイルサイズがゼロ
-@retval JC_ERROR_FILE_CLOSE_FAILED         -206 : ファイルのクローズに失敗
+@retval JC_ERROR_READ_FILE_SIZE_ZERO       -204 : imageLength がゼロ
 
 @retval JC_ERROR_INCORRECT_EXIF_FORMAT     -301 : Exif フォーマットが不正
 @retval JC_ERROR_APP5_NOT_EXISTS           -303 : APP5 領域が見つからない
 @retval JC_ERROR_INCORRECT_APP5_FORMAT     -304 : APP5 領域の記述形式が異なる
 @retval JC_ERROR_HASH_NOT_EXISTS           -305 : ハッシュ値が設定されていない
-@retval JC_ERROR_DATE_NOT_EXISTS           -307 : checkFile に日時情報が見つからない
+@retval JC_ERROR_DATE_NOT_EXISTS           -307 : image に日時情報が見つからない
 
 @retval JC_ERROR_OTHER                     -900 : その他のエラー
 
-@since 1.0
+@since 3.2
 */
-int WINAPI JCOMSIA_CheckHashValue(const char *checkFile)
+int WINAPI JCOMSIA_CheckHashValueMem(const unsigned char *image, size_t imageLength)
 {
     int ret;
     JpegBuffer *readJpegBuffer = NULL;
 
-    /* ファイル読み込みチェック */
-    if(checkFile == NULL)
+    /* パラメータが不正 */
+    if(image == NULL)
     {
-        /* パラメータが不正 */
         return JC_ERROR_INCORRECT_PARAMETER;
     }
 
-    /* チェック対象画像ファイルが存在しない場合 */
-    if(_fileExist(checkFile) != FUNCTION_SUCCESS)
-    {
-        return JC_ERROR_READ_FILE_NOT_EXISTS;
-    }
-
-    /* チェック対象画像オープン */
-    ret = _readFile(checkFile, &readJpegBuffer);
+    ret = _copyToFileBinaryData(image, imageLength, &readJpegBuffer);
     if(ret != FUNCTION_SUCCESS)
     {
         goto FINALIZE;
     }
 
     /* ハッシュ値一致判定 */
-    ret = _validateImage(readJpegBuffer, NULL, NULL);
+    ret = _validateImage(readJpegBuffer, NULL, NULL, NULL);
 
 FINALIZE:
 
     /* メモリ解放 */
-    _SECURE_FREE(readJpegBuffer);
+    releaseFileBinaryData(&readJpegBuffer);
 
     /* 戻り値を外部公開用の定数に置き換えて返す */
     return _hashCheckReturnValueConvert(ret);
 }
 
 /*!
-@brief 原本画像と黒板画像から SVG 画像に埋め込むための改ざん検知情報を計算する。
-@details hashCode は処理が成功した際にメモリ領域が確保されるため、必要に応じて手動で解放する必要がある。
+@brief 原本画像と黒板画像のバイト配列から SVG 画像に埋め込むための改ざん検知情報を計算する。
+@details `JCOMSIA_SVG_CalculateHashValue()` のファイルを介さない版。
+hashCode は処理が成功した際にメモリ領域が確保されるため、`JCOMSIA_SVG_FreeHashValue()` で解放すること。
 hashCode の長さは `JCOMSIA_HASH_LENGTH` を参照。
 
-@param [in] originalImagePath 画像改ざん検知情報付与済みの原本画像のパス
-@param [in] chalkboardPath 画像改ざん検知情報付与済みの黒板画像のパス
+@param [in] originalImage 画像改ざん検知情報付与済みの原本画像のバイト配列
+@param [in] originalImageLength originalImage のバイト数
+@param [in] chalkboardImage 画像改ざん検知情報付与済みの黒板画像のバイト配列
+@param [in] chalkboardImageLength chalkboardImage のバイト数
 @param [out] hashCode 計算したハッシュ値を格納するポインタ。NULL 終端されない。途中で処理が失敗した場合は NULL を返す。
 
 @retval JW_HASHER_CREATE_SUCCESS                   0 : 正常終了
 
 @retval JW_HASHER_ERROR_INCORRECT_PARAMETER     -101 : 引数に NULL を渡された等、引数指定に不備がある場合
 
-@retval JW_HASHER_ERROR_FILE_DOES_NOT_EXIST     -201 : 読み込み元ファイルが存在しない
-@retval JW_HASHER_ERROR_FILE_OPEN_FAILED        -203 : ファイルオープン失敗
-@retval JW_HASHER_ERROR_FILE_SIZE_ZERO          -204 : 読み込んだファイルサイズがゼロ
-@retval JW_HASHER_ERROR_FILE_CLOSE_FAILED       -206 : ファイルクローズ失敗
+@retval JW_HASHER_ERROR_FILE_SIZE_ZERO          -204 : 画像のバイト数がゼロ
 
 @retval JW_HASHER_ERROR_ORG_DOES_NOT_HAVE_HASH  -351 : 原本画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
 @retval JW_HASHER_ERROR_ORG_HASH_NG_IMAGE       -352 : 原本画像のハッシュ値（画像）が正しくない
@@ -1176,9 +2863,9 @@ hashCode の長さは `JCOMSIA_HASH_LENGTH` を参照。
 
 @retval JW_HASHER_ERROR_OTHERS                  -900 : その他のエラー（メモリ領域の確保失敗など）
 
-@since 3.0
+@since 3.2
 */
-int WINAPI JCOMSIA_SVG_CalculateHashValue(const char *originalImagePath, const char *chalkboardPath, unsigned char **hashCode)
+int WINAPI JCOMSIA_SVG_CalculateHashValueMem(const unsigned char *originalImage, size_t originalImageLength, const unsigned char *chalkboardImage, size_t chalkboardImageLength, unsigned char **hashCode)
 {
     int ret;
 
@@ -1188,28 +2875,21 @@ int WINAPI JCOMSIA_SVG_CalculateHashValue(const char *originalImagePath, const c
     HashBuffer *returnHashCode = NULL;
 
     /* パラメータが不正 */
-    if(originalImagePath == NULL || chalkboardPath == NULL || hashCode == NULL)
+    if(originalImage == NULL || chalkboardImage == NULL || hashCode == NULL)
     {
         return JW_HASHER_ERROR_INCORRECT_PARAMETER;
     }
 
     *hashCode = NULL;
 
-    /* 画像ファイルが存在しない場合 */
-    if(_fileExist(originalImagePath) != FUNCTION_SUCCESS ||
-            _fileExist(chalkboardPath) != FUNCTION_SUCCESS)
-    {
-        return JW_HASHER_ERROR_FILE_DOES_NOT_EXIST;
-    }
-
-    ret = _readFile(originalImagePath, &originalImageBuffer);
+    ret = _copyToFileBinaryData(originalImage, originalImageLength, &originalImageBuffer);
     if(ret != FUNCTION_SUCCESS) goto FINALIZE;
 
-    ret = _readFile(chalkboardPath, &chalkBoardBuffer);
+    ret = _copyToFileBinaryData(chalkboardImage, chalkboardImageLength, &chalkBoardBuffer);
     if(ret != FUNCTION_SUCCESS) goto FINALIZE;
 
     /* ハッシュ値の算出を行う */
-    ret = _calculateHashValue(originalImageBuffer, chalkBoardBuffer, &returnHashCode);
+    ret = _calculateHashValue(originalImageBuffer, chalkBoardBuffer, NULL, &returnHashCode);
     if(ret != FUNCTION_SUCCESS) goto FINALIZE;
 
     /* 最終的な結果を受け取る引数にコピーする */
@@ -1225,37 +2905,49 @@ int WINAPI JCOMSIA_SVG_CalculateHashValue(const char *originalImagePath, const c
 FINALIZE:
 
     /* メモリ解放 */
-    _SECURE_FREE(originalImageBuffer);
-    _SECURE_FREE(chalkBoardBuffer);
-    _SECURE_FREE(returnHashCode);
+    releaseFileBinaryData(&originalImageBuffer);
+    releaseFileBinaryData(&chalkBoardBuffer);
+    _SECURE_RELEASE(returnHashCode);
 
     return _createHashReturnValueConvert(ret);
 }
 
 /*!
-@brief SVG ファイルが改ざんされているものか検証を行う。
-@details メタデータ内に含まれる hashCode と、
-原本画像 + 黒板画像で再計算したハッシュ値が等しいかを調べる。
+@brief `JCOMSIA_WriteHashValueMem()` 関数によって確保されたメモリ領域を解放する。
+@details 解放されたポインタには NULL が設定される。
+@attention `JCOMSIA_WriteHashValueMem()` で取得したポインタ以外を引数として与えないこと。
 
-もし SVG ファイル内に黒板画像が含まれていない場合、
-原本画像単体に対して `JACIC_CheckHashValue` 関数を呼び出したときと同じ値を返す。
+@param [out] data メモリ解放の対象となるポインタの参照。処理後は `NULL` ポインタを指すように設定される。
 
-@param checkFilePath 処理対象となる SVG ファイルのパス
+@since 3.2
+*/
+void WINAPI JCOMSIA_FreeImageData(unsigned char **data)
+{
+    JpegBuffer *buffer;
 
-@retval JC_SVG_RESULT_OK                                   1 : 改ざん無し
-@retval JC_SVG_RESULT_NG_COMBINATION                      -3 : 原本画像と黒板画像の組み合わせが正しくない
+    if(data == NULL || *data == NULL) return;
 
-@retval JC_SVG_ERROR_ORG_DOES_NOT_EXIST                  -21 : SVG内に原本画像が存在しない
-@retval JC_SVG_ERROR_ORG_DOES_NOT_HAVE_HASH              -22 : 原本画像からハッシュ値を取得できなかった
-@retval JC_SVG_ERROR_NG_ORG_IMAGE                        -23 : 原本画像の画像ハッシュが不正または計算不能
-@retval JC_SVG_ERROR_NG_ORG_DATE                         -24 : 原本画像の撮影日時ハッシュが不正または計算不能
-@retval JC_SVG_ERROR_NG_ORG_BOTH                         -25 : 原本画像の画像ハッシュおよび撮影日時ハッシュの両方が不正または計算不能
+    /* JCOMSIA_WriteHashValueMem はバイナリデータ構造体の _buff を返しているため、構造体の先頭に戻して解放する */
+    buffer = (JpegBuffer *)(*data - offsetof(JpegBuffer, _buff));
+    _SECURE_RELEASE(buffer);
+
+    *data = NULL;
+}
+
+/*!
+@brief SVG ファイルのメタデータと黒板画像レイヤの有無のみを取得する。
+@details 画像の Base64 部分はデコードせずに読み捨て、黒板画像レイヤの開始タグを検出した時点で読み込みを終了する。
+一覧表示などでメタデータのみ必要な場合に、`JCOMSIA_SVG_CheckHashValue()` より少ない処理量で取得できる。
+画像の内容と改ざんの有無は検証しないため、検証には `JCOMSIA_SVG_CheckHashValue()` を使用すること。
+meta は処理が成功した際にメモリ領域が確保されるため、使い終わったら `JCOMSIA_SVG_FreeMetadata()` で解放すること。
+
+@param [in] svgFilePath 処理対象となる SVG ファイルのパス
+@param [out] meta 取得したメタデータを格納する構造体。途中で処理が失敗した場合は各メンバに NULL, 0 を設定する。
 
+@retval JW_SUCCESS                                         0 : 正常終了
+
+@retval JC_SVG_ERROR_ORG_DOES_NOT_EXIST                  -21 : SVG内に原本画像が存在しない
 @retval JC_SVG_ERROR_CB_DOES_NOT_EXIST                   -41 : SVG内に合成ハッシュ値が含まれているが、黒板画像が存在しない
-@retval JC_SVG_ERROR_CB_DOES_NOT_HAVE_HASH               -42 : 黒板画像からハッシュ値を取得できなかった
-@retval JC_SVG_ERROR_NG_CB_IMAGE                         -43 : 黒板画像の画像ハッシュが不正または計算不能
-@retval JC_SVG_ERROR_NG_CB_DATE                          -44 : 黒板画像の撮影日時ハッシュが不正または計算不能
-@retval JC_SVG_ERROR_NG_CB_BOTH                          -45 : 黒板画像の画像ハッシュおよび撮影日時ハッシュの両方が不正または計算不能
 
 @retval JC_SVG_ERROR_BROKEN_STRUCTURE                    -61 : SVGの構成が壊れている
 
@@ -1267,97 +2959,450 @@ FINALIZE:
 @retval JC_SVG_ERROR_METADATA_INCORRECT_HASHCODE         -86 : メタデータ「ハッシュコード」に問題あり
 
 @retval JC_SVG_ERROR_INCORRECT_PARAMETER                -100 : NULLなど不正な引数が渡された
+@retval JC_ERROR_READ_FILE_NOT_EXISTS                   -201 : SVG ファイルが存在しない
 @retval JC_SVG_ERROR_OTHERS                             -900 : メモリ確保失敗などの予期せぬエラー
 
-@since 3.0
+@since 3.2
 */
-int WINAPI JCOMSIA_SVG_CheckHashValue(const char *checkFilePath)
+int WINAPI JCOMSIA_SVG_ProbeMetadata(const char *svgFilePath, JCOMSIA_SVGMeta *meta)
 {
-    int ret, cmpResult;
+    int ret = JW_SUCCESS;
     SVGResult svgResult;
-
-    JpegBuffer *originalImageBuffer = NULL;
-    JpegBuffer *chalkboardBuffer = NULL;
-    HashBuffer *svgHashCode = NULL;
-    HashBuffer *recalculatedHashCode = NULL;
+    SVGMetadata metadata;
 
     /* パラメータが不正 */
-    if(checkFilePath == NULL)
+    if(svgFilePath == NULL || meta == NULL)
     {
         return JC_SVG_ERROR_INCORRECT_PARAMETER;
     }
 
-    /* チェック対象画像ファイルが存在しない場合 */
-    if(_fileExist(checkFilePath) != FUNCTION_SUCCESS)
+    meta->vender = NULL;
+    meta->software = NULL;
+    meta->metaVersion = NULL;
+    meta->stdVersion = NULL;
+    meta->hashCode = NULL;
+    meta->hasChalkboard = 0;
+    meta->dcpmNamespace = NULL;
+
+    /* SVG ファイルが存在しない場合 */
+    if(_fileExist(svgFilePath) != FUNCTION_SUCCESS)
     {
         return JC_ERROR_READ_FILE_NOT_EXISTS;
     }
 
-    /* SVG ファイルの解析 */
-    svgResult = parse(checkFilePath, &originalImageBuffer, &chalkboardBuffer, &svgHashCode);
+    svgResult = probeMetadata(svgFilePath, &metadata);
     if(svgResult != SVG_SUCCESS)
     {
         ret = _svgResultToPublicErrorCode(svgResult);
         goto FINALIZE;
     }
-    assert(originalImageBuffer != NULL);
 
-    if(chalkboardBuffer == NULL)
+    /* ハッシュコードは NULL 終端した文字列として返す */
+    if(metadata._hashCode != NULL)
     {
-        /* 原本画像のみ取得できた場合、原本画像に対して従来のハッシュチェックを行った値を返す */
-        ret = _validateImage(originalImageBuffer, NULL, NULL);
-        ret = _hashCheckReturnValueConvert(ret);
-        goto FINALIZE;
+        meta->hashCode = malloc(metadata._hashCode->_len + 1);
+        if(meta->hashCode == NULL)
+        {
+            ret = JC_SVG_ERROR_OTHERS;
+            goto FINALIZE;
+        }
+
+        memcpy(meta->hashCode, metadata._hashCode->_buff, metadata._hashCode->_len);
+        meta->hashCode[metadata._hashCode->_len] = '\0';
     }
 
-    /* ハッシュ値算出 */
-    ret = _calculateHashValue(originalImageBuffer, chalkboardBuffer, &recalculatedHashCode);
-    if(ret != FUNCTION_SUCCESS)
+    /* 文字列は複製せずにそのまま返す */
+    meta->vender = metadata._vender;
+    meta->software = metadata._software;
+    meta->metaVersion = metadata._metaVersion;
+    meta->stdVersion = metadata._stdVersion;
+    meta->hasChalkboard = (metadata._hasChalkboard == JACIC_BOOL_TRUE) ? 1 : 0;
+
+    metadata._vender = NULL;
+    metadata._software = NULL;
+    metadata._metaVersion = NULL;
+    metadata._stdVersion = NULL;
+
+FINALIZE:
+
+    /* メモリ解放 */
+    releaseSVGMetadata(&metadata);
+
+    return ret;
+}
+
+/*!
+@brief `JCOMSIA_SVG_ProbeMetadata()` 関数によって確保されたメモリ領域を解放する。
+@details 解放したメンバには NULL, 0 が設定される。
+
+@param [in, out] meta `JCOMSIA_SVG_ProbeMetadata()` でメタデータを取得した構造体
+
+@since 3.2
+*/
+void WINAPI JCOMSIA_SVG_FreeMetadata(JCOMSIA_SVGMeta *meta)
+{
+    if(meta == NULL) return;
+
+    _SECURE_FREE(meta->vender);
+    _SECURE_FREE(meta->software);
+    _SECURE_FREE(meta->metaVersion);
+    _SECURE_FREE(meta->stdVersion);
+    _SECURE_FREE(meta->hashCode);
+    meta->hasChalkboard = 0;
+}
+
+/*!
+@brief SVG ファイルに埋め込む画像と、その幅と高さを取得する。
+@param [in] image 埋め込む JPEG 画像
+@param [out] layer 取得結果
+@retval FUNCTION_SUCCESS 正常終了
+@retval INCORRECT_EXIF_FORMAT 画像の幅と高さを取得できない場合
+@retval OTHER_ERROR メモリ確保に失敗した場合
+*/
+static int _getLayerImage(JpegBuffer *image, SVGLayerImage *layer)
+{
+    int ret;
+    JpegSegmentIndex index = {NULL, 0, 0, 0UL, NULL};
+
+    layer->_image = image;
+
+    ret = buildSegmentIndex(image, &index, NULL);
+    if(ret == FUNCTION_SUCCESS)
     {
-        ret = _svgHashCheckReturnValueConvert(ret);
-        goto FINALIZE;
+        ret = getImageSize(image, &index, &(layer->_width), &(layer->_height));
     }
-    assert(recalculatedHashCode != NULL);
 
-    if(svgHashCode->_len != recalculatedHashCode->_len)
+    releaseSegmentIndex(&index);
+
+    return ret;
+}
+
+/*!
+@brief 原本画像と黒板画像を埋め込み、改ざん検知情報（ hashCode ）を含むメタデータを持つ SVG ファイルを作成する。
+@details hashCode は `JCOMSIA_SVG_CalculateHashValue()` と同じく、両方の画像の改ざん検知情報を検証したうえで計算する。
+画像は一定の長さずつ Base64 エンコードしながらファイルへ書き出し、 SVG ファイル全体や Base64 文字列全体をメモリ上に作成しない。
+原本画像の大きさを SVG の大きさとし、黒板画像は左上に元の大きさで配置する。
+書き出しに失敗した場合、書き出し途中の outPath は削除される。
+
+@param [in] originalPath 画像改ざん検知情報付与済みの原本画像のパス
+@param [in] chalkboardPath 画像改ざん検知情報付与済みの黒板画像のパス。NULL の場合は黒板画像レイヤと hashCode を出力しない。
+@param [in] annotationSvgFragment 注釈レイヤ (dcp_annotation) の内容とする SVG 要素の並び（ UTF-8 ）。NULL の場合は注釈レイヤを出力しない。
+@param [in] meta 出力するメタデータ。dcpmNamespace 、vender 、software は必須（ NULL または空文字列の場合は JW_SVG_ERROR_INCORRECT_PARAMETER を返す）。
+dcpmNamespace には既定値が無く、dcpm 接頭辞に割り当てる名前空間を呼び出し元が指定すること。
+metaVersion と stdVersion は NULL の場合 "3.1" と "1.5" を出力する。hashCode と hasChalkboard は参照しない。
+@param [in] outPath 出力先の SVG ファイルのパス
+
+@retval JW_SVG_CREATE_SUCCESS                  0 : 正常終了
+
+@retval JW_SVG_ERROR_INCORRECT_PARAMETER    -101 : 引数に NULL を渡された、dcpmNamespace などメタデータが不足している、メタデータが正しい UTF-8 でない、対応していないバージョンが指定された、注釈が整形式でない場合
+@retval JW_SVG_ERROR_SAME_FILE_PATH         -102 : 読み込み元と出力先のファイルパスが同じ
+
+@retval JW_SVG_ERROR_FILE_DOES_NOT_EXIST    -201 : 読み込み元ファイルが存在しない
+@retval JW_SVG_ERROR_FILE_ALREADY_EXISTS    -202 : 出力先ファイルが既に存在する
+@retval JW_SVG_ERROR_FILE_OPEN_FAILED       -203 : ファイルオープン失敗
+@retval JW_SVG_ERROR_FILE_SIZE_ZERO         -204 : 読み込んだファイルサイズがゼロ
+@retval JW_SVG_ERROR_FILE_WRITE_FAILED      -205 : ファイル書き込み失敗
+@retval JW_SVG_ERROR_FILE_CLOSE_FAILED      -206 : ファイルクローズ失敗
+
+@retval JW_SVG_ERROR_INCORRECT_EXIF_FORMAT  -301 : 画像の幅と高さを取得できない
+
+@retval JW_SVG_ERROR_ORG_DOES_NOT_HAVE_HASH -351 : 原本画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_SVG_ERROR_ORG_HASH_NG_IMAGE      -352 : 原本画像のハッシュ値（画像）が正しくない
+@retval JW_SVG_ERROR_ORG_HASH_NG_DATE       -353 : 原本画像のハッシュ値（撮影日時）が正しくない
+@retval JW_SVG_ERROR_ORG_HASH_NG_BOTH       -354 : 原本画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_SVG_ERROR_CB_DOES_NOT_HAVE_HASH  -361 : 黒板画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_SVG_ERROR_CB_HASH_NG_IMAGE       -362 : 黒板画像のハッシュ値（画像）が正しくない
+@retval JW_SVG_ERROR_CB_HASH_NG_DATE        -363 : 黒板画像のハッシュ値（撮影日時）が正しくない
+@retval JW_SVG_ERROR_CB_HASH_NG_BOTH        -364 : 黒板画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_SVG_ERROR_OTHERS                 -900 : その他のエラー（メモリ領域の確保失敗など）
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SVG_Write(const char *originalPath, const char *chalkboardPath, const char *annotationSvgFragment, const JCOMSIA_SVGMeta *meta, const char *outPath)
+{
+    int ret;
+
+    JpegBuffer *originalImageBuffer = NULL;
+    JpegBuffer *chalkBoardBuffer = NULL;
+    PrehashedImage prehashedImages[2];
+
+    HashBuffer *hashCode = NULL;
+    SVGDocument document;
+
+    /* パラメータが不正 */
+    if(originalPath == NULL || meta == NULL || outPath == NULL)
     {
-        ret = JC_SVG_RESULT_NG_COMBINATION;
-        goto FINALIZE;
+        return JW_SVG_ERROR_INCORRECT_PARAMETER;
     }
 
-    cmpResult = memcmp(svgHashCode->_buff, recalculatedHashCode->_buff, svgHashCode->_len);
-    if(cmpResult != 0)
+    /* 読み込み元と出力先のファイルパスが同じ場合 */
+    if(strcmp(originalPath, outPath) == 0 ||
+            (chalkboardPath != NULL && strcmp(chalkboardPath, outPath) == 0))
     {
-        ret = JC_SVG_RESULT_NG_COMBINATION;
-        goto FINALIZE;
+        return JW_SVG_ERROR_SAME_FILE_PATH;
     }
-    ret = JC_SVG_RESULT_OK;
+
+    /* 画像ファイルが存在しない場合 */
+    if(_fileExist(originalPath) != FUNCTION_SUCCESS ||
+            (chalkboardPath != NULL && _fileExist(chalkboardPath) != FUNCTION_SUCCESS))
+    {
+        return JW_SVG_ERROR_FILE_DOES_NOT_EXIST;
+    }
+
+    /* 出力先ファイルが既に存在する場合 */
+    if(_fileExist(outPath) == FUNCTION_SUCCESS)
+    {
+        return JW_SVG_ERROR_FILE_ALREADY_EXISTS;
+    }
+
+    memset(&document, 0x00, sizeof(document));
+    document._dcpmNamespace = meta->dcpmNamespace;
+    document._vender = meta->vender;
+    document._software = meta->software;
+    document._metaVersion = (meta->metaVersion != NULL) ? meta->metaVersion : "3.1";
+    document._stdVersion = (meta->stdVersion != NULL) ? meta->stdVersion : "1.5";
+    document._annotation = annotationSvgFragment;
+
+    ret = _readFileWithImageHash(originalPath, &originalImageBuffer, &prehashedImages[0]);
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    if(chalkboardPath != NULL)
+    {
+        ret = _readFileWithImageHash(chalkboardPath, &chalkBoardBuffer, &prehashedImages[1]);
+        if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+        /* 両方の画像を検証しながら、メタデータに含める hashCode を算出する */
+        ret = _calculateHashValue(originalImageBuffer, chalkBoardBuffer, prehashedImages, &hashCode);
+        if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+    }
+    else
+    {
+        /* hashCode を出力しない場合も、改ざん検知情報付与済みの原本画像であることは確認する */
+        ret = _validateImage(originalImageBuffer, &prehashedImages[0], NULL, NULL);
+        if(ret != SAME_HASH)
+        {
+            ret = _validateResultToSVGError(ret, JACIC_BOOL_TRUE);
+            goto FINALIZE;
+        }
+    }
+
+    /* 各画像レイヤの大きさを取得する */
+    ret = _getLayerImage(originalImageBuffer, &(document._originalImage));
+    if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+
+    if(chalkBoardBuffer != NULL)
+    {
+        ret = _getLayerImage(chalkBoardBuffer, &(document._chalkboardImage));
+        if(ret != FUNCTION_SUCCESS) goto FINALIZE;
+    }
+
+    document._hashCode = hashCode;
+
+    /* 出力（ SVG ファイル全体はメモリ上に作成しない） */
+    ret = writeSVG(&document, outPath);
 
 FINALIZE:
 
     /* メモリ解放 */
-    _SECURE_FREE(originalImageBuffer);
-    _SECURE_FREE(chalkboardBuffer);
-    _SECURE_FREE(svgHashCode);
-    _SECURE_FREE(recalculatedHashCode);
+    releaseFileBinaryData(&originalImageBuffer);
+    releaseFileBinaryData(&chalkBoardBuffer);
+    _SECURE_RELEASE(hashCode);
 
-    return ret;
+    return _svgWriteReturnValueConvert(ret);
 }
 
 /*!
-@brief `JCOMSIA_SVG_CalculateHashValue()` 関数によって確保されたメモリ領域を解放する。
-@details 解放されたポインタには NULL が設定される。
-@attention 動作の安全性のため、本ライブラリによって確保されたメモリ領域以外を指すポインタを引数として与えないこと。
+@brief 非同期処理用の処理キューを開始する。
+@details 処理キューはライブラリ内で 1 つを共有する。既に開始している場合は何もせず、options は反映されない。
+呼び出さずに処理を登録した場合は、既定の設定で開始する。
 
-@param [out] ptr メモリ解放の対象となるポインタの参照。処理後は `NULL` ポインタを指すように設定される。
+@param [in] options 処理キューの設定。NULL の場合は既定値を使用する。
 
-@since 3.1
+@retval JQ_SUCCESS                            0 : 正常終了（既に開始している場合を含む）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : スレッドの作成やメモリ確保に失敗した場合、またはスレッドを使用できない環境の場合
+
+@since 3.2
 */
-void WINAPI JCOMSIA_SVG_FreeHashValue(unsigned char **ptr)
+int WINAPI JCOMSIA_StartQueue(const JCOMSIA_QueueOptions *options)
 {
-    if(ptr == NULL) return;
+    if(options == NULL)
+    {
+        return startWorkQueue(0, 0, JACIC_BOOL_TRUE);
+    }
 
-    _SECURE_FREE(*ptr);
+    return startWorkQueue(options->threadCount, options->capacity, options->failWhenFull != 0 ? JACIC_BOOL_FALSE : JACIC_BOOL_TRUE);
+}
+
+/*!
+@brief `JCOMSIA_WriteHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] sourceFile 改ざんチェック値を埋め込みたいファイル名
+@param [in] destFile 改ざんチェック値を埋め込んだファイル名
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SubmitWriteHash(const char *sourceFile, const char *destFile, JCOMSIA_CompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId)
+{
+    /* パラメータが不正 */
+    if(sourceFile == NULL || destFile == NULL)
+    {
+        return JQ_ERROR_INCORRECT_PARAMETER;
+    }
+
+    return _submitHashJob(_createHashJob(HASH_JOB_WRITE, sourceFile, destFile, callback, NULL, userdata), jobId);
+}
+
+/*!
+@brief `JCOMSIA_CheckHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] checkFile チェック対象のファイル名
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SubmitCheckHash(const char *checkFile, JCOMSIA_CompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId)
+{
+    /* パラメータが不正 */
+    if(checkFile == NULL)
+    {
+        return JQ_ERROR_INCORRECT_PARAMETER;
+    }
+
+    return _submitHashJob(_createHashJob(HASH_JOB_CHECK, checkFile, NULL, callback, NULL, userdata), jobId);
+}
+
+/*!
+@brief `JCOMSIA_SVG_CalculateHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] originalImagePath 画像改ざん検知情報付与済みの原本画像のパス
+@param [in] chalkboardPath 画像改ざん検知情報付与済みの黒板画像のパス
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SVG_SubmitCalculateHash(const char *originalImagePath, const char *chalkboardPath, JCOMSIA_HashCompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId)
+{
+    /* パラメータが不正 */
+    if(originalImagePath == NULL || chalkboardPath == NULL)
+    {
+        return JQ_ERROR_INCORRECT_PARAMETER;
+    }
+
+    return _submitHashJob(_createHashJob(HASH_JOB_SVG_CALCULATE, originalImagePath, chalkboardPath, NULL, callback, userdata), jobId);
+}
+
+/*!
+@brief `JCOMSIA_SVG_CheckHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] checkFilePath 処理対象となる SVG ファイルのパス
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_SVG_SubmitCheckHash(const char *checkFilePath, JCOMSIA_CompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId)
+{
+    /* パラメータが不正 */
+    if(checkFilePath == NULL)
+    {
+        return JQ_ERROR_INCORRECT_PARAMETER;
+    }
+
+    return _submitHashJob(_createHashJob(HASH_JOB_SVG_CHECK, checkFilePath, NULL, callback, NULL, userdata), jobId);
+}
+
+/*!
+@brief 処理待ちの処理を取り消す。
+@details 取り消した処理の callback は、この関数を呼び出したスレッドから `JQ_ERROR_CANCELLED` を結果として呼び出される。
+既に実行を始めた処理は取り消せない。
+
+@param [in] jobId 登録時に取得した識別番号
+
+@retval JQ_SUCCESS                            0 : 取り消した
+@retval JQ_ERROR_JOB_NOT_FOUND             -504 : 処理待ちの中に見つからない（実行中・実行済みの場合を含む）
+
+@since 3.2
+*/
+int WINAPI JCOMSIA_CancelJob(JCOMSIA_JobId jobId)
+{
+    return cancelWork(jobId);
+}
+
+/*!
+@brief 登録済みの処理が全て完了するまで待つ。
+@attention callback の中から呼び出さないこと。
+
+@since 3.2
+*/
+void WINAPI JCOMSIA_DrainQueue(void)
+{
+    drainWorkQueue();
+}
+
+/*!
+@brief 処理キューを停止し、ライブラリが作成したスレッドを終了する。
+@details 実行中の処理は完了まで待つ。停止処理中の登録は `JQ_ERROR_QUEUE_STOPPED` で失敗する。
+停止後に処理を登録した場合は、処理キューを再び開始する。
+@attention callback の中から呼び出さないこと。また、複数のスレッドから同時に呼び出さないこと。
+
+@param [in] cancelPending 0 の場合は処理待ちを全て実行してから停止し、0 以外の場合は処理待ちを取り消して停止する。
+
+@since 3.2
+*/
+void WINAPI JCOMSIA_ShutdownQueue(int cancelPending)
+{
+    shutdownWorkQueue(cancelPending != 0 ? JACIC_BOOL_TRUE : JACIC_BOOL_FALSE);
 }
 
 /*!
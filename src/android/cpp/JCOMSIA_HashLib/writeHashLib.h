@@ -260,6 +260,542 @@ DECLSPEC_PORT
 #endif /* WRITE_EXPORTS */
 void WINAPI JCOMSIA_SVG_FreeHashValue(unsigned char **ptr);
 
+/*!
+@brief `JCOMSIA_SetAllocator()` に指定するメモリ確保関数の型
+@since 3.2
+*/
+typedef void *(*JCOMSIA_AllocFunc)(size_t size, void *context);
+
+/*!
+@brief `JCOMSIA_SetAllocator()` に指定するメモリ解放関数の型
+@since 3.2
+*/
+typedef void (*JCOMSIA_FreeFunc)(void *ptr, void *context);
+
+/*!
+@brief 本ライブラリが画像バッファ等の確保・解放に使用する関数を差し替える。
+@details 画像ファイルの読み込み先や APP5 埋め込み後の出力先など、サイズの大きいバッファを組み込み先のメモリプールに割り当てる場合に使用する。
+allocFunction と freeFunction の両方に NULL を指定した場合は、標準の malloc / free に戻す。
+`JCOMSIA_SVG_CalculateHashValue()` で取得したハッシュ値は差し替えの対象外であり、`JCOMSIA_SVG_FreeHashValue()` で解放できる。
+@attention 本ライブラリが確保した領域（ `JCOMSIA_WriteHashValueMem()` で取得して `JCOMSIA_FreeImageData()` で解放していない画像、
+処理中または処理待ちの API 呼び出しが使用している領域を含む）が残っている間は差し替えず、JW_ERROR_ALLOCATOR_IN_USE を返す。
+他の API を呼び出す前、またはすべての処理が終わって確保した領域をすべて解放した後に呼び出すこと。
+
+@param [in] allocFunction メモリを確保する関数。確保できなかった場合は NULL を返すこと。
+@param [in] freeFunction allocFunction で確保したメモリを解放する関数
+@param [in] context allocFunction, freeFunction の呼び出し時に渡される任意の値
+
+@retval JW_SUCCESS                            0 : 正常終了
+@retval JW_ERROR_INCORRECT_PARAMETER       -101 : allocFunction と freeFunction の片方のみ NULL が指定された場合
+@retval JW_ERROR_ALLOCATOR_IN_USE          -103 : 差し替え前の関数で確保した領域が残っている場合、または他のスレッドが差し替え中の場合
+
+@since 3.2
+*/
+#if defined(WRITE_EXPORTS) || defined(CHECK_EXPORTS)
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS || CHECK_EXPORTS */
+int WINAPI JCOMSIA_SetAllocator(JCOMSIA_AllocFunc allocFunction, JCOMSIA_FreeFunc freeFunction, void *context);
+
+/*!
+@struct JCOMSIA_BatchOptions
+@brief `JCOMSIA_CheckHashValueBatch()`, `JCOMSIA_SVG_CheckHashValueBatch()` の動作を指定する構造体
+@since 3.2
+*/
+typedef struct
+{
+    size_t threadCount; /*!< @brief 同時に処理するスレッド数（呼び出し元のスレッドを含む）。0 の場合は利用可能な CPU 数 */
+} JCOMSIA_BatchOptions;
+
+/*!
+@brief 複数の画像ファイルについて、ハッシュ値をチェックする。
+@details 指定したスレッド数のワーカーで paths を分担して処理し、paths[i] の結果を results[i] に格納する。
+results[i] には `JCOMSIA_CheckHashValue(paths[i])` と同じ値が格納される。
+スレッドを作成できない環境では、呼び出し元のスレッドで順に処理する。
+
+@param [in] paths チェック対象となる画像ファイルのパスの配列
+@param [in] count paths の要素数
+@param [out] results 各ファイルのチェック結果を格納する配列（ count 個の要素が必要）
+@param [in] options 動作の指定。NULL の場合は既定値を使用する。
+
+@retval JW_SUCCESS                            0 : 全てのファイルを処理した（各ファイルの結果は results を参照）
+@retval JC_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_CheckHashValueBatch(const char **paths, size_t count, int *results, const JCOMSIA_BatchOptions *options);
+
+/*!
+@brief 複数の SVG ファイルについて、ハッシュ値をチェックする。
+@details 指定したスレッド数のワーカーで paths を分担して処理し、paths[i] の結果を results[i] に格納する。
+results[i] には `JCOMSIA_SVG_CheckHashValue(paths[i])` と同じ値が格納される。
+スレッドを作成できない環境では、呼び出し元のスレッドで順に処理する。
+
+@param [in] paths チェック対象となる SVG ファイルのパスの配列
+@param [in] count paths の要素数
+@param [out] results 各ファイルのチェック結果を格納する配列（ count 個の要素が必要）
+@param [in] options 動作の指定。NULL の場合は既定値を使用する。
+
+@retval JW_SUCCESS                            0 : 全てのファイルを処理した（各ファイルの結果は results を参照）
+@retval JC_SVG_ERROR_INCORRECT_PARAMETER   -101 : 不正な引数が指定された場合
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_SVG_CheckHashValueBatch(const char **paths, size_t count, int *results, const JCOMSIA_BatchOptions *options);
+
+/*!
+@brief 検証結果キャッシュを有効にする。
+@details 以降の `JCOMSIA_CheckHashValue()`, `JCOMSIA_SVG_CheckHashValue()` およびその一括処理の結果を、
+ファイルの識別情報（デバイス、i ノード番号、サイズ、更新日時、状態変更日時）とともに cachePath のファイルに記録する。
+識別情報が全て一致するファイルは検証を行わず、記録した結果を返す。いずれかが異なる場合は検証し直す。
+状態変更日時はファイルの内容や属性を変更するたびに更新され、ユーザー空間から設定できないため、更新日時を元に戻したファイルも検証し直す。
+キャッシュファイルは複数のプロセスから同時に使用できる。cachePath に NULL を指定した場合はキャッシュを無効にする。
+ファイル操作やメモリ確保の失敗による結果は記録しない。
+他のスレッドで検証中に呼び出した場合は、その検索・記録が終わるのを待ってからキャッシュを切り替える。
+@attention Windows では使用できない。
+キャッシュの内容は検証結果として信頼されるため、cachePath には他のユーザーが書き込めない、
+アプリ専用のディレクトリ内のパスを指定すること。作成するファイルは所有者のみが読み書きできる。
+
+@param [in] cachePath キャッシュのファイルパス。存在しない場合は作成する。
+
+@retval JW_SUCCESS                            0 : 正常終了
+@retval JW_ERROR_READ_FILE_OPEN_FAILED     -203 : キャッシュファイルのオープンに失敗
+@retval JW_ERROR_WRITE_FILE_FAILED         -205 : キャッシュファイルの初期化に失敗
+@retval JW_ERROR_OTHER                     -900 : キャッシュファイルをマップできなかった場合、またはキャッシュを使用できない環境の場合
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_SetVerificationCache(const char *cachePath);
+
+/*!
+@brief 指定された JPEG 画像のバイト配列に改ざんチェック値を埋め込んだバイト配列を返す。
+@details `JCOMSIA_WriteHashValue()` のファイルを介さない版。source の内容は変更しない。
+dest は処理が成功した際にメモリ領域が確保されるため、使い終わったら `JCOMSIA_FreeImageData()` で解放すること。
+
+@param [in] source 改ざんチェック値を埋め込みたい JPEG 画像のバイト配列
+@param [in] sourceLength source のバイト数
+@param [out] dest 改ざんチェック値を埋め込んだ JPEG 画像のバイト配列を格納するポインタ。途中で処理が失敗した場合は NULL を返す。
+@param [out] destLength dest のバイト数を格納する変数
+
+@retval JW_SUCCESS                            0 : 正常終了
+
+@retval JW_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+
+@retval JW_ERROR_READ_FILE_SIZE_ZERO       -204 : sourceLength がゼロ
+
+@retval JW_ERROR_INCORRECT_EXIF_FORMAT     -301 : Exif フォーマットが不正
+@retval JW_ERROR_APP5_ALREADY_EXISTS       -302 : APP5 セグメントが既に存在する
+@retval JW_ERROR_DATE_NOT_EXISTS           -307 : source に日時情報が見つからない
+
+@retval JW_ERROR_OTHER                     -900 : その他のエラー
+
+@since 3.2
+*/
+#ifdef WRITE_EXPORTS
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS */
+int WINAPI JCOMSIA_WriteHashValueMem(const unsigned char *source, size_t sourceLength, unsigned char **dest, size_t *destLength);
+
+/*!
+@brief 指定された JPEG 画像のバイト配列に正しい改ざんチェック値が設定されているかを確認する。
+@details `JCOMSIA_CheckHashValue()` のファイルを介さない版。
+
+@param [in] image チェック対象の JPEG 画像のバイト配列
+@param [in] imageLength image のバイト数
+
+@retval JC_OK                                 1 : ハッシュ値が一致した
+@retval JC_NG                                 0 : ハッシュ値（画像、撮影日時の両方）が一致しない
+@retval JC_NG_IMAGE                          -1 : ハッシュ値（画像）が一致しない
+@retval JC_NG_DATE                           -2 : ハッシュ値（撮影日時）が一致しない
+
+@retval JC_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+
+@retval JC_ERROR_READ_FILE_SIZE_ZERO       -204 : imageLength がゼロ
+
+@retval JC_ERROR_INCORRECT_EXIF_FORMAT     -301 : Exif フォーマットが不正
+@retval JC_ERROR_APP5_NOT_EXISTS           -303 : APP5 領域が見つからない
+@retval JC_ERROR_INCORRECT_APP5_FORMAT     -304 : APP5 領域の記述形式が異なる
+@retval JC_ERROR_HASH_NOT_EXISTS           -305 : ハッシュ値が設定されていない
+@retval JC_ERROR_DATE_NOT_EXISTS           -307 : image に日時情報が見つからない
+
+@retval JC_ERROR_OTHER                     -900 : その他のエラー
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_CheckHashValueMem(const unsigned char *image, size_t imageLength);
+
+/*!
+@brief 原本画像と黒板画像のバイト配列から SVG 画像に埋め込むための改ざん検知情報を計算する。
+@details `JCOMSIA_SVG_CalculateHashValue()` のファイルを介さない版。
+hashCode は処理が成功した際にメモリ領域が確保されるため、`JCOMSIA_SVG_FreeHashValue()` で解放すること。
+hashCode の長さは `JCOMSIA_HASH_LENGTH` を参照。
+
+@param [in] originalImage 画像改ざん検知情報付与済みの原本画像のバイト配列
+@param [in] originalImageLength originalImage のバイト数
+@param [in] chalkboardImage 画像改ざん検知情報付与済みの黒板画像のバイト配列
+@param [in] chalkboardImageLength chalkboardImage のバイト数
+@param [out] hashCode 計算したハッシュ値を格納するポインタ。NULL 終端されない。途中で処理が失敗した場合は NULL を返す。
+
+@retval JW_HASHER_CREATE_SUCCESS                   0 : 正常終了
+
+@retval JW_HASHER_ERROR_INCORRECT_PARAMETER     -101 : 引数に NULL を渡された等、引数指定に不備がある場合
+
+@retval JW_HASHER_ERROR_FILE_SIZE_ZERO          -204 : 画像のバイト数がゼロ
+
+@retval JW_HASHER_ERROR_ORG_DOES_NOT_HAVE_HASH  -351 : 原本画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_HASHER_ERROR_ORG_HASH_NG_IMAGE       -352 : 原本画像のハッシュ値（画像）が正しくない
+@retval JW_HASHER_ERROR_ORG_HASH_NG_DATE        -353 : 原本画像のハッシュ値（撮影日時）が正しくない
+@retval JW_HASHER_ERROR_ORG_HASH_NG_BOTH        -354 : 原本画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_HASHER_ERROR_CB_DOES_NOT_HAVE_HASH   -361 : 黒板画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_HASHER_ERROR_CB_HASH_NG_IMAGE        -362 : 黒板画像のハッシュ値（画像）が正しくない
+@retval JW_HASHER_ERROR_CB_HASH_NG_DATE         -363 : 黒板画像のハッシュ値（撮影日時）が正しくない
+@retval JW_HASHER_ERROR_CB_HASH_NG_BOTH         -364 : 黒板画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_HASHER_ERROR_OTHERS                  -900 : その他のエラー（メモリ領域の確保失敗など）
+
+@since 3.2
+*/
+#ifdef WRITE_EXPORTS
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS */
+int WINAPI JCOMSIA_SVG_CalculateHashValueMem(const unsigned char *originalImage, size_t originalImageLength, const unsigned char *chalkboardImage, size_t chalkboardImageLength, unsigned char **hashCode);
+
+/*!
+@brief `JCOMSIA_WriteHashValueMem()` 関数によって確保されたメモリ領域を解放する。
+@details 解放されたポインタには NULL が設定される。
+@attention `JCOMSIA_WriteHashValueMem()` で取得したポインタ以外を引数として与えないこと。
+
+@param [out] data メモリ解放の対象となるポインタの参照。処理後は `NULL` ポインタを指すように設定される。
+
+@since 3.2
+*/
+#ifdef WRITE_EXPORTS
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS */
+void WINAPI JCOMSIA_FreeImageData(unsigned char **data);
+
+/*!
+@struct JCOMSIA_SVGMeta
+@brief `JCOMSIA_SVG_ProbeMetadata()` で取得する SVG ファイルのメタデータ
+@details 文字列はすべて NULL 終端される。
+@since 3.2
+*/
+typedef struct
+{
+    char *vender;       /*!< @brief ソフトウェアベンダー名 (dcpm:vender) */
+    char *software;     /*!< @brief ソフトウェア名 (dcpm:software) */
+    char *metaVersion;  /*!< @brief メタデータバージョン (dcpm:metaVersion) */
+    char *stdVersion;   /*!< @brief 適用基準バージョン (dcpm:stdVersion) */
+    char *hashCode;     /*!< @brief ハッシュコード (dcpm:hashCode) 。メタデータに含まれていない場合は NULL */
+    int hasChalkboard;  /*!< @brief 黒板画像レイヤが存在する場合は 0 以外 */
+    const char *dcpmNamespace;  /*!< @brief `JCOMSIA_SVG_Write()` で dcpm 接頭辞に割り当てる名前空間。`JCOMSIA_SVG_ProbeMetadata()` では取得せず NULL を設定し、`JCOMSIA_SVG_FreeMetadata()` では解放しない */
+} JCOMSIA_SVGMeta;
+
+/*!
+@brief SVG ファイルのメタデータと黒板画像レイヤの有無のみを取得する。
+@details 画像の Base64 部分はデコードせずに読み捨て、黒板画像レイヤの開始タグを検出した時点で読み込みを終了する。
+一覧表示などでメタデータのみ必要な場合に、`JCOMSIA_SVG_CheckHashValue()` より少ない処理量で取得できる。
+画像の内容と改ざんの有無は検証しないため、検証には `JCOMSIA_SVG_CheckHashValue()` を使用すること。
+meta は処理が成功した際にメモリ領域が確保されるため、使い終わったら `JCOMSIA_SVG_FreeMetadata()` で解放すること。
+
+@param [in] svgFilePath 処理対象となる SVG ファイルのパス
+@param [out] meta 取得したメタデータを格納する構造体。途中で処理が失敗した場合は各メンバに NULL, 0 を設定する。
+
+@retval JW_SUCCESS                                         0 : 正常終了
+
+@retval JC_SVG_ERROR_ORG_DOES_NOT_EXIST                  -21 : SVG内に原本画像が存在しない
+@retval JC_SVG_ERROR_CB_DOES_NOT_EXIST                   -41 : SVG内に合成ハッシュ値が含まれているが、黒板画像が存在しない
+
+@retval JC_SVG_ERROR_BROKEN_STRUCTURE                    -61 : SVGの構成が壊れている
+
+@retval JC_SVG_ERROR_METADATA_BROKEN_STRUCTURE           -81 : メタデータの構成が壊れている
+@retval JC_SVG_ERROR_METADATA_INCORRECT_VENDER           -82 : メタデータ「ベンダー名」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_SOFTWARE         -83 : メタデータ「ソフトウェア名」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_FORMAT_VERSION   -84 : メタデータ「メタデータバージョン」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_STANDARD_VERSION -85 : メタデータ「適用基準バージョン」に問題あり
+@retval JC_SVG_ERROR_METADATA_INCORRECT_HASHCODE         -86 : メタデータ「ハッシュコード」に問題あり
+
+@retval JC_SVG_ERROR_INCORRECT_PARAMETER                -100 : NULLなど不正な引数が渡された
+@retval JC_ERROR_READ_FILE_NOT_EXISTS                   -201 : SVG ファイルが存在しない
+@retval JC_SVG_ERROR_OTHERS                             -900 : メモリ確保失敗などの予期せぬエラー
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_SVG_ProbeMetadata(const char *svgFilePath, JCOMSIA_SVGMeta *meta);
+
+/*!
+@brief `JCOMSIA_SVG_ProbeMetadata()` 関数によって確保されたメモリ領域を解放する。
+@details 解放したメンバには NULL, 0 が設定される。
+
+@param [in, out] meta `JCOMSIA_SVG_ProbeMetadata()` でメタデータを取得した構造体
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+void WINAPI JCOMSIA_SVG_FreeMetadata(JCOMSIA_SVGMeta *meta);
+
+/*!
+@brief 原本画像と黒板画像を埋め込み、改ざん検知情報（ hashCode ）を含むメタデータを持つ SVG ファイルを作成する。
+@details hashCode は `JCOMSIA_SVG_CalculateHashValue()` と同じく、両方の画像の改ざん検知情報を検証したうえで計算する。
+画像は一定の長さずつ Base64 エンコードしながらファイルへ書き出し、 SVG ファイル全体や Base64 文字列全体をメモリ上に作成しない。
+原本画像の大きさを SVG の大きさとし、黒板画像は左上に元の大きさで配置する。
+書き出しに失敗した場合、書き出し途中の outPath は削除される。
+
+@param [in] originalPath 画像改ざん検知情報付与済みの原本画像のパス
+@param [in] chalkboardPath 画像改ざん検知情報付与済みの黒板画像のパス。NULL の場合は黒板画像レイヤと hashCode を出力しない。
+@param [in] annotationSvgFragment 注釈レイヤ (dcp_annotation) の内容とする SVG 要素の並び（ UTF-8 ）。NULL の場合は注釈レイヤを出力しない。
+@param [in] meta 出力するメタデータ。dcpmNamespace 、vender 、software は必須（ NULL または空文字列の場合は JW_SVG_ERROR_INCORRECT_PARAMETER を返す）。
+dcpmNamespace には既定値が無く、dcpm 接頭辞に割り当てる名前空間を呼び出し元が指定すること。
+metaVersion と stdVersion は NULL の場合 "3.1" と "1.5" を出力する。hashCode と hasChalkboard は参照しない。
+@param [in] outPath 出力先の SVG ファイルのパス
+
+@retval JW_SVG_CREATE_SUCCESS                  0 : 正常終了
+
+@retval JW_SVG_ERROR_INCORRECT_PARAMETER    -101 : 引数に NULL を渡された、dcpmNamespace などメタデータが不足している、メタデータが正しい UTF-8 でない、対応していないバージョンが指定された、注釈が整形式でない場合
+@retval JW_SVG_ERROR_SAME_FILE_PATH         -102 : 読み込み元と出力先のファイルパスが同じ
+
+@retval JW_SVG_ERROR_FILE_DOES_NOT_EXIST    -201 : 読み込み元ファイルが存在しない
+@retval JW_SVG_ERROR_FILE_ALREADY_EXISTS    -202 : 出力先ファイルが既に存在する
+@retval JW_SVG_ERROR_FILE_OPEN_FAILED       -203 : ファイルオープン失敗
+@retval JW_SVG_ERROR_FILE_SIZE_ZERO         -204 : 読み込んだファイルサイズがゼロ
+@retval JW_SVG_ERROR_FILE_WRITE_FAILED      -205 : ファイル書き込み失敗
+@retval JW_SVG_ERROR_FILE_CLOSE_FAILED      -206 : ファイルクローズ失敗
+
+@retval JW_SVG_ERROR_INCORRECT_EXIF_FORMAT  -301 : 画像の幅と高さを取得できない
+
+@retval JW_SVG_ERROR_ORG_DOES_NOT_HAVE_HASH -351 : 原本画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_SVG_ERROR_ORG_HASH_NG_IMAGE      -352 : 原本画像のハッシュ値（画像）が正しくない
+@retval JW_SVG_ERROR_ORG_HASH_NG_DATE       -353 : 原本画像のハッシュ値（撮影日時）が正しくない
+@retval JW_SVG_ERROR_ORG_HASH_NG_BOTH       -354 : 原本画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_SVG_ERROR_CB_DOES_NOT_HAVE_HASH  -361 : 黒板画像に画像ハッシュまたは撮影日時ハッシュが含まれていない
+@retval JW_SVG_ERROR_CB_HASH_NG_IMAGE       -362 : 黒板画像のハッシュ値（画像）が正しくない
+@retval JW_SVG_ERROR_CB_HASH_NG_DATE        -363 : 黒板画像のハッシュ値（撮影日時）が正しくない
+@retval JW_SVG_ERROR_CB_HASH_NG_BOTH        -364 : 黒板画像のハッシュ値（画像、撮影日時）が正しくない
+
+@retval JW_SVG_ERROR_OTHERS                 -900 : その他のエラー（メモリ領域の確保失敗など）
+
+@since 3.2
+*/
+#ifdef WRITE_EXPORTS
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS */
+int WINAPI JCOMSIA_SVG_Write(const char *originalPath, const char *chalkboardPath, const char *annotationSvgFragment, const JCOMSIA_SVGMeta *meta, const char *outPath);
+
+/*!
+@struct JCOMSIA_QueueOptions
+@brief `JCOMSIA_StartQueue()` で指定する処理キューの設定
+@since 3.2
+*/
+typedef struct
+{
+    size_t threadCount; /*!< @brief 処理を実行するスレッド数。0 の場合は利用可能な CPU 数 */
+    size_t capacity;    /*!< @brief 処理待ちにできる処理の数。0 の場合は 16 */
+    int failWhenFull;   /*!< @brief 0 の場合は処理待ちに空きができるまで登録を待たせ、0 以外の場合は `JQ_ERROR_QUEUE_FULL` で失敗させる */
+} JCOMSIA_QueueOptions;
+
+/*!
+@brief 処理キューに登録した処理の識別番号（ 0 は無効な値）
+@since 3.2
+*/
+typedef unsigned long JCOMSIA_JobId;
+
+/*!
+@brief 処理の完了を通知する関数の型
+@details result には同期版の API と同じ値、取り消された場合は `JQ_ERROR_CANCELLED` が渡される。
+@since 3.2
+*/
+typedef void (*JCOMSIA_CompletionFunc)(int result, void *userdata);
+
+/*!
+@brief `JCOMSIA_SVG_SubmitCalculateHash()` の完了を通知する関数の型
+@details hashCode は通知の間のみ有効で、失敗した場合や取り消された場合は NULL が渡される。長さは `JCOMSIA_HASH_LENGTH` を参照。
+@since 3.2
+*/
+typedef void (*JCOMSIA_HashCompletionFunc)(int result, const unsigned char *hashCode, void *userdata);
+
+/*!
+@brief 非同期処理用の処理キューを開始する。
+@details 処理キューはライブラリ内で 1 つを共有する。既に開始している場合は何もせず、options は反映されない。
+呼び出さずに処理を登録した場合は、既定の設定で開始する。
+fork した子プロセスでは処理キューは開始していない状態に戻り、子プロセスで最初に処理を登録した際に既定の設定で開始し直す。
+親プロセスの処理待ち・実行中の処理は、子プロセスでは実行されず、完了も通知されない。
+
+@param [in] options 処理キューの設定。NULL の場合は既定値を使用する。
+
+@retval JQ_SUCCESS                            0 : 正常終了（既に開始している場合を含む）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : スレッドの作成やメモリ確保に失敗した場合、またはスレッドを使用できない環境の場合
+
+@since 3.2
+*/
+#if defined(WRITE_EXPORTS) || defined(CHECK_EXPORTS)
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS || CHECK_EXPORTS */
+int WINAPI JCOMSIA_StartQueue(const JCOMSIA_QueueOptions *options);
+
+/*!
+@brief `JCOMSIA_WriteHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] sourceFile 改ざんチェック値を埋め込みたいファイル名
+@param [in] destFile 改ざんチェック値を埋め込んだファイル名
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+#ifdef WRITE_EXPORTS
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS */
+int WINAPI JCOMSIA_SubmitWriteHash(const char *sourceFile, const char *destFile, JCOMSIA_CompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId);
+
+/*!
+@brief `JCOMSIA_CheckHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] checkFile チェック対象のファイル名
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_SubmitCheckHash(const char *checkFile, JCOMSIA_CompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId);
+
+/*!
+@brief `JCOMSIA_SVG_CalculateHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] originalImagePath 画像改ざん検知情報付与済みの原本画像のパス
+@param [in] chalkboardPath 画像改ざん検知情報付与済みの黒板画像のパス
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+#ifdef WRITE_EXPORTS
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS */
+int WINAPI JCOMSIA_SVG_SubmitCalculateHash(const char *originalImagePath, const char *chalkboardPath, JCOMSIA_HashCompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId);
+
+/*!
+@brief `JCOMSIA_SVG_CheckHashValue()` を非同期に実行するよう登録する。
+@details 処理はライブラリが管理するスレッドで実行し、完了後に同じスレッドから callback を呼び出す。
+処理キューを開始していない場合は既定の設定で開始する。引数のパスは登録時に複製する。
+処理待ちが上限に達している場合は、設定に応じて空きができるまで待つか `JQ_ERROR_QUEUE_FULL` を返す。
+登録に失敗した場合、callback は呼び出されない。
+
+@param [in] checkFilePath 処理対象となる SVG ファイルのパス
+@param [in] callback 完了を通知する関数。不要な場合は NULL
+@param [in] userdata callback に渡す任意の値
+@param [out] jobId 登録した処理の識別番号（ `JCOMSIA_CancelJob()` に使用する）。不要な場合は NULL
+
+@retval JQ_SUCCESS                            0 : 正常に登録した
+@retval JQ_ERROR_INCORRECT_PARAMETER       -101 : 不正な引数が指定された場合
+@retval JQ_ERROR_QUEUE_FULL                -502 : 処理待ちが上限に達している場合（ failWhenFull を指定した場合のみ）
+@retval JQ_ERROR_QUEUE_STOPPED             -503 : 処理キューが停止処理中の場合
+@retval JQ_ERROR_OTHER                     -900 : 処理キューを開始できなかった場合、メモリ確保に失敗した場合
+
+@since 3.2
+*/
+#ifdef CHECK_EXPORTS
+DECLSPEC_PORT
+#endif /* CHECK_EXPORTS */
+int WINAPI JCOMSIA_SVG_SubmitCheckHash(const char *checkFilePath, JCOMSIA_CompletionFunc callback, void *userdata, JCOMSIA_JobId *jobId);
+
+/*!
+@brief 処理待ちの処理を取り消す。
+@details 取り消した処理の callback は、この関数を呼び出したスレッドから `JQ_ERROR_CANCELLED` を結果として呼び出される。
+既に実行を始めた処理は取り消せない。
+
+@param [in] jobId 登録時に取得した識別番号
+
+@retval JQ_SUCCESS                            0 : 取り消した
+@retval JQ_ERROR_JOB_NOT_FOUND             -504 : 処理待ちの中に見つからない（実行中・実行済みの場合を含む）
+
+@since 3.2
+*/
+#if defined(WRITE_EXPORTS) || defined(CHECK_EXPORTS)
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS || CHECK_EXPORTS */
+int WINAPI JCOMSIA_CancelJob(JCOMSIA_JobId jobId);
+
+/*!
+@brief 登録済みの処理が全て完了するまで待つ。
+@attention callback の中から呼び出さないこと。
+
+@since 3.2
+*/
+#if defined(WRITE_EXPORTS) || defined(CHECK_EXPORTS)
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS || CHECK_EXPORTS */
+void WINAPI JCOMSIA_DrainQueue(void);
+
+/*!
+@brief 処理キューを停止し、ライブラリが作成したスレッドを終了する。
+@details 実行中の処理は完了まで待つ。停止処理中の登録は `JQ_ERROR_QUEUE_STOPPED` で失敗する。
+停止後に処理を登録した場合は、処理キューを再び開始する。
+@attention callback の中から呼び出さないこと。また、複数のスレッドから同時に呼び出さないこと。
+
+@param [in] cancelPending 0 の場合は処理待ちを全て実行してから停止し、0 以外の場合は処理待ちを取り消して停止する。
+
+@since 3.2
+*/
+#if defined(WRITE_EXPORTS) || defined(CHECK_EXPORTS)
+DECLSPEC_PORT
+#endif /* WRITE_EXPORTS || CHECK_EXPORTS */
+void WINAPI JCOMSIA_ShutdownQueue(int cancelPending);
+
 
 /*!
 @name deprecated